@@ -0,0 +1,269 @@
+/*+===================================================================
+  File:      ENTITYBENCHMARK.CPP
+
+  Summary:   Command line benchmark of the entity store, updating a
+             field of spinning cubes, and the bounds of each, two ways:
+               objects   one heap object per cube, in scattered memory,
+                         updated through virtual calls, like
+                         SpinningCube and the other renderables
+               entities  the dense arrays of an EntityStore, updated
+                         by its systems
+             Both run one ParallelFor over the cubes, from 1 to N
+             threads.
+
+             Needs DirectXMath, so only builds on Windows.
+
+             Usage: EntityBenchmark [max threads] [iterations] [cubes]
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+
+#include "Entity/EntityStore.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr std::uint32_t DEFAULT_NUM_CUBES = 100000u;
+    constexpr std::uint32_t CUBES_PER_ROW = 320u;
+    constexpr FLOAT DELTA_TIME = 1.0f / 60.0f;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CubeObject
+
+      Summary:  Spinning cube laid out like a renderable: the world
+                matrix next to the shader and buffer pointers, the
+                update behind a virtual call
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CubeObject
+    {
+    public:
+        CubeObject(const XMFLOAT3& position, FLOAT speed)
+            : m_world(XMMatrixIdentity())
+            , m_aPadding()
+            , m_position(position)
+            , m_speed(speed)
+            , m_time(0.0f)
+            , m_bounds()
+        {
+        }
+        virtual ~CubeObject() = default;
+
+        virtual void Update(FLOAT deltaTime)
+        {
+            m_time += deltaTime;
+
+            const XMMATRIX mScale = XMMatrixScaling(0.5f, 0.5f, 0.5f);
+            const XMMATRIX mSpin = XMMatrixRotationY(m_time * m_speed);
+            const XMMATRIX mTranslate = XMMatrixTranslation(m_position.x, m_position.y, m_position.z);
+            m_world = mScale * mSpin * mTranslate;
+        }
+
+        virtual void UpdateBounds()
+        {
+            XMVECTOR min = XMVectorReplicate(FLT_MAX);
+            XMVECTOR max = XMVectorReplicate(-FLT_MAX);
+            for (UINT uCorner = 0u; uCorner < 8u; ++uCorner)
+            {
+                const XMVECTOR corner = XMVectorSet(
+                    uCorner & 1u ? 1.0f : -1.0f,
+                    uCorner & 2u ? 1.0f : -1.0f,
+                    uCorner & 4u ? 1.0f : -1.0f,
+                    1.0f
+                );
+                const XMVECTOR world = XMVector3TransformCoord(corner, m_world);
+                min = XMVectorMin(min, world);
+                max = XMVectorMax(max, world);
+            }
+            XMStoreFloat3(&m_bounds.Min, min);
+            XMStoreFloat3(&m_bounds.Max, max);
+        }
+
+        const AxisAlignedBox& GetBounds() const
+        {
+            return m_bounds;
+        }
+
+    private:
+        XMMATRIX m_world;
+        BYTE m_aPadding[160];
+        XMFLOAT3 m_position;
+        FLOAT m_speed;
+        FLOAT m_time;
+        AxisAlignedBox m_bounds;
+    };
+
+    XMFLOAT3 getCubePosition(std::uint32_t uCube)
+    {
+        return XMFLOAT3(4.0f * static_cast<FLOAT>(uCube % CUBES_PER_ROW), 40.0f, 4.0f * static_cast<FLOAT>(uCube / CUBES_PER_ROW));
+    }
+
+    FLOAT getCubeSpeed(std::uint32_t uCube)
+    {
+        return 1.0f + static_cast<FLOAT>(uCube % 7u) * 0.25f;
+    }
+
+    double sumBounds(const AxisAlignedBox& bounds)
+    {
+        return static_cast<double>(bounds.Min.x) + bounds.Max.y + bounds.Max.z;
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Workloads
+
+      Summary:  The cubes of both workloads. Each run advances the
+                cubes by one step and returns a checksum of the bounds,
+                which must not depend on the number of threads
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Workloads final
+    {
+    public:
+        explicit Workloads(std::uint32_t uNumCubes)
+            : m_apObjects()
+            , m_entities()
+        {
+            // Allocations of random sizes between the cubes scatter them over the heap, as in a long running game
+            std::mt19937 random(42u);
+            std::uniform_int_distribution<std::size_t> scatterSize(16u, 512u);
+            std::vector<std::unique_ptr<BYTE[]>> aScatter;
+            m_apObjects.reserve(uNumCubes);
+            aScatter.reserve(uNumCubes);
+            for (std::uint32_t uCube = 0u; uCube < uNumCubes; ++uCube)
+            {
+                m_apObjects.push_back(std::make_unique<CubeObject>(getCubePosition(uCube), getCubeSpeed(uCube)));
+                aScatter.push_back(std::make_unique<BYTE[]>(scatterSize(random)));
+            }
+            std::shuffle(m_apObjects.begin(), m_apObjects.end(), random);
+
+            for (std::uint32_t uCube = 0u; uCube < uNumCubes; ++uCube)
+            {
+                EntityDesc desc;
+                desc.Position = getCubePosition(uCube);
+                desc.Scale = XMFLOAT3(0.5f, 0.5f, 0.5f);
+                desc.SpinAxis = XMFLOAT3(0.0f, 1.0f, 0.0f);
+                desc.SpinSpeed = getCubeSpeed(uCube);
+                desc.LocalBounds = AxisAlignedBox{ .Min = XMFLOAT3(-1.0f, -1.0f, -1.0f), .Max = XMFLOAT3(1.0f, 1.0f, 1.0f) };
+                m_entities.Add(desc);
+            }
+        }
+
+        double Objects(JobSystem& jobSystem)
+        {
+            jobSystem.ParallelFor(0u, static_cast<std::uint32_t>(m_apObjects.size()), EntityStore::ENTITIES_PER_JOB, [this](std::uint32_t i)
+            {
+                m_apObjects[i]->Update(DELTA_TIME);
+                m_apObjects[i]->UpdateBounds();
+            });
+
+            double checksum = 0.0;
+            for (const std::unique_ptr<CubeObject>& pObject : m_apObjects)
+            {
+                checksum += sumBounds(pObject->GetBounds());
+            }
+            return checksum;
+        }
+
+        double Entities(JobSystem& jobSystem)
+        {
+            m_entities.Update(DELTA_TIME, jobSystem);
+
+            double checksum = 0.0;
+            for (const AxisAlignedBox& bounds : m_entities.GetWorldBounds())
+            {
+                checksum += sumBounds(bounds);
+            }
+            return checksum;
+        }
+
+    private:
+        std::vector<std::unique_ptr<CubeObject>> m_apObjects;
+        EntityStore m_entities;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: measure
+
+      Summary:  Runs a workload a number of times and returns the
+                average time of a run
+
+      Args:     std::uint32_t uNumIterations
+                  Number of timed runs, after one warm up run
+                const std::function<double()>& workload
+                  Workload to run
+                double* pChecksum
+                  Receives the checksum of the last run
+
+      Returns:  double
+                  Milliseconds per run
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double measure(std::uint32_t uNumIterations, const std::function<double()>& workload, double* pChecksum)
+    {
+        *pChecksum = workload();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0u; i < uNumIterations; ++i)
+        {
+            *pChecksum = workload();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count() / static_cast<double>(uNumIterations);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Measures both workloads with 1 to N threads and prints the
+            time per run and the speed up of the entities over the
+            objects
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Maximum number of threads, number of iterations, then
+              number of cubes
+
+  Returns:  int
+              0
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    const std::uint32_t uMaxThreads = argc > 1
+        ? static_cast<std::uint32_t>(std::max(std::atoi(argv[1]), 1))
+        : std::max(std::thread::hardware_concurrency(), 1u);
+    const std::uint32_t uNumIterations = argc > 2 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[2]), 1)) : 50u;
+    const std::uint32_t uNumCubes = argc > 3 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[3]), 1)) : DEFAULT_NUM_CUBES;
+
+    std::printf("%u cubes\n", uNumCubes);
+    std::printf("%8s %12s %12s %9s\n", "threads", "objects", "entities", "speed up");
+    for (std::uint32_t uNumThreads = 1u; uNumThreads <= uMaxThreads; ++uNumThreads)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize(uNumThreads);
+
+        // Fresh cubes for each number of threads, so the checksums match from row to row
+        Workloads workloads(uNumCubes);
+
+        double aChecksums[2] = {};
+        const double aTimes[2] =
+        {
+            measure(uNumIterations, [&]() { return workloads.Objects(jobSystem); }, &aChecksums[0]),
+            measure(uNumIterations, [&]() { return workloads.Entities(jobSystem); }, &aChecksums[1]),
+        };
+
+        std::printf("%8u %10.3fms %10.3fms %8.2fx   checksums %.3f %.3f\n", uNumThreads, aTimes[0], aTimes[1], aTimes[0] / aTimes[1], aChecksums[0], aChecksums[1]);
+
+        jobSystem.Shutdown();
+    }
+
+    return 0;
+}
@@ -0,0 +1,552 @@
+/*+===================================================================
+  File:      FRAMEGRAPHTEST.CPP
+
+  Summary:   Command line test of FrameGraph::Compile, which needs no
+             device. A few hand written graphs check the expected
+             culled passes, execution order and transient offsets,
+             then many random graphs, declared with their passes in
+             shuffled order, are checked against a brute force
+             reference:
+               culling    a pass is kept when it has a side effect,
+                          writes an imported texture, or writes a
+                          version read by a kept pass
+               ordering   every kept pass runs after the producers of
+                          the versions it reads, and after the other
+                          kept readers of the versions it writes over
+               aliasing   transient textures alive at the same time
+                          never overlap in the heap, and every offset
+                          is a multiple of the placement alignment
+             Exits with 1 on the first graph failing a check.
+
+             Depends only on the standard library and the frame
+             graph, so it also builds on Linux:
+               g++ -std=c++20 -O2 -I../Library FrameGraphTest.cpp
+                   ../Library/Renderer/FrameGraph.cpp -o FrameGraphTest
+
+             Usage: FrameGraphTest [random graphs] [seed]
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "Renderer/FrameGraph.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr std::uint32_t DEFAULT_NUM_GRAPHS = 2000u;
+    constexpr std::uint32_t DEFAULT_SEED = 1u;
+
+    constexpr FrameGraphTextureDesc HDR_DESC = { 1920u, 1080u, eFrameGraphFormat::R16G16B16A16_FLOAT };
+    constexpr FrameGraphTextureDesc BACK_BUFFER_DESC = { 1920u, 1080u, eFrameGraphFormat::R8G8B8A8_UNORM };
+
+    constexpr eFrameGraphFormat FORMATS[] =
+    {
+        eFrameGraphFormat::R8_UNORM,
+        eFrameGraphFormat::R16_FLOAT,
+        eFrameGraphFormat::R8G8B8A8_UNORM,
+        eFrameGraphFormat::R16G16B16A16_FLOAT,
+        eFrameGraphFormat::R32G32B32A32_FLOAT,
+    };
+
+    std::uint32_t g_uNumFailures = 0u;
+
+    void check(bool bCondition, const char* pszGraph, const char* pszCheck)
+    {
+        if (!bCondition)
+        {
+            ++g_uNumFailures;
+            std::printf("%s: %s failed\n", pszGraph, pszCheck);
+        }
+    }
+
+    std::vector<std::uint32_t> getPositions(const FrameGraph& graph, size_t uNumPasses)
+    {
+        std::vector<std::uint32_t> auPositions(uNumPasses, FrameGraph::INVALID_INDEX);
+        const std::vector<std::uint32_t>& auOrder = graph.GetExecutionOrder();
+        for (std::uint32_t i = 0u; i < auOrder.size(); ++i)
+        {
+            auPositions[auOrder[i]] = i;
+        }
+
+        return auPositions;
+    }
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Declaration
+
+      Summary:  Copy of what a random graph declared, which the
+                reference checks the compiled graph against
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Declaration
+    {
+        std::vector<bool> abImported;
+        std::vector<FrameGraphTextureDesc> aDescs;
+        std::vector<std::uint32_t> auHandleTextures;
+        std::vector<std::uint32_t> auHandleProducers;
+        std::vector<std::uint32_t> auHandlePrevious;
+        std::vector<std::vector<std::uint32_t>> aauReads;
+        std::vector<std::vector<std::uint32_t>> aauWrites;
+        std::vector<bool> abSideEffects;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testFrame
+
+      Summary:  Checks a frame like the one of the renderer, declared
+                out of order: bloom and tone mapping read the scene,
+                the final pass writes the back buffer, and a debug pass
+                nobody reads is culled along with the pass feeding it
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void testFrame()
+    {
+        const char* pszGraph = "frame";
+        FrameGraph graph;
+
+        const std::uint32_t uBackBuffer = graph.ImportTexture(L"Back buffer", BACK_BUFFER_DESC);
+        const std::uint32_t uHdr = graph.CreateTexture(L"HDR", HDR_DESC);
+        const std::uint32_t uBloom = graph.CreateTexture(L"Bloom", HDR_DESC);
+        const std::uint32_t uPost = graph.CreateTexture(L"Post", HDR_DESC);
+        const std::uint32_t uDebug = graph.CreateTexture(L"Debug", HDR_DESC);
+        const std::uint32_t uOverlay = graph.CreateTexture(L"Overlay", HDR_DESC);
+
+        // Added before the passes they read from
+        const std::uint32_t uTonePass = graph.AddPass(L"Tone", nullptr);
+        const std::uint32_t uDebugPass = graph.AddPass(L"Debug", nullptr);
+        const std::uint32_t uScenePass = graph.AddPass(L"Scene", nullptr);
+        const std::uint32_t uBloomPass = graph.AddPass(L"Bloom", nullptr);
+        const std::uint32_t uFinalPass = graph.AddPass(L"Final", nullptr);
+        const std::uint32_t uOverlayPass = graph.AddPass(L"Overlay", nullptr);
+        const std::uint32_t uPresentPass = graph.AddPass(L"Present", nullptr);
+
+        const std::uint32_t uHdr1 = graph.Write(uScenePass, uHdr);
+
+        graph.Read(uBloomPass, uHdr1);
+        const std::uint32_t uBloom1 = graph.Write(uBloomPass, uBloom);
+
+        graph.Read(uTonePass, uHdr1);
+        graph.Read(uTonePass, uBloom1);
+        const std::uint32_t uPost1 = graph.Write(uTonePass, uPost);
+
+        graph.Read(uFinalPass, uPost1);
+        graph.Write(uFinalPass, uBackBuffer);
+
+        graph.Read(uDebugPass, uHdr1);
+        const std::uint32_t uDebug1 = graph.Write(uDebugPass, uDebug);
+
+        graph.Read(uOverlayPass, uDebug1);
+        graph.Write(uOverlayPass, uOverlay);
+
+        graph.SetSideEffect(uPresentPass);
+
+        check(graph.Compile(), pszGraph, "compile");
+        check(!graph.IsPassCulled(uScenePass), pszGraph, "scene kept");
+        check(!graph.IsPassCulled(uBloomPass), pszGraph, "bloom kept");
+        check(!graph.IsPassCulled(uTonePass), pszGraph, "tone kept");
+        check(!graph.IsPassCulled(uFinalPass), pszGraph, "final pass writing an imported texture kept");
+        check(!graph.IsPassCulled(uPresentPass), pszGraph, "side effect kept");
+        check(graph.IsPassCulled(uOverlayPass), pszGraph, "unread overlay culled");
+        check(graph.IsPassCulled(uDebugPass), pszGraph, "debug only read by a culled pass culled");
+
+        const std::vector<std::uint32_t> auExpectedOrder = { uScenePass, uBloomPass, uTonePass, uFinalPass, uPresentPass };
+        check(graph.GetExecutionOrder() == auExpectedOrder, pszGraph, "execution order");
+
+        check(graph.GetTextureSize(uBackBuffer) == 0u, pszGraph, "imported texture takes no memory");
+        check(graph.GetTextureSize(uDebug) == 0u, pszGraph, "texture of culled passes takes no memory");
+        check(graph.GetTextureSize(uOverlay) == 0u, pszGraph, "texture of culled passes takes no memory");
+        check(graph.GetTextureSize(uHdr) == FrameGraph::GetTextureMemory(HDR_DESC), pszGraph, "transient size");
+
+        // HDR is read until tone mapping, so the three overlap
+        const std::uint64_t uSize = FrameGraph::GetTextureMemory(HDR_DESC);
+        const FrameGraphStats& stats = graph.GetStats();
+        check(stats.uNumPasses == 7u && stats.uNumCulledPasses == 2u, pszGraph, "pass counts");
+        check(stats.uNumTransientTextures == 3u, pszGraph, "transient texture count");
+        check(stats.uTransientBytes == 3u * uSize && stats.uPeakTransientBytes == 3u * uSize, pszGraph, "transient bytes");
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testChain
+
+      Summary:  Checks a chain of passes, each reading the texture of
+                the previous one. Only neighbors are alive at the same
+                time, so every other texture shares an offset
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void testChain()
+    {
+        const char* pszGraph = "chain";
+        FrameGraph graph;
+
+        const std::uint32_t uBackBuffer = graph.ImportTexture(L"Back buffer", BACK_BUFFER_DESC);
+        const std::uint32_t auTextures[] =
+        {
+            graph.CreateTexture(L"A", HDR_DESC),
+            graph.CreateTexture(L"B", HDR_DESC),
+            graph.CreateTexture(L"C", HDR_DESC),
+            graph.CreateTexture(L"D", HDR_DESC),
+        };
+
+        std::uint32_t uPrevious = FrameGraph::INVALID_INDEX;
+        for (std::uint32_t uTexture : auTextures)
+        {
+            const std::uint32_t uPass = graph.AddPass(L"Chain", nullptr);
+            if (uPrevious != FrameGraph::INVALID_INDEX)
+            {
+                graph.Read(uPass, uPrevious);
+            }
+            uPrevious = graph.Write(uPass, uTexture);
+        }
+
+        const std::uint32_t uFinalPass = graph.AddPass(L"Final", nullptr);
+        graph.Read(uFinalPass, uPrevious);
+        graph.Write(uFinalPass, uBackBuffer);
+
+        check(graph.Compile(), pszGraph, "compile");
+        check(graph.GetExecutionOrder().size() == 5u, pszGraph, "no pass culled");
+
+        const std::uint64_t uSize = FrameGraph::GetTextureMemory(HDR_DESC);
+        check(graph.GetTextureOffset(auTextures[0]) == graph.GetTextureOffset(auTextures[2]), pszGraph, "A and C aliased");
+        check(graph.GetTextureOffset(auTextures[1]) == graph.GetTextureOffset(auTextures[3]), pszGraph, "B and D aliased");
+        check(graph.GetTextureOffset(auTextures[0]) != graph.GetTextureOffset(auTextures[1]), pszGraph, "A and B apart");
+        check(graph.GetStats().uTransientBytes == 4u * uSize, pszGraph, "transient bytes");
+        check(graph.GetStats().uPeakTransientBytes == 2u * uSize, pszGraph, "peak transient bytes");
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testWriteAfterRead
+
+      Summary:  Checks that a pass writing over a version runs after the
+                passes reading it, although it was added first, and
+                that a cycle fails to compile
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void testWriteAfterRead()
+    {
+        const char* pszGraph = "write after read";
+        {
+            FrameGraph graph;
+
+            const std::uint32_t uBackBuffer = graph.ImportTexture(L"Back buffer", BACK_BUFFER_DESC);
+            const std::uint32_t uOutput = graph.ImportTexture(L"Output", BACK_BUFFER_DESC);
+
+            const std::uint32_t uOverwritePass = graph.AddPass(L"Overwrite", nullptr);
+            const std::uint32_t uCopyPass = graph.AddPass(L"Copy", nullptr);
+
+            graph.Read(uCopyPass, uBackBuffer);
+            graph.Write(uCopyPass, uOutput);
+            graph.Write(uOverwritePass, uBackBuffer);
+
+            check(graph.Compile(), pszGraph, "compile");
+
+            const std::vector<std::uint32_t> auExpectedOrder = { uCopyPass, uOverwritePass };
+            check(graph.GetExecutionOrder() == auExpectedOrder, pszGraph, "reader before writer");
+        }
+
+        pszGraph = "cycle";
+        {
+            FrameGraph graph;
+
+            const std::uint32_t uBackBuffer = graph.ImportTexture(L"Back buffer", BACK_BUFFER_DESC);
+            const std::uint32_t uTexture = graph.CreateTexture(L"Texture", HDR_DESC);
+
+            const std::uint32_t uFirstPass = graph.AddPass(L"First", nullptr);
+            const std::uint32_t uSecondPass = graph.AddPass(L"Second", nullptr);
+
+            const std::uint32_t uTexture1 = graph.Write(uFirstPass, uTexture);
+            graph.Read(uSecondPass, uTexture1);
+            const std::uint32_t uBackBuffer1 = graph.Write(uSecondPass, uBackBuffer);
+            graph.Read(uFirstPass, uBackBuffer1);
+
+            check(!graph.Compile(), pszGraph, "compile fails");
+            check(graph.GetExecutionOrder().empty(), pszGraph, "no execution order");
+        }
+    }
+
+    Declaration declareRandomGraph(std::mt19937& generator, FrameGraph& graph)
+    {
+        const std::uint32_t uNumTextures = std::uniform_int_distribution<std::uint32_t>(1u, 12u)(generator);
+        const std::uint32_t uNumPasses = std::uniform_int_distribution<std::uint32_t>(1u, 16u)(generator);
+
+        Declaration declaration;
+        std::vector<std::uint32_t> auLatest(uNumTextures);
+        for (std::uint32_t i = 0u; i < uNumTextures; ++i)
+        {
+            const FrameGraphTextureDesc desc =
+            {
+                .uWidth = std::uniform_int_distribution<std::uint32_t>(1u, 2048u)(generator),
+                .uHeight = std::uniform_int_distribution<std::uint32_t>(1u, 2048u)(generator),
+                .Format = FORMATS[std::uniform_int_distribution<size_t>(0u, std::size(FORMATS) - 1u)(generator)],
+            };
+            const bool bImported = std::bernoulli_distribution(0.2)(generator);
+
+            auLatest[i] = bImported ? graph.ImportTexture(L"Imported", desc) : graph.CreateTexture(L"Transient", desc);
+            declaration.abImported.push_back(bImported);
+            declaration.aDescs.push_back(desc);
+            declaration.auHandleTextures.push_back(i);
+            declaration.auHandleProducers.push_back(FrameGraph::INVALID_INDEX);
+            declaration.auHandlePrevious.push_back(FrameGraph::INVALID_INDEX);
+        }
+
+        // Passes are added in shuffled order, then declared in the
+        // order of a valid frame, so the graph has to sort them
+        std::vector<std::uint32_t> auPasses(uNumPasses);
+        for (std::uint32_t i = 0u; i < uNumPasses; ++i)
+        {
+            auPasses[i] = graph.AddPass(L"Random", nullptr);
+        }
+        std::shuffle(auPasses.begin(), auPasses.end(), generator);
+
+        declaration.aauReads.resize(uNumPasses);
+        declaration.aauWrites.resize(uNumPasses);
+        declaration.abSideEffects.resize(uNumPasses, false);
+
+        std::vector<std::uint32_t> auTextures(uNumTextures);
+        std::iota(auTextures.begin(), auTextures.end(), 0u);
+        for (std::uint32_t uPass : auPasses)
+        {
+            std::shuffle(auTextures.begin(), auTextures.end(), generator);
+            const std::uint32_t uNumReads = std::uniform_int_distribution<std::uint32_t>(0u, std::min(uNumTextures, 3u))(generator);
+            const std::uint32_t uNumWrites = std::uniform_int_distribution<std::uint32_t>(0u, std::min(uNumTextures - uNumReads, 2u))(generator);
+
+            for (std::uint32_t i = 0u; i < uNumReads; ++i)
+            {
+                graph.Read(uPass, auLatest[auTextures[i]]);
+                declaration.aauReads[uPass].push_back(auLatest[auTextures[i]]);
+            }
+
+            for (std::uint32_t i = uNumReads; i < uNumReads + uNumWrites; ++i)
+            {
+                const std::uint32_t uPrevious = auLatest[auTextures[i]];
+                auLatest[auTextures[i]] = graph.Write(uPass, uPrevious);
+
+                declaration.aauReads[uPass].push_back(uPrevious);
+                declaration.aauWrites[uPass].push_back(auLatest[auTextures[i]]);
+                declaration.auHandleTextures.push_back(auTextures[i]);
+                declaration.auHandleProducers.push_back(uPass);
+                declaration.auHandlePrevious.push_back(uPrevious);
+            }
+
+            if (std::bernoulli_distribution(0.1)(generator))
+            {
+                graph.SetSideEffect(uPass);
+                declaration.abSideEffects[uPass] = true;
+            }
+        }
+
+        return declaration;
+    }
+
+    std::vector<bool> getReferenceKeptPasses(const Declaration& declaration)
+    {
+        const size_t uNumPasses = declaration.aauReads.size();
+
+        std::vector<bool> abKept(uNumPasses, false);
+        for (size_t uPass = 0u; uPass < uNumPasses; ++uPass)
+        {
+            abKept[uPass] = declaration.abSideEffects[uPass];
+            for (std::uint32_t uHandle : declaration.aauWrites[uPass])
+            {
+                abKept[uPass] = abKept[uPass] || declaration.abImported[declaration.auHandleTextures[uHandle]];
+            }
+        }
+
+        // Keeps the producers of what kept passes read until nothing
+        // changes, at most once per pass
+        for (bool bChanged = true; bChanged;)
+        {
+            bChanged = false;
+            for (size_t uPass = 0u; uPass < uNumPasses; ++uPass)
+            {
+                if (!abKept[uPass])
+                {
+                    continue;
+                }
+
+                for (std::uint32_t uHandle : declaration.aauReads[uPass])
+                {
+                    const std::uint32_t uProducer = declaration.auHandleProducers[uHandle];
+                    if (uProducer != FrameGraph::INVALID_INDEX && !abKept[uProducer])
+                    {
+                        abKept[uProducer] = true;
+                        bChanged = true;
+                    }
+                }
+            }
+        }
+
+        return abKept;
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: testRandomGraph
+
+      Summary:  Declares a random graph and checks its compilation
+                against the reference
+
+      Args:     std::mt19937& generator
+                  Generator of the graph
+
+      Returns:  bool
+                  true if every check passed
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    bool testRandomGraph(std::mt19937& generator)
+    {
+        const char* pszGraph = "random";
+        const std::uint32_t uNumFailures = g_uNumFailures;
+
+        FrameGraph graph;
+        const Declaration declaration = declareRandomGraph(generator, graph);
+        const size_t uNumPasses = declaration.aauReads.size();
+
+        check(graph.Compile(), pszGraph, "compile");
+
+        const std::vector<bool> abKept = getReferenceKeptPasses(declaration);
+        for (std::uint32_t uPass = 0u; uPass < uNumPasses; ++uPass)
+        {
+            check(graph.IsPassCulled(uPass) == !abKept[uPass], pszGraph, "culled passes");
+        }
+
+        const std::vector<std::uint32_t> auPositions = getPositions(graph, uNumPasses);
+        check(
+            graph.GetExecutionOrder().size() == static_cast<size_t>(std::count(abKept.begin(), abKept.end(), true)),
+            pszGraph,
+            "every kept pass executed once"
+        );
+        for (std::uint32_t uPass = 0u; uPass < uNumPasses; ++uPass)
+        {
+            if (!abKept[uPass])
+            {
+                continue;
+            }
+
+            for (std::uint32_t uHandle : declaration.aauReads[uPass])
+            {
+                const std::uint32_t uProducer = declaration.auHandleProducers[uHandle];
+                if (uProducer != FrameGraph::INVALID_INDEX && uProducer != uPass)
+                {
+                    check(auPositions[uProducer] < auPositions[uPass], pszGraph, "read after write order");
+                }
+            }
+
+            for (std::uint32_t uHandle : declaration.aauWrites[uPass])
+            {
+                const std::uint32_t uPrevious = declaration.auHandlePrevious[uHandle];
+                for (std::uint32_t uReader = 0u; uReader < uNumPasses; ++uReader)
+                {
+                    const std::vector<std::uint32_t>& auReads = declaration.aauReads[uReader];
+                    if (uReader != uPass && abKept[uReader] && std::find(auReads.begin(), auReads.end(), uPrevious) != auReads.end())
+                    {
+                        check(auPositions[uReader] < auPositions[uPass], pszGraph, "write after read order");
+                    }
+                }
+            }
+        }
+
+        // Lifetimes from the execution order
+        const size_t uNumTextures = declaration.aDescs.size();
+        std::vector<std::uint32_t> auFirstUse(uNumTextures, FrameGraph::INVALID_INDEX);
+        std::vector<std::uint32_t> auLastUse(uNumTextures, 0u);
+        for (std::uint32_t uPass = 0u; uPass < uNumPasses; ++uPass)
+        {
+            if (!abKept[uPass])
+            {
+                continue;
+            }
+
+            for (std::uint32_t uHandle : declaration.aauReads[uPass])
+            {
+                const std::uint32_t uTexture = declaration.auHandleTextures[uHandle];
+                auFirstUse[uTexture] = std::min(auFirstUse[uTexture], auPositions[uPass]);
+                auLastUse[uTexture] = std::max(auLastUse[uTexture], auPositions[uPass]);
+            }
+        }
+
+        std::uint64_t uTransientBytes = 0u;
+        std::uint64_t uPeakTransientBytes = 0u;
+        std::uint32_t uNumTransientTextures = 0u;
+        for (std::uint32_t i = 0u; i < uNumTextures; ++i)
+        {
+            const bool bTransient = !declaration.abImported[i] && auFirstUse[i] != FrameGraph::INVALID_INDEX;
+            const std::uint64_t uSize = graph.GetTextureSize(i);
+            const std::uint64_t uOffset = graph.GetTextureOffset(i);
+
+            check(uSize == (bTransient ? FrameGraph::GetTextureMemory(declaration.aDescs[i]) : 0u), pszGraph, "transient size");
+            check(uOffset % FrameGraph::PLACEMENT_ALIGNMENT == 0u, pszGraph, "aligned offset");
+            if (!bTransient)
+            {
+                continue;
+            }
+
+            ++uNumTransientTextures;
+            uTransientBytes += uSize;
+            uPeakTransientBytes = std::max(uPeakTransientBytes, uOffset + uSize);
+
+            for (std::uint32_t j = 0u; j < i; ++j)
+            {
+                const std::uint64_t uOtherSize = graph.GetTextureSize(j);
+                const std::uint64_t uOtherOffset = graph.GetTextureOffset(j);
+                const bool bAlive = uOtherSize > 0u && auFirstUse[j] <= auLastUse[i] && auFirstUse[i] <= auLastUse[j];
+                if (bAlive)
+                {
+                    check(uOffset + uSize <= uOtherOffset || uOtherOffset + uOtherSize <= uOffset, pszGraph, "live textures apart");
+                }
+            }
+        }
+
+        const FrameGraphStats& stats = graph.GetStats();
+        check(stats.uNumPasses == uNumPasses, pszGraph, "pass count");
+        check(stats.uNumCulledPasses == uNumPasses - graph.GetExecutionOrder().size(), pszGraph, "culled pass count");
+        check(stats.uNumTransientTextures == uNumTransientTextures, pszGraph, "transient texture count");
+        check(stats.uTransientBytes == uTransientBytes, pszGraph, "transient bytes");
+        check(stats.uPeakTransientBytes == uPeakTransientBytes, pszGraph, "peak transient bytes");
+        check(stats.uPeakTransientBytes <= stats.uTransientBytes, pszGraph, "peak at most the total");
+
+        return g_uNumFailures == uNumFailures;
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Runs the hand written graphs, then the random graphs, and
+            prints the failed checks and the memory saved by aliasing
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Number of random graphs, then seed
+
+  Returns:  int
+              0 if every check passed, 1 otherwise
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    const std::uint32_t uNumGraphs = argc > 1 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[1]), 0)) : DEFAULT_NUM_GRAPHS;
+    const std::uint32_t uSeed = argc > 2 ? static_cast<std::uint32_t>(std::atoi(argv[2])) : DEFAULT_SEED;
+
+    testFrame();
+    testChain();
+    testWriteAfterRead();
+
+    std::mt19937 generator(uSeed);
+    for (std::uint32_t i = 0u; i < uNumGraphs; ++i)
+    {
+        if (!testRandomGraph(generator))
+        {
+            std::printf("random graph %u of seed %u failed\n", i, uSeed);
+            break;
+        }
+    }
+
+    std::printf("random graphs   %u, seed %u\n", uNumGraphs, uSeed);
+    std::printf("failed checks   %u\n", g_uNumFailures);
+
+    return g_uNumFailures == 0u ? 0 : 1;
+}
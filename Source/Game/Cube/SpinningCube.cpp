@@ -0,0 +1,41 @@
+#include "Cube/SpinningCube.h"
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SpinningCube::SpinningCube
+
+  Summary:  Constructor
+
+  Args:     const XMFLOAT4& position
+              Position of the center of the cube
+            FLOAT speed
+              Angular speed in radians per second
+            const XMFLOAT4& outputColor
+              Default color of the cube
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+SpinningCube::SpinningCube(_In_ const XMFLOAT4& position, _In_ FLOAT speed, _In_ const XMFLOAT4& outputColor)
+    : BaseCube(outputColor)
+    , m_position(position)
+    , m_speed(speed)
+    , m_time(0.0f)
+{
+}
+
+/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+  Method:   SpinningCube::Update
+
+  Summary:  Spins the cube around its vertical axis
+
+  Args:     FLOAT deltaTime
+              Elapsed time
+
+  Modifies: [m_time, m_world].
+M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+void SpinningCube::Update(_In_ FLOAT deltaTime)
+{
+    m_time += deltaTime;
+
+    XMMATRIX mScale = XMMatrixScaling(0.5f, 0.5f, 0.5f);
+    XMMATRIX mSpin = XMMatrixRotationY(m_time * m_speed);
+    XMMATRIX mTranslate = XMMatrixTranslation(m_position.x, m_position.y, m_position.z);
+    m_world = mScale * mSpin * mTranslate;
+}
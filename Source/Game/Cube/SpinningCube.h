@@ -0,0 +1,48 @@
+/*+===================================================================
+  File:      SPINNINGCUBE.H
+
+  Summary:  SpinningCube header file contains declarations of
+            SpinningCube class used for the lab samples of Game
+            Graphics Programming course.
+
+  Classes: SpinningCube
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Cube/BaseCube.h"
+
+/*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+  Class:    SpinningCube
+
+  Summary:  A renderable 3d cube spinning in place, with its own
+            position and speed
+
+  Methods:  Update
+              Overriden function that spins the cube every frame
+            SpinningCube
+              Constructor.
+            ~SpinningCube
+              Destructor.
+C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+class SpinningCube : public BaseCube
+{
+public:
+
+    SpinningCube(_In_ const XMFLOAT4& position, _In_ FLOAT speed, _In_ const XMFLOAT4& outputColor);
+    SpinningCube(const SpinningCube& other) = delete;
+    SpinningCube(SpinningCube&& other) = delete;
+    SpinningCube& operator=(const SpinningCube& other) = delete;
+    SpinningCube& operator=(SpinningCube&& other) = delete;
+    ~SpinningCube() = default;
+
+    virtual void Update(_In_ FLOAT deltaTime) override;
+
+private:
+    XMFLOAT4 m_position;
+    FLOAT m_speed;
+    FLOAT m_time;
+};
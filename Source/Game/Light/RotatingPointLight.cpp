@@ -9,10 +9,13 @@
               Position of the light
             const XMFLOAT4& color
               Position of the color
+            FLOAT attenuationRadius
+              Distance at which the light fades out, 0 when the
+              light never fades
 M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 
-RotatingPointLight::RotatingPointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color) :
-    PointLight(position, color)
+RotatingPointLight::RotatingPointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color, _In_ FLOAT attenuationRadius) :
+    PointLight(position, color, attenuationRadius)
 
 {}
 /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
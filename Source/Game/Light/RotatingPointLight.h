@@ -30,7 +30,7 @@ class RotatingPointLight final : public library::PointLight
 {
 public:
     RotatingPointLight() = delete;
-    RotatingPointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color);
+    RotatingPointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color, _In_ FLOAT attenuationRadius = 0.0f);
     RotatingPointLight(const RotatingPointLight& other) = default;
     RotatingPointLight(RotatingPointLight&& other) = default;
     RotatingPointLight& operator=(const RotatingPointLight & other) = default;
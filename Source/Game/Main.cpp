@@ -15,10 +15,16 @@
 #include <fstream>
 #include <memory>
 
+#include "Cube/Cube.h"
 #include "Game/Game.h"
 #include "Light/RotatingPointLight.h"
+#include "Memory/MemoryTracker.h"
 #include "Model/Model.h"
+#include "Model/ModelCrowd.h"
+#include "Renderer/PipelineState.h"
 #include "Scene/Voxel.h"
+#include "Shader/DebugVertexShader.h"
+#include "Shader/InstancedVertexShader.h"
 #include "Shader/SkinningVertexShader.h"
 
 using namespace library;
@@ -51,7 +57,6 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 #endif
 
 	UNREFERENCED_PARAMETER(hPrevInstance);
-	UNREFERENCED_PARAMETER(lpCmdLine);
 
 	std::unique_ptr<library::Game> game = std::make_unique<library::Game>(L"Game Graphics Programming Lab 8: Skeletal Animation");
 
@@ -61,6 +66,12 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
+	std::shared_ptr<library::SkinningVertexShader> phongCrowdVertexShader = std::make_shared<library::SkinningVertexShader>(L"Shaders/SkinningShaders.fxh", "VSPhongCrowd", "vs_5_0");
+	if (FAILED(game->GetRenderer()->AddVertexShader(L"PhongCrowdShader", phongCrowdVertexShader)))
+	{
+		return 0;
+	}
+
 	std::shared_ptr<library::VertexShader> phongVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSPhong", "vs_5_0");
 	if (FAILED(game->GetRenderer()->AddVertexShader(L"PhongShader", phongVertexShader)))
 	{
@@ -91,6 +102,91 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
+	std::shared_ptr<library::VertexShader> lightCubeVertexShader = std::make_shared<library::VertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCube", "vs_5_0");
+	if (FAILED(game->GetRenderer()->AddVertexShader(L"LightCubeShader", lightCubeVertexShader)))
+	{
+		return 0;
+	}
+
+	std::shared_ptr<library::PixelShader> lightCubePixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCube", "ps_5_0");
+	if (FAILED(game->GetRenderer()->AddPixelShader(L"LightCubeShader", lightCubePixelShader)))
+	{
+		return 0;
+	}
+
+	std::shared_ptr<library::InstancedVertexShader> lightCubeInstancedVertexShader = std::make_shared<library::InstancedVertexShader>(L"Shaders/PhongShaders.fxh", "VSLightCubeInstanced", "vs_5_0");
+	if (FAILED(game->GetRenderer()->AddVertexShader(L"LightCubeInstancedShader", lightCubeInstancedVertexShader)))
+	{
+		return 0;
+	}
+
+	std::shared_ptr<library::PixelShader> lightCubeInstancedPixelShader = std::make_shared<library::PixelShader>(L"Shaders/PhongShaders.fxh", "PSLightCubeInstanced", "ps_5_0");
+	if (FAILED(game->GetRenderer()->AddPixelShader(L"LightCubeInstancedShader", lightCubeInstancedPixelShader)))
+	{
+		return 0;
+	}
+
+	std::shared_ptr<library::DebugVertexShader> debugVertexShader = std::make_shared<library::DebugVertexShader>(L"Shaders/DebugShaders.fxh", "VSDebug", "vs_5_0");
+	if (FAILED(game->GetRenderer()->AddVertexShader(L"DebugShader", debugVertexShader)))
+	{
+		return 0;
+	}
+
+	std::shared_ptr<library::PixelShader> debugPixelShader = std::make_shared<library::PixelShader>(L"Shaders/DebugShaders.fxh", "PSDebug", "ps_5_0");
+	if (FAILED(game->GetRenderer()->AddPixelShader(L"DebugShader", debugPixelShader)))
+	{
+		return 0;
+	}
+
+	// The crowd and the instanced cubes read their transforms from instance data, not the object constants
+	library::PipelineStateDesc instancedDesc = library::PipelineState::GetDefaultDesc();
+	instancedDesc.bVertexShaderObjectConstants = FALSE;
+	instancedDesc.bPixelShaderObjectConstants = FALSE;
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"PhongSkinning", std::make_shared<library::PipelineState>(phongSkinningVertexShader, phongSkinningPixelShader))))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"PhongCrowd", std::make_shared<library::PipelineState>(phongCrowdVertexShader, phongSkinningPixelShader, instancedDesc))))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"Voxel", std::make_shared<library::PipelineState>(voxelVertexShader, voxelPixelShader))))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"LightCube", std::make_shared<library::PipelineState>(lightCubeVertexShader, lightCubePixelShader))))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"LightCubeInstanced", std::make_shared<library::PipelineState>(lightCubeInstancedVertexShader, lightCubeInstancedPixelShader, instancedDesc))))
+	{
+		return 0;
+	}
+
+	// Debug triangles are seen from both sides, and only the vertex shader reads the view projection
+	library::PipelineStateDesc debugDesc = library::PipelineState::GetDefaultDesc();
+	debugDesc.Rasterizer.CullMode = D3D11_CULL_NONE;
+	debugDesc.bPixelShaderObjectConstants = FALSE;
+
+	if (FAILED(game->GetRenderer()->AddPipelineState(L"Debug", std::make_shared<library::PipelineState>(debugVertexShader, debugPixelShader, debugDesc))))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->SetPipelineStateOfDebugDraw(L"Debug")))
+	{
+		return 0;
+	}
+
+#ifdef _DEBUG
+	game->GetRenderer()->GetDebugDraw().SetEnabled(TRUE);
+#endif
+
 	std::shared_ptr<library::Model> warrior = std::make_shared<library::Model>(L"Content/BobLampClean/boblampclean.md5mesh");
 	warrior->RotateX(XM_PIDIV2);
 	warrior->Scale(0.1f, 0.1f, 0.1f);
@@ -100,12 +196,47 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
-	if (FAILED(game->GetRenderer()->SetVertexShaderOfModel(L"Warrior", L"PhongSkinningShader")))
+	if (FAILED(game->GetRenderer()->SetPipelineStateOfModel(L"Warrior", L"PhongSkinning")))
+	{
+		return 0;
+	}
+
+	// Crowd of guards sharing one model, each with its own animation time
+	constexpr const UINT NUM_GUARDS_X = 10u;
+	constexpr const UINT NUM_GUARDS_Z = 10u;
+	constexpr const FLOAT GUARD_SPACING = 8.0f;
+
+	std::shared_ptr<library::Model> guard = std::make_shared<library::Model>(L"Content/BobLampClean/boblampclean.md5mesh");
+	guard->RotateX(XM_PIDIV2);
+	guard->Scale(0.1f, 0.1f, 0.1f);
+
+	std::shared_ptr<library::ModelCrowd> guards = std::make_shared<library::ModelCrowd>(guard);
+	for (UINT z = 0u; z < NUM_GUARDS_Z; ++z)
+	{
+		for (UINT x = 0u; x < NUM_GUARDS_X; ++x)
+		{
+			const UINT uGuardIdx = z * NUM_GUARDS_X + x;
+			if (FAILED(guards->AddInstance(
+				XMMatrixTranslation(
+					GUARD_SPACING * (static_cast<FLOAT>(x) - static_cast<FLOAT>(NUM_GUARDS_X - 1u) / 2.0f),
+					0.0f,
+					GUARD_SPACING * (static_cast<FLOAT>(z) + 2.0f)
+				),
+				static_cast<FLOAT>(uGuardIdx) * 0.37f,
+				0.8f + static_cast<FLOAT>(uGuardIdx % 5u) * 0.1f
+			)))
+			{
+				return 0;
+			}
+		}
+	}
+
+	if (FAILED(game->GetRenderer()->AddModelCrowd(L"Guards", guards)))
 	{
 		return 0;
 	}
 
-	if (FAILED(game->GetRenderer()->SetPixelShaderOfModel(L"Warrior", L"PhongSkinningShader")))
+	if (FAILED(game->GetRenderer()->SetPipelineStateOfModelCrowd(L"Guards", L"PhongCrowd")))
 	{
 		return 0;
 	}
@@ -117,7 +248,7 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		XMFLOAT4(-5.77f, 5.77f, -5.77f, 1.0f),
 		color
 		);
-	if (FAILED(game->GetRenderer()->AddPointLight(0, directionalLight)))
+	if (FAILED(game->GetRenderer()->AddPointLight(L"DirectionalLight", directionalLight)))
 	{
 		return 0;
 	}
@@ -127,11 +258,147 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		XMFLOAT4(0.0f, 0.0f, -5.0f, 1.0f),
 		color
 		);
-	if (FAILED(game->GetRenderer()->AddPointLight(1, rotatingDirectionalLight)))
+	if (FAILED(game->GetRenderer()->AddPointLight(L"RotatingDirectionalLight", rotatingDirectionalLight)))
 	{
 		return 0;
 	}
 
+	// Grid of small lights over the voxel map, each only reaching the clusters around it
+	constexpr const UINT NUM_GRID_LIGHTS_X = 16u;
+	constexpr const UINT NUM_GRID_LIGHTS_Z = 16u;
+	constexpr const FLOAT GRID_LIGHT_SPACING = 32.0f;
+	constexpr const FLOAT GRID_LIGHT_RADIUS = 24.0f;
+	const XMVECTORF32 aGridLightColors[] =
+	{
+		Colors::OrangeRed, Colors::Gold, Colors::LimeGreen, Colors::DeepSkyBlue, Colors::MediumOrchid,
+	};
+	for (UINT z = 0u; z < NUM_GRID_LIGHTS_Z; ++z)
+	{
+		for (UINT x = 0u; x < NUM_GRID_LIGHTS_X; ++x)
+		{
+			const UINT uLightIdx = z * NUM_GRID_LIGHTS_X + x;
+			XMStoreFloat4(&color, aGridLightColors[uLightIdx % ARRAYSIZE(aGridLightColors)]);
+
+			std::shared_ptr<PointLight> gridLight = std::make_shared<PointLight>(
+				XMFLOAT4(
+					GRID_LIGHT_SPACING * (static_cast<FLOAT>(x) - static_cast<FLOAT>(NUM_GRID_LIGHTS_X - 1u) / 2.0f),
+					8.0f,
+					GRID_LIGHT_SPACING * (static_cast<FLOAT>(z) - static_cast<FLOAT>(NUM_GRID_LIGHTS_Z - 1u) / 2.0f),
+					1.0f
+				),
+				color,
+				GRID_LIGHT_RADIUS
+				);
+
+			WCHAR szGridLightName[32];
+			swprintf_s(szGridLightName, L"GridLight%u", uLightIdx);
+			if (FAILED(game->GetRenderer()->AddPointLight(szGridLightName, gridLight)))
+			{
+				return 0;
+			}
+		}
+	}
+
+	// Field of identical cubes floating over the voxel map, entities sharing one mesh and drawn instanced.
+	// Each row hangs from an anchor entity, so a row out of view is culled as a whole
+	constexpr const UINT NUM_CUBES_X = 100u;
+	constexpr const UINT NUM_CUBES_Z = 100u;
+	constexpr const FLOAT CUBE_SPACING = 4.0f;
+	constexpr const FLOAT CUBE_HEIGHT = 40.0f;
+	const XMVECTORF32 aCubeColors[] =
+	{
+		Colors::OrangeRed, Colors::Gold, Colors::LimeGreen, Colors::DeepSkyBlue, Colors::MediumOrchid
+	};
+	XMStoreFloat4(&color, aCubeColors[0]);
+	library::Renderer::EntityMeshHandle cubeMesh;
+	if (FAILED(game->GetRenderer()->AddEntityMesh(L"CubeMesh", std::make_shared<Cube>(color), &cubeMesh)))
+	{
+		return 0;
+	}
+
+	if (FAILED(game->GetRenderer()->SetPipelineStateOfEntityMesh(L"CubeMesh", L"LightCube")))
+	{
+		return 0;
+	}
+
+	for (UINT z = 0u; z < NUM_CUBES_Z; ++z)
+	{
+		library::EntityDesc rowDesc;
+		rowDesc.Position = XMFLOAT3(0.0f, CUBE_HEIGHT, CUBE_SPACING * (static_cast<FLOAT>(z) - static_cast<FLOAT>(NUM_CUBES_Z - 1u) / 2.0f));
+
+		library::EntityHandle row;
+		if (FAILED(game->GetRenderer()->AddEntity(rowDesc, &row)))
+		{
+			return 0;
+		}
+
+		for (UINT x = 0u; x < NUM_CUBES_X; ++x)
+		{
+			const UINT uCubeIdx = z * NUM_CUBES_X + x;
+
+			library::EntityDesc cubeDesc;
+			cubeDesc.Mesh = cubeMesh;
+			cubeDesc.Parent = row;
+			cubeDesc.Position = XMFLOAT3(CUBE_SPACING * (static_cast<FLOAT>(x) - static_cast<FLOAT>(NUM_CUBES_X - 1u) / 2.0f), 0.0f, 0.0f);
+			cubeDesc.Scale = XMFLOAT3(0.5f, 0.5f, 0.5f);
+			cubeDesc.SpinAxis = XMFLOAT3(0.0f, 1.0f, 0.0f);
+			cubeDesc.SpinSpeed = 1.0f + static_cast<FLOAT>(uCubeIdx % 7u) * 0.25f;
+			XMStoreFloat4(&cubeDesc.OutputColor, aCubeColors[uCubeIdx % ARRAYSIZE(aCubeColors)]);
+
+			if (FAILED(game->GetRenderer()->AddEntity(cubeDesc)))
+			{
+				return 0;
+			}
+		}
+	}
+
+	if (FAILED(game->GetRenderer()->SetInstancedPipelineState(L"LightCube", L"LightCubeInstanced")))
+	{
+		return 0;
+	}
+
+	// Rows of pillars that never move, merged into the static batches by the renderer
+	constexpr const UINT NUM_PILLARS_X = 32u;
+	constexpr const UINT NUM_PILLARS_Z = 32u;
+	constexpr const FLOAT PILLAR_SPACING = 12.0f;
+	constexpr const FLOAT PILLAR_HEIGHT = 6.0f;
+	const XMVECTORF32 aPillarColors[] =
+	{
+		Colors::SlateGray, Colors::DarkKhaki
+	};
+	for (UINT z = 0u; z < NUM_PILLARS_Z; ++z)
+	{
+		for (UINT x = 0u; x < NUM_PILLARS_X; ++x)
+		{
+			const UINT uPillarIdx = z * NUM_PILLARS_X + x;
+			XMStoreFloat4(&color, aPillarColors[uPillarIdx % ARRAYSIZE(aPillarColors)]);
+
+			std::shared_ptr<Cube> pillar = std::make_shared<Cube>(color);
+			pillar->Scale(0.5f, PILLAR_HEIGHT, 0.5f);
+			pillar->Translate(
+				XMVectorSet(
+					PILLAR_SPACING * (static_cast<FLOAT>(x) - static_cast<FLOAT>(NUM_PILLARS_X - 1u) / 2.0f),
+					PILLAR_HEIGHT + 20.0f,
+					PILLAR_SPACING * (static_cast<FLOAT>(z) - static_cast<FLOAT>(NUM_PILLARS_Z - 1u) / 2.0f),
+					0.0f
+				)
+			);
+			pillar->SetStatic(TRUE);
+
+			WCHAR szPillarName[32];
+			swprintf_s(szPillarName, L"Pillar%u", uPillarIdx);
+			if (FAILED(game->GetRenderer()->AddRenderable(szPillarName, pillar)))
+			{
+				return 0;
+			}
+
+			if (FAILED(game->GetRenderer()->SetPipelineStateOfRenderable(szPillarName, L"LightCube")))
+			{
+				return 0;
+			}
+		}
+	}
+
 	std::ofstream sceneFile;
 	sceneFile.open("HeightMap.txt");
 	constexpr const UINT MAP_WIDTH = 256u;
@@ -293,19 +560,47 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
-	if (FAILED(game->GetRenderer()->SetVertexShaderOfScene(L"VoxelMap", L"VoxelShader")))
+	if (FAILED(game->GetRenderer()->SetPipelineStateOfScene(L"VoxelMap", L"Voxel")))
 	{
 		return 0;
 	}
 
-	if (FAILED(game->GetRenderer()->SetPixelShaderOfScene(L"VoxelMap", L"VoxelShader")))
+	if (FAILED(game->GetRenderer()->SetMainScene(L"VoxelMap")))
 	{
 		return 0;
 	}
 
-	if (FAILED(game->GetRenderer()->SetMainScene(L"VoxelMap")))
+	// "Game.exe image.png" renders the scene on the CPU to the image instead of opening a window
+	// "Game.exe image.png --golden golden.png" also fails when the image does not match the golden image, or when there is none yet
+	// "--trace <file>" traces the first frames of the window for the TraceStats tool
+	// "--benchmark [frames]" measures the CPU side of the frames, recorded instead of drawn
+	constexpr const WCHAR TRACE_OPTION[] = L"--trace ";
+	constexpr const UINT TRACE_NUM_FRAMES = 300u;
+	constexpr const WCHAR BENCHMARK_OPTION[] = L"--benchmark";
+	constexpr const UINT BENCHMARK_NUM_FRAMES = 600u;
+	constexpr const WCHAR GOLDEN_OPTION[] = L" --golden ";
+	constexpr const FLOAT SIMULATION_STEPS_PER_SECOND = 30.0f;
+	constexpr const UINT MAX_SIMULATION_STEPS_PER_FRAME = 4u;
+	const BOOL bTrace = lpCmdLine && wcsncmp(lpCmdLine, TRACE_OPTION, ARRAYSIZE(TRACE_OPTION) - 1u) == 0;
+
+	if (lpCmdLine && wcsncmp(lpCmdLine, BENCHMARK_OPTION, ARRAYSIZE(BENCHMARK_OPTION) - 1u) == 0)
 	{
-		return 0;
+		const INT iNumFrames = _wtoi(lpCmdLine + ARRAYSIZE(BENCHMARK_OPTION) - 1u);
+		return SUCCEEDED(game->Benchmark(800u, 600u, iNumFrames > 0 ? static_cast<UINT>(iNumFrames) : BENCHMARK_NUM_FRAMES)) ? 0 : 1;
+	}
+
+	if (!bTrace && lpCmdLine && lpCmdLine[0] != L'\0')
+	{
+		std::wstring imagePath(lpCmdLine);
+		std::wstring goldenPath;
+		const size_t uGoldenOption = imagePath.find(GOLDEN_OPTION);
+		if (uGoldenOption != std::wstring::npos)
+		{
+			goldenPath = imagePath.substr(uGoldenOption + ARRAYSIZE(GOLDEN_OPTION) - 1u);
+			imagePath.resize(uGoldenOption);
+		}
+
+		return SUCCEEDED(game->RenderToFile(imagePath, 800u, 600u, 60u, goldenPath)) ? 0 : 1;
 	}
 
 	if (FAILED(game->Initialize(hInstance, nCmdShow)))
@@ -313,5 +608,38 @@ INT WINAPI wWinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
 		return 0;
 	}
 
-	return game->Run();
+	// The animation and crowds update at a bounded rate, the frames are drawn in between
+	game->GetTimestep().SetStepRate(SIMULATION_STEPS_PER_SECOND);
+	game->GetTimestep().SetMaxStepsPerFrame(MAX_SIMULATION_STEPS_PER_FRAME);
+
+	if (bTrace && FAILED(game->GetRenderer()->BeginTrace(lpCmdLine + ARRAYSIZE(TRACE_OPTION) - 1u, TRACE_NUM_FRAMES)))
+	{
+		return 0;
+	}
+
+#ifdef _DEBUG
+	// The frames after the warm up take their memory from the frame arena, any heap allocation asserts
+	game->GetRenderer()->SetHeapAllocationCheck(TRUE);
+#endif
+
+	const INT status = game->Run();
+
+	// Time to first frame is tracked in every build
+	FILE* pFile = nullptr;
+	if (fopen_s(&pFile, "StartupReport.txt", "w") == 0)
+	{
+		game->GetRenderer()->WriteStartupReport(pFile);
+		fclose(pFile);
+	}
+
+#ifdef _DEBUG
+	// Live memory of the scene still loaded, and the peaks of the whole run
+	if (fopen_s(&pFile, "MemoryReport.txt", "w") == 0)
+	{
+		library::MemoryTracker::Dump(pFile);
+		fclose(pFile);
+	}
+#endif
+
+	return status;
 }
\ No newline at end of file
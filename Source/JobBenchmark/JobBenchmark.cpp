@@ -0,0 +1,257 @@
+/*+===================================================================
+  File:      JOBBENCHMARK.CPP
+
+  Summary:   Command line benchmark of the job system, measuring how
+             three workloads scale from 1 to N threads:
+               animation  bone hierarchies of many skeletons, one
+                          ParallelFor over the skeletons, like
+                          Renderer::Update over the models
+               fine       a ParallelFor over many tiny items, which
+                          measures the scheduling overhead
+               graph      two waves of jobs, the second depending on
+                          the counter of the first
+
+             Depends only on the standard library and the job system,
+             so it also builds on Linux:
+               g++ -std=c++20 -O2 -pthread -I../Library JobBenchmark.cpp
+                   ../Library/Job/JobSystem.cpp
+                   ../Library/Job/WorkStealingDeque.cpp -o JobBenchmark
+
+             Usage: JobBenchmark [max threads] [iterations]
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "Job/JobSystem.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr std::uint32_t NUM_SKELETONS = 2048u;
+    constexpr std::uint32_t NUM_BONES = 64u;
+    constexpr std::uint32_t NUM_FINE_ITEMS = 1u << 20u;
+    constexpr std::uint32_t NUM_GRAPH_JOBS = 256u;
+    constexpr std::uint32_t GRAPH_JOB_SIZE = 2048u;
+
+    struct Matrix
+    {
+        float m[4][4];
+    };
+
+    Matrix multiply(const Matrix& a, const Matrix& b)
+    {
+        Matrix result = {};
+        for (int r = 0; r < 4; ++r)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                result.m[r][c] = a.m[r][0] * b.m[0][c] + a.m[r][1] * b.m[1][c] + a.m[r][2] * b.m[2][c] + a.m[r][3] * b.m[3][c];
+            }
+        }
+        return result;
+    }
+
+    Matrix rotationZ(float angle)
+    {
+        const float s = std::sin(angle);
+        const float c = std::cos(angle);
+        return Matrix{ { { c, s, 0.0f, 0.0f }, { -s, c, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.1f, 0.0f, 1.0f } } };
+    }
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Workloads
+
+      Summary:  Inputs and outputs of the three workloads, each of
+                which returns a checksum that must not depend on the
+                number of threads
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class Workloads final
+    {
+    public:
+        Workloads()
+            : m_aBones(static_cast<std::size_t>(NUM_SKELETONS) * NUM_BONES)
+            , m_aFine(NUM_FINE_ITEMS)
+            , m_aGraph(static_cast<std::size_t>(NUM_GRAPH_JOBS) * GRAPH_JOB_SIZE)
+            , m_aSmoothed(m_aGraph.size())
+        {
+        }
+
+        double Animation(JobSystem& jobSystem)
+        {
+            jobSystem.ParallelFor(0u, NUM_SKELETONS, 0u, [this](std::uint32_t uSkeleton)
+            {
+                Matrix* aBones = &m_aBones[static_cast<std::size_t>(uSkeleton) * NUM_BONES];
+                aBones[0] = rotationZ(static_cast<float>(uSkeleton));
+                for (std::uint32_t uBone = 1u; uBone < NUM_BONES; ++uBone)
+                {
+                    aBones[uBone] = multiply(rotationZ(0.1f * static_cast<float>(uBone)), aBones[(uBone - 1u) / 2u]);
+                }
+            });
+
+            double checksum = 0.0;
+            for (std::uint32_t uSkeleton = 0u; uSkeleton < NUM_SKELETONS; ++uSkeleton)
+            {
+                checksum += m_aBones[static_cast<std::size_t>(uSkeleton) * NUM_BONES + NUM_BONES - 1u].m[3][1];
+            }
+            return checksum;
+        }
+
+        double Fine(JobSystem& jobSystem)
+        {
+            jobSystem.ParallelFor(0u, NUM_FINE_ITEMS, 0u, [this](std::uint32_t i)
+            {
+                m_aFine[i] = static_cast<float>(i) * 0.5f + 1.0f;
+            });
+
+            double checksum = 0.0;
+            for (std::uint32_t i = 0u; i < NUM_FINE_ITEMS; i += 4096u)
+            {
+                checksum += m_aFine[i];
+            }
+            return checksum;
+        }
+
+        double Graph(JobSystem& jobSystem)
+        {
+            JobCounter first;
+            JobCounter second;
+            for (std::uint32_t uJob = 0u; uJob < NUM_GRAPH_JOBS; ++uJob)
+            {
+                jobSystem.Run(&Workloads::fillJob, this, uJob * GRAPH_JOB_SIZE, (uJob + 1u) * GRAPH_JOB_SIZE, &first);
+            }
+            for (std::uint32_t uJob = 0u; uJob < NUM_GRAPH_JOBS; ++uJob)
+            {
+                jobSystem.Run(&Workloads::smoothJob, this, uJob * GRAPH_JOB_SIZE, (uJob + 1u) * GRAPH_JOB_SIZE, &second, &first);
+            }
+            jobSystem.Wait(second);
+
+            double checksum = 0.0;
+            for (std::size_t i = 0u; i < m_aSmoothed.size(); i += 4096u)
+            {
+                checksum += m_aSmoothed[i];
+            }
+            return checksum;
+        }
+
+    private:
+        static void fillJob(void* pData, std::uint32_t uBegin, std::uint32_t uEnd)
+        {
+            Workloads& workloads = *static_cast<Workloads*>(pData);
+            for (std::uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                workloads.m_aGraph[i] = std::sqrt(static_cast<float>(i));
+            }
+        }
+
+        static void smoothJob(void* pData, std::uint32_t uBegin, std::uint32_t uEnd)
+        {
+            // Reads the neighbours filled by other jobs of the first wave
+            Workloads& workloads = *static_cast<Workloads*>(pData);
+            const std::uint32_t uSize = static_cast<std::uint32_t>(workloads.m_aGraph.size());
+            for (std::uint32_t i = uBegin; i < uEnd; ++i)
+            {
+                workloads.m_aSmoothed[i] = 0.5f * (workloads.m_aGraph[i] + workloads.m_aGraph[(i + GRAPH_JOB_SIZE) % uSize]);
+            }
+        }
+
+    private:
+        std::vector<Matrix> m_aBones;
+        std::vector<float> m_aFine;
+        std::vector<float> m_aGraph;
+        std::vector<float> m_aSmoothed;
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: measure
+
+      Summary:  Runs a workload a number of times and returns the
+                average time of a run
+
+      Args:     std::uint32_t uNumIterations
+                  Number of timed runs, after one warm up run
+                const std::function<double()>& workload
+                  Workload to run
+                double* pChecksum
+                  Receives the checksum of the last run
+
+      Returns:  double
+                  Milliseconds per run
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    double measure(std::uint32_t uNumIterations, const std::function<double()>& workload, double* pChecksum)
+    {
+        *pChecksum = workload();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (std::uint32_t i = 0u; i < uNumIterations; ++i)
+        {
+            *pChecksum = workload();
+        }
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        return elapsed.count() / static_cast<double>(uNumIterations);
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Measures each workload with 1 to N threads and prints the
+            time per run and the speed up over one thread
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Maximum number of threads, then number of iterations
+
+  Returns:  int
+              0
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    const std::uint32_t uMaxThreads = argc > 1
+        ? static_cast<std::uint32_t>(std::max(std::atoi(argv[1]), 1))
+        : std::max(std::thread::hardware_concurrency(), 1u);
+    const std::uint32_t uNumIterations = argc > 2 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[2]), 1)) : 20u;
+
+    Workloads workloads;
+    double aBaselines[3] = {};
+
+    std::printf("%8s %12s %9s %12s %9s %12s %9s\n", "threads", "animation", "speed up", "fine", "speed up", "graph", "speed up");
+    for (std::uint32_t uNumThreads = 1u; uNumThreads <= uMaxThreads; ++uNumThreads)
+    {
+        JobSystem jobSystem;
+        jobSystem.Initialize(uNumThreads);
+
+        double aChecksums[3] = {};
+        const double aTimes[3] =
+        {
+            measure(uNumIterations, [&]() { return workloads.Animation(jobSystem); }, &aChecksums[0]),
+            measure(uNumIterations, [&]() { return workloads.Fine(jobSystem); }, &aChecksums[1]),
+            measure(uNumIterations, [&]() { return workloads.Graph(jobSystem); }, &aChecksums[2]),
+        };
+
+        if (uNumThreads == 1u)
+        {
+            std::copy(std::begin(aTimes), std::end(aTimes), aBaselines);
+        }
+
+        std::printf("%8u", uNumThreads);
+        for (int i = 0; i < 3; ++i)
+        {
+            std::printf(" %10.3fms %8.2fx", aTimes[i], aBaselines[i] / aTimes[i]);
+        }
+        std::printf("   checksums %.3f %.3f %.3f\n", aChecksums[0], aChecksums[1], aChecksums[2]);
+
+        jobSystem.Shutdown();
+    }
+
+    return 0;
+}
@@ -7,15 +7,19 @@ namespace library
 
       Summary:  Constructor
 
-      Modifies: [m_yaw, m_pitch, m_moveLeftRight, m_moveBackForward,
+      Modifies: [m_yaw, m_pitch, m_previousYaw, m_previousPitch,
+                 m_moveLeftRight, m_moveBackForward,
                  m_moveUpDown, m_travelSpeed, m_rotationSpeed, 
                  m_padding, m_cameraForward, m_cameraRight, m_cameraUp, 
-                 m_eye, m_at, m_up, m_rotation, m_view].
+                 m_eye, m_at, m_up, m_previousEye, m_rotation, m_view,
+                 m_bHasPreviousState].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     Camera::Camera(_In_ const XMVECTOR& position) :
 
         m_yaw(0.0f),
         m_pitch(0.0f),
+        m_previousYaw(0.0f),
+        m_previousPitch(0.0f),
         m_moveLeftRight(0.0f),
         m_moveBackForward(0.0f),
         m_moveUpDown(0.0f),
@@ -28,8 +32,10 @@ namespace library
         m_eye(position),
         m_at(),
         m_up(),
+        m_previousEye(position),
         m_rotation(),
-        m_view()
+        m_view(),
+        m_bHasPreviousState(FALSE)
 
     {}
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -248,4 +254,72 @@ namespace library
         m_view = XMMatrixLookAtLH(m_eye, m_at, m_up);
     };
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::StorePreviousState
+
+      Summary:  Keeps the eye and orientation before a simulation
+                step, the start of the interpolation
+
+      Modifies: [m_previousEye, m_previousYaw, m_previousPitch,
+                 m_bHasPreviousState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Camera::StorePreviousState()
+    {
+        m_previousEye = m_eye;
+        m_previousYaw = m_yaw;
+        m_previousPitch = m_pitch;
+        m_bHasPreviousState = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::GetInterpolatedEye
+
+      Summary:  Returns the eye between the one before the last
+                simulation step and the current one
+
+      Args:     FLOAT alpha
+                  Fraction of a step elapsed since the last one
+
+      Returns:  XMVECTOR
+                  Interpolated eye
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR Camera::GetInterpolatedEye(_In_ FLOAT alpha) const
+    {
+        if (!m_bHasPreviousState || alpha >= 1.0f)
+        {
+            return m_eye;
+        }
+
+        return XMVectorLerp(m_previousEye, m_eye, alpha);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Camera::GetInterpolatedView
+
+      Summary:  Returns the view transform between the one before the
+                last simulation step and the current one. The yaw and
+                pitch are blended rather than the matrices, like Update
+                builds the view from them
+
+      Args:     FLOAT alpha
+                  Fraction of a step elapsed since the last one
+
+      Returns:  XMMATRIX
+                  Interpolated view transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX Camera::GetInterpolatedView(_In_ FLOAT alpha) const
+    {
+        if (!m_bHasPreviousState || alpha >= 1.0f)
+        {
+            return m_view;
+        }
+
+        const FLOAT yaw = m_previousYaw + alpha * (m_yaw - m_previousYaw);
+        const FLOAT pitch = m_previousPitch + alpha * (m_pitch - m_previousPitch);
+        const XMMATRIX rotation = XMMatrixRotationRollPitchYaw(pitch, yaw, 0.0f);
+        const XMVECTOR eye = GetInterpolatedEye(alpha);
+
+        return XMMatrixLookAtLH(eye, XMVector3TransformCoord(DEFAULT_FORWARD, rotation) + eye, XMVector3TransformCoord(DEFAULT_UP, rotation));
+    }
+
 }
\ No newline at end of file
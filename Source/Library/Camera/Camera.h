@@ -39,6 +39,14 @@ namespace library
                   Initialize the view matrix constant buffers
                 Update
                   Update the camera according to the input
+                StorePreviousState
+                  Keeps the position and orientation before a
+                  simulation step
+                GetInterpolatedEye
+                  Returns the eye between the last two simulation steps
+                GetInterpolatedView
+                  Returns the view transform between the last two
+                  simulation steps
                 Camera
                   Constructor.
                 ~Camera
@@ -64,6 +72,10 @@ namespace library
         virtual void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
         virtual HRESULT Initialize(_In_ ID3D11Device* device);
         virtual void Update(_In_ FLOAT deltaTime);
+
+        void StorePreviousState();
+        XMVECTOR GetInterpolatedEye(_In_ FLOAT alpha) const;
+        XMMATRIX GetInterpolatedView(_In_ FLOAT alpha) const;
     protected:
         static constexpr const XMVECTORF32 DEFAULT_FORWARD = { 0.0f, 0.0f, 1.0f, 0.0f };
         static constexpr const XMVECTORF32 DEFAULT_RIGHT = { 1.0f, 0.0f, 0.0f, 0.0f };
@@ -73,6 +85,8 @@ namespace library
 
         FLOAT m_yaw;
         FLOAT m_pitch;
+        FLOAT m_previousYaw;
+        FLOAT m_previousPitch;
 
         FLOAT m_moveLeftRight;
         FLOAT m_moveBackForward;
@@ -81,7 +95,7 @@ namespace library
         FLOAT m_travelSpeed;
         FLOAT m_rotationSpeed;
 
-        BYTE m_padding[12]; // struct alignment
+        BYTE m_padding[4]; // struct alignment
 
         XMVECTOR m_cameraForward;
         XMVECTOR m_cameraRight;
@@ -90,8 +104,11 @@ namespace library
         XMVECTOR m_eye;
         XMVECTOR m_at;
         XMVECTOR m_up;
+        XMVECTOR m_previousEye;
 
         XMMATRIX m_rotation;
         XMMATRIX m_view;
+
+        BOOL m_bHasPreviousState;
     };
 }
\ No newline at end of file
@@ -19,6 +19,10 @@
 #define WIN32_LEAN_AND_MEAN
 #endif // ! WIN32_LEAN_AND_MEAN
 
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // ! NOMINMAX
+
 #include <windows.h>
 #include <wincodec.h>
 #include <wrl.h>
@@ -39,6 +43,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -50,8 +55,8 @@ constexpr LPCWSTR PSZ_COURSE_TITLE = L"Game Graphics Programming";
 using namespace Microsoft::WRL;
 using namespace DirectX;
 
-#ifndef NUM_LIGHTS
-#define NUM_LIGHTS (2)
+#ifndef MAX_NUM_LIGHTS
+#define MAX_NUM_LIGHTS (1024)
 #endif
 
 #define ASSIMP_LOAD_FLAGS (aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices | aiProcess_ConvertToLeftHanded)
@@ -84,6 +89,18 @@ namespace library
         LONG Y;
     };
 
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   InputEvent
+
+        Summary:  Data structure that stores the input sampled by the
+                  window thread, passed to the simulation thread
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct InputEvent
+    {
+        DirectionsInput Directions;
+        MouseRelativeMovement MouseMovement;
+    };
+
     /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
         Enum:     eBlockType
 
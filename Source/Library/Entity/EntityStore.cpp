@@ -0,0 +1,646 @@
+#include "Entity/EntityStore.h"
+
+namespace library
+{
+    namespace
+    {
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: mergeBounds
+
+          Summary:  Grows bounds to hold other bounds. Empty bounds, whose
+                    minimum is above their maximum, hold nothing
+
+          Args:     AxisAlignedBox& bounds
+                      Bounds to grow
+                    const AxisAlignedBox& other
+                      Bounds to hold
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void mergeBounds(_Inout_ AxisAlignedBox& bounds, _In_ const AxisAlignedBox& other)
+        {
+            XMStoreFloat3(&bounds.Min, XMVectorMin(XMLoadFloat3(&bounds.Min), XMLoadFloat3(&other.Min)));
+            XMStoreFloat3(&bounds.Max, XMVectorMax(XMLoadFloat3(&bounds.Max), XMLoadFloat3(&other.Max)));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::forEachComponentArray
+
+      Summary:  Calls a function on every array indexed by the dense
+                index, so adding and removing entities keep them in step
+
+      Args:     const Function& function
+                  Function taking a component array
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <class Function>
+    void EntityStore::forEachComponentArray(_In_ const Function& function)
+    {
+        function(m_auEntitySlots);
+        function(m_aMeshes);
+        function(m_auParents);
+        function(m_auSubtreeSizes);
+        function(m_abDirty);
+        function(m_aPositions);
+        function(m_aRotations);
+        function(m_aScales);
+        function(m_aPreviousPositions);
+        function(m_aPreviousRotations);
+        function(m_aPreviousScales);
+        function(m_aSpinAxes);
+        function(m_aSpinSpeeds);
+        function(m_aWorldMatrices);
+        function(m_aLocalBounds);
+        function(m_aWorldBounds);
+        function(m_aSubtreeBounds);
+        function(m_aOutputColors);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::Add
+
+      Summary:  Adds an entity. A root is appended to the dense arrays,
+                a child is inserted at the end of the subtree of its
+                parent, which moves the entities after it. Its world
+                matrix and bounds are computed at once, and it stays
+                dirty so the bounds of its ancestors grow at the next
+                UpdateTransforms. Its previous transform is its current
+                one
+
+      Args:     const EntityDesc& desc
+                  Initial components of the entity
+
+      Modifies: [m_aSlots, m_auFreeSlots, every component array].
+
+      Returns:  EntityHandle
+                  Handle of the entity, a null handle when the parent
+                  is stale
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    EntityHandle EntityStore::Add(_In_ const EntityDesc& desc)
+    {
+        UINT uParent = NO_PARENT;
+        UINT uIndex = GetSize();
+        if (!desc.Parent.IsNull())
+        {
+            if (!IsValid(desc.Parent))
+            {
+                return EntityHandle();
+            }
+
+            uParent = m_aSlots[desc.Parent.uIndex].uDenseIndex;
+            uIndex = uParent + m_auSubtreeSizes[uParent];
+        }
+
+        UINT uSlot;
+        if (m_auFreeSlots.empty())
+        {
+            uSlot = static_cast<UINT>(m_aSlots.size());
+            m_aSlots.push_back(Slot{ .uGeneration = 0u, .uDenseIndex = 0u });
+        }
+        else
+        {
+            uSlot = m_auFreeSlots.back();
+            m_auFreeSlots.pop_back();
+        }
+
+        forEachComponentArray([uIndex](auto& aComponents)
+        {
+            aComponents.emplace(aComponents.begin() + uIndex);
+        });
+
+        // The entities after the new one move one place further
+        for (UINT i = uIndex + 1u; i < GetSize(); ++i)
+        {
+            m_aSlots[m_auEntitySlots[i]].uDenseIndex = i;
+            if (m_auParents[i] != NO_PARENT && m_auParents[i] >= uIndex)
+            {
+                ++m_auParents[i];
+            }
+        }
+        for (UINT uAncestor = uParent; uAncestor != NO_PARENT; uAncestor = m_auParents[uAncestor])
+        {
+            ++m_auSubtreeSizes[uAncestor];
+        }
+
+        m_aSlots[uSlot].uDenseIndex = uIndex;
+        m_auEntitySlots[uIndex] = uSlot;
+        m_aMeshes[uIndex] = desc.Mesh;
+        m_auParents[uIndex] = uParent;
+        m_auSubtreeSizes[uIndex] = 1u;
+        m_abDirty[uIndex] = TRUE;
+        m_aPositions[uIndex] = desc.Position;
+        m_aRotations[uIndex] = desc.Rotation;
+        m_aScales[uIndex] = desc.Scale;
+        m_aPreviousPositions[uIndex] = desc.Position;
+        m_aPreviousRotations[uIndex] = desc.Rotation;
+        m_aPreviousScales[uIndex] = desc.Scale;
+        m_aSpinAxes[uIndex] = desc.SpinAxis;
+        m_aSpinSpeeds[uIndex] = desc.SpinSpeed;
+        m_aLocalBounds[uIndex] = desc.LocalBounds;
+        m_aOutputColors[uIndex] = desc.OutputColor;
+
+        updateTransform(uIndex);
+        updateBounds(uIndex);
+        m_aSubtreeBounds[uIndex] = m_aWorldBounds[uIndex];
+
+        return EntityHandle{ .uIndex = uSlot, .uGeneration = m_aSlots[uSlot].uGeneration };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::Remove
+
+      Summary:  Removes the entity of a handle with its descendants.
+                The entities after its subtree move back in its place,
+                keeping their order, and its parent becomes dirty so its
+                bounds shrink at the next UpdateTransforms
+
+      Args:     EntityHandle handle
+                  Handle of the entity
+
+      Modifies: [m_aSlots, m_auFreeSlots, every component array].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG for a stale handle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT EntityStore::Remove(_In_ EntityHandle handle)
+    {
+        if (!IsValid(handle))
+        {
+            return E_INVALIDARG;
+        }
+
+        const UINT uIndex = m_aSlots[handle.uIndex].uDenseIndex;
+        const UINT uSize = m_auSubtreeSizes[uIndex];
+        const UINT uParent = m_auParents[uIndex];
+
+        for (UINT i = uIndex; i < uIndex + uSize; ++i)
+        {
+            ++m_aSlots[m_auEntitySlots[i]].uGeneration;
+            m_auFreeSlots.push_back(m_auEntitySlots[i]);
+        }
+
+        forEachComponentArray([uIndex, uSize](auto& aComponents)
+        {
+            aComponents.erase(aComponents.begin() + uIndex, aComponents.begin() + uIndex + uSize);
+        });
+
+        // No entity left after the subtree descends from it, so a parent at or after it was after it
+        for (UINT i = uIndex; i < GetSize(); ++i)
+        {
+            m_aSlots[m_auEntitySlots[i]].uDenseIndex = i;
+            if (m_auParents[i] != NO_PARENT && m_auParents[i] >= uIndex)
+            {
+                m_auParents[i] -= uSize;
+            }
+        }
+        for (UINT uAncestor = uParent; uAncestor != NO_PARENT; uAncestor = m_auParents[uAncestor])
+        {
+            m_auSubtreeSizes[uAncestor] -= uSize;
+        }
+
+        if (uParent != NO_PARENT)
+        {
+            m_abDirty[uParent] = TRUE;
+        }
+
+        return S_OK;
+    }
+
+    BOOL EntityStore::IsValid(_In_ EntityHandle handle) const
+    {
+        return handle.uIndex < m_aSlots.size() && m_aSlots[handle.uIndex].uGeneration == handle.uGeneration;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetIndex
+
+      Summary:  Returns the dense index of an entity, which addresses
+                its components until an entity is added as a child or
+                removed
+
+      Args:     EntityHandle handle
+                  Handle of the entity
+
+      Returns:  UINT
+                  Dense index, EntityHandle::INVALID_INDEX for a stale
+                  handle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT EntityStore::GetIndex(_In_ EntityHandle handle) const
+    {
+        return IsValid(handle) ? m_aSlots[handle.uIndex].uDenseIndex : EntityHandle::INVALID_INDEX;
+    }
+
+    UINT EntityStore::GetSize() const
+    {
+        return static_cast<UINT>(m_auEntitySlots.size());
+    }
+
+    void EntityStore::SetPosition(_In_ UINT uIndex, _In_ const XMFLOAT3& position)
+    {
+        m_aPositions[uIndex] = position;
+        m_abDirty[uIndex] = TRUE;
+    }
+
+    void EntityStore::SetRotation(_In_ UINT uIndex, _In_ const XMFLOAT4& rotation)
+    {
+        m_aRotations[uIndex] = rotation;
+        m_abDirty[uIndex] = TRUE;
+    }
+
+    void EntityStore::SetScale(_In_ UINT uIndex, _In_ const XMFLOAT3& scale)
+    {
+        m_aScales[uIndex] = scale;
+        m_abDirty[uIndex] = TRUE;
+    }
+
+    void EntityStore::SetSpin(_In_ UINT uIndex, _In_ const XMFLOAT3& axis, _In_ FLOAT speed)
+    {
+        m_aSpinAxes[uIndex] = axis;
+        m_aSpinSpeeds[uIndex] = speed;
+    }
+
+    void EntityStore::SetOutputColor(_In_ UINT uIndex, _In_ const XMFLOAT4& outputColor)
+    {
+        m_aOutputColors[uIndex] = outputColor;
+    }
+
+    void EntityStore::SetLocalBounds(_In_ UINT uIndex, _In_ const AxisAlignedBox& localBounds)
+    {
+        m_aLocalBounds[uIndex] = localBounds;
+        m_abDirty[uIndex] = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::Update
+
+      Summary:  Runs the systems of a simulation step in order: spin,
+                then transforms and bounds
+
+      Args:     FLOAT deltaTime
+                  Time of the step
+                JobSystem& jobSystem
+                  Job system running the ranges of the systems
+
+      Modifies: [m_aRotations, m_abDirty, m_aWorldMatrices,
+                 m_aWorldBounds, m_aSubtreeBounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::Update(_In_ FLOAT deltaTime, _In_ JobSystem& jobSystem)
+    {
+        Spin(deltaTime, jobSystem);
+        UpdateTransforms(jobSystem);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::Spin
+
+      Summary:  Animation system. Turns the rotation of every spinning
+                entity around its spin axis and marks it dirty. Reads
+                the spin arrays and writes the rotations
+
+      Args:     FLOAT deltaTime
+                  Time of the step
+                JobSystem& jobSystem
+                  Job system running the ranges
+
+      Modifies: [m_aRotations, m_abDirty].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::Spin(_In_ FLOAT deltaTime, _In_ JobSystem& jobSystem)
+    {
+        jobSystem.ParallelFor(0u, GetSize(), ENTITIES_PER_JOB, [this, deltaTime](std::uint32_t i)
+        {
+            if (m_aSpinSpeeds[i] == 0.0f)
+            {
+                return;
+            }
+
+            const XMVECTOR turn = XMQuaternionRotationNormal(XMLoadFloat3(&m_aSpinAxes[i]), m_aSpinSpeeds[i] * deltaTime);
+            XMStoreFloat4(&m_aRotations[i], XMQuaternionNormalize(XMQuaternionMultiply(XMLoadFloat4(&m_aRotations[i]), turn)));
+            m_abDirty[i] = TRUE;
+        });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::UpdateTransforms
+
+      Summary:  Transform and bounds system. Finds the subtrees rooted
+                at a dirty entity, skipping the dirty entities inside
+                them, and recomputes their world matrices and bounds,
+                each subtree in one pass in storage order. The subtrees
+                are disjoint and their parents are clean, so they run
+                in parallel. The subtree bounds of their ancestors are
+                grown afterwards. Clean subtrees are not touched
+
+      Args:     JobSystem& jobSystem
+                  Job system running the subtrees
+
+      Modifies: [m_abDirty, m_aWorldMatrices, m_aWorldBounds,
+                 m_aSubtreeBounds, m_aDirtySubtrees,
+                 m_auDirtyAncestors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::UpdateTransforms(_In_ JobSystem& jobSystem)
+    {
+        m_aDirtySubtrees.clear();
+        for (UINT i = 0u; i < GetSize();)
+        {
+            if (m_abDirty[i])
+            {
+                m_aDirtySubtrees.push_back(Range{ .uBegin = i, .uEnd = i + m_auSubtreeSizes[i] });
+                i += m_auSubtreeSizes[i];
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        // The subtrees differ in size, so they are split evenly over the threads rather than by a fixed grain
+        jobSystem.ParallelFor(0u, static_cast<std::uint32_t>(m_aDirtySubtrees.size()), 0u, [this](std::uint32_t i)
+        {
+            updateSubtree(m_aDirtySubtrees[i]);
+        });
+
+        updateAncestorBounds();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::StorePreviousTransforms
+
+      Summary:  Keeps the transforms before a simulation step, so the
+                frames drawn until the next step interpolate from them
+
+      Modifies: [m_aPreviousPositions, m_aPreviousRotations,
+                 m_aPreviousScales].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::StorePreviousTransforms()
+    {
+        std::copy(m_aPositions.begin(), m_aPositions.end(), m_aPreviousPositions.begin());
+        std::copy(m_aRotations.begin(), m_aRotations.end(), m_aPreviousRotations.begin());
+        std::copy(m_aScales.begin(), m_aScales.end(), m_aPreviousScales.begin());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetInterpolatedWorldMatrix
+
+      Summary:  Returns the world matrix of an entity between the last
+                two simulation steps. The scale and translation are
+                interpolated linearly and the rotation spherically, for
+                the entity and each of its ancestors
+
+      Args:     UINT uIndex
+                  Dense index of the entity
+                FLOAT alpha
+                  Fraction of a step since the previous transform, 1
+                  for the current one
+
+      Returns:  XMMATRIX
+                  Interpolated world matrix
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX EntityStore::GetInterpolatedWorldMatrix(_In_ UINT uIndex, _In_ FLOAT alpha) const
+    {
+        if (alpha >= 1.0f)
+        {
+            return XMLoadFloat4x4(&m_aWorldMatrices[uIndex]);
+        }
+
+        const XMVECTOR scale = XMVectorLerp(XMLoadFloat3(&m_aPreviousScales[uIndex]), XMLoadFloat3(&m_aScales[uIndex]), alpha);
+        const XMVECTOR rotation = XMQuaternionSlerp(XMLoadFloat4(&m_aPreviousRotations[uIndex]), XMLoadFloat4(&m_aRotations[uIndex]), alpha);
+        const XMVECTOR position = XMVectorLerp(XMLoadFloat3(&m_aPreviousPositions[uIndex]), XMLoadFloat3(&m_aPositions[uIndex]), alpha);
+
+        const XMMATRIX local = XMMatrixScalingFromVector(scale) * XMMatrixRotationQuaternion(rotation) * XMMatrixTranslationFromVector(position);
+        if (m_auParents[uIndex] == NO_PARENT)
+        {
+            return local;
+        }
+
+        return local * GetInterpolatedWorldMatrix(m_auParents[uIndex], alpha);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetMeshes
+
+      Summary:  Returns the mesh component of each entity, a null handle
+                for the entities without mesh
+
+      Returns:  const std::vector<ResourceHandle<Renderable>>&
+                  Mesh handles, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<ResourceHandle<Renderable>>& EntityStore::GetMeshes() const
+    {
+        return m_aMeshes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetParents
+
+      Summary:  Returns the dense index of the parent of each entity
+
+      Returns:  const std::vector<UINT>&
+                  Parent indices, NO_PARENT for the roots
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<UINT>& EntityStore::GetParents() const
+    {
+        return m_auParents;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetSubtreeSizes
+
+      Summary:  Returns the number of entities of the subtree of each
+                entity, itself included, following it in dense order
+
+      Returns:  const std::vector<UINT>&
+                  Subtree sizes, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<UINT>& EntityStore::GetSubtreeSizes() const
+    {
+        return m_auSubtreeSizes;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetWorldMatrices
+
+      Summary:  Returns the world matrices computed by the last
+                UpdateTransforms
+
+      Returns:  const std::vector<XMFLOAT4X4>&
+                  World matrices, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<XMFLOAT4X4>& EntityStore::GetWorldMatrices() const
+    {
+        return m_aWorldMatrices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetWorldBounds
+
+      Summary:  Returns the world bounds of the mesh of each entity
+
+      Returns:  const std::vector<AxisAlignedBox>&
+                  World bounds, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<AxisAlignedBox>& EntityStore::GetWorldBounds() const
+    {
+        return m_aWorldBounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetSubtreeBounds
+
+      Summary:  Returns the world bounds of the subtree of each entity,
+                which the culling tests before its entities
+
+      Returns:  const std::vector<AxisAlignedBox>&
+                  Subtree bounds, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<AxisAlignedBox>& EntityStore::GetSubtreeBounds() const
+    {
+        return m_aSubtreeBounds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::GetOutputColors
+
+      Summary:  Returns the output color of each entity
+
+      Returns:  const std::vector<XMFLOAT4>&
+                  Output colors, by dense index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<XMFLOAT4>& EntityStore::GetOutputColors() const
+    {
+        return m_aOutputColors;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::updateSubtree
+
+      Summary:  Recomputes the world matrices and bounds of a subtree
+                whose parent is clean. A parent comes before its
+                children, so one pass forward composes the matrices,
+                and one pass backward folds the bounds of every child
+                into its parent
+
+      Args:     const Range& range
+                  Dense indices of the subtree
+
+      Modifies: [m_abDirty, m_aWorldMatrices, m_aWorldBounds,
+                 m_aSubtreeBounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::updateSubtree(_In_ const Range& range)
+    {
+        for (UINT i = range.uBegin; i < range.uEnd; ++i)
+        {
+            updateTransform(i);
+            updateBounds(i);
+            m_aSubtreeBounds[i] = m_aWorldBounds[i];
+            m_abDirty[i] = FALSE;
+        }
+
+        for (UINT i = range.uEnd - 1u; i > range.uBegin; --i)
+        {
+            mergeBounds(m_aSubtreeBounds[m_auParents[i]], m_aSubtreeBounds[i]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::updateAncestorBounds
+
+      Summary:  Recomputes the subtree bounds of the ancestors of the
+                updated subtrees from their own bounds and the ones of
+                their children. Each ancestor is collected once, and
+                they are processed from the last to the first, so the
+                children of an ancestor are done before it
+
+      Modifies: [m_abDirty, m_aSubtreeBounds, m_auDirtyAncestors].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::updateAncestorBounds()
+    {
+        // The dirty flags are all clear by now, they mark the collected ancestors
+        m_auDirtyAncestors.clear();
+        for (const Range& range : m_aDirtySubtrees)
+        {
+            for (UINT uAncestor = m_auParents[range.uBegin]; uAncestor != NO_PARENT && !m_abDirty[uAncestor]; uAncestor = m_auParents[uAncestor])
+            {
+                m_abDirty[uAncestor] = TRUE;
+                m_auDirtyAncestors.push_back(uAncestor);
+            }
+        }
+
+        std::sort(m_auDirtyAncestors.begin(), m_auDirtyAncestors.end(), [](UINT a, UINT b) { return a > b; });
+
+        for (UINT uAncestor : m_auDirtyAncestors)
+        {
+            AxisAlignedBox bounds = m_aWorldBounds[uAncestor];
+            for (UINT uChild = uAncestor + 1u; uChild < uAncestor + m_auSubtreeSizes[uAncestor]; uChild += m_auSubtreeSizes[uChild])
+            {
+                mergeBounds(bounds, m_aSubtreeBounds[uChild]);
+            }
+
+            m_aSubtreeBounds[uAncestor] = bounds;
+            m_abDirty[uAncestor] = FALSE;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::updateTransform
+
+      Summary:  Composes the world matrix of an entity from its local
+                transform and the world matrix of its parent, which
+                must be up to date
+
+      Args:     UINT uIndex
+                  Dense index of the entity
+
+      Modifies: [m_aWorldMatrices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::updateTransform(_In_ UINT uIndex)
+    {
+        XMMATRIX world = XMMatrixScalingFromVector(XMLoadFloat3(&m_aScales[uIndex]))
+            * XMMatrixRotationQuaternion(XMLoadFloat4(&m_aRotations[uIndex]))
+            * XMMatrixTranslationFromVector(XMLoadFloat3(&m_aPositions[uIndex]));
+        if (m_auParents[uIndex] != NO_PARENT)
+        {
+            world = XMMatrixMultiply(world, XMLoadFloat4x4(&m_aWorldMatrices[m_auParents[uIndex]]));
+        }
+
+        XMStoreFloat4x4(&m_aWorldMatrices[uIndex], world);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   EntityStore::updateBounds
+
+      Summary:  Transforms the local bounds of an entity by its world
+                matrix. The center is transformed, and the extents by
+                the absolute value of the linear part, which gives the
+                same box as the eight corners for a quarter of the work.
+                Empty local bounds stay empty
+
+      Args:     UINT uIndex
+                  Dense index of the entity
+
+      Modifies: [m_aWorldBounds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void EntityStore::updateBounds(_In_ UINT uIndex)
+    {
+        if (m_aLocalBounds[uIndex].Min.x > m_aLocalBounds[uIndex].Max.x)
+        {
+            m_aWorldBounds[uIndex] = m_aLocalBounds[uIndex];
+            return;
+        }
+
+        const XMMATRIX world = XMLoadFloat4x4(&m_aWorldMatrices[uIndex]);
+        const XMVECTOR localMin = XMLoadFloat3(&m_aLocalBounds[uIndex].Min);
+        const XMVECTOR localMax = XMLoadFloat3(&m_aLocalBounds[uIndex].Max);
+        const XMVECTOR localCenter = XMVectorScale(XMVectorAdd(localMin, localMax), 0.5f);
+        const XMVECTOR localExtents = XMVectorScale(XMVectorSubtract(localMax, localMin), 0.5f);
+
+        const XMVECTOR center = XMVector3Transform(localCenter, world);
+        const XMVECTOR extents = XMVectorAdd(
+            XMVectorAdd(
+                XMVectorMultiply(XMVectorAbs(world.r[0]), XMVectorSplatX(localExtents)),
+                XMVectorMultiply(XMVectorAbs(world.r[1]), XMVectorSplatY(localExtents))
+            ),
+            XMVectorMultiply(XMVectorAbs(world.r[2]), XMVectorSplatZ(localExtents))
+        );
+
+        XMStoreFloat3(&m_aWorldBounds[uIndex].Min, XMVectorSubtract(center, extents));
+        XMStoreFloat3(&m_aWorldBounds[uIndex].Max, XMVectorAdd(center, extents));
+    }
+}
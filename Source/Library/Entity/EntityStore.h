@@ -0,0 +1,233 @@
+/*+===================================================================
+  File:      ENTITYSTORE.H
+
+  Summary:   EntityStore header file contains the data oriented store
+             of the entities, their components in dense arrays, their
+             hierarchy of transforms, and the systems updating them.
+
+  Classes: EntityStore
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <cfloat>
+
+#include "Job/JobSystem.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/ResourceRegistry.h"
+
+namespace library
+{
+    class Renderable;
+    class EntityStore;
+
+    typedef ResourceHandle<EntityStore> EntityHandle;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   EntityDesc
+
+      Summary:  Initial components of an entity
+
+      Members:  ResourceHandle<Renderable> Mesh
+                  Mesh drawing the entity, resolved by the renderer. An
+                  entity without mesh only carries a transform, as a
+                  parent of other entities
+                EntityHandle Parent
+                  Entity the transform is relative to, none for a root
+                XMFLOAT3 Position
+                  Translation of the entity, relative to its parent
+                XMFLOAT4 Rotation
+                  Rotation quaternion of the entity, relative to its
+                  parent
+                XMFLOAT3 Scale
+                  Scale of the entity, relative to its parent
+                XMFLOAT3 SpinAxis
+                  Normalized axis the entity spins around
+                FLOAT SpinSpeed
+                  Spin speed in radians per second, 0 for none
+                XMFLOAT4 OutputColor
+                  Color of the entity
+                AxisAlignedBox LocalBounds
+                  Bounds of the mesh in its own space, empty (minimum
+                  above maximum) for none
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct EntityDesc
+    {
+        ResourceHandle<Renderable> Mesh;
+        EntityHandle Parent;
+        XMFLOAT3 Position = XMFLOAT3(0.0f, 0.0f, 0.0f);
+        XMFLOAT4 Rotation = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+        XMFLOAT3 Scale = XMFLOAT3(1.0f, 1.0f, 1.0f);
+        XMFLOAT3 SpinAxis = XMFLOAT3(0.0f, 1.0f, 0.0f);
+        FLOAT SpinSpeed = 0.0f;
+        XMFLOAT4 OutputColor = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        AxisAlignedBox LocalBounds = { .Min = XMFLOAT3(FLT_MAX, FLT_MAX, FLT_MAX), .Max = XMFLOAT3(-FLT_MAX, -FLT_MAX, -FLT_MAX) };
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    EntityStore
+
+      Summary:  Stores every component of the entities in its own dense
+                array, indexed by the dense index of the entity, and
+                addresses the entities with generational handles like
+                ResourceRegistry. The entities form a hierarchy of
+                transforms, stored depth first: a parent comes before
+                its children, and each subtree is a contiguous range
+                starting at its root. Adding a child inserts it at the
+                end of the subtree of its parent, and removing an entity
+                removes its subtree, so the dense indices after them
+                move. Roots are appended, which keeps flat stores as
+                cheap as before. The systems run over the arrays in
+                order, split in ranges on the job system: Spin turns the
+                rotations, and UpdateTransforms recomputes the world
+                matrices and bounds of the changed subtrees only, then
+                grows the bounds of their ancestors. Nothing is virtual,
+                and each system only touches the arrays it reads and
+                writes
+
+      Methods:  Add
+                  Adds an entity
+                Remove
+                  Removes an entity and its descendants
+                IsValid
+                  Returns whether a handle refers to an entity
+                GetIndex
+                  Returns the dense index of an entity
+                GetSize
+                  Returns the number of entities
+                SetPosition
+                  Sets the translation of an entity
+                SetRotation
+                  Sets the rotation of an entity
+                SetScale
+                  Sets the scale of an entity
+                SetSpin
+                  Sets the spin of an entity
+                SetOutputColor
+                  Sets the color of an entity
+                SetLocalBounds
+                  Sets the local bounds of an entity
+                Update
+                  Runs the systems in order
+                Spin
+                  Turns the spinning entities
+                UpdateTransforms
+                  Recomputes the world matrices and bounds of the
+                  changed subtrees
+                StorePreviousTransforms
+                  Keeps the transforms before a simulation step
+                GetInterpolatedWorldMatrix
+                  Returns the world matrix of an entity between the
+                  last two simulation steps
+                GetMeshes
+                  Returns the mesh components
+                GetParents
+                  Returns the dense indices of the parents
+                GetSubtreeSizes
+                  Returns the sizes of the subtrees
+                GetWorldMatrices
+                  Returns the world matrices
+                GetWorldBounds
+                  Returns the world bounds of the entities
+                GetSubtreeBounds
+                  Returns the world bounds of the subtrees
+                GetOutputColors
+                  Returns the colors
+                EntityStore
+                  Constructor.
+                ~EntityStore
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class EntityStore final
+    {
+    public:
+        static constexpr std::uint32_t ENTITIES_PER_JOB = 1024u;
+        static constexpr UINT NO_PARENT = 0xFFFFFFFF;
+
+    public:
+        EntityStore() = default;
+        EntityStore(const EntityStore& other) = delete;
+        EntityStore(EntityStore&& other) = delete;
+        EntityStore& operator=(const EntityStore& other) = delete;
+        EntityStore& operator=(EntityStore&& other) = delete;
+        ~EntityStore() = default;
+
+        EntityHandle Add(_In_ const EntityDesc& desc);
+        HRESULT Remove(_In_ EntityHandle handle);
+        BOOL IsValid(_In_ EntityHandle handle) const;
+        UINT GetIndex(_In_ EntityHandle handle) const;
+        UINT GetSize() const;
+
+        void SetPosition(_In_ UINT uIndex, _In_ const XMFLOAT3& position);
+        void SetRotation(_In_ UINT uIndex, _In_ const XMFLOAT4& rotation);
+        void SetScale(_In_ UINT uIndex, _In_ const XMFLOAT3& scale);
+        void SetSpin(_In_ UINT uIndex, _In_ const XMFLOAT3& axis, _In_ FLOAT speed);
+        void SetOutputColor(_In_ UINT uIndex, _In_ const XMFLOAT4& outputColor);
+        void SetLocalBounds(_In_ UINT uIndex, _In_ const AxisAlignedBox& localBounds);
+
+        void Update(_In_ FLOAT deltaTime, _In_ JobSystem& jobSystem);
+        void Spin(_In_ FLOAT deltaTime, _In_ JobSystem& jobSystem);
+        void UpdateTransforms(_In_ JobSystem& jobSystem);
+        void StorePreviousTransforms();
+        XMMATRIX GetInterpolatedWorldMatrix(_In_ UINT uIndex, _In_ FLOAT alpha) const;
+
+        const std::vector<ResourceHandle<Renderable>>& GetMeshes() const;
+        const std::vector<UINT>& GetParents() const;
+        const std::vector<UINT>& GetSubtreeSizes() const;
+        const std::vector<XMFLOAT4X4>& GetWorldMatrices() const;
+        const std::vector<AxisAlignedBox>& GetWorldBounds() const;
+        const std::vector<AxisAlignedBox>& GetSubtreeBounds() const;
+        const std::vector<XMFLOAT4>& GetOutputColors() const;
+
+    private:
+        struct Slot
+        {
+            UINT uGeneration;
+            UINT uDenseIndex;
+        };
+
+        struct Range
+        {
+            UINT uBegin;
+            UINT uEnd;
+        };
+
+    private:
+        template <class Function>
+        void forEachComponentArray(_In_ const Function& function);
+
+        void updateSubtree(_In_ const Range& range);
+        void updateAncestorBounds();
+        void updateTransform(_In_ UINT uIndex);
+        void updateBounds(_In_ UINT uIndex);
+
+    private:
+        std::vector<Slot> m_aSlots;
+        std::vector<UINT> m_auFreeSlots;
+        std::vector<UINT> m_auEntitySlots;
+
+        std::vector<ResourceHandle<Renderable>> m_aMeshes;
+        std::vector<UINT> m_auParents;
+        std::vector<UINT> m_auSubtreeSizes;
+        std::vector<BYTE> m_abDirty;
+        std::vector<XMFLOAT3> m_aPositions;
+        std::vector<XMFLOAT4> m_aRotations;
+        std::vector<XMFLOAT3> m_aScales;
+        std::vector<XMFLOAT3> m_aPreviousPositions;
+        std::vector<XMFLOAT4> m_aPreviousRotations;
+        std::vector<XMFLOAT3> m_aPreviousScales;
+        std::vector<XMFLOAT3> m_aSpinAxes;
+        std::vector<FLOAT> m_aSpinSpeeds;
+        std::vector<XMFLOAT4X4> m_aWorldMatrices;
+        std::vector<AxisAlignedBox> m_aLocalBounds;
+        std::vector<AxisAlignedBox> m_aWorldBounds;
+        std::vector<AxisAlignedBox> m_aSubtreeBounds;
+        std::vector<XMFLOAT4> m_aOutputColors;
+
+        std::vector<Range> m_aDirtySubtrees;
+        std::vector<UINT> m_auDirtyAncestors;
+    };
+}
@@ -0,0 +1,143 @@
+#include "Game/FixedTimestep.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::FixedTimestep
+
+      Summary:  Constructor of a variable step, one per frame
+
+      Modifies: [m_fixedStepSeconds, m_stepSeconds, m_accumulatedSeconds,
+                 m_alpha, m_uMaxStepsPerFrame, m_uNumSteps,
+                 m_uNumDroppedSteps].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FixedTimestep::FixedTimestep()
+        : m_fixedStepSeconds(0.0f)
+        , m_stepSeconds(0.0f)
+        , m_accumulatedSeconds(0.0f)
+        , m_alpha(1.0f)
+        , m_uMaxStepsPerFrame(DEFAULT_MAX_STEPS_PER_FRAME)
+        , m_uNumSteps(0u)
+        , m_uNumDroppedSteps(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::SetStepRate
+
+      Summary:  Sets the number of steps per second. The next frame
+                runs a step at once, so there is always a state to
+                draw
+
+      Args:     FLOAT stepsPerSecond
+                  Steps per second, 0 for one step per frame
+
+      Modifies: [m_fixedStepSeconds, m_stepSeconds, m_accumulatedSeconds,
+                 m_alpha].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FixedTimestep::SetStepRate(_In_ FLOAT stepsPerSecond)
+    {
+        m_fixedStepSeconds = stepsPerSecond > 0.0f ? 1.0f / stepsPerSecond : 0.0f;
+        m_stepSeconds = m_fixedStepSeconds;
+        m_accumulatedSeconds = m_fixedStepSeconds;
+        m_alpha = 1.0f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::SetMaxStepsPerFrame
+
+      Summary:  Sets the maximum number of steps a frame runs to catch
+                up. The time of the steps beyond it is dropped, so the
+                simulation slows down instead of spiralling
+
+      Args:     UINT uMaxStepsPerFrame
+                  Maximum number of steps, at least 1
+
+      Modifies: [m_uMaxStepsPerFrame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FixedTimestep::SetMaxStepsPerFrame(_In_ UINT uMaxStepsPerFrame)
+    {
+        m_uMaxStepsPerFrame = std::max(uMaxStepsPerFrame, 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::Advance
+
+      Summary:  Adds the elapsed time of a frame to the accumulator and
+                takes the whole steps out of it
+
+      Args:     FLOAT elapsedSeconds
+                  Time since the previous frame
+
+      Modifies: [m_stepSeconds, m_accumulatedSeconds, m_alpha,
+                 m_uNumSteps, m_uNumDroppedSteps].
+
+      Returns:  UINT
+                  Number of steps of GetStepSeconds to run this frame,
+                  0 when the frame is shorter than what is left of a
+                  step
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT FixedTimestep::Advance(_In_ FLOAT elapsedSeconds)
+    {
+        if (!IsFixed())
+        {
+            m_stepSeconds = elapsedSeconds;
+            ++m_uNumSteps;
+            return 1u;
+        }
+
+        m_accumulatedSeconds += std::max(elapsedSeconds, 0.0f);
+
+        UINT uNumSteps = static_cast<UINT>(m_accumulatedSeconds / m_fixedStepSeconds);
+        if (uNumSteps > m_uMaxStepsPerFrame)
+        {
+            m_uNumDroppedSteps += uNumSteps - m_uMaxStepsPerFrame;
+            uNumSteps = m_uMaxStepsPerFrame;
+        }
+
+        // Only the fraction of a step is kept, whatever was dropped
+        m_accumulatedSeconds = std::clamp(m_accumulatedSeconds - static_cast<FLOAT>(uNumSteps) * m_fixedStepSeconds, 0.0f, m_fixedStepSeconds);
+        m_alpha = std::min(m_accumulatedSeconds / m_fixedStepSeconds, 1.0f);
+        m_uNumSteps += uNumSteps;
+
+        return uNumSteps;
+    }
+
+    BOOL FixedTimestep::IsFixed() const
+    {
+        return m_fixedStepSeconds > 0.0f;
+    }
+
+    FLOAT FixedTimestep::GetStepSeconds() const
+    {
+        return m_stepSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FixedTimestep::GetAlpha
+
+      Summary:  Returns the fraction of a step accumulated since the
+                last one, how far the frame is drawn between the state
+                before the last step and the current one
+
+      Returns:  FLOAT
+                  Fraction between 0 and 1, always 1 with a variable
+                  step
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT FixedTimestep::GetAlpha() const
+    {
+        return m_alpha;
+    }
+
+    UINT64 FixedTimestep::GetNumSteps() const
+    {
+        return m_uNumSteps;
+    }
+
+    UINT64 FixedTimestep::GetNumDroppedSteps() const
+    {
+        return m_uNumDroppedSteps;
+    }
+}
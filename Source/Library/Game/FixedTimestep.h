@@ -0,0 +1,85 @@
+/*+===================================================================
+  File:      FIXEDTIMESTEP.H
+
+  Summary:   FixedTimestep header file contains declarations of the
+             accumulator splitting the elapsed time of the frames into
+             simulation steps of a fixed length.
+
+  Classes: FixedTimestep
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FixedTimestep
+
+      Summary:  Accumulates the elapsed time of the frames and returns
+                how many steps of a fixed length the simulation runs
+                each frame, at most a maximum number so a slow frame
+                does not make the next ones slower. The time left over
+                is the fraction of a step the frame is drawn at,
+                between the last two simulation states. With a step
+                rate of 0, every frame is a single step of its elapsed
+                time
+
+      Methods:  SetStepRate
+                  Sets the number of steps per second
+                SetMaxStepsPerFrame
+                  Sets the maximum number of steps run by a frame
+                Advance
+                  Adds the elapsed time of a frame and returns the
+                  number of steps to run
+                IsFixed
+                  Returns whether the steps have a fixed length
+                GetStepSeconds
+                  Returns the length of the steps
+                GetAlpha
+                  Returns the fraction of a step elapsed since the last
+                  one
+                GetNumSteps
+                  Returns the number of steps run
+                GetNumDroppedSteps
+                  Returns the number of steps skipped to catch up
+                FixedTimestep
+                  Constructor.
+                ~FixedTimestep
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FixedTimestep final
+    {
+    public:
+        static constexpr UINT DEFAULT_MAX_STEPS_PER_FRAME = 5u;
+
+    public:
+        FixedTimestep();
+        FixedTimestep(const FixedTimestep& other) = delete;
+        FixedTimestep(FixedTimestep&& other) = delete;
+        FixedTimestep& operator=(const FixedTimestep& other) = delete;
+        FixedTimestep& operator=(FixedTimestep&& other) = delete;
+        ~FixedTimestep() = default;
+
+        void SetStepRate(_In_ FLOAT stepsPerSecond);
+        void SetMaxStepsPerFrame(_In_ UINT uMaxStepsPerFrame);
+        UINT Advance(_In_ FLOAT elapsedSeconds);
+
+        BOOL IsFixed() const;
+        FLOAT GetStepSeconds() const;
+        FLOAT GetAlpha() const;
+        UINT64 GetNumSteps() const;
+        UINT64 GetNumDroppedSteps() const;
+
+    private:
+        FLOAT m_fixedStepSeconds;
+        FLOAT m_stepSeconds;
+        FLOAT m_accumulatedSeconds;
+        FLOAT m_alpha;
+        UINT m_uMaxStepsPerFrame;
+        UINT64 m_uNumSteps;
+        UINT64 m_uNumDroppedSteps;
+    };
+}
@@ -1,5 +1,13 @@
 ﻿#include "Game/Game.h"
 
+#include <atomic>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "Job/SpscQueue.h"
+
 namespace library
 {
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -10,12 +18,13 @@ namespace library
 	  Args:     PCWSTR pszGameName
 				  Name of the game
 
-	  Modifies: [m_pszGameName, m_mainWindow, m_renderer].
+	  Modifies: [m_pszGameName, m_mainWindow, m_renderer, m_timestep].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Game::Game(_In_ PCWSTR pszGameName) :
 		m_pszGameName(pszGameName),
 		m_mainWindow(std::make_unique<MainWindow>()),
-		m_renderer(std::make_unique<Renderer>())
+		m_renderer(std::make_unique<Renderer>()),
+		m_timestep()
 
 	{}
 
@@ -56,7 +65,19 @@ namespace library
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Game::Run
 
-	  Summary:  Runs the game loop
+	  Summary:  Runs the game loop on three threads. The calling
+				thread pumps the window messages and sends the input to
+				the simulation thread through a queue. The simulation
+				thread runs the stages of the frame pipeline of the
+				renderer, the input and update stages being the ones of
+				the game, and hands every frame to the render thread,
+				which submits it while the next frame is simulated.
+				The simulation thread waits for the render thread to
+				take a frame before it builds the next one, so it
+				runs at most one frame ahead.
+				The update runs the steps of the time step, and the
+				frame is drawn between the last two steps, so the
+				simulation may run at a lower rate than the frames
 
 	  Returns:  INT
 				  Status code to return to the operating system
@@ -68,38 +89,383 @@ namespace library
 		LARGE_INTEGER startingTime, endingTime;
 		LARGE_INTEGER frequency;
 
-		float elapsedTime;
+		float elapsedTime = 0.0f;
+		InputEvent input = {};
+		DirectionsInput sentDirections = {};
+		SpscQueue<InputEvent, INPUT_QUEUE_CAPACITY> inputEvents;
+		std::atomic<bool> bQuit(false);
 
 		QueryPerformanceCounter(&startingTime);
 		QueryPerformanceFrequency(&frequency);
 
+		FramePipeline& framePipeline = m_renderer->GetFramePipeline();
+		framePipeline.SetStage(
+			eFrameStage::INPUT,
+			[&]()
+			{
+				// The newest directions hold, the mouse movements add up until a step handles them
+				InputEvent event;
+				while (inputEvents.TryPop(event))
+				{
+					input.Directions = event.Directions;
+					input.MouseMovement.X += event.MouseMovement.X;
+					input.MouseMovement.Y += event.MouseMovement.Y;
+				}
+			}
+		);
+		framePipeline.SetStage(
+			eFrameStage::UPDATE,
+			[&]()
+			{
+				const UINT uNumSteps = m_timestep.Advance(elapsedTime);
+				for (UINT i = 0u; i < uNumSteps; ++i)
+				{
+					m_renderer->StorePreviousState();
+					m_renderer->HandleInput(input.Directions, input.MouseMovement, m_timestep.GetStepSeconds());
+					m_renderer->Update(m_timestep.GetStepSeconds());
+
+					input.MouseMovement = {};
+				}
 
-		while (WM_QUIT != msg.message)
+				m_renderer->SetInterpolationAlpha(m_timestep.GetAlpha());
+			}
+		);
+
+		framePipeline.Start();
+		std::thread simulationThread(
+			[&]()
+			{
+				while (!bQuit.load(std::memory_order_acquire))
+				{
+					//Update the elapsedTime
+					QueryPerformanceCounter(&endingTime);
+					elapsedTime = (float)(endingTime.QuadPart - startingTime.QuadPart);
+					elapsedTime /= (float)(frequency.QuadPart);
+
+					//Update and render once the render thread took the previous frame, which may still be submitted when the stages return
+					QueryPerformanceCounter(&startingTime);
+					m_renderer->ExecuteFrame();
+				}
+			}
+		);
+
+		// Rendering runs on the other threads, the window thread sleeps until a message arrives
+		while (GetMessage(&msg, nullptr, 0, 0) > 0)
 		{
-			if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+
+			const InputEvent event = { m_mainWindow->GetDirections(), m_mainWindow->GetMouseRelativeMovement() };
+			if (event.MouseMovement.X == 0 && event.MouseMovement.Y == 0 && std::memcmp(&event.Directions, &sentDirections, sizeof(DirectionsInput)) == 0)
 			{
-				TranslateMessage(&msg);
-				DispatchMessage(&msg);
+				continue;
+			}
 
+			// When the queue is full, the movement keeps adding up until the next message
+			if (inputEvents.TryPush(event))
+			{
+				sentDirections = event.Directions;
+				m_mainWindow->ResetMouseMovement();
 			}
-			else
+		}
+
+		// The stages capture the locals of the loop, the render thread submits the last frame before it stops
+		bQuit.store(true, std::memory_order_release);
+		simulationThread.join();
+		framePipeline.Stop();
+		framePipeline.SetStage(eFrameStage::INPUT, nullptr);
+		framePipeline.SetStage(eFrameStage::UPDATE, nullptr);
+
+		return static_cast<INT>(msg.wParam);
+
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Game::RenderToFile
+
+	  Summary:  Renders frames with the software renderer, without a
+				window or a GPU, then saves the last frame and reports
+				the throughput, the cost of the light assignment and
+				the bytes of bone transforms uploaded per frame.
+				The frames are a fixed time step apart, so the image
+				only depends on the number of frames, and can be
+				compared with a golden image saved by an earlier run.
+				Images match when at most GOLDEN_MAX_DIFFERENT_PIXELS
+				of the pixels have a channel differing by more than
+				GOLDEN_CHANNEL_TOLERANCE. A missing golden image is a
+				failure, the image written can be reviewed and kept as
+				the golden image
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the PNG file to write
+				UINT uWidth
+				  Width of the image
+				UINT uHeight
+				  Height of the image
+				UINT uNumFrames
+				  Number of frames to render
+				const std::filesystem::path& goldenFilePath
+				  Path of the golden image, no comparison when empty
+
+	  Modifies: [m_renderer].
+
+	  Returns:  HRESULT
+				  Status code, E_FAIL when the image does not match the
+				  golden image, HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND)
+				  when the golden image does not exist
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Game::RenderToFile(
+		_In_ const std::filesystem::path& filePath,
+		_In_ UINT uWidth,
+		_In_ UINT uHeight,
+		_In_ UINT uNumFrames,
+		_In_ const std::filesystem::path& goldenFilePath
+	)
+	{
+		constexpr FLOAT FRAME_TIME = 1.0f / 60.0f;
+
+		if (uNumFrames == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		// Textures and images go through WIC, COM stays initialized for the rest of the process
+		HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		if (FAILED(hr))
+			return hr;
+
+		hr = m_renderer->InitializeHeadless(uWidth, uHeight, std::make_shared<RecordingRenderBackend>());
+		if (FAILED(hr))
+			return hr;
+
+		SoftwareRenderer softwareRenderer(uWidth, uHeight);
+		hr = softwareRenderer.Initialize();
+		if (FAILED(hr))
+			return hr;
+
+		UINT64 uSkinningUploadBytes = 0u;
+		UINT uMaxSkinningUploadBytes = 0u;
+		for (UINT i = 0u; i < uNumFrames; ++i)
+		{
+			m_renderer->Update(FRAME_TIME);
+
+			hr = m_renderer->RenderSoftware(softwareRenderer);
+			if (FAILED(hr))
+				return hr;
+
+			uSkinningUploadBytes += m_renderer->GetSkinningUploadBytes();
+			uMaxSkinningUploadBytes = std::max(uMaxSkinningUploadBytes, m_renderer->GetSkinningUploadBytes());
+		}
+
+		hr = softwareRenderer.SaveToFile(filePath);
+		if (FAILED(hr))
+			return hr;
+
+		const SoftwareRenderStats& stats = softwareRenderer.GetStats();
+		WCHAR szMessage[1024];
+		swprintf_s(
+			szMessage,
+			L"%llu frames of %ux%u in %.3f s: %.2f frames/s, %.2f megapixels/s, %llu of %llu triangles rasterized\n",
+			stats.uNumFrames,
+			uWidth,
+			uHeight,
+			stats.totalSeconds,
+			softwareRenderer.GetFramesPerSecond(),
+			softwareRenderer.GetMegapixelsPerSecond(),
+			stats.uNumRasterizedTriangles,
+			stats.uNumTriangles
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		const ClusteredLightCuller& lightCuller = m_renderer->GetLightCuller();
+		swprintf_s(
+			szMessage,
+			L"%u lights assigned to %u clusters in %.3f ms, %.2f lights per cluster\n",
+			lightCuller.GetNumLights(),
+			NUM_CLUSTERS,
+			lightCuller.GetLastUpdateSeconds() * 1000.0f,
+			static_cast<FLOAT>(lightCuller.GetNumLightIndices()) / static_cast<FLOAT>(NUM_CLUSTERS)
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		swprintf_s(
+			szMessage,
+			L"%.1f KB of bone transforms uploaded per frame on average, %.1f KB at most\n",
+			static_cast<FLOAT>(uSkinningUploadBytes) / (1024.0f * static_cast<FLOAT>(uNumFrames)),
+			static_cast<FLOAT>(uMaxSkinningUploadBytes) / 1024.0f
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		if (goldenFilePath.empty())
+		{
+			return S_OK;
+		}
+
+		if (!std::filesystem::exists(goldenFilePath))
+		{
+			swprintf_s(
+				szMessage,
+				L"Golden image %s not found, review %s and copy it there to make it the golden image\n",
+				goldenFilePath.c_str(),
+				filePath.c_str()
+			);
+			OutputDebugString(szMessage);
+			fputws(szMessage, stderr);
+
+			return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+		}
+
+		SoftwareImageDifference difference;
+		hr = softwareRenderer.CompareToFile(goldenFilePath, GOLDEN_CHANNEL_TOLERANCE, difference);
+		if (FAILED(hr))
+			return hr;
+
+		const BOOL bMatch = static_cast<FLOAT>(difference.uNumDifferentPixels) <= GOLDEN_MAX_DIFFERENT_PIXELS * static_cast<FLOAT>(difference.uNumPixels);
+		swprintf_s(
+			szMessage,
+			L"%s golden image: %llu of %llu pixels differ by more than %u, %u at most\n",
+			bMatch ? L"Matches the" : L"Does not match the",
+			difference.uNumDifferentPixels,
+			difference.uNumPixels,
+			GOLDEN_CHANNEL_TOLERANCE,
+			difference.uMaxChannelDifference
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		return bMatch ? S_OK : E_FAIL;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Game::Benchmark
+
+	  Summary:  Runs the stages of frames in the frame pipeline, without
+				a window or a GPU. The commands go to a recording
+				backend and the submission runs inline, so the frames
+				only measure the CPU side: update, culling, draw list
+				and command replay. The frames are a fixed time step
+				apart and the first BENCHMARK_WARM_UP_FRAMES are not
+				measured. Reports the average time of every stage,
+				the frame times, and the commands of the last frame
+
+	  Args:     UINT uWidth
+				  Width of the virtual back buffer
+				UINT uHeight
+				  Height of the virtual back buffer
+				UINT uNumFrames
+				  Number of frames to measure
+
+	  Modifies: [m_renderer].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Game::Benchmark(_In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uNumFrames)
+	{
+		constexpr FLOAT FRAME_TIME = 1.0f / 60.0f;
+		constexpr size_t NUM_STAGES = static_cast<size_t>(eFrameStage::COUNT);
+
+		if (uNumFrames == 0u)
+		{
+			return E_INVALIDARG;
+		}
+
+		// Textures go through WIC, COM stays initialized for the rest of the process
+		HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		if (FAILED(hr))
+			return hr;
+
+		std::shared_ptr<RecordingRenderBackend> backend = std::make_shared<RecordingRenderBackend>();
+		hr = m_renderer->InitializeHeadless(uWidth, uHeight, backend);
+		if (FAILED(hr))
+			return hr;
+
+		FramePipeline& framePipeline = m_renderer->GetFramePipeline();
+		framePipeline.SetStage(
+			eFrameStage::UPDATE,
+			[&]()
 			{
-				//Update the elapsedTime
-				QueryPerformanceCounter(&endingTime);
-				elapsedTime = (float)(endingTime.QuadPart - startingTime.QuadPart);
-				elapsedTime /= (float)(frequency.QuadPart);
+				m_renderer->StorePreviousState();
+				m_renderer->Update(FRAME_TIME);
+				m_renderer->SetInterpolationAlpha(1.0f);
+			}
+		);
 
-				//Update and render
-				m_renderer->HandleInput(m_mainWindow->GetDirections(), m_mainWindow->GetMouseRelativeMovement(), elapsedTime );
-				m_mainWindow->ResetMouseMovement();
-				m_renderer->Update(elapsedTime);
-				QueryPerformanceCounter(&startingTime);
-				m_renderer->Render();
+		for (UINT i = 0u; i < BENCHMARK_WARM_UP_FRAMES; ++i)
+		{
+			m_renderer->ExecuteFrame();
+		}
 
+		LARGE_INTEGER frequency;
+		LARGE_INTEGER startingTime, endingTime;
+		QueryPerformanceFrequency(&frequency);
+
+		double aStageSeconds[NUM_STAGES] = {};
+		double totalSeconds = 0.0;
+		double minFrameSeconds = DBL_MAX;
+		double maxFrameSeconds = 0.0;
+		for (UINT i = 0u; i < uNumFrames; ++i)
+		{
+			// The render thread is not started, so the submission runs before ExecuteFrame returns
+			QueryPerformanceCounter(&startingTime);
+			m_renderer->ExecuteFrame();
+			QueryPerformanceCounter(&endingTime);
+
+			const double frameSeconds = static_cast<double>(endingTime.QuadPart - startingTime.QuadPart) / static_cast<double>(frequency.QuadPart);
+			totalSeconds += frameSeconds;
+			minFrameSeconds = std::min(minFrameSeconds, frameSeconds);
+			maxFrameSeconds = std::max(maxFrameSeconds, frameSeconds);
+
+			for (size_t uStage = 0u; uStage < NUM_STAGES; ++uStage)
+			{
+				aStageSeconds[uStage] += framePipeline.GetStageSeconds(static_cast<eFrameStage>(uStage));
 			}
 		}
-		return static_cast<INT>(msg.wParam);
 
+		framePipeline.SetStage(eFrameStage::UPDATE, nullptr);
+
+		WCHAR szMessage[256];
+		swprintf_s(
+			szMessage,
+			L"%u frames of %ux%u, %.3f ms per frame on average, %.3f ms at least, %.3f ms at most, %.2f frames/s\n",
+			uNumFrames,
+			uWidth,
+			uHeight,
+			totalSeconds * 1000.0 / uNumFrames,
+			minFrameSeconds * 1000.0,
+			maxFrameSeconds * 1000.0,
+			uNumFrames / totalSeconds
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		for (size_t uStage = 0u; uStage < NUM_STAGES; ++uStage)
+		{
+			swprintf_s(
+				szMessage,
+				L"  %-16s %8.3f ms\n",
+				FramePipeline::GetStageName(static_cast<eFrameStage>(uStage)),
+				aStageSeconds[uStage] * 1000.0 / uNumFrames
+			);
+			OutputDebugString(szMessage);
+			fputws(szMessage, stdout);
+		}
+
+		swprintf_s(
+			szMessage,
+			L"last frame: %zu commands, %u draws, %llu indices, %.1f KB uploaded\n",
+			backend->GetCommands().size(),
+			backend->GetNumDrawCalls(),
+			backend->GetNumIndices(),
+			static_cast<double>(backend->GetNumUploadedBytes()) / 1024.0
+		);
+		OutputDebugString(szMessage);
+		fputws(szMessage, stdout);
+
+		return S_OK;
 	}
 
 
@@ -147,4 +513,20 @@ namespace library
 		return m_renderer;
 
 	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Game::GetTimestep
+
+	  Summary:  Returns the time step of the simulation, one step per
+				frame until a step rate is set
+
+	  Returns:  FixedTimestep&
+				  The time step
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+
+	FixedTimestep& Game::GetTimestep()
+	{
+		return m_timestep;
+
+	}
 }
@@ -13,6 +13,7 @@
 
 #include "Common.h"
 
+#include "Game/FixedTimestep.h"
 #include "Renderer/Renderer.h"
 #include "Window/MainWindow.h"
 
@@ -26,7 +27,16 @@ namespace library
       Methods:  Initialize
                   Initializes the components of the game
                 Run
-                  Runs the game loop
+                  Runs the game loop, the simulation and the rendering
+                  on their own threads
+                RenderToFile
+                  Renders frames on the CPU without a window, saves
+                  the last one to an image file and compares it with a
+                  golden image
+                Benchmark
+                  Runs frames without a window or a GPU into a
+                  recording backend and reports the CPU time of their
+                  stages
                 GetGameName
                   Returns the name of the game
                 GetWindow
@@ -35,6 +45,8 @@ namespace library
                 GetRenderer
                   Returns the reference to the unique pointer to the 
                   renderer
+                GetTimestep
+                  Returns the time step of the simulation
                 Game
                   Constructor.
                 ~Game
@@ -42,6 +54,12 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Game final
     {
+    public:
+        static constexpr size_t INPUT_QUEUE_CAPACITY = 256u;
+        static constexpr UINT BENCHMARK_WARM_UP_FRAMES = 16u;
+        static constexpr UINT GOLDEN_CHANNEL_TOLERANCE = 2u;
+        static constexpr FLOAT GOLDEN_MAX_DIFFERENT_PIXELS = 0.001f;
+
     public:
         Game(_In_ PCWSTR pszGameName);
         Game(const Game& other) = delete;
@@ -52,13 +70,23 @@ namespace library
 
         HRESULT Initialize(_In_ HINSTANCE hInstance, _In_ INT nCmdShow);
         INT Run();
+        HRESULT RenderToFile(
+            _In_ const std::filesystem::path& filePath,
+            _In_ UINT uWidth,
+            _In_ UINT uHeight,
+            _In_ UINT uNumFrames,
+            _In_ const std::filesystem::path& goldenFilePath = std::filesystem::path()
+        );
+        HRESULT Benchmark(_In_ UINT uWidth, _In_ UINT uHeight, _In_ UINT uNumFrames);
 
         PCWSTR GetGameName() const;
         std::unique_ptr<MainWindow>& GetWindow();
         std::unique_ptr<Renderer>& GetRenderer();
+        FixedTimestep& GetTimestep();
     private:
         PCWSTR m_pszGameName;
         std::unique_ptr<MainWindow> m_mainWindow;
         std::unique_ptr<Renderer> m_renderer;
+        FixedTimestep m_timestep;
     };
 }
\ No newline at end of file
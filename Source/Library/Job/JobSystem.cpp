@@ -0,0 +1,540 @@
+#include "Job/JobSystem.h"
+
+namespace library
+{
+    thread_local JobSystem* JobSystem::sm_pCurrentJobSystem = nullptr;
+    thread_local std::uint32_t JobSystem::sm_uWorkerIndex = JobSystem::NO_WORKER;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobCounter::JobCounter
+
+      Summary:  Constructor of a done counter
+
+      Modifies: [m_uNumPending, m_mutex, m_apDependents].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobCounter::JobCounter()
+        : m_uNumPending(0u)
+        , m_mutex()
+        , m_apDependents()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobCounter::IsDone
+
+      Summary:  Returns whether every job run with the counter is
+                finished
+
+      Returns:  bool
+                  Whether no job of the counter is pending
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool JobCounter::IsDone() const
+    {
+        return m_uNumPending.load(std::memory_order_acquire) == 0u;
+    }
+
+    std::uint32_t JobCounter::GetNumPending() const
+    {
+        return m_uNumPending.load(std::memory_order_acquire);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::JobSystem
+
+      Summary:  Constructor, no thread is started until Initialize
+
+      Modifies: [m_aWorkers, m_externalMutex, m_apExternalJobs,
+                 m_uExternalHead, m_aExternalJobPool, m_uNextExternalJob,
+                 m_uNumExternalJobs, m_uWakeEpoch, m_uNumSleeping,
+                 m_bRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobSystem::JobSystem()
+        : m_aWorkers()
+        , m_externalMutex()
+        , m_apExternalJobs(MAX_JOBS_PER_THREAD)
+        , m_uExternalHead(0u)
+        , m_aExternalJobPool(MAX_JOBS_PER_THREAD)
+        , m_uNextExternalJob(0u)
+        , m_uNumExternalJobs(0u)
+        , m_uWakeEpoch(0u)
+        , m_uNumSleeping(0u)
+        , m_bRunning(false)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::~JobSystem
+
+      Summary:  Destructor, stops the worker threads
+
+      Modifies: [m_aWorkers, m_bRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Initialize
+
+      Summary:  Makes the calling thread the first worker and starts a
+                thread for each other worker. With one thread no worker
+                is started and jobs run inline
+
+      Args:     std::uint32_t uNumThreads
+                  Number of threads running jobs, the calling thread
+                  included, 0 for one per hardware thread
+
+      Modifies: [m_aWorkers, m_bRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::Initialize(std::uint32_t uNumThreads)
+    {
+        Shutdown();
+
+        if (uNumThreads == 0u)
+        {
+            uNumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+
+        for (std::uint32_t i = 0u; i < uNumThreads; ++i)
+        {
+            std::unique_ptr<Worker> worker = std::make_unique<Worker>();
+            worker->aJobPool = std::vector<Job>(MAX_JOBS_PER_THREAD);
+            worker->uNextJob = 0u;
+            m_aWorkers.push_back(std::move(worker));
+        }
+
+        sm_pCurrentJobSystem = this;
+        sm_uWorkerIndex = 0u;
+
+        if (uNumThreads < 2u)
+        {
+            return;
+        }
+
+        m_bRunning.store(true, std::memory_order_release);
+        for (std::uint32_t i = 1u; i < uNumThreads; ++i)
+        {
+            m_aWorkers[i]->Thread = std::thread(&JobSystem::workerMain, this, i);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Shutdown
+
+      Summary:  Wakes the workers, which finish the queued jobs and
+                exit, and joins their threads. Must be called from the
+                thread that called Initialize
+
+      Modifies: [m_aWorkers, m_bRunning].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::Shutdown()
+    {
+        m_bRunning.store(false, std::memory_order_release);
+        m_uWakeEpoch.fetch_add(1u, std::memory_order_seq_cst);
+        m_uWakeEpoch.notify_all();
+
+        for (const std::unique_ptr<Worker>& worker : m_aWorkers)
+        {
+            if (worker->Thread.joinable())
+            {
+                worker->Thread.join();
+            }
+        }
+        m_aWorkers.clear();
+
+        if (sm_pCurrentJobSystem == this)
+        {
+            sm_pCurrentJobSystem = nullptr;
+            sm_uWorkerIndex = NO_WORKER;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::IsInitialized
+
+      Summary:  Returns whether worker threads are running jobs
+
+      Returns:  bool
+                  false before Initialize or with one thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool JobSystem::IsInitialized() const
+    {
+        return m_bRunning.load(std::memory_order_acquire);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::GetNumThreads
+
+      Summary:  Returns the number of threads running jobs, the thread
+                that called Initialize included
+
+      Returns:  std::uint32_t
+                  Number of workers, 1 when jobs run inline
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t JobSystem::GetNumThreads() const
+    {
+        return IsInitialized() ? static_cast<std::uint32_t>(m_aWorkers.size()) : 1u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Run
+
+      Summary:  Runs a function on a range of indices as a job. The job
+                is pushed on the deque of the calling worker, or on the
+                shared queue from other threads. With a dependency it
+                is only scheduled once the dependency is done. Without
+                workers, or when the pool of the calling thread is
+                full, it runs inline, after helping the dependency
+
+      Args:     JobFunction pfnFunction
+                  Function of the job
+                void* pData
+                  First argument of the function, must outlive the job
+                std::uint32_t uBegin
+                  First index
+                std::uint32_t uEnd
+                  Index past the end
+                JobCounter* pCounter
+                  Counter incremented now and decremented when the job
+                  is finished, may be nullptr
+                JobCounter* pDependency
+                  Counter that must be done before the job starts, may
+                  be nullptr
+
+      Modifies: [m_aWorkers, m_apExternalJobs, m_aExternalJobPool,
+                 m_uNextExternalJob, m_uNumExternalJobs, m_uWakeEpoch].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::Run(
+        JobFunction pfnFunction,
+        void* pData,
+        std::uint32_t uBegin,
+        std::uint32_t uEnd,
+        JobCounter* pCounter,
+        JobCounter* pDependency
+    )
+    {
+        if (!IsInitialized())
+        {
+            // Inline jobs run in submission order, so the dependency is already done
+            pfnFunction(pData, uBegin, uEnd);
+            return;
+        }
+
+        if (pCounter)
+        {
+            pCounter->m_uNumPending.fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        Job* pJob = allocateJob();
+        if (!pJob)
+        {
+            // Every slot holds an unfinished job, overwriting one would lose it
+            Job job;
+            job.pfnFunction = pfnFunction;
+            job.pData = pData;
+            job.uBegin = uBegin;
+            job.uEnd = uEnd;
+            job.pCounter = pCounter;
+            if (pDependency)
+            {
+                Wait(*pDependency);
+            }
+            execute(&job);
+            return;
+        }
+
+        pJob->pfnFunction = pfnFunction;
+        pJob->pData = pData;
+        pJob->uBegin = uBegin;
+        pJob->uEnd = uEnd;
+        pJob->pCounter = pCounter;
+
+        if (pDependency)
+        {
+            // The last job of the dependency takes the dependents under the same lock
+            std::lock_guard<std::mutex> lock(pDependency->m_mutex);
+            if (!pDependency->IsDone())
+            {
+                pDependency->m_apDependents.push_back(pJob);
+                return;
+            }
+        }
+
+        schedule(pJob);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::Wait
+
+      Summary:  Runs queued jobs, any of them, until the counter is
+                done
+
+      Args:     JobCounter& counter
+                  Counter to wait for
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (!counter.IsDone())
+        {
+            Job* pJob = findJob();
+            if (pJob)
+            {
+                execute(pJob);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // The thread finishing the last job may still hold the lock, the counter must outlive it
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::allocateJob
+
+      Summary:  Takes the next job of the ring pool of the calling
+                thread. Threads that are not workers share one pool.
+                A pool holds MAX_JOBS_PER_THREAD unfinished jobs, the
+                next slot still holding one means the pool is full
+
+      Modifies: [m_aWorkers, m_aExternalJobPool, m_uNextExternalJob].
+
+      Returns:  Job*
+                  Job to fill, nullptr when the pool is full
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Job* JobSystem::allocateJob()
+    {
+        Job* pJob = nullptr;
+        if (sm_pCurrentJobSystem == this && sm_uWorkerIndex != NO_WORKER)
+        {
+            Worker& worker = *m_aWorkers[sm_uWorkerIndex];
+            pJob = &worker.aJobPool[worker.uNextJob++ & (MAX_JOBS_PER_THREAD - 1u)];
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(m_externalMutex);
+            pJob = &m_aExternalJobPool[m_uNextExternalJob++ & (MAX_JOBS_PER_THREAD - 1u)];
+        }
+
+        // Slots are freed by whichever thread ran the job, the exchange pairs with that release
+        if (pJob->bInUse.exchange(true, std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        return pJob;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::schedule
+
+      Summary:  Queues a job and wakes a sleeping worker. A full deque,
+                or a full shared queue, runs the job at once instead.
+                The shared queue is a fixed ring, so scheduling never
+                allocates
+
+      Args:     Job* pJob
+                  Job to queue
+
+      Modifies: [m_aWorkers, m_apExternalJobs, m_uNumExternalJobs,
+                 m_uWakeEpoch].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::schedule(Job* pJob)
+    {
+        if (sm_pCurrentJobSystem == this && sm_uWorkerIndex != NO_WORKER)
+        {
+            if (!m_aWorkers[sm_uWorkerIndex]->Deque.Push(pJob))
+            {
+                execute(pJob);
+                return;
+            }
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(m_externalMutex);
+            const std::uint32_t uNumExternalJobs = m_uNumExternalJobs.load(std::memory_order_relaxed);
+            if (uNumExternalJobs == MAX_JOBS_PER_THREAD)
+            {
+                lock.unlock();
+                execute(pJob);
+                return;
+            }
+
+            m_apExternalJobs[(m_uExternalHead + uNumExternalJobs) & (MAX_JOBS_PER_THREAD - 1u)] = pJob;
+            m_uNumExternalJobs.fetch_add(1u, std::memory_order_release);
+        }
+
+        m_uWakeEpoch.fetch_add(1u, std::memory_order_seq_cst);
+        if (m_uNumSleeping.load(std::memory_order_seq_cst) > 0u)
+        {
+            m_uWakeEpoch.notify_one();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::findJob
+
+      Summary:  Returns the newest job of the calling worker, else the
+                oldest job of the shared queue, else a job stolen from
+                the other workers, starting with the next one
+
+      Modifies: [m_aWorkers, m_apExternalJobs, m_uExternalHead,
+                 m_uNumExternalJobs].
+
+      Returns:  Job*
+                  Job to run, nullptr when none was found
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Job* JobSystem::findJob()
+    {
+        const std::uint32_t uNumWorkers = static_cast<std::uint32_t>(m_aWorkers.size());
+        const bool bWorker = sm_pCurrentJobSystem == this && sm_uWorkerIndex != NO_WORKER;
+
+        if (bWorker)
+        {
+            Job* pJob = m_aWorkers[sm_uWorkerIndex]->Deque.Pop();
+            if (pJob)
+            {
+                return pJob;
+            }
+        }
+
+        if (m_uNumExternalJobs.load(std::memory_order_acquire) > 0u)
+        {
+            std::lock_guard<std::mutex> lock(m_externalMutex);
+            if (m_uNumExternalJobs.load(std::memory_order_relaxed) > 0u)
+            {
+                Job* pJob = m_apExternalJobs[m_uExternalHead++ & (MAX_JOBS_PER_THREAD - 1u)];
+                m_uNumExternalJobs.fetch_sub(1u, std::memory_order_relaxed);
+                return pJob;
+            }
+        }
+
+        const std::uint32_t uFirstVictim = bWorker ? sm_uWorkerIndex + 1u : 0u;
+        for (std::uint32_t i = 0u; i < uNumWorkers; ++i)
+        {
+            const std::uint32_t uVictim = (uFirstVictim + i) % uNumWorkers;
+            if (bWorker && uVictim == sm_uWorkerIndex)
+            {
+                continue;
+            }
+
+            Job* pJob = m_aWorkers[uVictim]->Deque.Steal();
+            if (pJob)
+            {
+                return pJob;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::execute
+
+      Summary:  Calls the function of a job, frees its slot and
+                finishes it
+
+      Args:     Job* pJob
+                  Job to run
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::execute(Job* pJob)
+    {
+        JobCounter* pCounter = pJob->pCounter;
+        pJob->pfnFunction(pJob->pData, pJob->uBegin, pJob->uEnd);
+        pJob->bInUse.store(false, std::memory_order_release);
+        finish(pCounter);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::finish
+
+      Summary:  Decrements the counter of a finished job. The last job
+                schedules the jobs depending on the counter
+
+      Args:     JobCounter* pCounter
+                  Counter of the job, may be nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::finish(JobCounter* pCounter)
+    {
+        if (!pCounter)
+        {
+            return;
+        }
+
+        std::vector<Job*> apDependents;
+        {
+            std::lock_guard<std::mutex> lock(pCounter->m_mutex);
+            if (pCounter->m_uNumPending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                apDependents.swap(pCounter->m_apDependents);
+            }
+        }
+
+        for (Job* pDependent : apDependents)
+        {
+            schedule(pDependent);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::workerMain
+
+      Summary:  Loop of a worker thread. Runs jobs while there are
+                some, spins a little when there are none, then sleeps
+                until a job is scheduled. Exits once stopped and out
+                of jobs
+
+      Args:     std::uint32_t uWorkerIndex
+                  Index of the worker
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void JobSystem::workerMain(std::uint32_t uWorkerIndex)
+    {
+        sm_pCurrentJobSystem = this;
+        sm_uWorkerIndex = uWorkerIndex;
+
+        std::uint32_t uNumSpins = 0u;
+        for (;;)
+        {
+            Job* pJob = findJob();
+            if (pJob)
+            {
+                execute(pJob);
+                uNumSpins = 0u;
+                continue;
+            }
+
+            if (!m_bRunning.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            if (++uNumSpins < NUM_SPINS_BEFORE_SLEEP)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Announce the sleep, then look once more, so a job scheduled in between either is found or wakes us
+            const std::uint32_t uWakeEpoch = m_uWakeEpoch.load(std::memory_order_seq_cst);
+            m_uNumSleeping.fetch_add(1u, std::memory_order_seq_cst);
+            pJob = findJob();
+            if (!pJob && m_bRunning.load(std::memory_order_acquire))
+            {
+                m_uWakeEpoch.wait(uWakeEpoch, std::memory_order_seq_cst);
+            }
+            m_uNumSleeping.fetch_sub(1u, std::memory_order_relaxed);
+
+            if (pJob)
+            {
+                execute(pJob);
+            }
+            uNumSpins = 0u;
+        }
+
+        sm_pCurrentJobSystem = nullptr;
+        sm_uWorkerIndex = NO_WORKER;
+    }
+}
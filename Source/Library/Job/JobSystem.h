@@ -0,0 +1,277 @@
+/*+===================================================================
+  File:      JOBSYSTEM.H
+
+  Summary:   JobSystem header file contains declarations of the work
+             stealing job system running the update and loading work
+             of the engine on one worker per core. Only depends on the
+             standard library.
+
+  Classes: Job, JobCounter, JobSystem
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Job/WorkStealingDeque.h"
+
+namespace library
+{
+    class JobCounter;
+
+    typedef void (*JobFunction)(void* pData, std::uint32_t uBegin, std::uint32_t uEnd);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Job
+
+      Summary:  Function called on a range of indices. Jobs live in
+                the pools of the job system, not on the heap, and keep
+                their slot until they are finished
+
+      Members:  JobFunction pfnFunction
+                  Function to call
+                void* pData
+                  First argument of the function
+                std::uint32_t uBegin
+                  First index of the range
+                std::uint32_t uEnd
+                  Index past the end of the range
+                JobCounter* pCounter
+                  Counter decremented when the job is finished, may be
+                  nullptr
+                std::atomic<bool> bInUse
+                  Whether the slot holds an unfinished job
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Job
+    {
+        JobFunction pfnFunction;
+        void* pData;
+        std::uint32_t uBegin;
+        std::uint32_t uEnd;
+        JobCounter* pCounter;
+        std::atomic<bool> bInUse;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JobCounter
+
+      Summary:  Number of unfinished jobs run with the counter. Waiting
+                on a counter runs other jobs until it reaches zero, and
+                jobs may depend on a counter, they are only scheduled
+                once it reaches zero. A counter can be reused once it
+                is done
+
+      Methods:  IsDone
+                  Returns whether every job of the counter is finished
+                GetNumPending
+                  Returns the number of unfinished jobs
+                JobCounter
+                  Constructor.
+                ~JobCounter
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class JobCounter final
+    {
+        friend class JobSystem;
+
+    public:
+        JobCounter();
+        JobCounter(const JobCounter& other) = delete;
+        JobCounter(JobCounter&& other) = delete;
+        JobCounter& operator=(const JobCounter& other) = delete;
+        JobCounter& operator=(JobCounter&& other) = delete;
+        ~JobCounter() = default;
+
+        bool IsDone() const;
+        std::uint32_t GetNumPending() const;
+
+    private:
+        std::atomic<std::uint32_t> m_uNumPending;
+        std::mutex m_mutex;
+        std::vector<Job*> m_apDependents;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    JobSystem
+
+      Summary:  One worker per core, the thread calling Initialize
+                being the first, each with a Chase-Lev deque. A worker
+                runs its own newest jobs first and steals the oldest
+                jobs of the others when it runs out. Threads that are
+                not workers submit to a shared queue and help while
+                they wait. Idle workers spin briefly then sleep until
+                jobs are submitted. Before Initialize, and with one
+                thread, every job runs inline on the calling thread
+
+      Methods:  Initialize
+                  Starts the worker threads
+                Shutdown
+                  Finishes the jobs and stops the worker threads
+                IsInitialized
+                  Returns whether worker threads are running
+                GetNumThreads
+                  Returns the number of threads running jobs
+                Run
+                  Runs a job on a range, optionally after a counter
+                Wait
+                  Runs jobs until a counter is done
+                ParallelFor
+                  Calls a function on every index of a range, split in
+                  jobs, and waits
+                JobSystem
+                  Constructor.
+                ~JobSystem
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class JobSystem final
+    {
+    public:
+        static constexpr std::uint32_t MAX_JOBS_PER_THREAD = 4096u;
+        static constexpr std::uint32_t NUM_JOBS_PER_THREAD_PER_FOR = 4u;
+        static constexpr std::uint32_t NUM_SPINS_BEFORE_SLEEP = 64u;
+        static constexpr std::uint32_t NO_WORKER = UINT32_MAX;
+
+    public:
+        JobSystem();
+        JobSystem(const JobSystem& other) = delete;
+        JobSystem(JobSystem&& other) = delete;
+        JobSystem& operator=(const JobSystem& other) = delete;
+        JobSystem& operator=(JobSystem&& other) = delete;
+        ~JobSystem();
+
+        void Initialize(std::uint32_t uNumThreads = 0u);
+        void Shutdown();
+        bool IsInitialized() const;
+        std::uint32_t GetNumThreads() const;
+
+        void Run(
+            JobFunction pfnFunction,
+            void* pData,
+            std::uint32_t uBegin,
+            std::uint32_t uEnd,
+            JobCounter* pCounter,
+            JobCounter* pDependency = nullptr
+        );
+        void Wait(JobCounter& counter);
+
+        template <typename Function>
+        void ParallelFor(std::uint32_t uBegin, std::uint32_t uEnd, std::uint32_t uGrainSize, const Function& function);
+
+    private:
+        struct Worker
+        {
+            WorkStealingDeque Deque;
+            std::vector<Job> aJobPool;
+            std::uint32_t uNextJob;
+            std::thread Thread;
+        };
+
+    private:
+        template <typename Function>
+        static void invokeRange(void* pData, std::uint32_t uBegin, std::uint32_t uEnd);
+
+        Job* allocateJob();
+        void schedule(Job* pJob);
+        Job* findJob();
+        void execute(Job* pJob);
+        void finish(JobCounter* pCounter);
+        void workerMain(std::uint32_t uWorkerIndex);
+
+    private:
+        static thread_local JobSystem* sm_pCurrentJobSystem;
+        static thread_local std::uint32_t sm_uWorkerIndex;
+
+        std::vector<std::unique_ptr<Worker>> m_aWorkers;
+        std::mutex m_externalMutex;
+        std::vector<Job*> m_apExternalJobs;
+        std::uint32_t m_uExternalHead;
+        std::vector<Job> m_aExternalJobPool;
+        std::uint32_t m_uNextExternalJob;
+        std::atomic<std::uint32_t> m_uNumExternalJobs;
+        std::atomic<std::uint32_t> m_uWakeEpoch;
+        std::atomic<std::uint32_t> m_uNumSleeping;
+        std::atomic<bool> m_bRunning;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::ParallelFor
+
+      Summary:  Calls a function on every index of a range. The range
+                is split in jobs of at least uGrainSize indices, run by
+                every worker, and the calling thread helps until they
+                are all finished. Small ranges, and every range before
+                Initialize, run inline
+
+      Args:     std::uint32_t uBegin
+                  First index
+                std::uint32_t uEnd
+                  Index past the end
+                std::uint32_t uGrainSize
+                  Minimum number of indices of a job, 0 to split the
+                  range in NUM_JOBS_PER_THREAD_PER_FOR jobs per thread.
+                Grown so the range makes at most MAX_JOBS_PER_THREAD
+                jobs
+                const Function& function
+                  Called with each index, from any thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename Function>
+    void JobSystem::ParallelFor(std::uint32_t uBegin, std::uint32_t uEnd, std::uint32_t uGrainSize, const Function& function)
+    {
+        if (uEnd <= uBegin)
+        {
+            return;
+        }
+
+        const std::uint32_t uCount = uEnd - uBegin;
+        const std::uint32_t uNumJobsWanted = GetNumThreads() * NUM_JOBS_PER_THREAD_PER_FOR;
+        std::uint32_t uJobSize = uGrainSize != 0u
+            ? uGrainSize
+            : std::max((uCount + uNumJobsWanted - 1u) / uNumJobsWanted, 1u);
+        uJobSize = std::max(uJobSize, (uCount + MAX_JOBS_PER_THREAD - 1u) / MAX_JOBS_PER_THREAD);
+
+        if (GetNumThreads() < 2u || uCount <= uJobSize)
+        {
+            invokeRange<Function>(const_cast<Function*>(&function), uBegin, uEnd);
+            return;
+        }
+
+        JobCounter counter;
+        for (std::uint32_t uJobBegin = uBegin; uJobBegin < uEnd;)
+        {
+            const std::uint32_t uJobEnd = uJobBegin + std::min(uJobSize, uEnd - uJobBegin);
+            Run(&invokeRange<Function>, const_cast<Function*>(&function), uJobBegin, uJobEnd, &counter);
+            uJobBegin = uJobEnd;
+        }
+        Wait(counter);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   JobSystem::invokeRange
+
+      Summary:  Job function of ParallelFor, calls the function on each
+                index of the range of the job
+
+      Args:     void* pData
+                  The function
+                std::uint32_t uBegin
+                  First index
+                std::uint32_t uEnd
+                  Index past the end
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename Function>
+    void JobSystem::invokeRange(void* pData, std::uint32_t uBegin, std::uint32_t uEnd)
+    {
+        const Function& function = *static_cast<const Function*>(pData);
+        for (std::uint32_t i = uBegin; i < uEnd; ++i)
+        {
+            function(i);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+/*+===================================================================
+  File:      SPSCQUEUE.H
+
+  Summary:   SpscQueue header file contains the lock free queue
+             passing items from one producer thread to one consumer
+             thread. Only depends on the standard library.
+
+  Classes: SpscQueue
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SpscQueue
+
+      Summary:  Fixed size ring of items written by one thread and read
+                by another, without locks. The producer only writes the
+                tail and the consumer only writes the head, each on its
+                own cache line, and an index is released after the item
+                it covers
+
+      Methods:  TryPush
+                  Adds an item, producer only
+                TryPop
+                  Removes the oldest item, consumer only
+                IsEmpty
+                  Returns whether the queue looks empty
+                SpscQueue
+                  Constructor.
+                ~SpscQueue
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T, std::size_t CAPACITY>
+    class SpscQueue final
+    {
+    public:
+        static_assert(CAPACITY != 0u && (CAPACITY & (CAPACITY - 1u)) == 0u, "The capacity must be a power of two");
+
+    public:
+        SpscQueue()
+            : m_uHead(0u)
+            , m_uTail(0u)
+            , m_aItems()
+        {
+        }
+        SpscQueue(const SpscQueue& other) = delete;
+        SpscQueue(SpscQueue&& other) = delete;
+        SpscQueue& operator=(const SpscQueue& other) = delete;
+        SpscQueue& operator=(SpscQueue&& other) = delete;
+        ~SpscQueue() = default;
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   SpscQueue::TryPush
+
+          Summary:  Adds an item at the tail. Only the producer may call
+                    it
+
+          Args:     const T& item
+                      Item to copy into the queue
+
+          Modifies: [m_uTail, m_aItems].
+
+          Returns:  bool
+                      false when the queue is full
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        bool TryPush(const T& item)
+        {
+            const std::size_t uTail = m_uTail.load(std::memory_order_relaxed);
+            if (uTail - m_uHead.load(std::memory_order_acquire) == CAPACITY)
+            {
+                return false;
+            }
+
+            m_aItems[uTail & MASK] = item;
+            m_uTail.store(uTail + 1u, std::memory_order_release);
+
+            return true;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   SpscQueue::TryPop
+
+          Summary:  Removes the item at the head. Only the consumer may
+                    call it
+
+          Args:     T& item
+                      Receives the oldest item
+
+          Modifies: [m_uHead].
+
+          Returns:  bool
+                      false when the queue is empty
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        bool TryPop(T& item)
+        {
+            const std::size_t uHead = m_uHead.load(std::memory_order_relaxed);
+            if (uHead == m_uTail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            item = m_aItems[uHead & MASK];
+            m_uHead.store(uHead + 1u, std::memory_order_release);
+
+            return true;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_uHead.load(std::memory_order_acquire) == m_uTail.load(std::memory_order_acquire);
+        }
+
+    private:
+        static constexpr std::size_t MASK = CAPACITY - 1u;
+
+        alignas(64) std::atomic<std::size_t> m_uHead;
+        alignas(64) std::atomic<std::size_t> m_uTail;
+        alignas(64) T m_aItems[CAPACITY];
+    };
+}
@@ -0,0 +1,240 @@
+/*+===================================================================
+  File:      TASK.H
+
+  Summary:   Task header file contains the coroutine type of the
+             asynchronous work of the engine, such as the loading of
+             assets. Only depends on the standard library.
+
+  Classes: Task
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    Task
+
+      Summary:  Coroutine returning a value of type T. A task starts
+                suspended and runs when it is awaited, or when Start is
+                called on a task nobody awaits. Awaiting a task resumes
+                the awaiting coroutine on the thread finishing the
+                task. The task owns the coroutine, so a started task
+                must not be destroyed before it is done
+
+      Methods:  Start
+                  Runs a task nobody awaits until its first suspension
+                IsDone
+                  Returns whether the task returned
+                GetResult
+                  Returns the value returned by the task
+                Task
+                  Constructor.
+                ~Task
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T>
+    class Task final
+    {
+    public:
+        struct promise_type;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FinalAwaiter
+
+          Summary:  Marks the task done and transfers to the awaiting
+                    coroutine, if any
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                // Read before the task is marked done, the owner may destroy it right after
+                const std::coroutine_handle<> continuation = handle.promise().Continuation;
+                handle.promise().bDone.store(true, std::memory_order_release);
+
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   promise_type
+
+          Summary:  State of the coroutine of a task
+
+          Members:  std::optional<T> Result
+                      Value returned by the task
+                    std::coroutine_handle<> Continuation
+                      Coroutine awaiting the task, resumed when it
+                      returns
+                    std::atomic<bool> bDone
+                      Whether the task returned
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct promise_type
+        {
+            std::optional<T> Result;
+            std::coroutine_handle<> Continuation;
+            std::atomic<bool> bDone = false;
+
+            Task get_return_object() noexcept
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() const noexcept
+            {
+                return {};
+            }
+
+            template <typename U>
+            void return_value(U&& value)
+            {
+                Result.emplace(std::forward<U>(value));
+            }
+
+            void unhandled_exception() const noexcept
+            {
+                std::terminate();
+            }
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   Awaiter
+
+          Summary:  Starts an awaited task, the awaiting coroutine is
+                    resumed with its value once it returns
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> Handle;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+            {
+                Handle.promise().Continuation = continuation;
+                return Handle;
+            }
+
+            T await_resume()
+            {
+                return std::move(*Handle.promise().Result);
+            }
+        };
+
+    public:
+        Task() noexcept
+            : m_handle()
+            , m_bStarted(false)
+        {
+        }
+
+        Task(const Task& other) = delete;
+
+        Task(Task&& other) noexcept
+            : m_handle(std::exchange(other.m_handle, nullptr))
+            , m_bStarted(other.m_bStarted)
+        {
+        }
+
+        Task& operator=(const Task& other) = delete;
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (m_handle)
+                {
+                    m_handle.destroy();
+                }
+                m_handle = std::exchange(other.m_handle, nullptr);
+                m_bStarted = other.m_bStarted;
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   Task::Start
+
+          Summary:  Runs a task nobody awaits on the calling thread until
+                    it first suspends, usually to move to another
+                    thread. Does nothing once started
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        void Start()
+        {
+            if (m_handle && !m_bStarted)
+            {
+                m_bStarted = true;
+                m_handle.resume();
+            }
+        }
+
+        bool IsDone() const noexcept
+        {
+            return !m_handle || m_handle.promise().bDone.load(std::memory_order_acquire);
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   Task::GetResult
+
+          Summary:  Returns the value returned by the task, which must be
+                    done
+
+          Returns:  T&
+                      Value returned by the task
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        T& GetResult()
+        {
+            return *m_handle.promise().Result;
+        }
+
+        Awaiter operator co_await() && noexcept
+        {
+            m_bStarted = true;
+            return Awaiter{ .Handle = m_handle };
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+            : m_handle(handle)
+            , m_bStarted(false)
+        {
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+        bool m_bStarted;
+    };
+}
@@ -0,0 +1,127 @@
+/*+===================================================================
+  File:      TRIPLEBUFFER.H
+
+  Summary:   TripleBuffer header file contains the lock free triple
+             buffer handing the newest value written by one thread to
+             another. Only depends on the standard library.
+
+  Classes: TripleBuffer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TripleBuffer
+
+      Summary:  Three values shared by a producer and a consumer. The
+                producer owns one to write, the consumer owns one to
+                read, and the third is the newest published one. The
+                producer publishes by exchanging its value with the
+                published one, the consumer acquires by exchanging its
+                value with the published one when it is new. Neither
+                side ever waits for the other, and a value published
+                while the consumer is busy replaces the older one,
+                which is then never read
+
+      Methods:  GetWriteBuffer
+                  Returns the value the producer writes
+                Publish
+                  Publishes the written value, producer only
+                Acquire
+                  Takes the newest published value, consumer only
+                GetReadBuffer
+                  Returns the value the consumer acquired
+                HasPublished
+                  Returns whether a value was published since the last
+                  Acquire
+                TripleBuffer
+                  Constructor.
+                ~TripleBuffer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T>
+    class TripleBuffer final
+    {
+    public:
+        TripleBuffer()
+            : m_aBuffers()
+            , m_uWrite(0u)
+            , m_uRead(1u)
+            , m_uPublished(2u)
+        {
+        }
+        TripleBuffer(const TripleBuffer& other) = delete;
+        TripleBuffer(TripleBuffer&& other) = delete;
+        TripleBuffer& operator=(const TripleBuffer& other) = delete;
+        TripleBuffer& operator=(TripleBuffer&& other) = delete;
+        ~TripleBuffer() = default;
+
+        T& GetWriteBuffer()
+        {
+            return m_aBuffers[m_uWrite];
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   TripleBuffer::Publish
+
+          Summary:  Publishes the written value and takes the previously
+                    published one to write next. The exchange releases
+                    the writes to the value. Only the producer may call
+                    it
+
+          Modifies: [m_uWrite, m_uPublished].
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        void Publish()
+        {
+            m_uWrite = m_uPublished.exchange(m_uWrite | NEW_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   TripleBuffer::Acquire
+
+          Summary:  Takes the newest published value, if one was
+                    published since the last call, and gives back the
+                    value read before. Only the consumer may call it
+
+          Modifies: [m_uRead, m_uPublished].
+
+          Returns:  bool
+                      true when GetReadBuffer returns a new value
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        bool Acquire()
+        {
+            if (!HasPublished())
+            {
+                return false;
+            }
+
+            m_uRead = m_uPublished.exchange(m_uRead, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+
+        const T& GetReadBuffer() const
+        {
+            return m_aBuffers[m_uRead];
+        }
+
+        bool HasPublished() const
+        {
+            return (m_uPublished.load(std::memory_order_relaxed) & NEW_BIT) != 0u;
+        }
+
+    private:
+        static constexpr std::uint32_t INDEX_MASK = 3u;
+        static constexpr std::uint32_t NEW_BIT = 4u;
+
+        T m_aBuffers[3];
+        std::uint32_t m_uWrite;
+        std::uint32_t m_uRead;
+        alignas(64) std::atomic<std::uint32_t> m_uPublished;
+    };
+}
@@ -0,0 +1,139 @@
+#include "Job/WorkStealingDeque.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WorkStealingDeque::WorkStealingDeque
+
+      Summary:  Constructor of an empty deque
+
+      Modifies: [m_iTop, m_iBottom, m_apJobs].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    WorkStealingDeque::WorkStealingDeque()
+        : m_iTop(0)
+        , m_iBottom(0)
+        , m_apJobs()
+    {
+        for (std::atomic<Job*>& pJob : m_apJobs)
+        {
+            pJob.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WorkStealingDeque::Push
+
+      Summary:  Adds a job at the bottom. Only the owning worker may
+                call it
+
+      Args:     Job* pJob
+                  Job to add
+
+      Modifies: [m_iBottom, m_apJobs].
+
+      Returns:  bool
+                  false when the deque is full, the caller then runs
+                  the job itself
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool WorkStealingDeque::Push(Job* pJob)
+    {
+        const std::int64_t iBottom = m_iBottom.load(std::memory_order_relaxed);
+        const std::int64_t iTop = m_iTop.load(std::memory_order_acquire);
+        if (iBottom - iTop >= static_cast<std::int64_t>(CAPACITY))
+        {
+            return false;
+        }
+
+        // Releases the job to the thieves acquiring the bottom index
+        m_apJobs[static_cast<std::size_t>(iBottom) & MASK].store(pJob, std::memory_order_relaxed);
+        m_iBottom.store(iBottom + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WorkStealingDeque::Pop
+
+      Summary:  Removes the newest job. Only the owning worker may call
+                it. The last job is raced for with the thieves on the
+                top index
+
+      Modifies: [m_iTop, m_iBottom].
+
+      Returns:  Job*
+                  Newest job, nullptr when empty or lost to a thief
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Job* WorkStealingDeque::Pop()
+    {
+        const std::int64_t iBottom = m_iBottom.load(std::memory_order_relaxed) - 1;
+        m_iBottom.store(iBottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t iTop = m_iTop.load(std::memory_order_relaxed);
+
+        if (iTop > iBottom)
+        {
+            m_iBottom.store(iBottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* pJob = m_apJobs[static_cast<std::size_t>(iBottom) & MASK].load(std::memory_order_relaxed);
+        if (iTop == iBottom)
+        {
+            if (!m_iTop.compare_exchange_strong(iTop, iTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                pJob = nullptr;
+            }
+            m_iBottom.store(iBottom + 1, std::memory_order_relaxed);
+        }
+
+        return pJob;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WorkStealingDeque::Steal
+
+      Summary:  Removes the oldest job. Any thread may call it
+
+      Modifies: [m_iTop].
+
+      Returns:  Job*
+                  Oldest job, nullptr when empty or lost to another
+                  thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Job* WorkStealingDeque::Steal()
+    {
+        std::int64_t iTop = m_iTop.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t iBottom = m_iBottom.load(std::memory_order_acquire);
+
+        if (iTop >= iBottom)
+        {
+            return nullptr;
+        }
+
+        Job* pJob = m_apJobs[static_cast<std::size_t>(iTop) & MASK].load(std::memory_order_relaxed);
+        if (!m_iTop.compare_exchange_strong(iTop, iTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+
+        return pJob;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   WorkStealingDeque::GetSize
+
+      Summary:  Returns the number of jobs, already stale when other
+                threads steal
+
+      Returns:  std::size_t
+                  Estimated number of jobs
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::size_t WorkStealingDeque::GetSize() const
+    {
+        const std::int64_t iBottom = m_iBottom.load(std::memory_order_relaxed);
+        const std::int64_t iTop = m_iTop.load(std::memory_order_relaxed);
+
+        return iBottom > iTop ? static_cast<std::size_t>(iBottom - iTop) : 0u;
+    }
+}
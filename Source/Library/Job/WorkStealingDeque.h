@@ -0,0 +1,71 @@
+/*+===================================================================
+  File:      WORKSTEALINGDEQUE.H
+
+  Summary:   WorkStealingDeque header file contains declarations of
+             the Chase-Lev deque each worker of the job system keeps
+             its jobs in. Only depends on the standard library.
+
+  Classes: WorkStealingDeque
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace library
+{
+    struct Job;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    WorkStealingDeque
+
+      Summary:  Fixed size lock free deque of jobs, after Chase and Lev
+                with the memory orders of Le et al. The owning worker
+                pushes and pops at the bottom, the other workers steal
+                from the top, so the owner works on its newest jobs
+                while thieves take the oldest, usually largest, ones
+
+      Methods:  Push
+                  Adds a job at the bottom, owner only
+                Pop
+                  Removes the newest job, owner only
+                Steal
+                  Removes the oldest job, any thread
+                GetSize
+                  Returns an estimate of the number of jobs
+                WorkStealingDeque
+                  Constructor.
+                ~WorkStealingDeque
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class WorkStealingDeque final
+    {
+    public:
+        static constexpr std::size_t CAPACITY = 4096u;
+
+    public:
+        WorkStealingDeque();
+        WorkStealingDeque(const WorkStealingDeque& other) = delete;
+        WorkStealingDeque(WorkStealingDeque&& other) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque& other) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&& other) = delete;
+        ~WorkStealingDeque() = default;
+
+        bool Push(Job* pJob);
+        Job* Pop();
+        Job* Steal();
+        std::size_t GetSize() const;
+
+    private:
+        static constexpr std::size_t MASK = CAPACITY - 1u;
+        static_assert((CAPACITY & MASK) == 0u, "The capacity must be a power of two");
+
+        // Top and bottom on their own cache lines, they are written by different threads
+        alignas(64) std::atomic<std::int64_t> m_iTop;
+        alignas(64) std::atomic<std::int64_t> m_iBottom;
+        alignas(64) std::atomic<Job*> m_apJobs[CAPACITY];
+    };
+}
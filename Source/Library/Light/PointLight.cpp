@@ -13,12 +13,16 @@ namespace library
 				  Position of the light
 				const XMFLOAT4& color
 				  Position of the color
+				FLOAT attenuationRadius
+				  Distance at which the light fades out, 0 when the
+				  light never fades
 
-	  Modifies: [m_position, m_color].
+	  Modifies: [m_position, m_color, m_attenuationRadius].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	PointLight::PointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color) :
+	PointLight::PointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color, _In_ FLOAT attenuationRadius) :
 		m_position(position),
-		m_color(color)
+		m_color(color),
+		m_attenuationRadius(attenuationRadius)
 
 	{}
 
@@ -50,6 +54,20 @@ namespace library
 
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   PointLight::GetAttenuationRadius
+
+	  Summary:  Returns the distance at which the light fades out
+
+	  Returns:  FLOAT
+				  Attenuation radius, 0 when the light never fades
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT PointLight::GetAttenuationRadius() const
+	{
+		return m_attenuationRadius;
+
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   PointLight::Update
 
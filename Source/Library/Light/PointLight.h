@@ -10,12 +10,16 @@ namespace library
       Class:    PointLight
 
       Summary:  Point light that emits a light from a single point to 
-                every direction
+                every direction. A light with an attenuation radius
+                fades out at that distance and only lights the clusters
+                it reaches, a light without one lights everything
 
       Methods:  GetPosition
                   Returns the position of the light
                 GetColor
                   Returns the color of the light
+                GetAttenuationRadius
+                  Returns the distance at which the light fades out
                 Update
                   Updates the light
                 PointLight
@@ -27,7 +31,7 @@ namespace library
     {
     public:
         PointLight() = delete;
-        PointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color);
+        PointLight(_In_ const XMFLOAT4& position, _In_ const XMFLOAT4& color, _In_ FLOAT attenuationRadius = 0.0f);
         PointLight(const PointLight& other) = default;
         PointLight(PointLight&& other) = default;
         PointLight& operator=(const PointLight& other) = default;
@@ -36,10 +40,12 @@ namespace library
 
         const XMFLOAT4& GetPosition() const;
         const XMFLOAT4& GetColor() const;
+        FLOAT GetAttenuationRadius() const;
 
         virtual void Update(_In_ FLOAT deltaTime);
     protected:
         XMFLOAT4 m_position;
         XMFLOAT4 m_color;
+        FLOAT m_attenuationRadius;
     };
 }
\ No newline at end of file
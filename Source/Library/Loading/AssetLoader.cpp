@@ -0,0 +1,321 @@
+#include "Loading/AssetLoader.h"
+
+#include <chrono>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::AssetLoader
+
+      Summary:  Constructor of a loader without threads, loading inline
+                until initialized
+
+      Modifies: [m_d3dDevice, m_immediateContext, m_loaderQueue,
+                 m_deviceQueue, m_aThreads, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetLoader::AssetLoader()
+        : m_d3dDevice()
+        , m_immediateContext()
+        , m_loaderQueue()
+        , m_deviceQueue()
+        , m_aThreads()
+        , m_bStopping(FALSE)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::~AssetLoader
+
+      Summary:  Destructor stopping the loader threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetLoader::~AssetLoader()
+    {
+        Shutdown();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::Initialize
+
+      Summary:  Keeps the device creating the assets and starts the
+                loader threads. The thread calling it becomes the device
+                thread. Without loader threads, the loads read their
+                files inline on the thread starting them
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the assets
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context of the device thread
+                UINT uNumThreads
+                  Number of loader threads
+
+      Modifies: [m_d3dDevice, m_immediateContext, m_aThreads,
+                 m_bStopping].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG without device
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT AssetLoader::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumThreads)
+    {
+        if (!pDevice || !pImmediateContext)
+        {
+            return E_INVALIDARG;
+        }
+
+        Shutdown();
+
+        m_d3dDevice = pDevice;
+        m_immediateContext = pImmediateContext;
+
+        m_bStopping = FALSE;
+        m_aThreads.reserve(uNumThreads);
+        for (UINT i = 0u; i < uNumThreads; ++i)
+        {
+            m_aThreads.emplace_back(&AssetLoader::loaderThreadMain, this);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::Shutdown
+
+      Summary:  Stops the loader threads once they finish the loads
+                they are running. The loads still queued are never
+                resumed, the tasks owning them can only be destroyed
+
+      Modifies: [m_aThreads, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetLoader::Shutdown()
+    {
+        if (m_aThreads.empty())
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_loaderQueue.Mutex);
+            m_bStopping = TRUE;
+        }
+        m_loaderQueue.Condition.notify_all();
+
+        for (std::thread& thread : m_aThreads)
+        {
+            thread.join();
+        }
+        m_aThreads.clear();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::ResumeOnLoaderThread
+
+      Summary:  Returns the awaitable moving the awaiting coroutine to
+                a loader thread, or keeping it on the calling thread
+                when there are no loader threads
+
+      Args:     eLoadPriority priority
+                  Priority of the coroutine in the queue
+
+      Returns:  QueueAwaiter
+                  Awaitable of the loader threads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetLoader::QueueAwaiter AssetLoader::ResumeOnLoaderThread(_In_ eLoadPriority priority)
+    {
+        return QueueAwaiter{ .pLoader = this, .pQueue = &m_loaderQueue, .Priority = priority, .bInline = m_aThreads.empty() };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::ResumeOnDeviceThread
+
+      Summary:  Returns the awaitable moving the awaiting coroutine to
+                the device thread, which resumes it in RunDeviceWork or
+                Wait. Always queues, even from the device thread, so a
+                frame never runs more creation than its budget
+
+      Args:     eLoadPriority priority
+                  Priority of the coroutine in the queue
+
+      Returns:  QueueAwaiter
+                  Awaitable of the device thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    AssetLoader::QueueAwaiter AssetLoader::ResumeOnDeviceThread(_In_ eLoadPriority priority)
+    {
+        return QueueAwaiter{ .pLoader = this, .pQueue = &m_deviceQueue, .Priority = priority, .bInline = false };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::RunDeviceWork
+
+      Summary:  Resumes the coroutines waiting for the device thread,
+                highest priority first, until none is left or the time
+                is spent. Called once per frame by the thread owning
+                the immediate context, it never sleeps
+
+      Args:     FLOAT maxSeconds
+                  Time after which no other coroutine is resumed. At
+                  least one is resumed when any waits
+
+      Returns:  UINT
+                  Number of coroutines resumed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT AssetLoader::RunDeviceWork(_In_ FLOAT maxSeconds)
+    {
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        UINT uNumResumed = 0u;
+        for (;;)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::lock_guard<std::mutex> lock(m_deviceQueue.Mutex);
+                handle = popHighestPriority(m_deviceQueue);
+            }
+            if (!handle)
+            {
+                break;
+            }
+
+            handle.resume();
+            ++uNumResumed;
+
+            if (std::chrono::duration<FLOAT>(std::chrono::steady_clock::now() - start).count() >= maxSeconds)
+            {
+                break;
+            }
+        }
+
+        return uNumResumed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::LoadThenCreate
+
+      Summary:  Runs the two halves of the loading of an asset: the
+                load, touching no Direct3D object, on a loader thread,
+                then the creation on the device thread. Returns to the
+                device thread even when the load fails or is cancelled,
+                so the task always finishes there
+
+      Args:     std::function<HRESULT()> load
+                  Reads and parses the files of the asset
+                std::function<HRESULT(ID3D11Device*, ID3D11DeviceContext*)> create
+                  Creates the Direct3D objects of the asset, only
+                  called when the load succeeded
+                eLoadPriority priority
+                  Priority of both halves
+                std::stop_token stopToken
+                  Cancels the halves not yet started
+
+      Returns:  Task<HRESULT>
+                  Status code, E_ABORT if cancelled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Task<HRESULT> AssetLoader::LoadThenCreate(
+        std::function<HRESULT()> load,
+        std::function<HRESULT(ID3D11Device*, ID3D11DeviceContext*)> create,
+        eLoadPriority priority,
+        std::stop_token stopToken
+    )
+    {
+        co_await ResumeOnLoaderThread(priority);
+
+        HRESULT hr = stopToken.stop_requested() ? E_ABORT : load();
+
+        co_await ResumeOnDeviceThread(priority);
+
+        if (SUCCEEDED(hr))
+        {
+            hr = stopToken.stop_requested() ? E_ABORT : create(m_d3dDevice.Get(), m_immediateContext.Get());
+        }
+
+        co_return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::schedule
+
+      Summary:  Queues a suspended coroutine and wakes a thread serving
+                the queue. The coroutine may be resumed before this
+                returns, so only the arguments are used
+
+      Args:     Queue& queue
+                  Queue of the threads to resume the coroutine on
+                eLoadPriority priority
+                  Priority of the coroutine
+                std::coroutine_handle<> handle
+                  Suspended coroutine
+
+      Modifies: [m_loaderQueue, m_deviceQueue].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetLoader::schedule(_In_ Queue& queue, _In_ eLoadPriority priority, _In_ std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(queue.Mutex);
+            queue.aHandles[static_cast<size_t>(priority)].push_back(handle);
+        }
+        queue.Condition.notify_one();
+    }
+
+    BOOL AssetLoader::isEmpty(_In_ const Queue& queue)
+    {
+        for (const std::deque<std::coroutine_handle<>>& aHandles : queue.aHandles)
+        {
+            if (!aHandles.empty())
+            {
+                return FALSE;
+            }
+        }
+        return TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::popHighestPriority
+
+      Summary:  Removes the oldest coroutine of the highest priority
+                from a queue, whose mutex must be locked
+
+      Args:     Queue& queue
+                  Queue to pop from
+
+      Returns:  std::coroutine_handle<>
+                  Coroutine to resume, nullptr if the queue is empty
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::coroutine_handle<> AssetLoader::popHighestPriority(_In_ Queue& queue)
+    {
+        for (size_t uPriority = static_cast<size_t>(eLoadPriority::COUNT); uPriority-- > 0u;)
+        {
+            std::deque<std::coroutine_handle<>>& aHandles = queue.aHandles[uPriority];
+            if (!aHandles.empty())
+            {
+                const std::coroutine_handle<> handle = aHandles.front();
+                aHandles.pop_front();
+                return handle;
+            }
+        }
+        return nullptr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::loaderThreadMain
+
+      Summary:  Loop of a loader thread, resuming the coroutines of the
+                loader queue and sleeping while it is empty, until the
+                loader stops
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void AssetLoader::loaderThreadMain()
+    {
+        for (;;)
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(m_loaderQueue.Mutex);
+                m_loaderQueue.Condition.wait(lock, [this]() { return m_bStopping || !isEmpty(m_loaderQueue); });
+                if (m_bStopping)
+                {
+                    return;
+                }
+                handle = popHighestPriority(m_loaderQueue);
+            }
+
+            handle.resume();
+        }
+    }
+}
@@ -0,0 +1,194 @@
+/*+===================================================================
+  File:      ASSETLOADER.H
+
+  Summary:   AssetLoader header file contains declarations of the
+             asynchronous loading of the assets. The files are read
+             and decoded on loader threads, and the Direct3D objects
+             are created on the device thread, through coroutines.
+
+  Classes: AssetLoader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "Job/Task.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eLoadPriority
+
+      Summary:  Priorities of the loads, the higher ones are resumed
+                first on both the loader and the device threads
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eLoadPriority : BYTE
+    {
+        LOW,
+        NORMAL,
+        HIGH,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    AssetLoader
+
+      Summary:  Runs the loads of the assets as coroutines moving
+                between two kinds of threads. The loader threads read
+                and parse the files, they block on the disk, so they
+                are kept apart from the job system running the frames.
+                The device thread, the one owning the immediate
+                context, creates the Direct3D objects when it calls
+                RunDeviceWork or Wait. Each queue resumes the loads of
+                the highest priority first, and every load can be
+                cancelled through a stop token. The loads always finish
+                on the device thread, so the coroutines awaiting them
+                continue there
+
+      Methods:  Initialize
+                  Starts the loader threads
+                Shutdown
+                  Stops the loader threads
+                ResumeOnLoaderThread
+                  Awaitable moving a coroutine to a loader thread
+                ResumeOnDeviceThread
+                  Awaitable moving a coroutine to the device thread
+                RunDeviceWork
+                  Resumes the coroutines waiting for the device thread
+                Wait
+                  Resumes them until a task is done
+                LoadThenCreate
+                  Loads on a loader thread then creates on the device
+                  thread
+                AssetLoader
+                  Constructor.
+                ~AssetLoader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class AssetLoader final
+    {
+    public:
+        static constexpr UINT DEFAULT_NUM_THREADS = 2u;
+
+    private:
+        struct Queue
+        {
+            std::deque<std::coroutine_handle<>> aHandles[static_cast<size_t>(eLoadPriority::COUNT)];
+            std::mutex Mutex;
+            std::condition_variable Condition;
+        };
+
+    public:
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   QueueAwaiter
+
+          Summary:  Suspends a coroutine into a queue of the loader,
+                    the thread serving the queue resumes it
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct QueueAwaiter
+        {
+            AssetLoader* pLoader;
+            Queue* pQueue;
+            eLoadPriority Priority;
+            bool bInline;
+
+            bool await_ready() const noexcept
+            {
+                return bInline;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) const
+            {
+                pLoader->schedule(*pQueue, Priority, handle);
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+    public:
+        AssetLoader();
+        AssetLoader(const AssetLoader& other) = delete;
+        AssetLoader(AssetLoader&& other) = delete;
+        AssetLoader& operator=(const AssetLoader& other) = delete;
+        AssetLoader& operator=(AssetLoader&& other) = delete;
+        ~AssetLoader();
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext, _In_ UINT uNumThreads = DEFAULT_NUM_THREADS);
+        void Shutdown();
+
+        QueueAwaiter ResumeOnLoaderThread(_In_ eLoadPriority priority);
+        QueueAwaiter ResumeOnDeviceThread(_In_ eLoadPriority priority);
+        UINT RunDeviceWork(_In_ FLOAT maxSeconds);
+
+        template <typename T>
+        T& Wait(_In_ Task<T>& task);
+
+        Task<HRESULT> LoadThenCreate(
+            std::function<HRESULT()> load,
+            std::function<HRESULT(ID3D11Device*, ID3D11DeviceContext*)> create,
+            eLoadPriority priority = eLoadPriority::NORMAL,
+            std::stop_token stopToken = {}
+        );
+
+    private:
+        void schedule(_In_ Queue& queue, _In_ eLoadPriority priority, _In_ std::coroutine_handle<> handle);
+        static BOOL isEmpty(_In_ const Queue& queue);
+        static std::coroutine_handle<> popHighestPriority(_In_ Queue& queue);
+        void loaderThreadMain();
+
+    private:
+        ComPtr<ID3D11Device> m_d3dDevice;
+        ComPtr<ID3D11DeviceContext> m_immediateContext;
+        Queue m_loaderQueue;
+        Queue m_deviceQueue;
+        std::vector<std::thread> m_aThreads;
+        BOOL m_bStopping;
+    };
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   AssetLoader::Wait
+
+      Summary:  Starts a task if needed, then resumes the coroutines
+                waiting for the device thread, sleeping while there are
+                none, until the task is done. Must be called from the
+                device thread, with a task finishing there like the
+                loads of the loader
+
+      Args:     Task<T>& task
+                  Task to wait for
+
+      Returns:  T&
+                  Value returned by the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    template <typename T>
+    T& AssetLoader::Wait(_In_ Task<T>& task)
+    {
+        task.Start();
+
+        while (!task.IsDone())
+        {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock<std::mutex> lock(m_deviceQueue.Mutex);
+                m_deviceQueue.Condition.wait(lock, [this]() { return !isEmpty(m_deviceQueue); });
+                handle = popHighestPriority(m_deviceQueue);
+            }
+            handle.resume();
+        }
+
+        return task.GetResult();
+    }
+}
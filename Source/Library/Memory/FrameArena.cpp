@@ -0,0 +1,106 @@
+#include "Memory/FrameArena.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameArena::FrameArena
+
+      Summary:  Constructor allocating the blocks of the frames
+
+      Args:     size_t uCapacity
+                  Initial size of the block of each frame
+
+      Modifies: [m_aBlocks, m_uCurrentBlock, m_uNumOverflows].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrameArena::FrameArena(_In_ size_t uCapacity)
+        : m_aBlocks()
+        , m_uCurrentBlock(0u)
+        , m_uNumOverflows(0u)
+    {
+        for (Block& block : m_aBlocks)
+        {
+            block.aMemory = TaggedVector<BYTE, eMemoryTag::RENDERER>(uCapacity);
+            block.uCapacity = uCapacity;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameArena::BeginFrame
+
+      Summary:  Moves to the block of the next frame and empties it.
+                When it overflowed the last time it served, it grows
+                to hold everything that frame allocated
+
+      Modifies: [m_aBlocks, m_uCurrentBlock].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameArena::BeginFrame()
+    {
+        m_uCurrentBlock = (m_uCurrentBlock + 1u) % NUM_FRAMES;
+
+        Block& block = m_aBlocks[m_uCurrentBlock];
+        if (block.uOverflowBytes > 0u)
+        {
+            block.uCapacity = std::max(2u * block.uCapacity, block.uUsed + block.uOverflowBytes);
+            block.aMemory = TaggedVector<BYTE, eMemoryTag::RENDERER>(block.uCapacity);
+            block.aOverflows.clear();
+            block.uOverflowBytes = 0u;
+        }
+        block.uUsed = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameArena::Allocate
+
+      Summary:  Allocates from the block of the current frame, or from
+                the heap when the block is full
+
+      Args:     size_t uSize
+                  Number of bytes
+                size_t uAlignment
+                  Alignment of the memory, a power of two
+
+      Modifies: [m_aBlocks, m_uNumOverflows].
+
+      Returns:  void*
+                  Memory valid until the block of the current frame is
+                  started again, NUM_FRAMES frames later
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void* FrameArena::Allocate(_In_ size_t uSize, _In_ size_t uAlignment)
+    {
+        Block& block = m_aBlocks[m_uCurrentBlock];
+
+        const uintptr_t uBase = reinterpret_cast<uintptr_t>(block.aMemory.data());
+        const uintptr_t uAligned = (uBase + block.uUsed + uAlignment - 1u) & ~static_cast<uintptr_t>(uAlignment - 1u);
+        const size_t uEnd = static_cast<size_t>(uAligned - uBase) + uSize;
+        if (uEnd <= block.uCapacity)
+        {
+            block.uUsed = uEnd;
+            return reinterpret_cast<void*>(uAligned);
+        }
+
+        // Counted in the size of the block the next time it is used
+        ++m_uNumOverflows;
+        block.uOverflowBytes += uSize + uAlignment;
+        block.aOverflows.emplace_back(uSize + uAlignment);
+
+        const uintptr_t uOverflow = reinterpret_cast<uintptr_t>(block.aOverflows.back().data());
+        return reinterpret_cast<void*>((uOverflow + uAlignment - 1u) & ~static_cast<uintptr_t>(uAlignment - 1u));
+    }
+
+    size_t FrameArena::GetUsedBytes() const
+    {
+        return m_aBlocks[m_uCurrentBlock].uUsed + m_aBlocks[m_uCurrentBlock].uOverflowBytes;
+    }
+
+    size_t FrameArena::GetCapacity() const
+    {
+        return m_aBlocks[m_uCurrentBlock].uCapacity;
+    }
+
+    UINT64 FrameArena::GetNumOverflows() const
+    {
+        return m_uNumOverflows;
+    }
+}
@@ -0,0 +1,157 @@
+/*+===================================================================
+  File:      FRAMEARENA.H
+
+  Summary:   FrameArena header file contains the linear allocator of
+             the transient allocations of a frame, and the allocator
+             adapting it to the standard containers.
+
+  Classes: FrameArena, FrameAllocator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Memory/MemoryTracker.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrameArena
+
+      Summary:  Bump allocator of the transient data of a frame. Each
+                of NUM_FRAMES blocks serves one frame in turn, so what
+                a frame allocates stays valid while the next one is
+                built, and nothing is freed one by one. A frame
+                allocating more than its block gets extra blocks from
+                the heap, and its block grows to fit them the next
+                time it is used, so a steady frame never reaches the
+                heap. Only one thread, the one beginning the frames,
+                may allocate
+
+      Methods:  BeginFrame
+                  Starts the next frame, releasing what its block
+                  served NUM_FRAMES frames ago
+                Allocate
+                  Allocates memory valid until the same block is
+                  started again
+                GetUsedBytes
+                  Returns the bytes allocated in the current frame
+                GetCapacity
+                  Returns the size of the block of the current frame
+                GetNumOverflows
+                  Returns the number of allocations served by the heap
+                FrameArena
+                  Constructor.
+                ~FrameArena
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrameArena final
+    {
+    public:
+        static constexpr UINT NUM_FRAMES = 2u;
+        static constexpr size_t DEFAULT_CAPACITY = 256u * 1024u;
+
+    public:
+        FrameArena(_In_ size_t uCapacity = DEFAULT_CAPACITY);
+        FrameArena(const FrameArena& other) = delete;
+        FrameArena(FrameArena&& other) = delete;
+        FrameArena& operator=(const FrameArena& other) = delete;
+        FrameArena& operator=(FrameArena&& other) = delete;
+        ~FrameArena() = default;
+
+        void BeginFrame();
+        void* Allocate(_In_ size_t uSize, _In_ size_t uAlignment);
+
+        size_t GetUsedBytes() const;
+        size_t GetCapacity() const;
+        UINT64 GetNumOverflows() const;
+
+    private:
+        struct Block
+        {
+            TaggedVector<BYTE, eMemoryTag::RENDERER> aMemory;
+            size_t uCapacity;
+            size_t uUsed;
+            size_t uOverflowBytes;
+            std::vector<TaggedVector<BYTE, eMemoryTag::RENDERER>> aOverflows;
+        };
+
+    private:
+        Block m_aBlocks[NUM_FRAMES];
+        UINT m_uCurrentBlock;
+        UINT64 m_uNumOverflows;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrameAllocator
+
+      Summary:  Standard allocator taking its memory from a frame
+                arena. Deallocation does nothing, the memory goes back
+                with the frame. The allocator follows the containers
+                when they are assigned, so a container is emptied for a
+                new frame by assigning it a new one
+
+      Methods:  allocate
+                  Allocates an array from the arena
+                deallocate
+                  Does nothing
+                GetArena
+                  Returns the arena
+                FrameAllocator
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T>
+    class FrameAllocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+    public:
+        FrameAllocator(_In_ FrameArena& arena) noexcept
+            : m_pArena(&arena)
+        {
+        }
+
+        template <typename U>
+        FrameAllocator(_In_ const FrameAllocator<U>& other) noexcept
+            : m_pArena(other.GetArena())
+        {
+        }
+
+        T* allocate(_In_ size_t uCount)
+        {
+            return static_cast<T*>(m_pArena->Allocate(uCount * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(_In_ T* p, _In_ size_t uCount) noexcept
+        {
+            UNREFERENCED_PARAMETER(p);
+            UNREFERENCED_PARAMETER(uCount);
+        }
+
+        FrameArena* GetArena() const noexcept
+        {
+            return m_pArena;
+        }
+
+        template <typename U>
+        bool operator==(_In_ const FrameAllocator<U>& other) const noexcept
+        {
+            return m_pArena == other.GetArena();
+        }
+
+    private:
+        FrameArena* m_pArena;
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
@@ -0,0 +1,103 @@
+#include "Memory/HeapAllocationCheck.h"
+
+namespace library
+{
+#if defined(DEBUG) || defined(_DEBUG)
+    namespace
+    {
+        thread_local BOOL s_bCounting = FALSE;
+        thread_local UINT64 s_uNumAllocations = 0u;
+        _CRT_ALLOC_HOOK s_pfnPreviousHook = nullptr;
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: countAllocation
+
+          Summary:  Allocation hook of the debug heap counting the
+                    allocations of the threads that are counting, then
+                    passing the call on to the previous hook
+
+          Args:     int allocType
+                      _HOOK_ALLOC, _HOOK_REALLOC or _HOOK_FREE
+                    void* pUserData
+                    size_t uSize
+                    int blockType
+                    long requestNumber
+                    const unsigned char* pszFileName
+                    int lineNumber
+                      See _CrtSetAllocHook
+
+          Returns:  int
+                      TRUE to let the operation proceed
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        int __cdecl countAllocation(int allocType, void* pUserData, size_t uSize, int blockType, long requestNumber, const unsigned char* pszFileName, int lineNumber)
+        {
+            if (s_bCounting && allocType != _HOOK_FREE)
+            {
+                ++s_uNumAllocations;
+            }
+
+            return s_pfnPreviousHook
+                ? s_pfnPreviousHook(allocType, pUserData, uSize, blockType, requestNumber, pszFileName, lineNumber)
+                : TRUE;
+        }
+    }
+#endif
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeapAllocationCheck::HeapAllocationCheck
+
+      Summary:  Constructor installing the allocation hook in debug
+                builds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeapAllocationCheck::HeapAllocationCheck()
+    {
+#if defined(DEBUG) || defined(_DEBUG)
+        s_pfnPreviousHook = _CrtSetAllocHook(countAllocation);
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeapAllocationCheck::~HeapAllocationCheck
+
+      Summary:  Destructor restoring the previous allocation hook
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HeapAllocationCheck::~HeapAllocationCheck()
+    {
+#if defined(DEBUG) || defined(_DEBUG)
+        _CrtSetAllocHook(s_pfnPreviousHook);
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeapAllocationCheck::Begin
+
+      Summary:  Resets the count of the calling thread and starts
+                counting its allocations
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void HeapAllocationCheck::Begin()
+    {
+#if defined(DEBUG) || defined(_DEBUG)
+        s_uNumAllocations = 0u;
+        s_bCounting = TRUE;
+#endif
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   HeapAllocationCheck::End
+
+      Summary:  Stops counting the allocations of the calling thread
+
+      Returns:  UINT64
+                  Number of heap allocations the thread made since
+                  Begin, always 0 in release builds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 HeapAllocationCheck::End()
+    {
+#if defined(DEBUG) || defined(_DEBUG)
+        s_bCounting = FALSE;
+        return s_uNumAllocations;
+#else
+        return 0u;
+#endif
+    }
+}
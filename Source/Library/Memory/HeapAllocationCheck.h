@@ -0,0 +1,48 @@
+/*+===================================================================
+  File:      HEAPALLOCATIONCHECK.H
+
+  Summary:   HeapAllocationCheck header file contains the debug check
+             that a section of code does not allocate from the heap.
+
+  Classes: HeapAllocationCheck
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    HeapAllocationCheck
+
+      Summary:  Counts the allocations the calling thread makes from
+                the debug heap of the C runtime between Begin and End,
+                through an allocation hook. Only counts in debug builds,
+                where the hook exists; in release builds End always
+                returns 0. Other threads are never counted
+
+      Methods:  Begin
+                  Starts counting the allocations of the calling thread
+                End
+                  Stops counting and returns the count
+                HeapAllocationCheck
+                  Constructor.
+                ~HeapAllocationCheck
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class HeapAllocationCheck final
+    {
+    public:
+        HeapAllocationCheck();
+        HeapAllocationCheck(const HeapAllocationCheck& other) = delete;
+        HeapAllocationCheck(HeapAllocationCheck&& other) = delete;
+        HeapAllocationCheck& operator=(const HeapAllocationCheck& other) = delete;
+        HeapAllocationCheck& operator=(HeapAllocationCheck&& other) = delete;
+        ~HeapAllocationCheck();
+
+        void Begin();
+        UINT64 End();
+    };
+}
@@ -0,0 +1,138 @@
+#include "Memory/MemoryTracker.h"
+
+#include <atomic>
+
+namespace library
+{
+    namespace
+    {
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   TagCounters
+
+          Summary:  Counters of a tag, on their own cache line so the
+                    tags recorded by different threads do not share one
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct alignas(64) TagCounters
+        {
+            std::atomic<std::uint64_t> uLiveBytes;
+            std::atomic<std::uint64_t> uPeakBytes;
+            std::atomic<std::uint64_t> uLiveAllocations;
+            std::atomic<std::uint64_t> uTotalAllocations;
+        };
+
+        // Constant initialized, so it is ready before any other static object allocates
+        constinit TagCounters s_aCounters[static_cast<std::size_t>(eMemoryTag::COUNT)] = {};
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MemoryTracker::RecordAllocation
+
+      Summary:  Counts an allocation under a tag and raises its peak
+                when the live bytes pass it
+
+      Args:     eMemoryTag tag
+                  Tag of the memory
+                std::size_t uBytes
+                  Size of the allocation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MemoryTracker::RecordAllocation(eMemoryTag tag, std::size_t uBytes)
+    {
+        TagCounters& counters = s_aCounters[static_cast<std::size_t>(tag)];
+
+        const std::uint64_t uLiveBytes = counters.uLiveBytes.fetch_add(uBytes, std::memory_order_relaxed) + uBytes;
+        counters.uLiveAllocations.fetch_add(1u, std::memory_order_relaxed);
+        counters.uTotalAllocations.fetch_add(1u, std::memory_order_relaxed);
+
+        std::uint64_t uPeakBytes = counters.uPeakBytes.load(std::memory_order_relaxed);
+        while (uLiveBytes > uPeakBytes && !counters.uPeakBytes.compare_exchange_weak(uPeakBytes, uLiveBytes, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void MemoryTracker::RecordFree(eMemoryTag tag, std::size_t uBytes)
+    {
+        TagCounters& counters = s_aCounters[static_cast<std::size_t>(tag)];
+
+        counters.uLiveBytes.fetch_sub(uBytes, std::memory_order_relaxed);
+        counters.uLiveAllocations.fetch_sub(1u, std::memory_order_relaxed);
+    }
+
+    MemoryStats MemoryTracker::GetStats(eMemoryTag tag)
+    {
+        const TagCounters& counters = s_aCounters[static_cast<std::size_t>(tag)];
+
+        return MemoryStats
+        {
+            .uLiveBytes = counters.uLiveBytes.load(std::memory_order_relaxed),
+            .uPeakBytes = counters.uPeakBytes.load(std::memory_order_relaxed),
+            .uLiveAllocations = counters.uLiveAllocations.load(std::memory_order_relaxed),
+            .uTotalAllocations = counters.uTotalAllocations.load(std::memory_order_relaxed),
+        };
+    }
+
+    const char* MemoryTracker::GetTagName(eMemoryTag tag)
+    {
+        switch (tag)
+        {
+        case eMemoryTag::SCENE:
+            return "Scene";
+        case eMemoryTag::MODEL:
+            return "Model";
+        case eMemoryTag::ANIMATION:
+            return "Animation";
+        case eMemoryTag::TEXTURE:
+            return "Texture";
+        case eMemoryTag::RENDERER:
+            return "Renderer";
+        default:
+            return "Unknown";
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   MemoryTracker::Dump
+
+      Summary:  Prints a table of the live and peak kilobytes and the
+                allocations of every tag, then their total. The total
+                peak is the sum of the peaks, which may have been
+                reached at different times
+
+      Args:     std::FILE* pFile
+                  File to print to, such as stdout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void MemoryTracker::Dump(std::FILE* pFile)
+    {
+        std::fprintf(pFile, "%-10s %12s %12s %10s %12s\n", "tag", "live KB", "peak KB", "live", "allocations");
+
+        MemoryStats total = {};
+        for (std::size_t i = 0u; i < static_cast<std::size_t>(eMemoryTag::COUNT); ++i)
+        {
+            const eMemoryTag tag = static_cast<eMemoryTag>(i);
+            const MemoryStats stats = GetStats(tag);
+            std::fprintf(
+                pFile,
+                "%-10s %12.1f %12.1f %10llu %12llu\n",
+                GetTagName(tag),
+                static_cast<double>(stats.uLiveBytes) / 1024.0,
+                static_cast<double>(stats.uPeakBytes) / 1024.0,
+                static_cast<unsigned long long>(stats.uLiveAllocations),
+                static_cast<unsigned long long>(stats.uTotalAllocations)
+            );
+
+            total.uLiveBytes += stats.uLiveBytes;
+            total.uPeakBytes += stats.uPeakBytes;
+            total.uLiveAllocations += stats.uLiveAllocations;
+            total.uTotalAllocations += stats.uTotalAllocations;
+        }
+
+        std::fprintf(
+            pFile,
+            "%-10s %12.1f %12.1f %10llu %12llu\n",
+            "Total",
+            static_cast<double>(total.uLiveBytes) / 1024.0,
+            static_cast<double>(total.uPeakBytes) / 1024.0,
+            static_cast<unsigned long long>(total.uLiveAllocations),
+            static_cast<unsigned long long>(total.uTotalAllocations)
+        );
+    }
+}
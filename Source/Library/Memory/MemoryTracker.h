@@ -0,0 +1,148 @@
+/*+===================================================================
+  File:      MEMORYTRACKER.H
+
+  Summary:   MemoryTracker header file contains the accounting of the
+             memory of each subsystem, and the standard allocator
+             tagging the memory of a container. Only depends on the
+             standard library.
+
+  Classes: MemoryTracker, TaggedAllocator
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eMemoryTag
+
+      Summary:  Subsystems the memory is accounted to
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eMemoryTag : std::uint8_t
+    {
+        SCENE,
+        MODEL,
+        ANIMATION,
+        TEXTURE,
+        RENDERER,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   MemoryStats
+
+      Summary:  Memory accounted to a tag
+
+      Members:  std::uint64_t uLiveBytes
+                  Bytes allocated and not yet freed
+                std::uint64_t uPeakBytes
+                  Highest number of live bytes so far
+                std::uint64_t uLiveAllocations
+                  Allocations not yet freed
+                std::uint64_t uTotalAllocations
+                  Allocations so far
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct MemoryStats
+    {
+        std::uint64_t uLiveBytes;
+        std::uint64_t uPeakBytes;
+        std::uint64_t uLiveAllocations;
+        std::uint64_t uTotalAllocations;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    MemoryTracker
+
+      Summary:  Process wide counters of the memory of each tag. The
+                counters are atomic, so any thread may record, and they
+                need no construction, so memory may be recorded before
+                main. Only the memory recorded through it is counted,
+                mostly by the containers using TaggedAllocator
+
+      Methods:  RecordAllocation
+                  Counts an allocation
+                RecordFree
+                  Counts a deallocation
+                GetStats
+                  Returns the counters of a tag
+                GetTagName
+                  Returns the name of a tag
+                Dump
+                  Prints the counters of every tag
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class MemoryTracker final
+    {
+    public:
+        MemoryTracker() = delete;
+
+        static void RecordAllocation(eMemoryTag tag, std::size_t uBytes);
+        static void RecordFree(eMemoryTag tag, std::size_t uBytes);
+        static MemoryStats GetStats(eMemoryTag tag);
+        static const char* GetTagName(eMemoryTag tag);
+        static void Dump(std::FILE* pFile);
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TaggedAllocator
+
+      Summary:  Standard allocator taking its memory from the heap like
+                std::allocator, and recording it under a tag of the
+                memory tracker. It has no state, so all the allocators
+                of a tag are equal
+
+      Methods:  allocate
+                  Allocates and records memory
+                deallocate
+                  Records and frees memory
+                TaggedAllocator
+                  Constructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <typename T, eMemoryTag TAG>
+    class TaggedAllocator
+    {
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef TaggedAllocator<U, TAG> other;
+        };
+
+    public:
+        TaggedAllocator() noexcept = default;
+
+        template <typename U>
+        TaggedAllocator(const TaggedAllocator<U, TAG>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t uCount)
+        {
+            T* p = std::allocator<T>().allocate(uCount);
+            MemoryTracker::RecordAllocation(TAG, uCount * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T* p, std::size_t uCount) noexcept
+        {
+            MemoryTracker::RecordFree(TAG, uCount * sizeof(T));
+            std::allocator<T>().deallocate(p, uCount);
+        }
+
+        template <typename U>
+        bool operator==(const TaggedAllocator<U, TAG>&) const noexcept
+        {
+            return true;
+        }
+    };
+
+    template <typename T, eMemoryTag TAG>
+    using TaggedVector = std::vector<T, TaggedAllocator<T, TAG>>;
+}
@@ -61,8 +61,6 @@ namespace library
         return XMLoadFloat4(&float4);
     }
 
-    std::unique_ptr<Assimp::Importer> Model::sm_pImporter = std::make_unique<Assimp::Importer>();
-
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Model
 
@@ -71,11 +69,13 @@ namespace library
       Args:     const std::filesystem::path& filePath
                   Path to the model to load
 
-      Modifies: [m_filePath, m_animationBuffer, m_skinningConstantBuffer,
-                 m_skinningConstantBuffer, m_aVertices, m_aAnimationData,
+      Modifies: [m_filePath, m_importer, m_animationBuffer, m_boneTransforms,
+                 m_boneTransformsView, m_aVertices, m_aAnimationData,
                  m_aIndices, m_aBoneData, m_aBoneInfo, m_aTransforms,
-                 m_aBoneInfo, m_aTransforms, m_boneNameToIndexMap,
-                 m_pScene, m_timeSinceLoaded, m_globalInverseTransform].
+                 m_aPackedTransforms, m_boneNameToIndexMap, m_pScene,
+                 m_timeSinceLoaded, m_animationSpeed, m_poseUpdateInterval,
+                 m_timeSincePoseUpdate, m_poseTime, m_bPoseChanged,
+                 m_uPoseUploadFrame, m_globalInverseTransform].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Model::Model definition (remove the comment)
@@ -84,24 +84,95 @@ namespace library
     Model::Model(_In_ const std::filesystem::path& filePath)
         : Renderable(XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f))
         , m_filePath(filePath)
+        , m_importer(std::make_unique<Assimp::Importer>())
         , m_animationBuffer(nullptr)
-        , m_skinningConstantBuffer(nullptr)
-        , m_aVertices(std::vector<SimpleVertex>())
-        , m_aAnimationData(std::vector<AnimationData>())
-        , m_aIndices(std::vector<WORD>())
-        , m_aBoneData(std::vector<VertexBoneData>())
+        , m_boneTransforms(nullptr)
+        , m_boneTransformsView(nullptr)
+        , m_diffuseSliceBuffer(nullptr)
+        , m_materialDrawIndexBuffer(nullptr)
+        , m_aVertices()
+        , m_aAnimationData()
+        , m_aIndices()
+        , m_aBoneData()
         , m_aBoneInfo(std::vector<BoneInfo>())
         , m_aTransforms(std::vector<XMMATRIX>())
-        , m_boneNameToIndexMap(std::unordered_map<std::string, UINT>())
+        , m_aPackedTransforms()
+        , m_boneNameToIndexMap()
+        , m_aDiffuseArrays()
+        , m_auMaterialDiffuseArrays()
+        , m_auMaterialDiffuseSlices()
+        , m_auDiffuseSlices()
+        , m_aMaterialDraws()
+        , m_aMaterialDrawIndices()
         , m_pScene(nullptr)
         , m_timeSinceLoaded(0)
+        , m_animationSpeed(1.0f)
+        , m_poseUpdateInterval(0.0f)
+        , m_timeSincePoseUpdate(0.0f)
+        , m_poseTime(0.0f)
+        , m_bPoseChanged(FALSE)
+        , m_uPoseUploadFrame(0u)
         , m_globalInverseTransform(XMMatrixIdentity())
     { }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::~Model
+
+      Summary:  Destructor, defined where the importer is complete
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Model::~Model() = default;
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::Load
+
+      Summary:  Parses the model file with the importer of the model,
+                which owns the scene, and creates the textures of its
+                materials without reading them. Touches no Direct3D
+                object, so the loaders run it for many models in
+                parallel before Initialize. Does nothing once the file
+                is parsed
+
+      Modifies: [m_pScene, m_globalInverseTransform, m_aMaterials].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the file could not be parsed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::Load()
+    {
+        if (m_pScene)
+        {
+            return S_OK;
+        }
+
+        m_pScene = m_importer->ReadFile(
+            m_filePath.string().c_str(),
+            ASSIMP_LOAD_FLAGS
+        );
+
+        if (!m_pScene)
+        {
+            OutputDebugString(L"Error parsing ");
+            OutputDebugString(m_filePath.c_str());
+            OutputDebugString(L": ");
+            OutputDebugStringA(m_importer->GetErrorString());
+            OutputDebugString(L"\n");
+            return E_FAIL;
+        }
+
+        // Set matrix from world to model
+        m_globalInverseTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
+        m_globalInverseTransform = XMMatrixInverse(nullptr, m_globalInverseTransform);
+
+        loadTextures();
+
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Initialize
 
-      Summary:  Load and initialize the 3d model and create buffers
+      Summary:  Load the 3d model if Load was not called, initialize it
+                and create buffers
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
@@ -109,7 +180,7 @@ namespace library
                   The Direct3D context to set buffers
 
       Modifies: [m_pScene, m_globalInverseTransform, m_animationBuffer,
-                 m_skinningConstantBuffer].
+                 m_boneTransforms, m_boneTransformsView].
 
       Returns:  HRESULT
                   Status code
@@ -124,29 +195,14 @@ namespace library
 
         // Create the buffers for the vertices attributes
 
-        m_pScene = sm_pImporter->ReadFile(
-            m_filePath.string().c_str(),
-            ASSIMP_LOAD_FLAGS
-        );
+        hr = Load();
 
         if (m_pScene)
         {
-            // Set matrix from world to model
-            m_globalInverseTransform = ConvertMatrix(m_pScene->mRootNode->mTransformation);
-            m_globalInverseTransform = XMMatrixInverse(nullptr, m_globalInverseTransform);
             hr = initFromScene(pDevice, pImmediateContext, m_pScene, m_filePath);
             if (FAILED(hr))
                 return hr; 
         }
-        else
-        {
-            hr = E_FAIL;
-            OutputDebugString(L"Error parsing ");
-            OutputDebugString(m_filePath.c_str());
-            OutputDebugString(L": ");
-            OutputDebugStringA(sm_pImporter->GetErrorString());
-            OutputDebugString(L"\n");
-        }
 
         // Create the vertex buffer 
         D3D11_BUFFER_DESC bd =
@@ -166,16 +222,71 @@ namespace library
         if (FAILED(hr))
             return hr;
 
-        // Create the constant buffer
+        // Create the vertex buffer of the diffuse array slices
+        bd =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(UINT) * m_auDiffuseSlices.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0
+        };
+
+        initData =
+        {
+            .pSysMem = m_auDiffuseSlices.data()
+        };
+
+        hr = pDevice->CreateBuffer(&bd, &initData, m_diffuseSliceBuffer.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        // Create the index buffer of the draws over the diffuse arrays
         bd =
         {
-            .ByteWidth = sizeof(CBSkinning),
+            .ByteWidth = static_cast<UINT>(sizeof(WORD) * m_aMaterialDrawIndices.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_INDEX_BUFFER,
+            .CPUAccessFlags = 0
+        };
+
+        initData =
+        {
+            .pSysMem = m_aMaterialDrawIndices.data()
+        };
+
+        hr = pDevice->CreateBuffer(&bd, &initData, m_materialDrawIndexBuffer.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        // Create the buffer of the bones in use, as 3x4 affine matrices
+        if (m_aBoneInfo.empty())
+            return hr;
+
+        bd =
+        {
+            .ByteWidth = static_cast<UINT>(sizeof(XMFLOAT3X4) * m_aBoneInfo.size()),
             .Usage = D3D11_USAGE_DEFAULT,
-            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
             .CPUAccessFlags = 0,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = sizeof(XMFLOAT3X4),
+        };
+
+        hr = pDevice->CreateBuffer(&bd, nullptr, m_boneTransforms.GetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc =
+        {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = static_cast<UINT>(m_aBoneInfo.size()),
+            },
         };
 
-        hr = pDevice->CreateBuffer(&bd, nullptr, m_skinningConstantBuffer.GetAddressOf());
+        hr = pDevice->CreateShaderResourceView(m_boneTransforms.Get(), &srvDesc, m_boneTransformsView.GetAddressOf());
         if (FAILED(hr))
             return hr;
 
@@ -185,12 +296,17 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::Update
 
-      Summary:  Update bone transformations
+      Summary:  Update bone transformations. The pose is only computed
+                again when the animation time moved and the pose update
+                interval elapsed, so a paused or throttled animation
+                keeps its uploaded bones
 
       Args:     FLOAT deltaTime
                   Time difference of a frame
 
-      Modifies: [m_aTransforms].
+      Modifies: [m_timeSinceLoaded, m_timeSincePoseUpdate, m_poseTime,
+                 m_aTransforms, m_aPackedTransforms, m_bPoseChanged,
+                 m_uPoseUploadFrame].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Model::Update definition (remove the comment)
@@ -198,31 +314,246 @@ namespace library
 
     void Model::Update(_In_ FLOAT deltaTime)
     {
-        m_timeSinceLoaded += deltaTime;
+        m_timeSinceLoaded += deltaTime * m_animationSpeed;
+        m_timeSincePoseUpdate += deltaTime;
 
-        if (m_pScene->HasAnimations())
+        if (!m_pScene->HasAnimations() || !m_pScene->mRootNode)
         {
-            XMMATRIX identity = XMMatrixIdentity();
-            FLOAT ticksPerSecond = static_cast<FLOAT>(m_pScene->mAnimations[0]->mTicksPerSecond != 0.0 ? 
-                m_pScene->mAnimations[0]->mTicksPerSecond : 25.0f);
-            FLOAT timeInTicks = m_timeSinceLoaded * ticksPerSecond;
-            FLOAT animationTimeTicks = fmod(timeInTicks, static_cast<FLOAT>(m_pScene->mAnimations[0]->mDuration));
+            return;
+        }
 
-            if (m_pScene->mRootNode)
-            {
-                // Calculate the bone transform matrices
-                readNodeHierarchy(animationTimeTicks, m_pScene->mRootNode, identity);
+        const BOOL bFirstPose = m_aTransforms.empty();
+        if (!bFirstPose && (m_timeSincePoseUpdate < m_poseUpdateInterval || m_timeSinceLoaded == m_poseTime))
+        {
+            return;
+        }
 
-                // Resize 
-                m_aTransforms.resize(m_aBoneInfo.size());
+        m_timeSincePoseUpdate = 0.0f;
+        m_poseTime = m_timeSinceLoaded;
 
-                // Store each final tranformations in the bone infomation
-                for (UINT i = 0u; i < m_aBoneInfo.size(); ++i)
-                {
-                    m_aTransforms[i] = m_aBoneInfo[i].FinalTransformation;
-                }
+        m_aTransforms.resize(m_aBoneInfo.size());
+        ComputeBoneTransforms(m_timeSinceLoaded, m_aTransforms.data());
+
+        // Stored transposed as the shaders read them, without the last row which is always (0, 0, 0, 1)
+        m_aPackedTransforms.resize(m_aTransforms.size());
+        for (size_t i = 0u; i < m_aTransforms.size(); ++i)
+        {
+            XMStoreFloat3x4(&m_aPackedTransforms[i], m_aTransforms[i]);
+        }
+
+        m_bPoseChanged = TRUE;
+        m_uPoseUploadFrame = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::UploadBoneTransforms
+
+      Summary:  Uploads the packed bone transforms when the pose changed
+                since the render thread last acquired a snapshot
+                carrying them. The render thread drops the snapshots
+                it does not acquire, so the pose is uploaded into every
+                snapshot until one of them is acquired
+
+      Args:     RenderBackend& backend
+                  Backend receiving the upload
+                UINT64 uFrame
+                  Number of the snapshot being built
+                UINT64 uLastAcquiredFrame
+                  Number of the last snapshot the render thread acquired
+
+      Modifies: [m_bPoseChanged, m_uPoseUploadFrame].
+
+      Returns:  UINT
+                  Number of bytes uploaded, 0 if the pose did not change
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::UploadBoneTransforms(_In_ RenderBackend& backend, _In_ UINT64 uFrame, _In_ UINT64 uLastAcquiredFrame)
+    {
+        // Every snapshot from the first one carrying the pose carries it, so acquiring any of them is enough
+        if (m_bPoseChanged && m_uPoseUploadFrame != 0u && uLastAcquiredFrame >= m_uPoseUploadFrame)
+        {
+            m_bPoseChanged = FALSE;
+        }
+
+        if (!m_bPoseChanged || !m_boneTransforms)
+        {
+            return 0u;
+        }
+
+        const UINT uSize = static_cast<UINT>(sizeof(XMFLOAT3X4) * m_aPackedTransforms.size());
+        backend.UpdateBuffer(m_boneTransforms.Get(), m_aPackedTransforms.data(), uSize);
+        if (m_uPoseUploadFrame == 0u)
+        {
+            m_uPoseUploadFrame = uFrame;
+        }
+
+        return uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetAnimationSpeed
+
+      Summary:  Sets the playback speed of the animation, 0 pauses it
+
+      Args:     FLOAT speed
+                  Animation seconds per second
+
+      Modifies: [m_animationSpeed].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetAnimationSpeed(_In_ FLOAT speed)
+    {
+        m_animationSpeed = speed;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::SetPoseUpdateInterval
+
+      Summary:  Sets the minimum time between two poses, to animate
+                distant or unimportant models at a lower rate
+
+      Args:     FLOAT seconds
+                  Minimum time between two poses, 0 updates every frame
+
+      Modifies: [m_poseUpdateInterval].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::SetPoseUpdateInterval(_In_ FLOAT seconds)
+    {
+        m_poseUpdateInterval = seconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumMaterialDraws
+
+      Summary:  Returns the number of draws over the diffuse arrays
+
+      Returns:  UINT
+                  Number of draws
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumMaterialDraws() const
+    {
+        return static_cast<UINT>(m_aMaterialDraws.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetMaterialDraw
+
+      Summary:  Returns a draw over the diffuse arrays
+
+      Args:     UINT uIndex
+                  Index of the draw
+
+      Returns:  const MaterialDraw&
+                  The draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const Model::MaterialDraw& Model::GetMaterialDraw(_In_ UINT uIndex) const
+    {
+        assert(uIndex < m_aMaterialDraws.size());
+
+        return m_aMaterialDraws[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetMaterialDrawIndexBuffer
+
+      Summary:  Returns the 16 bit index buffer of the draws over the
+                diffuse arrays
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Index buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetMaterialDrawIndexBuffer()
+    {
+        return m_materialDrawIndexBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetDiffuseSliceBuffer
+
+      Summary:  Returns the vertex buffer holding the diffuse array
+                slice of each vertex
+
+      Returns:  ComPtr<ID3D11Buffer>&
+                  Vertex buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11Buffer>& Model::GetDiffuseSliceBuffer()
+    {
+        return m_diffuseSliceBuffer;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetDiffuseArray
+
+      Summary:  Returns a diffuse texture array
+
+      Args:     UINT uIndex
+                  Index of the array, as in MaterialDraw::uDiffuseArray
+
+      Returns:  TextureArray&
+                  The array
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureArray& Model::GetDiffuseArray(_In_ UINT uIndex)
+    {
+        assert(uIndex < m_aDiffuseArrays.size());
+
+        return *m_aDiffuseArrays[uIndex];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetTextures
+
+      Summary:  Returns the diffuse and specular textures of the
+                materials, created by Load. The loaders decode them in
+                parallel before Initialize creates their resources
+
+      Returns:  std::vector<std::shared_ptr<Texture>>
+                  Textures of the materials
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<std::shared_ptr<Texture>> Model::GetTextures() const
+    {
+        std::vector<std::shared_ptr<Texture>> aTextures;
+        aTextures.reserve(m_aMaterials.size() * 2ull);
+
+        for (const Material& material : m_aMaterials)
+        {
+            if (material.pDiffuse)
+            {
+                aTextures.push_back(material.pDiffuse);
             }
+            if (material.pSpecular)
+            {
+                aTextures.push_back(material.pSpecular);
+            }
+        }
+
+        return aTextures;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::ComputeBoneTransforms
+
+      Summary:  Computes the bone transforms of the first animation at
+                a given time. Only reads the model, so poses of several
+                instances can be computed by different threads
+
+      Args:     FLOAT timeSeconds
+                  Time in the animation, wrapped around its duration
+                XMMATRIX* pOutTransforms
+                  One transform per bone, identity without animation
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::ComputeBoneTransforms(_In_ FLOAT timeSeconds, _Out_writes_(GetNumBones()) XMMATRIX* pOutTransforms)
+    {
+        if (!m_pScene || !m_pScene->HasAnimations() || !m_pScene->mRootNode)
+        {
+            std::fill(pOutTransforms, pOutTransforms + m_aBoneInfo.size(), XMMatrixIdentity());
+            return;
         }
+
+        FLOAT ticksPerSecond = static_cast<FLOAT>(m_pScene->mAnimations[0]->mTicksPerSecond != 0.0 ?
+            m_pScene->mAnimations[0]->mTicksPerSecond : 25.0f);
+        FLOAT timeInTicks = timeSeconds * ticksPerSecond;
+        FLOAT animationTimeTicks = fmod(timeInTicks, static_cast<FLOAT>(m_pScene->mAnimations[0]->mDuration));
+
+        // Calculate the bone transform matrices
+        readNodeHierarchy(animationTimeTicks, m_pScene->mRootNode, XMMatrixIdentity(), pOutTransforms);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -239,16 +570,16 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::GetSkinningConstantBuffer
+      Method:   Model::GetBoneTransformsView
 
-      Summary:  Returns the skinning constant buffer
+      Summary:  Returns the view of the packed bone transforms
 
-      Returns:  ComPtr<ID3D11Buffer>&
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
 
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    ComPtr<ID3D11Buffer>& Model::GetSkinningConstantBuffer()
+    ComPtr<ID3D11ShaderResourceView>& Model::GetBoneTransformsView()
     {
-        return m_skinningConstantBuffer;
+        return m_boneTransformsView;
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -290,15 +621,41 @@ namespace library
         return m_aTransforms;
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetNumBones
+
+      Summary:  Returns the number of bones
+
+      Returns:  UINT
+                  Number of bones, the size of a bone palette
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT Model::GetNumBones() const
+    {
+        return static_cast<UINT>(m_aBoneInfo.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::GetAnimationData
+
+      Summary:  Returns the bone indices and weights of the vertices
+
+      Returns:  const TaggedVector<AnimationData, eMemoryTag::ANIMATION>&
+                  Animation data, one per vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const TaggedVector<AnimationData, eMemoryTag::ANIMATION>& Model::GetAnimationData() const
+    {
+        return m_aAnimationData;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
         Method:   Model::GetBoneNameToIndexMap
 
         Summary:  Returns the bone name to index map
 
-        Returns:  std::unordered_map<std::string, UINT>&
+        Returns:  BoneNameToIndexMap&
 
      M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    const std::unordered_map<std::string, UINT>& Model::GetBoneNameToIndexMap() const
+    const Model::BoneNameToIndexMap& Model::GetBoneNameToIndexMap() const
     {
         return m_boneNameToIndexMap;
     }
@@ -528,6 +885,156 @@ namespace library
         }
     }
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initDiffuseArrays
+
+      Summary:  Groups the loaded diffuse textures of the materials by
+                size and format, copies each group into a texture array
+                and stores the slice of every vertex
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the arrays
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the textures
+
+      Modifies: [m_aDiffuseArrays, m_auMaterialDiffuseArrays,
+                 m_auMaterialDiffuseSlices, m_auDiffuseSlices].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Model::initDiffuseArrays(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        std::vector<std::vector<std::shared_ptr<Texture>>> aaGroups;
+        std::vector<D3D11_TEXTURE2D_DESC> aGroupDescs;
+
+        m_auMaterialDiffuseArrays.assign(m_aMaterials.size(), NO_DIFFUSE_ARRAY);
+        m_auMaterialDiffuseSlices.assign(m_aMaterials.size(), 0u);
+
+        for (UINT i = 0u; i < m_aMaterials.size(); ++i)
+        {
+            const std::shared_ptr<Texture>& diffuse = m_aMaterials[i].pDiffuse;
+            if (!diffuse || !diffuse->GetTextureResourceView())
+            {
+                continue;
+            }
+
+            const D3D11_TEXTURE2D_DESC desc = diffuse->GetTextureDesc();
+
+            UINT uGroup = 0u;
+            while (uGroup < aaGroups.size() &&
+                (!TextureArray::AreCompatible(desc, aGroupDescs[uGroup]) || aaGroups[uGroup].size() >= TextureArray::MAX_NUM_SLICES))
+            {
+                ++uGroup;
+            }
+
+            if (uGroup == aaGroups.size())
+            {
+                aaGroups.emplace_back();
+                aGroupDescs.push_back(desc);
+            }
+
+            // Materials sharing a texture file share its slice
+            std::vector<std::shared_ptr<Texture>>& aGroup = aaGroups[uGroup];
+            UINT uSlice = 0u;
+            while (uSlice < aGroup.size() && aGroup[uSlice]->GetFilePath() != diffuse->GetFilePath())
+            {
+                ++uSlice;
+            }
+
+            if (uSlice == aGroup.size())
+            {
+                aGroup.push_back(diffuse);
+            }
+
+            m_auMaterialDiffuseArrays[i] = uGroup;
+            m_auMaterialDiffuseSlices[i] = uSlice;
+        }
+
+        m_aDiffuseArrays.clear();
+        for (const std::vector<std::shared_ptr<Texture>>& aGroup : aaGroups)
+        {
+            std::unique_ptr<TextureArray> diffuseArray = std::make_unique<TextureArray>();
+
+            hr = diffuseArray->Initialize(pDevice, pImmediateContext, aGroup);
+            if (FAILED(hr))
+                return hr;
+
+            m_aDiffuseArrays.push_back(std::move(diffuseArray));
+        }
+
+        // Every vertex samples the slice of the material of its mesh
+        m_auDiffuseSlices.assign(m_aVertices.size(), 0u);
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            if (mesh.uMaterialIndex >= m_aMaterials.size())
+            {
+                continue;
+            }
+
+            const UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : static_cast<UINT>(m_aVertices.size());
+            std::fill(
+                m_auDiffuseSlices.begin() + mesh.uBaseVertex,
+                m_auDiffuseSlices.begin() + uEndVertex,
+                m_auMaterialDiffuseSlices[mesh.uMaterialIndex]
+            );
+        }
+
+        return hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Model::initMaterialDraws
+
+      Summary:  Merges the consecutive meshes using the same diffuse
+                array into one draw, as long as the vertices they span
+                are addressable with 16 bit indices, and builds the
+                indices of the draws relative to their first vertex
+
+      Modifies: [m_aMaterialDraws, m_aMaterialDrawIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Model::initMaterialDraws()
+    {
+        m_aMaterialDraws.clear();
+        m_aMaterialDrawIndices.clear();
+        m_aMaterialDrawIndices.reserve(m_aIndices.size());
+
+        for (UINT i = 0u; i < m_aMeshes.size(); ++i)
+        {
+            const BasicMeshEntry& mesh = m_aMeshes[i];
+            const UINT uDiffuseArray = mesh.uMaterialIndex < m_aMaterials.size() ?
+                m_auMaterialDiffuseArrays[mesh.uMaterialIndex] : NO_DIFFUSE_ARRAY;
+            const UINT uEndVertex = i + 1u < m_aMeshes.size() ? m_aMeshes[i + 1u].uBaseVertex : static_cast<UINT>(m_aVertices.size());
+
+            if (m_aMaterialDraws.empty() ||
+                m_aMaterialDraws.back().uDiffuseArray != uDiffuseArray ||
+                uEndVertex - m_aMaterialDraws.back().uBaseVertex > 0x10000u)
+            {
+                m_aMaterialDraws.push_back(
+                    MaterialDraw
+                    {
+                        .uNumIndices = 0u,
+                        .uBaseIndex = static_cast<UINT>(m_aMaterialDrawIndices.size()),
+                        .uBaseVertex = mesh.uBaseVertex,
+                        .uDiffuseArray = uDiffuseArray,
+                    }
+                );
+            }
+
+            MaterialDraw& draw = m_aMaterialDraws.back();
+            const UINT uOffset = mesh.uBaseVertex - draw.uBaseVertex;
+            for (UINT j = mesh.uBaseIndex; j < mesh.uBaseIndex + mesh.uNumIndices; ++j)
+            {
+                m_aMaterialDrawIndices.push_back(static_cast<WORD>(m_aIndices[j] + uOffset));
+            }
+
+            draw.uNumIndices += mesh.uNumIndices;
+        }
+    }
+
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initFromScene
@@ -567,10 +1074,17 @@ namespace library
         initAllMeshes(pScene);
 
         // Initializing materials
-        hr = initMaterials(pDevice, pImmediateContext, pScene, filePath);
+        hr = initMaterials(pDevice, pImmediateContext);
         if (FAILED(hr))
             return hr;
 
+        // Pack the diffuse textures into arrays and merge the meshes sharing one
+        hr = initDiffuseArrays(pDevice, pImmediateContext);
+        if (FAILED(hr))
+            return hr;
+
+        initMaterialDraws();
+
         // Create AnimationData for the vertex and add it to m_aAnimationData
          AnimationData animationData;
          for (UINT i = 0u; i < m_aBoneData.size(); ++i)
@@ -584,6 +1098,13 @@ namespace library
         if (FAILED(hr))
             return hr;
 
+        // Bind pose bounds do not cover animated limbs, grow them by half their size on every side
+        const XMVECTOR boundsMin = XMLoadFloat3(&m_localBounds.Min);
+        const XMVECTOR boundsMax = XMLoadFloat3(&m_localBounds.Max);
+        const XMVECTOR margin = XMVectorScale(XMVectorSubtract(boundsMax, boundsMin), 0.5f);
+        XMStoreFloat3(&m_localBounds.Min, XMVectorSubtract(boundsMin, margin));
+        XMStoreFloat3(&m_localBounds.Max, XMVectorAdd(boundsMax, margin));
+
         return S_OK;
     }
 
@@ -591,41 +1112,38 @@ namespace library
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::initMaterials
 
-      Summary:  Initialize all materials in a given assimp scene
+      Summary:  Initialize the textures of all materials, decoding the
+                ones the loaders did not. A texture failing to load
+                is left out of the diffuse arrays, the model is still
+                drawn
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
-                const aiScene* pScene
-                  Assimp scene
-                const std::filesystem::path& filePath
-                  Path to the model
 
       Returns:  HRESULT
                   Status code
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::initMaterials(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const aiScene* pScene,
-        _In_ const std::filesystem::path& filePath
-    )
+    HRESULT Model::initMaterials(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
-        HRESULT hr = S_OK;
-
-        // Extract the directory part from the file name
-        std::filesystem::path parentDirectory = filePath.parent_path();
-
-        // Initialize the materials
-        for (UINT i = 0u; i < pScene->mNumMaterials; ++i)
+        for (const Material& material : m_aMaterials)
         {
-            const aiMaterial* pMaterial = pScene->mMaterials[i];
+            for (const std::shared_ptr<Texture>& texture : { material.pDiffuse, material.pSpecular })
+            {
+                if (!texture)
+                {
+                    continue;
+                }
 
-            loadTextures(pDevice, pImmediateContext, parentDirectory, pMaterial, i);
+                const HRESULT hr = texture->Initialize(pDevice, pImmediateContext);
+                OutputDebugString(SUCCEEDED(hr) ? L"Loaded texture \"" : L"Error loading texture \"");
+                OutputDebugString(texture->GetFilePath().c_str());
+                OutputDebugString(L"\"\n");
+            }
         }
 
-        return hr;
+        return S_OK;
     }
 
 
@@ -841,169 +1359,71 @@ namespace library
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-      Method:   Model::loadDiffuseTexture
+      Method:   Model::loadTexture
 
-      Summary:  Load a diffuse texture from given path
+      Summary:  Creates the texture of a material from the path given
+                by the model file, without reading it yet
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
+      Args:     const std::filesystem::path& parentDirectory
                   Parent path to the model
                 const aiMaterial* pMaterial
                   Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+                UINT uTextureType
+                  aiTextureType of the texture, diffuse or specular
+
+      Returns:  std::shared_ptr<Texture>
+                  Texture of the material, nullptr if it has none
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadDiffuseTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
+    std::shared_ptr<Texture> Model::loadTexture(
         _In_ const std::filesystem::path& parentDirectory,
         _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
+        _In_ UINT uTextureType
     )
     {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pDiffuse = nullptr;
+        const aiTextureType textureType = static_cast<aiTextureType>(uTextureType);
 
-        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        if (pMaterial->GetTextureCount(textureType) == 0)
         {
-            aiString aiPath;
-
-            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
-
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
-
-                std::filesystem::path fullPath = parentDirectory / szPath;
-
-                m_aMaterials[uIndex].pDiffuse = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex].pDiffuse->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading diffuse texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
-
-                    return hr;
-                }
-
-                OutputDebugString(L"Loaded diffuse texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
-            }
+            return nullptr;
         }
 
-        return hr;
-    }
-
-
-    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-       Method:   Model::loadSpecularTexture
-
-       Summary:  Load a specular texture from given path
-
-       Args:     ID3D11Device* pDevice
-                   The Direct3D device to create the buffers
-                 ID3D11DeviceContext* pImmediateContext
-                   The Direct3D context to set buffers
-                 const std::filesystem::path& parentDirectory
-                   Parent path to the model
-                 const aiMaterial* pMaterial
-                   Pointer to an assimp material object
-                 UINT uIndex
-                   Index to a material
-     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadSpecularTexture(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
-    {
-        HRESULT hr = S_OK;
-        m_aMaterials[uIndex].pSpecular = nullptr;
-
-        if (pMaterial->GetTextureCount(aiTextureType_SHININESS) > 0)
+        aiString aiPath;
+        if (pMaterial->GetTexture(textureType, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) != AI_SUCCESS)
         {
-            aiString aiPath;
-
-            if (pMaterial->GetTexture(aiTextureType_SHININESS, 0u, &aiPath, nullptr, nullptr, nullptr, nullptr, nullptr) == AI_SUCCESS)
-            {
-                std::string szPath(aiPath.data);
-
-                if (szPath.substr(0ull, 2ull) == ".\\")
-                {
-                    szPath = szPath.substr(2ull, szPath.size() - 2ull);
-                }
-
-                std::filesystem::path fullPath = parentDirectory / szPath;
-
-                m_aMaterials[uIndex].pSpecular = std::make_shared<Texture>(fullPath);
-
-                hr = m_aMaterials[uIndex].pSpecular->Initialize(pDevice, pImmediateContext);
-                if (FAILED(hr))
-                {
-                    OutputDebugString(L"Error loading specular texture \"");
-                    OutputDebugString(fullPath.c_str());
-                    OutputDebugString(L"\"\n");
+            return nullptr;
+        }
 
-                    return hr;
-                }
+        std::string szPath(aiPath.data);
 
-                OutputDebugString(L"Loaded specular texture \"");
-                OutputDebugString(fullPath.c_str());
-                OutputDebugString(L"\"\n");
-            }
+        if (szPath.substr(0ull, 2ull) == ".\\")
+        {
+            szPath = szPath.substr(2ull, szPath.size() - 2ull);
         }
 
-        return hr;
+        return std::make_shared<Texture>(parentDirectory / szPath);
     }
 
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Model::loadTextures
 
-      Summary:  Load a specular texture from given path
+      Summary:  Creates the diffuse and specular textures of every
+                material of the parsed scene. Their files are read and
+                decoded by Texture::Decode, or by Initialize
 
-      Args:     ID3D11Device* pDevice
-                  The Direct3D device to create the buffers
-                ID3D11DeviceContext* pImmediateContext
-                  The Direct3D context to set buffers
-                const std::filesystem::path& parentDirectory
-                  Parent path to the model
-                const aiMaterial* pMaterial
-                  Pointer to an assimp material object
-                UINT uIndex
-                  Index to a material
+      Modifies: [m_aMaterials].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    HRESULT Model::loadTextures(
-        _In_ ID3D11Device* pDevice,
-        _In_ ID3D11DeviceContext* pImmediateContext,
-        _In_ const std::filesystem::path& parentDirectory,
-        _In_ const aiMaterial* pMaterial,
-        _In_ UINT uIndex
-    )
+    void Model::loadTextures()
     {
-        HRESULT hr = loadDiffuseTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
-        {
-            return hr;
-        }
+        const std::filesystem::path parentDirectory = m_filePath.parent_path();
 
-        hr = loadSpecularTexture(pDevice, pImmediateContext, parentDirectory, pMaterial, uIndex);
-        if (FAILED(hr))
+        m_aMaterials.resize(m_pScene->mNumMaterials);
+        for (UINT i = 0u; i < m_pScene->mNumMaterials; ++i)
         {
-            return hr;
-        }
+            const aiMaterial* pMaterial = m_pScene->mMaterials[i];
 
-        return hr;
+            m_aMaterials[i].pDiffuse = loadTexture(parentDirectory, pMaterial, aiTextureType_DIFFUSE);
+            m_aMaterials[i].pSpecular = loadTexture(parentDirectory, pMaterial, aiTextureType_SHININESS);
+        }
     }
 
 
@@ -1018,12 +1438,19 @@ namespace library
                   Pointer to an assimp node object
                 const XMMATRIX& parentTransform
                   Parent transform in hierarchy
+                XMMATRIX* pOutTransforms
+                  Final transform of every bone
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Model::readNodeHierarchy definition (remove the comment)
     --------------------------------------------------------------------*/
 
-    void Model::readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform)
+    void Model::readNodeHierarchy(
+        _In_ FLOAT animationTimeTicks,
+        _In_ const aiNode* pNode,
+        _In_ const XMMATRIX& parentTransform,
+        _Out_writes_(m_aBoneInfo.size()) XMMATRIX* pOutTransforms
+    )
     {
         const aiNodeAnim* pNodeAnim = findNodeAnimOrNull(m_pScene->mAnimations[0], pNode->mName.C_Str());
        
@@ -1052,16 +1479,18 @@ namespace library
 
         XMMATRIX globalTransform = nodeTransform * parentTransform;
 
-        if (m_boneNameToIndexMap.contains(pNode->mName.C_Str()))
+        // Looked up by view, the node name is not copied into a std::string every frame
+        const auto bone = m_boneNameToIndexMap.find(std::string_view(pNode->mName.C_Str(), pNode->mName.length));
+        if (bone != m_boneNameToIndexMap.end())
         {
             // Get the bone index 
-            UINT boneIndex = m_boneNameToIndexMap[pNode->mName.C_Str()];
-            m_aBoneInfo[boneIndex].FinalTransformation = m_aBoneInfo[boneIndex].OffsetMatrix * globalTransform * m_globalInverseTransform;
+            UINT boneIndex = bone->second;
+            pOutTransforms[boneIndex] = m_aBoneInfo[boneIndex].OffsetMatrix * globalTransform * m_globalInverseTransform;
         }
 
         for (UINT i = 0; i < pNode->mNumChildren; ++i)
         {
-            readNodeHierarchy(animationTimeTicks, pNode->mChildren[i], globalTransform);
+            readNodeHierarchy(animationTimeTicks, pNode->mChildren[i], globalTransform, pOutTransforms);
         }
     }
 
@@ -13,11 +13,14 @@
 
 #include "Common.h"
 
+#include "Memory/MemoryTracker.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/RenderBackend.h"
 #include "Renderer/Renderable.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
 #include "Texture/Material.h"
+#include "Texture/TextureArray.h"
 
 struct aiScene;
 struct aiMesh;
@@ -41,7 +44,9 @@ namespace library
 
       Summary:  Model class is a renderable from model files
 
-      Methods:  Initialize
+      Methods:  Load
+                  Parses the model file, may run on any thread
+                Initialize
                   Pure virtual function that initializes the object
                 Update
                   Pure virtual function that updates the object each
@@ -60,6 +65,33 @@ namespace library
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                GetAnimationData
+                  Returns the bone indices and weights of the vertices
+                GetNumBones
+                  Returns the number of bones
+                ComputeBoneTransforms
+                  Computes the bone transforms at a given time
+                UploadBoneTransforms
+                  Uploads the packed bone transforms if the pose changed
+                GetBoneTransformsView
+                  Returns the view of the packed bone transforms
+                SetAnimationSpeed
+                  Sets the playback speed of the animation
+                SetPoseUpdateInterval
+                  Sets the minimum time between two poses
+                GetNumMaterialDraws
+                  Returns the number of draws over the diffuse arrays
+                GetMaterialDraw
+                  Returns a draw over the diffuse arrays
+                GetMaterialDrawIndexBuffer
+                  Returns the index buffer of the draws over the
+                  diffuse arrays
+                GetDiffuseSliceBuffer
+                  Returns the diffuse array slice of the vertices
+                GetDiffuseArray
+                  Returns a diffuse texture array
+                GetTextures
+                  Returns the textures of the materials
                 Model
                   Constructor.
                 ~Model
@@ -67,6 +99,55 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Model : public Renderable
     {
+    public:
+        static constexpr UINT BONE_TRANSFORMS_SLOT = 4u;
+        static constexpr UINT NO_DIFFUSE_ARRAY = 0xFFFFFFFFu;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   BoneNameHash
+
+          Summary:  Transparent hash of the bone names, so the map of
+                    the bones is searched with the C string of a node
+                    without building a std::string
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct BoneNameHash
+        {
+            typedef void is_transparent;
+
+            size_t operator()(_In_ std::string_view szName) const
+            {
+                return std::hash<std::string_view>()(szName);
+            }
+        };
+
+        typedef std::unordered_map<std::string, UINT, BoneNameHash, std::equal_to<>> BoneNameToIndexMap;
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   MaterialDraw
+
+          Summary:  Consecutive meshes whose diffuse textures are slices
+                    of the same array, drawn at once. Its indices are
+                    relative to uBaseVertex and the vertices it spans
+                    fit in 16 bit indices
+
+          Members:  UINT uNumIndices
+                      Number of indices of the meshes
+                    UINT uBaseIndex
+                      First index in the index buffer of the draws
+                    UINT uBaseVertex
+                      Vertex of the first mesh
+                    UINT uDiffuseArray
+                      Index of the diffuse array, NO_DIFFUSE_ARRAY if
+                      the meshes have no diffuse texture
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct MaterialDraw
+        {
+            UINT uNumIndices;
+            UINT uBaseIndex;
+            UINT uBaseVertex;
+            UINT uDiffuseArray;
+        };
+
     public:
         Model() = delete;
         Model(_In_ const std::filesystem::path& filePath);
@@ -74,19 +155,35 @@ namespace library
         Model(Model&& other) = delete;
         Model& operator=(const Model& other) = delete;
         Model& operator=(Model&& other) = delete;
-        virtual ~Model() = default;
+        virtual ~Model();
 
+        HRESULT Load();
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         virtual void Update(_In_ FLOAT deltaTime) override;
 
         ComPtr<ID3D11Buffer>& GetAnimationBuffer();
-        ComPtr<ID3D11Buffer>& GetSkinningConstantBuffer();
+        ComPtr<ID3D11ShaderResourceView>& GetBoneTransformsView();
 
         virtual UINT GetNumVertices() const override;
         virtual UINT GetNumIndices() const override;
 
         std::vector<XMMATRIX>& GetBoneTransforms();
-        const std::unordered_map<std::string, UINT>& GetBoneNameToIndexMap() const;
+        const TaggedVector<AnimationData, eMemoryTag::ANIMATION>& GetAnimationData() const;
+        const BoneNameToIndexMap& GetBoneNameToIndexMap() const;
+        UINT GetNumBones() const;
+
+        void ComputeBoneTransforms(_In_ FLOAT timeSeconds, _Out_writes_(GetNumBones()) XMMATRIX* pOutTransforms);
+        UINT UploadBoneTransforms(_In_ RenderBackend& backend, _In_ UINT64 uFrame, _In_ UINT64 uLastAcquiredFrame);
+
+        void SetAnimationSpeed(_In_ FLOAT speed);
+        void SetPoseUpdateInterval(_In_ FLOAT seconds);
+
+        UINT GetNumMaterialDraws() const;
+        const MaterialDraw& GetMaterialDraw(_In_ UINT uIndex) const;
+        ComPtr<ID3D11Buffer>& GetMaterialDrawIndexBuffer();
+        ComPtr<ID3D11Buffer>& GetDiffuseSliceBuffer();
+        TextureArray& GetDiffuseArray(_In_ UINT uIndex);
+        std::vector<std::shared_ptr<Texture>> GetTextures() const;
 
     protected:
         struct VertexBoneData
@@ -124,12 +221,10 @@ namespace library
             BoneInfo() = default;
             BoneInfo(const XMMATRIX& Offset)
                 : OffsetMatrix(Offset)
-                , FinalTransformation()
             {
             }
 
             XMMATRIX OffsetMatrix;
-            XMMATRIX FinalTransformation;
         };
 
         void countVerticesAndIndices(_Inout_ UINT& uOutNumVertices, _Inout_ UINT& uOutNumIndices, _In_ const aiScene* pScene);
@@ -141,68 +236,69 @@ namespace library
         const virtual SimpleVertex* getVertices() const override;
         virtual const WORD* getIndices() const override;
         void initAllMeshes(_In_ const aiScene* pScene);
+        HRESULT initDiffuseArrays(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
         HRESULT initFromScene(
             _In_ ID3D11Device* pDevice,
             _In_ ID3D11DeviceContext* pImmediateContext,
             _In_ const aiScene* pScene,
             _In_ const std::filesystem::path& filePath
         );
-        HRESULT initMaterials(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const aiScene* pScene,
-            _In_ const std::filesystem::path& filePath
-        );
+        HRESULT initMaterials(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void initMaterialDraws();
         void initMeshBones(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
         void initMeshSingleBone(_In_ UINT uMeshIndex, _In_ const aiBone* pBone);
         void initSingleMesh(_In_ UINT uMeshIndex, _In_ const aiMesh* pMesh);
         void interpolatePosition(_Inout_ XMFLOAT3& outTranslate, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateRotation(_Inout_ XMVECTOR& outQuaternion, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
         void interpolateScaling(_Inout_ XMFLOAT3& outScale, _In_ FLOAT animationTimeTicks, _In_ const aiNodeAnim* pNodeAnim);
-        HRESULT loadDiffuseTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
+        std::shared_ptr<Texture> loadTexture(
             _In_ const std::filesystem::path& parentDirectory,
             _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
+            _In_ UINT uTextureType
         );
-        HRESULT loadSpecularTexture(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
+        void loadTextures();
+        void readNodeHierarchy(
+            _In_ FLOAT animationTimeTicks,
+            _In_ const aiNode* pNode,
+            _In_ const XMMATRIX& parentTransform,
+            _Out_writes_(m_aBoneInfo.size()) XMMATRIX* pOutTransforms
         );
-        HRESULT loadTextures(
-            _In_ ID3D11Device* pDevice,
-            _In_ ID3D11DeviceContext* pImmediateContext,
-            _In_ const std::filesystem::path& parentDirectory,
-            _In_ const aiMaterial* pMaterial,
-            _In_ UINT uIndex
-        );
-        void readNodeHierarchy(_In_ FLOAT animationTimeTicks, _In_ const aiNode* pNode, _In_ const XMMATRIX& parentTransform);
         void reserveSpace(_In_ UINT uNumVertices, _In_ UINT uNumIndices);
 
-    protected:
-        static std::unique_ptr<Assimp::Importer> sm_pImporter;
-
     protected:
         std::filesystem::path m_filePath;
+        std::unique_ptr<Assimp::Importer> m_importer;
 
         ComPtr<ID3D11Buffer> m_animationBuffer;
-        ComPtr<ID3D11Buffer> m_skinningConstantBuffer;
-
-        std::vector<SimpleVertex> m_aVertices;
-        std::vector<AnimationData> m_aAnimationData;
-        std::vector<WORD> m_aIndices;
-        std::vector<VertexBoneData> m_aBoneData;
+        ComPtr<ID3D11Buffer> m_boneTransforms;
+        ComPtr<ID3D11ShaderResourceView> m_boneTransformsView;
+        ComPtr<ID3D11Buffer> m_diffuseSliceBuffer;
+        ComPtr<ID3D11Buffer> m_materialDrawIndexBuffer;
+
+        TaggedVector<SimpleVertex, eMemoryTag::MODEL> m_aVertices;
+        TaggedVector<AnimationData, eMemoryTag::ANIMATION> m_aAnimationData;
+        TaggedVector<WORD, eMemoryTag::MODEL> m_aIndices;
+        TaggedVector<VertexBoneData, eMemoryTag::ANIMATION> m_aBoneData;
         std::vector<BoneInfo> m_aBoneInfo;
         std::vector<XMMATRIX> m_aTransforms;
-        std::unordered_map<std::string, UINT> m_boneNameToIndexMap;
+        TaggedVector<XMFLOAT3X4, eMemoryTag::ANIMATION> m_aPackedTransforms;
+        BoneNameToIndexMap m_boneNameToIndexMap;
+        std::vector<std::unique_ptr<TextureArray>> m_aDiffuseArrays;
+        std::vector<UINT> m_auMaterialDiffuseArrays;
+        std::vector<UINT> m_auMaterialDiffuseSlices;
+        std::vector<UINT> m_auDiffuseSlices;
+        std::vector<MaterialDraw> m_aMaterialDraws;
+        TaggedVector<WORD, eMemoryTag::MODEL> m_aMaterialDrawIndices;
 
         const aiScene* m_pScene;
 
         float m_timeSinceLoaded;
+        FLOAT m_animationSpeed;
+        FLOAT m_poseUpdateInterval;
+        FLOAT m_timeSincePoseUpdate;
+        FLOAT m_poseTime;
+        BOOL m_bPoseChanged;
+        UINT64 m_uPoseUploadFrame;
 
         XMMATRIX m_globalInverseTransform;
 
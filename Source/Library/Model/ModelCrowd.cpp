@@ -0,0 +1,270 @@
+#include "Model/ModelCrowd.h"
+
+#include <algorithm>
+#include <execution>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::ModelCrowd
+
+      Summary:  Constructor
+
+      Args:     const std::shared_ptr<Model>& model
+                  Model drawn by every instance. It is initialized by the
+                  crowd and should not be added to the renderer as well
+
+      Modifies: [m_model, m_pipelineState, m_bonePalettes,
+                 m_bonePalettesView, m_instances, m_instancesView,
+                 m_aInstances, m_aBonePalettes, m_aPackedBonePalettes,
+                 m_aInstanceData, m_uNumBones].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ModelCrowd::ModelCrowd(_In_ const std::shared_ptr<Model>& model)
+        : m_model(model)
+        , m_pipelineState()
+        , m_bonePalettes()
+        , m_bonePalettesView()
+        , m_instances()
+        , m_instancesView()
+        , m_aInstances()
+        , m_aBonePalettes()
+        , m_aPackedBonePalettes()
+        , m_aInstanceData()
+        , m_uNumBones(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::AddInstance
+
+      Summary:  Adds an instance. The buffers are sized for the
+                instances when the crowd is initialized
+
+      Args:     const XMMATRIX& world
+                  World transform applied after the one of the model
+                FLOAT timeOffset
+                  Initial animation time in seconds
+                FLOAT speed
+                  Playback speed of the animation
+
+      Modifies: [m_aInstances].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL once the crowd is initialized
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ModelCrowd::AddInstance(_In_ const XMMATRIX& world, _In_ FLOAT timeOffset, _In_ FLOAT speed)
+    {
+        if (m_instances)
+        {
+            return E_FAIL;
+        }
+
+        m_aInstances.push_back(Instance{ .World = world, .time = timeOffset, .speed = speed });
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::Initialize
+
+      Summary:  Initializes the model, then creates the bone palette
+                buffer and the instance buffer with their views
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to initialize the model
+
+      Modifies: [m_model, m_bonePalettes, m_bonePalettesView,
+                 m_instances, m_instancesView, m_aBonePalettes,
+                 m_aPackedBonePalettes, m_aInstanceData, m_uNumBones].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ModelCrowd::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
+    {
+        HRESULT hr = S_OK;
+
+        if (m_aInstances.empty())
+        {
+            return E_FAIL;
+        }
+
+        hr = m_model->Initialize(pDevice, pImmediateContext);
+        if (FAILED(hr)) return hr;
+
+        m_uNumBones = std::max(m_model->GetNumBones(), 1u);
+        const UINT uNumInstances = static_cast<UINT>(m_aInstances.size());
+        const UINT uNumPaletteBones = uNumInstances * m_uNumBones;
+
+        m_aBonePalettes.assign(uNumPaletteBones, XMMatrixIdentity());
+        m_aPackedBonePalettes.resize(uNumPaletteBones);
+        for (UINT i = 0u; i < uNumPaletteBones; ++i)
+        {
+            XMStoreFloat3x4(&m_aPackedBonePalettes[i], m_aBonePalettes[i]);
+        }
+        m_aInstanceData.resize(uNumInstances);
+        for (UINT i = 0u; i < uNumInstances; ++i)
+        {
+            m_aInstanceData[i].uBoneOffset = i * m_uNumBones;
+        }
+
+        D3D11_BUFFER_DESC bonePalettesDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(XMFLOAT3X4) * uNumPaletteBones),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = sizeof(XMFLOAT3X4),
+        };
+        hr = pDevice->CreateBuffer(&bonePalettesDesc, nullptr, m_bonePalettes.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC bonePalettesViewDesc = {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = uNumPaletteBones,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_bonePalettes.Get(), &bonePalettesViewDesc, m_bonePalettesView.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_BUFFER_DESC instancesDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(CrowdInstanceData) * uNumInstances),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = sizeof(CrowdInstanceData),
+        };
+        hr = pDevice->CreateBuffer(&instancesDesc, nullptr, m_instances.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC instancesViewDesc = {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = uNumInstances,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_instances.Get(), &instancesViewDesc, m_instancesView.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::Update
+
+      Summary:  Advances the animation time of every instance and
+                computes its bone palette and world transform, one
+                instance per task
+
+      Args:     FLOAT deltaTime
+                  Time difference of a frame
+
+      Modifies: [m_aInstances, m_aBonePalettes, m_aPackedBonePalettes,
+                 m_aInstanceData].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ModelCrowd::Update(_In_ FLOAT deltaTime)
+    {
+        const XMMATRIX modelWorld = m_model->GetWorldMatrix();
+        const BOOL bHasBones = m_model->GetNumBones() > 0u;
+
+        std::for_each(
+            std::execution::par,
+            m_aInstances.begin(),
+            m_aInstances.end(),
+            [&](Instance& instance)
+            {
+                const size_t uIndex = static_cast<size_t>(&instance - m_aInstances.data());
+
+                instance.time += deltaTime * instance.speed;
+                if (bHasBones)
+                {
+                    const size_t uBoneOffset = uIndex * m_uNumBones;
+                    m_model->ComputeBoneTransforms(instance.time, &m_aBonePalettes[uBoneOffset]);
+                    for (size_t i = uBoneOffset; i < uBoneOffset + m_uNumBones; ++i)
+                    {
+                        XMStoreFloat3x4(&m_aPackedBonePalettes[i], m_aBonePalettes[i]);
+                    }
+                }
+
+                m_aInstanceData[uIndex].World = XMMatrixTranspose(modelWorld * instance.World);
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::Upload
+
+      Summary:  Uploads the bone palettes and the instances
+
+      Args:     RenderBackend& backend
+                  Backend receiving the uploads
+
+      Returns:  UINT
+                  Number of bytes uploaded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ModelCrowd::Upload(_In_ RenderBackend& backend) const
+    {
+        const UINT uPalettesSize = static_cast<UINT>(sizeof(XMFLOAT3X4) * m_aPackedBonePalettes.size());
+        const UINT uInstancesSize = static_cast<UINT>(sizeof(CrowdInstanceData) * m_aInstanceData.size());
+
+        backend.UpdateBuffer(m_bonePalettes.Get(), m_aPackedBonePalettes.data(), uPalettesSize);
+        backend.UpdateBuffer(m_instances.Get(), m_aInstanceData.data(), uInstancesSize);
+
+        return uPalettesSize + uInstancesSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::Bind
+
+      Summary:  Binds the bone palettes and the instances to the vertex
+                shader
+
+      Args:     RenderBackend& backend
+                  Backend or command buffer receiving the bindings
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ModelCrowd::Bind(_In_ RenderBackend& backend) const
+    {
+        backend.SetVertexShaderResource(BONE_PALETTES_SLOT, m_bonePalettesView.Get());
+        backend.SetVertexShaderResource(INSTANCES_SLOT, m_instancesView.Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ModelCrowd::SetPipelineState
+
+      Summary:  Sets the pipeline state of the crowd, whose vertex
+                shader reads the instances by their id. The instances
+                have no object constant buffer
+
+      Args:     const std::shared_ptr<PipelineState>& pipelineState
+                  Pipeline state with the input layout of the model
+
+      Modifies: [m_pipelineState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ModelCrowd::SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState)
+    {
+        m_pipelineState = pipelineState;
+    }
+
+    Model& ModelCrowd::GetModel()
+    {
+        return *m_model;
+    }
+
+    const std::shared_ptr<PipelineState>& ModelCrowd::GetPipelineState() const
+    {
+        return m_pipelineState;
+    }
+
+    UINT ModelCrowd::GetNumInstances() const
+    {
+        return static_cast<UINT>(m_aInstances.size());
+    }
+}
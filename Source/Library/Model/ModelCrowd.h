@@ -0,0 +1,110 @@
+/*+===================================================================
+  File:      MODELCROWD.H
+
+  Summary:   ModelCrowd header file contains declarations of the crowd
+             of instances of one skinned model, each with its own world
+             transform and animation time, drawn with one instanced
+             draw per diffuse array draw of the model.
+
+  Classes: ModelCrowd
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Memory/MemoryTracker.h"
+#include "Model/Model.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ModelCrowd
+
+      Summary:  Instances of one skinned model. Every frame, the pose of
+                each instance is computed on a worker thread into its
+                range of one bone palette buffer of 3x4 matrices. The
+                instances read their world transform and the offset of
+                their palette from a structured buffer indexed by the
+                instance id, so the vertex buffers and the input layout
+                of the model are shared and each of its draws is issued once for
+                the whole crowd
+
+      Methods:  AddInstance
+                  Adds an instance before the crowd is initialized
+                Initialize
+                  Initializes the model and creates the buffers
+                Update
+                  Advances the animations and computes the palettes
+                Upload
+                  Uploads the palettes and the instances
+                Bind
+                  Binds the palettes and the instances to the vertex
+                  shader
+                SetPipelineState
+                  Sets the pipeline state drawing the crowd
+                GetModel
+                  Returns the instanced model
+                GetPipelineState
+                  Returns the pipeline state drawing the crowd
+                GetNumInstances
+                  Returns the number of instances
+                ModelCrowd
+                  Constructor.
+                ~ModelCrowd
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ModelCrowd final
+    {
+    public:
+        static constexpr UINT BONE_PALETTES_SLOT = Model::BONE_TRANSFORMS_SLOT;
+        static constexpr UINT INSTANCES_SLOT = 5u;
+
+    public:
+        ModelCrowd() = delete;
+        ModelCrowd(_In_ const std::shared_ptr<Model>& model);
+        ModelCrowd(const ModelCrowd& other) = delete;
+        ModelCrowd(ModelCrowd&& other) = delete;
+        ModelCrowd& operator=(const ModelCrowd& other) = delete;
+        ModelCrowd& operator=(ModelCrowd&& other) = delete;
+        ~ModelCrowd() = default;
+
+        HRESULT AddInstance(_In_ const XMMATRIX& world, _In_ FLOAT timeOffset, _In_ FLOAT speed);
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void Update(_In_ FLOAT deltaTime);
+        UINT Upload(_In_ RenderBackend& backend) const;
+        void Bind(_In_ RenderBackend& backend) const;
+
+        void SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState);
+
+        Model& GetModel();
+        const std::shared_ptr<PipelineState>& GetPipelineState() const;
+        UINT GetNumInstances() const;
+
+    private:
+        struct Instance
+        {
+            XMMATRIX World;
+            FLOAT time;
+            FLOAT speed;
+        };
+
+    private:
+        std::shared_ptr<Model> m_model;
+        std::shared_ptr<PipelineState> m_pipelineState;
+        ComPtr<ID3D11Buffer> m_bonePalettes;
+        ComPtr<ID3D11ShaderResourceView> m_bonePalettesView;
+        ComPtr<ID3D11Buffer> m_instances;
+        ComPtr<ID3D11ShaderResourceView> m_instancesView;
+        std::vector<Instance> m_aInstances;
+        TaggedVector<XMMATRIX, eMemoryTag::ANIMATION> m_aBonePalettes;
+        TaggedVector<XMFLOAT3X4, eMemoryTag::ANIMATION> m_aPackedBonePalettes;
+        TaggedVector<CrowdInstanceData, eMemoryTag::RENDERER> m_aInstanceData;
+        UINT m_uNumBones;
+    };
+}
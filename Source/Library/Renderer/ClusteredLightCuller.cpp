@@ -0,0 +1,584 @@
+#include "Renderer/ClusteredLightCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::ClusteredLightCuller
+
+      Summary:  Constructor
+
+      Modifies: [m_lights, m_lightsView, m_clusters, m_clustersView,
+                 m_lightIndices, m_lightIndicesView, m_constants,
+                 m_aClusterBounds, m_aSlices, m_aLights, m_uNumLights,
+                 m_aViewLights, m_auGlobalLights, m_aClusters,
+                 m_auLightIndices, m_uNumLightIndices,
+                 m_uNumDroppedLightIndices, m_lastUpdateSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ClusteredLightCuller::ClusteredLightCuller()
+        : m_lights()
+        , m_lightsView()
+        , m_clusters()
+        , m_clustersView()
+        , m_lightIndices()
+        , m_lightIndicesView()
+        , m_constants()
+        , m_aClusterBounds(NUM_CLUSTERS)
+        , m_aSlices(NUM_CLUSTERS_Z)
+        , m_aLights(MAX_NUM_LIGHTS)
+        , m_uNumLights(0u)
+        , m_aViewLights(MAX_NUM_LIGHTS)
+        , m_auGlobalLights()
+        , m_aClusters(NUM_CLUSTERS)
+        , m_auLightIndices(MAX_NUM_CLUSTER_LIGHT_INDICES)
+        , m_uNumLightIndices(0u)
+        , m_uNumDroppedLightIndices(0u)
+        , m_lastUpdateSeconds(0.0f)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::Initialize
+
+      Summary:  Creates the light buffer, the cluster buffer and the
+                light index buffer with their shader resource views
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_lights, m_lightsView, m_clusters, m_clustersView,
+                 m_lightIndices, m_lightIndicesView].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT ClusteredLightCuller::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        D3D11_BUFFER_DESC lightsDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(PointLightData) * MAX_NUM_LIGHTS),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED,
+            .StructureByteStride = sizeof(PointLightData),
+        };
+        hr = pDevice->CreateBuffer(&lightsDesc, nullptr, m_lights.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC lightsViewDesc = {
+            .Format = DXGI_FORMAT_UNKNOWN,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = MAX_NUM_LIGHTS,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_lights.Get(), &lightsViewDesc, m_lightsView.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_BUFFER_DESC clustersDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(XMUINT2) * NUM_CLUSTERS),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u,
+        };
+        hr = pDevice->CreateBuffer(&clustersDesc, nullptr, m_clusters.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC clustersViewDesc = {
+            .Format = DXGI_FORMAT_R32G32_UINT,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = NUM_CLUSTERS,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_clusters.Get(), &clustersViewDesc, m_clustersView.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_BUFFER_DESC lightIndicesDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(UINT) * MAX_NUM_CLUSTER_LIGHT_INDICES),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+            .StructureByteStride = 0u,
+        };
+        hr = pDevice->CreateBuffer(&lightIndicesDesc, nullptr, m_lightIndices.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC lightIndicesViewDesc = {
+            .Format = DXGI_FORMAT_R32_UINT,
+            .ViewDimension = D3D11_SRV_DIMENSION_BUFFER,
+            .Buffer = {
+                .FirstElement = 0u,
+                .NumElements = MAX_NUM_CLUSTER_LIGHT_INDICES,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_lightIndices.Get(), &lightIndicesViewDesc, m_lightIndicesView.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::SetProjection
+
+      Summary:  Computes the view space bounding box of every cluster
+                and the constants the pixel shaders use to find the
+                cluster of a pixel
+
+      Args:     const XMMATRIX& projection
+                  Perspective projection matrix
+                FLOAT nearZ
+                  Distance to the near plane
+                FLOAT farZ
+                  Distance to the far plane
+                UINT uWidth
+                  Width of the render target
+                UINT uHeight
+                  Height of the render target
+
+      Modifies: [m_constants, m_aClusterBounds, m_aSlices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ClusteredLightCuller::SetProjection(_In_ const XMMATRIX& projection, _In_ FLOAT nearZ, _In_ FLOAT farZ, _In_ UINT uWidth, _In_ UINT uHeight)
+    {
+        assert(nearZ < FIRST_SLICE_DEPTH && FIRST_SLICE_DEPTH < farZ);
+
+        const FLOAT logDepthRange = std::log(farZ / FIRST_SLICE_DEPTH);
+
+        m_constants.ClusterScale = XMFLOAT4(
+            static_cast<FLOAT>(NUM_CLUSTERS_X) / static_cast<FLOAT>(uWidth),
+            static_cast<FLOAT>(NUM_CLUSTERS_Y) / static_cast<FLOAT>(uHeight),
+            static_cast<FLOAT>(NUM_CLUSTERS_Z - 1) / logDepthRange,
+            FIRST_SLICE_DEPTH
+        );
+
+        // A view space point at depth d projects to x * P11 / d, so the
+        // tile edges at that depth are at ndc * d / P11
+        XMFLOAT4X4 projectionValues;
+        XMStoreFloat4x4(&projectionValues, projection);
+        const FLOAT invScaleX = 1.0f / projectionValues._11;
+        const FLOAT invScaleY = 1.0f / projectionValues._22;
+
+        for (UINT z = 0u; z < NUM_CLUSTERS_Z; ++z)
+        {
+            DepthSlice& slice = m_aSlices[z];
+            slice.minDepth = (z == 0u) ? nearZ : FIRST_SLICE_DEPTH * std::exp(logDepthRange * static_cast<FLOAT>(z - 1u) / static_cast<FLOAT>(NUM_CLUSTERS_Z - 1));
+            slice.maxDepth = FIRST_SLICE_DEPTH * std::exp(logDepthRange * static_cast<FLOAT>(z) / static_cast<FLOAT>(NUM_CLUSTERS_Z - 1));
+
+            for (UINT y = 0u; y < NUM_CLUSTERS_Y; ++y)
+            {
+                // Tiles are numbered from the top of the screen
+                const FLOAT ndcTop = 1.0f - 2.0f * static_cast<FLOAT>(y) / static_cast<FLOAT>(NUM_CLUSTERS_Y);
+                const FLOAT ndcBottom = 1.0f - 2.0f * static_cast<FLOAT>(y + 1u) / static_cast<FLOAT>(NUM_CLUSTERS_Y);
+
+                for (UINT x = 0u; x < NUM_CLUSTERS_X; ++x)
+                {
+                    const FLOAT ndcLeft = -1.0f + 2.0f * static_cast<FLOAT>(x) / static_cast<FLOAT>(NUM_CLUSTERS_X);
+                    const FLOAT ndcRight = -1.0f + 2.0f * static_cast<FLOAT>(x + 1u) / static_cast<FLOAT>(NUM_CLUSTERS_X);
+
+                    const FLOAT aX[4] = {
+                        ndcLeft * slice.minDepth * invScaleX, ndcLeft * slice.maxDepth * invScaleX,
+                        ndcRight * slice.minDepth * invScaleX, ndcRight * slice.maxDepth * invScaleX,
+                    };
+                    const FLOAT aY[4] = {
+                        ndcBottom * slice.minDepth * invScaleY, ndcBottom * slice.maxDepth * invScaleY,
+                        ndcTop * slice.minDepth * invScaleY, ndcTop * slice.maxDepth * invScaleY,
+                    };
+
+                    ClusterBounds& bounds = m_aClusterBounds[(z * NUM_CLUSTERS_Y + y) * NUM_CLUSTERS_X + x];
+                    bounds.Min = XMFLOAT3(*std::min_element(aX, aX + 4), *std::min_element(aY, aY + 4), slice.minDepth);
+                    bounds.Max = XMFLOAT3(*std::max_element(aX, aX + 4), *std::max_element(aY, aY + 4), slice.maxDepth);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::Update
+
+      Summary:  Assigns the lights to the clusters. The depth slices
+                are assigned in parallel into their own lists, which
+                are then packed in cluster order, so the result does
+                not depend on the number of threads. Lists that do not
+                fit in MAX_NUM_CLUSTER_LIGHT_INDICES are truncated and
+                the indices left out are counted
+
+      Args:     const XMMATRIX& view
+                  View matrix of the camera
+                const std::vector<std::shared_ptr<PointLight>>& lights
+                  Lights of the frame, the first MAX_NUM_LIGHTS are
+                  used
+
+      Modifies: [m_constants, m_aSlices, m_aLights, m_uNumLights,
+                 m_aViewLights, m_auGlobalLights, m_aClusters,
+                 m_auLightIndices, m_uNumLightIndices,
+                 m_uNumDroppedLightIndices, m_lastUpdateSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ClusteredLightCuller::Update(_In_ const XMMATRIX& view, _In_ const std::vector<std::shared_ptr<PointLight>>& lights)
+    {
+        LARGE_INTEGER startTime;
+        QueryPerformanceCounter(&startTime);
+
+        m_uNumLights = 0u;
+        m_auGlobalLights.clear();
+        for (const std::shared_ptr<PointLight>& light : lights)
+        {
+            if (!light)
+            {
+                continue;
+            }
+
+            if (m_uNumLights == MAX_NUM_LIGHTS)
+            {
+                break;
+            }
+
+            const XMFLOAT4& position = light->GetPosition();
+            const FLOAT radius = light->GetAttenuationRadius();
+
+            m_aLights[m_uNumLights] = PointLightData{
+                .Position = XMFLOAT4(position.x, position.y, position.z, radius),
+                .Color = light->GetColor(),
+            };
+
+            if (radius > 0.0f)
+            {
+                const XMVECTOR viewPosition = XMVector3TransformCoord(XMVectorSet(position.x, position.y, position.z, 1.0f), view);
+                XMStoreFloat4(&m_aViewLights[m_uNumLights], XMVectorSetW(viewPosition, radius));
+            }
+            else
+            {
+                m_aViewLights[m_uNumLights] = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+                m_auGlobalLights.push_back(m_uNumLights);
+            }
+
+            ++m_uNumLights;
+        }
+        m_constants.NumLights = XMUINT4(m_uNumLights, 0u, 0u, 0u);
+
+        std::for_each(
+            std::execution::par,
+            m_aSlices.begin(),
+            m_aSlices.end(),
+            [this](const DepthSlice& slice)
+            {
+                assignSlice(static_cast<UINT>(&slice - m_aSlices.data()));
+            }
+        );
+
+        // Pack the lists of the slices, which are already in cluster order
+        m_uNumLightIndices = 0u;
+        m_uNumDroppedLightIndices = 0u;
+        for (UINT z = 0u; z < NUM_CLUSTERS_Z; ++z)
+        {
+            const std::vector<UINT>& auIndices = m_aSlices[z].auIndices;
+            UINT uSliceOffset = 0u;
+
+            for (UINT i = z * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; i < (z + 1u) * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; ++i)
+            {
+                const UINT uNumIndices = m_aClusters[i].y;
+                const UINT uNumPacked = std::min(uNumIndices, MAX_NUM_CLUSTER_LIGHT_INDICES - m_uNumLightIndices);
+
+                std::copy(
+                    auIndices.begin() + uSliceOffset,
+                    auIndices.begin() + uSliceOffset + uNumPacked,
+                    m_auLightIndices.begin() + m_uNumLightIndices
+                );
+                m_aClusters[i] = XMUINT2(m_uNumLightIndices, uNumPacked);
+
+                uSliceOffset += uNumIndices;
+                m_uNumLightIndices += uNumPacked;
+                m_uNumDroppedLightIndices += uNumIndices - uNumPacked;
+            }
+        }
+        assert(m_uNumDroppedLightIndices == 0u);
+
+        LARGE_INTEGER endTime;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&endTime);
+        QueryPerformanceFrequency(&frequency);
+        m_lastUpdateSeconds = static_cast<FLOAT>(endTime.QuadPart - startTime.QuadPart) / static_cast<FLOAT>(frequency.QuadPart);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::Upload
+
+      Summary:  Uploads the used part of the light buffer and of the
+                light index buffer, and the whole cluster buffer
+
+      Args:     RenderBackend& backend
+                  Backend receiving the uploads
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ClusteredLightCuller::Upload(_In_ RenderBackend& backend) const
+    {
+        if (m_uNumLights > 0u)
+        {
+            backend.UpdateBuffer(m_lights.Get(), m_aLights.data(), static_cast<UINT>(sizeof(PointLightData) * m_uNumLights));
+        }
+
+        backend.UpdateBuffer(m_clusters.Get(), m_aClusters.data(), static_cast<UINT>(sizeof(XMUINT2) * NUM_CLUSTERS));
+
+        if (m_uNumLightIndices > 0u)
+        {
+            backend.UpdateBuffer(m_lightIndices.Get(), m_auLightIndices.data(), static_cast<UINT>(sizeof(UINT) * m_uNumLightIndices));
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::Bind
+
+      Summary:  Binds the light buffer, the cluster buffer and the light
+                index buffer to the pixel shader
+
+      Args:     RenderBackend& backend
+                  Backend or command buffer receiving the bindings
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ClusteredLightCuller::Bind(_In_ RenderBackend& backend) const
+    {
+        backend.SetPixelShaderResource(LIGHTS_SLOT, m_lightsView.Get());
+        backend.SetPixelShaderResource(CLUSTERS_SLOT, m_clustersView.Get());
+        backend.SetPixelShaderResource(LIGHT_INDICES_SLOT, m_lightIndicesView.Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetConstants
+
+      Summary:  Returns the constants locating the cluster of a pixel
+
+      Returns:  const CBLights&
+                  Cluster scale and number of lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const CBLights& ClusteredLightCuller::GetConstants() const
+    {
+        return m_constants;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetLights
+
+      Summary:  Returns the lights of the frame. Only the first
+                GetNumLights are valid
+
+      Returns:  const std::vector<PointLightData>&
+                  World space lights, attenuation radius in w
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<PointLightData>& ClusteredLightCuller::GetLights() const
+    {
+        return m_aLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetNumLights
+
+      Summary:  Returns the number of lights of the frame
+
+      Returns:  UINT
+                  Number of lights
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ClusteredLightCuller::GetNumLights() const
+    {
+        return m_uNumLights;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetClusters
+
+      Summary:  Returns the offset and the count of the light list of
+                every cluster, x first, then y from the top of the
+                screen, then depth
+
+      Returns:  const std::vector<XMUINT2>&
+                  Offsets and counts
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<XMUINT2>& ClusteredLightCuller::GetClusters() const
+    {
+        return m_aClusters;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetLightIndices
+
+      Summary:  Returns the packed light lists. Only the first
+                GetNumLightIndices are valid
+
+      Returns:  const std::vector<UINT>&
+                  Light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<UINT>& ClusteredLightCuller::GetLightIndices() const
+    {
+        return m_auLightIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetNumLightIndices
+
+      Summary:  Returns the number of packed light indices
+
+      Returns:  UINT
+                  Number of light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ClusteredLightCuller::GetNumLightIndices() const
+    {
+        return m_uNumLightIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetNumDroppedLightIndices
+
+      Summary:  Returns the number of light indices left out of the
+                last assignment because MAX_NUM_CLUSTER_LIGHT_INDICES
+                was reached. Pixels of the clusters cut miss lights
+
+      Returns:  UINT
+                  Number of dropped light indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT ClusteredLightCuller::GetNumDroppedLightIndices() const
+    {
+        return m_uNumDroppedLightIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetLastUpdateSeconds
+
+      Summary:  Returns the duration of the last assignment
+
+      Returns:  FLOAT
+                  Duration in seconds
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT ClusteredLightCuller::GetLastUpdateSeconds() const
+    {
+        return m_lastUpdateSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::GetAttenuation
+
+      Summary:  Returns how much of a light reaches a position, as the
+                GetAttenuation function of the shaders. It falls
+                smoothly to 0 at the attenuation radius
+
+      Args:     const PointLightData& light
+                  Light, attenuation radius in the w of the position
+                FXMVECTOR worldPosition
+                  Lit position
+
+      Returns:  FLOAT
+                  Attenuation, 1 for lights without attenuation radius
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT ClusteredLightCuller::GetAttenuation(_In_ const PointLightData& light, _In_ FXMVECTOR worldPosition)
+    {
+        if (light.Position.w <= 0.0f)
+        {
+            return 1.0f;
+        }
+
+        const FLOAT distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(XMLoadFloat4(&light.Position), worldPosition)));
+        const FLOAT ratio = distance / light.Position.w;
+        const FLOAT falloff = std::clamp(1.0f - ratio * ratio, 0.0f, 1.0f);
+
+        return falloff * falloff;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   ClusteredLightCuller::assignSlice
+
+      Summary:  Lists the lights of every cluster of a depth slice. The
+                lights overlapping the depth range of the slice are
+                gathered in structure of arrays, padded to a multiple
+                of four, then each cluster tests four lights at once
+                with the squared distance between the sphere center and
+                its bounding box
+
+      Args:     UINT uSlice
+                  Index of the depth slice
+
+      Modifies: [m_aSlices, m_aClusters].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void ClusteredLightCuller::assignSlice(_In_ UINT uSlice)
+    {
+        DepthSlice& slice = m_aSlices[uSlice];
+
+        slice.aX.clear();
+        slice.aY.clear();
+        slice.aZ.clear();
+        slice.aRadii.clear();
+        slice.auLights.clear();
+        slice.auIndices.clear();
+
+        for (UINT i = 0u; i < m_uNumLights; ++i)
+        {
+            const XMFLOAT4& light = m_aViewLights[i];
+            if (light.w <= 0.0f || light.z + light.w < slice.minDepth || light.z - light.w > slice.maxDepth)
+            {
+                continue;
+            }
+
+            slice.aX.push_back(light.x);
+            slice.aY.push_back(light.y);
+            slice.aZ.push_back(light.z);
+            slice.aRadii.push_back(light.w);
+            slice.auLights.push_back(i);
+        }
+
+        // Padding lights are infinitely far, so they never overlap
+        while (slice.auLights.size() % 4u != 0u)
+        {
+            slice.aX.push_back(D3D11_FLOAT32_MAX);
+            slice.aY.push_back(D3D11_FLOAT32_MAX);
+            slice.aZ.push_back(D3D11_FLOAT32_MAX);
+            slice.aRadii.push_back(0.0f);
+            slice.auLights.push_back(0u);
+        }
+
+        const XMVECTOR zero = XMVectorZero();
+        for (UINT uCluster = uSlice * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; uCluster < (uSlice + 1u) * NUM_CLUSTERS_X * NUM_CLUSTERS_Y; ++uCluster)
+        {
+            const ClusterBounds& bounds = m_aClusterBounds[uCluster];
+            const XMVECTOR minX = XMVectorReplicate(bounds.Min.x);
+            const XMVECTOR minY = XMVectorReplicate(bounds.Min.y);
+            const XMVECTOR minZ = XMVectorReplicate(bounds.Min.z);
+            const XMVECTOR maxX = XMVectorReplicate(bounds.Max.x);
+            const XMVECTOR maxY = XMVectorReplicate(bounds.Max.y);
+            const XMVECTOR maxZ = XMVectorReplicate(bounds.Max.z);
+
+            const size_t uFirstIndex = slice.auIndices.size();
+            slice.auIndices.insert(slice.auIndices.end(), m_auGlobalLights.begin(), m_auGlobalLights.end());
+
+            for (size_t i = 0u; i < slice.auLights.size(); i += 4u)
+            {
+                const XMVECTOR x = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.aX[i]));
+                const XMVECTOR y = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.aY[i]));
+                const XMVECTOR z = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.aZ[i]));
+                const XMVECTOR radii = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&slice.aRadii[i]));
+
+                // Distance from the center to the box along each axis, 0 inside
+                const XMVECTOR dx = XMVectorAdd(XMVectorMax(XMVectorSubtract(minX, x), zero), XMVectorMax(XMVectorSubtract(x, maxX), zero));
+                const XMVECTOR dy = XMVectorAdd(XMVectorMax(XMVectorSubtract(minY, y), zero), XMVectorMax(XMVectorSubtract(y, maxY), zero));
+                const XMVECTOR dz = XMVectorAdd(XMVectorMax(XMVectorSubtract(minZ, z), zero), XMVectorMax(XMVectorSubtract(z, maxZ), zero));
+                const XMVECTOR squaredDistances = XMVectorMultiplyAdd(dx, dx, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dz, dz)));
+
+                UINT auOverlaps[4];
+                XMStoreInt4(auOverlaps, XMVectorLessOrEqual(squaredDistances, XMVectorMultiply(radii, radii)));
+
+                for (size_t j = 0u; j < 4u; ++j)
+                {
+                    if (auOverlaps[j] != 0u)
+                    {
+                        slice.auIndices.push_back(slice.auLights[i + j]);
+                    }
+                }
+            }
+
+            m_aClusters[uCluster].y = static_cast<UINT>(slice.auIndices.size() - uFirstIndex);
+        }
+    }
+}
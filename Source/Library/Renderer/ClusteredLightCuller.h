@@ -0,0 +1,148 @@
+/*+===================================================================
+  File:      CLUSTEREDLIGHTCULLER.H
+
+  Summary:   ClusteredLightCuller header file contains declarations of
+             the CPU light assignment that splits the view frustum into
+             clusters and lists the point lights reaching each of them,
+             so a pixel only shades the lights of its cluster.
+
+  Classes: ClusteredLightCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Light/PointLight.h"
+#include "Renderer/DataTypes.h"
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ClusteredLightCuller
+
+      Summary:  Splits the view frustum into NUM_CLUSTERS_X by
+                NUM_CLUSTERS_Y screen tiles and NUM_CLUSTERS_Z depth
+                slices. The first slice ends at FIRST_SLICE_DEPTH and
+                the others are spaced logarithmically up to the far
+                plane. Every frame, the lights are moved to view space
+                and each depth slice is assigned on a worker thread:
+                the lights overlapping the slice are gathered, then
+                tested four at a time against the bounding box of each
+                cluster. The lists are packed into one index buffer
+                with an offset and a count per cluster. Lights without
+                attenuation radius are listed in every cluster
+
+      Methods:  Initialize
+                  Creates the buffers read by the pixel shaders
+                SetProjection
+                  Computes the bounds of the clusters
+                Update
+                  Assigns the lights to the clusters
+                Upload
+                  Uploads the lights and the cluster lists
+                Bind
+                  Binds the lights and the cluster lists to the pixel
+                  shader
+                GetConstants
+                  Returns the constants locating the cluster of a
+                  pixel
+                GetLights
+                  Returns the lights of the frame
+                GetNumLights
+                  Returns the number of lights of the frame
+                GetClusters
+                  Returns the offset and count of every cluster
+                GetLightIndices
+                  Returns the packed light lists
+                GetNumLightIndices
+                  Returns the number of packed light indices
+                GetNumDroppedLightIndices
+                  Returns the number of light indices that did not fit
+                GetLastUpdateSeconds
+                  Returns the duration of the last assignment
+                GetAttenuation
+                  Returns how much of a light reaches a position
+                ClusteredLightCuller
+                  Constructor.
+                ~ClusteredLightCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ClusteredLightCuller final
+    {
+    public:
+        static constexpr FLOAT FIRST_SLICE_DEPTH = 1.0f;
+        static constexpr UINT LIGHTS_SLOT = 1u;
+        static constexpr UINT CLUSTERS_SLOT = 2u;
+        static constexpr UINT LIGHT_INDICES_SLOT = 3u;
+
+    public:
+        ClusteredLightCuller();
+        ClusteredLightCuller(const ClusteredLightCuller& other) = delete;
+        ClusteredLightCuller(ClusteredLightCuller&& other) = delete;
+        ClusteredLightCuller& operator=(const ClusteredLightCuller& other) = delete;
+        ClusteredLightCuller& operator=(ClusteredLightCuller&& other) = delete;
+        ~ClusteredLightCuller() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+        void SetProjection(_In_ const XMMATRIX& projection, _In_ FLOAT nearZ, _In_ FLOAT farZ, _In_ UINT uWidth, _In_ UINT uHeight);
+        void Update(_In_ const XMMATRIX& view, _In_ const std::vector<std::shared_ptr<PointLight>>& lights);
+        void Upload(_In_ RenderBackend& backend) const;
+        void Bind(_In_ RenderBackend& backend) const;
+
+        const CBLights& GetConstants() const;
+        const std::vector<PointLightData>& GetLights() const;
+        UINT GetNumLights() const;
+        const std::vector<XMUINT2>& GetClusters() const;
+        const std::vector<UINT>& GetLightIndices() const;
+        UINT GetNumLightIndices() const;
+        UINT GetNumDroppedLightIndices() const;
+        FLOAT GetLastUpdateSeconds() const;
+
+        static FLOAT GetAttenuation(_In_ const PointLightData& light, _In_ FXMVECTOR worldPosition);
+
+    private:
+        struct ClusterBounds
+        {
+            XMFLOAT3 Min;
+            XMFLOAT3 Max;
+        };
+
+        struct DepthSlice
+        {
+            FLOAT minDepth;
+            FLOAT maxDepth;
+            std::vector<FLOAT> aX;
+            std::vector<FLOAT> aY;
+            std::vector<FLOAT> aZ;
+            std::vector<FLOAT> aRadii;
+            std::vector<UINT> auLights;
+            std::vector<UINT> auIndices;
+        };
+
+    private:
+        void assignSlice(_In_ UINT uSlice);
+
+    private:
+        ComPtr<ID3D11Buffer> m_lights;
+        ComPtr<ID3D11ShaderResourceView> m_lightsView;
+        ComPtr<ID3D11Buffer> m_clusters;
+        ComPtr<ID3D11ShaderResourceView> m_clustersView;
+        ComPtr<ID3D11Buffer> m_lightIndices;
+        ComPtr<ID3D11ShaderResourceView> m_lightIndicesView;
+        CBLights m_constants;
+        std::vector<ClusterBounds> m_aClusterBounds;
+        std::vector<DepthSlice> m_aSlices;
+        std::vector<PointLightData> m_aLights;
+        UINT m_uNumLights;
+        std::vector<XMFLOAT4> m_aViewLights;
+        std::vector<UINT> m_auGlobalLights;
+        std::vector<XMUINT2> m_aClusters;
+        std::vector<UINT> m_auLightIndices;
+        UINT m_uNumLightIndices;
+        UINT m_uNumDroppedLightIndices;
+        FLOAT m_lastUpdateSeconds;
+    };
+}
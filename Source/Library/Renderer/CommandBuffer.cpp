@@ -0,0 +1,630 @@
+#include "Renderer/CommandBuffer.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::CommandBuffer
+
+      Summary:  Constructor
+
+      Modifies: [m_aCommands, m_aPayload, m_auNumCommands,
+                 m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    CommandBuffer::CommandBuffer()
+        : m_aCommands()
+        , m_aPayload()
+        , m_auNumCommands()
+        , m_uNumIndices(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::BeginFrame
+
+      Summary:  Discards the recorded commands
+
+      Modifies: [m_aCommands, m_aPayload, m_auNumCommands,
+                 m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::BeginFrame()
+    {
+        Reset();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::ClearRenderTarget
+
+      Summary:  Records a back buffer clear
+
+      Args:     const FLOAT aClearColor[4]
+                  RGBA clear color
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::ClearRenderTarget(_In_ const FLOAT aClearColor[4])
+    {
+        RenderCommand& command = record(eRenderCommandType::CLEAR_RENDER_TARGET, 0u, nullptr);
+        std::copy(aClearColor, aClearColor + 4, command.aValues);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::ClearDepthStencil
+
+      Summary:  Records a depth stencil clear
+
+      Args:     FLOAT depth
+                  Depth to clear to
+                UINT8 stencil
+                  Stencil value to clear to
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil)
+    {
+        RenderCommand& command = record(eRenderCommandType::CLEAR_DEPTH_STENCIL, 0u, nullptr);
+        command.aValues[0] = depth;
+        command.auArgs[0] = stencil;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::UpdateBuffer
+
+      Summary:  Records a buffer upload and copies its data, since the
+                caller usually passes a temporary
+
+      Args:     ID3D11Buffer* pBuffer
+                  Buffer to update
+                const void* pData
+                  Source data
+                UINT uSize
+                  Size of the data in bytes
+
+      Modifies: [m_aCommands, m_aPayload, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        RenderCommand& command = record(eRenderCommandType::UPDATE_BUFFER, 0u, pBuffer);
+        command.uPayloadOffset = static_cast<UINT>(m_aPayload.size());
+        command.uPayloadSize = uSize;
+
+        const BYTE* pBytes = static_cast<const BYTE*>(pData);
+        m_aPayload.insert(m_aPayload.end(), pBytes, pBytes + uSize);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPrimitiveTopology
+
+      Summary:  Records a primitive topology change
+
+      Args:     D3D11_PRIMITIVE_TOPOLOGY topology
+                  Primitive topology
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology)
+    {
+        RenderCommand& command = record(eRenderCommandType::SET_PRIMITIVE_TOPOLOGY, 0u, nullptr);
+        command.auArgs[0] = static_cast<UINT>(topology);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetVertexBuffer
+
+      Summary:  Records a vertex buffer binding
+
+      Args:     UINT uSlot
+                  Input slot
+                ID3D11Buffer* pBuffer
+                  Vertex buffer
+                UINT uStride
+                  Size of an element in bytes
+                UINT uOffset
+                  Offset of the first element in bytes
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset)
+    {
+        RenderCommand& command = record(eRenderCommandType::SET_VERTEX_BUFFER, uSlot, pBuffer);
+        command.auArgs[0] = uStride;
+        command.auArgs[1] = uOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetIndexBuffer
+
+      Summary:  Records an index buffer binding
+
+      Args:     ID3D11Buffer* pBuffer
+                  Index buffer
+                DXGI_FORMAT format
+                  Format of the indices
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format)
+    {
+        RenderCommand& command = record(eRenderCommandType::SET_INDEX_BUFFER, 0u, pBuffer);
+        command.auArgs[0] = static_cast<UINT>(format);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetInputLayout
+
+      Summary:  Records an input layout binding
+
+      Args:     ID3D11InputLayout* pInputLayout
+                  Input layout
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetInputLayout(_In_ ID3D11InputLayout* pInputLayout)
+    {
+        record(eRenderCommandType::SET_INPUT_LAYOUT, 0u, pInputLayout);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetVertexShader
+
+      Summary:  Records a vertex shader binding
+
+      Args:     ID3D11VertexShader* pVertexShader
+                  Vertex shader
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetVertexShader(_In_ ID3D11VertexShader* pVertexShader)
+    {
+        record(eRenderCommandType::SET_VERTEX_SHADER, 0u, pVertexShader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPixelShader
+
+      Summary:  Records a pixel shader binding
+
+      Args:     ID3D11PixelShader* pPixelShader
+                  Pixel shader
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPixelShader(_In_ ID3D11PixelShader* pPixelShader)
+    {
+        record(eRenderCommandType::SET_PIXEL_SHADER, 0u, pPixelShader);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetVertexShaderConstantBuffer
+
+      Summary:  Records a vertex shader constant buffer binding
+
+      Args:     UINT uSlot
+                  Constant buffer register
+                ID3D11Buffer* pBuffer
+                  Constant buffer
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        record(eRenderCommandType::SET_VS_CONSTANT_BUFFER, uSlot, pBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPixelShaderConstantBuffer
+
+      Summary:  Records a pixel shader constant buffer binding
+
+      Args:     UINT uSlot
+                  Constant buffer register
+                ID3D11Buffer* pBuffer
+                  Constant buffer
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        record(eRenderCommandType::SET_PS_CONSTANT_BUFFER, uSlot, pBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetVertexShaderResource
+
+      Summary:  Records a vertex shader resource view binding
+
+      Args:     UINT uSlot
+                  Texture register
+                ID3D11ShaderResourceView* pShaderResourceView
+                  Shader resource view
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        record(eRenderCommandType::SET_VS_SHADER_RESOURCE, uSlot, pShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPixelShaderResource
+
+      Summary:  Records a shader resource view binding
+
+      Args:     UINT uSlot
+                  Texture register
+                ID3D11ShaderResourceView* pShaderResourceView
+                  Shader resource view
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        record(eRenderCommandType::SET_PS_SHADER_RESOURCE, uSlot, pShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPixelShaderSampler
+
+      Summary:  Records a sampler binding
+
+      Args:     UINT uSlot
+                  Sampler register
+                ID3D11SamplerState* pSamplerState
+                  Sampler state
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState)
+    {
+        record(eRenderCommandType::SET_PS_SAMPLER, uSlot, pSamplerState);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::SetPipelineState
+
+      Summary:  Records a pipeline state binding
+
+      Args:     const PipelineState& pipelineState
+                  Pipeline state, must outlive the recording
+                ID3D11Buffer* pObjectConstants
+                  Constant buffer of the drawn object
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants)
+    {
+        RenderCommand& command = record(eRenderCommandType::SET_PIPELINE_STATE, 0u, pObjectConstants);
+        command.pPipelineState = &pipelineState;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::Draw
+
+      Summary:  Records a non-indexed draw
+
+      Args:     UINT uVertexCount
+                  Number of vertices to draw
+                UINT uStartVertex
+                  First vertex
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex)
+    {
+        RenderCommand& command = record(eRenderCommandType::DRAW, 0u, nullptr);
+        command.auArgs[0] = uVertexCount;
+        command.auArgs[2] = uStartVertex;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::DrawIndexed
+
+      Summary:  Records an indexed draw
+
+      Args:     UINT uIndexCount
+                  Number of indices to draw
+                UINT uStartIndex
+                  First index
+                INT iBaseVertex
+                  Value added to each index
+
+      Modifies: [m_aCommands, m_auNumCommands, m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex)
+    {
+        RenderCommand& command = record(eRenderCommandType::DRAW_INDEXED, 0u, nullptr);
+        command.auArgs[0] = uIndexCount;
+        command.auArgs[1] = 1u;
+        command.auArgs[2] = uStartIndex;
+        command.iBaseVertex = iBaseVertex;
+
+        m_uNumIndices += uIndexCount;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::DrawIndexedInstanced
+
+      Summary:  Records an instanced indexed draw
+
+      Args:     UINT uIndexCount
+                  Number of indices per instance
+                UINT uInstanceCount
+                  Number of instances
+                UINT uStartIndex
+                  First index
+                INT iBaseVertex
+                  Value added to each index
+                UINT uStartInstance
+                  First instance
+
+      Modifies: [m_aCommands, m_auNumCommands, m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance)
+    {
+        RenderCommand& command = record(eRenderCommandType::DRAW_INDEXED_INSTANCED, 0u, nullptr);
+        command.auArgs[0] = uIndexCount;
+        command.auArgs[1] = uInstanceCount;
+        command.auArgs[2] = uStartIndex;
+        command.auArgs[3] = uStartInstance;
+        command.iBaseVertex = iBaseVertex;
+
+        m_uNumIndices += static_cast<UINT64>(uIndexCount) * uInstanceCount;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::ExecuteCommandBuffers
+
+      Summary:  Appends the commands of other command buffers, in order
+
+      Args:     const CommandBuffer* const* apCommandBuffers
+                  Command buffers to append
+                UINT uNumCommandBuffers
+                  Number of command buffers
+
+      Modifies: [m_aCommands, m_aPayload, m_auNumCommands,
+                 m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers)
+    {
+        for (UINT i = 0u; i < uNumCommandBuffers; ++i)
+        {
+            assert(apCommandBuffers[i] != this);
+            apCommandBuffers[i]->Replay(*this);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::Present
+
+      Summary:  Records the end of the frame
+
+      Modifies: [m_aCommands, m_auNumCommands].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::Present()
+    {
+        record(eRenderCommandType::PRESENT, 0u, nullptr);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::Reset
+
+      Summary:  Discards the recorded commands. The storage is kept, so
+                recording a steady frame does not allocate
+
+      Modifies: [m_aCommands, m_aPayload, m_auNumCommands,
+                 m_uNumIndices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::Reset()
+    {
+        m_aCommands.clear();
+        m_aPayload.clear();
+        std::fill(std::begin(m_auNumCommands), std::end(m_auNumCommands), 0u);
+        m_uNumIndices = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::Replay
+
+      Summary:  Submits the recorded commands to a backend in the order
+                they were recorded
+
+      Args:     RenderBackend& backend
+                  Backend receiving the commands
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void CommandBuffer::Replay(_In_ RenderBackend& backend) const
+    {
+        for (const RenderCommand& command : m_aCommands)
+        {
+            switch (command.Type)
+            {
+            case eRenderCommandType::CLEAR_RENDER_TARGET:
+                backend.ClearRenderTarget(command.aValues);
+                break;
+            case eRenderCommandType::CLEAR_DEPTH_STENCIL:
+                backend.ClearDepthStencil(command.aValues[0], static_cast<UINT8>(command.auArgs[0]));
+                break;
+            case eRenderCommandType::UPDATE_BUFFER:
+                backend.UpdateBuffer(static_cast<ID3D11Buffer*>(command.pObject), GetPayload(command), command.uPayloadSize);
+                break;
+            case eRenderCommandType::SET_PRIMITIVE_TOPOLOGY:
+                backend.SetPrimitiveTopology(static_cast<D3D11_PRIMITIVE_TOPOLOGY>(command.auArgs[0]));
+                break;
+            case eRenderCommandType::SET_VERTEX_BUFFER:
+                backend.SetVertexBuffer(command.uSlot, static_cast<ID3D11Buffer*>(command.pObject), command.auArgs[0], command.auArgs[1]);
+                break;
+            case eRenderCommandType::SET_INDEX_BUFFER:
+                backend.SetIndexBuffer(static_cast<ID3D11Buffer*>(command.pObject), static_cast<DXGI_FORMAT>(command.auArgs[0]));
+                break;
+            case eRenderCommandType::SET_INPUT_LAYOUT:
+                backend.SetInputLayout(static_cast<ID3D11InputLayout*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_VERTEX_SHADER:
+                backend.SetVertexShader(static_cast<ID3D11VertexShader*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_PIXEL_SHADER:
+                backend.SetPixelShader(static_cast<ID3D11PixelShader*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_VS_CONSTANT_BUFFER:
+                backend.SetVertexShaderConstantBuffer(command.uSlot, static_cast<ID3D11Buffer*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_PS_CONSTANT_BUFFER:
+                backend.SetPixelShaderConstantBuffer(command.uSlot, static_cast<ID3D11Buffer*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_VS_SHADER_RESOURCE:
+                backend.SetVertexShaderResource(command.uSlot, static_cast<ID3D11ShaderResourceView*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_PS_SHADER_RESOURCE:
+                backend.SetPixelShaderResource(command.uSlot, static_cast<ID3D11ShaderResourceView*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_PS_SAMPLER:
+                backend.SetPixelShaderSampler(command.uSlot, static_cast<ID3D11SamplerState*>(command.pObject));
+                break;
+            case eRenderCommandType::SET_PIPELINE_STATE:
+                backend.SetPipelineState(*command.pPipelineState, static_cast<ID3D11Buffer*>(command.pObject));
+                break;
+            case eRenderCommandType::DRAW:
+                backend.Draw(command.auArgs[0], command.auArgs[2]);
+                break;
+            case eRenderCommandType::DRAW_INDEXED:
+                backend.DrawIndexed(command.auArgs[0], command.auArgs[2], command.iBaseVertex);
+                break;
+            case eRenderCommandType::DRAW_INDEXED_INSTANCED:
+                backend.DrawIndexedInstanced(command.auArgs[0], command.auArgs[1], command.auArgs[2], command.iBaseVertex, command.auArgs[3]);
+                break;
+            case eRenderCommandType::PRESENT:
+                backend.Present();
+                break;
+            default:
+                assert(FALSE);
+                break;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetCommands
+
+      Summary:  Returns the recorded commands
+
+      Returns:  const std::vector<RenderCommand>&
+                  Commands in submission order
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<RenderCommand>& CommandBuffer::GetCommands() const
+    {
+        return m_aCommands;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetPayload
+
+      Summary:  Returns the copy of the data uploaded by a command
+
+      Args:     const RenderCommand& command
+                  UPDATE_BUFFER command of this command buffer
+
+      Returns:  const BYTE*
+                  Uploaded data, nullptr if the command has none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const BYTE* CommandBuffer::GetPayload(_In_ const RenderCommand& command) const
+    {
+        if (command.uPayloadSize == 0u)
+        {
+            return nullptr;
+        }
+
+        return m_aPayload.data() + command.uPayloadOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetNumCommands
+
+      Summary:  Returns the number of commands of a type recorded
+
+      Args:     eRenderCommandType type
+                  Kind of the commands to count
+
+      Returns:  UINT
+                  Number of commands
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT CommandBuffer::GetNumCommands(_In_ eRenderCommandType type) const
+    {
+        if (type >= eRenderCommandType::COUNT)
+        {
+            return 0u;
+        }
+
+        return m_auNumCommands[static_cast<size_t>(type)];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetNumDrawCalls
+
+      Summary:  Returns the number of draws recorded
+
+      Returns:  UINT
+                  Number of indexed and instanced draws
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT CommandBuffer::GetNumDrawCalls() const
+    {
+        return GetNumCommands(eRenderCommandType::DRAW) + GetNumCommands(eRenderCommandType::DRAW_INDEXED) + GetNumCommands(eRenderCommandType::DRAW_INDEXED_INSTANCED);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetNumIndices
+
+      Summary:  Returns the number of indices drawn, counting every
+                instance
+
+      Returns:  UINT64
+                  Number of indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 CommandBuffer::GetNumIndices() const
+    {
+        return m_uNumIndices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::GetNumUploadedBytes
+
+      Summary:  Returns the number of bytes uploaded
+
+      Returns:  UINT64
+                  Number of bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 CommandBuffer::GetNumUploadedBytes() const
+    {
+        return static_cast<UINT64>(m_aPayload.size());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   CommandBuffer::record
+
+      Summary:  Appends a command and counts it
+
+      Args:     eRenderCommandType type
+                  Kind of the command
+                UINT uSlot
+                  Register or input slot of a binding
+                ID3D11DeviceChild* pObject
+                  Bound or updated object
+
+      Modifies: [m_aCommands, m_auNumCommands].
+
+      Returns:  RenderCommand&
+                  The new command, valid until the next record
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RenderCommand& CommandBuffer::record(_In_ eRenderCommandType type, _In_ UINT uSlot, _In_opt_ ID3D11DeviceChild* pObject)
+    {
+        ++m_auNumCommands[static_cast<size_t>(type)];
+
+        RenderCommand& command = m_aCommands.emplace_back();
+        command = {
+            .Type = type,
+            .uSlot = uSlot,
+            .pObject = pObject,
+        };
+
+        return command;
+    }
+}
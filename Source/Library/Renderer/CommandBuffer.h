@@ -0,0 +1,217 @@
+/*+===================================================================
+  File:      COMMANDBUFFER.H
+
+  Summary:   CommandBuffer header file contains declarations of the
+             engine level command buffer. Worker threads record disjoint
+             parts of a frame into their own command buffers, which are
+             then executed in order by the render backend.
+
+  Classes: CommandBuffer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eRenderCommandType
+
+      Summary:  Kind of a recorded render command, one per method of
+                RenderBackend
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eRenderCommandType : BYTE
+    {
+        CLEAR_RENDER_TARGET,
+        CLEAR_DEPTH_STENCIL,
+        UPDATE_BUFFER,
+        SET_PRIMITIVE_TOPOLOGY,
+        SET_VERTEX_BUFFER,
+        SET_INDEX_BUFFER,
+        SET_INPUT_LAYOUT,
+        SET_VERTEX_SHADER,
+        SET_PIXEL_SHADER,
+        SET_VS_CONSTANT_BUFFER,
+        SET_PS_CONSTANT_BUFFER,
+        SET_VS_SHADER_RESOURCE,
+        SET_PS_SHADER_RESOURCE,
+        SET_PS_SAMPLER,
+        SET_PIPELINE_STATE,
+        DRAW,
+        DRAW_INDEXED,
+        DRAW_INDEXED_INSTANCED,
+        PRESENT,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   RenderCommand
+
+      Summary:  One recorded command. Objects are not referenced, they
+                must outlive the recording. Uploaded data is copied to
+                the payload of the command buffer
+
+      Members:  eRenderCommandType Type
+                  Kind of the command
+                UINT uSlot
+                  Register or input slot of a binding
+                ID3D11DeviceChild* pObject
+                  Bound or updated object, nullptr when not used
+                const PipelineState* pPipelineState
+                  Bound pipeline state, nullptr when not used
+                UINT auArgs[4]
+                  Counts, offsets, strides and formats, depending on
+                  the type
+                INT iBaseVertex
+                  Base vertex of a draw
+                FLOAT aValues[4]
+                  Clear color or depth
+                UINT uPayloadOffset
+                  Offset of the uploaded data in the payload
+                UINT uPayloadSize
+                  Size of the uploaded data in bytes
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct RenderCommand
+    {
+        eRenderCommandType Type;
+        UINT uSlot;
+        ID3D11DeviceChild* pObject;
+        const PipelineState* pPipelineState;
+        UINT auArgs[4];
+        INT iBaseVertex;
+        FLOAT aValues[4];
+        UINT uPayloadOffset;
+        UINT uPayloadSize;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    CommandBuffer
+
+      Summary:  Render backend that stores commands instead of
+                executing them. It never touches a device context, so
+                any number of command buffers can be recorded at the
+                same time from different threads, one thread each
+
+      Methods:  BeginFrame
+                  Discards the recorded commands
+                ClearRenderTarget
+                  Records a back buffer clear
+                ClearDepthStencil
+                  Records a depth stencil clear
+                UpdateBuffer
+                  Records a buffer upload and copies its data
+                SetPrimitiveTopology
+                  Records a primitive topology change
+                SetVertexBuffer
+                  Records a vertex buffer binding
+                SetIndexBuffer
+                  Records an index buffer binding
+                SetInputLayout
+                  Records an input layout binding
+                SetVertexShader
+                  Records a vertex shader binding
+                SetPixelShader
+                  Records a pixel shader binding
+                SetVertexShaderConstantBuffer
+                  Records a vertex shader constant buffer binding
+                SetPixelShaderConstantBuffer
+                  Records a pixel shader constant buffer binding
+                SetVertexShaderResource
+                  Records a vertex shader resource view binding
+                SetPixelShaderResource
+                  Records a shader resource view binding
+                SetPixelShaderSampler
+                  Records a sampler binding
+                SetPipelineState
+                  Records a pipeline state binding
+                Draw
+                  Records a non-indexed draw
+                DrawIndexed
+                  Records an indexed draw
+                DrawIndexedInstanced
+                  Records an instanced indexed draw
+                ExecuteCommandBuffers
+                  Appends the commands of other command buffers
+                Present
+                  Records the end of the frame
+                Reset
+                  Discards the recorded commands
+                Replay
+                  Submits the recorded commands to a backend in order
+                GetCommands
+                  Returns the recorded commands
+                GetPayload
+                  Returns the data uploaded by a command
+                GetNumCommands
+                  Returns the number of recorded commands of a type
+                GetNumDrawCalls
+                  Returns the number of recorded draws
+                GetNumIndices
+                  Returns the number of indices drawn, instances
+                  included
+                GetNumUploadedBytes
+                  Returns the number of bytes uploaded
+                CommandBuffer
+                  Constructor.
+                ~CommandBuffer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class CommandBuffer : public RenderBackend
+    {
+    public:
+        CommandBuffer();
+        CommandBuffer(const CommandBuffer& other) = delete;
+        CommandBuffer(CommandBuffer&& other) = delete;
+        CommandBuffer& operator=(const CommandBuffer& other) = delete;
+        CommandBuffer& operator=(CommandBuffer&& other) = delete;
+        virtual ~CommandBuffer() = default;
+
+        void BeginFrame() override;
+        void ClearRenderTarget(_In_ const FLOAT aClearColor[4]) override;
+        void ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil) override;
+        void UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) override;
+
+        void SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology) override;
+        void SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset) override;
+        void SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format) override;
+        void SetInputLayout(_In_ ID3D11InputLayout* pInputLayout) override;
+        void SetVertexShader(_In_ ID3D11VertexShader* pVertexShader) override;
+        void SetPixelShader(_In_ ID3D11PixelShader* pPixelShader) override;
+        void SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState) override;
+        void SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants) override;
+
+        void Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex) override;
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex) override;
+        void DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance) override;
+        void ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers) override;
+
+        void Present() override;
+
+        void Reset();
+        void Replay(_In_ RenderBackend& backend) const;
+
+        const std::vector<RenderCommand>& GetCommands() const;
+        const BYTE* GetPayload(_In_ const RenderCommand& command) const;
+        UINT GetNumCommands(_In_ eRenderCommandType type) const;
+        UINT GetNumDrawCalls() const;
+        UINT64 GetNumIndices() const;
+        UINT64 GetNumUploadedBytes() const;
+
+    private:
+        RenderCommand& record(_In_ eRenderCommandType type, _In_ UINT uSlot, _In_opt_ ID3D11DeviceChild* pObject);
+
+    private:
+        std::vector<RenderCommand> m_aCommands;
+        std::vector<BYTE> m_aPayload;
+        UINT m_auNumCommands[static_cast<size_t>(eRenderCommandType::COUNT)];
+        UINT64 m_uNumIndices;
+    };
+}
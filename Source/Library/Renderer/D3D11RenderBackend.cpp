@@ -0,0 +1,536 @@
+#include "Renderer/D3D11RenderBackend.h"
+
+#include "Renderer/PipelineState.h"
+
+#include <algorithm>
+#include <execution>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::D3D11RenderBackend
+
+      Summary:  Constructor
+
+      Args:     ID3D11DeviceContext* pDeviceContext
+                  Context receiving the commands
+                IDXGISwapChain* pSwapChain
+                  Swap chain to present, may be nullptr
+                ID3D11RenderTargetView* pRenderTargetView
+                  Back buffer view, may be nullptr
+                ID3D11DepthStencilView* pDepthStencilView
+                  Depth stencil view, may be nullptr
+                const D3D11_VIEWPORT& viewport
+                  Viewport bound with the render target
+
+      Modifies: [m_deviceContext, m_swapChain, m_renderTargetView,
+                 m_depthStencilView, m_viewport, m_aDeferredBackends,
+                 m_aCommandLists].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    D3D11RenderBackend::D3D11RenderBackend(
+        _In_ ID3D11DeviceContext* pDeviceContext,
+        _In_opt_ IDXGISwapChain* pSwapChain,
+        _In_opt_ ID3D11RenderTargetView* pRenderTargetView,
+        _In_opt_ ID3D11DepthStencilView* pDepthStencilView,
+        _In_ const D3D11_VIEWPORT& viewport
+    )
+        : m_deviceContext(pDeviceContext)
+        , m_swapChain(pSwapChain)
+        , m_renderTargetView(pRenderTargetView)
+        , m_depthStencilView(pDepthStencilView)
+        , m_viewport(viewport)
+        , m_aDeferredBackends()
+        , m_aCommandLists()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::BeginFrame
+
+      Summary:  Nothing to prepare, the context is always ready
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::BeginFrame()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::ClearRenderTarget
+
+      Summary:  Clears the back buffer
+
+      Args:     const FLOAT aClearColor[4]
+                  RGBA clear color
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::ClearRenderTarget(_In_ const FLOAT aClearColor[4])
+    {
+        if (m_renderTargetView)
+        {
+            m_deviceContext->ClearRenderTargetView(m_renderTargetView.Get(), aClearColor);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::ClearDepthStencil
+
+      Summary:  Clears the depth stencil buffer
+
+      Args:     FLOAT depth
+                  Depth to clear to
+                UINT8 stencil
+                  Stencil value to clear to
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil)
+    {
+        if (m_depthStencilView)
+        {
+            m_deviceContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, depth, stencil);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::UpdateBuffer
+
+      Summary:  Uploads the first bytes of a default usage buffer.
+                Constant buffers are always uploaded whole, since
+                Direct3D 11.0 cannot update part of them. A dynamic
+                buffer is mapped and its previous contents discarded
+
+      Args:     ID3D11Buffer* pBuffer
+                  Buffer to update
+                const void* pData
+                  Source data
+                UINT uSize
+                  Size of the data in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        D3D11_BUFFER_DESC desc;
+        pBuffer->GetDesc(&desc);
+
+        if (desc.Usage == D3D11_USAGE_DYNAMIC)
+        {
+            D3D11_MAPPED_SUBRESOURCE mapped;
+            if (SUCCEEDED(m_deviceContext->Map(pBuffer, 0u, D3D11_MAP_WRITE_DISCARD, 0u, &mapped)))
+            {
+                memcpy(mapped.pData, pData, uSize);
+                m_deviceContext->Unmap(pBuffer, 0u);
+            }
+        }
+        else if (uSize < desc.ByteWidth && !(desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER))
+        {
+            const D3D11_BOX box = {
+                .left = 0u,
+                .top = 0u,
+                .front = 0u,
+                .right = uSize,
+                .bottom = 1u,
+                .back = 1u,
+            };
+            m_deviceContext->UpdateSubresource(pBuffer, 0u, &box, pData, 0u, 0u);
+        }
+        else
+        {
+            m_deviceContext->UpdateSubresource(pBuffer, 0u, nullptr, pData, 0u, 0u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPrimitiveTopology
+
+      Summary:  Sets the primitive topology
+
+      Args:     D3D11_PRIMITIVE_TOPOLOGY topology
+                  Primitive topology
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology)
+    {
+        m_deviceContext->IASetPrimitiveTopology(topology);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetVertexBuffer
+
+      Summary:  Binds a vertex buffer to an input slot
+
+      Args:     UINT uSlot
+                  Input slot
+                ID3D11Buffer* pBuffer
+                  Vertex buffer
+                UINT uStride
+                  Size of an element in bytes
+                UINT uOffset
+                  Offset of the first element in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset)
+    {
+        m_deviceContext->IASetVertexBuffers(uSlot, 1u, &pBuffer, &uStride, &uOffset);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetIndexBuffer
+
+      Summary:  Binds the index buffer
+
+      Args:     ID3D11Buffer* pBuffer
+                  Index buffer
+                DXGI_FORMAT format
+                  Format of the indices
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format)
+    {
+        m_deviceContext->IASetIndexBuffer(pBuffer, format, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetInputLayout
+
+      Summary:  Binds the input layout
+
+      Args:     ID3D11InputLayout* pInputLayout
+                  Input layout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetInputLayout(_In_ ID3D11InputLayout* pInputLayout)
+    {
+        m_deviceContext->IASetInputLayout(pInputLayout);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetVertexShader
+
+      Summary:  Binds the vertex shader
+
+      Args:     ID3D11VertexShader* pVertexShader
+                  Vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetVertexShader(_In_ ID3D11VertexShader* pVertexShader)
+    {
+        m_deviceContext->VSSetShader(pVertexShader, nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPixelShader
+
+      Summary:  Binds the pixel shader
+
+      Args:     ID3D11PixelShader* pPixelShader
+                  Pixel shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPixelShader(_In_ ID3D11PixelShader* pPixelShader)
+    {
+        m_deviceContext->PSSetShader(pPixelShader, nullptr, 0u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetVertexShaderConstantBuffer
+
+      Summary:  Binds a constant buffer to the vertex shader
+
+      Args:     UINT uSlot
+                  Constant buffer register
+                ID3D11Buffer* pBuffer
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        m_deviceContext->VSSetConstantBuffers(uSlot, 1u, &pBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPixelShaderConstantBuffer
+
+      Summary:  Binds a constant buffer to the pixel shader
+
+      Args:     UINT uSlot
+                  Constant buffer register
+                ID3D11Buffer* pBuffer
+                  Constant buffer
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        m_deviceContext->PSSetConstantBuffers(uSlot, 1u, &pBuffer);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetVertexShaderResource
+
+      Summary:  Binds a shader resource view to the vertex shader
+
+      Args:     UINT uSlot
+                  Texture register
+                ID3D11ShaderResourceView* pShaderResourceView
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        m_deviceContext->VSSetShaderResources(uSlot, 1u, &pShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPixelShaderResource
+
+      Summary:  Binds a shader resource view to the pixel shader
+
+      Args:     UINT uSlot
+                  Texture register
+                ID3D11ShaderResourceView* pShaderResourceView
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        m_deviceContext->PSSetShaderResources(uSlot, 1u, &pShaderResourceView);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPixelShaderSampler
+
+      Summary:  Binds a sampler to the pixel shader
+
+      Args:     UINT uSlot
+                  Sampler register
+                ID3D11SamplerState* pSamplerState
+                  Sampler state
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState)
+    {
+        m_deviceContext->PSSetSamplers(uSlot, 1u, &pSamplerState);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::SetPipelineState
+
+      Summary:  Binds the input layout, shaders, sampler and fixed
+                function states of a pipeline state, and the object
+                constant buffer to the stages reading it
+
+      Args:     const PipelineState& pipelineState
+                  Initialized pipeline state
+                ID3D11Buffer* pObjectConstants
+                  Constant buffer of the drawn object, ignored if no
+                  stage reads it
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants)
+    {
+        assert(pipelineState.IsInitialized());
+
+        ID3D11SamplerState* pSamplerState = pipelineState.GetSamplerState();
+
+        m_deviceContext->IASetInputLayout(pipelineState.GetVertexLayout());
+        m_deviceContext->VSSetShader(pipelineState.GetVertexShader(), nullptr, 0u);
+        m_deviceContext->PSSetShader(pipelineState.GetPixelShader(), nullptr, 0u);
+        m_deviceContext->PSSetSamplers(0u, 1u, &pSamplerState);
+        m_deviceContext->RSSetState(pipelineState.GetRasterizerState());
+        m_deviceContext->OMSetBlendState(pipelineState.GetBlendState(), nullptr, 0xFFFFFFFFu);
+        m_deviceContext->OMSetDepthStencilState(pipelineState.GetDepthStencilState(), 0u);
+
+        if (pipelineState.HasVertexShaderObjectConstants())
+        {
+            m_deviceContext->VSSetConstantBuffers(pipelineState.GetObjectConstantsSlot(), 1u, &pObjectConstants);
+        }
+
+        if (pipelineState.HasPixelShaderObjectConstants())
+        {
+            m_deviceContext->PSSetConstantBuffers(pipelineState.GetObjectConstantsSlot(), 1u, &pObjectConstants);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::Draw
+
+      Summary:  Draws non-indexed primitives
+
+      Args:     UINT uVertexCount
+                  Number of vertices to draw
+                UINT uStartVertex
+                  First vertex
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex)
+    {
+        m_deviceContext->Draw(uVertexCount, uStartVertex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::DrawIndexed
+
+      Summary:  Draws indexed primitives
+
+      Args:     UINT uIndexCount
+                  Number of indices to draw
+                UINT uStartIndex
+                  First index
+                INT iBaseVertex
+                  Value added to each index
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex)
+    {
+        m_deviceContext->DrawIndexed(uIndexCount, uStartIndex, iBaseVertex);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::DrawIndexedInstanced
+
+      Summary:  Draws instanced indexed primitives
+
+      Args:     UINT uIndexCount
+                  Number of indices per instance
+                UINT uInstanceCount
+                  Number of instances
+                UINT uStartIndex
+                  First index
+                INT iBaseVertex
+                  Value added to each index
+                UINT uStartInstance
+                  First instance
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance)
+    {
+        m_deviceContext->DrawIndexedInstanced(uIndexCount, uInstanceCount, uStartIndex, iBaseVertex, uStartInstance);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::ExecuteCommandBuffers
+
+      Summary:  Executes command buffers in order. Without deferred
+                contexts they are replayed on the immediate context.
+                Otherwise consecutive command buffers are grouped, each
+                group is translated into a command list on its own
+                deferred context in parallel, and the command lists are
+                executed in order
+
+      Args:     const CommandBuffer* const* apCommandBuffers
+                  Command buffers to execute
+                UINT uNumCommandBuffers
+                  Number of command buffers
+
+      Modifies: [m_aDeferredBackends, m_aCommandLists].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers)
+    {
+        if (m_aDeferredBackends.empty() || uNumCommandBuffers < 2u)
+        {
+            for (UINT i = 0u; i < uNumCommandBuffers; ++i)
+            {
+                apCommandBuffers[i]->Replay(*this);
+            }
+            return;
+        }
+
+        const UINT uNumLists = std::min(uNumCommandBuffers, static_cast<UINT>(m_aDeferredBackends.size()));
+        std::for_each(
+            std::execution::par,
+            m_aDeferredBackends.begin(),
+            m_aDeferredBackends.begin() + uNumLists,
+            [&](const std::unique_ptr<D3D11RenderBackend>& deferredBackend)
+            {
+                const UINT uList = static_cast<UINT>(&deferredBackend - m_aDeferredBackends.data());
+                const UINT uBegin = uList * uNumCommandBuffers / uNumLists;
+                const UINT uEnd = (uList + 1u) * uNumCommandBuffers / uNumLists;
+
+                // Deferred contexts start from the default state
+                bindRenderTarget(deferredBackend->m_deviceContext.Get());
+                for (UINT i = uBegin; i < uEnd; ++i)
+                {
+                    apCommandBuffers[i]->Replay(*deferredBackend);
+                }
+
+                deferredBackend->m_deviceContext->FinishCommandList(FALSE, &m_aCommandLists[uList]);
+            }
+        );
+
+        for (UINT i = 0u; i < uNumLists; ++i)
+        {
+            if (m_aCommandLists[i])
+            {
+                m_deviceContext->ExecuteCommandList(m_aCommandLists[i].Get(), FALSE);
+                m_aCommandLists[i].Reset();
+            }
+        }
+
+        // Executing a command list without restoring the state clears the immediate context
+        bindRenderTarget(m_deviceContext.Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::Present
+
+      Summary:  Presents the back buffer and binds the render target
+                again, since presenting a flip model swap chain unbinds
+                back buffer 0
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::Present()
+    {
+        if (m_swapChain)
+        {
+            m_swapChain->Present(0, 0);
+        }
+
+        bindRenderTarget(m_deviceContext.Get());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::CreateDeferredContexts
+
+      Summary:  Creates the deferred contexts translating command
+                buffers in parallel. Only worth it when the driver
+                supports command lists natively, otherwise the runtime
+                emulates them and replaying is faster
+
+      Args:     ID3D11Device* pDevice
+                  Device owning the immediate context
+                UINT uNumContexts
+                  Number of deferred contexts, 0 to replay command
+                  buffers on the immediate context
+
+      Modifies: [m_aDeferredBackends, m_aCommandLists].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT D3D11RenderBackend::CreateDeferredContexts(_In_ ID3D11Device* pDevice, _In_ UINT uNumContexts)
+    {
+        HRESULT hr = S_OK;
+
+        m_aDeferredBackends.clear();
+        m_aCommandLists.clear();
+
+        for (UINT i = 0u; i < uNumContexts; ++i)
+        {
+            ComPtr<ID3D11DeviceContext> deferredContext;
+            hr = pDevice->CreateDeferredContext(0u, &deferredContext);
+            if (FAILED(hr))
+            {
+                m_aDeferredBackends.clear();
+                return hr;
+            }
+
+            m_aDeferredBackends.push_back(std::make_unique<D3D11RenderBackend>(
+                deferredContext.Get(),
+                nullptr,
+                m_renderTargetView.Get(),
+                m_depthStencilView.Get(),
+                m_viewport
+            ));
+        }
+
+        m_aCommandLists.resize(uNumContexts);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   D3D11RenderBackend::bindRenderTarget
+
+      Summary:  Binds the render target, the depth stencil and the
+                viewport to a context
+
+      Args:     ID3D11DeviceContext* pDeviceContext
+                  Immediate or deferred context
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void D3D11RenderBackend::bindRenderTarget(_In_ ID3D11DeviceContext* pDeviceContext) const
+    {
+        if (m_renderTargetView)
+        {
+            pDeviceContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+            pDeviceContext->RSSetViewports(1, &m_viewport);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/*+===================================================================
+  File:      D3D11RENDERBACKEND.H
+
+  Summary:   D3D11RenderBackend header file contains declarations of
+             the render backend submitting commands to a Direct3D 11
+             device context.
+
+  Classes: D3D11RenderBackend
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    D3D11RenderBackend
+
+      Summary:  Forwards every command to a Direct3D 11 device context
+                and presents through the swap chain. Command buffers
+                are replayed on the immediate context, or translated in
+                parallel on deferred contexts when they are created
+
+      Methods:  BeginFrame
+                  Does nothing
+                ClearRenderTarget
+                  Clears the back buffer
+                ClearDepthStencil
+                  Clears the depth stencil buffer
+                UpdateBuffer
+                  Calls UpdateSubresource on the buffer
+                SetPrimitiveTopology
+                  Sets the primitive topology
+                SetVertexBuffer
+                  Binds a vertex buffer to an input slot
+                SetIndexBuffer
+                  Binds the index buffer
+                SetInputLayout
+                  Binds the input layout
+                SetVertexShader
+                  Binds the vertex shader
+                SetPixelShader
+                  Binds the pixel shader
+                SetVertexShaderConstantBuffer
+                  Binds a constant buffer to the vertex shader
+                SetPixelShaderConstantBuffer
+                  Binds a constant buffer to the pixel shader
+                SetVertexShaderResource
+                  Binds a shader resource view to the vertex shader
+                SetPixelShaderResource
+                  Binds a shader resource view to the pixel shader
+                SetPixelShaderSampler
+                  Binds a sampler to the pixel shader
+                SetPipelineState
+                  Binds every state of a pipeline state and the object
+                  constant buffer
+                Draw
+                  Draws non-indexed primitives
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instanced indexed primitives
+                ExecuteCommandBuffers
+                  Replays command buffers, or executes the command lists
+                  built from them on deferred contexts
+                CreateDeferredContexts
+                  Creates the deferred contexts used to translate
+                  command buffers in parallel
+                Present
+                  Presents the back buffer and binds it again
+                D3D11RenderBackend
+                  Constructor.
+                ~D3D11RenderBackend
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class D3D11RenderBackend final : public RenderBackend
+    {
+    public:
+        D3D11RenderBackend(
+            _In_ ID3D11DeviceContext* pDeviceContext,
+            _In_opt_ IDXGISwapChain* pSwapChain,
+            _In_opt_ ID3D11RenderTargetView* pRenderTargetView,
+            _In_opt_ ID3D11DepthStencilView* pDepthStencilView,
+            _In_ const D3D11_VIEWPORT& viewport
+        );
+        D3D11RenderBackend(const D3D11RenderBackend& other) = delete;
+        D3D11RenderBackend(D3D11RenderBackend&& other) = delete;
+        D3D11RenderBackend& operator=(const D3D11RenderBackend& other) = delete;
+        D3D11RenderBackend& operator=(D3D11RenderBackend&& other) = delete;
+        ~D3D11RenderBackend() = default;
+
+        void BeginFrame() override;
+        void ClearRenderTarget(_In_ const FLOAT aClearColor[4]) override;
+        void ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil) override;
+        void UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) override;
+
+        void SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology) override;
+        void SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset) override;
+        void SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format) override;
+        void SetInputLayout(_In_ ID3D11InputLayout* pInputLayout) override;
+        void SetVertexShader(_In_ ID3D11VertexShader* pVertexShader) override;
+        void SetPixelShader(_In_ ID3D11PixelShader* pPixelShader) override;
+        void SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState) override;
+        void SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants) override;
+
+        void Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex) override;
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex) override;
+        void DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance) override;
+        void ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers) override;
+
+        void Present() override;
+
+        HRESULT CreateDeferredContexts(_In_ ID3D11Device* pDevice, _In_ UINT uNumContexts);
+
+    private:
+        void bindRenderTarget(_In_ ID3D11DeviceContext* pDeviceContext) const;
+
+    private:
+        ComPtr<ID3D11DeviceContext> m_deviceContext;
+        ComPtr<IDXGISwapChain> m_swapChain;
+        ComPtr<ID3D11RenderTargetView> m_renderTargetView;
+        ComPtr<ID3D11DepthStencilView> m_depthStencilView;
+        D3D11_VIEWPORT m_viewport;
+        std::vector<std::unique_ptr<D3D11RenderBackend>> m_aDeferredBackends;
+        std::vector<ComPtr<ID3D11CommandList>> m_aCommandLists;
+    };
+}
@@ -2,22 +2,41 @@
 
 #include "Common.h"
 
+#include "Renderer/GeometryTypes.h"
+
 namespace library
 {
-#define NUM_LIGHTS (2)
+// Must match Shaders/LightClusters.fxh of the game
+#define NUM_CLUSTERS_X (16)
+#define NUM_CLUSTERS_Y (9)
+#define NUM_CLUSTERS_Z (24)
+#define NUM_CLUSTERS (NUM_CLUSTERS_X * NUM_CLUSTERS_Y * NUM_CLUSTERS_Z)
+#define MAX_NUM_CLUSTER_LIGHT_INDICES (NUM_CLUSTERS * 32)
 #define MAX_NUM_BONES (256)
 #define MAX_NUM_BONES_PER_VERTEX (16)
 
-	struct SimpleVertex
+	struct InstanceData
 	{
-		XMFLOAT3 Position;
-		XMFLOAT2 TexCoord;
-		XMFLOAT3 Normal;
+		XMMATRIX Transformation;
 	};
 
-	struct InstanceData
+	struct RenderableInstanceData
 	{
-		XMMATRIX Transformation;
+		XMMATRIX World;
+		XMFLOAT4 OutputColor;
+	};
+
+	struct CrowdInstanceData
+	{
+		XMMATRIX World;
+		UINT uBoneOffset;
+		UINT auPadding[3];
+	};
+
+	struct DebugVertex
+	{
+		XMFLOAT3 Position;
+		UINT uColor;
 	};
 
 	struct AnimationData
@@ -43,15 +62,21 @@ namespace library
 		XMFLOAT4 OutputColor;
 	};
 
-	struct CBSkinning
+	struct CBDebugDraw
+	{
+		XMMATRIX ViewProjection;
+	};
+
+	struct PointLightData
 	{
-		XMMATRIX BoneTransforms[MAX_NUM_BONES];
+		XMFLOAT4 Position;
+		XMFLOAT4 Color;
 	};
 
 	struct CBLights
 	{
-		XMFLOAT4 LightPositions[NUM_LIGHTS];
-		XMFLOAT4 LightColors[NUM_LIGHTS];
+		XMFLOAT4 ClusterScale;
+		XMUINT4 NumLights;
 	};
 
 }
\ No newline at end of file
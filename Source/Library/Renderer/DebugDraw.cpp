@@ -0,0 +1,535 @@
+#include "Renderer/DebugDraw.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::DebugDraw
+
+      Summary:  Constructor, the debug drawing starts disabled
+
+      Modifies: [m_bEnabled, m_pipelineState, m_aVertexBuffers,
+                 m_constantBuffer, m_aaVertices, m_auNumVertices,
+                 m_uNumDropped, m_uNumDroppedLastFrame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DebugDraw::DebugDraw()
+        : m_bEnabled(FALSE)
+        , m_pipelineState()
+        , m_aVertexBuffers()
+        , m_constantBuffer()
+        , m_aaVertices()
+        , m_auNumVertices()
+        , m_uNumDropped(0u)
+        , m_uNumDroppedLastFrame(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::Initialize
+
+      Summary:  Creates one dynamic vertex buffer of MAX_NUM_VERTICES
+                per primitive type, their copies on the CPU, and the
+                constant buffer of the view projection
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+
+      Modifies: [m_aVertexBuffers, m_constantBuffer, m_aaVertices].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT DebugDraw::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        D3D11_BUFFER_DESC vertexBufferDesc = {
+            .ByteWidth = MAX_NUM_VERTICES * static_cast<UINT>(sizeof(DebugVertex)),
+            .Usage = D3D11_USAGE_DYNAMIC,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = D3D11_CPU_ACCESS_WRITE,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        for (size_t i = 0u; i < static_cast<size_t>(eDebugPrimitiveType::COUNT); ++i)
+        {
+            hr = pDevice->CreateBuffer(&vertexBufferDesc, nullptr, m_aVertexBuffers[i].ReleaseAndGetAddressOf());
+            if (FAILED(hr))
+                return hr;
+        }
+
+        D3D11_BUFFER_DESC constantBufferDesc = {
+            .ByteWidth = sizeof(CBDebugDraw),
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+            .CPUAccessFlags = 0,
+            .MiscFlags = 0,
+            .StructureByteStride = 0
+        };
+
+        hr = pDevice->CreateBuffer(&constantBufferDesc, nullptr, m_constantBuffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        // The vertices are reserved by index, so the storage never grows while threads write to it
+        for (std::vector<DebugVertex>& aVertices : m_aaVertices)
+        {
+            aVertices.resize(MAX_NUM_VERTICES);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::SetEnabled
+
+      Summary:  Enables or disables the debug drawing. Disabling drops
+                the primitives added so far
+
+      Args:     BOOL bEnabled
+                  Whether primitives are accumulated and drawn
+
+      Modifies: [m_bEnabled, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::SetEnabled(_In_ BOOL bEnabled)
+    {
+        m_bEnabled.store(bEnabled, std::memory_order_relaxed);
+
+        if (!bEnabled)
+        {
+            for (std::atomic<UINT>& uNumVertices : m_auNumVertices)
+            {
+                uNumVertices.store(0u, std::memory_order_relaxed);
+            }
+            m_uNumDropped.store(0u, std::memory_order_relaxed);
+        }
+    }
+
+    BOOL DebugDraw::IsEnabled() const
+    {
+        return m_bEnabled.load(std::memory_order_relaxed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::SetPipelineState
+
+      Summary:  Sets the pipeline state of the draws. Its vertex shader
+                must read DebugVertex and its object constants are the
+                view projection of CBDebugDraw
+
+      Args:     const std::shared_ptr<PipelineState>& pipelineState
+                  Pipeline state of the draws
+
+      Modifies: [m_pipelineState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState)
+    {
+        m_pipelineState = pipelineState;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddLine
+
+      Summary:  Adds a line
+
+      Args:     const XMFLOAT3& start
+                  Start of the line in world space
+                const XMFLOAT3& end
+                  End of the line in world space
+                const XMFLOAT4& color
+                  Color of the line
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddLine(_In_ const XMFLOAT3& start, _In_ const XMFLOAT3& end, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        DebugVertex* pVertices = reserve(eDebugPrimitiveType::LINES, 2u);
+        if (!pVertices)
+        {
+            return;
+        }
+
+        const UINT uColor = packColor(color);
+        pVertices[0] = DebugVertex{ .Position = start, .uColor = uColor };
+        pVertices[1] = DebugVertex{ .Position = end, .uColor = uColor };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddRay
+
+      Summary:  Adds a line from an origin along a direction
+
+      Args:     const XMFLOAT3& origin
+                  Origin of the ray in world space
+                const XMFLOAT3& direction
+                  Direction of the ray, normalized here
+                FLOAT length
+                  Length of the drawn line
+                const XMFLOAT4& color
+                  Color of the ray
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddRay(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT length, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        XMFLOAT3 end;
+        XMStoreFloat3(&end, XMLoadFloat3(&origin) + XMVector3Normalize(XMLoadFloat3(&direction)) * length);
+
+        AddLine(origin, end, color);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddBox
+
+      Summary:  Adds the 12 edges of an axis aligned box
+
+      Args:     const AxisAlignedBox& box
+                  Box in world space
+                const XMFLOAT4& color
+                  Color of the edges
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddBox(_In_ const AxisAlignedBox& box, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        XMFLOAT3 aCorners[8];
+        getCorners(box, aCorners);
+
+        addEdges(aCorners, color);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddSolidBox
+
+      Summary:  Adds the 6 faces of an axis aligned box as 12 triangles
+
+      Args:     const AxisAlignedBox& box
+                  Box in world space
+                const XMFLOAT4& color
+                  Color of the faces
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddSolidBox(_In_ const AxisAlignedBox& box, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        DebugVertex* pVertices = reserve(eDebugPrimitiveType::TRIANGLES, 36u);
+        if (!pVertices)
+        {
+            return;
+        }
+
+        XMFLOAT3 aCorners[8];
+        getCorners(box, aCorners);
+
+        const UINT uColor = packColor(color);
+
+        // A face keeps one bit of the corner index fixed, its corners go around the two other bits
+        for (UINT uAxis = 0u; uAxis < 3u; ++uAxis)
+        {
+            const UINT uFixed = 1u << uAxis;
+            const UINT uU = 1u << ((uAxis + 1u) % 3u);
+            const UINT uV = 1u << ((uAxis + 2u) % 3u);
+
+            for (UINT uSide : { 0u, uFixed })
+            {
+                const UINT auFace[6] = { uSide, uSide | uU, uSide | uU | uV, uSide, uSide | uU | uV, uSide | uV };
+                for (UINT uCorner : auFace)
+                {
+                    *pVertices++ = DebugVertex{ .Position = aCorners[uCorner], .uColor = uColor };
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddFrustum
+
+      Summary:  Adds the 12 edges of the frustum of a view projection,
+                its corners are the clip space corners transformed back
+                to world space
+
+      Args:     FXMMATRIX viewProjection
+                  View projection of the frustum
+                const XMFLOAT4& color
+                  Color of the edges
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddFrustum(_In_ FXMMATRIX viewProjection, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        const XMMATRIX inverseViewProjection = XMMatrixInverse(nullptr, viewProjection);
+
+        XMFLOAT3 aCorners[8];
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            const XMVECTOR clipCorner = XMVectorSet(
+                (i & 1u) ? 1.0f : -1.0f,
+                (i & 2u) ? 1.0f : -1.0f,
+                (i & 4u) ? 1.0f : 0.0f,
+                1.0f
+            );
+            XMStoreFloat3(&aCorners[i], XMVector3TransformCoord(clipCorner, inverseViewProjection));
+        }
+
+        addEdges(aCorners, color);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::AddTriangle
+
+      Summary:  Adds a triangle, drawn from both sides
+
+      Args:     const XMFLOAT3& a
+                  First corner in world space
+                const XMFLOAT3& b
+                  Second corner in world space
+                const XMFLOAT3& c
+                  Third corner in world space
+                const XMFLOAT4& color
+                  Color of the triangle
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::AddTriangle(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b, _In_ const XMFLOAT3& c, _In_ const XMFLOAT4& color)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        DebugVertex* pVertices = reserve(eDebugPrimitiveType::TRIANGLES, 3u);
+        if (!pVertices)
+        {
+            return;
+        }
+
+        const UINT uColor = packColor(color);
+        pVertices[0] = DebugVertex{ .Position = a, .uColor = uColor };
+        pVertices[1] = DebugVertex{ .Position = b, .uColor = uColor };
+        pVertices[2] = DebugVertex{ .Position = c, .uColor = uColor };
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::Flush
+
+      Summary:  Uploads the primitives of the frame and draws each
+                primitive type with one draw, then clears them. Must not
+                run while other threads add primitives
+
+      Args:     RenderBackend& backend
+                  Backend receiving the commands
+                FXMMATRIX viewProjection
+                  View projection of the camera
+
+      Modifies: [m_auNumVertices, m_uNumDropped,
+                 m_uNumDroppedLastFrame].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::Flush(_In_ RenderBackend& backend, _In_ FXMMATRIX viewProjection)
+    {
+        if (!IsEnabled())
+        {
+            return;
+        }
+
+        m_uNumDroppedLastFrame = m_uNumDropped.exchange(0u, std::memory_order_relaxed);
+
+        UINT auNumVertices[static_cast<size_t>(eDebugPrimitiveType::COUNT)];
+        UINT uTotalVertices = 0u;
+        for (size_t i = 0u; i < static_cast<size_t>(eDebugPrimitiveType::COUNT); ++i)
+        {
+            auNumVertices[i] = m_auNumVertices[i].exchange(0u, std::memory_order_relaxed);
+            uTotalVertices += auNumVertices[i];
+        }
+
+        if (uTotalVertices == 0u || !m_pipelineState || !m_pipelineState->IsInitialized() || !m_constantBuffer)
+        {
+            return;
+        }
+
+        const CBDebugDraw cbDebugDraw = {
+            .ViewProjection = XMMatrixTranspose(viewProjection),
+        };
+        backend.UpdateBuffer(m_constantBuffer.Get(), &cbDebugDraw, sizeof(cbDebugDraw));
+
+        backend.SetPipelineState(*m_pipelineState, m_constantBuffer.Get());
+
+        static constexpr D3D11_PRIMITIVE_TOPOLOGY aTopologies[] =
+        {
+            D3D11_PRIMITIVE_TOPOLOGY_LINELIST,
+            D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST,
+        };
+        static_assert(ARRAYSIZE(aTopologies) == static_cast<size_t>(eDebugPrimitiveType::COUNT));
+
+        for (size_t i = 0u; i < static_cast<size_t>(eDebugPrimitiveType::COUNT); ++i)
+        {
+            if (auNumVertices[i] == 0u)
+            {
+                continue;
+            }
+
+            backend.UpdateBuffer(m_aVertexBuffers[i].Get(), m_aaVertices[i].data(), auNumVertices[i] * static_cast<UINT>(sizeof(DebugVertex)));
+            backend.SetPrimitiveTopology(aTopologies[i]);
+            backend.SetVertexBuffer(0u, m_aVertexBuffers[i].Get(), sizeof(DebugVertex), 0u);
+            backend.Draw(auNumVertices[i], 0u);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::GetNumDroppedPrimitives
+
+      Summary:  Returns the number of primitives dropped in the last
+                flushed frame because the cap was reached
+
+      Returns:  UINT
+                  Number of dropped lines, boxes, frusta and triangles
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT DebugDraw::GetNumDroppedPrimitives() const
+    {
+        return m_uNumDroppedLastFrame;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::reserve
+
+      Summary:  Reserves consecutive vertices of a primitive type. The
+                counter never passes the cap, so the vertices below it
+                are always written by a successful reservation
+
+      Args:     eDebugPrimitiveType type
+                  Primitive type of the vertices
+                UINT uNumVertices
+                  Number of vertices to reserve
+
+      Modifies: [m_auNumVertices, m_uNumDropped].
+
+      Returns:  DebugVertex*
+                  The reserved vertices, nullptr when the cap is reached
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    DebugVertex* DebugDraw::reserve(_In_ eDebugPrimitiveType type, _In_ UINT uNumVertices)
+    {
+        std::vector<DebugVertex>& aVertices = m_aaVertices[static_cast<size_t>(type)];
+        std::atomic<UINT>& uCount = m_auNumVertices[static_cast<size_t>(type)];
+
+        UINT uStart = uCount.load(std::memory_order_relaxed);
+        do
+        {
+            if (uStart + uNumVertices > aVertices.size())
+            {
+                m_uNumDropped.fetch_add(1u, std::memory_order_relaxed);
+                return nullptr;
+            }
+        } while (!uCount.compare_exchange_weak(uStart, uStart + uNumVertices, std::memory_order_relaxed));
+
+        return aVertices.data() + uStart;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::addEdges
+
+      Summary:  Adds the 12 edges of a box given by its corners. The
+                bits 0, 1 and 2 of the index of a corner select its far
+                side along x, y and z
+
+      Args:     const XMFLOAT3* aCorners
+                  The 8 corners
+                const XMFLOAT4& color
+                  Color of the edges
+
+      Modifies: [m_aaVertices, m_auNumVertices, m_uNumDropped].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::addEdges(_In_reads_(8) const XMFLOAT3* aCorners, _In_ const XMFLOAT4& color)
+    {
+        DebugVertex* pVertices = reserve(eDebugPrimitiveType::LINES, 24u);
+        if (!pVertices)
+        {
+            return;
+        }
+
+        const UINT uColor = packColor(color);
+
+        // Each edge joins two corners whose indices differ by one bit
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            for (UINT uBit = 1u; uBit < 8u; uBit <<= 1u)
+            {
+                if (!(i & uBit))
+                {
+                    *pVertices++ = DebugVertex{ .Position = aCorners[i], .uColor = uColor };
+                    *pVertices++ = DebugVertex{ .Position = aCorners[i | uBit], .uColor = uColor };
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::packColor
+
+      Summary:  Packs a color into the R8G8B8A8_UNORM of DebugVertex
+
+      Args:     const XMFLOAT4& color
+                  Color, clamped to [0, 1]
+
+      Returns:  UINT
+                  Packed color, red in the lowest byte
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT DebugDraw::packColor(_In_ const XMFLOAT4& color)
+    {
+        const auto toByte = [](FLOAT value)
+        {
+            return static_cast<UINT>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+
+        return toByte(color.x) | (toByte(color.y) << 8u) | (toByte(color.z) << 16u) | (toByte(color.w) << 24u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   DebugDraw::getCorners
+
+      Summary:  Returns the corners of a box, the bits 0, 1 and 2 of
+                the index of a corner select its maximum along x, y
+                and z
+
+      Args:     const AxisAlignedBox& box
+                  Box
+                XMFLOAT3* aCorners
+                  Receives the 8 corners
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void DebugDraw::getCorners(_In_ const AxisAlignedBox& box, _Out_writes_(8) XMFLOAT3* aCorners)
+    {
+        for (UINT i = 0u; i < 8u; ++i)
+        {
+            aCorners[i] = XMFLOAT3(
+                (i & 1u) ? box.Max.x : box.Min.x,
+                (i & 2u) ? box.Max.y : box.Min.y,
+                (i & 4u) ? box.Max.z : box.Min.z
+            );
+        }
+    }
+}
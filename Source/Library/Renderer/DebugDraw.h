@@ -0,0 +1,124 @@
+/*+===================================================================
+  File:      DEBUGDRAW.H
+
+  Summary:   DebugDraw header file contains declarations of the
+             immediate mode drawing of lines, boxes and frusta used to
+             visualize culling, levels of detail and streaming.
+
+  Classes: DebugDraw
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eDebugPrimitiveType
+
+      Summary:  Kind of the primitives of the debug drawing, each kind
+                is flushed with one draw
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eDebugPrimitiveType : BYTE
+    {
+        LINES,
+        TRIANGLES,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DebugDraw
+
+      Summary:  Accumulates world space lines and triangles during a
+                frame, then uploads them to one dynamic vertex buffer
+                per primitive type and draws each buffer at once. Any
+                thread may add primitives, they reserve their vertices
+                with an atomic counter. Primitives past the per frame
+                cap are dropped and counted. When disabled, adding
+                returns at once and nothing is uploaded or drawn
+
+      Methods:  Initialize
+                  Creates the vertex buffers and the constant buffer
+                SetEnabled
+                  Enables or disables the debug drawing
+                IsEnabled
+                  Returns whether the debug drawing is enabled
+                SetPipelineState
+                  Sets the pipeline state of the draws
+                AddLine
+                  Adds a line
+                AddRay
+                  Adds a ray of a given length
+                AddBox
+                  Adds the edges of an axis aligned box
+                AddSolidBox
+                  Adds the faces of an axis aligned box
+                AddFrustum
+                  Adds the edges of the frustum of a view projection
+                AddTriangle
+                  Adds a triangle
+                Flush
+                  Draws the primitives of the frame and clears them
+                GetNumDroppedPrimitives
+                  Returns the primitives dropped in the last frame
+                DebugDraw
+                  Constructor.
+                ~DebugDraw
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DebugDraw final
+    {
+    public:
+        static constexpr UINT MAX_NUM_VERTICES = 1u << 17u;
+
+    public:
+        DebugDraw();
+        DebugDraw(const DebugDraw& other) = delete;
+        DebugDraw(DebugDraw&& other) = delete;
+        DebugDraw& operator=(const DebugDraw& other) = delete;
+        DebugDraw& operator=(DebugDraw&& other) = delete;
+        ~DebugDraw() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+
+        void SetEnabled(_In_ BOOL bEnabled);
+        BOOL IsEnabled() const;
+        void SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState);
+
+        void AddLine(_In_ const XMFLOAT3& start, _In_ const XMFLOAT3& end, _In_ const XMFLOAT4& color);
+        void AddRay(_In_ const XMFLOAT3& origin, _In_ const XMFLOAT3& direction, _In_ FLOAT length, _In_ const XMFLOAT4& color);
+        void AddBox(_In_ const AxisAlignedBox& box, _In_ const XMFLOAT4& color);
+        void AddSolidBox(_In_ const AxisAlignedBox& box, _In_ const XMFLOAT4& color);
+        void AddFrustum(_In_ FXMMATRIX viewProjection, _In_ const XMFLOAT4& color);
+        void AddTriangle(_In_ const XMFLOAT3& a, _In_ const XMFLOAT3& b, _In_ const XMFLOAT3& c, _In_ const XMFLOAT4& color);
+
+        void Flush(_In_ RenderBackend& backend, _In_ FXMMATRIX viewProjection);
+
+        UINT GetNumDroppedPrimitives() const;
+
+    private:
+        DebugVertex* reserve(_In_ eDebugPrimitiveType type, _In_ UINT uNumVertices);
+        void addEdges(_In_reads_(8) const XMFLOAT3* aCorners, _In_ const XMFLOAT4& color);
+
+        static UINT packColor(_In_ const XMFLOAT4& color);
+        static void getCorners(_In_ const AxisAlignedBox& box, _Out_writes_(8) XMFLOAT3* aCorners);
+
+    private:
+        std::atomic<BOOL> m_bEnabled;
+        std::shared_ptr<PipelineState> m_pipelineState;
+        ComPtr<ID3D11Buffer> m_aVertexBuffers[static_cast<size_t>(eDebugPrimitiveType::COUNT)];
+        ComPtr<ID3D11Buffer> m_constantBuffer;
+        std::vector<DebugVertex> m_aaVertices[static_cast<size_t>(eDebugPrimitiveType::COUNT)];
+        std::atomic<UINT> m_auNumVertices[static_cast<size_t>(eDebugPrimitiveType::COUNT)];
+        std::atomic<UINT> m_uNumDropped;
+        UINT m_uNumDroppedLastFrame;
+    };
+}
@@ -0,0 +1,673 @@
+#include "Renderer/FrameGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <queue>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::FrameGraph
+
+      Summary:  Constructor
+
+      Modifies: [m_aTextures, m_aHandles, m_aPasses, m_auExecutionOrder,
+                 m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FrameGraph::FrameGraph()
+        : m_aTextures()
+        , m_aHandles()
+        , m_aPasses()
+        , m_auExecutionOrder()
+        , m_stats()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Reset
+
+      Summary:  Removes every pass and texture, so the graph can be
+                declared again
+
+      Modifies: [m_aTextures, m_aHandles, m_aPasses, m_auExecutionOrder,
+                 m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Reset()
+    {
+        m_aTextures.clear();
+        m_aHandles.clear();
+        m_aPasses.clear();
+        m_auExecutionOrder.clear();
+        m_stats = FrameGraphStats();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::ImportTexture
+
+      Summary:  Adds a texture owned outside of the graph, like the back
+                buffer. It takes no transient memory, and the passes
+                writing it are never culled
+
+      Args:     const wchar_t* pszName
+                  Name of the texture
+                const FrameGraphTextureDesc& desc
+                  Description of the texture
+
+      Modifies: [m_aTextures, m_aHandles].
+
+      Returns:  std::uint32_t
+                  Handle of the first version of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t FrameGraph::ImportTexture(const wchar_t* pszName, const FrameGraphTextureDesc& desc)
+    {
+        const std::uint32_t uHandle = CreateTexture(pszName, desc);
+        m_aTextures.back().bImported = true;
+
+        return uHandle;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::CreateTexture
+
+      Summary:  Adds a transient texture, which only needs memory
+                between the first and the last pass using it
+
+      Args:     const wchar_t* pszName
+                  Name of the texture
+                const FrameGraphTextureDesc& desc
+                  Description of the texture
+
+      Modifies: [m_aTextures, m_aHandles].
+
+      Returns:  std::uint32_t
+                  Handle of the first version of the texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t FrameGraph::CreateTexture(const wchar_t* pszName, const FrameGraphTextureDesc& desc)
+    {
+        m_aTextures.push_back(
+            FrameGraphTexture{
+                .pszName = pszName,
+                .Desc = desc,
+                .bImported = false,
+                .uSize = 0u,
+                .uOffset = 0u,
+                .uFirstUse = INVALID_INDEX,
+                .uLastUse = INVALID_INDEX,
+            }
+        );
+        m_aHandles.push_back(
+            FrameGraphHandle{
+                .uTexture = static_cast<std::uint32_t>(m_aTextures.size() - 1u),
+                .uProducer = INVALID_INDEX,
+                .uPrevious = INVALID_INDEX,
+                .auReaders = std::vector<std::uint32_t>(),
+            }
+        );
+
+        return static_cast<std::uint32_t>(m_aHandles.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::AddPass
+
+      Summary:  Adds a pass. Its inputs and outputs are declared
+                afterward with Read and Write
+
+      Args:     const wchar_t* pszName
+                  Name of the pass
+                ExecuteCallback execute
+                  Records the commands of the pass
+
+      Modifies: [m_aPasses].
+
+      Returns:  std::uint32_t
+                  Index of the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t FrameGraph::AddPass(const wchar_t* pszName, ExecuteCallback execute)
+    {
+        m_aPasses.push_back(
+            FrameGraphPass{
+                .pszName = pszName,
+                .Execute = std::move(execute),
+                .auReads = std::vector<std::uint32_t>(),
+                .auWrites = std::vector<std::uint32_t>(),
+                .bSideEffect = false,
+                .bCulled = false,
+            }
+        );
+
+        return static_cast<std::uint32_t>(m_aPasses.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Read
+
+      Summary:  Declares that a pass reads a version of a texture, so it
+                runs after the pass that wrote this version
+
+      Args:     std::uint32_t uPass
+                  Index of the reading pass
+                std::uint32_t uHandle
+                  Version of the texture read
+
+      Modifies: [m_aHandles, m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Read(std::uint32_t uPass, std::uint32_t uHandle)
+    {
+        assert(uPass < m_aPasses.size() && uHandle < m_aHandles.size());
+
+        m_aPasses[uPass].auReads.push_back(uHandle);
+        m_aHandles[uHandle].auReaders.push_back(uPass);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Write
+
+      Summary:  Declares that a pass writes over a version of a texture.
+                The previous content is kept, so the pass also reads
+                the given version
+
+      Args:     std::uint32_t uPass
+                  Index of the writing pass
+                std::uint32_t uHandle
+                  Version of the texture written over
+
+      Modifies: [m_aHandles, m_aPasses].
+
+      Returns:  std::uint32_t
+                  Handle of the version written by the pass
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t FrameGraph::Write(std::uint32_t uPass, std::uint32_t uHandle)
+    {
+        Read(uPass, uHandle);
+
+        m_aHandles.push_back(
+            FrameGraphHandle{
+                .uTexture = m_aHandles[uHandle].uTexture,
+                .uProducer = uPass,
+                .uPrevious = uHandle,
+                .auReaders = std::vector<std::uint32_t>(),
+            }
+        );
+
+        const std::uint32_t uNewHandle = static_cast<std::uint32_t>(m_aHandles.size() - 1u);
+        m_aPasses[uPass].auWrites.push_back(uNewHandle);
+
+        return uNewHandle;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::SetSideEffect
+
+      Summary:  Keeps a pass even when none of its outputs is used,
+                like the pass presenting the frame
+
+      Args:     std::uint32_t uPass
+                  Index of the pass
+
+      Modifies: [m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::SetSideEffect(std::uint32_t uPass)
+    {
+        assert(uPass < m_aPasses.size());
+
+        m_aPasses[uPass].bSideEffect = true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Compile
+
+      Summary:  Culls the passes whose outputs are never used, orders
+                the others, then computes the lifetime and the place in
+                the aliased heap of every transient texture
+
+      Modifies: [m_aTextures, m_aPasses, m_auExecutionOrder, m_stats].
+
+      Returns:  bool
+                  false when the dependencies form a cycle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool FrameGraph::Compile()
+    {
+        cullPasses();
+
+        if (!orderPasses())
+        {
+            return false;
+        }
+
+        computeLifetimes();
+        planMemory();
+
+        m_stats.uNumPasses = static_cast<std::uint32_t>(m_aPasses.size());
+        m_stats.uNumCulledPasses = static_cast<std::uint32_t>(m_aPasses.size() - m_auExecutionOrder.size());
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::Execute
+
+      Summary:  Runs the kept passes in execution order
+
+      Args:     RenderBackend& backend
+                  Backend receiving the commands of the passes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::Execute(RenderBackend& backend) const
+    {
+        for (std::uint32_t uPass : m_auExecutionOrder)
+        {
+            if (m_aPasses[uPass].Execute)
+            {
+                m_aPasses[uPass].Execute(backend);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::IsPassCulled
+
+      Summary:  Returns whether the last compilation culled a pass
+
+      Args:     std::uint32_t uPass
+                  Index of the pass
+
+      Returns:  bool
+                  true when the pass is not executed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool FrameGraph::IsPassCulled(std::uint32_t uPass) const
+    {
+        return m_aPasses[uPass].bCulled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetExecutionOrder
+
+      Summary:  Returns the kept passes in execution order
+
+      Returns:  const std::vector<std::uint32_t>&
+                  Indices of the passes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<std::uint32_t>& FrameGraph::GetExecutionOrder() const
+    {
+        return m_auExecutionOrder;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetTextureOffset
+
+      Summary:  Returns the offset of a transient texture in the aliased
+                heap. Textures alive at the same time never overlap
+
+      Args:     std::uint32_t uHandle
+                  Any version of the texture
+
+      Returns:  std::uint64_t
+                  Offset in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint64_t FrameGraph::GetTextureOffset(std::uint32_t uHandle) const
+    {
+        return m_aTextures[m_aHandles[uHandle].uTexture].uOffset;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetTextureSize
+
+      Summary:  Returns the memory reserved for a transient texture in
+                the aliased heap
+
+      Args:     std::uint32_t uHandle
+                  Any version of the texture
+
+      Returns:  std::uint64_t
+                  Size in bytes, 0 for imported textures and textures
+                  only used by culled passes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint64_t FrameGraph::GetTextureSize(std::uint32_t uHandle) const
+    {
+        return m_aTextures[m_aHandles[uHandle].uTexture].uSize;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetStats
+
+      Summary:  Returns the result of the last compilation
+
+      Returns:  const FrameGraphStats&
+                  Pass counts and transient memory
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const FrameGraphStats& FrameGraph::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::GetTextureMemory
+
+      Summary:  Estimates the memory of a texture, rounded up to the
+                placement alignment of a heap
+
+      Args:     const FrameGraphTextureDesc& desc
+                  Description of the texture
+
+      Returns:  std::uint64_t
+                  Size in bytes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint64_t FrameGraph::GetTextureMemory(const FrameGraphTextureDesc& desc)
+    {
+        std::uint64_t uBytesPerTexel = 4u;
+        switch (desc.Format)
+        {
+        case eFrameGraphFormat::R8_UNORM:
+            uBytesPerTexel = 1u;
+            break;
+
+        case eFrameGraphFormat::R16_FLOAT:
+        case eFrameGraphFormat::D16_UNORM:
+            uBytesPerTexel = 2u;
+            break;
+
+        case eFrameGraphFormat::R16G16B16A16_FLOAT:
+        case eFrameGraphFormat::R32G32_FLOAT:
+        case eFrameGraphFormat::D32_FLOAT_S8X24_UINT:
+            uBytesPerTexel = 8u;
+            break;
+
+        case eFrameGraphFormat::R32G32B32A32_FLOAT:
+            uBytesPerTexel = 16u;
+            break;
+
+        default:
+            break;
+        }
+
+        const std::uint64_t uSize = static_cast<std::uint64_t>(desc.uWidth) * desc.uHeight * uBytesPerTexel;
+
+        return (uSize + PLACEMENT_ALIGNMENT - 1u) / PLACEMENT_ALIGNMENT * PLACEMENT_ALIGNMENT;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::cullPasses
+
+      Summary:  Culls the passes whose outputs are never read. Every
+                pass starts with one reference per written version and
+                every version with one reference per reader. Versions
+                nobody reads release their producer, and a culled pass
+                releases the versions it reads, until nothing changes.
+                Passes with side effects or writing an imported texture
+                are never culled
+
+      Modifies: [m_aPasses].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::cullPasses()
+    {
+        std::vector<size_t> auPassRefs(m_aPasses.size());
+        std::vector<size_t> auHandleRefs(m_aHandles.size());
+        std::vector<std::uint32_t> auUnusedHandles;
+
+        for (std::uint32_t i = 0u; i < m_aHandles.size(); ++i)
+        {
+            auHandleRefs[i] = m_aHandles[i].auReaders.size();
+            if (auHandleRefs[i] == 0u)
+            {
+                auUnusedHandles.push_back(i);
+            }
+        }
+
+        for (std::uint32_t i = 0u; i < m_aPasses.size(); ++i)
+        {
+            FrameGraphPass& pass = m_aPasses[i];
+
+            pass.bCulled = false;
+            auPassRefs[i] = pass.auWrites.size();
+
+            bool bRoot = pass.bSideEffect;
+            for (std::uint32_t uHandle : pass.auWrites)
+            {
+                bRoot |= m_aTextures[m_aHandles[uHandle].uTexture].bImported;
+            }
+
+            // Roots keep one extra reference, so they are never released
+            if (bRoot)
+            {
+                ++auPassRefs[i];
+            }
+            else if (auPassRefs[i] == 0u)
+            {
+                // Writes nothing, so only its reads need releasing
+                pass.bCulled = true;
+                for (std::uint32_t uHandle : pass.auReads)
+                {
+                    if (--auHandleRefs[uHandle] == 0u)
+                    {
+                        auUnusedHandles.push_back(uHandle);
+                    }
+                }
+            }
+        }
+
+        while (!auUnusedHandles.empty())
+        {
+            const std::uint32_t uProducer = m_aHandles[auUnusedHandles.back()].uProducer;
+            auUnusedHandles.pop_back();
+
+            if (uProducer == INVALID_INDEX || --auPassRefs[uProducer] > 0u)
+            {
+                continue;
+            }
+
+            m_aPasses[uProducer].bCulled = true;
+            for (std::uint32_t uHandle : m_aPasses[uProducer].auReads)
+            {
+                if (--auHandleRefs[uHandle] == 0u)
+                {
+                    auUnusedHandles.push_back(uHandle);
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::orderPasses
+
+      Summary:  Sorts the kept passes topologically. A reader runs after
+                the producer of the version it reads, and a writer runs
+                after the other readers of the version it writes over.
+                Among ready passes, the one added first runs first, so
+                a graph declared in a valid order keeps that order
+
+      Modifies: [m_auExecutionOrder].
+
+      Returns:  bool
+                  false when the dependencies form a cycle
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool FrameGraph::orderPasses()
+    {
+        std::vector<std::vector<std::uint32_t>> aauSuccessors(m_aPasses.size());
+        std::vector<std::uint32_t> auNumPredecessors(m_aPasses.size(), 0u);
+
+        for (std::uint32_t uPass = 0u; uPass < m_aPasses.size(); ++uPass)
+        {
+            if (m_aPasses[uPass].bCulled)
+            {
+                continue;
+            }
+
+            for (std::uint32_t uHandle : m_aPasses[uPass].auReads)
+            {
+                // Read after write
+                const std::uint32_t uProducer = m_aHandles[uHandle].uProducer;
+                if (uProducer != INVALID_INDEX && uProducer != uPass)
+                {
+                    aauSuccessors[uProducer].push_back(uPass);
+                    ++auNumPredecessors[uPass];
+                }
+            }
+
+            for (std::uint32_t uHandle : m_aPasses[uPass].auWrites)
+            {
+                // Write after read, the version written over must be
+                // read by everyone else before it is replaced
+                for (std::uint32_t uReader : m_aHandles[m_aHandles[uHandle].uPrevious].auReaders)
+                {
+                    if (uReader != uPass && !m_aPasses[uReader].bCulled)
+                    {
+                        aauSuccessors[uReader].push_back(uPass);
+                        ++auNumPredecessors[uPass];
+                    }
+                }
+            }
+        }
+
+        std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<std::uint32_t>> readyPasses;
+        size_t uNumKeptPasses = 0u;
+        for (std::uint32_t uPass = 0u; uPass < m_aPasses.size(); ++uPass)
+        {
+            if (!m_aPasses[uPass].bCulled)
+            {
+                ++uNumKeptPasses;
+                if (auNumPredecessors[uPass] == 0u)
+                {
+                    readyPasses.push(uPass);
+                }
+            }
+        }
+
+        m_auExecutionOrder.clear();
+        while (!readyPasses.empty())
+        {
+            const std::uint32_t uPass = readyPasses.top();
+            readyPasses.pop();
+
+            m_auExecutionOrder.push_back(uPass);
+            for (std::uint32_t uSuccessor : aauSuccessors[uPass])
+            {
+                if (--auNumPredecessors[uSuccessor] == 0u)
+                {
+                    readyPasses.push(uSuccessor);
+                }
+            }
+        }
+
+        if (m_auExecutionOrder.size() != uNumKeptPasses)
+        {
+            m_auExecutionOrder.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::computeLifetimes
+
+      Summary:  Finds the first and last position in the execution order
+                at which each texture is used
+
+      Modifies: [m_aTextures].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::computeLifetimes()
+    {
+        for (FrameGraphTexture& texture : m_aTextures)
+        {
+            texture.uFirstUse = INVALID_INDEX;
+            texture.uLastUse = INVALID_INDEX;
+        }
+
+        for (std::uint32_t uPosition = 0u; uPosition < m_auExecutionOrder.size(); ++uPosition)
+        {
+            const FrameGraphPass& pass = m_aPasses[m_auExecutionOrder[uPosition]];
+
+            // Every written version is preceded by a read of the version
+            // written over, so the reads cover every texture used
+            for (std::uint32_t uHandle : pass.auReads)
+            {
+                FrameGraphTexture& texture = m_aTextures[m_aHandles[uHandle].uTexture];
+                if (texture.uFirstUse == INVALID_INDEX)
+                {
+                    texture.uFirstUse = uPosition;
+                }
+                texture.uLastUse = uPosition;
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FrameGraph::planMemory
+
+      Summary:  Places the used transient textures in one heap, largest
+                first, each at the lowest offset not overlapping a
+                placed texture alive at the same time
+
+      Modifies: [m_aTextures, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FrameGraph::planMemory()
+    {
+        std::vector<std::uint32_t> auTextures;
+        for (std::uint32_t i = 0u; i < m_aTextures.size(); ++i)
+        {
+            FrameGraphTexture& texture = m_aTextures[i];
+
+            texture.uOffset = 0u;
+            texture.uSize = 0u;
+            if (!texture.bImported && texture.uFirstUse != INVALID_INDEX)
+            {
+                texture.uSize = GetTextureMemory(texture.Desc);
+                auTextures.push_back(i);
+            }
+        }
+
+        std::stable_sort(
+            auTextures.begin(),
+            auTextures.end(),
+            [this](std::uint32_t uLeft, std::uint32_t uRight)
+            {
+                return m_aTextures[uLeft].uSize > m_aTextures[uRight].uSize;
+            }
+        );
+
+        m_stats.uNumTransientTextures = static_cast<std::uint32_t>(auTextures.size());
+        m_stats.uTransientBytes = 0u;
+        m_stats.uPeakTransientBytes = 0u;
+
+        std::vector<std::uint32_t> auAlive;
+        for (size_t i = 0u; i < auTextures.size(); ++i)
+        {
+            FrameGraphTexture& texture = m_aTextures[auTextures[i]];
+
+            // Placed textures whose lifetime overlaps, by offset
+            auAlive.clear();
+            for (size_t j = 0u; j < i; ++j)
+            {
+                const FrameGraphTexture& placed = m_aTextures[auTextures[j]];
+                if (placed.uFirstUse <= texture.uLastUse && texture.uFirstUse <= placed.uLastUse)
+                {
+                    auAlive.push_back(auTextures[j]);
+                }
+            }
+
+            std::sort(
+                auAlive.begin(),
+                auAlive.end(),
+                [this](std::uint32_t uLeft, std::uint32_t uRight)
+                {
+                    return m_aTextures[uLeft].uOffset < m_aTextures[uRight].uOffset;
+                }
+            );
+
+            std::uint64_t uOffset = 0u;
+            for (std::uint32_t uPlaced : auAlive)
+            {
+                const FrameGraphTexture& placed = m_aTextures[uPlaced];
+                if (uOffset + texture.uSize <= placed.uOffset)
+                {
+                    break;
+                }
+                uOffset = std::max(uOffset, placed.uOffset + placed.uSize);
+            }
+
+            texture.uOffset = uOffset;
+            m_stats.uTransientBytes += texture.uSize;
+            m_stats.uPeakTransientBytes = std::max(m_stats.uPeakTransientBytes, uOffset + texture.uSize);
+        }
+    }
+}
@@ -0,0 +1,219 @@
+/*+===================================================================
+  File:      FRAMEGRAPH.H
+
+  Summary:   FrameGraph header file contains declarations of the
+             declarative description of a frame. Passes declare the
+             resources they read and write, and compiling the graph
+             culls the unused passes, orders the others and plans how
+             transient render targets share memory. Only depends on
+             the standard library, the backend is only referenced.
+
+  Classes: FrameGraph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace library
+{
+    class RenderBackend;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eFrameGraphFormat
+
+      Summary:  Formats of the textures of the frame graph, named after
+                the DXGI formats they stand for
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eFrameGraphFormat : std::uint8_t
+    {
+        R8_UNORM,
+        R16_FLOAT,
+        D16_UNORM,
+        R8G8B8A8_UNORM,
+        B8G8R8A8_UNORM,
+        D24_UNORM_S8_UINT,
+        D32_FLOAT,
+        R16G16B16A16_FLOAT,
+        R32G32_FLOAT,
+        D32_FLOAT_S8X24_UINT,
+        R32G32B32A32_FLOAT,
+        COUNT,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameGraphTextureDesc
+
+      Summary:  Description of a render target or depth buffer of the
+                frame graph
+
+      Members:  std::uint32_t uWidth
+                  Width in texels
+                std::uint32_t uHeight
+                  Height in texels
+                eFrameGraphFormat Format
+                  Format of the texels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameGraphTextureDesc
+    {
+        std::uint32_t uWidth;
+        std::uint32_t uHeight;
+        eFrameGraphFormat Format;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameGraphStats
+
+      Summary:  Result of the last compilation of a frame graph
+
+      Members:  std::uint32_t uNumPasses
+                  Number of passes added
+                std::uint32_t uNumCulledPasses
+                  Number of passes removed because nothing used them
+                std::uint32_t uNumTransientTextures
+                  Number of transient textures used by a kept pass
+                std::uint64_t uTransientBytes
+                  Memory of the transient textures without aliasing
+                std::uint64_t uPeakTransientBytes
+                  Memory of the transient textures with aliasing
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameGraphStats
+    {
+        std::uint32_t uNumPasses;
+        std::uint32_t uNumCulledPasses;
+        std::uint32_t uNumTransientTextures;
+        std::uint64_t uTransientBytes;
+        std::uint64_t uPeakTransientBytes;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FrameGraph
+
+      Summary:  Graph of the passes of a frame. Textures are either
+                imported, like the back buffer, or transient, living
+                only between their first and last use. Every write
+                creates a new version of a texture, so a pass reading a
+                version runs after the pass that wrote it, and a pass
+                writing over a version runs after the passes reading
+                it. Passes writing an imported texture, or marked as
+                having side effects, are kept, and so are the passes
+                they transitively depend on. Compile only works on the
+                declarations, it needs neither a device nor a backend
+
+      Methods:  Reset
+                  Removes every pass and texture
+                ImportTexture
+                  Adds a texture owned outside of the graph
+                CreateTexture
+                  Adds a transient texture
+                AddPass
+                  Adds a pass and its execute callback
+                Read
+                  Declares that a pass reads a texture version
+                Write
+                  Declares that a pass writes a texture version
+                SetSideEffect
+                  Keeps a pass even when nothing reads its outputs
+                Compile
+                  Culls, orders and plans the memory of the passes
+                Execute
+                  Runs the kept passes in order
+                IsPassCulled
+                  Returns whether a pass was culled
+                GetExecutionOrder
+                  Returns the kept passes in execution order
+                GetTextureOffset
+                  Returns the offset of a transient texture in the
+                  aliased heap
+                GetTextureSize
+                  Returns the memory of a transient texture
+                GetStats
+                  Returns the result of the last compilation
+                FrameGraph
+                  Constructor.
+                ~FrameGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FrameGraph final
+    {
+    public:
+        typedef std::function<void(RenderBackend&)> ExecuteCallback;
+
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+        static constexpr std::uint64_t PLACEMENT_ALIGNMENT = 65536u;
+
+    public:
+        FrameGraph();
+        FrameGraph(const FrameGraph& other) = delete;
+        FrameGraph(FrameGraph&& other) = delete;
+        FrameGraph& operator=(const FrameGraph& other) = delete;
+        FrameGraph& operator=(FrameGraph&& other) = delete;
+        ~FrameGraph() = default;
+
+        void Reset();
+
+        std::uint32_t ImportTexture(const wchar_t* pszName, const FrameGraphTextureDesc& desc);
+        std::uint32_t CreateTexture(const wchar_t* pszName, const FrameGraphTextureDesc& desc);
+        std::uint32_t AddPass(const wchar_t* pszName, ExecuteCallback execute);
+        void Read(std::uint32_t uPass, std::uint32_t uHandle);
+        std::uint32_t Write(std::uint32_t uPass, std::uint32_t uHandle);
+        void SetSideEffect(std::uint32_t uPass);
+
+        bool Compile();
+        void Execute(RenderBackend& backend) const;
+
+        bool IsPassCulled(std::uint32_t uPass) const;
+        const std::vector<std::uint32_t>& GetExecutionOrder() const;
+        std::uint64_t GetTextureOffset(std::uint32_t uHandle) const;
+        std::uint64_t GetTextureSize(std::uint32_t uHandle) const;
+        const FrameGraphStats& GetStats() const;
+
+        static std::uint64_t GetTextureMemory(const FrameGraphTextureDesc& desc);
+
+    private:
+        struct FrameGraphTexture
+        {
+            const wchar_t* pszName;
+            FrameGraphTextureDesc Desc;
+            bool bImported;
+            std::uint64_t uSize;
+            std::uint64_t uOffset;
+            std::uint32_t uFirstUse;
+            std::uint32_t uLastUse;
+        };
+
+        struct FrameGraphHandle
+        {
+            std::uint32_t uTexture;
+            std::uint32_t uProducer;
+            std::uint32_t uPrevious;
+            std::vector<std::uint32_t> auReaders;
+        };
+
+        struct FrameGraphPass
+        {
+            const wchar_t* pszName;
+            ExecuteCallback Execute;
+            std::vector<std::uint32_t> auReads;
+            std::vector<std::uint32_t> auWrites;
+            bool bSideEffect;
+            bool bCulled;
+        };
+
+    private:
+        void cullPasses();
+        bool orderPasses();
+        void computeLifetimes();
+        void planMemory();
+
+    private:
+        std::vector<FrameGraphTexture> m_aTextures;
+        std::vector<FrameGraphHandle> m_aHandles;
+        std::vector<FrameGraphPass> m_aPasses;
+        std::vector<std::uint32_t> m_auExecutionOrder;
+        FrameGraphStats m_stats;
+    };
+}
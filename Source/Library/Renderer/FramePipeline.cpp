@@ -0,0 +1,294 @@
+#include "Renderer/FramePipeline.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::FramePipeline
+
+      Summary:  Constructor of a pipeline without tasks
+
+      Modifies: [m_aTasks, m_aStageSeconds, m_aAverageStageSeconds,
+                 m_renderThread, m_uRenderEpoch, m_bStopping,
+                 m_uNumFrames, m_frequency].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FramePipeline::FramePipeline()
+        : m_aTasks()
+        , m_aStageSeconds()
+        , m_aAverageStageSeconds()
+        , m_renderThread()
+        , m_uRenderEpoch(0u)
+        , m_bStopping(false)
+        , m_uNumFrames(0u)
+        , m_frequency()
+    {
+        QueryPerformanceFrequency(&m_frequency);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::~FramePipeline
+
+      Summary:  Destructor stopping the render thread
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FramePipeline::~FramePipeline()
+    {
+        Stop();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::SetStage
+
+      Summary:  Sets the task of a stage. A stage without task is
+                skipped. The task of the submission may only be set
+                while the render thread is stopped
+
+      Args:     eFrameStage stage
+                  Stage of the task
+                const std::function<void()>& task
+                  Task run once per frame. The task of the submission
+                  runs on the render thread once started
+
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::SetStage(_In_ eFrameStage stage, _In_ const std::function<void()>& task)
+    {
+        m_aTasks[static_cast<size_t>(stage)] = task;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::Start
+
+      Summary:  Starts the render thread, which from then on runs the
+                submission every time a frame is executed. Does nothing
+                when it already runs
+
+      Modifies: [m_renderThread, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::Start()
+    {
+        if (m_renderThread.joinable())
+        {
+            return;
+        }
+
+        m_bStopping.store(false, std::memory_order_relaxed);
+        m_renderThread = std::thread(&FramePipeline::renderThreadMain, this);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::Stop
+
+      Summary:  Wakes the render thread a last time, so it submits the
+                newest frame, and waits for it to finish. Must be
+                called from the thread calling Execute, or once it no
+                longer executes frames
+
+      Modifies: [m_renderThread, m_uRenderEpoch, m_bStopping].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::Stop()
+    {
+        if (!m_renderThread.joinable())
+        {
+            return;
+        }
+
+        m_bStopping.store(true, std::memory_order_release);
+        m_uRenderEpoch.fetch_add(1u, std::memory_order_release);
+        m_uRenderEpoch.notify_one();
+
+        m_renderThread.join();
+    }
+
+    BOOL FramePipeline::IsRunning() const
+    {
+        return m_renderThread.joinable();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::Execute
+
+      Summary:  Runs the stages of a frame up to the draw list on the
+                calling thread, then wakes the render thread to submit
+                it and returns without waiting for it. Until the render
+                thread is started, runs the submission inline instead
+
+      Modifies: [m_aStageSeconds, m_aAverageStageSeconds, m_uRenderEpoch,
+                 m_uNumFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::Execute()
+    {
+        runStage(eFrameStage::INPUT);
+        runStage(eFrameStage::UPDATE);
+        runStage(eFrameStage::CULL);
+        runStage(eFrameStage::BUILD_DRAW_LIST);
+
+        if (m_renderThread.joinable())
+        {
+            m_uRenderEpoch.fetch_add(1u, std::memory_order_release);
+            m_uRenderEpoch.notify_one();
+        }
+        else
+        {
+            runStage(eFrameStage::SUBMIT);
+        }
+
+        ++m_uNumFrames;
+    }
+
+    UINT64 FramePipeline::GetNumFrames() const
+    {
+        return m_uNumFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::GetStageSeconds
+
+      Summary:  Returns the time of a stage in the last frame. The
+                time of the submission is the one of the last finished
+                submission. May be called from any thread
+
+      Args:     eFrameStage stage
+                  Stage to query
+
+      Returns:  FLOAT
+                  Seconds spent in the task of the stage
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT FramePipeline::GetStageSeconds(_In_ eFrameStage stage) const
+    {
+        return m_aStageSeconds[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::GetAverageStageSeconds
+
+      Summary:  Returns the time of a stage, exponentially smoothed
+                over the frames with AVERAGE_WEIGHT
+
+      Args:     eFrameStage stage
+                  Stage to query
+
+      Returns:  FLOAT
+                  Smoothed seconds spent in the task of the stage
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT FramePipeline::GetAverageStageSeconds(_In_ eFrameStage stage) const
+    {
+        return m_aAverageStageSeconds[static_cast<size_t>(stage)].load(std::memory_order_relaxed);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::GetStageName
+
+      Summary:  Returns the name of a stage, for reports
+
+      Args:     eFrameStage stage
+                  Stage to name
+
+      Returns:  PCWSTR
+                  Name of the stage
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PCWSTR FramePipeline::GetStageName(_In_ eFrameStage stage)
+    {
+        switch (stage)
+        {
+        case eFrameStage::INPUT:
+            return L"Input";
+        case eFrameStage::UPDATE:
+            return L"Update";
+        case eFrameStage::CULL:
+            return L"Cull";
+        case eFrameStage::BUILD_DRAW_LIST:
+            return L"Draw list";
+        case eFrameStage::SUBMIT:
+            return L"Submit";
+        default:
+            return L"Unknown";
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::renderThreadMain
+
+      Summary:  Loop of the render thread. Runs the submission, then
+                sleeps until a frame is executed or the pipeline stops.
+                The epoch is read before the submission, so a frame
+                executed during it wakes the thread again at once, and
+                the frame executed last is always submitted before the
+                thread ends
+
+      Modifies: [m_aStageSeconds, m_aAverageStageSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::renderThreadMain()
+    {
+        for (;;)
+        {
+            const std::uint32_t uEpoch = m_uRenderEpoch.load(std::memory_order_acquire);
+            const bool bStopping = m_bStopping.load(std::memory_order_acquire);
+
+            runStage(eFrameStage::SUBMIT);
+
+            if (bStopping)
+            {
+                break;
+            }
+
+            m_uRenderEpoch.wait(uEpoch, std::memory_order_acquire);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::runStage
+
+      Summary:  Runs the task of a stage on the calling thread and
+                records its time. Each stage is only ever run by one
+                thread
+
+      Args:     eFrameStage stage
+                  Stage to run
+
+      Modifies: [m_aStageSeconds, m_aAverageStageSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::runStage(_In_ eFrameStage stage)
+    {
+        const std::function<void()>& task = m_aTasks[static_cast<size_t>(stage)];
+        if (!task)
+        {
+            return;
+        }
+
+        LARGE_INTEGER startTime;
+        QueryPerformanceCounter(&startTime);
+        task();
+        recordStageSeconds(stage, getSecondsSince(startTime));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   FramePipeline::recordStageSeconds
+
+      Summary:  Stores the time of a stage and folds it into its
+                average, which starts at the first time recorded
+
+      Args:     eFrameStage stage
+                  Stage timed
+                FLOAT seconds
+                  Time of the stage
+
+      Modifies: [m_aStageSeconds, m_aAverageStageSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void FramePipeline::recordStageSeconds(_In_ eFrameStage stage, _In_ FLOAT seconds)
+    {
+        const size_t uStage = static_cast<size_t>(stage);
+
+        // Only the thread running the stage writes its times
+        const FLOAT average = m_aAverageStageSeconds[uStage].load(std::memory_order_relaxed);
+
+        m_aStageSeconds[uStage].store(seconds, std::memory_order_relaxed);
+        m_aAverageStageSeconds[uStage].store(average == 0.0f ? seconds : average + AVERAGE_WEIGHT * (seconds - average), std::memory_order_relaxed);
+    }
+
+    FLOAT FramePipeline::getSecondsSince(_In_ const LARGE_INTEGER& startTime) const
+    {
+        LARGE_INTEGER endTime;
+        QueryPerformanceCounter(&endTime);
+
+        return static_cast<FLOAT>(endTime.QuadPart - startTime.QuadPart) / static_cast<FLOAT>(m_frequency.QuadPart);
+    }
+}
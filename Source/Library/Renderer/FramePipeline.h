@@ -0,0 +1,117 @@
+/*+===================================================================
+  File:      FRAMEPIPELINE.H
+
+  Summary:   FramePipeline header file contains declarations of the
+             task graph of a frame. The stages of a frame run in
+             order on the simulation thread, and the submission runs
+             on a dedicated render thread, overlapping the stages of
+             the next frames.
+
+  Classes: FramePipeline
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eFrameStage
+
+      Summary:  Stages of a frame, in the order they run
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eFrameStage : BYTE
+    {
+        INPUT,
+        UPDATE,
+        CULL,
+        BUILD_DRAW_LIST,
+        SUBMIT,
+        COUNT,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    FramePipeline
+
+      Summary:  Runs the stages of a frame, each a task, and times
+                them. The stages up to the draw list run on the thread
+                calling Execute, the simulation thread. Once started,
+                a render thread runs the submission task every time a
+                frame is executed, without the simulation thread ever
+                waiting for it: the tasks hand the frames over by
+                themselves, through a triple buffer. The submission
+                task takes the newest frame and does nothing when no
+                frame is new. Until the render thread is started,
+                Execute runs the submission inline
+
+      Methods:  SetStage
+                  Sets the task of a stage
+                Start
+                  Starts the render thread
+                Stop
+                  Runs the submission a last time and stops the render
+                  thread
+                IsRunning
+                  Returns whether the render thread runs
+                Execute
+                  Runs the stages of a frame
+                GetNumFrames
+                  Returns the number of frames executed
+                GetStageSeconds
+                  Returns the time of a stage in the last frame
+                GetAverageStageSeconds
+                  Returns the smoothed time of a stage
+                GetStageName
+                  Returns the name of a stage
+                FramePipeline
+                  Constructor.
+                ~FramePipeline
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class FramePipeline final
+    {
+    public:
+        static constexpr FLOAT AVERAGE_WEIGHT = 0.05f;
+
+    public:
+        FramePipeline();
+        FramePipeline(const FramePipeline& other) = delete;
+        FramePipeline(FramePipeline&& other) = delete;
+        FramePipeline& operator=(const FramePipeline& other) = delete;
+        FramePipeline& operator=(FramePipeline&& other) = delete;
+        ~FramePipeline();
+
+        void SetStage(_In_ eFrameStage stage, _In_ const std::function<void()>& task);
+        void Start();
+        void Stop();
+        BOOL IsRunning() const;
+        void Execute();
+
+        UINT64 GetNumFrames() const;
+        FLOAT GetStageSeconds(_In_ eFrameStage stage) const;
+        FLOAT GetAverageStageSeconds(_In_ eFrameStage stage) const;
+        static PCWSTR GetStageName(_In_ eFrameStage stage);
+
+    private:
+        void renderThreadMain();
+        void runStage(_In_ eFrameStage stage);
+        void recordStageSeconds(_In_ eFrameStage stage, _In_ FLOAT seconds);
+        FLOAT getSecondsSince(_In_ const LARGE_INTEGER& startTime) const;
+
+    private:
+        std::function<void()> m_aTasks[static_cast<size_t>(eFrameStage::COUNT)];
+        std::atomic<FLOAT> m_aStageSeconds[static_cast<size_t>(eFrameStage::COUNT)];
+        std::atomic<FLOAT> m_aAverageStageSeconds[static_cast<size_t>(eFrameStage::COUNT)];
+        std::thread m_renderThread;
+        std::atomic<std::uint32_t> m_uRenderEpoch;
+        std::atomic<bool> m_bStopping;
+        UINT64 m_uNumFrames;
+        LARGE_INTEGER m_frequency;
+    };
+}
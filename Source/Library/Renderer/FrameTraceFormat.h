@@ -0,0 +1,139 @@
+/*+===================================================================
+  File:      FRAMETRACEFORMAT.H
+
+  Summary:   FrameTraceFormat header file contains the layout of the
+             binary frame trace written by TracingRenderBackend and
+             read by the TraceStats tool. It only depends on the
+             standard library, so the tool builds on any platform.
+
+  Classes: TraceFileHeader, TraceRecord
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace library
+{
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eTraceRecordType
+
+      Summary:  Kind of a trace record. The commands have the values of
+                eRenderCommandType, FRAME starts the records of a frame
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eTraceRecordType : std::uint8_t
+    {
+        CLEAR_RENDER_TARGET,
+        CLEAR_DEPTH_STENCIL,
+        UPDATE_BUFFER,
+        SET_PRIMITIVE_TOPOLOGY,
+        SET_VERTEX_BUFFER,
+        SET_INDEX_BUFFER,
+        SET_INPUT_LAYOUT,
+        SET_VERTEX_SHADER,
+        SET_PIXEL_SHADER,
+        SET_VS_CONSTANT_BUFFER,
+        SET_PS_CONSTANT_BUFFER,
+        SET_VS_SHADER_RESOURCE,
+        SET_PS_SHADER_RESOURCE,
+        SET_PS_SAMPLER,
+        SET_PIPELINE_STATE,
+        DRAW,
+        DRAW_INDEXED,
+        DRAW_INDEXED_INSTANCED,
+        PRESENT,
+        FRAME,
+        COUNT,
+    };
+
+    inline constexpr const char* TRACE_RECORD_NAMES[] =
+    {
+        "ClearRenderTarget",
+        "ClearDepthStencil",
+        "UpdateBuffer",
+        "SetPrimitiveTopology",
+        "SetVertexBuffer",
+        "SetIndexBuffer",
+        "SetInputLayout",
+        "SetVertexShader",
+        "SetPixelShader",
+        "SetVSConstantBuffer",
+        "SetPSConstantBuffer",
+        "SetVSShaderResource",
+        "SetPSShaderResource",
+        "SetPSSampler",
+        "SetPipelineState",
+        "Draw",
+        "DrawIndexed",
+        "DrawIndexedInstanced",
+        "Present",
+        "Frame",
+    };
+    static_assert(sizeof(TRACE_RECORD_NAMES) / sizeof(TRACE_RECORD_NAMES[0]) == static_cast<std::size_t>(eTraceRecordType::COUNT));
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TraceFileHeader
+
+      Summary:  First bytes of a trace file, followed by the records
+
+      Members:  std::uint32_t uMagic
+                  TRACE_MAGIC
+                std::uint32_t uVersion
+                  TRACE_VERSION of the writer
+                std::uint32_t uNumFrames
+                  Number of frames in the file
+                std::uint32_t uReserved
+                  Zero
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TraceFileHeader
+    {
+        static constexpr std::uint32_t TRACE_MAGIC = 0x43525446u; // "FTRC"
+        static constexpr std::uint32_t TRACE_VERSION = 1u;
+
+        std::uint32_t uMagic;
+        std::uint32_t uVersion;
+        std::uint32_t uNumFrames;
+        std::uint32_t uReserved;
+    };
+    static_assert(sizeof(TraceFileHeader) == 16u);
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   TraceRecord
+
+      Summary:  One context call of a frame. Objects are replaced by
+                ids numbered from 1 in the order they are first seen,
+                0 being no object. Uploaded data is not kept, only its
+                size
+
+      Members:  std::uint8_t Type
+                  eTraceRecordType of the record
+                std::uint8_t uSlot
+                  Register or input slot of a binding
+                std::uint16_t uReserved
+                  Zero
+                std::uint32_t uObject
+                  Id of the bound or updated object or pipeline state
+                std::uint32_t auArgs[3]
+                  FRAME: frame index, number of records of the frame
+                  UPDATE_BUFFER: uploaded bytes
+                  SET_PRIMITIVE_TOPOLOGY: topology
+                  SET_VERTEX_BUFFER: stride, offset
+                  SET_INDEX_BUFFER: format
+                  SET_PIPELINE_STATE: id of the object constants
+                  DRAW: vertex count, unused, start vertex
+                  DRAW_INDEXED: index count, 1, start index
+                  DRAW_INDEXED_INSTANCED: index count, instance
+                  count, start index
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct TraceRecord
+    {
+        std::uint8_t Type;
+        std::uint8_t uSlot;
+        std::uint16_t uReserved;
+        std::uint32_t uObject;
+        std::uint32_t auArgs[3];
+    };
+    static_assert(sizeof(TraceRecord) == 20u);
+}
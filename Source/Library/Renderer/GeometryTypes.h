@@ -0,0 +1,30 @@
+/*+===================================================================
+  File:      GEOMETRYTYPES.H
+
+  Summary:   GeometryTypes header file contains the vertex and bounds
+             types shared by the renderer and the CPU side culling.
+             Only depends on DirectXMath.
+
+  Classes: SimpleVertex, AxisAlignedBox
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <DirectXMath.h>
+
+namespace library
+{
+    struct SimpleVertex
+    {
+        DirectX::XMFLOAT3 Position;
+        DirectX::XMFLOAT2 TexCoord;
+        DirectX::XMFLOAT3 Normal;
+    };
+
+    struct AxisAlignedBox
+    {
+        DirectX::XMFLOAT3 Min;
+        DirectX::XMFLOAT3 Max;
+    };
+}
@@ -16,7 +16,7 @@ namespace library
     InstancedRenderable::InstancedRenderable(_In_ const XMFLOAT4& outputColor) :
         Renderable(outputColor),
         m_instanceBuffer(nullptr),
-        m_aInstanceData(std::vector<InstanceData>()),
+        m_aInstanceData(),
         m_padding()
 
     {};
@@ -26,17 +26,17 @@ namespace library
 
       Summary:  Constructor
 
-      Args:     std::vector<InstanceData>&& aInstanceData
+      Args:     InstanceDataVector&& aInstanceData
                   An instance data
                 const XMFLOAT4& outputColor
                   Default color of the renderable
 
       Modifies: [m_instanceBuffer, m_aInstanceData].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    InstancedRenderable::InstancedRenderable(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor) :
+    InstancedRenderable::InstancedRenderable(_In_ InstanceDataVector&& aInstanceData, _In_ const XMFLOAT4& outputColor) :
         Renderable(outputColor),
         m_instanceBuffer(nullptr),
-        m_aInstanceData(aInstanceData),
+        m_aInstanceData(std::move(aInstanceData)),
         m_padding()
 
     {};
@@ -47,12 +47,12 @@ namespace library
 
       Summary:  Sets the instance data
 
-      Args:     std::vector<InstanceData>&& aInstanceData
+      Args:     InstanceDataVector&& aInstanceData
                   Instance data
 
       Modifies: [m_aInstanceData].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    void InstancedRenderable::SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData)
+    void InstancedRenderable::SetInstanceData(_In_ InstanceDataVector&& aInstanceData)
     {
         m_aInstanceData = std::move(aInstanceData);
 
@@ -84,6 +84,20 @@ namespace library
         return numOfInstances;
 
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   InstancedRenderable::GetInstanceData
+
+      Summary:  Returns the instance data kept on the CPU
+
+      Returns:  const InstanceDataVector&
+                  Instance data
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const InstanceDataVector& InstancedRenderable::GetInstanceData() const
+    {
+        return m_aInstanceData;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   InstancedRenderable::initializeInstance
 
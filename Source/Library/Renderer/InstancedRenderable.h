@@ -13,11 +13,15 @@
 
 #include "Common.h"
 
+#include "Memory/MemoryTracker.h"
 #include "Renderer/DataTypes.h"
 #include "Renderer/Renderable.h"
 
 namespace library
 {
+    // The instances drawn are the voxels of the scenes, so their memory is accounted to the scene
+    typedef TaggedVector<InstanceData, eMemoryTag::SCENE> InstanceDataVector;
+
     /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
       Class:    InstancedRenderable
 
@@ -29,6 +33,8 @@ namespace library
                   Returns a instance buffer
                 GetNumInstances
                   Returns the number of instance data
+                GetInstanceData
+                  Returns the instance data
                 initializeInstance
                   Initialize the instance buffer
                 InstancedRenderable
@@ -40,7 +46,7 @@ namespace library
     {
     public:
         InstancedRenderable(_In_ const XMFLOAT4& outputColor);
-        InstancedRenderable(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor);
+        InstancedRenderable(_In_ InstanceDataVector&& aInstanceData, _In_ const XMFLOAT4& outputColor);
         InstancedRenderable(const InstancedRenderable& other) = delete;
         InstancedRenderable(InstancedRenderable&& other) = delete;
         InstancedRenderable& operator=(const InstancedRenderable& other) = delete;
@@ -50,10 +56,11 @@ namespace library
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) override = 0;
         virtual void Update(_In_ FLOAT deltaTime) override = 0;
 
-        void SetInstanceData(_In_ std::vector<InstanceData>&& aInstanceData);
+        void SetInstanceData(_In_ InstanceDataVector&& aInstanceData);
 
         virtual ComPtr<ID3D11Buffer>& GetInstanceBuffer();
         virtual UINT GetNumInstances() const;
+        const InstanceDataVector& GetInstanceData() const;
 
         UINT GetNumVertices() const override = 0;
         UINT GetNumIndices() const override = 0;
@@ -66,7 +73,7 @@ namespace library
 
     protected:
         ComPtr<ID3D11Buffer> m_instanceBuffer;
-        std::vector<InstanceData> m_aInstanceData;
+        InstanceDataVector m_aInstanceData;
 
     private:
         BYTE m_padding[8];
@@ -0,0 +1,628 @@
+#include "Renderer/OcclusionCuller.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <iterator>
+
+using namespace DirectX;
+
+namespace library
+{
+    namespace
+    {
+        constexpr std::uint16_t BOX_INDICES[] =
+        {
+            0, 1, 2,  2, 1, 3,  // -z
+            4, 6, 5,  5, 6, 7,  // +z
+            0, 2, 4,  4, 2, 6,  // -x
+            1, 5, 3,  3, 5, 7,  // +x
+            0, 4, 1,  1, 4, 5,  // -y
+            2, 3, 6,  6, 3, 7,  // +y
+        };
+
+        /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+          Function: GetBoxCorners
+
+          Summary:  Writes the 8 corners of a box, bit 0 selecting x,
+                    bit 1 selecting y and bit 2 selecting z
+
+          Args:     const AxisAlignedBox& box
+                      Box to expand
+                    XMVECTOR aCorners[8]
+                      Corners with w set to 1
+        F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+        void GetBoxCorners(_In_ const AxisAlignedBox& box, _Out_writes_(8) XMVECTOR aCorners[8])
+        {
+            for (std::uint32_t i = 0u; i < 8u; ++i)
+            {
+                aCorners[i] = XMVectorSet(
+                    (i & 1u) ? box.Max.x : box.Min.x,
+                    (i & 2u) ? box.Max.y : box.Min.y,
+                    (i & 4u) ? box.Max.z : box.Min.z,
+                    1.0f
+                );
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::OcclusionCuller
+
+      Summary:  Constructor
+
+      Args:     std::uint32_t uWidth
+                  Width of the depth buffer, rounded up to whole tiles
+                std::uint32_t uHeight
+                  Height of the depth buffer, rounded up to whole tiles
+
+      Modifies: [m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+                 m_bEnabled, m_uNumTested, m_uNumCulled, m_aDepth,
+                 m_aTileMaxDepth, m_aClipPositions, m_viewProjection].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    OcclusionCuller::OcclusionCuller(_In_ std::uint32_t uWidth, _In_ std::uint32_t uHeight)
+        : m_uWidth((std::max(uWidth, 1u) + TILE_WIDTH - 1u) / TILE_WIDTH * TILE_WIDTH)
+        , m_uHeight((std::max(uHeight, 1u) + TILE_HEIGHT - 1u) / TILE_HEIGHT * TILE_HEIGHT)
+        , m_uNumTilesX(m_uWidth / TILE_WIDTH)
+        , m_uNumTilesY(m_uHeight / TILE_HEIGHT)
+        , m_bEnabled(true)
+        , m_uNumTested(0u)
+        , m_uNumCulled(0u)
+        , m_aDepth(static_cast<size_t>(m_uWidth) * m_uHeight, 1.0f)
+        , m_aTileMaxDepth(static_cast<size_t>(m_uNumTilesX) * m_uNumTilesY, 1.0f)
+        , m_aClipPositions()
+        , m_viewProjection(XMMatrixIdentity())
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::BeginFrame
+
+      Summary:  Clears the depth buffer to the far plane and stores the
+                view projection matrix used by the following calls
+
+      Args:     const XMMATRIX& viewProjection
+                  View matrix multiplied by the projection matrix
+
+      Modifies: [m_aDepth, m_aTileMaxDepth, m_viewProjection,
+                 m_uNumTested, m_uNumCulled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::BeginFrame(_In_ const XMMATRIX& viewProjection)
+    {
+        std::fill(m_aDepth.begin(), m_aDepth.end(), 1.0f);
+        std::fill(m_aTileMaxDepth.begin(), m_aTileMaxDepth.end(), 1.0f);
+        m_viewProjection = viewProjection;
+        m_uNumTested = 0u;
+        m_uNumCulled = 0u;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RenderOccluderBox
+
+      Summary:  Rasterizes the 12 triangles of a solid box. The box
+                must be fully opaque (e.g. the part of a terrain chunk
+                below its lowest column)
+
+      Args:     const AxisAlignedBox& box
+                  World space box
+
+      Modifies: [m_aDepth, m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RenderOccluderBox(_In_ const AxisAlignedBox& box)
+    {
+        if (!m_bEnabled)
+        {
+            return;
+        }
+
+        XMVECTOR aCorners[8];
+        GetBoxCorners(box, aCorners);
+        for (std::uint32_t i = 0u; i < 8u; ++i)
+        {
+            aCorners[i] = XMVector4Transform(aCorners[i], m_viewProjection);
+        }
+
+        for (std::uint32_t i = 0u; i < std::size(BOX_INDICES); i += 3u)
+        {
+            rasterizeTriangle(aCorners[BOX_INDICES[i]], aCorners[BOX_INDICES[i + 1u]], aCorners[BOX_INDICES[i + 2u]]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::RenderOccluderMesh
+
+      Summary:  Rasterizes an indexed triangle list as an occluder
+
+      Args:     const SimpleVertex* pVertices
+                  Vertices of the mesh
+                std::uint32_t uNumVertices
+                  Number of vertices
+                const std::uint16_t* pIndices
+                  Indices of the triangle list
+                std::uint32_t uNumIndices
+                  Number of indices
+                const XMMATRIX& world
+                  World matrix of the mesh
+
+      Modifies: [m_aDepth, m_aTileMaxDepth, m_aClipPositions].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::RenderOccluderMesh(
+        _In_reads_(uNumVertices) const SimpleVertex* pVertices,
+        _In_ std::uint32_t uNumVertices,
+        _In_reads_(uNumIndices) const std::uint16_t* pIndices,
+        _In_ std::uint32_t uNumIndices,
+        _In_ const XMMATRIX& world
+    )
+    {
+        if (!m_bEnabled || !pVertices || !pIndices)
+        {
+            return;
+        }
+
+        const XMMATRIX worldViewProjection = world * m_viewProjection;
+
+        // Only grows, the occluders are transformed every frame
+        if (m_aClipPositions.size() < uNumVertices)
+        {
+            m_aClipPositions.resize(uNumVertices);
+        }
+        for (std::uint32_t i = 0u; i < uNumVertices; ++i)
+        {
+            m_aClipPositions[i] = XMVector4Transform(XMVectorSetW(XMLoadFloat3(&pVertices[i].Position), 1.0f), worldViewProjection);
+        }
+
+        for (std::uint32_t i = 0u; i + 2u < uNumIndices; i += 3u)
+        {
+            if (pIndices[i] >= uNumVertices || pIndices[i + 1u] >= uNumVertices || pIndices[i + 2u] >= uNumVertices)
+            {
+                continue;
+            }
+            rasterizeTriangle(m_aClipPositions[pIndices[i]], m_aClipPositions[pIndices[i + 1u]], m_aClipPositions[pIndices[i + 2u]]);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::EndOccluders
+
+      Summary:  Computes the farthest depth of every tile. Must be
+                called after the last occluder and before IsVisible
+
+      Modifies: [m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::EndOccluders()
+    {
+        for (std::uint32_t ty = 0u; ty < m_uNumTilesY; ++ty)
+        {
+            for (std::uint32_t tx = 0u; tx < m_uNumTilesX; ++tx)
+            {
+                XMVECTOR tileMax = XMVectorZero();
+                for (std::uint32_t y = ty * TILE_HEIGHT; y < (ty + 1u) * TILE_HEIGHT; ++y)
+                {
+                    const float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                    for (std::uint32_t x = tx * TILE_WIDTH; x < (tx + 1u) * TILE_WIDTH; x += 4u)
+                    {
+                        tileMax = XMVectorMax(tileMax, XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pRow + x)));
+                    }
+                }
+
+                m_aTileMaxDepth[static_cast<size_t>(ty) * m_uNumTilesX + tx] = std::max(
+                    std::max(XMVectorGetX(tileMax), XMVectorGetY(tileMax)),
+                    std::max(XMVectorGetZ(tileMax), XMVectorGetW(tileMax))
+                );
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsVisible
+
+      Summary:  Tests a world space box against the occluders. Boxes
+                crossing the near plane are always visible, boxes
+                entirely outside the viewport are never visible
+
+      Args:     const AxisAlignedBox& box
+                  World space box
+
+      Modifies: [m_uNumTested, m_uNumCulled].
+
+      Returns:  bool
+                  false if the box is certainly hidden
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::IsVisible(_In_ const AxisAlignedBox& box)
+    {
+        if (!m_bEnabled)
+        {
+            return true;
+        }
+
+        ++m_uNumTested;
+
+        XMFLOAT4 screenRect;
+        float minDepth;
+        if (!projectBox(box, screenRect, minDepth))
+        {
+            return true;
+        }
+
+        if (screenRect.z < 0.0f || screenRect.w < 0.0f ||
+            screenRect.x >= static_cast<float>(m_uWidth) || screenRect.y >= static_cast<float>(m_uHeight) ||
+            minDepth > 1.0f)
+        {
+            ++m_uNumCulled;
+            return false;
+        }
+
+        const std::uint32_t uMinX = static_cast<std::uint32_t>(std::max(screenRect.x, 0.0f));
+        const std::uint32_t uMinY = static_cast<std::uint32_t>(std::max(screenRect.y, 0.0f));
+        const std::uint32_t uMaxX = static_cast<std::uint32_t>(std::min(screenRect.z, static_cast<float>(m_uWidth - 1u)));
+        const std::uint32_t uMaxY = static_cast<std::uint32_t>(std::min(screenRect.w, static_cast<float>(m_uHeight - 1u)));
+        const XMVECTOR boxDepth = XMVectorReplicate(minDepth);
+
+        for (std::uint32_t ty = uMinY / TILE_HEIGHT; ty <= uMaxY / TILE_HEIGHT; ++ty)
+        {
+            for (std::uint32_t tx = uMinX / TILE_WIDTH; tx <= uMaxX / TILE_WIDTH; ++tx)
+            {
+                // Every pixel of the tile is nearer than the box
+                if (m_aTileMaxDepth[static_cast<size_t>(ty) * m_uNumTilesX + tx] < minDepth)
+                {
+                    continue;
+                }
+
+                // Widening the span to 4 pixel groups only adds pixels, which keeps the test conservative
+                const std::uint32_t uStartX = std::max(uMinX, tx * TILE_WIDTH) & ~3u;
+                const std::uint32_t uEndX = std::min(uMaxX, (tx + 1u) * TILE_WIDTH - 1u);
+                const std::uint32_t uStartY = std::max(uMinY, ty * TILE_HEIGHT);
+                const std::uint32_t uEndY = std::min(uMaxY, (ty + 1u) * TILE_HEIGHT - 1u);
+                for (std::uint32_t y = uStartY; y <= uEndY; ++y)
+                {
+                    const float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                    for (std::uint32_t x = uStartX; x <= uEndX; x += 4u)
+                    {
+                        if (!XMVector4Less(XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pRow + x)), boxDepth))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+
+        ++m_uNumCulled;
+        return false;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::SetEnabled
+
+      Summary:  Enables or disables culling. When disabled every query
+                reports visible and occluders are ignored
+
+      Args:     bool bEnabled
+                  Whether to cull
+
+      Modifies: [m_bEnabled].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::SetEnabled(_In_ bool bEnabled)
+    {
+        m_bEnabled = bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::IsEnabled
+
+      Summary:  Returns whether culling is enabled
+
+      Returns:  bool
+                  Whether culling is enabled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::IsEnabled() const
+    {
+        return m_bEnabled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumTested
+
+      Summary:  Returns the number of IsVisible calls since BeginFrame
+
+      Returns:  std::uint32_t
+                  Number of tested boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetNumTested() const
+    {
+        return m_uNumTested;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetNumCulled
+
+      Summary:  Returns the number of boxes rejected since BeginFrame
+
+      Returns:  std::uint32_t
+                  Number of culled boxes
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetNumCulled() const
+    {
+        return m_uNumCulled;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetWidth
+
+      Summary:  Returns the width of the depth buffer
+
+      Returns:  std::uint32_t
+                  Width in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetHeight
+
+      Summary:  Returns the height of the depth buffer
+
+      Returns:  std::uint32_t
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t OcclusionCuller::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::GetDepth
+
+      Summary:  Returns the depth stored at a pixel
+
+      Args:     std::uint32_t uX
+                  Column of the pixel
+                std::uint32_t uY
+                  Row of the pixel
+
+      Returns:  float
+                  Depth in [0, 1], 1 where no occluder was drawn
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    float OcclusionCuller::GetDepth(_In_ std::uint32_t uX, _In_ std::uint32_t uY) const
+    {
+        if (uX >= m_uWidth || uY >= m_uHeight)
+        {
+            return 1.0f;
+        }
+
+        return m_aDepth[static_cast<size_t>(uY) * m_uWidth + uX];
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::rasterizeTriangle
+
+      Summary:  Rasterizes a clip space triangle tile by tile. The
+                whole triangle is written with its farthest depth so
+                that the buffer never claims to be nearer than the
+                real occluder. Tiles already nearer than the triangle
+                are skipped, tiles fully inside it are filled without
+                edge tests and the rest are walked 4 pixels at a time
+
+      Args:     FXMVECTOR v0
+                  Clip space position of the first vertex
+                FXMVECTOR v1
+                  Clip space position of the second vertex
+                FXMVECTOR v2
+                  Clip space position of the third vertex
+
+      Modifies: [m_aDepth, m_aTileMaxDepth].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void OcclusionCuller::rasterizeTriangle(_In_ FXMVECTOR v0, _In_ FXMVECTOR v1, _In_ FXMVECTOR v2)
+    {
+        // Triangles touching the near plane are dropped: occluders only
+        // have to be conservative, not complete
+        XMFLOAT4 aClip[3];
+        XMStoreFloat4(&aClip[0], v0);
+        XMStoreFloat4(&aClip[1], v1);
+        XMStoreFloat4(&aClip[2], v2);
+
+        float aX[3];
+        float aY[3];
+        float maxDepth = 0.0f;
+        for (std::uint32_t i = 0u; i < 3u; ++i)
+        {
+            if (aClip[i].w <= 0.0f || aClip[i].z < 0.0f)
+            {
+                return;
+            }
+
+            const float invW = 1.0f / aClip[i].w;
+            aX[i] = (aClip[i].x * invW * 0.5f + 0.5f) * static_cast<float>(m_uWidth);
+            aY[i] = (0.5f - aClip[i].y * invW * 0.5f) * static_cast<float>(m_uHeight);
+            maxDepth = std::max(maxDepth, aClip[i].z * invW);
+        }
+        maxDepth = std::min(maxDepth, 1.0f);
+
+        float area = (aX[1] - aX[0]) * (aY[2] - aY[0]) - (aX[2] - aX[0]) * (aY[1] - aY[0]);
+        if (area == 0.0f)
+        {
+            return;
+        }
+        if (area < 0.0f)
+        {
+            std::swap(aX[1], aX[2]);
+            std::swap(aY[1], aY[2]);
+        }
+
+        const float fMinX = std::min({ aX[0], aX[1], aX[2] });
+        const float fMaxX = std::max({ aX[0], aX[1], aX[2] });
+        const float fMinY = std::min({ aY[0], aY[1], aY[2] });
+        const float fMaxY = std::max({ aY[0], aY[1], aY[2] });
+        if (fMaxX < 0.0f || fMaxY < 0.0f || fMinX >= static_cast<float>(m_uWidth) || fMinY >= static_cast<float>(m_uHeight))
+        {
+            return;
+        }
+
+        const std::uint32_t uMinX = static_cast<std::uint32_t>(std::max(fMinX, 0.0f));
+        const std::uint32_t uMinY = static_cast<std::uint32_t>(std::max(fMinY, 0.0f));
+        const std::uint32_t uMaxX = static_cast<std::uint32_t>(std::min(fMaxX, static_cast<float>(m_uWidth - 1u)));
+        const std::uint32_t uMaxY = static_cast<std::uint32_t>(std::min(fMaxY, static_cast<float>(m_uHeight - 1u)));
+
+        // Edge function of edge i evaluated at pixel (x, y) is aA[i] * x + aB[i] * y + aC[i],
+        // non negative on the inner side
+        float aA[3];
+        float aB[3];
+        float aC[3];
+        for (std::uint32_t i = 0u; i < 3u; ++i)
+        {
+            const std::uint32_t j = (i + 1u) % 3u;
+            aA[i] = aY[i] - aY[j];
+            aB[i] = aX[j] - aX[i];
+            aC[i] = -(aA[i] * aX[i] + aB[i] * aY[i]);
+        }
+
+        const XMVECTOR depth = XMVectorReplicate(maxDepth);
+        const XMVECTOR zero = XMVectorZero();
+        const XMVECTOR laneOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+        XMVECTOR aStepX[3];
+        for (std::uint32_t i = 0u; i < 3u; ++i)
+        {
+            aStepX[i] = XMVectorReplicate(aA[i] * 4.0f);
+        }
+
+        for (std::uint32_t ty = uMinY / TILE_HEIGHT; ty <= uMaxY / TILE_HEIGHT; ++ty)
+        {
+            for (std::uint32_t tx = uMinX / TILE_WIDTH; tx <= uMaxX / TILE_WIDTH; ++tx)
+            {
+                float& tileMaxDepth = m_aTileMaxDepth[static_cast<size_t>(ty) * m_uNumTilesX + tx];
+                if (tileMaxDepth <= maxDepth)
+                {
+                    continue;
+                }
+
+                const std::uint32_t uTileX = tx * TILE_WIDTH;
+                const std::uint32_t uTileY = ty * TILE_HEIGHT;
+                const float aCornerX[2] = { static_cast<float>(uTileX) + 0.5f, static_cast<float>(uTileX + TILE_WIDTH) - 0.5f };
+                const float aCornerY[2] = { static_cast<float>(uTileY) + 0.5f, static_cast<float>(uTileY + TILE_HEIGHT) - 0.5f };
+
+                bool bOutside = false;
+                bool bFullyInside = true;
+                for (std::uint32_t i = 0u; i < 3u && !bOutside; ++i)
+                {
+                    std::uint32_t uNumInside = 0u;
+                    for (std::uint32_t c = 0u; c < 4u; ++c)
+                    {
+                        if (aA[i] * aCornerX[c & 1u] + aB[i] * aCornerY[c >> 1u] + aC[i] >= 0.0f)
+                        {
+                            ++uNumInside;
+                        }
+                    }
+                    bOutside = uNumInside == 0u;
+                    bFullyInside = bFullyInside && uNumInside == 4u;
+                }
+                if (bOutside)
+                {
+                    continue;
+                }
+
+                if (bFullyInside)
+                {
+                    for (std::uint32_t y = uTileY; y < uTileY + TILE_HEIGHT; ++y)
+                    {
+                        float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                        for (std::uint32_t x = uTileX; x < uTileX + TILE_WIDTH; x += 4u)
+                        {
+                            XMFLOAT4* pDst = reinterpret_cast<XMFLOAT4*>(pRow + x);
+                            XMStoreFloat4(pDst, XMVectorMin(XMLoadFloat4(pDst), depth));
+                        }
+                    }
+                    tileMaxDepth = maxDepth;
+                    continue;
+                }
+
+                for (std::uint32_t y = uTileY; y < uTileY + TILE_HEIGHT; ++y)
+                {
+                    const float fY = static_cast<float>(y) + 0.5f;
+                    const float fX = static_cast<float>(uTileX);
+                    XMVECTOR aEdge[3];
+                    for (std::uint32_t i = 0u; i < 3u; ++i)
+                    {
+                        aEdge[i] = XMVectorMultiplyAdd(
+                            XMVectorReplicate(aA[i]),
+                            XMVectorAdd(XMVectorReplicate(fX), laneOffsets),
+                            XMVectorReplicate(aB[i] * fY + aC[i])
+                        );
+                    }
+
+                    float* pRow = &m_aDepth[static_cast<size_t>(y) * m_uWidth];
+                    for (std::uint32_t x = uTileX; x < uTileX + TILE_WIDTH; x += 4u)
+                    {
+                        const XMVECTOR inside = XMVectorAndInt(
+                            XMVectorAndInt(XMVectorGreaterOrEqual(aEdge[0], zero), XMVectorGreaterOrEqual(aEdge[1], zero)),
+                            XMVectorGreaterOrEqual(aEdge[2], zero)
+                        );
+
+                        XMFLOAT4* pDst = reinterpret_cast<XMFLOAT4*>(pRow + x);
+                        const XMVECTOR current = XMLoadFloat4(pDst);
+                        XMStoreFloat4(pDst, XMVectorSelect(current, XMVectorMin(current, depth), inside));
+
+                        for (std::uint32_t i = 0u; i < 3u; ++i)
+                        {
+                            aEdge[i] = XMVectorAdd(aEdge[i], aStepX[i]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   OcclusionCuller::projectBox
+
+      Summary:  Projects a box onto the depth buffer
+
+      Args:     const AxisAlignedBox& box
+                  World space box
+                XMFLOAT4& screenRect
+                  Receives min x, min y, max x and max y in pixels
+                float& minDepth
+                  Receives the nearest depth of the box
+
+      Returns:  bool
+                  false if the box crosses the near plane
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    bool OcclusionCuller::projectBox(_In_ const AxisAlignedBox& box, _Out_ XMFLOAT4& screenRect, _Out_ float& minDepth) const
+    {
+        XMVECTOR aCorners[8];
+        GetBoxCorners(box, aCorners);
+
+        XMVECTOR minimum = XMVectorReplicate(FLT_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-FLT_MAX);
+        for (std::uint32_t i = 0u; i < 8u; ++i)
+        {
+            const XMVECTOR clip = XMVector4Transform(aCorners[i], m_viewProjection);
+            const float w = XMVectorGetW(clip);
+            if (w <= 0.0f || XMVectorGetZ(clip) < 0.0f)
+            {
+                screenRect = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+                minDepth = 0.0f;
+                return false;
+            }
+
+            const XMVECTOR ndc = XMVectorScale(clip, 1.0f / w);
+            minimum = XMVectorMin(minimum, ndc);
+            maximum = XMVectorMax(maximum, ndc);
+        }
+
+        XMFLOAT4 ndcMin;
+        XMFLOAT4 ndcMax;
+        XMStoreFloat4(&ndcMin, minimum);
+        XMStoreFloat4(&ndcMax, maximum);
+
+        screenRect = XMFLOAT4(
+            (ndcMin.x * 0.5f + 0.5f) * static_cast<float>(m_uWidth),
+            (0.5f - ndcMax.y * 0.5f) * static_cast<float>(m_uHeight),
+            (ndcMax.x * 0.5f + 0.5f) * static_cast<float>(m_uWidth),
+            (0.5f - ndcMin.y * 0.5f) * static_cast<float>(m_uHeight)
+        );
+        minDepth = ndcMin.z;
+
+        return true;
+    }
+}
@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      OCCLUSIONCULLER.H
+
+  Summary:   OcclusionCuller header file contains declarations of
+             OcclusionCuller class used to reject renderables and
+             scene chunks hidden behind coarse occluders before they
+             are submitted to the GPU. Only depends on DirectXMath and
+             the geometry types, so it also builds outside the engine.
+
+  Classes: OcclusionCuller
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "Renderer/GeometryTypes.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    OcclusionCuller
+
+      Summary:  Software occlusion culler. Coarse occluders are
+                rasterized on the CPU into a low resolution depth
+                buffer split into tiles, then bounding boxes are
+                tested against it. Each tile keeps its farthest depth
+                so most queries are answered without touching pixels.
+
+      Methods:  BeginFrame
+                  Clears the depth buffer and stores the view
+                  projection matrix
+                RenderOccluderBox
+                  Rasterizes a solid box as an occluder
+                RenderOccluderMesh
+                  Rasterizes an indexed triangle mesh as an occluder
+                EndOccluders
+                  Builds the per-tile farthest depth
+                IsVisible
+                  Tests a world space bounding box against the depth
+                  buffer
+                SetEnabled
+                  Enables or disables culling
+                IsEnabled
+                  Returns whether culling is enabled
+                GetNumTested
+                  Returns the number of queries since BeginFrame
+                GetNumCulled
+                  Returns the number of rejected queries since
+                  BeginFrame
+                GetWidth
+                  Returns the width of the depth buffer
+                GetHeight
+                  Returns the height of the depth buffer
+                GetDepth
+                  Returns the depth stored at a pixel
+                OcclusionCuller
+                  Constructor.
+                ~OcclusionCuller
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class OcclusionCuller final
+    {
+    public:
+        static constexpr std::uint32_t TILE_WIDTH = 8u;
+        static constexpr std::uint32_t TILE_HEIGHT = 8u;
+        static constexpr std::uint32_t DEFAULT_WIDTH = 256u;
+        static constexpr std::uint32_t DEFAULT_HEIGHT = 128u;
+
+    public:
+        OcclusionCuller(_In_ std::uint32_t uWidth = DEFAULT_WIDTH, _In_ std::uint32_t uHeight = DEFAULT_HEIGHT);
+        OcclusionCuller(const OcclusionCuller& other) = delete;
+        OcclusionCuller(OcclusionCuller&& other) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller& other) = delete;
+        OcclusionCuller& operator=(OcclusionCuller&& other) = delete;
+        ~OcclusionCuller() = default;
+
+        void BeginFrame(_In_ const DirectX::XMMATRIX& viewProjection);
+        void RenderOccluderBox(_In_ const AxisAlignedBox& box);
+        void RenderOccluderMesh(_In_reads_(uNumVertices) const SimpleVertex* pVertices, _In_ std::uint32_t uNumVertices, _In_reads_(uNumIndices) const std::uint16_t* pIndices, _In_ std::uint32_t uNumIndices, _In_ const DirectX::XMMATRIX& world);
+        void EndOccluders();
+
+        bool IsVisible(_In_ const AxisAlignedBox& box);
+
+        void SetEnabled(_In_ bool bEnabled);
+        bool IsEnabled() const;
+        std::uint32_t GetNumTested() const;
+        std::uint32_t GetNumCulled() const;
+
+        std::uint32_t GetWidth() const;
+        std::uint32_t GetHeight() const;
+        float GetDepth(_In_ std::uint32_t uX, _In_ std::uint32_t uY) const;
+
+    private:
+        void rasterizeTriangle(_In_ DirectX::FXMVECTOR v0, _In_ DirectX::FXMVECTOR v1, _In_ DirectX::FXMVECTOR v2);
+        bool projectBox(_In_ const AxisAlignedBox& box, _Out_ DirectX::XMFLOAT4& screenRect, _Out_ float& minDepth) const;
+
+    private:
+        std::uint32_t m_uWidth;
+        std::uint32_t m_uHeight;
+        std::uint32_t m_uNumTilesX;
+        std::uint32_t m_uNumTilesY;
+        bool m_bEnabled;
+        std::uint32_t m_uNumTested;
+        std::uint32_t m_uNumCulled;
+        std::vector<float> m_aDepth;
+        std::vector<float> m_aTileMaxDepth;
+        std::vector<DirectX::XMVECTOR> m_aClipPositions;
+        DirectX::XMMATRIX m_viewProjection;
+    };
+}
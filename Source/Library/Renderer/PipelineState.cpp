@@ -0,0 +1,268 @@
+#include "Renderer/PipelineState.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::PipelineState
+
+      Summary:  Constructor of a pipeline state with the default states
+
+      Args:     const std::shared_ptr<VertexShader>& vertexShader
+                  Vertex shader, with its input layout
+                const std::shared_ptr<PixelShader>& pixelShader
+                  Pixel shader
+
+      Modifies: [m_vertexShader, m_pixelShader, m_desc,
+                 m_rasterizerState, m_blendState, m_depthStencilState,
+                 m_samplerState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PipelineState::PipelineState(
+        _In_ const std::shared_ptr<VertexShader>& vertexShader,
+        _In_ const std::shared_ptr<PixelShader>& pixelShader
+    )
+        : PipelineState(vertexShader, pixelShader, GetDefaultDesc())
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::PipelineState
+
+      Summary:  Constructor
+
+      Args:     const std::shared_ptr<VertexShader>& vertexShader
+                  Vertex shader, with its input layout
+                const std::shared_ptr<PixelShader>& pixelShader
+                  Pixel shader
+                const PipelineStateDesc& desc
+                  Fixed function states and object constant bindings
+
+      Modifies: [m_vertexShader, m_pixelShader, m_desc,
+                 m_rasterizerState, m_blendState, m_depthStencilState,
+                 m_samplerState].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PipelineState::PipelineState(
+        _In_ const std::shared_ptr<VertexShader>& vertexShader,
+        _In_ const std::shared_ptr<PixelShader>& pixelShader,
+        _In_ const PipelineStateDesc& desc
+    )
+        : m_vertexShader(vertexShader)
+        , m_pixelShader(pixelShader)
+        , m_desc(desc)
+        , m_rasterizerState()
+        , m_blendState()
+        , m_depthStencilState()
+        , m_samplerState()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::Initialize
+
+      Summary:  Checks that the shaders are compiled and the vertex
+                shader has an input layout, then creates the states.
+                Must be called after the shaders are initialized
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the states
+
+      Modifies: [m_rasterizerState, m_blendState, m_depthStencilState,
+                 m_samplerState].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if a shader is missing or
+                  not compiled
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT PipelineState::Initialize(_In_ ID3D11Device* pDevice)
+    {
+        HRESULT hr = S_OK;
+
+        if (!m_vertexShader || !m_pixelShader ||
+            !m_vertexShader->GetVertexShader() || !m_vertexShader->GetVertexLayout() ||
+            !m_pixelShader->GetPixelShader())
+        {
+            return E_INVALIDARG;
+        }
+
+        hr = pDevice->CreateRasterizerState(&m_desc.Rasterizer, m_rasterizerState.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        hr = pDevice->CreateBlendState(&m_desc.Blend, m_blendState.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        hr = pDevice->CreateDepthStencilState(&m_desc.DepthStencil, m_depthStencilState.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        hr = pDevice->CreateSamplerState(&m_desc.Sampler, m_samplerState.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::GetDefaultDesc
+
+      Summary:  Returns the Direct3D default rasterizer, blend and depth
+                stencil states, the linear wrap sampler of the textures,
+                and the object constants in register b2 of both shaders
+
+      Returns:  PipelineStateDesc
+                  Default description
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    PipelineStateDesc PipelineState::GetDefaultDesc()
+    {
+        const D3D11_DEPTH_STENCILOP_DESC stencilOp =
+        {
+            .StencilFailOp = D3D11_STENCIL_OP_KEEP,
+            .StencilDepthFailOp = D3D11_STENCIL_OP_KEEP,
+            .StencilPassOp = D3D11_STENCIL_OP_KEEP,
+            .StencilFunc = D3D11_COMPARISON_ALWAYS,
+        };
+
+        PipelineStateDesc desc =
+        {
+            .Rasterizer =
+            {
+                .FillMode = D3D11_FILL_SOLID,
+                .CullMode = D3D11_CULL_BACK,
+                .FrontCounterClockwise = FALSE,
+                .DepthBias = D3D11_DEFAULT_DEPTH_BIAS,
+                .DepthBiasClamp = D3D11_DEFAULT_DEPTH_BIAS_CLAMP,
+                .SlopeScaledDepthBias = D3D11_DEFAULT_SLOPE_SCALED_DEPTH_BIAS,
+                .DepthClipEnable = TRUE,
+                .ScissorEnable = FALSE,
+                .MultisampleEnable = FALSE,
+                .AntialiasedLineEnable = FALSE,
+            },
+            .Blend =
+            {
+                .AlphaToCoverageEnable = FALSE,
+                .IndependentBlendEnable = FALSE,
+            },
+            .DepthStencil =
+            {
+                .DepthEnable = TRUE,
+                .DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL,
+                .DepthFunc = D3D11_COMPARISON_LESS,
+                .StencilEnable = FALSE,
+                .StencilReadMask = D3D11_DEFAULT_STENCIL_READ_MASK,
+                .StencilWriteMask = D3D11_DEFAULT_STENCIL_WRITE_MASK,
+                .FrontFace = stencilOp,
+                .BackFace = stencilOp,
+            },
+            .Sampler =
+            {
+                .Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+                .AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
+                .AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
+                .AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
+                .ComparisonFunc = D3D11_COMPARISON_NEVER,
+                .MinLOD = 0,
+                .MaxLOD = D3D11_FLOAT32_MAX,
+            },
+            .uObjectConstantsSlot = OBJECT_CONSTANTS_SLOT,
+            .bVertexShaderObjectConstants = TRUE,
+            .bPixelShaderObjectConstants = TRUE,
+        };
+
+        for (D3D11_RENDER_TARGET_BLEND_DESC& renderTarget : desc.Blend.RenderTarget)
+        {
+            renderTarget =
+            {
+                .BlendEnable = FALSE,
+                .SrcBlend = D3D11_BLEND_ONE,
+                .DestBlend = D3D11_BLEND_ZERO,
+                .BlendOp = D3D11_BLEND_OP_ADD,
+                .SrcBlendAlpha = D3D11_BLEND_ONE,
+                .DestBlendAlpha = D3D11_BLEND_ZERO,
+                .BlendOpAlpha = D3D11_BLEND_OP_ADD,
+                .RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL,
+            };
+        }
+
+        return desc;
+    }
+
+    ID3D11VertexShader* PipelineState::GetVertexShader() const
+    {
+        return m_vertexShader->GetVertexShader().Get();
+    }
+
+    ID3D11PixelShader* PipelineState::GetPixelShader() const
+    {
+        return m_pixelShader->GetPixelShader().Get();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::GetShaderObjects
+
+      Summary:  Returns the shader objects of the pipeline, which have
+                to be initialized before it, compiled or not
+
+      Args:     const VertexShader** ppVertexShader
+                  Receives the vertex shader, nullptr if there is none
+                const PixelShader** ppPixelShader
+                  Receives the pixel shader, nullptr if there is none
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void PipelineState::GetShaderObjects(_Out_ const VertexShader** ppVertexShader, _Out_ const PixelShader** ppPixelShader) const
+    {
+        *ppVertexShader = m_vertexShader.get();
+        *ppPixelShader = m_pixelShader.get();
+    }
+
+    ID3D11InputLayout* PipelineState::GetVertexLayout() const
+    {
+        return m_vertexShader->GetVertexLayout().Get();
+    }
+
+    ID3D11RasterizerState* PipelineState::GetRasterizerState() const
+    {
+        return m_rasterizerState.Get();
+    }
+
+    ID3D11BlendState* PipelineState::GetBlendState() const
+    {
+        return m_blendState.Get();
+    }
+
+    ID3D11DepthStencilState* PipelineState::GetDepthStencilState() const
+    {
+        return m_depthStencilState.Get();
+    }
+
+    ID3D11SamplerState* PipelineState::GetSamplerState() const
+    {
+        return m_samplerState.Get();
+    }
+
+    UINT PipelineState::GetObjectConstantsSlot() const
+    {
+        return m_desc.uObjectConstantsSlot;
+    }
+
+    BOOL PipelineState::HasVertexShaderObjectConstants() const
+    {
+        return m_desc.bVertexShaderObjectConstants;
+    }
+
+    BOOL PipelineState::HasPixelShaderObjectConstants() const
+    {
+        return m_desc.bPixelShaderObjectConstants;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   PipelineState::IsInitialized
+
+      Summary:  Returns whether the states have been created
+
+      Returns:  BOOL
+                  Whether Initialize succeeded
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL PipelineState::IsInitialized() const
+    {
+        return m_samplerState != nullptr;
+    }
+}
@@ -0,0 +1,146 @@
+/*+===================================================================
+  File:      PIPELINESTATE.H
+
+  Summary:   PipelineState header file contains declarations of the
+             immutable bundle of the pipeline states a draw needs
+             besides its buffers and textures.
+
+  Classes: PipelineState
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/PixelShader.h"
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   PipelineStateDesc
+
+      Summary:  Fixed function states of a pipeline state and the
+                bindings of the constant buffer of the drawn object
+
+      Members:  D3D11_RASTERIZER_DESC Rasterizer
+                  Rasterizer state
+                D3D11_BLEND_DESC Blend
+                  Blend state
+                D3D11_DEPTH_STENCIL_DESC DepthStencil
+                  Depth stencil state
+                D3D11_SAMPLER_DESC Sampler
+                  Sampler bound to register s0 of the pixel shader
+                UINT uObjectConstantsSlot
+                  Register of the constant buffer of the object
+                BOOL bVertexShaderObjectConstants
+                  Whether the vertex shader reads the object constants
+                BOOL bPixelShaderObjectConstants
+                  Whether the pixel shader reads the object constants
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct PipelineStateDesc
+    {
+        D3D11_RASTERIZER_DESC Rasterizer;
+        D3D11_BLEND_DESC Blend;
+        D3D11_DEPTH_STENCIL_DESC DepthStencil;
+        D3D11_SAMPLER_DESC Sampler;
+        UINT uObjectConstantsSlot;
+        BOOL bVertexShaderObjectConstants;
+        BOOL bPixelShaderObjectConstants;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    PipelineState
+
+      Summary:  Input layout, shaders, object constant buffer slots,
+                sampler, and rasterizer, blend and depth stencil states
+                of a kind of draw. The states are created and the
+                shaders checked once in Initialize, then the bundle
+                never changes and is applied by the render backend
+                with one call
+
+      Methods:  Initialize
+                  Checks the shaders and creates the states
+                GetDefaultDesc
+                  Returns the states the pipeline used before bundles
+                GetVertexShader
+                  Returns the vertex shader
+                GetPixelShader
+                  Returns the pixel shader
+                GetShaderObjects
+                  Returns the shader objects compiled into the pipeline
+                GetVertexLayout
+                  Returns the input layout
+                GetRasterizerState
+                  Returns the rasterizer state
+                GetBlendState
+                  Returns the blend state
+                GetDepthStencilState
+                  Returns the depth stencil state
+                GetSamplerState
+                  Returns the sampler state
+                GetObjectConstantsSlot
+                  Returns the register of the object constants
+                HasVertexShaderObjectConstants
+                  Returns whether the vertex shader reads the object
+                  constants
+                HasPixelShaderObjectConstants
+                  Returns whether the pixel shader reads the object
+                  constants
+                IsInitialized
+                  Returns whether the states have been created
+                PipelineState
+                  Constructor.
+                ~PipelineState
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class PipelineState final
+    {
+    public:
+        static constexpr UINT OBJECT_CONSTANTS_SLOT = 2u;
+
+    public:
+        PipelineState() = delete;
+        PipelineState(
+            _In_ const std::shared_ptr<VertexShader>& vertexShader,
+            _In_ const std::shared_ptr<PixelShader>& pixelShader
+        );
+        PipelineState(
+            _In_ const std::shared_ptr<VertexShader>& vertexShader,
+            _In_ const std::shared_ptr<PixelShader>& pixelShader,
+            _In_ const PipelineStateDesc& desc
+        );
+        PipelineState(const PipelineState& other) = delete;
+        PipelineState(PipelineState&& other) = delete;
+        PipelineState& operator=(const PipelineState& other) = delete;
+        PipelineState& operator=(PipelineState&& other) = delete;
+        ~PipelineState() = default;
+
+        HRESULT Initialize(_In_ ID3D11Device* pDevice);
+
+        static PipelineStateDesc GetDefaultDesc();
+
+        ID3D11VertexShader* GetVertexShader() const;
+        ID3D11PixelShader* GetPixelShader() const;
+        void GetShaderObjects(_Out_ const VertexShader** ppVertexShader, _Out_ const PixelShader** ppPixelShader) const;
+        ID3D11InputLayout* GetVertexLayout() const;
+        ID3D11RasterizerState* GetRasterizerState() const;
+        ID3D11BlendState* GetBlendState() const;
+        ID3D11DepthStencilState* GetDepthStencilState() const;
+        ID3D11SamplerState* GetSamplerState() const;
+        UINT GetObjectConstantsSlot() const;
+        BOOL HasVertexShaderObjectConstants() const;
+        BOOL HasPixelShaderObjectConstants() const;
+        BOOL IsInitialized() const;
+
+    private:
+        std::shared_ptr<VertexShader> m_vertexShader;
+        std::shared_ptr<PixelShader> m_pixelShader;
+        PipelineStateDesc m_desc;
+        ComPtr<ID3D11RasterizerState> m_rasterizerState;
+        ComPtr<ID3D11BlendState> m_blendState;
+        ComPtr<ID3D11DepthStencilState> m_depthStencilState;
+        ComPtr<ID3D11SamplerState> m_samplerState;
+    };
+}
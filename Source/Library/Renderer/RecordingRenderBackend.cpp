@@ -0,0 +1,44 @@
+#include "Renderer/RecordingRenderBackend.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingRenderBackend::RecordingRenderBackend
+
+      Summary:  Constructor
+
+      Modifies: [m_uNumFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    RecordingRenderBackend::RecordingRenderBackend()
+        : CommandBuffer()
+        , m_uNumFrames(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingRenderBackend::BeginFrame
+
+      Summary:  Discards the commands of the previous frame. The
+                storage is kept, so a steady frame does not allocate
+
+      Modifies: [m_uNumFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void RecordingRenderBackend::BeginFrame()
+    {
+        Reset();
+        ++m_uNumFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   RecordingRenderBackend::GetNumFrames
+
+      Summary:  Returns the number of frames begun on this backend
+
+      Returns:  UINT64
+                  Number of frames
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT64 RecordingRenderBackend::GetNumFrames() const
+    {
+        return m_uNumFrames;
+    }
+}
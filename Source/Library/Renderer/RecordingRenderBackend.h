@@ -0,0 +1,55 @@
+/*+===================================================================
+  File:      RECORDINGRENDERBACKEND.H
+
+  Summary:   RecordingRenderBackend header file contains declarations
+             of the render backend that stores the commands of a frame
+             instead of executing them, so the frame loop can run and
+             be measured without a GPU.
+
+  Classes: RecordingRenderBackend
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/CommandBuffer.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RecordingRenderBackend
+
+      Summary:  Render backend that never touches a device context. It
+                keeps the commands of the current frame, with copies of
+                the uploaded data, and counts them per type. Command
+                buffers executed on it are appended in order
+
+      Methods:  BeginFrame
+                  Discards the commands of the previous frame
+                GetNumFrames
+                  Returns the number of frames begun
+                RecordingRenderBackend
+                  Constructor.
+                ~RecordingRenderBackend
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RecordingRenderBackend final : public CommandBuffer
+    {
+    public:
+        RecordingRenderBackend();
+        RecordingRenderBackend(const RecordingRenderBackend& other) = delete;
+        RecordingRenderBackend(RecordingRenderBackend&& other) = delete;
+        RecordingRenderBackend& operator=(const RecordingRenderBackend& other) = delete;
+        RecordingRenderBackend& operator=(RecordingRenderBackend&& other) = delete;
+        ~RecordingRenderBackend() = default;
+
+        void BeginFrame() override;
+
+        UINT64 GetNumFrames() const;
+
+    private:
+        UINT64 m_uNumFrames;
+    };
+}
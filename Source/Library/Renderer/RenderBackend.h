@@ -0,0 +1,114 @@
+/*+===================================================================
+  File:      RENDERBACKEND.H
+
+  Summary:   RenderBackend header file contains declarations of the
+             RenderBackend interface through which the Renderer
+             submits the commands of a frame.
+
+  Classes: RenderBackend
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    class CommandBuffer;
+    class PipelineState;
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    RenderBackend
+
+      Summary:  Interface receiving the pipeline state changes, buffer
+                uploads and draw calls of a frame. Resources are still
+                Direct3D objects created by the device, the backend
+                only decides what to do with the commands
+
+      Methods:  BeginFrame
+                  Called before the first command of a frame
+                ClearRenderTarget
+                  Clears the back buffer
+                ClearDepthStencil
+                  Clears the depth stencil buffer
+                UpdateBuffer
+                  Uploads the first bytes of a buffer, constant
+                  buffers are uploaded whole
+                SetPrimitiveTopology
+                  Sets the primitive topology
+                SetVertexBuffer
+                  Binds a vertex buffer to an input slot
+                SetIndexBuffer
+                  Binds the index buffer
+                SetInputLayout
+                  Binds the input layout
+                SetVertexShader
+                  Binds the vertex shader
+                SetPixelShader
+                  Binds the pixel shader
+                SetVertexShaderConstantBuffer
+                  Binds a constant buffer to the vertex shader
+                SetPixelShaderConstantBuffer
+                  Binds a constant buffer to the pixel shader
+                SetVertexShaderResource
+                  Binds a shader resource view to the vertex shader
+                SetPixelShaderResource
+                  Binds a shader resource view to the pixel shader
+                SetPixelShaderSampler
+                  Binds a sampler to the pixel shader
+                SetPipelineState
+                  Binds the input layout, shaders, sampler and fixed
+                  function states of a pipeline state, and the
+                  constant buffer of the drawn object
+                Draw
+                  Draws non-indexed primitives
+                DrawIndexed
+                  Draws indexed primitives
+                DrawIndexedInstanced
+                  Draws instanced indexed primitives
+                ExecuteCommandBuffers
+                  Executes recorded command buffers in order
+                Present
+                  Ends the frame
+                RenderBackend
+                  Constructor.
+                ~RenderBackend
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class RenderBackend
+    {
+    public:
+        RenderBackend() = default;
+        RenderBackend(const RenderBackend& other) = delete;
+        RenderBackend(RenderBackend&& other) = delete;
+        RenderBackend& operator=(const RenderBackend& other) = delete;
+        RenderBackend& operator=(RenderBackend&& other) = delete;
+        virtual ~RenderBackend() = default;
+
+        virtual void BeginFrame() = 0;
+        virtual void ClearRenderTarget(_In_ const FLOAT aClearColor[4]) = 0;
+        virtual void ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil) = 0;
+        virtual void UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) = 0;
+
+        virtual void SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+        virtual void SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset) = 0;
+        virtual void SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format) = 0;
+        virtual void SetInputLayout(_In_ ID3D11InputLayout* pInputLayout) = 0;
+        virtual void SetVertexShader(_In_ ID3D11VertexShader* pVertexShader) = 0;
+        virtual void SetPixelShader(_In_ ID3D11PixelShader* pPixelShader) = 0;
+        virtual void SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) = 0;
+        virtual void SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) = 0;
+        virtual void SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) = 0;
+        virtual void SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) = 0;
+        virtual void SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState) = 0;
+        virtual void SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants) = 0;
+
+        virtual void Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex) = 0;
+        virtual void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex) = 0;
+        virtual void DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance) = 0;
+        virtual void ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers) = 0;
+
+        virtual void Present() = 0;
+    };
+}
@@ -13,9 +13,10 @@ namespace library
 				  Default color of the renderable
 
 	  Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
-				 m_textureRV, m_samplerLinear, m_vertexShader,
-				 m_pixelShader, m_textureFilePath, m_outputColor,
-				 m_world].
+				 m_textureRV, m_samplerLinear, m_pipelineState,
+				 m_textureFilePath, m_outputColor,
+				 m_world, m_previousWorld, m_bStatic,
+				 m_bHasPreviousWorld].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	/*--------------------------------------------------------------------
 	  TODO: Renderable::Renderable definition (remove the comment)
@@ -27,11 +28,14 @@ namespace library
 		m_constantBuffer(nullptr),
 		m_aMeshes(std::vector<BasicMeshEntry>()),
 		m_aMaterials(std::vector<Material>()),
-		m_vertexShader(nullptr),
-		m_pixelShader(nullptr),
+		m_pipelineState(nullptr),
 		m_outputColor(outputColor),
 		m_padding(),
-		m_world(XMMatrixIdentity())
+		m_world(XMMatrixIdentity()),
+		m_previousWorld(XMMatrixIdentity()),
+		m_localBounds(),
+		m_bStatic(FALSE),
+		m_bHasPreviousWorld(FALSE)
 
 	{};
 
@@ -47,7 +51,8 @@ namespace library
 				ID3D11DeviceContext* pImmediateContext
 				  The Direct3D context to set buffers
 
-	  Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer].
+	  Modifies: [m_vertexBuffer, m_indexBuffer, m_constantBuffer,
+				 m_localBounds].
 
 	  Returns:  HRESULT
 				  Status code
@@ -59,6 +64,22 @@ namespace library
 	{
 		HRESULT hr = S_OK;
 
+		// Compute the object space bounds used for culling
+		const SimpleVertex* pVertices = getVertices();
+		if (pVertices && GetNumVertices() > 0u)
+		{
+			XMVECTOR minimum = XMLoadFloat3(&pVertices[0].Position);
+			XMVECTOR maximum = minimum;
+			for (UINT i = 1u; i < GetNumVertices(); ++i)
+			{
+				const XMVECTOR position = XMLoadFloat3(&pVertices[i].Position);
+				minimum = XMVectorMin(minimum, position);
+				maximum = XMVectorMax(maximum, position);
+			}
+			XMStoreFloat3(&m_localBounds.Min, minimum);
+			XMStoreFloat3(&m_localBounds.Max, maximum);
+		}
+
 		// Create the vertex buffer
 		D3D11_BUFFER_DESC bd =
 		{
@@ -157,135 +178,210 @@ namespace library
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::SetVertexShader
+	  Method:   Renderable::SetPipelineState
 
-	  Summary:  Sets the vertex shader to be used for this renderable
-				object
+	  Summary:  Sets the pipeline state drawing this renderable object
 
-	  Args:     const std::shared_ptr<VertexShader>& vertexShader
-				  Vertex shader to set to
+	  Args:     const std::shared_ptr<PipelineState>& pipelineState
+				  Pipeline state to set to
 
-	  Modifies: [m_vertexShader].
+	  Modifies: [m_pipelineState].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Renderable::SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader)
+	void Renderable::SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState)
 	{
-		m_vertexShader = vertexShader;
-
+		m_pipelineState = pipelineState;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::SetPixelShader
+	  Method:   Renderable::GetPipelineState
+
+	  Summary:  Returns the pipeline state drawing this renderable
+
+	  Returns:  const std::shared_ptr<PipelineState>&
+				  Pipeline state. Could be a nullptr
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const std::shared_ptr<PipelineState>& Renderable::GetPipelineState() const
+	{
+		return m_pipelineState;
+	}
 
-	  Summary:  Sets the pixel shader to be used for this renderable
-				object
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetVertexBuffer
 
-	  Args:     const std::shared_ptr<PixelShader>& pixelShader
-				  Pixel shader to set to
+	  Summary:  Returns the vertex buffer
 
-	  Modifies: [m_pixelShader].
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  Vertex buffer
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Renderable::SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader)
+	ComPtr<ID3D11Buffer>& Renderable::GetVertexBuffer()
 	{
-		m_pixelShader = pixelShader;
+		return m_vertexBuffer;
 
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetVertexShader
+	  Method:   Renderable::GetIndexBuffer
 
-	  Summary:  Returns the vertex shader
+	  Summary:  Returns the index buffer
 
-	  Returns:  ComPtr<ID3D11VertexShader>&
-				  Vertex shader. Could be a nullptr
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  Index buffer
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11VertexShader>& Renderable::GetVertexShader()
+	ComPtr<ID3D11Buffer>& Renderable::GetIndexBuffer()
 	{
-		return m_vertexShader->GetVertexShader();
+		return m_indexBuffer;
 
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetPixelShader
+	  Method:   Renderable::GetConstantBuffer
 
-	  Summary:  Returns the vertex shader
+	  Summary:  Returns the constant buffer
 
-	  Returns:  ComPtr<ID3D11PixelShader>&
-				  Pixel shader. Could be a nullptr
+	  Returns:  ComPtr<ID3D11Buffer>&
+				  Constant buffer
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11PixelShader>& Renderable::GetPixelShader()
+	ComPtr<ID3D11Buffer>& Renderable::GetConstantBuffer()
 	{
-		return m_pixelShader->GetPixelShader();
+		return m_constantBuffer;
 
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetVertexLayout
+		  Method:   Renderable::GetWorldMatrix
 
-	  Summary:  Returns the vertex input layout
+		  Summary:  Returns the world matrix
 
-	  Returns:  ComPtr<ID3D11InputLayout>&
-				  Vertex input layout
+		  Returns:  const XMMATRIX&
+					  World matrix
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11InputLayout>& Renderable::GetVertexLayout()
+	const XMMATRIX& Renderable::GetWorldMatrix() const
 	{
-		return m_vertexShader->GetVertexLayout();
+		return m_world;
 
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetVertexBuffer
+	  Method:   Renderable::StorePreviousWorldMatrix
 
-	  Summary:  Returns the vertex buffer
+	  Summary:  Keeps the world matrix before a simulation step, the
+				start of the interpolation
 
-	  Returns:  ComPtr<ID3D11Buffer>&
-				  Vertex buffer
+	  Modifies: [m_previousWorld, m_bHasPreviousWorld].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11Buffer>& Renderable::GetVertexBuffer()
+	void Renderable::StorePreviousWorldMatrix()
 	{
-		return m_vertexBuffer;
-
+		m_previousWorld = m_world;
+		m_bHasPreviousWorld = TRUE;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetIndexBuffer
+	  Method:   Renderable::GetInterpolatedWorldMatrix
 
-	  Summary:  Returns the index buffer
+	  Summary:  Returns the world matrix between the one before the
+				last simulation step and the current one. The scale and
+				translation are blended linearly and the rotation
+				spherically. A renderable that never stepped, did not
+				move or whose matrix does not decompose is drawn at its
+				current world matrix
 
-	  Returns:  ComPtr<ID3D11Buffer>&
-				  Index buffer
+	  Args:     FLOAT alpha
+				  Fraction of a step elapsed since the last one, from 0
+				  for the previous matrix to 1 for the current one
+
+	  Returns:  XMMATRIX
+				  Interpolated world matrix
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11Buffer>& Renderable::GetIndexBuffer()
+	XMMATRIX Renderable::GetInterpolatedWorldMatrix(_In_ FLOAT alpha) const
 	{
-		return m_indexBuffer;
+		if (!m_bHasPreviousWorld || alpha >= 1.0f)
+		{
+			return m_world;
+		}
+
+		if (XMVector4Equal(m_previousWorld.r[0], m_world.r[0]) && XMVector4Equal(m_previousWorld.r[1], m_world.r[1])
+			&& XMVector4Equal(m_previousWorld.r[2], m_world.r[2]) && XMVector4Equal(m_previousWorld.r[3], m_world.r[3]))
+		{
+			return m_world;
+		}
 
+		XMVECTOR previousScale, previousRotation, previousTranslation;
+		XMVECTOR scale, rotation, translation;
+		if (!XMMatrixDecompose(&previousScale, &previousRotation, &previousTranslation, m_previousWorld)
+			|| !XMMatrixDecompose(&scale, &rotation, &translation, m_world))
+		{
+			return m_world;
+		}
+
+		return XMMatrixAffineTransformation(
+			XMVectorLerp(previousScale, scale, alpha),
+			XMVectorZero(),
+			XMQuaternionSlerp(previousRotation, rotation, alpha),
+			XMVectorLerp(previousTranslation, translation, alpha)
+		);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderable::GetConstantBuffer
+	  Method:   Renderable::GetBoundingBox
 
-	  Summary:  Returns the constant buffer
+	  Summary:  Returns the world space box enclosing the object space
+				bounds transformed by the world matrix
 
-	  Returns:  ComPtr<ID3D11Buffer>&
-				  Constant buffer
+	  Returns:  AxisAlignedBox
+				  World space bounding box
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	ComPtr<ID3D11Buffer>& Renderable::GetConstantBuffer()
+	AxisAlignedBox Renderable::GetBoundingBox() const
 	{
-		return m_constantBuffer;
+		XMVECTOR minimum = XMVectorReplicate(D3D11_FLOAT32_MAX);
+		XMVECTOR maximum = XMVectorReplicate(-D3D11_FLOAT32_MAX);
+		for (UINT i = 0u; i < 8u; ++i)
+		{
+			const XMVECTOR corner = XMVector3TransformCoord(
+				XMVectorSet(
+					(i & 1u) ? m_localBounds.Max.x : m_localBounds.Min.x,
+					(i & 2u) ? m_localBounds.Max.y : m_localBounds.Min.y,
+					(i & 4u) ? m_localBounds.Max.z : m_localBounds.Min.z,
+					1.0f
+				),
+				m_world
+			);
+			minimum = XMVectorMin(minimum, corner);
+			maximum = XMVectorMax(maximum, corner);
+		}
 
+		AxisAlignedBox box;
+		XMStoreFloat3(&box.Min, minimum);
+		XMStoreFloat3(&box.Max, maximum);
+		return box;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-		  Method:   Renderable::GetWorldMatrix
+	  Method:   Renderable::GetLocalBoundingBox
 
-		  Summary:  Returns the world matrix
+	  Summary:  Returns the bounds of the vertices in object space,
+				computed when the object is initialized
 
-		  Returns:  const XMMATRIX&
-					  World matrix
+	  Returns:  const AxisAlignedBox&
+				  Object space bounding box
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	const XMMATRIX& Renderable::GetWorldMatrix() const
+	const AxisAlignedBox& Renderable::GetLocalBoundingBox() const
 	{
-		return m_world;
+		return m_localBounds;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::RenderOccluder
 
+	  Summary:  Rasterizes the triangles of the object into the depth
+				buffer of an occlusion culler. Only meaningful for
+				large opaque objects
+
+	  Args:     OcclusionCuller& occlusionCuller
+				  Culler to draw into
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderable::RenderOccluder(_In_ OcclusionCuller& occlusionCuller) const
+	{
+		occlusionCuller.RenderOccluderMesh(getVertices(), GetNumVertices(), getIndices(), GetNumIndices(), m_world);
 	}
 
 
@@ -441,6 +537,34 @@ namespace library
 		m_world *= XMMatrixTranslationFromVector(offset);
 
 	}
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetVertices
+
+	  Summary:  Returns the vertices kept on the CPU, used by the
+				software renderer
+
+	  Returns:  const SimpleVertex*
+				  Array of GetNumVertices vertices
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const SimpleVertex* Renderable::GetVertices() const
+	{
+		return getVertices();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::GetIndices
+
+	  Summary:  Returns the indices kept on the CPU, used by the
+				software renderer
+
+	  Returns:  const WORD*
+				  Array of GetNumIndices indices
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const WORD* Renderable::GetIndices() const
+	{
+		return getIndices();
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderable::GetNumMeshes
 
@@ -466,4 +590,35 @@ namespace library
 	{
 		return static_cast<UINT>(m_aMaterials.size());
 	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::SetStatic
+
+	  Summary:  Marks the renderable as never moving once it is added
+				to the renderer, which then draws it from the static
+				batches with its world matrix at that time. Has to be
+				set before the renderable is added
+
+	  Args:     BOOL bStatic
+				  Whether the renderable never moves
+
+	  Modifies: [m_bStatic].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderable::SetStatic(_In_ BOOL bStatic)
+	{
+		m_bStatic = bStatic;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderable::IsStatic
+
+	  Summary:  Returns whether the renderable never moves
+
+	  Returns:  BOOL
+				  Whether the renderable is drawn from the static batches
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	BOOL Renderable::IsStatic() const
+	{
+		return m_bStatic;
+	}
 }
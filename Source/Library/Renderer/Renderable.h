@@ -14,8 +14,8 @@
 #include "Common.h"
 
 #include "Renderer/DataTypes.h"
-#include "Shader/PixelShader.h"
-#include "Shader/VertexShader.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PipelineState.h"
 #include "Texture/Material.h"
 
 namespace library
@@ -30,6 +30,10 @@ namespace library
                 Update
                   Pure virtual function that updates the object each
                   frame
+                SetPipelineState
+                  Sets the pipeline state drawing the object
+                GetPipelineState
+                  Returns the pipeline state drawing the object
                 GetVertexBuffer
                   Returns the vertex buffer
                 GetIndexBuffer
@@ -38,12 +42,31 @@ namespace library
                   Returns the constant buffer
                 GetWorldMatrix
                   Returns the world matrix
+                StorePreviousWorldMatrix
+                  Keeps the world matrix before a simulation step
+                GetInterpolatedWorldMatrix
+                  Returns the world matrix between the last two
+                  simulation steps
+                GetBoundingBox
+                  Returns the world space bounding box
+                GetLocalBoundingBox
+                  Returns the object space bounding box
+                RenderOccluder
+                  Rasterizes the object into an occlusion culler
+                GetVertices
+                  Returns the vertices of the object
+                GetIndices
+                  Returns the indices of the object
                 GetNumVertices
                   Pure virtual function that returns the number of
                   vertices
                 GetNumIndices
                   Pure virtual function that returns the number of
                   indices
+                SetStatic
+                  Marks the renderable as never moving
+                IsStatic
+                  Returns whether the renderable never moves
                 Renderable
                   Constructor.
                 ~Renderable
@@ -80,17 +103,21 @@ namespace library
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext) = 0;
         virtual void Update(_In_ FLOAT deltaTime) = 0;
 
-        void SetVertexShader(_In_ const std::shared_ptr<VertexShader>& vertexShader);
-        void SetPixelShader(_In_ const std::shared_ptr<PixelShader>& pixelShader);
+        void SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState);
+        const std::shared_ptr<PipelineState>& GetPipelineState() const;
 
-        ComPtr<ID3D11VertexShader>& GetVertexShader();
-        ComPtr<ID3D11PixelShader>& GetPixelShader();
-        ComPtr<ID3D11InputLayout>& GetVertexLayout();
         ComPtr<ID3D11Buffer>& GetVertexBuffer();
         ComPtr<ID3D11Buffer>& GetIndexBuffer();
         ComPtr<ID3D11Buffer>& GetConstantBuffer();
 
         const XMMATRIX& GetWorldMatrix() const;
+        void StorePreviousWorldMatrix();
+        XMMATRIX GetInterpolatedWorldMatrix(_In_ FLOAT alpha) const;
+        AxisAlignedBox GetBoundingBox() const;
+        const AxisAlignedBox& GetLocalBoundingBox() const;
+        void RenderOccluder(_In_ OcclusionCuller& occlusionCuller) const;
+        const SimpleVertex* GetVertices() const;
+        const WORD* GetIndices() const;
         const XMFLOAT4& GetOutputColor() const;
         BOOL HasTexture() const;
         const Material& GetMaterial(UINT uIndex) const;
@@ -108,6 +135,9 @@ namespace library
 
         UINT GetNumMeshes() const;
         UINT GetNumMaterials() const;
+
+        void SetStatic(_In_ BOOL bStatic);
+        BOOL IsStatic() const;
     protected:
         const virtual SimpleVertex* getVertices() const = 0;
         virtual const WORD* getIndices() const = 0;
@@ -124,11 +154,14 @@ namespace library
         std::vector<BasicMeshEntry> m_aMeshes;
         std::vector<Material> m_aMaterials;
 
-        std::shared_ptr<VertexShader> m_vertexShader;
-        std::shared_ptr<PixelShader> m_pixelShader;
+        std::shared_ptr<PipelineState> m_pipelineState;
 
         XMFLOAT4 m_outputColor;
         BYTE m_padding[8];
         XMMATRIX m_world;
+        XMMATRIX m_previousWorld;
+        AxisAlignedBox m_localBounds;
+        BOOL m_bStatic;
+        BOOL m_bHasPreviousWorld;
     };
 }
@@ -1,4 +1,10 @@
-#include "Renderer/Renderer.h"
+﻿#include "Renderer/Renderer.h"
+
+#include <algorithm>
+#include <execution>
+#include <tuple>
+#include <thread>
+#include <unordered_map>
 
 namespace library {
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -10,8 +16,24 @@ namespace library {
 				 m_immediateContext, m_immediateContext1, m_swapChain,
 				 m_swapChain1, m_renderTargetView, m_depthStencil,
 				 m_depthStencilView, m_cbChangeOnResize, m_camera,
-				 m_projection, m_renderables, m_vertexShaders,
-				 m_pixelShaders].
+				 m_projection, m_interpolatedView, m_interpolatedEye,
+				 m_renderables, m_modelCrowds,
+				 m_vertexShaders, m_pixelShaders, m_pipelineStates,
+				 m_entityMeshes, m_entities, m_occluders,
+				 m_occlusionCuller, m_backend, m_aCommandBuffers, m_apCommandBuffers,
+				 m_frameArena, m_apVisibleRenderables,
+				 m_aInstancedPipelineStates, m_aRenderableBatchKeys,
+				 m_aRenderableBatches, m_aRenderableInstances,
+				 m_renderableInstanceBuffer, m_uRenderableInstanceCapacity,
+				 m_apVisibleModels, m_auVisibleEntities,
+				 m_aChunkVisibilities, m_frameGraph, m_lightCuller,
+				 m_uSkinningUploadBytes, m_staticBatcher, m_debugDraw,
+				 m_tracingBackend, m_jobSystem, m_assetLoader, m_frameSnapshots,
+				 m_aRetiredObjects, m_uNumBuiltFrames, m_uLastAcquiredFrame,
+				 m_uLastSubmittedFrame, m_interpolationAlpha,
+				 m_heapAllocationCheck, m_bHeapAllocationCheck,
+				 m_framePipeline, m_startupGraph, m_startupGraphBeginSeconds,
+				 m_timeToFirstFrame].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	Renderer::Renderer() :
 		m_driverType(D3D_DRIVER_TYPE_HARDWARE),
@@ -27,16 +49,73 @@ namespace library {
 		m_depthStencilView(),
 		m_cbChangeOnResize(),
 		m_cbLights(),
-		m_pszMainSceneName(),
+		m_mainScene(),
 		m_camera(XMVectorSet(0.0f, 0.0f, -5.0f, 0.0f)),
 		m_projection(),
+		m_interpolatedView(),
+		m_interpolatedEye(),
 		m_renderables(),
 		m_models(),
-		m_aPointLights(),
+		m_modelCrowds(),
+		m_pointLights(),
 		m_vertexShaders(),
 		m_pixelShaders(),
-		m_scenes()
-	{}
+		m_pipelineStates(),
+		m_scenes(),
+		m_entityMeshes(),
+		m_entities(),
+		m_occluders(),
+		m_occlusionCuller(),
+		m_backend(),
+		m_aCommandBuffers(),
+		m_apCommandBuffers(),
+		m_frameArena(),
+		m_apVisibleRenderables(FrameAllocator<Renderable*>(m_frameArena)),
+		m_aInstancedPipelineStates(),
+		m_aRenderableBatchKeys(FrameAllocator<RenderableBatchKey>(m_frameArena)),
+		m_aRenderableBatches(FrameAllocator<RenderableBatch>(m_frameArena)),
+		m_aRenderableInstances(FrameAllocator<RenderableInstanceData>(m_frameArena)),
+		m_renderableInstanceBuffer(),
+		m_uRenderableInstanceCapacity(0u),
+		m_apVisibleModels(FrameAllocator<Model*>(m_frameArena)),
+		m_auVisibleEntities(FrameAllocator<UINT>(m_frameArena)),
+		m_aChunkVisibilities(),
+		m_frameGraph(),
+		m_lightCuller(),
+		m_uSkinningUploadBytes(0u),
+		m_staticBatcher(),
+		m_debugDraw(),
+		m_tracingBackend(),
+		m_jobSystem(),
+		m_assetLoader(),
+		m_frameSnapshots(),
+		m_aRetiredObjects(),
+		m_uNumBuiltFrames(0u),
+		m_uLastAcquiredFrame(0u),
+		m_uLastSubmittedFrame(0u),
+		m_interpolationAlpha(1.0f),
+		m_heapAllocationCheck(),
+		m_bHeapAllocationCheck(FALSE),
+		m_framePipeline(),
+		m_startupGraph(),
+		m_startupGraphBeginSeconds(0.0f),
+		m_timeToFirstFrame(0.0f)
+	{
+		SetNumRecordingThreads(std::max(std::thread::hardware_concurrency(), 1u));
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::~Renderer
+
+	  Summary:  Destructor, stops the render thread since it reads the
+				objects of the renderer
+
+	  Modifies: [m_framePipeline].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	Renderer::~Renderer()
+	{
+		m_framePipeline.Stop();
+	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::Initialize
@@ -48,9 +127,10 @@ namespace library {
 
 	  Modifies: [m_d3dDevice, m_featureLevel, m_immediateContext,
 				 m_d3dDevice1, m_immediateContext1, m_swapChain1,
-				 m_swapChain, m_renderTargetView, m_cbChangeOnResize,
-				 m_projection, m_cbLights, m_camera, m_vertexShaders,
-				 m_pixelShaders, m_renderables].
+				 m_swapChain, m_renderTargetView, m_backend,
+				 m_cbChangeOnResize, m_projection, m_cbLights, m_camera,
+				 m_vertexShaders, m_pixelShaders, m_pipelineStates,
+				 m_renderables].
 
 	  Returns:  HRESULT
 				  Status code
@@ -197,11 +277,135 @@ namespace library {
 		);
 #pragma endregion
 
-#pragma region CreateCBChangeOnResizeAndSetB1
+#pragma region CreateBackend
+		std::shared_ptr<D3D11RenderBackend> d3d11Backend = std::make_shared<D3D11RenderBackend>(
+			m_immediateContext.Get(),
+			m_swapChain.Get(),
+			m_renderTargetView.Get(),
+			m_depthStencilView.Get(),
+			viewport
+		);
+
+		// Emulated command lists are slower than replaying on the immediate context
+		D3D11_FEATURE_DATA_THREADING threading = { };
+		hr = m_d3dDevice->CheckFeatureSupport(D3D11_FEATURE_THREADING, &threading, sizeof(threading));
+		if (SUCCEEDED(hr) && threading.DriverCommandLists)
+		{
+			hr = d3d11Backend->CreateDeferredContexts(m_d3dDevice.Get(), static_cast<UINT>(m_aCommandBuffers.size()));
+			if (FAILED(hr)) return hr;
+		}
+
+		m_backend = d3d11Backend;
+#pragma endregion
+
+		return initializeResources(bbDesc.Width, bbDesc.Height);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::InitializeHeadless
+
+	  Summary:  Initializes the renderer without a window. Resources are
+				created on the WARP software device, so no GPU is needed,
+				and every command of a frame goes to the given backend,
+				typically a RecordingRenderBackend
+
+	  Args:     UINT uWidth
+				  Width of the virtual back buffer
+				UINT uHeight
+				  Height of the virtual back buffer
+				const std::shared_ptr<RenderBackend>& backend
+				  Backend receiving the commands
+
+	  Modifies: [m_driverType, m_d3dDevice, m_featureLevel,
+				 m_immediateContext, m_d3dDevice1, m_immediateContext1,
+				 m_backend, m_cbChangeOnResize, m_projection, m_cbLights,
+				 m_camera, m_vertexShaders, m_pixelShaders,
+				 m_pipelineStates, m_renderables].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight, _In_ const std::shared_ptr<RenderBackend>& backend)
+	{
+		if (uWidth == 0u || uHeight == 0u || !backend)
+		{
+			return E_INVALIDARG;
+		}
+
+		HRESULT hr;
+
+		const D3D_FEATURE_LEVEL featureLevels[] = {
+			D3D_FEATURE_LEVEL_11_1,
+			D3D_FEATURE_LEVEL_11_0
+		};
+
+		m_driverType = D3D_DRIVER_TYPE_WARP;
+		hr = D3D11CreateDevice(
+			nullptr,
+			m_driverType,
+			nullptr,
+			0u,
+			featureLevels,
+			ARRAYSIZE(featureLevels),
+			D3D11_SDK_VERSION,
+			&m_d3dDevice,
+			&m_featureLevel,
+			&m_immediateContext
+		);
+		if (FAILED(hr)) return hr;
+
+		m_d3dDevice.As(&m_d3dDevice1);
+		m_immediateContext.As(&m_immediateContext1);
+
+		m_backend = backend;
+
+		return initializeResources(uWidth, uHeight);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::initializeResources
+
+	  Summary:  Starts the job system and the asset loader, creates the
+				constant buffers, initializes the shaders, renderables,
+				models, scenes and camera once the device and the
+				backend exist, then declares the frame graph and the
+				stages of the frame pipeline the renderer runs. The
+				shaders, renderables, models and scenes are initialized
+				through the startup graph, the workers compiling and
+				parsing while this thread creates the Direct3D objects
+				whose inputs are ready
+
+	  Args:     UINT uWidth
+				  Width of the back buffer
+				UINT uHeight
+				  Height of the back buffer
+
+	  Modifies: [m_cbChangeOnResize, m_projection, m_cbLights, m_camera,
+				 m_vertexShaders, m_pixelShaders, m_pipelineStates,
+				 m_renderables, m_models, m_modelCrowds, m_scenes, m_lightCuller,
+				 m_debugDraw, m_frameGraph, m_jobSystem, m_assetLoader,
+				 m_framePipeline, m_startupGraph, m_startupGraphBeginSeconds].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::initializeResources(_In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		HRESULT hr;
+
+		if (!m_jobSystem.IsInitialized())
+		{
+			m_jobSystem.Initialize();
+		}
+
+		hr = m_assetLoader.Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+		if (FAILED(hr)) return hr;
+
+#pragma region CreateCBChangeOnResize
 		float fovAngleY = XM_PIDIV2;
 		float nearZ = 0.01f;
 		float farZ = 100.0f;
-		m_projection = XMMatrixPerspectiveFovLH(fovAngleY, (float)bbDesc.Width / (float)bbDesc.Height, nearZ, farZ);
+		m_projection = XMMatrixPerspectiveFovLH(fovAngleY, (float)uWidth / (float)uHeight, nearZ, farZ);
 
 
 		D3D11_BUFFER_DESC cBufferDesc = {
@@ -225,11 +429,9 @@ namespace library {
 
 		hr = m_d3dDevice->CreateBuffer(&cBufferDesc, &cData, &m_cbChangeOnResize);
 		if (FAILED(hr)) return hr;
-
-		m_immediateContext->VSSetConstantBuffers(1, 1, m_cbChangeOnResize.GetAddressOf());
 #pragma endregion
 
-#pragma region CreateCBLightsAndSetB3
+#pragma region CreateCBLights
 		D3D11_BUFFER_DESC cbLightsDesc = {
 			.ByteWidth = sizeof(CBLights),
 			.Usage = D3D11_USAGE_DEFAULT,
@@ -250,122 +452,370 @@ namespace library {
 		hr = m_d3dDevice->CreateBuffer(&cbLightsDesc, &cbLightsData, &m_cbLights);
 		if (FAILED(hr)) return hr;
 
-		m_immediateContext->VSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
-#pragma endregion
-
-#pragma region InitializeShadersAndRenderables
-		for (auto& vs : m_vertexShaders)
-		{
-			hr = vs.second->Initialize(m_d3dDevice.Get());
-			if (FAILED(hr)) return hr;
-		}
+		hr = m_lightCuller.Initialize(m_d3dDevice.Get());
+		if (FAILED(hr)) return hr;
 
-		for (auto& ps : m_pixelShaders)
-		{
-			hr = ps.second->Initialize(m_d3dDevice.Get());
-			if (FAILED(hr)) return hr;
-		}
+		m_lightCuller.SetProjection(m_projection, nearZ, farZ, uWidth, uHeight);
 
-		for (auto& renderable : m_renderables)
-		{
-			hr = renderable.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
-			if (FAILED(hr)) return hr;
-		}
+		hr = m_debugDraw.Initialize(m_d3dDevice.Get());
+		if (FAILED(hr)) return hr;
+#pragma endregion
 
-		for (auto& model : m_models)
-		{
-			hr = model.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
-			if (FAILED(hr)) return hr;
-		}
+#pragma region InitializeShadersAndRenderables
+		hr = declareStartupGraph();
+		if (FAILED(hr)) return hr;
 
-		for (auto& scene : m_scenes)
-		{
-			hr = scene.second->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
-			if (FAILED(hr)) return hr;
-		}
+		m_startupGraphBeginSeconds = getSecondsSinceProcessStart();
+		hr = m_startupGraph.Execute(m_jobSystem, m_assetLoader);
+		if (FAILED(hr)) return hr;
 #pragma endregion
 
 		// Initialize Camera
 		hr = m_camera.Initialize(m_d3dDevice.Get());
 		if (FAILED(hr)) return hr;
 
-		// Set primitive topology
-		m_immediateContext->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		// The input and update stages belong to the game
+		m_framePipeline.SetStage(eFrameStage::CULL, [this]() { cullScene(); });
+		m_framePipeline.SetStage(eFrameStage::BUILD_DRAW_LIST, [this]() { buildFrame(); });
+		m_framePipeline.SetStage(eFrameStage::SUBMIT, [this]() { submitFrame(); });
 
-		return S_OK;
+		return declareFrameGraph(uWidth, uHeight);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::declareFrameGraph
+
+	  Summary:  Declares the passes of a frame and compiles the graph.
+				The back buffer and the depth buffer are created with
+				the device, so they are imported. A new pass only has to
+				declare what it reads and writes to be ordered, and is
+				culled when nothing uses its outputs
+
+	  Args:     UINT uWidth
+				  Width of the back buffer
+				UINT uHeight
+				  Height of the back buffer
+
+	  Modifies: [m_frameGraph].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::declareFrameGraph(_In_ UINT uWidth, _In_ UINT uHeight)
+	{
+		m_frameGraph.Reset();
+
+		UINT uBackBuffer = m_frameGraph.ImportTexture(
+			L"BackBuffer",
+			FrameGraphTextureDesc{ .uWidth = uWidth, .uHeight = uHeight, .Format = eFrameGraphFormat::B8G8R8A8_UNORM }
+		);
+		UINT uDepthStencil = m_frameGraph.ImportTexture(
+			L"DepthStencil",
+			FrameGraphTextureDesc{ .uWidth = uWidth, .uHeight = uHeight, .Format = eFrameGraphFormat::D24_UNORM_S8_UINT }
+		);
+
+		const UINT uClearPass = m_frameGraph.AddPass(
+			L"Clear",
+			[](RenderBackend& backend)
+			{
+				// Clear the backbuffer
+				backend.ClearRenderTarget(CLEAR_COLOR);
+
+				// Clear the depth buffer to 1.0 (maximum depth)
+				backend.ClearDepthStencil(1.0f, 0);
+			}
+		);
+		uBackBuffer = m_frameGraph.Write(uClearPass, uBackBuffer);
+		uDepthStencil = m_frameGraph.Write(uClearPass, uDepthStencil);
+
+		const UINT uScenePass = m_frameGraph.AddPass(
+			L"Scene",
+			[this](RenderBackend& backend)
+			{
+				renderScene(backend);
+			}
+		);
+		uBackBuffer = m_frameGraph.Write(uScenePass, uBackBuffer);
+		uDepthStencil = m_frameGraph.Write(uScenePass, uDepthStencil);
+
+		const UINT uDebugDrawPass = m_frameGraph.AddPass(
+			L"DebugDraw",
+			[this](RenderBackend& backend)
+			{
+				m_debugDraw.Flush(backend, m_interpolatedView * m_projection);
+			}
+		);
+		m_frameGraph.Read(uDebugDrawPass, uDepthStencil);
+		uBackBuffer = m_frameGraph.Write(uDebugDrawPass, uBackBuffer);
+
+		const UINT uPresentPass = m_frameGraph.AddPass(
+			L"Present",
+			[](RenderBackend& backend)
+			{
+				backend.Present();
+			}
+		);
+		m_frameGraph.Read(uPresentPass, uBackBuffer);
+		m_frameGraph.SetSideEffect(uPresentPass);
+
+		return m_frameGraph.Compile() ? S_OK : E_FAIL;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::AddRenderable
 
-	  Summary:  Add a renderable object
+	  Summary:  Add a renderable object. Once the renderer is
+				initialized, the object is initialized when added. A
+				static object is queued for the static batches, built
+				at the next frame
 
 	  Args:     PCWSTR pszRenderableName
-				  Key of the renderable object
+				  Name of the renderable object, compared by value
 				const std::shared_ptr<Renderable>& renderable
 				  Shared pointer to the renderable object
+				RenderableHandle* pHandle
+				  Optional handle of the renderable
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_renderables, m_staticBatcher].
 
 	  Returns:  HRESULT
 				  Status code.
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable)
+	HRESULT Renderer::AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable, _Out_opt_ RenderableHandle* pHandle)
 	{
-		if (m_renderables.contains(pszRenderableName)) return E_FAIL;
-		m_renderables.insert({ pszRenderableName, renderable });
+		HRESULT hr = m_renderables.Add(pszRenderableName, renderable, pHandle);
+		if (FAILED(hr)) return hr;
+
+		if (m_d3dDevice)
+		{
+			// The immediate context may be submitting a frame
+			WaitForSubmission();
+			hr = renderable->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+			if (FAILED(hr))
+			{
+				m_renderables.Remove(m_renderables.Find(pszRenderableName));
+				return hr;
+			}
+		}
+
+		if (renderable->IsStatic())
+		{
+			m_staticBatcher.Add(renderable.get());
+		}
 
 		return S_OK;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::RemoveRenderable
+
+	  Summary:  Remove a renderable object. A static object leaves its
+				static batches, which are rebuilt at the next frame
+
+	  Args:     RenderableHandle handle
+				  Handle of the renderable object
+
+	  Modifies: [m_renderables, m_occluders, m_staticBatcher].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG for a stale handle
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::RemoveRenderable(_In_ RenderableHandle handle)
+	{
+		const std::shared_ptr<Renderable> renderable = m_renderables.Get(handle);
+		if (!renderable) return E_INVALIDARG;
+
+		// The frame being submitted may still draw it
+		WaitForSubmission();
+
+		m_staticBatcher.Remove(renderable.get());
+		std::erase(m_occluders, renderable);
+
+		return m_renderables.Remove(handle);
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::AddModel
 
 	  Summary:  Add a model object
 
 	  Args:     PCWSTR pszModelName
-				  Key of the model object
+				  Name of the model object, compared by value
 				const std::shared_ptr<Model>& pModel
 				  Shared pointer to the model object
+				ModelHandle* pHandle
+				  Optional handle of the model
 
 	  Modifies: [m_models].
 
 	  Returns:  HRESULT
 				  Status code.
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel)
+	HRESULT Renderer::AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel, _Out_opt_ ModelHandle* pHandle)
+	{
+		return m_models.Add(pszModelName, pModel, pHandle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::AddModelCrowd
+
+	  Summary:  Add a crowd of instances of a skinned model. The model
+				of the crowd is initialized with it
+
+	  Args:     PCWSTR pszModelCrowdName
+				  Name of the crowd, compared by value
+				const std::shared_ptr<ModelCrowd>& modelCrowd
+				  Shared pointer to the crowd
+				ModelCrowdHandle* pHandle
+				  Optional handle of the crowd
+
+	  Modifies: [m_modelCrowds].
+
+	  Returns:  HRESULT
+				  Status code.
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::AddModelCrowd(_In_ PCWSTR pszModelCrowdName, _In_ const std::shared_ptr<ModelCrowd>& modelCrowd, _Out_opt_ ModelCrowdHandle* pHandle)
+	{
+		return m_modelCrowds.Add(pszModelCrowdName, modelCrowd, pHandle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::AddEntityMesh
+
+	  Summary:  Adds a renderable whose geometry, material and pipeline
+				state draw the entities referring to it. Any renderable
+				works unchanged as a mesh, it is initialized like the
+				others but never drawn by itself. The entities of a mesh
+				are drawn in instanced draws, so its pipeline state
+				needs an instanced pipeline state, see
+				SetInstancedPipelineState
+
+	  Args:     PCWSTR pszEntityMeshName
+				  Name of the mesh, compared by value
+				const std::shared_ptr<Renderable>& mesh
+				  Renderable used as the mesh
+				EntityMeshHandle* pHandle
+				  Optional handle of the mesh, referred to by the
+				  entities
+
+	  Modifies: [m_entityMeshes].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::AddEntityMesh(_In_ PCWSTR pszEntityMeshName, _In_ const std::shared_ptr<Renderable>& mesh, _Out_opt_ EntityMeshHandle* pHandle)
+	{
+		HRESULT hr = m_entityMeshes.Add(pszEntityMeshName, mesh, pHandle);
+		if (FAILED(hr)) return hr;
+
+		if (m_d3dDevice)
+		{
+			// The immediate context may be submitting a frame
+			WaitForSubmission();
+			hr = mesh->Initialize(m_d3dDevice.Get(), m_immediateContext.Get());
+			if (FAILED(hr))
+			{
+				m_entityMeshes.Remove(m_entityMeshes.Find(pszEntityMeshName));
+				return hr;
+			}
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::AddEntity
+
+	  Summary:  Adds an entity drawn with an entity mesh. Its local
+				bounds are the ones of the mesh, set when the mesh is
+				initialized. An entity without mesh is not drawn, and
+				only moves its children, like the anchor of a group or
+				of a chunk of the scene
+
+	  Args:     const EntityDesc& desc
+				  Initial components of the entity, its mesh and its
+				  parent must have been added
+				EntityHandle* pHandle
+				  Optional handle of the entity
+
+	  Modifies: [m_entities].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG for an unknown mesh or
+				  parent
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::AddEntity(_In_ const EntityDesc& desc, _Out_opt_ EntityHandle* pHandle)
 	{
-		if (m_models.contains(pszModelName)) return E_FAIL;
-		m_models.insert({ pszModelName, pModel });
+		EntityDesc entityDesc = desc;
+		if (!desc.Mesh.IsNull())
+		{
+			const std::shared_ptr<Renderable>& mesh = m_entityMeshes.Get(desc.Mesh);
+			if (!mesh)
+			{
+				return E_INVALIDARG;
+			}
+
+			entityDesc.LocalBounds = mesh->GetLocalBoundingBox();
+		}
+
+		const EntityHandle handle = m_entities.Add(entityDesc);
+		if (handle.IsNull())
+		{
+			return E_INVALIDARG;
+		}
+
+		if (pHandle)
+		{
+			*pHandle = handle;
+		}
 
 		return S_OK;
 	}
 
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::RemoveEntity
+
+	  Summary:  Removes an entity with its descendants. The entities
+				after them in the store move back in their place
+
+	  Args:     EntityHandle handle
+				  Handle of the entity
+
+	  Modifies: [m_entities].
+
+	  Returns:  HRESULT
+				  Status code, E_INVALIDARG for a stale handle
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::RemoveEntity(_In_ EntityHandle handle)
+	{
+		return m_entities.Remove(handle);
+	}
+
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::AddPointLight
 
 	  Summary:  Add a point light
 
-	  Args:     size_t index
-				  Index of the point light
+	  Args:     PCWSTR pszPointLightName
+				  Name of the point light, compared by value
 				const std::shared_ptr<PointLight>& pointLight
 				  Shared pointer to the point light object
+				PointLightHandle* pHandle
+				  Optional handle of the point light
 
-	  Modifies: [m_aPointLights].
+	  Modifies: [m_pointLights].
 
 	  Returns:  HRESULT
 				  Status code.
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddPointLight(_In_ size_t index, _In_ const std::shared_ptr<PointLight>& pPointLight)
+	HRESULT Renderer::AddPointLight(_In_ PCWSTR pszPointLightName, _In_ const std::shared_ptr<PointLight>& pPointLight, _Out_opt_ PointLightHandle* pHandle)
 	{
-		if (index >= NUM_LIGHTS || !pPointLight)
+		if (m_pointLights.GetSize() >= MAX_NUM_LIGHTS)
 		{
 			return E_FAIL;
 		}
 
-		m_aPointLights[index] = pPointLight;
-		return S_OK;
+		return m_pointLights.Add(pszPointLightName, pPointLight, pHandle);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -374,21 +824,20 @@ namespace library {
 	  Summary:  Add the vertex shader into the renderer
 
 	  Args:     PCWSTR pszVertexShaderName
-				  Key of the vertex shader
+				  Name of the vertex shader, compared by value
 				const std::shared_ptr<VertexShader>&
 				  Vertex shader to add
+				VertexShaderHandle* pHandle
+				  Optional handle of the vertex shader
 
 	  Modifies: [m_vertexShaders].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader)
+	HRESULT Renderer::AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader, _Out_opt_ VertexShaderHandle* pHandle)
 	{
-		if (m_vertexShaders.contains(pszVertexShaderName)) return E_FAIL;
-		m_vertexShaders.insert({ pszVertexShaderName, vertexShader });
-
-		return S_OK;
+		return m_vertexShaders.Add(pszVertexShaderName, vertexShader, pHandle);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -397,19 +846,65 @@ namespace library {
 	  Summary:  Add the pixel shader into the renderer
 
 	  Args:     PCWSTR pszPixelShaderName
-				  Key of the pixel shader
+				  Name of the pixel shader, compared by value
 				const std::shared_ptr<PixelShader>&
 				  Pixel shader to add
+				PixelShaderHandle* pHandle
+				  Optional handle of the pixel shader
 
 	  Modifies: [m_pixelShaders].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader)
+	HRESULT Renderer::AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader, _Out_opt_ PixelShaderHandle* pHandle)
+	{
+		return m_pixelShaders.Add(pszPixelShaderName, pixelShader, pHandle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::AddPipelineState
+
+	  Summary:  Add the pipeline state into the renderer. It is
+				initialized after the shaders
+
+	  Args:     PCWSTR pszPipelineStateName
+				  Name of the pipeline state, compared by value
+				const std::shared_ptr<PipelineState>&
+				  Pipeline state to add
+				PipelineStateHandle* pHandle
+				  Optional handle of the pipeline state
+
+	  Modifies: [m_pipelineStates].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::AddPipelineState(_In_ PCWSTR pszPipelineStateName, _In_ const std::shared_ptr<PipelineState>& pipelineState, _Out_opt_ PipelineStateHandle* pHandle)
+	{
+		return m_pipelineStates.Add(pszPipelineStateName, pipelineState, pHandle);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::AddOccluder
+
+	  Summary:  Marks a renderable as an occluder. Its triangles are
+				rasterized into the occlusion culler every frame, so
+				only large opaque renderables should be added
+
+	  Args:     PCWSTR pszRenderableName
+				  Key of the renderable
+
+	  Modifies: [m_occluders].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::AddOccluder(_In_ PCWSTR pszRenderableName)
 	{
-		if (m_pixelShaders.contains(pszPixelShaderName)) return E_FAIL;
-		m_pixelShaders.insert({ pszPixelShaderName, pixelShader });
+		const std::shared_ptr<Renderable>& renderable = m_renderables.Get(m_renderables.Find(pszRenderableName));
+		if (!renderable) return E_INVALIDARG;
+		m_occluders.push_back(renderable);
 
 		return S_OK;
 	}
@@ -423,20 +918,20 @@ namespace library {
 				  Key of a scene
 				const std::filesystem::path& sceneFilePath
 				  File path to initialize a scene
+				SceneHandle* pHandle
+				  Optional handle of the scene
 
 	  Modifies: [m_scenes].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFilePath)
+	HRESULT Renderer::AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFilePath, _Out_opt_ SceneHandle* pHandle)
 	{
-		if (m_scenes.contains(pszSceneName)) return E_FAIL;
+		if (m_scenes.IsValid(m_scenes.Find(pszSceneName))) return E_FAIL;
 
 		std::shared_ptr<Scene> newScene = std::make_shared<Scene>(sceneFilePath);
-		m_scenes.insert({ pszSceneName, newScene });
-
-		return S_OK;
+		return m_scenes.Add(pszSceneName, newScene, pHandle);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -447,15 +942,16 @@ namespace library {
 	  Args:     PCWSTR pszSceneName
 				  Name of the scene to set as the main scene
 
-	  Modifies: [m_pszMainSceneName].
+	  Modifies: [m_mainScene].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	HRESULT Renderer::SetMainScene(_In_ PCWSTR pszSceneName)
 	{
-		if (!m_scenes.contains(pszSceneName)) return E_FAIL;
-		m_pszMainSceneName = pszSceneName;
+		const SceneHandle scene = m_scenes.Find(pszSceneName);
+		if (!m_scenes.IsValid(scene)) return E_FAIL;
+		m_mainScene = scene;
 
 		return S_OK;
 	}
@@ -484,484 +980,1763 @@ namespace library {
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
 	  Method:   Renderer::Update
 
-	  Summary:  Update the renderables and models each frame
+	  Summary:  Update the renderables and models each frame. Each
+				renderable and model only updates itself, so they are
+				updated in parallel on the job system. The crowds split
+				their own update, the lights are too cheap to split.
+				The systems of the entity store run over its arrays
 
 	  Args:     FLOAT deltaTime
 				  Time difference of a frame
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
 	void Renderer::Update(_In_ FLOAT deltaTime)
 	{
-		for (const auto& renderable : m_renderables)
+		const std::vector<std::shared_ptr<Renderable>>& renderables = m_renderables.GetResources();
+		m_jobSystem.ParallelFor(0u, static_cast<std::uint32_t>(renderables.size()), 0u, [&](std::uint32_t i)
 		{
-			renderable.second->Update(deltaTime);
-		}
+			renderables[i]->Update(deltaTime);
+		});
 
-		for (const auto& model : m_models)
+		const std::vector<std::shared_ptr<Model>>& models = m_models.GetResources();
+		m_jobSystem.ParallelFor(0u, static_cast<std::uint32_t>(models.size()), 1u, [&](std::uint32_t i)
+		{
+			models[i]->Update(deltaTime);
+		});
+
+		for (const auto& modelCrowd : m_modelCrowds)
 		{
-			model.second->Update(deltaTime);
+			modelCrowd->Update(deltaTime);
 		}
 
-		for (const auto& light : m_aPointLights)
+		for (const auto& light : m_pointLights)
 		{
 			light->Update(deltaTime);
 		}
 
+		m_entities.Update(deltaTime, m_jobSystem);
+
 		m_camera.Update(deltaTime);
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::Render
+	  Method:   Renderer::StorePreviousState
+
+	  Summary:  Keeps the world matrices of the moving renderables and
+				models, the transforms of the entities and the camera
+				before a simulation step, so the frames drawn until the
+				next step interpolate from them. The bone palettes and
+				lights are drawn as last updated
 
-	  Summary:  Render the frame
+	  Modifies: [m_renderables, m_models, m_entities, m_camera].
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	void Renderer::Render()
+	void Renderer::StorePreviousState()
 	{
-		// Clear the backbuffer
-		constexpr float clearColor[4] = { 0.0f, 0.125f, 0.6f, 1.0f }; // RGBA
-		m_immediateContext->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
+		for (const auto& renderable : m_renderables)
+		{
+			if (!renderable->IsStatic())
+			{
+				renderable->StorePreviousWorldMatrix();
+			}
+		}
 
-		// Clear the depth buffer to 1.0 (maximum depth)
-		m_immediateContext->ClearDepthStencilView(m_depthStencilView.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+		for (const auto& model : m_models)
+		{
+			model->StorePreviousWorldMatrix();
+		}
 
-		// Create camera constant buffer and update
-		XMFLOAT4 camPos;
-		XMStoreFloat4(&camPos, m_camera.GetEye());
-		CBChangeOnCameraMovement cbCamera = {
-			.View = XMMatrixTranspose(m_camera.GetView()),
-			.CameraPosition = camPos,
-		};
+		m_entities.StorePreviousTransforms();
 
-		m_immediateContext->UpdateSubresource(
-			m_camera.GetConstantBuffer().Get(),
-			0u,
-			nullptr,
-			&cbCamera,
-			0u,
-			0u
+		m_camera.StorePreviousState();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetInterpolationAlpha
+
+	  Summary:  Sets how far the frames drawn next are between the
+				state before the last simulation step and the current
+				one. 1, the default, draws the current state
+
+	  Args:     FLOAT alpha
+				  Fraction of a step elapsed since the last one
+
+	  Modifies: [m_interpolationAlpha].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetInterpolationAlpha(_In_ FLOAT alpha)
+	{
+		m_interpolationAlpha = std::clamp(alpha, 0.0f, 1.0f);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::Render
+
+	  Summary:  Render the frame on the calling thread by culling the
+				main scene, then executing the passes of the frame graph
+				through the backend. The traced backend is restored
+				once a trace has written its last frame. Must not be
+				called while the render thread runs
+
+	  Modifies: [m_occlusionCuller, m_aChunkVisibilities,
+				 m_apVisibleRenderables, m_apVisibleModels,
+				 m_staticBatcher, m_aRetiredObjects, m_interpolatedView,
+				 m_interpolatedEye, m_aCommandBuffers, m_backend,
+				 m_tracingBackend, m_uNumBuiltFrames, m_uLastAcquiredFrame,
+				 m_uLastSubmittedFrame].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::Render()
+	{
+		// No snapshot is in flight, nothing draws the retired objects anymore
+		m_aRetiredObjects.clear();
+
+		cullScene();
+
+		m_backend->BeginFrame();
+
+		m_frameGraph.Execute(*m_backend);
+
+		// Drawn directly, the frame counts as acquired and submitted, so the uploads it carried are not repeated
+		++m_uNumBuiltFrames;
+		m_uLastAcquiredFrame.store(m_uNumBuiltFrames, std::memory_order_release);
+		m_uLastSubmittedFrame.store(m_uNumBuiltFrames, std::memory_order_release);
+
+		endTracedFrame();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::ExecuteFrame
+
+	  Summary:  Runs the stages of a frame in the frame pipeline, on
+				the simulation thread. The culling and draw list of the
+				frame are recorded into a snapshot, published to the
+				render thread, which submits it while the next frames
+				are simulated. At most one built frame waits for the
+				render thread: a new frame is only started once the
+				render thread acquired the previous one, so the
+				simulation thread sleeps instead of building snapshots
+				that would be overwritten before being submitted. Must
+				always be called from the same thread. When the heap
+				allocation check is set, a debug build asserts that the
+				frames after the warm up do not allocate from the heap
+				on this thread
+
+	  Modifies: [m_framePipeline, m_heapAllocationCheck].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::ExecuteFrame()
+	{
+		if (m_framePipeline.IsRunning())
+		{
+			for (UINT64 uFrame = m_uLastAcquiredFrame.load(std::memory_order_acquire); uFrame < m_uNumBuiltFrames; uFrame = m_uLastAcquiredFrame.load(std::memory_order_acquire))
+			{
+				m_uLastAcquiredFrame.wait(uFrame, std::memory_order_acquire);
+			}
+		}
+
+#if defined(DEBUG) || defined(_DEBUG)
+		const BOOL bCheck = m_bHeapAllocationCheck && m_framePipeline.GetNumFrames() >= HEAP_ALLOCATION_CHECK_WARM_UP_FRAMES;
+		if (bCheck)
+		{
+			m_heapAllocationCheck.Begin();
+		}
+#endif
+
+		m_framePipeline.Execute();
+
+#if defined(DEBUG) || defined(_DEBUG)
+		if (bCheck)
+		{
+			// A steady frame takes its transient memory from the frame arena and grow-only buffers
+			const UINT64 uNumAllocations = m_heapAllocationCheck.End();
+			assert(uNumAllocations == 0u);
+			UNREFERENCED_PARAMETER(uNumAllocations);
+		}
+#endif
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::WaitForSubmission
+
+	  Summary:  Waits until the render thread submitted the last frame
+				built, before the simulation thread uses the immediate
+				context or changes the backend. The render thread may
+				still wake up afterwards, but it only touches the
+				context once it acquires a new snapshot, so the caller
+				owns the context until it builds the next frame
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::WaitForSubmission()
+	{
+		if (!m_framePipeline.IsRunning())
+		{
+			return;
+		}
+
+		for (UINT64 uFrame = m_uLastSubmittedFrame.load(std::memory_order_acquire); uFrame < m_uNumBuiltFrames; uFrame = m_uLastSubmittedFrame.load(std::memory_order_acquire))
+		{
+			m_uLastSubmittedFrame.wait(uFrame, std::memory_order_acquire);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::declareStartupGraph
+
+	  Summary:  Declares the initialization of the shaders, pipeline
+				states, renderables, entity meshes, models, crowds and
+				scenes as tasks of the startup graph. The shaders are
+				compiled, and the pipeline states created, on the
+				workers, since they only use the free threaded device.
+				The model and scene files are parsed on the loader
+				threads of the asset loader, the textures of the models
+				then read and decoded in parallel on the workers, and
+				the Direct3D objects created on the device thread. Each
+				pipeline state waits for its shaders, the entity bounds
+				for the entity meshes, and the crowds sharing a model
+				for the task creating it
+
+	  Modifies: [m_startupGraph].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::declareStartupGraph()
+	{
+		HRESULT hr = S_OK;
+		ID3D11Device* pDevice = m_d3dDevice.Get();
+		ID3D11DeviceContext* pImmediateContext = m_immediateContext.Get();
+
+		m_startupGraph.Reset();
+
+		std::unordered_map<const VertexShader*, UINT> vertexShaderTasks;
+		for (size_t i = 0u; i < m_vertexShaders.GetSize(); ++i)
+		{
+			VertexShader* pVertexShader = m_vertexShaders.GetResources()[i].get();
+			vertexShaderTasks[pVertexShader] = m_startupGraph.AddTask(
+				L"Vertex shader " + m_vertexShaders.GetName(i),
+				eStartupThread::WORKER,
+				[pVertexShader, pDevice]() { return pVertexShader->Initialize(pDevice); }
+			);
+		}
+
+		std::unordered_map<const PixelShader*, UINT> pixelShaderTasks;
+		for (size_t i = 0u; i < m_pixelShaders.GetSize(); ++i)
+		{
+			PixelShader* pPixelShader = m_pixelShaders.GetResources()[i].get();
+			pixelShaderTasks[pPixelShader] = m_startupGraph.AddTask(
+				L"Pixel shader " + m_pixelShaders.GetName(i),
+				eStartupThread::WORKER,
+				[pPixelShader, pDevice]() { return pPixelShader->Initialize(pDevice); }
+			);
+		}
+
+		// The pipeline states check the compiled shaders, a shader missing from the registries fails them as before
+		for (size_t i = 0u; i < m_pipelineStates.GetSize(); ++i)
+		{
+			PipelineState* pPipelineState = m_pipelineStates.GetResources()[i].get();
+			const UINT uTask = m_startupGraph.AddTask(
+				L"Pipeline state " + m_pipelineStates.GetName(i),
+				eStartupThread::WORKER,
+				[pPipelineState, pDevice]() { return pPipelineState->Initialize(pDevice); }
+			);
+
+			const VertexShader* pVertexShader = nullptr;
+			const PixelShader* pPixelShader = nullptr;
+			pPipelineState->GetShaderObjects(&pVertexShader, &pPixelShader);
+
+			const auto vertexShaderTask = vertexShaderTasks.find(pVertexShader);
+			if (vertexShaderTask != vertexShaderTasks.end())
+			{
+				hr = m_startupGraph.AddDependency(uTask, vertexShaderTask->second);
+				if (FAILED(hr)) return hr;
+			}
+
+			const auto pixelShaderTask = pixelShaderTasks.find(pPixelShader);
+			if (pixelShaderTask != pixelShaderTasks.end())
+			{
+				hr = m_startupGraph.AddDependency(uTask, pixelShaderTask->second);
+				if (FAILED(hr)) return hr;
+			}
+		}
+
+		for (size_t i = 0u; i < m_renderables.GetSize(); ++i)
+		{
+			Renderable* pRenderable = m_renderables.GetResources()[i].get();
+			m_startupGraph.AddTask(
+				L"Renderable " + m_renderables.GetName(i),
+				eStartupThread::DEVICE,
+				[pRenderable, pDevice, pImmediateContext]() { return pRenderable->Initialize(pDevice, pImmediateContext); }
+			);
+		}
+
+		std::vector<UINT> auEntityMeshTasks;
+		auEntityMeshTasks.reserve(m_entityMeshes.GetSize());
+		for (size_t i = 0u; i < m_entityMeshes.GetSize(); ++i)
+		{
+			Renderable* pEntityMesh = m_entityMeshes.GetResources()[i].get();
+			auEntityMeshTasks.push_back(m_startupGraph.AddTask(
+				L"Entity mesh " + m_entityMeshes.GetName(i),
+				eStartupThread::DEVICE,
+				[pEntityMesh, pDevice, pImmediateContext]() { return pEntityMesh->Initialize(pDevice, pImmediateContext); }
+			));
+		}
+
+		// The bounds of the meshes are only known once they are initialized
+		const UINT uEntityBoundsTask = m_startupGraph.AddTask(
+			L"Entity bounds",
+			eStartupThread::DEVICE,
+			[this]()
+			{
+				for (UINT i = 0u; i < m_entities.GetSize(); ++i)
+				{
+					if (!m_entities.GetMeshes()[i].IsNull())
+					{
+						m_entities.SetLocalBounds(i, m_entityMeshes.Get(m_entities.GetMeshes()[i])->GetLocalBoundingBox());
+					}
+				}
+				m_entities.UpdateTransforms(m_jobSystem);
+
+				return S_OK;
+			}
 		);
-		m_immediateContext->VSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
-		m_immediateContext->PSSetConstantBuffers(0, 1, m_camera.GetConstantBuffer().GetAddressOf());
+		for (UINT uEntityMeshTask : auEntityMeshTasks)
+		{
+			hr = m_startupGraph.AddDependency(uEntityBoundsTask, uEntityMeshTask);
+			if (FAILED(hr)) return hr;
+		}
 
-		// Create light constant buffer and update
-		CBLights cbLights = { };
+		// Parsing a model file only touches the model, so it overlaps the buffer and texture creation of the others
+		const auto addModelLoadTasks = [this, pDevice](_In_ const std::wstring& name, _In_ Model* pModel, _Out_ UINT& uLoadTask)
+		{
+			const UINT uParseTask = m_startupGraph.AddTask(
+				name + L" parse",
+				eStartupThread::LOADER,
+				[pModel]() { return pModel->Load(); }
+			);
+
+			// A texture failing to decode is reported by the creation of the model, which still draws without it
+			const UINT uDecodeTask = m_startupGraph.AddTask(
+				name + L" textures",
+				eStartupThread::WORKER,
+				[this, pModel, pDevice]()
+				{
+					const std::vector<std::shared_ptr<Texture>> aTextures = pModel->GetTextures();
+					m_jobSystem.ParallelFor(0u, static_cast<std::uint32_t>(aTextures.size()), 1u, [&](std::uint32_t i)
+					{
+						aTextures[i]->Decode(pDevice);
+					});
 
-		for (int i = 0; i < NUM_LIGHTS; i++)
+					return S_OK;
+				}
+			);
+			uLoadTask = uDecodeTask;
+
+			return m_startupGraph.AddDependency(uDecodeTask, uParseTask);
+		};
+
+		std::unordered_map<const Model*, UINT> modelTasks;
+		for (size_t i = 0u; i < m_models.GetSize(); ++i)
 		{
-			if (!m_aPointLights[i]) continue;
-			cbLights.LightPositions[i] = m_aPointLights[i]->GetPosition();
-			cbLights.LightColors[i] = m_aPointLights[i]->GetColor();
+			Model* pModel = m_models.GetResources()[i].get();
+			UINT uLoadTask = 0u;
+			hr = addModelLoadTasks(L"Model " + m_models.GetName(i), pModel, uLoadTask);
+			if (FAILED(hr)) return hr;
+
+			const UINT uCreateTask = m_startupGraph.AddTask(
+				L"Model " + m_models.GetName(i),
+				eStartupThread::DEVICE,
+				[pModel, pDevice, pImmediateContext]() { return pModel->Initialize(pDevice, pImmediateContext); }
+			);
+			hr = m_startupGraph.AddDependency(uCreateTask, uLoadTask);
+			if (FAILED(hr)) return hr;
+
+			modelTasks.insert({ pModel, uCreateTask });
 		}
 
-		m_immediateContext->UpdateSubresource(
-			m_cbLights.Get(),
-			0u,
-			nullptr,
-			&cbLights,
-			0u,
-			0u
+		// A model is parsed by one task only, the crowds sharing it wait for the task creating it
+		for (size_t i = 0u; i < m_modelCrowds.GetSize(); ++i)
+		{
+			ModelCrowd* pModelCrowd = m_modelCrowds.GetResources()[i].get();
+			Model* pModel = &pModelCrowd->GetModel();
+
+			const auto modelTask = modelTasks.find(pModel);
+			const BOOL bSharedModel = modelTask != modelTasks.end();
+			UINT uModelTask = 0u;
+			if (bSharedModel)
+			{
+				uModelTask = modelTask->second;
+			}
+			else
+			{
+				hr = addModelLoadTasks(L"Model crowd " + m_modelCrowds.GetName(i), pModel, uModelTask);
+				if (FAILED(hr)) return hr;
+			}
+
+			const UINT uCreateTask = m_startupGraph.AddTask(
+				L"Model crowd " + m_modelCrowds.GetName(i),
+				eStartupThread::DEVICE,
+				[pModelCrowd, pDevice, pImmediateContext]() { return pModelCrowd->Initialize(pDevice, pImmediateContext); }
+			);
+			hr = m_startupGraph.AddDependency(uCreateTask, uModelTask);
+			if (FAILED(hr)) return hr;
+
+			if (!bSharedModel)
+			{
+				modelTasks.insert({ pModel, uCreateTask });
+			}
+		}
+
+		for (size_t i = 0u; i < m_scenes.GetSize(); ++i)
+		{
+			Scene* pScene = m_scenes.GetResources()[i].get();
+			const UINT uParseTask = m_startupGraph.AddTask(
+				L"Scene parse " + m_scenes.GetName(i),
+				eStartupThread::LOADER,
+				[pScene]() { return pScene->Load(); }
+			);
+			const UINT uCreateTask = m_startupGraph.AddTask(
+				L"Scene " + m_scenes.GetName(i),
+				eStartupThread::DEVICE,
+				[pScene, pDevice, pImmediateContext]() { return pScene->Initialize(pDevice, pImmediateContext); }
+			);
+			hr = m_startupGraph.AddDependency(uCreateTask, uParseTask);
+			if (FAILED(hr)) return hr;
+		}
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::cullScene
+
+	  Summary:  Cull stage of a frame. Places the camera between the
+				last two simulation steps, batches the queued static
+				renderables, then culls the main scene. The buffers the
+				static batches replace are retired, since the snapshot
+				being submitted may draw them
+
+	  Modifies: [m_aRetiredObjects, m_interpolatedView,
+				 m_interpolatedEye, m_staticBatcher, m_occlusionCuller,
+				 m_aChunkVisibilities, m_apVisibleRenderables,
+				 m_apVisibleModels, m_debugDraw].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::cullScene()
+	{
+		releaseRetiredObjects();
+		interpolateCamera();
+
+		// A static batch whose buffers could not be created is skipped and created again next frame
+		std::vector<ComPtr<ID3D11DeviceChild>> aRetiredObjects;
+		m_staticBatcher.Update(m_d3dDevice.Get(), &aRetiredObjects);
+		for (const ComPtr<ID3D11DeviceChild>& object : aRetiredObjects)
+		{
+			retireObject(object);
+		}
+
+		cull(m_scenes.Get(m_mainScene)->GetChunks());
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::buildFrame
+
+	  Summary:  Draw list stage of a frame. Executes the passes of the
+				frame graph into the snapshot written by the simulation
+				thread, then publishes it. Every upload, the camera,
+				transforms, bone palettes and lights, is copied into the
+				snapshot, so the simulation of the next frames can
+				change the objects while it is submitted
+
+	  Modifies: [m_frameSnapshots, m_uNumBuiltFrames, m_lightCuller,
+				 m_aRenderableBatchKeys, m_aRenderableBatches,
+				 m_aRenderableInstances, m_renderableInstanceBuffer,
+				 m_uRenderableInstanceCapacity, m_uSkinningUploadBytes,
+				 m_aCommandBuffers, m_debugDraw].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::buildFrame()
+	{
+		FrameSnapshot& snapshot = m_frameSnapshots.GetWriteBuffer();
+
+		snapshot.Commands.Reset();
+		m_frameGraph.Execute(snapshot.Commands);
+		snapshot.uFrame = ++m_uNumBuiltFrames;
+
+		m_frameSnapshots.Publish();
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::submitFrame
+
+	  Summary:  Submit stage of a frame, run by the render thread.
+				Acquires the newest snapshot and replays it into the
+				backend, its last command presenting the frame. Does
+				nothing when no snapshot was published since the last
+				one, and the snapshots published meanwhile are dropped.
+				Only reads the snapshot, the backend and the trace.
+				Once a snapshot is acquired, first creates the assets
+				loaded since the last frame, the render thread owning
+				the immediate context while a built frame is not
+				submitted yet. Without a snapshot the context is not
+				touched, since the simulation thread may be using it
+				after WaitForSubmission. The first submission records
+				the time to first frame
+
+	  Modifies: [m_assetLoader, m_frameSnapshots, m_uLastAcquiredFrame,
+				 m_uLastSubmittedFrame, m_backend, m_tracingBackend,
+				 m_timeToFirstFrame].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::submitFrame()
+	{
+		// The render thread may wake without a new frame, after WaitForSubmission handed the context over
+		if (!m_frameSnapshots.Acquire())
+		{
+			return;
+		}
+
+		m_assetLoader.RunDeviceWork(MAX_ASSET_CREATION_SECONDS_PER_FRAME);
+
+		// The older snapshots will never be read again, their retired objects can be released
+		const FrameSnapshot& snapshot = m_frameSnapshots.GetReadBuffer();
+		m_uLastAcquiredFrame.store(snapshot.uFrame, std::memory_order_release);
+		m_uLastAcquiredFrame.notify_all();
+
+		m_backend->BeginFrame();
+		snapshot.Commands.Replay(*m_backend);
+
+		endTracedFrame();
+
+		m_uLastSubmittedFrame.store(snapshot.uFrame, std::memory_order_release);
+		m_uLastSubmittedFrame.notify_all();
+
+		if (m_timeToFirstFrame.load(std::memory_order_relaxed) == 0.0f)
+		{
+			const FLOAT timeToFirstFrame = getSecondsSinceProcessStart();
+			m_timeToFirstFrame.store(timeToFirstFrame, std::memory_order_relaxed);
+
+			WCHAR szMessage[64];
+			swprintf_s(szMessage, L"Time to first frame: %.1f ms\n", timeToFirstFrame * 1000.0f);
+			OutputDebugString(szMessage);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::endTracedFrame
+
+	  Summary:  Restores the traced backend once the trace has written
+				its last frame
+
+	  Modifies: [m_backend, m_tracingBackend].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::endTracedFrame()
+	{
+		if (m_tracingBackend && m_tracingBackend->IsFinished())
+		{
+			m_backend = m_tracingBackend->GetBackend();
+			m_tracingBackend.reset();
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::interpolateCamera
+
+	  Summary:  Computes the view and eye the frame is drawn from,
+				between the last two simulation steps
+
+	  Modifies: [m_interpolatedView, m_interpolatedEye].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::interpolateCamera()
+	{
+		m_interpolatedView = m_camera.GetInterpolatedView(m_interpolationAlpha);
+		m_interpolatedEye = m_camera.GetInterpolatedEye(m_interpolationAlpha);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::retireObject
+
+	  Summary:  Keeps an object the frame being built replaced alive
+				until the render thread acquires that frame, since the
+				older snapshots may still draw it
+
+	  Args:     const ComPtr<ID3D11DeviceChild>& object
+				  Object replaced
+
+	  Modifies: [m_aRetiredObjects].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::retireObject(_In_ const ComPtr<ID3D11DeviceChild>& object)
+	{
+		m_aRetiredObjects.push_back(RetiredObject{ .Object = object, .uFrame = m_uNumBuiltFrames + 1u });
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::releaseRetiredObjects
+
+	  Summary:  Releases the retired objects of the frames the render
+				thread acquired. The render thread only ever moves on
+				to newer snapshots, so the snapshots older than the one
+				it acquired last, even the dropped ones, are never
+				replayed again
+
+	  Modifies: [m_aRetiredObjects].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::releaseRetiredObjects()
+	{
+		const UINT64 uLastAcquiredFrame = m_uLastAcquiredFrame.load(std::memory_order_acquire);
+
+		std::erase_if(
+			m_aRetiredObjects,
+			[uLastAcquiredFrame](const RetiredObject& retiredObject)
+			{
+				return retiredObject.uFrame <= uLastAcquiredFrame;
+			}
+		);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::renderScene
+
+	  Summary:  Executes the scene pass, after the cull stage. The
+				lights are assigned to the clusters, and the batching
+				of the visible renderables runs on the calling thread,
+				then the draw list is split into consecutive
+				ranges recorded in parallel into command buffers, which
+				the backend executes in order
+
+	  Args:     RenderBackend& backend
+				  Backend receiving the commands of the pass
+
+	  Modifies: [m_lightCuller, m_aRenderableBatchKeys,
+				 m_aRenderableBatches, m_aRenderableInstances,
+				 m_renderableInstanceBuffer, m_uRenderableInstanceCapacity,
+				 m_aRetiredObjects, m_uSkinningUploadBytes,
+				 m_aCommandBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::renderScene(_In_ RenderBackend& backend)
+	{
+		// Create camera constant buffer and update
+		XMFLOAT4 camPos;
+		XMStoreFloat4(&camPos, m_interpolatedEye);
+		CBChangeOnCameraMovement cbCamera = {
+			.View = XMMatrixTranspose(m_interpolatedView),
+			.CameraPosition = camPos,
+		};
+
+		backend.UpdateBuffer(m_camera.GetConstantBuffer().Get(), &cbCamera, sizeof(cbCamera));
+
+		// Assign the lights to the clusters and upload the lists
+		m_lightCuller.Update(m_interpolatedView, m_pointLights.GetResources());
+		m_lightCuller.Upload(backend);
+
+		backend.UpdateBuffer(m_cbLights.Get(), &m_lightCuller.GetConstants(), sizeof(CBLights));
+
+		const std::shared_ptr<Scene>& mainScene = m_scenes.Get(m_mainScene);
+		const std::vector<SceneChunk>& chunks = mainScene->GetChunks();
+		std::vector<std::shared_ptr<Voxel>>& voxels = mainScene->GetVoxels();
+
+		batchRenderables(backend);
+
+		// Upload the bones of the visible models whose pose changed, and the palettes and instances of the crowds
+		m_uSkinningUploadBytes = 0u;
+		const UINT64 uFrame = m_uNumBuiltFrames + 1u;
+		const UINT64 uLastAcquiredFrame = m_uLastAcquiredFrame.load(std::memory_order_acquire);
+		for (Model* pModel : m_apVisibleModels)
+		{
+			m_uSkinningUploadBytes += pModel->UploadBoneTransforms(backend, uFrame, uLastAcquiredFrame);
+		}
+
+		for (const auto& modelCrowd : m_modelCrowds)
+		{
+			m_uSkinningUploadBytes += modelCrowd->Upload(backend);
+		}
+
+		// The draw list is the static batches, then the batches of visible renderables, then the voxels, then the visible models, then the crowds
+		const size_t uNumDraws = m_staticBatcher.GetNumBatches() + m_aRenderableBatches.size() + voxels.size() + m_apVisibleModels.size() + m_modelCrowds.GetSize();
+		const UINT uNumCommandBuffers = static_cast<UINT>(std::min(m_aCommandBuffers.size(), uNumDraws / MIN_DRAWS_PER_COMMAND_BUFFER));
+
+		if (uNumCommandBuffers < 2u)
+		{
+			recordFrameState(backend);
+			recordDraws(backend, voxels, chunks, 0u, uNumDraws);
+		}
+		else
+		{
+			std::for_each(
+				std::execution::par,
+				m_aCommandBuffers.begin(),
+				m_aCommandBuffers.begin() + uNumCommandBuffers,
+				[&](const std::unique_ptr<CommandBuffer>& commandBuffer)
+				{
+					const size_t uIndex = static_cast<size_t>(&commandBuffer - m_aCommandBuffers.data());
+
+					commandBuffer->Reset();
+					recordFrameState(*commandBuffer);
+					recordDraws(
+						*commandBuffer,
+						voxels,
+						chunks,
+						uIndex * uNumDraws / uNumCommandBuffers,
+						(uIndex + 1u) * uNumDraws / uNumCommandBuffers
+					);
+				}
+			);
+
+			backend.ExecuteCommandBuffers(m_apCommandBuffers.data(), uNumCommandBuffers);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::RenderSoftware
+
+	  Summary:  Renders the frame on the CPU. The same objects as Render
+				are culled and drawn, with the shaders reproduced by the
+				software renderer, so no device context is used
+
+	  Args:     SoftwareRenderer& softwareRenderer
+				  Software renderer receiving the frame
+
+	  Modifies: [m_interpolatedView, m_interpolatedEye, m_lightCuller,
+				 m_occlusionCuller, m_aChunkVisibilities,
+				 m_apVisibleRenderables, m_apVisibleModels,
+				 m_staticBatcher].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::RenderSoftware(_In_ SoftwareRenderer& softwareRenderer)
+	{
+		HRESULT hr = S_OK;
+
+		interpolateCamera();
+
+		XMFLOAT4 camPos;
+		XMStoreFloat4(&camPos, m_interpolatedEye);
+
+		m_lightCuller.Update(m_interpolatedView, m_pointLights.GetResources());
+
+		softwareRenderer.BeginFrame(
+			CLEAR_COLOR,
+			m_interpolatedView,
+			m_projection,
+			camPos,
+			m_lightCuller.GetLights().data(),
+			m_lightCuller.GetNumLights()
+		);
+
+		const std::shared_ptr<Scene>& mainScene = m_scenes.Get(m_mainScene);
+		const std::vector<SceneChunk>& chunks = mainScene->GetChunks();
+		std::vector<std::shared_ptr<Voxel>>& voxels = mainScene->GetVoxels();
+
+		hr = m_staticBatcher.Update(m_d3dDevice.Get());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		cull(chunks);
+
+		// The static renderables are drawn one by one, the software renderer has no use for the merged buffers
+		for (Renderable* pRenderable : m_staticBatcher.GetVisibleRenderables())
+		{
+			hr = softwareRenderer.DrawRenderable(*pRenderable);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		for (Renderable* pRenderable : m_apVisibleRenderables)
+		{
+			hr = softwareRenderer.DrawRenderable(*pRenderable);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		// Same merging of the instances of consecutive visible chunks as recordVoxel
+		for (size_t voxelIdx = 0u; voxelIdx < voxels.size(); ++voxelIdx)
+		{
+			UINT uStartInstance = 0u;
+			UINT uNumInstances = 0u;
+			for (size_t chunkIdx = 0u; chunkIdx <= chunks.size(); ++chunkIdx)
+			{
+				const BOOL bDraw = chunkIdx < chunks.size() && m_aChunkVisibilities[chunkIdx];
+				if (bDraw && uNumInstances == 0u)
+				{
+					uStartInstance = chunks[chunkIdx].aInstanceRanges[voxelIdx].uStartInstance;
+				}
+
+				if (bDraw)
+				{
+					uNumInstances += chunks[chunkIdx].aInstanceRanges[voxelIdx].uNumInstances;
+				}
+				else if (uNumInstances > 0u)
+				{
+					softwareRenderer.DrawVoxels(*voxels[voxelIdx], uStartInstance, uNumInstances);
+					uNumInstances = 0u;
+				}
+			}
+		}
+
+		for (Model* pModel : m_apVisibleModels)
+		{
+			hr = softwareRenderer.DrawModel(*pModel);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+		}
+
+		softwareRenderer.EndFrame();
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::resetFrameAllocations
+
+	  Summary:  Starts the next block of the frame arena and gives the
+				lists of the frame new, empty storage in it. The storage
+				of the previous frame stays valid until the arena comes
+				back to its block. Each list reserves what it held last
+				frame, so it does not grow step by step
+
+	  Modifies: [m_frameArena, m_apVisibleRenderables,
+				 m_aRenderableBatchKeys, m_aRenderableBatches,
+				 m_aRenderableInstances, m_apVisibleModels,
+				 m_auVisibleEntities].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::resetFrameAllocations()
+	{
+		const size_t uNumVisibleRenderables = m_apVisibleRenderables.size();
+		const size_t uNumRenderableBatchKeys = m_aRenderableBatchKeys.size();
+		const size_t uNumRenderableBatches = m_aRenderableBatches.size();
+		const size_t uNumRenderableInstances = m_aRenderableInstances.size();
+		const size_t uNumVisibleModels = m_apVisibleModels.size();
+		const size_t uNumVisibleEntities = m_auVisibleEntities.size();
+
+		m_frameArena.BeginFrame();
+
+		// Assigning moves the allocator too, the old storage is dropped without being freed
+		m_apVisibleRenderables = FrameVector<Renderable*>(FrameAllocator<Renderable*>(m_frameArena));
+		m_aRenderableBatchKeys = FrameVector<RenderableBatchKey>(FrameAllocator<RenderableBatchKey>(m_frameArena));
+		m_aRenderableBatches = FrameVector<RenderableBatch>(FrameAllocator<RenderableBatch>(m_frameArena));
+		m_aRenderableInstances = FrameVector<RenderableInstanceData>(FrameAllocator<RenderableInstanceData>(m_frameArena));
+		m_apVisibleModels = FrameVector<Model*>(FrameAllocator<Model*>(m_frameArena));
+		m_auVisibleEntities = FrameVector<UINT>(FrameAllocator<UINT>(m_frameArena));
+
+		m_apVisibleRenderables.reserve(uNumVisibleRenderables);
+		m_aRenderableBatchKeys.reserve(uNumRenderableBatchKeys);
+		m_aRenderableBatches.reserve(uNumRenderableBatches);
+		m_aRenderableInstances.reserve(uNumRenderableInstances);
+		m_apVisibleModels.reserve(uNumVisibleModels);
+		m_auVisibleEntities.reserve(uNumVisibleEntities);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::cull
+
+	  Summary:  Rasterizes the occluders and tests the chunks of the
+				main scene, the renderables, the sub-draws of the static
+				batches, the models and the entities against them. The
+				entities are tested on their world bounds, and a
+				subtree of entities first on its bounds, as a whole,
+				both updated by the entity store. The chunk borders
+				are added to the debug drawing when it is enabled
+
+	  Args:     const std::vector<SceneChunk>& chunks
+				  Chunks of the main scene
+
+	  Modifies: [m_occlusionCuller, m_aChunkVisibilities,
+				 m_apVisibleRenderables, m_apVisibleModels,
+				 m_staticBatcher, m_debugDraw, m_frameArena,
+				 m_aRenderableBatchKeys, m_aRenderableBatches,
+				 m_aRenderableInstances, m_auVisibleEntities].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::cull(_In_ const std::vector<SceneChunk>& chunks)
+	{
+		resetFrameAllocations();
+
+		// Rasterize the occluders on the CPU: the solid part of every terrain chunk and the marked renderables
+		m_occlusionCuller.BeginFrame(m_interpolatedView * m_projection);
+		for (const SceneChunk& chunk : chunks)
+		{
+			if (chunk.bHasOccluder)
+			{
+				m_occlusionCuller.RenderOccluderBox(chunk.OccluderBounds);
+			}
+		}
+		for (const auto& occluder : m_occluders)
+		{
+			occluder->RenderOccluder(m_occlusionCuller);
+		}
+		m_occlusionCuller.EndOccluders();
+
+		// Cull on the calling thread, the culler is not thread safe
+		m_aChunkVisibilities.resize(chunks.size());
+		for (size_t i = 0u; i < chunks.size(); ++i)
+		{
+			m_aChunkVisibilities[i] = m_occlusionCuller.IsVisible(chunks[i].Bounds);
+		}
+
+		// Show the chunk borders, green when visible and red when occluded
+		if (m_debugDraw.IsEnabled())
+		{
+			for (size_t i = 0u; i < chunks.size(); ++i)
+			{
+				m_debugDraw.AddBox(chunks[i].Bounds, m_aChunkVisibilities[i] ? XMFLOAT4(0.0f, 1.0f, 0.0f, 1.0f) : XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f));
+			}
+		}
+
+		m_staticBatcher.Cull(m_occlusionCuller);
+
+		for (const auto& renderable : m_renderables)
+		{
+			if (!renderable->IsStatic() && m_occlusionCuller.IsVisible(renderable->GetBoundingBox()))
+			{
+				m_apVisibleRenderables.push_back(renderable.get());
+			}
+		}
+
+		for (const auto& model : m_models)
+		{
+			if (m_occlusionCuller.IsVisible(model->GetBoundingBox()))
+			{
+				m_apVisibleModels.push_back(model.get());
+			}
+		}
+
+		// A hidden subtree hides all the entities in it, which are skipped at once
+		const std::vector<EntityMeshHandle>& aEntityMeshes = m_entities.GetMeshes();
+		const std::vector<UINT>& auEntitySubtreeSizes = m_entities.GetSubtreeSizes();
+		const std::vector<AxisAlignedBox>& aEntityBounds = m_entities.GetWorldBounds();
+		const std::vector<AxisAlignedBox>& aEntitySubtreeBounds = m_entities.GetSubtreeBounds();
+		for (UINT i = 0u; i < m_entities.GetSize();)
+		{
+			if (auEntitySubtreeSizes[i] > 1u && !m_occlusionCuller.IsVisible(aEntitySubtreeBounds[i]))
+			{
+				i += auEntitySubtreeSizes[i];
+				continue;
+			}
+
+			if (!aEntityMeshes[i].IsNull() && m_occlusionCuller.IsVisible(aEntityBounds[i]))
+			{
+				m_auVisibleEntities.push_back(i);
+			}
+			++i;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::batchRenderables
+
+	  Summary:  Groups the visible renderables drawn with the same
+				geometry, texture and pipeline state, when an instanced
+				pipeline state is set for theirs. Each group of two or more
+				becomes one instanced draw, its world matrices and
+				output colors are written to the instance buffer. The
+				others are drawn one by one, before the groups. The
+				visible entities follow, in instanced draws of their
+				meshes. The lists were emptied when the frame was culled
+
+	  Args:     RenderBackend& backend
+				  Backend receiving the instance buffer upload
+
+	  Modifies: [m_aRenderableBatchKeys, m_aRenderableBatches,
+				 m_aRenderableInstances, m_renderableInstanceBuffer,
+				 m_uRenderableInstanceCapacity, m_aRetiredObjects].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::batchRenderables(_In_ RenderBackend& backend)
+	{
+		for (Renderable* pRenderable : m_apVisibleRenderables)
+		{
+			const InstancedPipelineState* pInstancedPipelineState = pRenderable->GetNumMeshes() == 1u ? findInstancedPipelineState(*pRenderable) : nullptr;
+			if (!pInstancedPipelineState)
+			{
+				m_aRenderableBatches.push_back(RenderableBatch{ .pRenderable = pRenderable, .pInstancedPipelineState = nullptr, .uStartInstance = 0u, .uNumInstances = 0u });
+				continue;
+			}
+
+			const auto& mesh = pRenderable->GetMesh(0u);
+			m_aRenderableBatchKeys.push_back(
+				RenderableBatchKey
+				{
+					.pInstancedPipelineState = pInstancedPipelineState,
+					.pVertices = pRenderable->GetVertices(),
+					.pIndices = pRenderable->GetIndices(),
+					.pDiffuse = pRenderable->HasTexture() ? pRenderable->GetMaterial(mesh.uMaterialIndex).pDiffuse.get() : nullptr,
+					.uNumIndices = mesh.uNumIndices,
+					.uBaseIndex = mesh.uBaseIndex,
+					.uBaseVertex = mesh.uBaseVertex,
+					.pRenderable = pRenderable,
+				}
+			);
+		}
+
+		// Every candidate and visible entity may become an instance, the buffer grows to hold them all
+		const size_t uNumInstanceCandidates = m_aRenderableBatchKeys.size() + m_auVisibleEntities.size();
+		if (uNumInstanceCandidates > m_uRenderableInstanceCapacity)
+		{
+			const UINT uCapacity = std::max(static_cast<UINT>(uNumInstanceCandidates), 2u * m_uRenderableInstanceCapacity);
+
+			D3D11_BUFFER_DESC bufferDesc = {
+				.ByteWidth = uCapacity * static_cast<UINT>(sizeof(RenderableInstanceData)),
+				.Usage = D3D11_USAGE_DEFAULT,
+				.BindFlags = D3D11_BIND_VERTEX_BUFFER,
+				.CPUAccessFlags = 0,
+				.MiscFlags = 0,
+				.StructureByteStride = 0
+			};
+
+			ComPtr<ID3D11Buffer> instanceBuffer;
+			if (SUCCEEDED(m_d3dDevice->CreateBuffer(&bufferDesc, nullptr, instanceBuffer.GetAddressOf())))
+			{
+				// The snapshot being submitted may still draw from the previous buffer
+				if (m_renderableInstanceBuffer)
+				{
+					retireObject(m_renderableInstanceBuffer);
+				}
+				m_renderableInstanceBuffer = instanceBuffer;
+				m_uRenderableInstanceCapacity = uCapacity;
+			}
+			else
+			{
+				// Draw the candidates one by one this frame
+				for (const RenderableBatchKey& key : m_aRenderableBatchKeys)
+				{
+					m_aRenderableBatches.push_back(RenderableBatch{ .pRenderable = key.pRenderable, .pInstancedPipelineState = nullptr, .uStartInstance = 0u, .uNumInstances = 0u });
+				}
+				m_aRenderableBatchKeys.clear();
+
+				// The entities are only drawn instanced
+				m_auVisibleEntities.clear();
+			}
+		}
+
+		const auto batchOf = [](const RenderableBatchKey& key)
+		{
+			return std::make_tuple(key.pInstancedPipelineState, key.pVertices, key.pIndices, key.pDiffuse, key.uNumIndices, key.uBaseIndex, key.uBaseVertex);
+		};
+		// The renderable breaks the ties, a stable sort would allocate its merge buffer every frame
+		std::sort(
+			m_aRenderableBatchKeys.begin(),
+			m_aRenderableBatchKeys.end(),
+			[&batchOf](const RenderableBatchKey& a, const RenderableBatchKey& b)
+			{
+				return std::make_tuple(batchOf(a), a.pRenderable) < std::make_tuple(batchOf(b), b.pRenderable);
+			}
+		);
+
+		size_t uBegin = 0u;
+		while (uBegin < m_aRenderableBatchKeys.size())
+		{
+			size_t uEnd = uBegin + 1u;
+			while (uEnd < m_aRenderableBatchKeys.size() && batchOf(m_aRenderableBatchKeys[uEnd]) == batchOf(m_aRenderableBatchKeys[uBegin]))
+			{
+				++uEnd;
+			}
+
+			if (uEnd - uBegin == 1u)
+			{
+				m_aRenderableBatches.push_back(RenderableBatch{ .pRenderable = m_aRenderableBatchKeys[uBegin].pRenderable, .pInstancedPipelineState = nullptr, .uStartInstance = 0u, .uNumInstances = 0u });
+			}
+			else
+			{
+				m_aRenderableBatches.push_back(
+					RenderableBatch
+					{
+						.pRenderable = m_aRenderableBatchKeys[uBegin].pRenderable,
+						.pInstancedPipelineState = m_aRenderableBatchKeys[uBegin].pInstancedPipelineState,
+						.uStartInstance = static_cast<UINT>(m_aRenderableInstances.size()),
+						.uNumInstances = static_cast<UINT>(uEnd - uBegin),
+					}
+				);
+
+				for (size_t i = uBegin; i < uEnd; ++i)
+				{
+					const Renderable& renderable = *m_aRenderableBatchKeys[i].pRenderable;
+					m_aRenderableInstances.push_back(
+						RenderableInstanceData
+						{
+							.World = renderable.GetInterpolatedWorldMatrix(m_interpolationAlpha),
+							.OutputColor = renderable.GetOutputColor(),
+						}
+					);
+				}
+			}
+
+			uBegin = uEnd;
+		}
+
+		batchEntities();
+
+		if (!m_aRenderableInstances.empty())
+		{
+			backend.UpdateBuffer(
+				m_renderableInstanceBuffer.Get(),
+				m_aRenderableInstances.data(),
+				static_cast<UINT>(m_aRenderableInstances.size() * sizeof(RenderableInstanceData))
+			);
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::batchEntities
+
+	  Summary:  Groups the visible entities by mesh, each group becomes
+				an instanced draw of the mesh. The instances are read
+				from the arrays of the entity store, in the order of the
+				store. The entities of a removed mesh, or of a mesh
+				without instanced pipeline state, are not drawn
+
+	  Modifies: [m_auVisibleEntities, m_aRenderableBatches,
+				 m_aRenderableInstances].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::batchEntities()
+	{
+		const std::vector<EntityMeshHandle>& aMeshes = m_entities.GetMeshes();
+		const std::vector<XMFLOAT4>& aOutputColors = m_entities.GetOutputColors();
+
+		std::sort(
+			m_auVisibleEntities.begin(),
+			m_auVisibleEntities.end(),
+			[&aMeshes](UINT a, UINT b)
+			{
+				return std::make_tuple(aMeshes[a].uIndex, aMeshes[a].uGeneration, a) < std::make_tuple(aMeshes[b].uIndex, aMeshes[b].uGeneration, b);
+			}
 		);
 
-		m_immediateContext->PSSetConstantBuffers(3, 1, m_cbLights.GetAddressOf());
+		size_t uBegin = 0u;
+		while (uBegin < m_auVisibleEntities.size())
+		{
+			const EntityMeshHandle meshHandle = aMeshes[m_auVisibleEntities[uBegin]];
+			size_t uEnd = uBegin + 1u;
+			while (uEnd < m_auVisibleEntities.size() && aMeshes[m_auVisibleEntities[uEnd]] == meshHandle)
+			{
+				++uEnd;
+			}
+
+			Renderable* pMesh = m_entityMeshes.Get(meshHandle).get();
+			const InstancedPipelineState* pInstancedPipelineState = pMesh && pMesh->GetNumMeshes() == 1u ? findInstancedPipelineState(*pMesh) : nullptr;
+			if (pInstancedPipelineState)
+			{
+				m_aRenderableBatches.push_back(
+					RenderableBatch
+					{
+						.pRenderable = pMesh,
+						.pInstancedPipelineState = pInstancedPipelineState,
+						.uStartInstance = static_cast<UINT>(m_aRenderableInstances.size()),
+						.uNumInstances = static_cast<UINT>(uEnd - uBegin),
+					}
+				);
+
+				for (size_t i = uBegin; i < uEnd; ++i)
+				{
+					const UINT uEntity = m_auVisibleEntities[i];
+					m_aRenderableInstances.push_back(
+						RenderableInstanceData
+						{
+							.World = m_entities.GetInterpolatedWorldMatrix(uEntity, m_interpolationAlpha),
+							.OutputColor = aOutputColors[uEntity],
+						}
+					);
+				}
+			}
+
+			uBegin = uEnd;
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::findInstancedPipelineState
+
+	  Summary:  Returns the instanced pipeline state set for the
+				pipeline state of a renderable
+
+	  Args:     Renderable& renderable
+				  Renderable to look up
+
+	  Returns:  const InstancedPipelineState*
+				  The instanced pipeline state, nullptr if there is none
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const Renderer::InstancedPipelineState* Renderer::findInstancedPipelineState(_In_ Renderable& renderable) const
+	{
+		for (const InstancedPipelineState& instanced : m_aInstancedPipelineStates)
+		{
+			if (renderable.GetPipelineState() == instanced.pipelineState)
+			{
+				return &instanced;
+			}
+		}
+
+		return nullptr;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordFrameState
+
+	  Summary:  Records the states shared by every draw of the frame.
+				Each command buffer starts with them, since it may be
+				translated on a deferred context starting from the
+				default state
+
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordFrameState(_In_ RenderBackend& backend)
+	{
+		// Set primitive topology
+		backend.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+		// Set camera, projection and light constant buffers
+		backend.SetVertexShaderConstantBuffer(0u, m_camera.GetConstantBuffer().Get());
+		backend.SetPixelShaderConstantBuffer(0u, m_camera.GetConstantBuffer().Get());
+		backend.SetVertexShaderConstantBuffer(1u, m_cbChangeOnResize.Get());
+		backend.SetVertexShaderConstantBuffer(3u, m_cbLights.Get());
+		backend.SetPixelShaderConstantBuffer(3u, m_cbLights.Get());
+
+		// Set the lights and their cluster lists
+		m_lightCuller.Bind(backend);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordDraws
+
+	  Summary:  Records a range of the draw list. Only reads the
+				renderer, so disjoint ranges can be recorded by
+				different threads
+
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				std::vector<std::shared_ptr<Voxel>>& voxels
+				  Voxels of the main scene
+				const std::vector<SceneChunk>& chunks
+				  Chunks of the main scene
+				size_t uBegin
+				  First draw of the range
+				size_t uEnd
+				  One past the last draw of the range
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordDraws(
+		_In_ RenderBackend& backend,
+		_In_ std::vector<std::shared_ptr<Voxel>>& voxels,
+		_In_ const std::vector<SceneChunk>& chunks,
+		_In_ size_t uBegin,
+		_In_ size_t uEnd
+	)
+	{
+		const size_t uRenderableBatchesBegin = m_staticBatcher.GetNumBatches();
+		const size_t uVoxelsBegin = uRenderableBatchesBegin + m_aRenderableBatches.size();
+		const size_t uModelsBegin = uVoxelsBegin + voxels.size();
+		const size_t uModelCrowdsBegin = uModelsBegin + m_apVisibleModels.size();
+
+		for (size_t i = uBegin; i < uEnd; ++i)
+		{
+			if (i < uRenderableBatchesBegin)
+			{
+				m_staticBatcher.Record(backend, i);
+			}
+			else if (i < uVoxelsBegin)
+			{
+				recordRenderableBatch(backend, m_aRenderableBatches[i - uRenderableBatchesBegin]);
+			}
+			else if (i < uModelsBegin)
+			{
+				recordVoxel(backend, *voxels[i - uVoxelsBegin], i - uVoxelsBegin, chunks);
+			}
+			else if (i < uModelCrowdsBegin)
+			{
+				recordModel(backend, *m_apVisibleModels[i - uModelsBegin]);
+			}
+			else
+			{
+				recordModelCrowd(backend, *m_modelCrowds.GetResources()[i - uModelCrowdsBegin]);
+			}
+		}
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordRenderable
+
+	  Summary:  Records the draws of a renderable
+
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				Renderable& renderable
+				  Renderable to draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordRenderable(_In_ RenderBackend& backend, _In_ Renderable& renderable)
+	{
+		// Set the vertex buffer
+		backend.SetVertexBuffer(0u, renderable.GetVertexBuffer().Get(), sizeof(SimpleVertex), 0u);
+
+		// Set the index buffer
+		backend.SetIndexBuffer(renderable.GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT);
+
+		// Create and update renderable constant buffer
+		CBChangesEveryFrame cbRenderable = {
+			.World = XMMatrixTranspose(renderable.GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+			.OutputColor = renderable.GetOutputColor()
+		};
+
+		backend.UpdateBuffer(renderable.GetConstantBuffer().Get(), &cbRenderable, sizeof(cbRenderable));
+
+		// Set the pipeline state with the renderable constant buffer
+		backend.SetPipelineState(*renderable.GetPipelineState(), renderable.GetConstantBuffer().Get());
+
+		const UINT numOfMesh = renderable.GetNumMeshes();
+		for (UINT i = 0; i < numOfMesh; i++)
+		{
+			const auto& mesh = renderable.GetMesh(i);
+
+			if (renderable.HasTexture())
+			{
+				const auto& material = renderable.GetMaterial(mesh.uMaterialIndex);
+				const auto& diffuseView = material.pDiffuse->GetTextureResourceView();
+
+				backend.SetPixelShaderResource(0u, diffuseView.Get());
+			}
 
-		// For each renderables
-		for (auto& pair : m_renderables)
-		{
-			auto& renderable = pair.second;
+			backend.DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+		}
+	}
 
-			// Set the vertex buffer
-			UINT stride = sizeof(SimpleVertex);
-			UINT offset = 0;
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordRenderableBatch
 
-			m_immediateContext->IASetVertexBuffers(
-				0,												// the first input slot for binding
-				1,												// the number of buffers in the array
-				renderable->GetVertexBuffer().GetAddressOf(),	// the array of vertex buffers
-				&stride,										// array of stride values, one for each buffer
-				&offset
-			);
+	  Summary:  Records a batch of renderables. A single renderable is
+				drawn with its own constant buffer, a group with one
+				instanced draw reading the instance buffer
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(renderable->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				const RenderableBatch& batch
+				  Batch to draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordRenderableBatch(_In_ RenderBackend& backend, _In_ const RenderableBatch& batch)
+	{
+		if (batch.uNumInstances == 0u)
+		{
+			recordRenderable(backend, *batch.pRenderable);
+			return;
+		}
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(renderable->GetVertexLayout().Get());
+		Renderable& renderable = *batch.pRenderable;
 
-			// Create and update renderable constant buffer
-			CBChangesEveryFrame cbRenderable = {
-				.World = XMMatrixTranspose(renderable->GetWorldMatrix()),
-				.OutputColor = renderable->GetOutputColor()
-			};
+		// Set the vertex buffer of the first renderable, they all have the same geometry
+		backend.SetVertexBuffer(0u, renderable.GetVertexBuffer().Get(), sizeof(SimpleVertex), 0u);
 
-			m_immediateContext->UpdateSubresource(
-				renderable->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbRenderable,
-				0u,
-				0u
-			);
+		// Set the instance buffer
+		backend.SetVertexBuffer(1u, m_renderableInstanceBuffer.Get(), sizeof(RenderableInstanceData), 0u);
 
-			// Set shaders
-			m_immediateContext->VSSetShader(renderable->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(renderable->GetPixelShader().Get(), nullptr, 0);
+		// Set the index buffer
+		backend.SetIndexBuffer(renderable.GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT);
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, renderable->GetConstantBuffer().GetAddressOf());
+		// Set the instanced pipeline state, the instances carry the renderable constants
+		backend.SetPipelineState(*batch.pInstancedPipelineState->instancedPipelineState, nullptr);
 
-			const UINT numOfMesh = renderable->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
-			{
-				const auto& mesh = renderable->GetMesh(i);
+		const auto& mesh = renderable.GetMesh(0u);
+		if (renderable.HasTexture())
+		{
+			const auto& material = renderable.GetMaterial(mesh.uMaterialIndex);
 
-				if (renderable->HasTexture())
-				{
-					const auto& material = renderable->GetMaterial(mesh.uMaterialIndex);
-					const auto& diffuseView = material.pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = material.pDiffuse->GetSamplerState();
+			backend.SetPixelShaderResource(0u, material.pDiffuse->GetTextureResourceView().Get());
+		}
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
-				}
+		backend.DrawIndexedInstanced(mesh.uNumIndices, batch.uNumInstances, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex), batch.uStartInstance);
+	}
 
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
-			}
-		}
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordVoxel
+
+	  Summary:  Records the instanced draws of a voxel type, skipping
+				the instances of the occluded chunks
+
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				Voxel& vox
+				  Voxel to draw
+				size_t voxelIdx
+				  Index of the voxel in the main scene
+				const std::vector<SceneChunk>& chunks
+				  Chunks of the main scene
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordVoxel(_In_ RenderBackend& backend, _In_ Voxel& vox, _In_ size_t voxelIdx, _In_ const std::vector<SceneChunk>& chunks)
+	{
+		// Set the vertex buffer
+		backend.SetVertexBuffer(0u, vox.GetVertexBuffer().Get(), sizeof(SimpleVertex), 0u);
 
-		auto& voxels = m_scenes[m_pszMainSceneName]->GetVoxels();
-		for (auto& vox : voxels)
-		{
-			// Set the vertex buffer
-			UINT vtxStride = sizeof(SimpleVertex);
-			UINT vtxOffset = 0;
+		// Set the instance buffer
+		backend.SetVertexBuffer(1u, vox.GetInstanceBuffer().Get(), sizeof(InstanceData), 0u);
 
-			m_immediateContext->IASetVertexBuffers(
-				0,										// the first input slot
-				1,										// the number of buffers
-				vox->GetVertexBuffer().GetAddressOf(),
-				&vtxStride,								// array of stride values, one for each buffer
-				&vtxOffset
-			);
+		// Set the index buffer
+		backend.SetIndexBuffer(vox.GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT);
 
-			// Set the instance buffer
-			UINT insStride = sizeof(InstanceData);
-			UINT insOffset = 0;
+		// Create and update voxel constant buffer
+		CBChangesEveryFrame cbVoxel = {
+			.World = XMMatrixTranspose(vox.GetWorldMatrix()),
+			.OutputColor = vox.GetOutputColor()
+		};
 
-			m_immediateContext->IASetVertexBuffers(
-				1, // second slot
-				1,
-				vox->GetInstanceBuffer().GetAddressOf(),
-				&insStride,
-				&insOffset
-			);
+		backend.UpdateBuffer(vox.GetConstantBuffer().Get(), &cbVoxel, sizeof(cbVoxel));
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(vox->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+		// Set the pipeline state with the voxel constant buffer
+		backend.SetPipelineState(*vox.GetPipelineState(), vox.GetConstantBuffer().Get());
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(vox->GetVertexLayout().Get());
+		// Instances are sorted by chunk, so consecutive visible chunks are merged into one draw
+		UINT uStartInstance = 0u;
+		UINT uNumInstances = 0u;
+		for (size_t chunkIdx = 0u; chunkIdx <= chunks.size(); ++chunkIdx)
+		{
+			const BOOL bDraw = chunkIdx < chunks.size() && m_aChunkVisibilities[chunkIdx];
+			if (bDraw && uNumInstances == 0u)
+			{
+				uStartInstance = chunks[chunkIdx].aInstanceRanges[voxelIdx].uStartInstance;
+			}
 
-			// Create and update voxel constant buffer
-			CBChangesEveryFrame cbVoxel = {
-				.World = XMMatrixTranspose(vox->GetWorldMatrix()),
-				.OutputColor = vox->GetOutputColor()
-			};
+			if (bDraw)
+			{
+				uNumInstances += chunks[chunkIdx].aInstanceRanges[voxelIdx].uNumInstances;
+			}
+			else if (uNumInstances > 0u)
+			{
+				backend.DrawIndexedInstanced(
+					vox.GetNumIndices(),
+					uNumInstances,
+					0,
+					0,
+					uStartInstance
+				);
+				uNumInstances = 0u;
+			}
+		}
+	}
 
-			m_immediateContext->UpdateSubresource(
-				vox->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbVoxel,
-				0u,
-				0u
-			);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordModel
 
-			// Set shaders
-			m_immediateContext->VSSetShader(vox->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(vox->GetPixelShader().Get(), nullptr, 0);
+	  Summary:  Records the draws of a skinned model
 
-			// Set constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, vox->GetConstantBuffer().GetAddressOf());
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				Model& model
+				  Model to draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordModel(_In_ RenderBackend& backend, _In_ Model& model)
+	{
+		// Set the vertex buffer
 
-			m_immediateContext->DrawIndexedInstanced(
-				vox->GetNumIndices(),
-				vox->GetNumInstances(),
-				0,
-				0,
-				0
-			);
-		}
+		// First slot
+		backend.SetVertexBuffer(0u, model.GetVertexBuffer().Get(), sizeof(SimpleVertex), 0u);
 
-		// For each models
-		for (auto& pair : m_models)
-		{
-			auto& model = pair.second;
+		// Second slot
+		backend.SetVertexBuffer(1u, model.GetAnimationBuffer().Get(), sizeof(AnimationData), 0u);
 
-			// Set the vertex buffer
+		// Third slot, the diffuse array slice of the vertices
+		backend.SetVertexBuffer(2u, model.GetDiffuseSliceBuffer().Get(), sizeof(UINT), 0u);
 
-			// First slot
-			UINT stride0 = sizeof(SimpleVertex);
-			UINT offset0 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				0,
-				1,
-				model->GetVertexBuffer().GetAddressOf(),
-				&stride0,
-				&offset0
-			);
+		// Set the index buffer of the draws over the diffuse arrays
+		backend.SetIndexBuffer(model.GetMaterialDrawIndexBuffer().Get(), DXGI_FORMAT_R16_UINT);
 
-			// Second slot
-			UINT stride1 = sizeof(AnimationData);
-			UINT offset1 = 0;
-			m_immediateContext->IASetVertexBuffers(
-				1,
-				1,
-				model->GetAnimationBuffer().GetAddressOf(),
-				&stride1,
-				&offset1
-			);
+		// Create and update renderable constant buffer
+		CBChangesEveryFrame cbRenderable = {
+			.World = XMMatrixTranspose(model.GetInterpolatedWorldMatrix(m_interpolationAlpha)),
+			.OutputColor = model.GetOutputColor()
+		};
 
-			// Set the index buffer
-			m_immediateContext->IASetIndexBuffer(model->GetIndexBuffer().Get(), DXGI_FORMAT_R16_UINT, 0);
+		backend.UpdateBuffer(model.GetConstantBuffer().Get(), &cbRenderable, sizeof(cbRenderable));
 
-			// Set the input layout
-			m_immediateContext->IASetInputLayout(model->GetVertexLayout().Get());
+		// Set the pipeline state with the renderable constant buffer
+		backend.SetPipelineState(*model.GetPipelineState(), model.GetConstantBuffer().Get());
 
-			// Create and update renderable constant buffer
-			CBChangesEveryFrame cbRenderable = {
-				.World = XMMatrixTranspose(model->GetWorldMatrix()),
-				.OutputColor = model->GetOutputColor()
-			};
+		// Set the bone transforms, uploaded before the draws are recorded
+		backend.SetVertexShaderResource(Model::BONE_TRANSFORMS_SLOT, model.GetBoneTransformsView().Get());
 
-			m_immediateContext->UpdateSubresource(
-				model->GetConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbRenderable,
-				0u,
-				0u
-			);
+		// Meshes sharing a diffuse array are drawn at once, the array is bound only when it changes
+		UINT uBoundDiffuseArray = Model::NO_DIFFUSE_ARRAY;
+		const UINT uNumDraws = model.GetNumMaterialDraws();
+		for (UINT i = 0u; i < uNumDraws; ++i)
+		{
+			const Model::MaterialDraw& draw = model.GetMaterialDraw(i);
 
-			// Create and update skinning constant buffer
-			CBSkinning cbSkinning = {};
-			auto& transforms = model->GetBoneTransforms();
-			for (UINT i = 0u; i < transforms.size(); i++)
+			if (draw.uDiffuseArray != Model::NO_DIFFUSE_ARRAY && draw.uDiffuseArray != uBoundDiffuseArray)
 			{
-				cbSkinning.BoneTransforms[i] = transforms[i];
+				TextureArray& diffuseArray = model.GetDiffuseArray(draw.uDiffuseArray);
+
+				backend.SetPixelShaderResource(0u, diffuseArray.GetTextureResourceView().Get());
+				uBoundDiffuseArray = draw.uDiffuseArray;
 			}
 
-			m_immediateContext->UpdateSubresource(
-				model->GetSkinningConstantBuffer().Get(),
-				0u,
-				nullptr,
-				&cbSkinning,
-				0u,
-				0u
-			);
+			backend.DrawIndexed(draw.uNumIndices, draw.uBaseIndex, static_cast<INT>(draw.uBaseVertex));
+		}
+	}
 
-			// Set shaders
-			m_immediateContext->VSSetShader(model->GetVertexShader().Get(), nullptr, 0);
-			m_immediateContext->PSSetShader(model->GetPixelShader().Get(), nullptr, 0);
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::recordModelCrowd
 
-			// Set renderable constant buffer
-			m_immediateContext->VSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
-			m_immediateContext->VSSetConstantBuffers(4, 1, model->GetSkinningConstantBuffer().GetAddressOf());
-			m_immediateContext->PSSetConstantBuffers(2, 1, model->GetConstantBuffer().GetAddressOf());
+	  Summary:  Records the draws of a crowd, one instanced draw per
+				diffuse array draw of its model
 
+	  Args:     RenderBackend& backend
+				  Backend or command buffer receiving the commands
+				ModelCrowd& modelCrowd
+				  Crowd to draw
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::recordModelCrowd(_In_ RenderBackend& backend, _In_ ModelCrowd& modelCrowd)
+	{
+		Model& model = modelCrowd.GetModel();
+
+		// Set the vertex buffers of the model, shared by all the instances
+		backend.SetVertexBuffer(0u, model.GetVertexBuffer().Get(), sizeof(SimpleVertex), 0u);
+		backend.SetVertexBuffer(1u, model.GetAnimationBuffer().Get(), sizeof(AnimationData), 0u);
+		backend.SetVertexBuffer(2u, model.GetDiffuseSliceBuffer().Get(), sizeof(UINT), 0u);
+		backend.SetIndexBuffer(model.GetMaterialDrawIndexBuffer().Get(), DXGI_FORMAT_R16_UINT);
+
+		// Set the pipeline state, the bone palettes and the instances
+		backend.SetPipelineState(*modelCrowd.GetPipelineState(), nullptr);
+		modelCrowd.Bind(backend);
+
+		const UINT uNumInstances = modelCrowd.GetNumInstances();
+		UINT uBoundDiffuseArray = Model::NO_DIFFUSE_ARRAY;
+		const UINT uNumDraws = model.GetNumMaterialDraws();
+		for (UINT i = 0u; i < uNumDraws; ++i)
+		{
+			const Model::MaterialDraw& draw = model.GetMaterialDraw(i);
 
-			const UINT numOfMesh = model->GetNumMeshes();
-			for (UINT i = 0; i < numOfMesh; i++)
+			if (draw.uDiffuseArray != Model::NO_DIFFUSE_ARRAY && draw.uDiffuseArray != uBoundDiffuseArray)
 			{
-				const auto& mesh = model->GetMesh(i);
-
-				if (model->HasTexture())
-				{
-					const auto& material = model->GetMaterial(mesh.uMaterialIndex);
-					const auto& diffuseView = material.pDiffuse->GetTextureResourceView();
-					const auto& diffuseSampler = material.pDiffuse->GetSamplerState();
+				TextureArray& diffuseArray = model.GetDiffuseArray(draw.uDiffuseArray);
 
-					m_immediateContext->PSSetShaderResources(0, 1, diffuseView.GetAddressOf());
-					m_immediateContext->PSSetSamplers(0, 1, diffuseSampler.GetAddressOf());
-				}
-
-				m_immediateContext->DrawIndexed(mesh.uNumIndices, mesh.uBaseIndex, static_cast<INT>(mesh.uBaseVertex));
+				backend.SetPixelShaderResource(0u, diffuseArray.GetTextureResourceView().Get());
+				uBoundDiffuseArray = draw.uDiffuseArray;
 			}
-		}
-
-		// Present
-		m_swapChain->Present(0, 0);
 
-		// Set Render Target View again (Present call for DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL unbinds backbuffer 0)
-		m_immediateContext->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+			backend.DrawIndexedInstanced(draw.uNumIndices, uNumInstances, draw.uBaseIndex, static_cast<INT>(draw.uBaseVertex), 0u);
+		}
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetVertexShaderOfRenderable
+	  Method:   Renderer::SetPipelineStateOfRenderable
 
-	  Summary:  Sets the vertex shader for a renderable
+	  Summary:  Sets the pipeline state for a renderable
 
 	  Args:     PCWSTR pszRenderableName
 				  Key of the renderable
-				PCWSTR pszVertexShaderName
-				  Key of the vertex shader
+				PCWSTR pszPipelineStateName
+				  Key of the pipeline state
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_renderables, m_staticBatcher].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName)
+	HRESULT Renderer::SetPipelineStateOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPipelineStateName)
 	{
-		if (!m_renderables.contains(pszRenderableName) || !m_vertexShaders.contains(pszVertexShaderName))
+		const std::shared_ptr<Renderable>& renderable = m_renderables.Get(m_renderables.Find(pszRenderableName));
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!renderable || !pipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& vs = m_vertexShaders[pszVertexShaderName];
-		m_renderables[pszRenderableName]->SetVertexShader(vs);
+		renderable->SetPipelineState(pipelineState);
+
+		// A batched static renderable moves to the batch of its new pipeline state
+		if (renderable->IsStatic())
+		{
+			m_staticBatcher.Remove(renderable.get());
+			m_staticBatcher.Add(renderable.get());
+		}
 		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetPixelShaderOfRenderable
+	  Method:   Renderer::SetPipelineStateOfModel
 
-	  Summary:  Sets the pixel shader for a renderable
+	  Summary:  Sets the pipeline state for a model
 
-	  Args:     PCWSTR pszRenderableName
-				  Key of the renderable
-				PCWSTR pszPixelShaderName
-				  Key of the pixel shader
+	  Args:     PCWSTR pszModelName
+				  Key of the model
+				PCWSTR pszPipelineStateName
+				  Key of the pipeline state
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_models].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName)
+	HRESULT Renderer::SetPipelineStateOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPipelineStateName)
 	{
-		if (!m_renderables.contains(pszRenderableName) || !m_pixelShaders.contains(pszPixelShaderName))
+		const std::shared_ptr<Model>& model = m_models.Get(m_models.Find(pszModelName));
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!model || !pipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& ps = m_pixelShaders[pszPixelShaderName];
-		m_renderables[pszRenderableName]->SetPixelShader(ps);
+		model->SetPipelineState(pipelineState);
 		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetVertexShaderOfModel
+	  Method:   Renderer::SetPipelineStateOfModelCrowd
 
-	  Summary:  Sets the pixel shader for a model
+	  Summary:  Sets the pipeline state for a crowd
 
-	  Args:     PCWSTR pszModelName
-				  Key of the model
-				PCWSTR pszVertexShaderName
-				  Key of the vertex shader
+	  Args:     PCWSTR pszModelCrowdName
+				  Key of the crowd
+				PCWSTR pszPipelineStateName
+				  Key of the pipeline state
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_modelCrowds].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName)
+	HRESULT Renderer::SetPipelineStateOfModelCrowd(_In_ PCWSTR pszModelCrowdName, _In_ PCWSTR pszPipelineStateName)
 	{
-		if (!m_models.contains(pszModelName) || !m_vertexShaders.contains(pszVertexShaderName))
+		const std::shared_ptr<ModelCrowd>& modelCrowd = m_modelCrowds.Get(m_modelCrowds.Find(pszModelCrowdName));
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!modelCrowd || !pipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& vs = m_vertexShaders[pszVertexShaderName];
-		m_models[pszModelName]->SetVertexShader(vs);
+		modelCrowd->SetPipelineState(pipelineState);
 		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetPixelShaderOfModel
+	  Method:   Renderer::SetPipelineStateOfScene
 
-	  Summary:  Sets the pixel shader for a model
+	  Summary:  Sets the pipeline state for the voxels in a scene
 
-	  Args:     PCWSTR pszModelName
-				  Key of the model
-				PCWSTR pszPixelShaderName
-				  Key of the pixel shader
+	  Args:     PCWSTR pszSceneName
+				  Key of the scene
+				PCWSTR pszPipelineStateName
+				  Key of the pipeline state
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_scenes].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName)
+	HRESULT Renderer::SetPipelineStateOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPipelineStateName)
 	{
-		if (!m_models.contains(pszModelName) || !m_pixelShaders.contains(pszPixelShaderName))
+		const std::shared_ptr<Scene>& scene = m_scenes.Get(m_scenes.Find(pszSceneName));
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!scene || !pipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& ps = m_pixelShaders[pszPixelShaderName];
-		m_models[pszModelName]->SetPixelShader(ps);
+		// The scene may not be parsed yet, it keeps the pipeline state for its voxels
+		scene->SetPipelineState(pipelineState);
+
 		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetVertexShaderOfScene
+	  Method:   Renderer::SetInstancedPipelineState
 
-	  Summary:  Sets the vertex shader for the voxels in a scene
+	  Summary:  Sets the pipeline state drawing the renderables of a
+				pipeline state in instanced draws. Visible renderables
+				with the same geometry, texture and pipeline state are
+				then grouped into one draw every frame. The vertex
+				shader of the instanced pipeline state must be an
+				InstancedVertexShader
 
-	  Args:     PCWSTR pszSceneName
-				  Key of the scene
-				PCWSTR pszVertexShaderName
-				  Key of the vertex shader
+	  Args:     PCWSTR pszPipelineStateName
+				  Key of the pipeline state of the renderables
+				PCWSTR pszInstancedPipelineStateName
+				  Key of the pipeline state reading the instance buffer
 
-	  Modifies: [m_scenes].
+	  Modifies: [m_aInstancedPipelineStates].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetVertexShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszVertexShaderName)
+	HRESULT Renderer::SetInstancedPipelineState(_In_ PCWSTR pszPipelineStateName, _In_ PCWSTR pszInstancedPipelineStateName)
 	{
-		if (!m_scenes.contains(pszSceneName) || !m_vertexShaders.contains(pszVertexShaderName))
+		const InstancedPipelineState instanced =
+		{
+			.pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName)),
+			.instancedPipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszInstancedPipelineStateName)),
+		};
+		if (!instanced.pipelineState || !instanced.instancedPipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& vs = m_vertexShaders[pszVertexShaderName];
-		const auto& voxels = m_scenes[pszSceneName]->GetVoxels();
 
-		for (const auto& vox : voxels)
+		for (InstancedPipelineState& existing : m_aInstancedPipelineStates)
 		{
-			vox->SetVertexShader(vs);
+			if (existing.pipelineState == instanced.pipelineState)
+			{
+				existing = instanced;
+				return S_OK;
+			}
 		}
 
+		m_aInstancedPipelineStates.push_back(instanced);
 		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
-	  Method:   Renderer::SetPixelShaderOfScene
+	  Method:   Renderer::SetPipelineStateOfEntityMesh
 
-	  Summary:  Sets the pixel shader for the voxels in a scene
+	  Summary:  Sets the pipeline state of an entity mesh. Its entities
+				are drawn with the instanced pipeline state set for it
 
-	  Args:     PCWSTR pszRenderableName
-				  Key of the renderable
-				PCWSTR pszPixelShaderName
-				  Key of the pixel shader
+	  Args:     PCWSTR pszEntityMeshName
+				  Key of the entity mesh
+				PCWSTR pszPipelineStateName
+				  Key of the pipeline state
 
-	  Modifies: [m_renderables].
+	  Modifies: [m_entityMeshes].
 
 	  Returns:  HRESULT
 				  Status code
 	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-	HRESULT Renderer::SetPixelShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPixelShaderName)
+	HRESULT Renderer::SetPipelineStateOfEntityMesh(_In_ PCWSTR pszEntityMeshName, _In_ PCWSTR pszPipelineStateName)
 	{
-		if (!m_scenes.contains(pszSceneName) || !m_pixelShaders.contains(pszPixelShaderName))
+		const std::shared_ptr<Renderable>& mesh = m_entityMeshes.Get(m_entityMeshes.Find(pszEntityMeshName));
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!mesh || !pipelineState)
 		{
 			return E_INVALIDARG;
 		}
-		const auto& ps = m_pixelShaders[pszPixelShaderName];
-		const auto& voxels = m_scenes[pszSceneName]->GetVoxels();
 
-		for (const auto& vox : voxels)
+		mesh->SetPipelineState(pipelineState);
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetEntities
+
+	  Summary:  Returns the entity store, whose components the game
+				changes between the simulation steps
+
+	  Returns:  EntityStore&
+				  The entity store
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	EntityStore& Renderer::GetEntities()
+	{
+		return m_entities;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetNumRecordingThreads
+
+	  Summary:  Sets the maximum number of threads recording the draw
+				list, one command buffer each. Small draw lists use
+				fewer threads, and 1 records directly into the backend.
+				Deferred contexts are created once at initialization,
+				so call it before Initialize to use them all
+
+	  Args:     UINT uNumThreads
+				  Maximum number of recording threads
+
+	  Modifies: [m_aCommandBuffers, m_apCommandBuffers].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetNumRecordingThreads(_In_ UINT uNumThreads)
+	{
+		m_aCommandBuffers.clear();
+		m_apCommandBuffers.clear();
+
+		for (UINT i = 0u; i < std::max(uNumThreads, 1u); ++i)
 		{
-			vox->SetPixelShader(ps);
+			m_aCommandBuffers.push_back(std::make_unique<CommandBuffer>());
+			m_apCommandBuffers.push_back(m_aCommandBuffers.back().get());
 		}
-
-		return S_OK;
 	}
 
 	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
@@ -976,6 +2751,310 @@ namespace library {
 	{
 		return m_driverType;
 	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetOcclusionCuller
+
+	  Summary:  Returns the occlusion culler, e.g. to disable it or to
+				read the number of culled objects of the last frame
+
+	  Returns:  OcclusionCuller&
+				  The occlusion culler
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	OcclusionCuller& Renderer::GetOcclusionCuller()
+	{
+		return m_occlusionCuller;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetBackend
+
+	  Summary:  Returns the backend receiving the commands of a frame
+
+	  Returns:  std::shared_ptr<RenderBackend>&
+				  The render backend, nullptr before initialization
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	std::shared_ptr<RenderBackend>& Renderer::GetBackend()
+	{
+		return m_backend;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetFrameGraph
+
+	  Summary:  Returns the frame graph compiled at initialization
+
+	  Returns:  const FrameGraph&
+				  The frame graph, with its culling and memory stats
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const FrameGraph& Renderer::GetFrameGraph() const
+	{
+		return m_frameGraph;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetLightCuller
+
+	  Summary:  Returns the culler assigning the point lights to the
+				clusters of the view frustum
+
+	  Returns:  const ClusteredLightCuller&
+				  The light culler, with the lists of the last frame
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const ClusteredLightCuller& Renderer::GetLightCuller() const
+	{
+		return m_lightCuller;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetSkinningUploadBytes
+
+	  Summary:  Returns the bytes of bone transforms, crowd palettes and
+				crowd instances uploaded in the last frame
+
+	  Returns:  UINT
+				  Number of bytes uploaded, zero when no pose changed
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	UINT Renderer::GetSkinningUploadBytes() const
+	{
+		return m_uSkinningUploadBytes;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetPipelineStateOfDebugDraw
+
+	  Summary:  Sets the pipeline state of the debug drawing, its vertex
+				shader must be a DebugVertexShader
+
+	  Args:     PCWSTR pszPipelineStateName
+				  Key of the pipeline state
+
+	  Modifies: [m_debugDraw].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::SetPipelineStateOfDebugDraw(_In_ PCWSTR pszPipelineStateName)
+	{
+		const std::shared_ptr<PipelineState>& pipelineState = m_pipelineStates.Get(m_pipelineStates.Find(pszPipelineStateName));
+		if (!pipelineState)
+		{
+			return E_INVALIDARG;
+		}
+		m_debugDraw.SetPipelineState(pipelineState);
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetDebugDraw
+
+	  Summary:  Returns the debug drawing. Primitives may be added from
+				any thread until the frame is rendered
+
+	  Returns:  DebugDraw&
+				  The debug drawing
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	DebugDraw& Renderer::GetDebugDraw()
+	{
+		return m_debugDraw;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::BeginTrace
+
+	  Summary:  Wraps the backend in a TracingRenderBackend writing the
+				commands of the next frames into a binary trace, read
+				by the TraceStats tool. The backend is unwrapped after
+				the last traced frame
+
+	  Args:     const std::filesystem::path& filePath
+				  Path of the trace file
+				UINT uNumFrames
+				  Number of frames to trace
+
+	  Modifies: [m_backend, m_tracingBackend].
+
+	  Returns:  HRESULT
+				  Status code, E_FAIL before initialization or while
+				  a trace is running
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT Renderer::BeginTrace(_In_ const std::filesystem::path& filePath, _In_ UINT uNumFrames)
+	{
+		// The backend must not change while a frame is submitted, the render thread sleeps until the next one
+		WaitForSubmission();
+
+		if (!m_backend || m_tracingBackend)
+		{
+			return E_FAIL;
+		}
+
+		std::shared_ptr<TracingRenderBackend> tracingBackend = std::make_shared<TracingRenderBackend>(m_backend);
+		HRESULT hr = tracingBackend->Open(filePath, uNumFrames);
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		m_tracingBackend = tracingBackend;
+		m_backend = tracingBackend;
+
+		return S_OK;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetJobSystem
+
+	  Summary:  Returns the job system running the update and loading
+				work, started when the renderer is initialized
+
+	  Returns:  JobSystem&
+				  The job system
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	JobSystem& Renderer::GetJobSystem()
+	{
+		return m_jobSystem;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetAssetLoader
+
+	  Summary:  Returns the loader of the assets, started when the
+				renderer is initialized. The assets it loads are
+				created before each submission, within
+				MAX_ASSET_CREATION_SECONDS_PER_FRAME, and the coroutines
+				awaiting them continue on the render thread
+
+	  Returns:  AssetLoader&
+				  The asset loader
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	AssetLoader& Renderer::GetAssetLoader()
+	{
+		return m_assetLoader;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetFramePipeline
+
+	  Summary:  Returns the frame pipeline run by ExecuteFrame. The
+				game sets its input and update stages, and reads the
+				time of every stage
+
+	  Returns:  FramePipeline&
+				  The frame pipeline
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FramePipeline& Renderer::GetFramePipeline()
+	{
+		return m_framePipeline;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetFrameArena
+
+	  Summary:  Returns the arena holding the culled lists, batch keys
+				and instance data of the frames, to read its use
+
+	  Returns:  const FrameArena&
+				  The frame arena
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const FrameArena& Renderer::GetFrameArena() const
+	{
+		return m_frameArena;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::SetHeapAllocationCheck
+
+	  Summary:  Sets whether ExecuteFrame asserts that the frames do
+				not allocate from the heap once
+				HEAP_ALLOCATION_CHECK_WARM_UP_FRAMES frames were
+				executed. Only checked in debug builds
+
+	  Args:     BOOL bEnabled
+				  Whether to check the frames
+
+	  Modifies: [m_bHeapAllocationCheck].
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::SetHeapAllocationCheck(_In_ BOOL bEnabled)
+	{
+		m_bHeapAllocationCheck = bEnabled;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetStartupGraph
+
+	  Summary:  Returns the graph of the initialization, with the
+				thread and times of each of its tasks
+
+	  Returns:  const StartupGraph&
+				  The startup graph
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	const StartupGraph& Renderer::GetStartupGraph() const
+	{
+		return m_startupGraph;
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::GetTimeToFirstFrame
+
+	  Summary:  Returns the time from the creation of the process to
+				the submission of the first frame, which includes the
+				loading of the executable and the creation of the
+				window and device before the startup graph
+
+	  Returns:  FLOAT
+				  Seconds to the first frame, 0 before it
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT Renderer::GetTimeToFirstFrame() const
+	{
+		return m_timeToFirstFrame.load(std::memory_order_relaxed);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::WriteStartupReport
+
+	  Summary:  Prints when the startup graph began after the launch,
+				its timeline and critical path, and the time to first
+				frame
+
+	  Args:     std::FILE* pFile
+				  File to print to, such as stdout
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	void Renderer::WriteStartupReport(_In_ std::FILE* pFile) const
+	{
+		std::fprintf(pFile, "Startup graph began %.1f ms after the launch\n", m_startupGraphBeginSeconds * 1000.0f);
+		m_startupGraph.WriteReport(pFile);
+		std::fprintf(pFile, "\nTime to first frame: %.1f ms\n", GetTimeToFirstFrame() * 1000.0f);
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   Renderer::getSecondsSinceProcessStart
+
+	  Summary:  Returns the time since the creation of the process,
+				measured by the system clock in 100 ns units
+
+	  Returns:  FLOAT
+				  Seconds since the creation of the process, 0 if its
+				  times are not available
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	FLOAT Renderer::getSecondsSinceProcessStart()
+	{
+		FILETIME creationTime;
+		FILETIME exitTime;
+		FILETIME kernelTime;
+		FILETIME userTime;
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		{
+			return 0.0f;
+		}
+
+		FILETIME currentTime;
+		GetSystemTimePreciseAsFileTime(&currentTime);
+
+		const UINT64 uCreationTime = (static_cast<UINT64>(creationTime.dwHighDateTime) << 32u) | creationTime.dwLowDateTime;
+		const UINT64 uCurrentTime = (static_cast<UINT64>(currentTime.dwHighDateTime) << 32u) | currentTime.dwLowDateTime;
+
+		return static_cast<FLOAT>(uCurrentTime - uCreationTime) * 1e-7f;
+	}
 }
 
 
@@ -14,10 +14,31 @@
 #include "Common.h"
 
 #include "Camera/Camera.h"
+#include "Entity/EntityStore.h"
+#include "Job/JobSystem.h"
+#include "Job/TripleBuffer.h"
 #include "Light/PointLight.h"
+#include "Loading/AssetLoader.h"
+#include "Memory/FrameArena.h"
+#include "Memory/HeapAllocationCheck.h"
 #include "Model/Model.h"
+#include "Model/ModelCrowd.h"
+#include "Renderer/ClusteredLightCuller.h"
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/D3D11RenderBackend.h"
+#include "Renderer/DebugDraw.h"
 #include "Renderer/DataTypes.h"
+#include "Renderer/FrameGraph.h"
+#include "Renderer/FramePipeline.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/RecordingRenderBackend.h"
+#include "Renderer/ResourceRegistry.h"
 #include "Renderer/Renderable.h"
+#include "Renderer/SoftwareRenderer.h"
+#include "Renderer/StartupGraph.h"
+#include "Renderer/StaticBatcher.h"
+#include "Renderer/TracingRenderBackend.h"
 #include "Scene/Scene.h"
 #include "Shader/PixelShader.h"
 #include "Shader/VertexShader.h"
@@ -34,14 +55,95 @@ namespace library
 
       Methods:  Initialize
                   Creates Direct3D device and swap chain
+                InitializeHeadless
+                  Creates a software device and renders through the
+                  given backend, without a window
                 AddRenderable
                   Add a renderable object and initialize the object
+                RemoveRenderable
+                  Remove a renderable object
+                AddModelCrowd
+                  Add a crowd of instances of a skinned model
+                AddEntityMesh
+                  Adds a renderable drawing entities
+                AddEntity
+                  Adds an entity to the entity store
+                RemoveEntity
+                  Removes an entity from the entity store
+                AddOccluder
+                  Marks a renderable as an occluder
                 Update
                   Update the renderables each frame
+                StorePreviousState
+                  Keeps the transforms before a simulation step
+                SetInterpolationAlpha
+                  Sets how far the drawn transforms are between the
+                  last two simulation steps
                 Render
                   Renders the frame
+                ExecuteFrame
+                  Runs the stages of a frame in the frame pipeline,
+                  handing the frame to the render thread
+                WaitForSubmission
+                  Waits until the render thread submitted the last
+                  frame built
+                RenderSoftware
+                  Renders the frame on the CPU into a software
+                  renderer
+                SetNumRecordingThreads
+                  Sets the maximum number of threads recording the
+                  draw list
+                AddPipelineState
+                  Add a pipeline state, initialized with the shaders
+                SetInstancedPipelineState
+                  Sets the pipeline state drawing the renderables of a
+                  pipeline state in instanced draws
+                SetPipelineStateOfEntityMesh
+                  Sets the pipeline state of an entity mesh
+                GetEntities
+                  Returns the entity store
                 GetDriverType
                   Returns the Direct3D driver type
+                GetOcclusionCuller
+                  Returns the occlusion culler
+                GetBackend
+                  Returns the render backend
+                GetFrameGraph
+                  Returns the compiled frame graph
+                GetLightCuller
+                  Returns the clustered light culler
+                GetSkinningUploadBytes
+                  Returns the bytes of bone transforms uploaded in the
+                  last frame
+                SetPipelineStateOfDebugDraw
+                  Sets the pipeline state of the debug drawing
+                GetDebugDraw
+                  Returns the debug drawing
+                BeginTrace
+                  Traces the commands of the next frames into a file
+                GetJobSystem
+                  Returns the job system running the update and
+                  loading work
+                GetAssetLoader
+                  Returns the loader of the assets, whose device work
+                  runs before each submission
+                GetFramePipeline
+                  Returns the frame pipeline, its stages and timings
+                GetFrameArena
+                  Returns the arena of the transient allocations of
+                  the frames
+                SetHeapAllocationCheck
+                  Checks that the frames no longer allocate from the
+                  heap once warmed up, in debug builds
+                GetStartupGraph
+                  Returns the tasks of the initialization and their
+                  times
+                GetTimeToFirstFrame
+                  Returns the seconds from the launch of the process
+                  to the first frame presented
+                WriteStartupReport
+                  Prints the startup timeline and the time to first
+                  frame
                 Renderer
                   Constructor.
                 ~Renderer
@@ -49,40 +151,158 @@ namespace library
     C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
     class Renderer final
     {
+    public:
+        typedef ResourceHandle<Renderable> RenderableHandle;
+        typedef ResourceHandle<Model> ModelHandle;
+        typedef ResourceHandle<ModelCrowd> ModelCrowdHandle;
+        typedef ResourceHandle<PointLight> PointLightHandle;
+        typedef ResourceHandle<VertexShader> VertexShaderHandle;
+        typedef ResourceHandle<PixelShader> PixelShaderHandle;
+        typedef ResourceHandle<PipelineState> PipelineStateHandle;
+        typedef ResourceHandle<Scene> SceneHandle;
+        typedef ResourceHandle<Renderable> EntityMeshHandle;
+
+        static constexpr size_t MIN_DRAWS_PER_COMMAND_BUFFER = 32u;
+        static constexpr FLOAT CLEAR_COLOR[4] = { 0.0f, 0.125f, 0.6f, 1.0f };
+        static constexpr UINT64 HEAP_ALLOCATION_CHECK_WARM_UP_FRAMES = 120u;
+        static constexpr FLOAT MAX_ASSET_CREATION_SECONDS_PER_FRAME = 0.002f;
+
     public:
         Renderer();
         Renderer(const Renderer& other) = delete;
         Renderer(Renderer&& other) = delete;
         Renderer& operator=(const Renderer& other) = delete;
         Renderer& operator=(Renderer&& other) = delete;
-        ~Renderer() = default;
+        ~Renderer();
 
         HRESULT Initialize(_In_ HWND hWnd);
-        HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable);
-        HRESULT AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel);
-        HRESULT AddPointLight(_In_ size_t index, _In_ const std::shared_ptr<PointLight>& pPointLight);
-        HRESULT AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader);
-        HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader);
+        HRESULT InitializeHeadless(_In_ UINT uWidth, _In_ UINT uHeight, _In_ const std::shared_ptr<RenderBackend>& backend);
+        HRESULT AddRenderable(_In_ PCWSTR pszRenderableName, _In_ const std::shared_ptr<Renderable>& renderable, _Out_opt_ RenderableHandle* pHandle = nullptr);
+        HRESULT RemoveRenderable(_In_ RenderableHandle handle);
+        HRESULT AddModel(_In_ PCWSTR pszModelName, _In_ const std::shared_ptr<Model>& pModel, _Out_opt_ ModelHandle* pHandle = nullptr);
+        HRESULT AddModelCrowd(_In_ PCWSTR pszModelCrowdName, _In_ const std::shared_ptr<ModelCrowd>& modelCrowd, _Out_opt_ ModelCrowdHandle* pHandle = nullptr);
+        HRESULT AddEntityMesh(_In_ PCWSTR pszEntityMeshName, _In_ const std::shared_ptr<Renderable>& mesh, _Out_opt_ EntityMeshHandle* pHandle = nullptr);
+        HRESULT AddEntity(_In_ const EntityDesc& desc, _Out_opt_ EntityHandle* pHandle = nullptr);
+        HRESULT RemoveEntity(_In_ EntityHandle handle);
+        HRESULT AddPointLight(_In_ PCWSTR pszPointLightName, _In_ const std::shared_ptr<PointLight>& pPointLight, _Out_opt_ PointLightHandle* pHandle = nullptr);
+        HRESULT AddVertexShader(_In_ PCWSTR pszVertexShaderName, _In_ const std::shared_ptr<VertexShader>& vertexShader, _Out_opt_ VertexShaderHandle* pHandle = nullptr);
+        HRESULT AddPixelShader(_In_ PCWSTR pszPixelShaderName, _In_ const std::shared_ptr<PixelShader>& pixelShader, _Out_opt_ PixelShaderHandle* pHandle = nullptr);
+        HRESULT AddPipelineState(_In_ PCWSTR pszPipelineStateName, _In_ const std::shared_ptr<PipelineState>& pipelineState, _Out_opt_ PipelineStateHandle* pHandle = nullptr);
+        HRESULT AddOccluder(_In_ PCWSTR pszRenderableName);
 
-        HRESULT AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFileDirectory);
+        HRESULT AddScene(_In_ PCWSTR pszSceneName, const std::filesystem::path& sceneFileDirectory, _Out_opt_ SceneHandle* pHandle = nullptr);
         HRESULT SetMainScene(_In_ PCWSTR pszSceneName);
 
         void HandleInput(_In_ const DirectionsInput& directions, _In_ const MouseRelativeMovement& mouseRelativeMovement, _In_ FLOAT deltaTime);
         void Update(_In_ FLOAT deltaTime);
+        void StorePreviousState();
+        void SetInterpolationAlpha(_In_ FLOAT alpha);
         void Render();
+        void ExecuteFrame();
+        void WaitForSubmission();
+        HRESULT RenderSoftware(_In_ SoftwareRenderer& softwareRenderer);
+        void SetNumRecordingThreads(_In_ UINT uNumThreads);
 
-        HRESULT SetVertexShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszVertexShaderName);
-        HRESULT SetPixelShaderOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPixelShaderName);
-        HRESULT SetVertexShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszVertexShaderName);
-        HRESULT SetPixelShaderOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPixelShaderName);
-        HRESULT SetVertexShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszVertexShaderName);
-        HRESULT SetPixelShaderOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPixelShaderName);
+        HRESULT SetPipelineStateOfRenderable(_In_ PCWSTR pszRenderableName, _In_ PCWSTR pszPipelineStateName);
+        HRESULT SetPipelineStateOfModel(_In_ PCWSTR pszModelName, _In_ PCWSTR pszPipelineStateName);
+        HRESULT SetPipelineStateOfModelCrowd(_In_ PCWSTR pszModelCrowdName, _In_ PCWSTR pszPipelineStateName);
+        HRESULT SetPipelineStateOfScene(_In_ PCWSTR pszSceneName, _In_ PCWSTR pszPipelineStateName);
+        HRESULT SetInstancedPipelineState(_In_ PCWSTR pszPipelineStateName, _In_ PCWSTR pszInstancedPipelineStateName);
+        HRESULT SetPipelineStateOfEntityMesh(_In_ PCWSTR pszEntityMeshName, _In_ PCWSTR pszPipelineStateName);
+        EntityStore& GetEntities();
 
         D3D_DRIVER_TYPE GetDriverType() const;
+        OcclusionCuller& GetOcclusionCuller();
+        std::shared_ptr<RenderBackend>& GetBackend();
+        const FrameGraph& GetFrameGraph() const;
+        const ClusteredLightCuller& GetLightCuller() const;
+        UINT GetSkinningUploadBytes() const;
+        HRESULT SetPipelineStateOfDebugDraw(_In_ PCWSTR pszPipelineStateName);
+        DebugDraw& GetDebugDraw();
+        HRESULT BeginTrace(_In_ const std::filesystem::path& filePath, _In_ UINT uNumFrames);
+        JobSystem& GetJobSystem();
+        AssetLoader& GetAssetLoader();
+        FramePipeline& GetFramePipeline();
+        const FrameArena& GetFrameArena() const;
+        void SetHeapAllocationCheck(_In_ BOOL bEnabled);
+        const StartupGraph& GetStartupGraph() const;
+        FLOAT GetTimeToFirstFrame() const;
+        void WriteStartupReport(_In_ std::FILE* pFile) const;
 
         std::shared_ptr<MainWindow> WindowPtr;
 
 
+    private:
+        struct InstancedPipelineState
+        {
+            std::shared_ptr<PipelineState> pipelineState;
+            std::shared_ptr<PipelineState> instancedPipelineState;
+        };
+
+        struct RenderableBatch
+        {
+            Renderable* pRenderable;
+            const InstancedPipelineState* pInstancedPipelineState;
+            UINT uStartInstance;
+            UINT uNumInstances;
+        };
+
+        struct RenderableBatchKey
+        {
+            const InstancedPipelineState* pInstancedPipelineState;
+            const SimpleVertex* pVertices;
+            const WORD* pIndices;
+            const Texture* pDiffuse;
+            UINT uNumIndices;
+            UINT uBaseIndex;
+            UINT uBaseVertex;
+            Renderable* pRenderable;
+        };
+
+        struct FrameSnapshot
+        {
+            CommandBuffer Commands;
+            UINT64 uFrame;
+        };
+
+        struct RetiredObject
+        {
+            ComPtr<ID3D11DeviceChild> Object;
+            UINT64 uFrame;
+        };
+
+    private:
+        HRESULT initializeResources(_In_ UINT uWidth, _In_ UINT uHeight);
+        HRESULT declareFrameGraph(_In_ UINT uWidth, _In_ UINT uHeight);
+        HRESULT declareStartupGraph();
+        static FLOAT getSecondsSinceProcessStart();
+        void cullScene();
+        void buildFrame();
+        void submitFrame();
+        void endTracedFrame();
+        void interpolateCamera();
+        void retireObject(_In_ const ComPtr<ID3D11DeviceChild>& object);
+        void releaseRetiredObjects();
+        void renderScene(_In_ RenderBackend& backend);
+        void resetFrameAllocations();
+        void cull(_In_ const std::vector<SceneChunk>& chunks);
+        void batchRenderables(_In_ RenderBackend& backend);
+        void batchEntities();
+        const InstancedPipelineState* findInstancedPipelineState(_In_ Renderable& renderable) const;
+        void recordFrameState(_In_ RenderBackend& backend);
+        void recordDraws(
+            _In_ RenderBackend& backend,
+            _In_ std::vector<std::shared_ptr<Voxel>>& voxels,
+            _In_ const std::vector<SceneChunk>& chunks,
+            _In_ size_t uBegin,
+            _In_ size_t uEnd
+        );
+        void recordRenderable(_In_ RenderBackend& backend, _In_ Renderable& renderable);
+        void recordRenderableBatch(_In_ RenderBackend& backend, _In_ const RenderableBatch& batch);
+        void recordVoxel(_In_ RenderBackend& backend, _In_ Voxel& vox, _In_ size_t voxelIdx, _In_ const std::vector<SceneChunk>& chunks);
+        void recordModel(_In_ RenderBackend& backend, _In_ Model& model);
+        void recordModelCrowd(_In_ RenderBackend& backend, _In_ ModelCrowd& modelCrowd);
+
     private:
         D3D_DRIVER_TYPE m_driverType;
         D3D_FEATURE_LEVEL m_featureLevel;
@@ -97,17 +317,59 @@ namespace library
         ComPtr<ID3D11DepthStencilView> m_depthStencilView;
         ComPtr<ID3D11Buffer> m_cbChangeOnResize;
         ComPtr<ID3D11Buffer> m_cbLights;
-        PCWSTR m_pszMainSceneName;
+        SceneHandle m_mainScene;
         BYTE m_padding[8];
         Camera m_camera;
         XMMATRIX m_projection;
+        XMMATRIX m_interpolatedView;
+        XMVECTOR m_interpolatedEye;
 
-        std::unordered_map<PCWSTR, std::shared_ptr<Renderable>> m_renderables;
-        std::unordered_map<PCWSTR, std::shared_ptr<Model>> m_models;
-        std::shared_ptr<PointLight> m_aPointLights[NUM_LIGHTS];
-        std::unordered_map<PCWSTR, std::shared_ptr<VertexShader>> m_vertexShaders;
-        std::unordered_map<PCWSTR, std::shared_ptr<PixelShader>> m_pixelShaders;
-        std::unordered_map<std::wstring, std::shared_ptr<Scene>> m_scenes;
+        ResourceRegistry<Renderable> m_renderables;
+        ResourceRegistry<Model> m_models;
+        ResourceRegistry<ModelCrowd> m_modelCrowds;
+        ResourceRegistry<PointLight> m_pointLights;
+        ResourceRegistry<VertexShader> m_vertexShaders;
+        ResourceRegistry<PixelShader> m_pixelShaders;
+        ResourceRegistry<PipelineState> m_pipelineStates;
+        ResourceRegistry<Scene> m_scenes;
+        ResourceRegistry<Renderable> m_entityMeshes;
+        EntityStore m_entities;
+        std::vector<std::shared_ptr<Renderable>> m_occluders;
+        OcclusionCuller m_occlusionCuller;
+        std::shared_ptr<RenderBackend> m_backend;
+        std::vector<std::unique_ptr<CommandBuffer>> m_aCommandBuffers;
+        std::vector<CommandBuffer*> m_apCommandBuffers;
+        FrameArena m_frameArena;
+        FrameVector<Renderable*> m_apVisibleRenderables;
+        std::vector<InstancedPipelineState> m_aInstancedPipelineStates;
+        FrameVector<RenderableBatchKey> m_aRenderableBatchKeys;
+        FrameVector<RenderableBatch> m_aRenderableBatches;
+        FrameVector<RenderableInstanceData> m_aRenderableInstances;
+        ComPtr<ID3D11Buffer> m_renderableInstanceBuffer;
+        UINT m_uRenderableInstanceCapacity;
+        FrameVector<Model*> m_apVisibleModels;
+        FrameVector<UINT> m_auVisibleEntities;
+        std::vector<BOOL> m_aChunkVisibilities;
+        FrameGraph m_frameGraph;
+        ClusteredLightCuller m_lightCuller;
+        UINT m_uSkinningUploadBytes;
+        StaticBatcher m_staticBatcher;
+        DebugDraw m_debugDraw;
+        std::shared_ptr<TracingRenderBackend> m_tracingBackend;
+        JobSystem m_jobSystem;
+        AssetLoader m_assetLoader;
+        TripleBuffer<FrameSnapshot> m_frameSnapshots;
+        std::vector<RetiredObject> m_aRetiredObjects;
+        UINT64 m_uNumBuiltFrames;
+        std::atomic<UINT64> m_uLastAcquiredFrame;
+        std::atomic<UINT64> m_uLastSubmittedFrame;
+        FLOAT m_interpolationAlpha;
+        HeapAllocationCheck m_heapAllocationCheck;
+        BOOL m_bHeapAllocationCheck;
+        FramePipeline m_framePipeline;
+        StartupGraph m_startupGraph;
+        FLOAT m_startupGraphBeginSeconds;
+        std::atomic<FLOAT> m_timeToFirstFrame;
     };
 
 }
\ No newline at end of file
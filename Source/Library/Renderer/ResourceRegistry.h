@@ -0,0 +1,279 @@
+/*+===================================================================
+  File:      RESOURCEREGISTRY.H
+
+  Summary:   ResourceRegistry header file contains declarations of the
+             generational handles and the dense registry the renderer
+             stores its renderables, models, shaders, scenes and lights
+             in.
+
+  Classes: ResourceHandle, ResourceRegistry
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+namespace library
+{
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ResourceHandle
+
+      Summary:  Generational handle to an entry of a ResourceRegistry.
+                The type parameter keeps handles of different registries
+                from being mixed up
+
+      Members:  UINT uIndex
+                  Slot of the entry in the registry
+                UINT uGeneration
+                  Generation of the slot when the entry was added. A
+                  handle to a removed entry no longer matches it
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    template <class T>
+    struct ResourceHandle
+    {
+        static constexpr UINT INVALID_INDEX = 0xFFFFFFFF;
+
+        UINT uIndex = INVALID_INDEX;
+        UINT uGeneration = 0u;
+
+        BOOL IsNull() const { return uIndex == INVALID_INDEX; }
+        bool operator==(const ResourceHandle& other) const = default;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ResourceRegistry
+
+      Summary:  Stores shared resources in a dense array addressed by
+                generational handles. Names are compared by value and
+                only looked up when a resource is added or found, so
+                the per frame code iterates the dense array or resolves
+                handles with two array accesses. Every resource keeps
+                its name next to it, so removing one and naming one
+                never search the names. Removing an entry moves the
+                last one into its place and bumps the generation of its
+                slot, so stale handles resolve to nullptr
+
+      Methods:  Add
+                  Adds a named resource
+                Remove
+                  Removes the resource of a handle
+                Find
+                  Returns the handle of a named resource
+                Get
+                  Returns the resource of a handle
+                IsValid
+                  Returns whether a handle refers to a resource
+                GetSize
+                  Returns the number of resources
+                GetResources
+                  Returns the dense array of resources
+                GetName
+                  Returns the name of a resource of the dense array
+                begin
+                  Returns the first resource of the dense array
+                end
+                  Returns the end of the dense array
+                ResourceRegistry
+                  Constructor.
+                ~ResourceRegistry
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    template <class T>
+    class ResourceRegistry final
+    {
+    public:
+        typedef ResourceHandle<T> Handle;
+        typedef typename std::vector<std::shared_ptr<T>>::const_iterator ConstIterator;
+
+    public:
+        ResourceRegistry() = default;
+        ResourceRegistry(const ResourceRegistry& other) = delete;
+        ResourceRegistry(ResourceRegistry&& other) = delete;
+        ResourceRegistry& operator=(const ResourceRegistry& other) = delete;
+        ResourceRegistry& operator=(ResourceRegistry&& other) = delete;
+        ~ResourceRegistry() = default;
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceRegistry::Add
+
+          Summary:  Adds a resource under a name not used yet
+
+          Args:     PCWSTR pszName
+                      Name of the resource, copied by the registry
+                    const std::shared_ptr<T>& resource
+                      Resource to add
+                    Handle* pHandle
+                      Optional handle of the added resource
+
+          Modifies: [m_aResources, m_aResourceNames, m_auResourceSlots,
+                     m_aSlots, m_auFreeSlots, m_names].
+
+          Returns:  HRESULT
+                      Status code, E_FAIL if the name is already used
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        HRESULT Add(_In_ PCWSTR pszName, _In_ const std::shared_ptr<T>& resource, _Out_opt_ Handle* pHandle = nullptr)
+        {
+            if (!pszName || !resource)
+            {
+                return E_INVALIDARG;
+            }
+
+            if (m_names.contains(pszName))
+            {
+                return E_FAIL;
+            }
+
+            UINT uSlot;
+            if (m_auFreeSlots.empty())
+            {
+                uSlot = static_cast<UINT>(m_aSlots.size());
+                m_aSlots.push_back(Slot{ .uGeneration = 0u, .uDenseIndex = 0u });
+            }
+            else
+            {
+                uSlot = m_auFreeSlots.back();
+                m_auFreeSlots.pop_back();
+            }
+
+            m_aSlots[uSlot].uDenseIndex = static_cast<UINT>(m_aResources.size());
+            m_aResources.push_back(resource);
+            m_aResourceNames.push_back(pszName);
+            m_auResourceSlots.push_back(uSlot);
+
+            const Handle handle = { .uIndex = uSlot, .uGeneration = m_aSlots[uSlot].uGeneration };
+            m_names.insert({ pszName, handle });
+
+            if (pHandle)
+            {
+                *pHandle = handle;
+            }
+
+            return S_OK;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceRegistry::Remove
+
+          Summary:  Removes the resource of a handle and its name. The
+                    last resource of the dense array takes its place
+
+          Args:     Handle handle
+                      Handle of the resource
+
+          Modifies: [m_aResources, m_aResourceNames, m_auResourceSlots,
+                     m_aSlots, m_auFreeSlots, m_names].
+
+          Returns:  HRESULT
+                      Status code, E_INVALIDARG for a stale handle
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        HRESULT Remove(_In_ Handle handle)
+        {
+            if (!IsValid(handle))
+            {
+                return E_INVALIDARG;
+            }
+
+            const UINT uDenseIndex = m_aSlots[handle.uIndex].uDenseIndex;
+            const UINT uLastSlot = m_auResourceSlots.back();
+
+            m_names.erase(m_aResourceNames[uDenseIndex]);
+
+            m_aResources[uDenseIndex] = std::move(m_aResources.back());
+            m_aResourceNames[uDenseIndex] = std::move(m_aResourceNames.back());
+            m_auResourceSlots[uDenseIndex] = uLastSlot;
+            m_aSlots[uLastSlot].uDenseIndex = uDenseIndex;
+            m_aResources.pop_back();
+            m_aResourceNames.pop_back();
+            m_auResourceSlots.pop_back();
+
+            ++m_aSlots[handle.uIndex].uGeneration;
+            m_auFreeSlots.push_back(handle.uIndex);
+
+            return S_OK;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceRegistry::Find
+
+          Summary:  Returns the handle of a named resource. Meant for
+                    registration time, not for the per frame code
+
+          Args:     PCWSTR pszName
+                      Name of the resource
+
+          Returns:  Handle
+                      Handle of the resource, null if there is none
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        Handle Find(_In_ PCWSTR pszName) const
+        {
+            if (!pszName)
+            {
+                return Handle();
+            }
+
+            const auto it = m_names.find(pszName);
+            return it != m_names.end() ? it->second : Handle();
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceRegistry::Get
+
+          Summary:  Returns the resource of a handle
+
+          Args:     Handle handle
+                      Handle of the resource
+
+          Returns:  const std::shared_ptr<T>&
+                      The resource, nullptr for a stale or null handle
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        const std::shared_ptr<T>& Get(_In_ Handle handle) const
+        {
+            static const std::shared_ptr<T> s_null;
+
+            return IsValid(handle) ? m_aResources[m_aSlots[handle.uIndex].uDenseIndex] : s_null;
+        }
+
+        BOOL IsValid(_In_ Handle handle) const
+        {
+            return handle.uIndex < m_aSlots.size() && m_aSlots[handle.uIndex].uGeneration == handle.uGeneration;
+        }
+
+        size_t GetSize() const { return m_aResources.size(); }
+        const std::vector<std::shared_ptr<T>>& GetResources() const { return m_aResources; }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ResourceRegistry::GetName
+
+          Summary:  Returns the name of a resource of the dense array
+
+          Args:     size_t uDenseIndex
+                      Index of the resource in the dense array
+
+          Returns:  std::wstring
+                      Name of the resource, empty if there is none
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        std::wstring GetName(_In_ size_t uDenseIndex) const
+        {
+            return uDenseIndex < m_aResourceNames.size() ? m_aResourceNames[uDenseIndex] : std::wstring();
+        }
+
+        ConstIterator begin() const { return m_aResources.begin(); }
+        ConstIterator end() const { return m_aResources.end(); }
+
+    private:
+        struct Slot
+        {
+            UINT uGeneration;
+            UINT uDenseIndex;
+        };
+
+    private:
+        std::vector<std::shared_ptr<T>> m_aResources;
+        std::vector<std::wstring> m_aResourceNames;
+        std::vector<UINT> m_auResourceSlots;
+        std::vector<Slot> m_aSlots;
+        std::vector<UINT> m_auFreeSlots;
+        std::unordered_map<std::wstring, Handle> m_names;
+    };
+}
@@ -0,0 +1,1557 @@
+#include "Renderer/SoftwareRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <thread>
+
+#include "Model/Model.h"
+#include "Renderer/ClusteredLightCuller.h"
+#include "Renderer/InstancedRenderable.h"
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::SoftwareRenderer
+
+      Summary:  Constructor. Allocates the tiles, the binning jobs and
+                the image
+
+      Args:     UINT uWidth
+                  Width of the image
+                UINT uHeight
+                  Height of the image
+
+      Modifies: [m_uWidth, m_uHeight, m_uNumTilesX, m_uNumTilesY,
+                 m_wicFactory, m_viewProjection, m_cameraPosition,
+                 m_aLights, m_uClearColor, m_aDraws, m_uNumTriangles,
+                 m_textures, m_aJobs, m_aTiles, m_aDepths, m_aRefs,
+                 m_aPixels, m_frameStartTime, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    SoftwareRenderer::SoftwareRenderer(_In_ UINT uWidth, _In_ UINT uHeight)
+        : m_uWidth(uWidth)
+        , m_uHeight(uHeight)
+        , m_uNumTilesX((uWidth + TILE_SIZE - 1u) / TILE_SIZE)
+        , m_uNumTilesY((uHeight + TILE_SIZE - 1u) / TILE_SIZE)
+        , m_wicFactory()
+        , m_viewProjection(XMMatrixIdentity())
+        , m_cameraPosition()
+        , m_aLights()
+        , m_uClearColor(0u)
+        , m_aDraws()
+        , m_uNumTriangles(0u)
+        , m_textures()
+        , m_aJobs(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)) * NUM_JOBS_PER_THREAD)
+        , m_aTiles()
+        , m_aDepths()
+        , m_aRefs()
+        , m_aPixels(static_cast<size_t>(uWidth) * static_cast<size_t>(uHeight), 0u)
+        , m_frameStartTime()
+        , m_stats()
+    {
+        const size_t uNumTiles = static_cast<size_t>(m_uNumTilesX) * static_cast<size_t>(m_uNumTilesY);
+
+        m_aTiles.reserve(uNumTiles);
+        for (UINT uTileY = 0u; uTileY < m_uNumTilesY; ++uTileY)
+        {
+            for (UINT uTileX = 0u; uTileX < m_uNumTilesX; ++uTileX)
+            {
+                m_aTiles.push_back(
+                    Tile
+                    {
+                        .uMinX = uTileX * TILE_SIZE,
+                        .uMinY = uTileY * TILE_SIZE,
+                        .uMaxX = std::min((uTileX + 1u) * TILE_SIZE, uWidth),
+                        .uMaxY = std::min((uTileY + 1u) * TILE_SIZE, uHeight),
+                    }
+                );
+            }
+        }
+
+        // Depths and visibility are stored tile by tile, every tile padded to TILE_SIZE x TILE_SIZE
+        m_aDepths.resize(uNumTiles * TILE_SIZE * TILE_SIZE);
+        m_aRefs.resize(uNumTiles * TILE_SIZE * TILE_SIZE);
+
+        for (BinningJob& job : m_aJobs)
+        {
+            job.aaBins.resize(uNumTiles);
+            job.uNumRasterizedTriangles = 0u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::Initialize
+
+      Summary:  Creates the imaging factory used to decode the textures
+                and to encode the image. COM must be initialized on the
+                calling thread
+
+      Modifies: [m_wicFactory].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::Initialize()
+    {
+        if (m_uWidth == 0u || m_uHeight == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        return CoCreateInstance(
+            CLSID_WICImagingFactory,
+            nullptr,
+            CLSCTX_INPROC_SERVER,
+            IID_PPV_ARGS(m_wicFactory.GetAddressOf())
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::BeginFrame
+
+      Summary:  Starts a frame. The draws of the previous frame are
+                discarded and the depth and visibility buffers cleared
+
+      Args:     const FLOAT aClearColor[4]
+                  Color of the pixels not covered by any draw
+                const XMMATRIX& view
+                  View transform of the camera
+                const XMMATRIX& projection
+                  Projection transform of the camera
+                const XMFLOAT4& cameraPosition
+                  Position of the camera in world space
+                const PointLightData* pLights
+                  Point lights of the frame
+                UINT uNumLights
+                  Number of point lights
+
+      Modifies: [m_viewProjection, m_cameraPosition, m_aLights,
+                 m_uClearColor, m_aDraws, m_uNumTriangles, m_aDepths,
+                 m_aRefs, m_frameStartTime].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::BeginFrame(
+        _In_ const FLOAT aClearColor[4],
+        _In_ const XMMATRIX& view,
+        _In_ const XMMATRIX& projection,
+        _In_ const XMFLOAT4& cameraPosition,
+        _In_reads_(uNumLights) const PointLightData* pLights,
+        _In_ UINT uNumLights
+    )
+    {
+        QueryPerformanceCounter(&m_frameStartTime);
+
+        m_viewProjection = view * projection;
+        m_cameraPosition = cameraPosition;
+        m_aLights.assign(pLights, pLights + uNumLights);
+        m_uClearColor = packColor(XMVectorSet(aClearColor[0], aClearColor[1], aClearColor[2], aClearColor[3]));
+
+        m_aDraws.clear();
+        m_uNumTriangles = 0u;
+
+        std::fill(m_aDepths.begin(), m_aDepths.end(), 1.0f);
+        std::fill(m_aRefs.begin(), m_aRefs.end(), TriangleRef{ .uDraw = INVALID_DRAW, .uGroup = 0u, .uTriangle = 0u });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::DrawRenderable
+
+      Summary:  Draws every mesh of a renderable, textured meshes with
+                the Phong shaders and the others with their output
+                color. The renderable must outlive the frame
+
+      Args:     const Renderable& renderable
+                  Renderable to draw
+
+      Modifies: [m_aDraws, m_uNumTriangles, m_textures].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::DrawRenderable(_In_ const Renderable& renderable)
+    {
+        HRESULT hr = S_OK;
+
+        const UINT uNumMeshes = renderable.GetNumMeshes();
+        for (UINT i = 0u; i < uNumMeshes; ++i)
+        {
+            const auto& mesh = renderable.GetMesh(i);
+            const UINT uEndVertex = i + 1u < uNumMeshes ? renderable.GetMesh(i + 1u).uBaseVertex : renderable.GetNumVertices();
+
+            SoftwareDraw draw =
+            {
+                .World = renderable.GetWorldMatrix(),
+                .OutputColor = renderable.GetOutputColor(),
+                .Shading = renderable.HasTexture() ? eSoftwareShading::PHONG : eSoftwareShading::COLOR,
+                .pVertices = renderable.GetVertices() + mesh.uBaseVertex,
+                .pIndices = renderable.GetIndices() + mesh.uBaseIndex,
+                .uNumVertices = uEndVertex - mesh.uBaseVertex,
+                .uNumIndices = mesh.uNumIndices,
+                .uNumGroups = 1u,
+            };
+
+            if (renderable.HasTexture() && renderable.GetMaterial(mesh.uMaterialIndex).pDiffuse)
+            {
+                hr = getTexture(*renderable.GetMaterial(mesh.uMaterialIndex).pDiffuse, draw.pTexture);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+
+            addDraw(draw);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::DrawVoxels
+
+      Summary:  Draws a range of the instances of a voxel with the voxel
+                shaders. The voxel must outlive the frame
+
+      Args:     const InstancedRenderable& voxel
+                  Voxel to draw
+                UINT uStartInstance
+                  Index of the first instance
+                UINT uNumInstances
+                  Number of instances
+
+      Modifies: [m_aDraws, m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::DrawVoxels(_In_ const InstancedRenderable& voxel, _In_ UINT uStartInstance, _In_ UINT uNumInstances)
+    {
+        assert(uStartInstance + uNumInstances <= voxel.GetNumInstances());
+
+        SoftwareDraw draw =
+        {
+            .World = voxel.GetWorldMatrix(),
+            .OutputColor = voxel.GetOutputColor(),
+            .Shading = eSoftwareShading::VOXEL,
+            .pVertices = voxel.GetVertices(),
+            .pIndices = voxel.GetIndices(),
+            .pInstances = voxel.GetInstanceData().data() + uStartInstance,
+            .uNumVertices = voxel.GetNumVertices(),
+            .uNumIndices = voxel.GetNumIndices(),
+            .uNumGroups = uNumInstances,
+        };
+
+        addDraw(draw);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::DrawModel
+
+      Summary:  Draws every mesh of a model with the skinning shaders, in
+                the pose of its current bone transforms. The model must
+                outlive the frame and not be updated before EndFrame
+
+      Args:     Model& model
+                  Model to draw
+
+      Modifies: [m_aDraws, m_uNumTriangles, m_textures].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::DrawModel(_In_ Model& model)
+    {
+        HRESULT hr = S_OK;
+
+        const std::vector<XMMATRIX>& aBoneTransforms = model.GetBoneTransforms();
+
+        const UINT uNumMeshes = model.GetNumMeshes();
+        for (UINT i = 0u; i < uNumMeshes; ++i)
+        {
+            const auto& mesh = model.GetMesh(i);
+            const UINT uEndVertex = i + 1u < uNumMeshes ? model.GetMesh(i + 1u).uBaseVertex : model.GetNumVertices();
+
+            SoftwareDraw draw =
+            {
+                .World = model.GetWorldMatrix(),
+                .OutputColor = model.GetOutputColor(),
+                .Shading = eSoftwareShading::SKINNED_PHONG,
+                .pVertices = model.GetVertices() + mesh.uBaseVertex,
+                .pIndices = model.GetIndices() + mesh.uBaseIndex,
+                .pAnimationData = model.GetAnimationData().data() + mesh.uBaseVertex,
+                .pBoneTransforms = aBoneTransforms.data(),
+                .uNumBones = static_cast<UINT>(aBoneTransforms.size()),
+                .uNumVertices = uEndVertex - mesh.uBaseVertex,
+                .uNumIndices = mesh.uNumIndices,
+                .uNumGroups = 1u,
+            };
+
+            if (model.HasTexture() && model.GetMaterial(mesh.uMaterialIndex).pDiffuse)
+            {
+                hr = getTexture(*model.GetMaterial(mesh.uMaterialIndex).pDiffuse, draw.pTexture);
+                if (FAILED(hr))
+                {
+                    return hr;
+                }
+            }
+
+            addDraw(draw);
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::EndFrame
+
+      Summary:  Renders the draws of the frame. Triangles are processed
+                in passes of at most MAX_TRIANGLES_PER_PASS, so the bins
+                stay small however large the scene is. Each pass sets
+                up and bins its triangles with one job per contiguous
+                range, then rasterizes every tile. The visible pixels
+                are shaded once all passes are done
+
+      Modifies: [m_aJobs, m_aDepths, m_aRefs, m_aPixels, m_stats].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::EndFrame()
+    {
+        const UINT64 uNumJobs = static_cast<UINT64>(m_aJobs.size());
+
+        for (UINT64 uPassStart = 0u; uPassStart < m_uNumTriangles; uPassStart += MAX_TRIANGLES_PER_PASS)
+        {
+            const UINT64 uPassSize = std::min(MAX_TRIANGLES_PER_PASS, m_uNumTriangles - uPassStart);
+
+            std::for_each(
+                std::execution::par,
+                m_aJobs.begin(),
+                m_aJobs.end(),
+                [&](BinningJob& job)
+                {
+                    const UINT64 uIndex = static_cast<UINT64>(&job - m_aJobs.data());
+
+                    setupTriangles(
+                        job,
+                        uPassStart + uIndex * uPassSize / uNumJobs,
+                        uPassStart + (uIndex + 1u) * uPassSize / uNumJobs
+                    );
+                }
+            );
+
+            std::for_each(
+                std::execution::par,
+                m_aTiles.begin(),
+                m_aTiles.end(),
+                [&](const Tile& tile)
+                {
+                    rasterizeTile(static_cast<size_t>(&tile - m_aTiles.data()));
+                }
+            );
+
+            for (const BinningJob& job : m_aJobs)
+            {
+                m_stats.uNumRasterizedTriangles += job.uNumRasterizedTriangles;
+            }
+        }
+
+        std::for_each(
+            std::execution::par,
+            m_aTiles.begin(),
+            m_aTiles.end(),
+            [&](const Tile& tile)
+            {
+                shadeTile(static_cast<size_t>(&tile - m_aTiles.data()));
+            }
+        );
+
+        LARGE_INTEGER frameEndTime;
+        LARGE_INTEGER frequency;
+        QueryPerformanceCounter(&frameEndTime);
+        QueryPerformanceFrequency(&frequency);
+
+        m_stats.frameSeconds = static_cast<FLOAT>(frameEndTime.QuadPart - m_frameStartTime.QuadPart) / static_cast<FLOAT>(frequency.QuadPart);
+        m_stats.totalSeconds += m_stats.frameSeconds;
+        m_stats.uNumTriangles += m_uNumTriangles;
+        ++m_stats.uNumFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::SaveToFile
+
+      Summary:  Writes the image of the last frame to a PNG file
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the file to write
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::SaveToFile(_In_ const std::filesystem::path& filePath) const
+    {
+        if (!m_wicFactory)
+        {
+            return E_ILLEGAL_METHOD_CALL;
+        }
+
+        HRESULT hr = S_OK;
+
+        ComPtr<IWICStream> stream;
+        hr = m_wicFactory->CreateStream(stream.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        hr = stream->InitializeFromFilename(filePath.c_str(), GENERIC_WRITE);
+        if (FAILED(hr)) return hr;
+
+        ComPtr<IWICBitmapEncoder> encoder;
+        hr = m_wicFactory->CreateEncoder(GUID_ContainerFormatPng, nullptr, encoder.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
+        if (FAILED(hr)) return hr;
+
+        ComPtr<IWICBitmapFrameEncode> frame;
+        hr = encoder->CreateNewFrame(frame.GetAddressOf(), nullptr);
+        if (FAILED(hr)) return hr;
+
+        hr = frame->Initialize(nullptr);
+        if (FAILED(hr)) return hr;
+
+        hr = frame->SetSize(m_uWidth, m_uHeight);
+        if (FAILED(hr)) return hr;
+
+        WICPixelFormatGUID format = GUID_WICPixelFormat32bppBGRA;
+        hr = frame->SetPixelFormat(&format);
+        if (FAILED(hr)) return hr;
+
+        if (!IsEqualGUID(format, GUID_WICPixelFormat32bppBGRA))
+        {
+            return WINCODEC_ERR_UNSUPPORTEDPIXELFORMAT;
+        }
+
+        hr = frame->WritePixels(
+            m_uHeight,
+            m_uWidth * sizeof(UINT),
+            static_cast<UINT>(m_aPixels.size() * sizeof(UINT)),
+            reinterpret_cast<BYTE*>(const_cast<UINT*>(m_aPixels.data()))
+        );
+        if (FAILED(hr)) return hr;
+
+        hr = frame->Commit();
+        if (FAILED(hr)) return hr;
+
+        return encoder->Commit();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::CompareToFile
+
+      Summary:  Compares the image of the last frame, channel by
+                channel, with a reference image, like a golden image
+                saved by an earlier run of SaveToFile
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the reference image
+                UINT uTolerance
+                  Largest difference of a channel still counted as
+                  equal, absorbing the rounding of other compilers
+                SoftwareImageDifference& outDifference
+                  Receives the difference between the images
+
+      Returns:  HRESULT
+                  Status code, WINCODEC_ERR_IMAGESIZEOUTOFRANGE when the
+                  sizes of the images differ
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::CompareToFile(_In_ const std::filesystem::path& filePath, _In_ UINT uTolerance, _Out_ SoftwareImageDifference& outDifference) const
+    {
+        outDifference = SoftwareImageDifference();
+
+        if (!m_wicFactory)
+        {
+            return E_ILLEGAL_METHOD_CALL;
+        }
+
+        HRESULT hr = S_OK;
+
+        ComPtr<IWICBitmapDecoder> decoder;
+        hr = m_wicFactory->CreateDecoderFromFilename(filePath.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        ComPtr<IWICBitmapFrameDecode> frame;
+        hr = decoder->GetFrame(0u, frame.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        // Decode to B8G8R8A8, the layout of the pixels
+        ComPtr<IWICFormatConverter> converter;
+        hr = m_wicFactory->CreateFormatConverter(converter.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut);
+        if (FAILED(hr)) return hr;
+
+        UINT uWidth = 0u;
+        UINT uHeight = 0u;
+        hr = converter->GetSize(&uWidth, &uHeight);
+        if (FAILED(hr)) return hr;
+
+        if (uWidth != m_uWidth || uHeight != m_uHeight)
+        {
+            return WINCODEC_ERR_IMAGESIZEOUTOFRANGE;
+        }
+
+        std::vector<UINT> aReferencePixels(m_aPixels.size());
+        hr = converter->CopyPixels(
+            nullptr,
+            uWidth * sizeof(UINT),
+            static_cast<UINT>(aReferencePixels.size() * sizeof(UINT)),
+            reinterpret_cast<BYTE*>(aReferencePixels.data())
+        );
+        if (FAILED(hr)) return hr;
+
+        outDifference.uNumPixels = m_aPixels.size();
+        for (size_t i = 0u; i < m_aPixels.size(); ++i)
+        {
+            UINT uMaxDifference = 0u;
+            for (UINT uShift = 0u; uShift < 32u; uShift += 8u)
+            {
+                const INT iChannel = static_cast<INT>((m_aPixels[i] >> uShift) & 0xFFu);
+                const INT iReferenceChannel = static_cast<INT>((aReferencePixels[i] >> uShift) & 0xFFu);
+                uMaxDifference = std::max(uMaxDifference, static_cast<UINT>(std::abs(iChannel - iReferenceChannel)));
+            }
+
+            outDifference.uMaxChannelDifference = std::max(outDifference.uMaxChannelDifference, uMaxDifference);
+            if (uMaxDifference > uTolerance)
+            {
+                ++outDifference.uNumDifferentPixels;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetWidth
+
+      Summary:  Returns the width of the image
+
+      Returns:  UINT
+                  Width in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SoftwareRenderer::GetWidth() const
+    {
+        return m_uWidth;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetHeight
+
+      Summary:  Returns the height of the image
+
+      Returns:  UINT
+                  Height in pixels
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SoftwareRenderer::GetHeight() const
+    {
+        return m_uHeight;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetPixels
+
+      Summary:  Returns the pixels of the last frame, row by row, in the
+                B8G8R8A8 layout of the back buffer
+
+      Returns:  const std::vector<UINT>&
+                  Pixels of the image
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::vector<UINT>& SoftwareRenderer::GetPixels() const
+    {
+        return m_aPixels;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetStats
+
+      Summary:  Returns the counters of the frames rendered so far
+
+      Returns:  const SoftwareRenderStats&
+                  Frame counters
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const SoftwareRenderStats& SoftwareRenderer::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetFramesPerSecond
+
+      Summary:  Returns the average throughput in frames
+
+      Returns:  FLOAT
+                  Frames per second, 0 before the first frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT SoftwareRenderer::GetFramesPerSecond() const
+    {
+        if (m_stats.totalSeconds <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        return static_cast<FLOAT>(m_stats.uNumFrames) / m_stats.totalSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::GetMegapixelsPerSecond
+
+      Summary:  Returns the average throughput in pixels
+
+      Returns:  FLOAT
+                  Millions of pixels per second, 0 before the first
+                  frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    FLOAT SoftwareRenderer::GetMegapixelsPerSecond() const
+    {
+        return GetFramesPerSecond() * static_cast<FLOAT>(m_uWidth) * static_cast<FLOAT>(m_uHeight) / 1000000.0f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::addDraw
+
+      Summary:  Appends a draw to the frame and numbers its triangles
+
+      Args:     SoftwareDraw& draw
+                  Draw to append, its transform and first triangle are
+                  filled in
+
+      Modifies: [m_aDraws, m_uNumTriangles].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::addDraw(_In_ SoftwareDraw& draw)
+    {
+        const UINT64 uNumTriangles = static_cast<UINT64>(draw.uNumIndices / 3u) * draw.uNumGroups;
+        if (uNumTriangles == 0u)
+        {
+            return;
+        }
+
+        draw.WorldViewProjection = draw.World * m_viewProjection;
+        draw.uFirstTriangle = m_uNumTriangles;
+        m_uNumTriangles += uNumTriangles;
+
+        m_aDraws.push_back(draw);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::getTexture
+
+      Summary:  Returns the decoded texels of a texture, decoding the
+                file on first use
+
+      Args:     const Texture& texture
+                  Texture to decode
+                const SoftwareTexture*& pOutTexture
+                  Receives the decoded texture
+
+      Modifies: [m_textures].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT SoftwareRenderer::getTexture(_In_ const Texture& texture, _Out_ const SoftwareTexture*& pOutTexture)
+    {
+        pOutTexture = nullptr;
+
+        if (!m_wicFactory)
+        {
+            return E_ILLEGAL_METHOD_CALL;
+        }
+
+        const std::wstring key = texture.GetFilePath().wstring();
+
+        auto it = m_textures.find(key);
+        if (it != m_textures.end())
+        {
+            pOutTexture = &it->second;
+            return S_OK;
+        }
+
+        HRESULT hr = S_OK;
+
+        ComPtr<IWICBitmapDecoder> decoder;
+        hr = m_wicFactory->CreateDecoderFromFilename(key.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        ComPtr<IWICBitmapFrameDecode> frame;
+        hr = decoder->GetFrame(0u, frame.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        // Decode to R8G8B8A8, the format CreateWICTextureFromFile gives the GPU
+        ComPtr<IWICFormatConverter> converter;
+        hr = m_wicFactory->CreateFormatConverter(converter.GetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeMedianCut);
+        if (FAILED(hr)) return hr;
+
+        SoftwareTexture softwareTexture = {};
+        hr = converter->GetSize(&softwareTexture.uWidth, &softwareTexture.uHeight);
+        if (FAILED(hr)) return hr;
+
+        if (softwareTexture.uWidth == 0u || softwareTexture.uHeight == 0u)
+        {
+            return WINCODEC_ERR_BADIMAGE;
+        }
+
+        softwareTexture.aTexels.resize(static_cast<size_t>(softwareTexture.uWidth) * static_cast<size_t>(softwareTexture.uHeight));
+        hr = converter->CopyPixels(
+            nullptr,
+            softwareTexture.uWidth * sizeof(UINT),
+            static_cast<UINT>(softwareTexture.aTexels.size() * sizeof(UINT)),
+            reinterpret_cast<BYTE*>(softwareTexture.aTexels.data())
+        );
+        if (FAILED(hr)) return hr;
+
+        pOutTexture = &m_textures.emplace(key, std::move(softwareTexture)).first->second;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::findGroup
+
+      Summary:  Finds the first group, instance or mesh, whose first
+                triangle is at or after the given one. A group belongs
+                to the pass and job holding its first triangle
+
+      Args:     UINT64 uTriangle
+                  Index of a triangle of the frame
+                UINT& uOutDraw
+                  Receives the draw of the group, m_aDraws.size() past
+                  the last group
+                UINT& uOutGroup
+                  Receives the group in the draw
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::findGroup(_In_ UINT64 uTriangle, _Out_ UINT& uOutDraw, _Out_ UINT& uOutGroup) const
+    {
+        auto it = std::upper_bound(
+            m_aDraws.begin(),
+            m_aDraws.end(),
+            uTriangle,
+            [](UINT64 uValue, const SoftwareDraw& draw)
+            {
+                return uValue < draw.uFirstTriangle;
+            }
+        );
+
+        // Draws are never empty, so the first one starts at triangle 0
+        const SoftwareDraw& draw = *(it - 1);
+        const UINT64 uNumTrianglesPerGroup = static_cast<UINT64>(draw.uNumIndices / 3u);
+        const UINT64 uGroup = (uTriangle - draw.uFirstTriangle + uNumTrianglesPerGroup - 1u) / uNumTrianglesPerGroup;
+
+        uOutDraw = static_cast<UINT>(it - 1 - m_aDraws.begin());
+        uOutGroup = static_cast<UINT>(uGroup);
+        if (uGroup >= draw.uNumGroups)
+        {
+            ++uOutDraw;
+            uOutGroup = 0u;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::getGroupTransform
+
+      Summary:  Returns the transform from object space to clip space
+                of a group, the instance transform included
+
+      Args:     const SoftwareDraw& draw
+                  Draw of the group
+                UINT uGroup
+                  Instance or mesh in the draw
+
+      Returns:  XMMATRIX
+                  Object to clip space transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX SoftwareRenderer::getGroupTransform(_In_ const SoftwareDraw& draw, _In_ UINT uGroup) const
+    {
+        if (draw.pInstances)
+        {
+            return draw.pInstances[uGroup].Transformation * draw.WorldViewProjection;
+        }
+
+        return draw.WorldViewProjection;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::getSkinTransform
+
+      Summary:  Blends the bone transforms of a vertex like VSPhong of
+                SkinningShaders.fxh. The bone transforms are uploaded
+                without transposition, so the shader sees them
+                transposed
+
+      Args:     const SoftwareDraw& draw
+                  Skinned draw
+                UINT uVertex
+                  Vertex in the draw
+
+      Returns:  XMMATRIX
+                  Skin transform
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMMATRIX SoftwareRenderer::getSkinTransform(_In_ const SoftwareDraw& draw, _In_ UINT uVertex) const
+    {
+        const AnimationData& animationData = draw.pAnimationData[uVertex];
+        const UINT auBoneIndices[] = { animationData.aBoneIndices.x, animationData.aBoneIndices.y, animationData.aBoneIndices.z, animationData.aBoneIndices.w };
+        const FLOAT aBoneWeights[] = { animationData.aBoneWeights.x, animationData.aBoneWeights.y, animationData.aBoneWeights.z, animationData.aBoneWeights.w };
+
+        XMMATRIX skinTransform(XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero());
+        for (UINT i = 0u; i < ARRAYSIZE(auBoneIndices); ++i)
+        {
+            // Bones past the uploaded ones read as zero in the structured buffer
+            if (auBoneIndices[i] >= draw.uNumBones)
+            {
+                continue;
+            }
+
+            const XMVECTOR weight = XMVectorReplicate(aBoneWeights[i]);
+            const XMMATRIX& boneTransform = draw.pBoneTransforms[auBoneIndices[i]];
+            for (UINT row = 0u; row < 4u; ++row)
+            {
+                skinTransform.r[row] = XMVectorMultiplyAdd(boneTransform.r[row], weight, skinTransform.r[row]);
+            }
+        }
+
+        return XMMatrixTranspose(skinTransform);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadeVertex
+
+      Summary:  Runs the vertex shader of a draw on one vertex
+
+      Args:     const SoftwareDraw& draw
+                  Draw of the vertex
+                UINT uGroup
+                  Instance or mesh in the draw
+                UINT uVertex
+                  Vertex in the draw
+                ShadedVertex& outVertex
+                  Receives the outputs of the vertex shader
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::shadeVertex(_In_ const SoftwareDraw& draw, _In_ UINT uGroup, _In_ UINT uVertex, _Out_ ShadedVertex& outVertex) const
+    {
+        const SimpleVertex& vertex = draw.pVertices[uVertex];
+        const XMVECTOR position = XMVectorSet(vertex.Position.x, vertex.Position.y, vertex.Position.z, 1.0f);
+        const XMVECTOR normal = XMVectorSet(vertex.Normal.x, vertex.Normal.y, vertex.Normal.z, 0.0f);
+
+        switch (draw.Shading)
+        {
+        case eSoftwareShading::VOXEL:
+            outVertex.WorldPosition = XMVector4Transform(XMVector4Transform(position, draw.pInstances[uGroup].Transformation), draw.World);
+            outVertex.Position = XMVector4Transform(outVertex.WorldPosition, m_viewProjection);
+            outVertex.Normal = XMVector3Normalize(XMVector3TransformNormal(normal, draw.World));
+            break;
+
+        case eSoftwareShading::SKINNED_PHONG:
+        {
+            const XMMATRIX skinTransform = getSkinTransform(draw, uVertex);
+
+            // The world position is not skinned in SkinningShaders.fxh
+            outVertex.Position = XMVector4Transform(XMVector4Transform(position, skinTransform), draw.WorldViewProjection);
+            outVertex.WorldPosition = XMVector4Transform(position, draw.World);
+            outVertex.Normal = XMVector3Normalize(XMVector3TransformNormal(XMVector3Normalize(XMVector3TransformNormal(normal, draw.World)), skinTransform));
+            break;
+        }
+
+        default:
+            // The Phong normal is neither normalized here nor in the pixel shader
+            outVertex.WorldPosition = XMVector4Transform(position, draw.World);
+            outVertex.Position = XMVector4Transform(outVertex.WorldPosition, m_viewProjection);
+            outVertex.Normal = XMVector3TransformNormal(normal, draw.World);
+            break;
+        }
+
+        outVertex.TexCoord = XMLoadFloat2(&vertex.TexCoord);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::setupTriangles
+
+      Summary:  Transforms the vertices of the groups starting in a
+                range of triangles, then rejects, clips, culls and bins
+                their triangles. Only the clip space positions are computed,
+                the other outputs of the vertex shader are evaluated
+                again for the visible triangles when shading
+
+      Args:     BinningJob& job
+                  Job receiving the triangles and bins
+                UINT64 uBeginTriangle
+                  First triangle of the range
+                UINT64 uEndTriangle
+                  Triangle past the range
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::setupTriangles(_In_ BinningJob& job, _In_ UINT64 uBeginTriangle, _In_ UINT64 uEndTriangle) const
+    {
+        job.aTriangles.clear();
+        for (std::vector<UINT>& aBin : job.aaBins)
+        {
+            aBin.clear();
+        }
+
+        UINT uDraw;
+        UINT uGroup;
+        UINT uEndDraw;
+        UINT uEndGroup;
+        findGroup(uBeginTriangle, uDraw, uGroup);
+        findGroup(uEndTriangle, uEndDraw, uEndGroup);
+
+        while (uDraw < uEndDraw || (uDraw == uEndDraw && uGroup < uEndGroup))
+        {
+            const SoftwareDraw& draw = m_aDraws[uDraw];
+            const XMMATRIX groupTransform = getGroupTransform(draw, uGroup);
+
+            job.aClipPositions.resize(draw.uNumVertices);
+            job.auOutCodes.resize(draw.uNumVertices);
+
+            UINT uGroupOutCode = ~0u;
+            for (UINT uVertex = 0u; uVertex < draw.uNumVertices; ++uVertex)
+            {
+                const XMFLOAT3& position = draw.pVertices[uVertex].Position;
+                XMVECTOR clipPosition = XMVectorSet(position.x, position.y, position.z, 1.0f);
+                if (draw.Shading == eSoftwareShading::SKINNED_PHONG)
+                {
+                    clipPosition = XMVector4Transform(clipPosition, getSkinTransform(draw, uVertex));
+                }
+                clipPosition = XMVector4Transform(clipPosition, groupTransform);
+
+                XMStoreFloat4(&job.aClipPositions[uVertex], clipPosition);
+                job.auOutCodes[uVertex] = getOutCode(clipPosition);
+                uGroupOutCode &= job.auOutCodes[uVertex];
+            }
+
+            // Whole instances outside of one frustum plane are skipped before primitive assembly
+            for (UINT uTriangle = 0u; uTriangle < draw.uNumIndices / 3u && uGroupOutCode == 0u; ++uTriangle)
+            {
+                const WORD* pIndices = draw.pIndices + uTriangle * 3u;
+                const UINT uOr = job.auOutCodes[pIndices[0]] | job.auOutCodes[pIndices[1]] | job.auOutCodes[pIndices[2]];
+                const UINT uAnd = job.auOutCodes[pIndices[0]] & job.auOutCodes[pIndices[1]] & job.auOutCodes[pIndices[2]];
+                if (uAnd != 0u)
+                {
+                    continue;
+                }
+
+                const XMVECTOR aClipPositions[] =
+                {
+                    XMLoadFloat4(&job.aClipPositions[pIndices[0]]),
+                    XMLoadFloat4(&job.aClipPositions[pIndices[1]]),
+                    XMLoadFloat4(&job.aClipPositions[pIndices[2]]),
+                };
+                const TriangleRef ref = { .uDraw = uDraw, .uGroup = uGroup, .uTriangle = uTriangle };
+
+                if (uOr & OUT_CODE_NEAR)
+                {
+                    clipTriangle(job, aClipPositions, ref);
+                }
+                else
+                {
+                    binTriangle(job, aClipPositions[0], aClipPositions[1], aClipPositions[2], ref);
+                }
+            }
+
+            if (++uGroup >= draw.uNumGroups)
+            {
+                ++uDraw;
+                uGroup = 0u;
+            }
+        }
+
+        job.uNumRasterizedTriangles = job.aTriangles.size();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::getOutCode
+
+      Summary:  Returns the frustum planes a clip space position is
+                outside of, one bit per plane
+
+      Args:     FXMVECTOR clipPosition
+                  Clip space position
+
+      Returns:  UINT
+                  Outcode, 0 inside of the frustum
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SoftwareRenderer::getOutCode(_In_ FXMVECTOR clipPosition)
+    {
+        const XMVECTOR w = XMVectorSplatW(clipPosition);
+
+        // -w <= x <= w, -w <= y <= w and 0 <= z <= w
+        UINT auBelow[4];
+        UINT auAbove[4];
+        XMStoreInt4(auBelow, XMVectorLess(clipPosition, XMVectorSelect(XMVectorNegate(w), XMVectorZero(), XMVectorSelectControl(0u, 0u, 1u, 1u))));
+        XMStoreInt4(auAbove, XMVectorGreater(clipPosition, w));
+
+        return (auBelow[0] & 1u) | (auAbove[0] & 2u) |
+            (auBelow[1] & 4u) | (auAbove[1] & 8u) |
+            (auBelow[2] & OUT_CODE_NEAR) | (auAbove[2] & 32u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::clipTriangle
+
+      Summary:  Clips a triangle crossing the near plane. Triangles
+                crossing the other planes are kept whole, their bounds
+                are clamped to the image and pixels past the far plane
+                fail the depth test
+
+      Args:     BinningJob& job
+                  Job receiving the triangles
+                const XMVECTOR* aClipPositions
+                  Clip space positions of the three vertices
+                const TriangleRef& ref
+                  Triangle in the frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::clipTriangle(_In_ BinningJob& job, _In_reads_(3) const XMVECTOR* aClipPositions, _In_ const TriangleRef& ref) const
+    {
+        // Sutherland-Hodgman against z >= 0 leaves a triangle or a quad
+        XMVECTOR aPolygon[4];
+        UINT uNumVertices = 0u;
+        for (UINT i = 0u; i < 3u; ++i)
+        {
+            const XMVECTOR current = aClipPositions[i];
+            const XMVECTOR next = aClipPositions[(i + 1u) % 3u];
+            const FLOAT currentDistance = XMVectorGetZ(current);
+            const FLOAT nextDistance = XMVectorGetZ(next);
+
+            if (currentDistance >= 0.0f)
+            {
+                aPolygon[uNumVertices++] = current;
+            }
+
+            if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+            {
+                aPolygon[uNumVertices++] = XMVectorLerp(current, next, currentDistance / (currentDistance - nextDistance));
+            }
+        }
+
+        for (UINT i = 2u; i < uNumVertices; ++i)
+        {
+            binTriangle(job, aPolygon[0], aPolygon[i - 1u], aPolygon[i], ref);
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::binTriangle
+
+      Summary:  Projects a clipped triangle to the image, culls it when
+                it faces away like the default rasterizer state, and
+                adds it to the bins of the tiles its bounds overlap
+
+      Args:     BinningJob& job
+                  Job receiving the triangle
+                FXMVECTOR v0, v1, v2
+                  Clip space positions in front of the near plane
+                const TriangleRef& ref
+                  Triangle in the frame
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::binTriangle(_In_ BinningJob& job, _In_ FXMVECTOR v0, _In_ FXMVECTOR v1, _In_ FXMVECTOR v2, _In_ const TriangleRef& ref) const
+    {
+        // Viewport transform, y grows downwards
+        const XMVECTOR scale = XMVectorSet(0.5f * static_cast<FLOAT>(m_uWidth), -0.5f * static_cast<FLOAT>(m_uHeight), 1.0f, 0.0f);
+        const XMVECTOR offset = XMVectorSet(0.5f * static_cast<FLOAT>(m_uWidth), 0.5f * static_cast<FLOAT>(m_uHeight), 0.0f, 0.0f);
+
+        SetupTriangle triangle = { .Ref = ref };
+        XMStoreFloat3(&triangle.aVertices[0], XMVectorMultiplyAdd(XMVectorDivide(v0, XMVectorSplatW(v0)), scale, offset));
+        XMStoreFloat3(&triangle.aVertices[1], XMVectorMultiplyAdd(XMVectorDivide(v1, XMVectorSplatW(v1)), scale, offset));
+        XMStoreFloat3(&triangle.aVertices[2], XMVectorMultiplyAdd(XMVectorDivide(v2, XMVectorSplatW(v2)), scale, offset));
+
+        const XMFLOAT3& a = triangle.aVertices[0];
+        const XMFLOAT3& b = triangle.aVertices[1];
+        const XMFLOAT3& c = triangle.aVertices[2];
+
+        // Clockwise on screen is front facing, back faces and degenerate triangles are culled
+        const FLOAT area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        if (!(area > 0.0f))
+        {
+            return;
+        }
+
+        // Pixels whose center is inside the bounds
+        const FLOAT minX = std::max(std::min({ a.x, b.x, c.x }), 0.0f);
+        const FLOAT maxX = std::min(std::max({ a.x, b.x, c.x }), static_cast<FLOAT>(m_uWidth));
+        const FLOAT minY = std::max(std::min({ a.y, b.y, c.y }), 0.0f);
+        const FLOAT maxY = std::min(std::max({ a.y, b.y, c.y }), static_cast<FLOAT>(m_uHeight));
+        const INT iMinX = static_cast<INT>(std::ceil(minX - 0.5f));
+        const INT iMaxX = std::min(static_cast<INT>(std::floor(maxX - 0.5f)), static_cast<INT>(m_uWidth) - 1);
+        const INT iMinY = static_cast<INT>(std::ceil(minY - 0.5f));
+        const INT iMaxY = std::min(static_cast<INT>(std::floor(maxY - 0.5f)), static_cast<INT>(m_uHeight) - 1);
+        if (iMinX > iMaxX || iMinY > iMaxY)
+        {
+            return;
+        }
+
+        const UINT uIndex = static_cast<UINT>(job.aTriangles.size());
+        job.aTriangles.push_back(triangle);
+
+        for (UINT uTileY = static_cast<UINT>(iMinY) / TILE_SIZE; uTileY <= static_cast<UINT>(iMaxY) / TILE_SIZE; ++uTileY)
+        {
+            for (UINT uTileX = static_cast<UINT>(iMinX) / TILE_SIZE; uTileX <= static_cast<UINT>(iMaxX) / TILE_SIZE; ++uTileX)
+            {
+                job.aaBins[static_cast<size_t>(uTileY) * m_uNumTilesX + uTileX].push_back(uIndex);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::rasterizeTile
+
+      Summary:  Rasterizes the triangles binned to a tile, job by job,
+                so they are drawn in submission order
+
+      Args:     size_t uTileIdx
+                  Index of the tile
+
+      Modifies: [m_aDepths, m_aRefs].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::rasterizeTile(_In_ size_t uTileIdx)
+    {
+        const Tile& tile = m_aTiles[uTileIdx];
+        FLOAT* pDepths = m_aDepths.data() + uTileIdx * TILE_SIZE * TILE_SIZE;
+        TriangleRef* pRefs = m_aRefs.data() + uTileIdx * TILE_SIZE * TILE_SIZE;
+
+        for (const BinningJob& job : m_aJobs)
+        {
+            for (UINT uTriangleIdx : job.aaBins[uTileIdx])
+            {
+                rasterizeTriangle(job.aTriangles[uTriangleIdx], tile, pDepths, pRefs);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::rasterizeTriangle
+
+      Summary:  Rasterizes a triangle inside a tile, four pixels at a
+                time. The three edge functions and the depth plane are
+                set up together in SIMD registers. Pixel centers on an
+                edge follow the top-left rule, and the depth test is
+                LESS like the default depth stencil state
+
+      Args:     const SetupTriangle& triangle
+                  Triangle to rasterize
+                const Tile& tile
+                  Tile being rasterized
+                FLOAT* pDepths
+                  Depths of the tile
+                TriangleRef* pRefs
+                  Visible triangle of every pixel of the tile
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::rasterizeTriangle(_In_ const SetupTriangle& triangle, _In_ const Tile& tile, _Inout_ FLOAT* pDepths, _Inout_ TriangleRef* pRefs) const
+    {
+        const XMFLOAT3* aVertices = triangle.aVertices;
+        const XMVECTOR x = XMVectorSet(aVertices[0].x, aVertices[1].x, aVertices[2].x, 0.0f);
+        const XMVECTOR y = XMVectorSet(aVertices[0].y, aVertices[1].y, aVertices[2].y, 0.0f);
+        const XMVECTOR z = XMVectorSet(aVertices[0].z, aVertices[1].z, aVertices[2].z, 0.0f);
+
+        // Edge i goes from vertex i to vertex i + 1: E(p) = A * p.x + B * p.y + C, positive inside
+        const XMVECTOR nextX = XMVectorSwizzle<1, 2, 0, 3>(x);
+        const XMVECTOR nextY = XMVectorSwizzle<1, 2, 0, 3>(y);
+        const XMVECTOR edgeA = XMVectorSubtract(y, nextY);
+        const XMVECTOR edgeB = XMVectorSubtract(nextX, x);
+        const XMVECTOR edgeC = XMVectorNegativeMultiplySubtract(y, nextX, XMVectorMultiply(x, nextY));
+
+        const XMVECTOR area = XMVector3Dot(edgeC, XMVectorSplatOne());
+        if (!(XMVectorGetX(area) > 0.0f))
+        {
+            return;
+        }
+
+        // The barycentric of a vertex is the edge function of the opposite edge over the area
+        const XMVECTOR oppositeZ = XMVectorDivide(XMVectorSwizzle<2, 0, 1, 3>(z), area);
+        const XMVECTOR depthA = XMVector3Dot(edgeA, oppositeZ);
+        const XMVECTOR depthB = XMVector3Dot(edgeB, oppositeZ);
+        const XMVECTOR depthC = XMVector3Dot(edgeC, oppositeZ);
+
+        // Top edges go right, left edges go up
+        const XMVECTOR topLeft = XMVectorOrInt(
+            XMVectorGreater(edgeA, XMVectorZero()),
+            XMVectorAndInt(XMVectorEqual(edgeA, XMVectorZero()), XMVectorGreater(edgeB, XMVectorZero()))
+        );
+
+        const XMVECTOR aEdgeA[] = { XMVectorSplatX(edgeA), XMVectorSplatY(edgeA), XMVectorSplatZ(edgeA) };
+        const XMVECTOR aEdgeB[] = { XMVectorSplatX(edgeB), XMVectorSplatY(edgeB), XMVectorSplatZ(edgeB) };
+        const XMVECTOR aEdgeC[] = { XMVectorSplatX(edgeC), XMVectorSplatY(edgeC), XMVectorSplatZ(edgeC) };
+        const XMVECTOR aTopLeft[] = { XMVectorSplatX(topLeft), XMVectorSplatY(topLeft), XMVectorSplatZ(topLeft) };
+
+        const FLOAT minX = std::max(std::min({ aVertices[0].x, aVertices[1].x, aVertices[2].x }), static_cast<FLOAT>(tile.uMinX));
+        const FLOAT maxX = std::min(std::max({ aVertices[0].x, aVertices[1].x, aVertices[2].x }), static_cast<FLOAT>(tile.uMaxX));
+        const FLOAT minY = std::max(std::min({ aVertices[0].y, aVertices[1].y, aVertices[2].y }), static_cast<FLOAT>(tile.uMinY));
+        const FLOAT maxY = std::min(std::max({ aVertices[0].y, aVertices[1].y, aVertices[2].y }), static_cast<FLOAT>(tile.uMaxY));
+        const INT iMinX = std::max(static_cast<INT>(std::ceil(minX - 0.5f)), static_cast<INT>(tile.uMinX));
+        const INT iMaxX = std::min(static_cast<INT>(std::floor(maxX - 0.5f)), static_cast<INT>(tile.uMaxX) - 1);
+        const INT iMinY = std::max(static_cast<INT>(std::ceil(minY - 0.5f)), static_cast<INT>(tile.uMinY));
+        const INT iMaxY = std::min(static_cast<INT>(std::floor(maxY - 0.5f)), static_cast<INT>(tile.uMaxY) - 1);
+
+        // Tiles are a multiple of four pixels wide, so aligned quads never leave the tile storage
+        const INT iStartX = iMinX & ~3;
+        const XMVECTOR pixelOffsets = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+
+        for (INT iY = iMinY; iY <= iMaxY; ++iY)
+        {
+            const XMVECTOR pixelY = XMVectorReplicate(static_cast<FLOAT>(iY) + 0.5f);
+            const XMVECTOR aRowEdges[] =
+            {
+                XMVectorMultiplyAdd(aEdgeB[0], pixelY, aEdgeC[0]),
+                XMVectorMultiplyAdd(aEdgeB[1], pixelY, aEdgeC[1]),
+                XMVectorMultiplyAdd(aEdgeB[2], pixelY, aEdgeC[2]),
+            };
+            const XMVECTOR rowDepth = XMVectorMultiplyAdd(XMVectorSplatX(depthB), pixelY, XMVectorSplatX(depthC));
+            const size_t uRowOffset = static_cast<size_t>(iY - static_cast<INT>(tile.uMinY)) * TILE_SIZE;
+
+            for (INT iX = iStartX; iX <= iMaxX; iX += 4)
+            {
+                const XMVECTOR pixelX = XMVectorAdd(XMVectorReplicate(static_cast<FLOAT>(iX)), pixelOffsets);
+
+                XMVECTOR inside = XMVectorTrueInt();
+                for (UINT uEdge = 0u; uEdge < 3u; ++uEdge)
+                {
+                    const XMVECTOR edge = XMVectorMultiplyAdd(aEdgeA[uEdge], pixelX, aRowEdges[uEdge]);
+                    inside = XMVectorAndInt(
+                        inside,
+                        XMVectorOrInt(
+                            XMVectorGreater(edge, XMVectorZero()),
+                            XMVectorAndInt(XMVectorEqual(edge, XMVectorZero()), aTopLeft[uEdge])
+                        )
+                    );
+                }
+
+                if (XMVector4EqualInt(inside, XMVectorFalseInt()))
+                {
+                    continue;
+                }
+
+                const size_t uOffset = uRowOffset + static_cast<size_t>(iX - static_cast<INT>(tile.uMinX));
+                FLOAT* pQuadDepths = pDepths + uOffset;
+
+                const XMVECTOR depth = XMVectorMultiplyAdd(XMVectorSplatX(depthA), pixelX, rowDepth);
+                const XMVECTOR storedDepth = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pQuadDepths));
+                const XMVECTOR pass = XMVectorAndInt(inside, XMVectorLess(depth, storedDepth));
+
+                XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pQuadDepths), XMVectorSelect(storedDepth, depth, pass));
+
+                UINT auPass[4];
+                XMStoreInt4(auPass, pass);
+                for (UINT uLane = 0u; uLane < 4u; ++uLane)
+                {
+                    if (auPass[uLane])
+                    {
+                        pRefs[uOffset + uLane] = triangle.Ref;
+                    }
+                }
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadeTile
+
+      Summary:  Runs the pixel shader once for every pixel of a tile.
+                The vertices of the visible triangle are shaded again,
+                and perspective correct barycentrics are computed from
+                their clip space positions, so triangles clipped by the
+                near plane need no extra vertices
+
+      Args:     size_t uTileIdx
+                  Index of the tile
+
+      Modifies: [m_aPixels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void SoftwareRenderer::shadeTile(_In_ size_t uTileIdx)
+    {
+        const Tile& tile = m_aTiles[uTileIdx];
+        const TriangleRef* pRefs = m_aRefs.data() + uTileIdx * TILE_SIZE * TILE_SIZE;
+
+        // Neighbouring pixels mostly see the same triangle
+        TriangleRef cachedRef = { .uDraw = INVALID_DRAW, .uGroup = 0u, .uTriangle = 0u };
+        ShadedVertex aVertices[3];
+        XMVECTOR aEdgePlanes[3];
+
+        for (UINT uY = tile.uMinY; uY < tile.uMaxY; ++uY)
+        {
+            for (UINT uX = tile.uMinX; uX < tile.uMaxX; ++uX)
+            {
+                const TriangleRef& ref = pRefs[static_cast<size_t>(uY - tile.uMinY) * TILE_SIZE + (uX - tile.uMinX)];
+                UINT& uPixel = m_aPixels[static_cast<size_t>(uY) * m_uWidth + uX];
+
+                if (ref.uDraw == INVALID_DRAW)
+                {
+                    uPixel = m_uClearColor;
+                    continue;
+                }
+
+                const SoftwareDraw& draw = m_aDraws[ref.uDraw];
+
+                if (ref.uDraw != cachedRef.uDraw || ref.uGroup != cachedRef.uGroup || ref.uTriangle != cachedRef.uTriangle)
+                {
+                    XMVECTOR aHomogeneous[3];
+                    for (UINT i = 0u; i < 3u; ++i)
+                    {
+                        shadeVertex(draw, ref.uGroup, draw.pIndices[ref.uTriangle * 3u + i], aVertices[i]);
+                        aHomogeneous[i] = XMVectorSwizzle<0, 1, 3, 3>(aVertices[i].Position);
+                    }
+
+                    // Rows of the adjugate of the matrix of the (x, y, w) of the vertices
+                    aEdgePlanes[0] = XMVector3Cross(aHomogeneous[1], aHomogeneous[2]);
+                    aEdgePlanes[1] = XMVector3Cross(aHomogeneous[2], aHomogeneous[0]);
+                    aEdgePlanes[2] = XMVector3Cross(aHomogeneous[0], aHomogeneous[1]);
+
+                    cachedRef = ref;
+                }
+
+                const XMVECTOR pixel = XMVectorSet(
+                    (static_cast<FLOAT>(uX) + 0.5f) * 2.0f / static_cast<FLOAT>(m_uWidth) - 1.0f,
+                    1.0f - (static_cast<FLOAT>(uY) + 0.5f) * 2.0f / static_cast<FLOAT>(m_uHeight),
+                    1.0f,
+                    0.0f
+                );
+
+                XMVECTOR aWeights[] =
+                {
+                    XMVector3Dot(aEdgePlanes[0], pixel),
+                    XMVector3Dot(aEdgePlanes[1], pixel),
+                    XMVector3Dot(aEdgePlanes[2], pixel),
+                };
+                const XMVECTOR weightSum = XMVectorAdd(XMVectorAdd(aWeights[0], aWeights[1]), aWeights[2]);
+                for (XMVECTOR& weight : aWeights)
+                {
+                    weight = XMVectorDivide(weight, weightSum);
+                }
+
+                XMVECTOR worldPosition = XMVectorZero();
+                XMVECTOR normal = XMVectorZero();
+                XMVECTOR texCoord = XMVectorZero();
+                for (UINT i = 0u; i < 3u; ++i)
+                {
+                    worldPosition = XMVectorMultiplyAdd(aVertices[i].WorldPosition, aWeights[i], worldPosition);
+                    normal = XMVectorMultiplyAdd(aVertices[i].Normal, aWeights[i], normal);
+                    texCoord = XMVectorMultiplyAdd(aVertices[i].TexCoord, aWeights[i], texCoord);
+                }
+
+                XMVECTOR color;
+                switch (draw.Shading)
+                {
+                case eSoftwareShading::VOXEL:
+                    color = shadeVoxel(draw, worldPosition, normal);
+                    break;
+
+                case eSoftwareShading::PHONG:
+                    color = shadePhong(draw, worldPosition, normal, texCoord);
+                    break;
+
+                case eSoftwareShading::SKINNED_PHONG:
+                    color = shadeSkinnedPhong(draw, worldPosition, normal, texCoord);
+                    break;
+
+                default:
+                    color = XMLoadFloat4(&draw.OutputColor);
+                    break;
+                }
+
+                uPixel = packColor(color);
+            }
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadeVoxel
+
+      Summary:  PSVoxel of VoxelShaders.fxh
+
+      Args:     const SoftwareDraw& draw
+                  Draw being shaded
+                FXMVECTOR worldPosition
+                  Interpolated world position
+                FXMVECTOR normal
+                  Interpolated normal
+
+      Returns:  XMVECTOR
+                  Color of the pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SoftwareRenderer::shadeVoxel(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal) const
+    {
+        const XMVECTOR unitNormal = XMVector3Normalize(normal);
+
+        XMVECTOR ambient = XMVectorSet(5.0f, 0.0f, 0.0f, 0.0f);
+        XMVECTOR diffuse = XMVectorSet(5.0f, 0.0f, 0.0f, 0.0f);
+        for (const PointLightData& light : m_aLights)
+        {
+            const XMVECTOR lightColor = XMVectorScale(XMVectorSetW(XMLoadFloat4(&light.Color), 0.0f), ClusteredLightCuller::GetAttenuation(light, worldPosition));
+            const XMVECTOR lightDirection = XMVector3Normalize(XMVectorSubtract(XMLoadFloat4(&light.Position), worldPosition));
+
+            ambient = XMVectorMultiplyAdd(XMVectorReplicate(0.1f), lightColor, ambient);
+            diffuse = XMVectorMultiplyAdd(XMVectorSaturate(XMVector3Dot(unitNormal, lightDirection)), lightColor, diffuse);
+        }
+
+        return XMVectorMultiply(XMVectorSetW(XMVectorAdd(ambient, diffuse), 1.0f), XMLoadFloat4(&draw.OutputColor));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadePhong
+
+      Summary:  PSPhong of PhongShaders.fxh
+
+      Args:     const SoftwareDraw& draw
+                  Draw being shaded
+                FXMVECTOR worldPosition
+                  Interpolated world position
+                FXMVECTOR normal
+                  Interpolated normal
+                FXMVECTOR texCoord
+                  Interpolated texture coordinates
+
+      Returns:  XMVECTOR
+                  Color of the pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SoftwareRenderer::shadePhong(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal, _In_ FXMVECTOR texCoord) const
+    {
+        const XMVECTOR viewDirection = XMVector3Normalize(XMVectorSubtract(worldPosition, XMLoadFloat4(&m_cameraPosition)));
+
+        XMVECTOR ambient = XMVectorZero();
+        XMVECTOR diffuse = XMVectorZero();
+        XMVECTOR specular = XMVectorZero();
+        for (const PointLightData& light : m_aLights)
+        {
+            const FLOAT attenuation = ClusteredLightCuller::GetAttenuation(light, worldPosition);
+            const XMVECTOR lightColor = XMVectorScale(XMVectorSetW(XMLoadFloat4(&light.Color), 0.0f), attenuation);
+            const XMVECTOR lightDirection = XMVector3Normalize(XMVectorSubtract(XMLoadFloat4(&light.Position), worldPosition));
+            const XMVECTOR reflectDirection = XMVector3Reflect(XMVectorNegate(lightDirection), normal);
+            const FLOAT specularFactor = std::pow(XMVectorGetX(XMVectorSaturate(XMVector3Dot(reflectDirection, XMVectorNegate(viewDirection)))), 40.0f);
+
+            ambient = XMVectorAdd(ambient, XMVectorReplicate(0.2f * attenuation));
+            diffuse = XMVectorMultiplyAdd(XMVectorSaturate(XMVector3Dot(normal, lightDirection)), lightColor, diffuse);
+            specular = XMVectorMultiplyAdd(XMVectorReplicate(specularFactor), lightColor, specular);
+        }
+
+        const XMVECTOR lighting = XMVectorSetW(XMVectorAdd(XMVectorAdd(ambient, diffuse), specular), 1.0f);
+
+        return XMVectorMultiply(lighting, sampleTexture(draw.pTexture, texCoord));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::shadeSkinnedPhong
+
+      Summary:  PSPhong of SkinningShaders.fxh
+
+      Args:     const SoftwareDraw& draw
+                  Draw being shaded
+                FXMVECTOR worldPosition
+                  Interpolated world position
+                FXMVECTOR normal
+                  Interpolated normal
+                FXMVECTOR texCoord
+                  Interpolated texture coordinates
+
+      Returns:  XMVECTOR
+                  Color of the pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SoftwareRenderer::shadeSkinnedPhong(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal, _In_ FXMVECTOR texCoord) const
+    {
+        const XMVECTOR viewDirection = XMVector3Normalize(XMVectorSubtract(worldPosition, XMLoadFloat4(&m_cameraPosition)));
+
+        XMVECTOR diffuse = XMVectorZero();
+        XMVECTOR specular = XMVectorZero();
+        for (const PointLightData& light : m_aLights)
+        {
+            const FLOAT attenuation = ClusteredLightCuller::GetAttenuation(light, worldPosition);
+            const XMVECTOR lightColor = XMVectorSetW(XMLoadFloat4(&light.Color), 0.0f);
+            const XMVECTOR lightDirection = XMVector3Normalize(XMVectorSubtract(worldPosition, XMLoadFloat4(&light.Position)));
+
+            diffuse = XMVectorMultiplyAdd(XMVectorSaturate(XMVectorMultiply(XMVector3Dot(normal, XMVectorNegate(lightDirection)), lightColor)), XMVectorReplicate(attenuation), diffuse);
+
+            const XMVECTOR reflectDirection = XMVector3Reflect(lightDirection, normal);
+            if (XMVectorGetX(diffuse) > 0.0f)
+            {
+                const FLOAT specularFactor = std::pow(XMVectorGetX(XMVectorSaturate(XMVector3Dot(reflectDirection, XMVectorNegate(viewDirection)))), 32.0f);
+                specular = XMVectorMultiplyAdd(XMVectorReplicate(specularFactor * attenuation), lightColor, specular);
+            }
+        }
+
+        const XMVECTOR ambient = XMVectorSet(0.2f, 0.2f, 0.2f, 0.0f);
+        const XMVECTOR lighting = XMVectorSetW(XMVectorAdd(XMVectorAdd(diffuse, specular), ambient), 1.0f);
+
+        return XMVectorMultiply(lighting, sampleTexture(draw.pTexture, texCoord));
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::sampleTexture
+
+      Summary:  Samples the top mip level of a texture with bilinear
+                filtering and wrapping, like the linear sampler of
+                Texture close to the camera
+
+      Args:     const SoftwareTexture* pTexture
+                  Texture to sample, white when nullptr
+                FXMVECTOR texCoord
+                  Texture coordinates
+
+      Returns:  XMVECTOR
+                  Filtered color
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    XMVECTOR SoftwareRenderer::sampleTexture(_In_opt_ const SoftwareTexture* pTexture, _In_ FXMVECTOR texCoord) const
+    {
+        if (!pTexture)
+        {
+            return XMVectorSplatOne();
+        }
+
+        const FLOAT u = XMVectorGetX(texCoord) * static_cast<FLOAT>(pTexture->uWidth) - 0.5f;
+        const FLOAT v = XMVectorGetY(texCoord) * static_cast<FLOAT>(pTexture->uHeight) - 0.5f;
+        const FLOAT floorU = std::floor(u);
+        const FLOAT floorV = std::floor(v);
+        if (!std::isfinite(floorU) || !std::isfinite(floorV))
+        {
+            return XMVectorZero();
+        }
+
+        const FLOAT wrappedU = floorU - std::floor(floorU / static_cast<FLOAT>(pTexture->uWidth)) * static_cast<FLOAT>(pTexture->uWidth);
+        const FLOAT wrappedV = floorV - std::floor(floorV / static_cast<FLOAT>(pTexture->uHeight)) * static_cast<FLOAT>(pTexture->uHeight);
+        const UINT uX0 = std::min(static_cast<UINT>(wrappedU), pTexture->uWidth - 1u);
+        const UINT uY0 = std::min(static_cast<UINT>(wrappedV), pTexture->uHeight - 1u);
+        const UINT uX1 = uX0 + 1u < pTexture->uWidth ? uX0 + 1u : 0u;
+        const UINT uY1 = uY0 + 1u < pTexture->uHeight ? uY0 + 1u : 0u;
+
+        const auto loadTexel = [pTexture](UINT uX, UINT uY)
+        {
+            const UINT uTexel = pTexture->aTexels[static_cast<size_t>(uY) * pTexture->uWidth + uX];
+            return XMVectorScale(
+                XMVectorSet(
+                    static_cast<FLOAT>(uTexel & 0xFFu),
+                    static_cast<FLOAT>((uTexel >> 8u) & 0xFFu),
+                    static_cast<FLOAT>((uTexel >> 16u) & 0xFFu),
+                    static_cast<FLOAT>(uTexel >> 24u)
+                ),
+                1.0f / 255.0f
+            );
+        };
+
+        const XMVECTOR top = XMVectorLerp(loadTexel(uX0, uY0), loadTexel(uX1, uY0), u - floorU);
+        const XMVECTOR bottom = XMVectorLerp(loadTexel(uX0, uY1), loadTexel(uX1, uY1), u - floorU);
+
+        return XMVectorLerp(top, bottom, v - floorV);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   SoftwareRenderer::packColor
+
+      Summary:  Converts a color to a B8G8R8A8_UNORM pixel
+
+      Args:     FXMVECTOR color
+                  Color to convert, saturated like a UNORM render target
+
+      Returns:  UINT
+                  Packed pixel
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT SoftwareRenderer::packColor(_In_ FXMVECTOR color)
+    {
+        XMFLOAT4 saturated;
+        XMStoreFloat4(&saturated, XMVectorSaturate(color));
+
+        const auto toByte = [](FLOAT value)
+        {
+            return static_cast<UINT>(value * 255.0f + 0.5f);
+        };
+
+        return toByte(saturated.z) | (toByte(saturated.y) << 8u) | (toByte(saturated.x) << 16u) | (toByte(saturated.w) << 24u);
+    }
+}
@@ -0,0 +1,291 @@
+/*+===================================================================
+  File:      SOFTWARERENDERER.H
+
+  Summary:   SoftwareRenderer header file contains declarations of the
+             tile based CPU rasterizer used to render scenes to image
+             files on machines without a GPU. It reproduces the voxel,
+             Phong and skinned Phong shaders.
+
+  Classes: SoftwareRenderer
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+    class InstancedRenderable;
+    class Model;
+    class Renderable;
+    class Texture;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eSoftwareShading
+
+      Summary:  Shader pair reproduced by a software draw
+
+      Values:   VOXEL
+                  VSVoxel and PSVoxel of VoxelShaders.fxh
+                PHONG
+                  VSPhong and PSPhong of PhongShaders.fxh
+                SKINNED_PHONG
+                  VSPhong and PSPhong of SkinningShaders.fxh
+                COLOR
+                  VSLightCube and PSLightCube of PhongShaders.fxh
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eSoftwareShading : BYTE
+    {
+        VOXEL,
+        PHONG,
+        SKINNED_PHONG,
+        COLOR,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SoftwareRenderStats
+
+      Summary:  Counters of the frames rendered by a software renderer
+
+      Members:  UINT64 uNumFrames
+                  Number of frames rendered
+                UINT64 uNumTriangles
+                  Number of triangles submitted, instances included
+                UINT64 uNumRasterizedTriangles
+                  Number of triangles left after clipping and culling
+                FLOAT frameSeconds
+                  Duration of the last frame
+                FLOAT totalSeconds
+                  Duration of all frames
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SoftwareRenderStats
+    {
+        UINT64 uNumFrames;
+        UINT64 uNumTriangles;
+        UINT64 uNumRasterizedTriangles;
+        FLOAT frameSeconds;
+        FLOAT totalSeconds;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   SoftwareImageDifference
+
+      Summary:  Difference between the image of a software renderer and
+                a reference image of the same size
+
+      Members:  UINT64 uNumPixels
+                  Number of pixels compared
+                UINT64 uNumDifferentPixels
+                  Number of pixels with a channel differing by more
+                  than the tolerance
+                UINT uMaxChannelDifference
+                  Largest difference of a channel over all pixels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SoftwareImageDifference
+    {
+        UINT64 uNumPixels;
+        UINT64 uNumDifferentPixels;
+        UINT uMaxChannelDifference;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    SoftwareRenderer
+
+      Summary:  Renders draws on the CPU into a B8G8R8A8 image. Draws
+                are only recorded until EndFrame, which transforms and
+                bins the triangles into screen tiles in parallel, then
+                rasterizes the tiles in parallel into a depth buffer and
+                a visibility buffer, and finally shades every visible
+                pixel once. Bins are walked in submission order, so the
+                image does not depend on the number of threads
+
+      Methods:  Initialize
+                  Creates the imaging factory used for textures and
+                  image files
+                BeginFrame
+                  Starts a frame with the camera and lights
+                DrawRenderable
+                  Draws a renderable with the Phong shaders
+                DrawVoxels
+                  Draws a range of voxel instances
+                DrawModel
+                  Draws a skinned model in its current pose
+                EndFrame
+                  Rasterizes and shades the draws of the frame
+                SaveToFile
+                  Writes the image to a PNG file
+                CompareToFile
+                  Compares the image with a reference image file
+                GetWidth
+                  Returns the width of the image
+                GetHeight
+                  Returns the height of the image
+                GetPixels
+                  Returns the pixels of the image
+                GetStats
+                  Returns the frame counters
+                GetFramesPerSecond
+                  Returns the average number of frames per second
+                GetMegapixelsPerSecond
+                  Returns the average number of pixels per second
+                SoftwareRenderer
+                  Constructor.
+                ~SoftwareRenderer
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class SoftwareRenderer final
+    {
+    public:
+        static constexpr UINT TILE_SIZE = 64u;
+        static constexpr UINT64 MAX_TRIANGLES_PER_PASS = 1u << 20u;
+        static constexpr UINT NUM_JOBS_PER_THREAD = 4u;
+        static constexpr UINT INVALID_DRAW = 0xFFFFFFFF;
+        static constexpr UINT OUT_CODE_NEAR = 16u;
+
+    public:
+        SoftwareRenderer(_In_ UINT uWidth, _In_ UINT uHeight);
+        SoftwareRenderer(const SoftwareRenderer& other) = delete;
+        SoftwareRenderer(SoftwareRenderer&& other) = delete;
+        SoftwareRenderer& operator=(const SoftwareRenderer& other) = delete;
+        SoftwareRenderer& operator=(SoftwareRenderer&& other) = delete;
+        ~SoftwareRenderer() = default;
+
+        HRESULT Initialize();
+
+        void BeginFrame(
+            _In_ const FLOAT aClearColor[4],
+            _In_ const XMMATRIX& view,
+            _In_ const XMMATRIX& projection,
+            _In_ const XMFLOAT4& cameraPosition,
+            _In_reads_(uNumLights) const PointLightData* pLights,
+            _In_ UINT uNumLights
+        );
+        HRESULT DrawRenderable(_In_ const Renderable& renderable);
+        void DrawVoxels(_In_ const InstancedRenderable& voxel, _In_ UINT uStartInstance, _In_ UINT uNumInstances);
+        HRESULT DrawModel(_In_ Model& model);
+        void EndFrame();
+
+        HRESULT SaveToFile(_In_ const std::filesystem::path& filePath) const;
+        HRESULT CompareToFile(_In_ const std::filesystem::path& filePath, _In_ UINT uTolerance, _Out_ SoftwareImageDifference& outDifference) const;
+
+        UINT GetWidth() const;
+        UINT GetHeight() const;
+        const std::vector<UINT>& GetPixels() const;
+        const SoftwareRenderStats& GetStats() const;
+        FLOAT GetFramesPerSecond() const;
+        FLOAT GetMegapixelsPerSecond() const;
+
+    private:
+        struct SoftwareTexture
+        {
+            UINT uWidth;
+            UINT uHeight;
+            std::vector<UINT> aTexels;
+        };
+
+        struct SoftwareDraw
+        {
+            XMMATRIX World;
+            XMMATRIX WorldViewProjection;
+            XMFLOAT4 OutputColor;
+            eSoftwareShading Shading;
+            const SimpleVertex* pVertices;
+            const WORD* pIndices;
+            const InstanceData* pInstances;
+            const AnimationData* pAnimationData;
+            const XMMATRIX* pBoneTransforms;
+            UINT uNumBones;
+            const SoftwareTexture* pTexture;
+            UINT uNumVertices;
+            UINT uNumIndices;
+            UINT uNumGroups;
+            UINT64 uFirstTriangle;
+        };
+
+        struct TriangleRef
+        {
+            UINT uDraw;
+            UINT uGroup;
+            UINT uTriangle;
+        };
+
+        struct SetupTriangle
+        {
+            XMFLOAT3 aVertices[3];
+            TriangleRef Ref;
+        };
+
+        struct ShadedVertex
+        {
+            XMVECTOR Position;
+            XMVECTOR WorldPosition;
+            XMVECTOR Normal;
+            XMVECTOR TexCoord;
+        };
+
+        struct BinningJob
+        {
+            std::vector<XMFLOAT4> aClipPositions;
+            std::vector<UINT> auOutCodes;
+            std::vector<SetupTriangle> aTriangles;
+            std::vector<std::vector<UINT>> aaBins;
+            UINT64 uNumRasterizedTriangles;
+        };
+
+        struct Tile
+        {
+            UINT uMinX;
+            UINT uMinY;
+            UINT uMaxX;
+            UINT uMaxY;
+        };
+
+    private:
+        void addDraw(_In_ SoftwareDraw& draw);
+        HRESULT getTexture(_In_ const Texture& texture, _Out_ const SoftwareTexture*& pOutTexture);
+        void findGroup(_In_ UINT64 uTriangle, _Out_ UINT& uOutDraw, _Out_ UINT& uOutGroup) const;
+
+        XMMATRIX getGroupTransform(_In_ const SoftwareDraw& draw, _In_ UINT uGroup) const;
+        XMMATRIX getSkinTransform(_In_ const SoftwareDraw& draw, _In_ UINT uVertex) const;
+        void shadeVertex(_In_ const SoftwareDraw& draw, _In_ UINT uGroup, _In_ UINT uVertex, _Out_ ShadedVertex& outVertex) const;
+
+        void setupTriangles(_In_ BinningJob& job, _In_ UINT64 uBeginTriangle, _In_ UINT64 uEndTriangle) const;
+        static UINT getOutCode(_In_ FXMVECTOR clipPosition);
+        void clipTriangle(_In_ BinningJob& job, _In_reads_(3) const XMVECTOR* aClipPositions, _In_ const TriangleRef& ref) const;
+        void binTriangle(_In_ BinningJob& job, _In_ FXMVECTOR v0, _In_ FXMVECTOR v1, _In_ FXMVECTOR v2, _In_ const TriangleRef& ref) const;
+        void rasterizeTile(_In_ size_t uTileIdx);
+        void rasterizeTriangle(_In_ const SetupTriangle& triangle, _In_ const Tile& tile, _Inout_ FLOAT* pDepths, _Inout_ TriangleRef* pRefs) const;
+        void shadeTile(_In_ size_t uTileIdx);
+
+        XMVECTOR shadeVoxel(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal) const;
+        XMVECTOR shadePhong(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal, _In_ FXMVECTOR texCoord) const;
+        XMVECTOR shadeSkinnedPhong(_In_ const SoftwareDraw& draw, _In_ FXMVECTOR worldPosition, _In_ FXMVECTOR normal, _In_ FXMVECTOR texCoord) const;
+        XMVECTOR sampleTexture(_In_opt_ const SoftwareTexture* pTexture, _In_ FXMVECTOR texCoord) const;
+
+        static UINT packColor(_In_ FXMVECTOR color);
+
+    private:
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uNumTilesX;
+        UINT m_uNumTilesY;
+        ComPtr<IWICImagingFactory> m_wicFactory;
+        XMMATRIX m_viewProjection;
+        XMFLOAT4 m_cameraPosition;
+        std::vector<PointLightData> m_aLights;
+        UINT m_uClearColor;
+        std::vector<SoftwareDraw> m_aDraws;
+        UINT64 m_uNumTriangles;
+        std::unordered_map<std::wstring, SoftwareTexture> m_textures;
+        std::vector<BinningJob> m_aJobs;
+        std::vector<Tile> m_aTiles;
+        std::vector<FLOAT> m_aDepths;
+        std::vector<TriangleRef> m_aRefs;
+        std::vector<UINT> m_aPixels;
+        LARGE_INTEGER m_frameStartTime;
+        SoftwareRenderStats m_stats;
+    };
+}
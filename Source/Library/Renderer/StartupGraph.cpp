@@ -0,0 +1,461 @@
+#include "Renderer/StartupGraph.h"
+
+#include <algorithm>
+
+#include "Loading/AssetLoader.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::StartupGraph
+
+      Summary:  Constructor of a graph without tasks
+
+      Modifies: [m_aTasks, m_pJobSystem, m_pAssetLoader, m_startTime,
+                 m_totalSeconds, m_deviceThreadId, m_mutex,
+                 m_finishedHandle, m_uNumUnfinishedTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StartupGraph::StartupGraph()
+        : m_aTasks()
+        , m_pJobSystem(nullptr)
+        , m_pAssetLoader(nullptr)
+        , m_startTime()
+        , m_totalSeconds(0.0f)
+        , m_deviceThreadId()
+        , m_mutex()
+        , m_finishedHandle()
+        , m_uNumUnfinishedTasks(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::Reset
+
+      Summary:  Removes every task and their times
+
+      Modifies: [m_aTasks, m_totalSeconds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StartupGraph::Reset()
+    {
+        m_aTasks.clear();
+        m_totalSeconds = 0.0f;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::AddTask
+
+      Summary:  Adds a task without dependencies
+
+      Args:     const std::wstring& name
+                  Name of the task in the report
+                eStartupThread thread
+                  Threads the task may run on
+                const std::function<HRESULT()>& task
+                  Function of the task, only called if every task it
+                  depends on succeeded
+
+      Modifies: [m_aTasks].
+
+      Returns:  UINT
+                  Index of the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    UINT StartupGraph::AddTask(_In_ const std::wstring& name, _In_ eStartupThread thread, _In_ const std::function<HRESULT()>& task)
+    {
+        StartupTask& startupTask = m_aTasks.emplace_back();
+        startupTask.Name = name;
+        startupTask.Thread = thread;
+        startupTask.Function = task;
+        startupTask.hr = S_OK;
+        startupTask.StartSeconds = 0.0f;
+        startupTask.EndSeconds = 0.0f;
+
+        return static_cast<UINT>(m_aTasks.size() - 1u);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::AddDependency
+
+      Summary:  Makes a task wait for another. Tasks may only depend on
+                tasks added before them, so the graph has no cycle
+
+      Args:     UINT uTask
+                  Index of the waiting task
+                UINT uDependency
+                  Index of the task to wait for
+
+      Modifies: [m_aTasks].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the dependency was not
+                  added before the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StartupGraph::AddDependency(_In_ UINT uTask, _In_ UINT uDependency)
+    {
+        if (uTask >= m_aTasks.size() || uDependency >= uTask)
+        {
+            return E_INVALIDARG;
+        }
+
+        m_aTasks[uTask].auDependencies.push_back(uDependency);
+        m_aTasks[uDependency].auDependents.push_back(uTask);
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::Execute
+
+      Summary:  Runs every task, the calling thread being the device
+                thread of the asset loader. The tasks without
+                dependencies are scheduled first, and each finished
+                task schedules the dependents it was the last to wait
+                for. The calling thread resumes the device tasks, and
+                any other load of the asset loader, as they become
+                ready, sleeping while there are none, and returns once
+                every task finished
+
+      Args:     JobSystem& jobSystem
+                  Job system running the worker tasks
+                AssetLoader& assetLoader
+                  Asset loader running the loader and device tasks
+
+      Modifies: [m_aTasks, m_pJobSystem, m_pAssetLoader, m_startTime,
+                 m_totalSeconds, m_deviceThreadId, m_finishedHandle,
+                 m_uNumUnfinishedTasks].
+
+      Returns:  HRESULT
+                  Status code of the first task added that failed
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StartupGraph::Execute(_In_ JobSystem& jobSystem, _In_ AssetLoader& assetLoader)
+    {
+        m_pJobSystem = &jobSystem;
+        m_pAssetLoader = &assetLoader;
+        m_deviceThreadId = std::this_thread::get_id();
+        m_finishedHandle = nullptr;
+        m_uNumUnfinishedTasks = static_cast<UINT>(m_aTasks.size());
+        for (StartupTask& task : m_aTasks)
+        {
+            task.uNumPendingDependencies.store(static_cast<UINT>(task.auDependencies.size()), std::memory_order_relaxed);
+            task.bDependencyFailed.store(false, std::memory_order_relaxed);
+            task.hr = S_OK;
+        }
+
+        // Every counter is set before the first task can finish
+        m_startTime = std::chrono::steady_clock::now();
+        for (UINT uTask = 0u; uTask < m_aTasks.size(); ++uTask)
+        {
+            if (m_aTasks[uTask].auDependencies.empty())
+            {
+                schedule(uTask);
+            }
+        }
+
+        Task<HRESULT> finished = waitForTasks();
+        assetLoader.Wait(finished);
+
+        m_totalSeconds = getSecondsSinceStart();
+
+        // A coroutine finishing the last task may still be returning from it
+        for (const StartupTask& task : m_aTasks)
+        {
+            while (!task.Coroutine.IsDone())
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        for (const StartupTask& task : m_aTasks)
+        {
+            if (FAILED(task.hr))
+            {
+                return task.hr;
+            }
+        }
+
+        return S_OK;
+    }
+
+    UINT StartupGraph::GetNumTasks() const
+    {
+        return static_cast<UINT>(m_aTasks.size());
+    }
+
+    FLOAT StartupGraph::GetTotalSeconds() const
+    {
+        return m_totalSeconds;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::GetCriticalPath
+
+      Summary:  Returns the critical path of the last execution: the
+                task that ended last, the dependency of it that ended
+                last, and so on. Shortening any other task does not
+                shorten the startup
+
+      Returns:  std::vector<UINT>
+                  Indices of the tasks of the path, first to last
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::vector<UINT> StartupGraph::GetCriticalPath() const
+    {
+        std::vector<UINT> auPath;
+        if (m_aTasks.empty())
+        {
+            return auPath;
+        }
+
+        UINT uTask = 0u;
+        for (UINT i = 1u; i < m_aTasks.size(); ++i)
+        {
+            if (m_aTasks[i].EndSeconds > m_aTasks[uTask].EndSeconds)
+            {
+                uTask = i;
+            }
+        }
+
+        for (;;)
+        {
+            auPath.push_back(uTask);
+
+            const std::vector<UINT>& auDependencies = m_aTasks[uTask].auDependencies;
+            if (auDependencies.empty())
+            {
+                break;
+            }
+            uTask = *std::max_element(auDependencies.begin(), auDependencies.end(), [this](UINT uA, UINT uB)
+            {
+                return m_aTasks[uA].EndSeconds < m_aTasks[uB].EndSeconds;
+            });
+        }
+
+        std::reverse(auPath.begin(), auPath.end());
+        return auPath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::WriteReport
+
+      Summary:  Prints the timeline of the last execution, one row per
+                task in the order they started: the thread, the start
+                and duration, a bar of the task over the startup, and
+                a star on the tasks of the critical path. Then prints
+                the critical path with its share of the startup
+
+      Args:     std::FILE* pFile
+                  File to print to, such as stdout
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StartupGraph::WriteReport(_In_ std::FILE* pFile) const
+    {
+        // The workers and the loader threads are numbered in the order they first ran a task
+        std::vector<std::thread::id> aThreadIds[2];
+        std::vector<UINT> auOrder(m_aTasks.size());
+        for (UINT i = 0u; i < auOrder.size(); ++i)
+        {
+            auOrder[i] = i;
+        }
+        std::stable_sort(auOrder.begin(), auOrder.end(), [this](UINT uA, UINT uB)
+        {
+            return m_aTasks[uA].StartSeconds < m_aTasks[uB].StartSeconds;
+        });
+
+        const std::vector<UINT> auCriticalPath = GetCriticalPath();
+        const FLOAT totalSeconds = std::max(m_totalSeconds, 1e-6f);
+
+        std::fprintf(pFile, "Startup: %u tasks in %.1f ms\n\n", GetNumTasks(), m_totalSeconds * 1000.0f);
+        std::fprintf(pFile, "  %-9s %9s %9s  %-*s  %s\n", "thread", "start ms", "time ms", static_cast<int>(REPORT_BAR_WIDTH) + 2, "timeline", "task");
+
+        for (UINT uTask : auOrder)
+        {
+            const StartupTask& task = m_aTasks[uTask];
+
+            CHAR szThread[16];
+            if (task.ThreadId == m_deviceThreadId)
+            {
+                std::snprintf(szThread, sizeof(szThread), "device");
+            }
+            else
+            {
+                const BOOL bLoader = task.Thread == eStartupThread::LOADER;
+                std::vector<std::thread::id>& aKindThreadIds = aThreadIds[bLoader ? 1 : 0];
+                std::vector<std::thread::id>::const_iterator it = std::find(aKindThreadIds.begin(), aKindThreadIds.end(), task.ThreadId);
+                if (it == aKindThreadIds.end())
+                {
+                    it = aKindThreadIds.insert(aKindThreadIds.end(), task.ThreadId);
+                }
+                std::snprintf(szThread, sizeof(szThread), "%s %u", bLoader ? "loader" : "worker", static_cast<UINT>(it - aKindThreadIds.begin()) + 1u);
+            }
+
+            CHAR szBar[REPORT_BAR_WIDTH + 1u];
+            const UINT uBarBegin = std::min(static_cast<UINT>(task.StartSeconds / totalSeconds * REPORT_BAR_WIDTH), REPORT_BAR_WIDTH - 1u);
+            const UINT uBarEnd = std::clamp(static_cast<UINT>(task.EndSeconds / totalSeconds * REPORT_BAR_WIDTH + 0.5f), uBarBegin + 1u, REPORT_BAR_WIDTH);
+            for (UINT i = 0u; i < REPORT_BAR_WIDTH; ++i)
+            {
+                szBar[i] = i >= uBarBegin && i < uBarEnd ? '#' : ' ';
+            }
+            szBar[REPORT_BAR_WIDTH] = '\0';
+
+            const BOOL bCritical = std::find(auCriticalPath.begin(), auCriticalPath.end(), uTask) != auCriticalPath.end();
+            std::fprintf(
+                pFile,
+                "%c %-9s %9.1f %9.1f  |%s|  %ls%s\n",
+                bCritical ? '*' : ' ',
+                szThread,
+                task.StartSeconds * 1000.0f,
+                (task.EndSeconds - task.StartSeconds) * 1000.0f,
+                szBar,
+                task.Name.c_str(),
+                task.hr == E_ABORT ? " (skipped)" : FAILED(task.hr) ? " (failed)" : ""
+            );
+        }
+
+        FLOAT criticalSeconds = 0.0f;
+        std::fprintf(pFile, "\nCritical path:\n");
+        for (UINT uTask : auCriticalPath)
+        {
+            const StartupTask& task = m_aTasks[uTask];
+            criticalSeconds += task.EndSeconds - task.StartSeconds;
+            std::fprintf(pFile, "  %9.1f ms  %ls\n", (task.EndSeconds - task.StartSeconds) * 1000.0f, task.Name.c_str());
+        }
+
+        // The rest of the startup is spent waiting for a thread, usually the device thread
+        std::fprintf(
+            pFile,
+            "  %9.1f ms  running, %.1f ms waiting for a thread\n",
+            criticalSeconds * 1000.0f,
+            std::max(m_totalSeconds - criticalSeconds, 0.0f) * 1000.0f
+        );
+    }
+
+    void StartupGraph::runTaskJob(void* pData, std::uint32_t uBegin, std::uint32_t uEnd)
+    {
+        static_cast<StartupGraph*>(pData)->runTask(uBegin);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::runTaskCoroutine
+
+      Summary:  Moves to a loader thread or to the device thread,
+                depending on the task, then runs it
+
+      Args:     UINT uTask
+                  Index of the ready task
+
+      Returns:  Task<HRESULT>
+                  Status code of the task
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Task<HRESULT> StartupGraph::runTaskCoroutine(_In_ UINT uTask)
+    {
+        if (m_aTasks[uTask].Thread == eStartupThread::LOADER)
+        {
+            co_await m_pAssetLoader->ResumeOnLoaderThread(eLoadPriority::HIGH);
+        }
+        else
+        {
+            co_await m_pAssetLoader->ResumeOnDeviceThread(eLoadPriority::HIGH);
+        }
+
+        runTask(uTask);
+
+        co_return m_aTasks[uTask].hr;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::waitForTasks
+
+      Summary:  Waits until every task finished, then moves back to the
+                device thread, so the asset loader waiting for it there
+                returns
+
+      Returns:  Task<HRESULT>
+                  S_OK
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    Task<HRESULT> StartupGraph::waitForTasks()
+    {
+        co_await FinishedAwaiter{ .pGraph = this };
+        co_await m_pAssetLoader->ResumeOnDeviceThread(eLoadPriority::HIGH);
+
+        co_return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::schedule
+
+      Summary:  Runs a task whose dependencies all finished: a worker
+                task as a job, the others as a coroutine queued on the
+                asset loader. The coroutine is started before any other
+                thread may touch its task
+
+      Args:     UINT uTask
+                  Index of the ready task
+
+      Modifies: [m_aTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StartupGraph::schedule(_In_ UINT uTask)
+    {
+        if (m_aTasks[uTask].Thread == eStartupThread::WORKER)
+        {
+            m_pJobSystem->Run(&StartupGraph::runTaskJob, this, uTask, uTask + 1u, nullptr);
+            return;
+        }
+
+        StartupTask& task = m_aTasks[uTask];
+        task.Coroutine = runTaskCoroutine(uTask);
+        task.Coroutine.Start();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StartupGraph::runTask
+
+      Summary:  Runs and times a task, or skips it when a dependency
+                failed, then schedules the dependents it was the last
+                to wait for. The last task to finish resumes the
+                coroutine waiting for the tasks, which may let Execute
+                return, so the graph is not touched afterwards
+
+      Args:     UINT uTask
+                  Index of the task
+
+      Modifies: [m_aTasks, m_finishedHandle, m_uNumUnfinishedTasks].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StartupGraph::runTask(_In_ UINT uTask)
+    {
+        StartupTask& task = m_aTasks[uTask];
+
+        task.ThreadId = std::this_thread::get_id();
+        task.StartSeconds = getSecondsSinceStart();
+        task.hr = task.bDependencyFailed.load(std::memory_order_acquire) ? E_ABORT : task.Function();
+        task.EndSeconds = getSecondsSinceStart();
+
+        for (UINT uDependent : task.auDependents)
+        {
+            StartupTask& dependent = m_aTasks[uDependent];
+            if (FAILED(task.hr))
+            {
+                dependent.bDependencyFailed.store(true, std::memory_order_relaxed);
+            }
+            if (dependent.uNumPendingDependencies.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+            {
+                schedule(uDependent);
+            }
+        }
+
+        std::coroutine_handle<> finishedHandle;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_uNumUnfinishedTasks == 0u)
+            {
+                finishedHandle = std::exchange(m_finishedHandle, nullptr);
+            }
+        }
+
+        if (finishedHandle)
+        {
+            finishedHandle.resume();
+        }
+    }
+
+    FLOAT StartupGraph::getSecondsSinceStart() const
+    {
+        return std::chrono::duration<FLOAT>(std::chrono::steady_clock::now() - m_startTime).count();
+    }
+}
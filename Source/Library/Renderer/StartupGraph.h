@@ -0,0 +1,175 @@
+/*+===================================================================
+  File:      STARTUPGRAPH.H
+
+  Summary:   StartupGraph header file contains declarations of the
+             dependency graph initializing the objects of the engine
+             in parallel, and timing them.
+
+  Classes: StartupGraph
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Job/JobSystem.h"
+#include "Job/Task.h"
+
+namespace library
+{
+    class AssetLoader;
+
+    /*E+E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E+++E
+      Enum:     eStartupThread
+
+      Summary:  Threads a startup task may run on. The tasks using the
+                immediate context run on the device thread. The tasks
+                blocking on the disk, such as parsing files, run on the
+                loader threads of the asset loader, so they do not hold
+                the workers of the job system, which run the others
+    E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E---E-E*/
+    enum class eStartupThread : BYTE
+    {
+        WORKER,
+        LOADER,
+        DEVICE,
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StartupGraph
+
+      Summary:  Tasks of the startup and their dependencies. A task
+                runs once every task it depends on finished, and is
+                skipped with E_ABORT when one of them failed. The
+                worker tasks run as jobs, the loader and device tasks
+                as coroutines of the asset loader, resumed by its
+                loader threads or by the thread calling Execute, which
+                becomes the device thread of the loader.
+                Each task is timed, so the report shows the timeline of
+                the startup and its critical path, the chain of tasks
+                that ended last
+
+      Methods:  Reset
+                  Removes every task
+                AddTask
+                  Adds a task
+                AddDependency
+                  Makes a task wait for an earlier one
+                Execute
+                  Runs the tasks
+                GetNumTasks
+                  Returns the number of tasks
+                GetTotalSeconds
+                  Returns the time Execute took
+                GetCriticalPath
+                  Returns the chain of tasks that ended last
+                WriteReport
+                  Prints the timeline and the critical path
+                StartupGraph
+                  Constructor.
+                ~StartupGraph
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StartupGraph final
+    {
+    public:
+        static constexpr UINT REPORT_BAR_WIDTH = 40u;
+
+    public:
+        StartupGraph();
+        StartupGraph(const StartupGraph& other) = delete;
+        StartupGraph(StartupGraph&& other) = delete;
+        StartupGraph& operator=(const StartupGraph& other) = delete;
+        StartupGraph& operator=(StartupGraph&& other) = delete;
+        ~StartupGraph() = default;
+
+        void Reset();
+        UINT AddTask(_In_ const std::wstring& name, _In_ eStartupThread thread, _In_ const std::function<HRESULT()>& task);
+        HRESULT AddDependency(_In_ UINT uTask, _In_ UINT uDependency);
+        HRESULT Execute(_In_ JobSystem& jobSystem, _In_ AssetLoader& assetLoader);
+
+        UINT GetNumTasks() const;
+        FLOAT GetTotalSeconds() const;
+        std::vector<UINT> GetCriticalPath() const;
+        void WriteReport(_In_ std::FILE* pFile) const;
+
+    private:
+        struct StartupTask
+        {
+            std::wstring Name;
+            eStartupThread Thread;
+            std::function<HRESULT()> Function;
+            std::vector<UINT> auDependencies;
+            std::vector<UINT> auDependents;
+            std::atomic<UINT> uNumPendingDependencies;
+            std::atomic<bool> bDependencyFailed;
+            HRESULT hr;
+            FLOAT StartSeconds;
+            FLOAT EndSeconds;
+            std::thread::id ThreadId;
+            Task<HRESULT> Coroutine;
+        };
+
+        /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+          Struct:   FinishedAwaiter
+
+          Summary:  Suspends a coroutine until every task finished, the
+                    thread finishing the last task resumes it
+        S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+        struct FinishedAwaiter
+        {
+            StartupGraph* pGraph;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle) const
+            {
+                std::lock_guard<std::mutex> lock(pGraph->m_mutex);
+                if (pGraph->m_uNumUnfinishedTasks == 0u)
+                {
+                    return false;
+                }
+                pGraph->m_finishedHandle = handle;
+                return true;
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+    private:
+        static void runTaskJob(void* pData, std::uint32_t uBegin, std::uint32_t uEnd);
+        Task<HRESULT> runTaskCoroutine(_In_ UINT uTask);
+        Task<HRESULT> waitForTasks();
+        void schedule(_In_ UINT uTask);
+        void runTask(_In_ UINT uTask);
+        FLOAT getSecondsSinceStart() const;
+
+    private:
+        std::deque<StartupTask> m_aTasks;
+        JobSystem* m_pJobSystem;
+        AssetLoader* m_pAssetLoader;
+        std::chrono::steady_clock::time_point m_startTime;
+        FLOAT m_totalSeconds;
+        std::thread::id m_deviceThreadId;
+        std::mutex m_mutex;
+        std::coroutine_handle<> m_finishedHandle;
+        UINT m_uNumUnfinishedTasks;
+    };
+}
@@ -0,0 +1,435 @@
+#include "Renderer/StaticBatcher.h"
+
+#include <algorithm>
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::StaticBatcher
+
+      Summary:  Constructor
+
+      Modifies: [m_apPendingRenderables, m_aBatches,
+                 m_apVisibleRenderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StaticBatcher::StaticBatcher()
+        : m_apPendingRenderables()
+        , m_aBatches()
+        , m_apVisibleRenderables()
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::Add
+
+      Summary:  Queues a static renderable. It is batched by the next
+                Update, once it is initialized and its pipeline state
+                is set
+
+      Args:     Renderable* pRenderable
+                  Renderable whose world matrix no longer changes
+
+      Modifies: [m_apPendingRenderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatcher::Add(_In_ Renderable* pRenderable)
+    {
+        m_apPendingRenderables.push_back(pRenderable);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::Remove
+
+      Summary:  Removes the sub-draws of a renderable. The vertices and
+                indices after them are moved down in their batch, and
+                the batches left empty are destroyed
+
+      Args:     const Renderable* pRenderable
+                  Renderable to remove
+
+      Modifies: [m_apPendingRenderables, m_aBatches,
+                 m_apVisibleRenderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatcher::Remove(_In_ const Renderable* pRenderable)
+    {
+        std::erase(m_apPendingRenderables, pRenderable);
+        std::erase(m_apVisibleRenderables, pRenderable);
+
+        for (const std::unique_ptr<Batch>& batch : m_aBatches)
+        {
+            if (std::none_of(
+                batch->aSubDraws.begin(),
+                batch->aSubDraws.end(),
+                [pRenderable](const SubDraw& subDraw) { return subDraw.pRenderable == pRenderable; }))
+            {
+                continue;
+            }
+
+            size_t uNumSubDraws = 0u;
+            UINT uNumVertices = 0u;
+            UINT uNumIndices = 0u;
+            for (const SubDraw& subDraw : batch->aSubDraws)
+            {
+                if (subDraw.pRenderable == pRenderable)
+                {
+                    continue;
+                }
+
+                std::copy_n(batch->aVertices.begin() + subDraw.uStartVertex, subDraw.uNumVertices, batch->aVertices.begin() + uNumVertices);
+                for (UINT i = 0u; i < subDraw.uNumIndices; ++i)
+                {
+                    batch->auIndices[uNumIndices + i] = batch->auIndices[subDraw.uStartIndex + i] - subDraw.uStartVertex + uNumVertices;
+                }
+
+                SubDraw& moved = batch->aSubDraws[uNumSubDraws++];
+                moved = subDraw;
+                moved.uStartVertex = uNumVertices;
+                moved.uStartIndex = uNumIndices;
+
+                uNumVertices += subDraw.uNumVertices;
+                uNumIndices += subDraw.uNumIndices;
+            }
+
+            batch->aSubDraws.resize(uNumSubDraws);
+            batch->aVertices.resize(uNumVertices);
+            batch->auIndices.resize(uNumIndices);
+            batch->aVisibleRanges.clear();
+            batch->bDirty = TRUE;
+        }
+
+        std::erase_if(m_aBatches, [](const std::unique_ptr<Batch>& batch) { return batch->aSubDraws.empty(); });
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::Update
+
+      Summary:  Appends the meshes of the queued renderables to their
+                batches, then creates the buffers of the batches that
+                changed. A queued renderable without meshes is not
+                initialized yet and stays queued
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects
+                  Receives the replaced buffers when commands recorded
+                  earlier may still use them, may be nullptr
+
+      Modifies: [m_apPendingRenderables, m_aBatches].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StaticBatcher::Update(_In_ ID3D11Device* pDevice, _Inout_opt_ std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects)
+    {
+        HRESULT hr = S_OK;
+
+        std::erase_if(
+            m_apPendingRenderables,
+            [this](Renderable* pRenderable)
+            {
+                if (pRenderable->GetNumMeshes() == 0u || !pRenderable->GetPipelineState())
+                {
+                    return false;
+                }
+
+                for (UINT i = 0u; i < pRenderable->GetNumMeshes(); ++i)
+                {
+                    addMesh(*pRenderable, i);
+                }
+
+                return true;
+            }
+        );
+
+        for (const std::unique_ptr<Batch>& batch : m_aBatches)
+        {
+            if (batch->bDirty)
+            {
+                hr = createBuffers(pDevice, *batch, pRetiredObjects);
+                if (FAILED(hr)) return hr;
+
+                batch->bDirty = FALSE;
+            }
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::Cull
+
+      Summary:  Tests the sub-draws of every batch against an occlusion
+                culler and merges the consecutive visible ones into
+                ranges of the index buffer
+
+      Args:     OcclusionCuller& occlusionCuller
+                  Culler with the occluders of the frame
+
+      Modifies: [m_aBatches, m_apVisibleRenderables].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatcher::Cull(_In_ OcclusionCuller& occlusionCuller)
+    {
+        m_apVisibleRenderables.clear();
+
+        for (const std::unique_ptr<Batch>& batch : m_aBatches)
+        {
+            batch->aVisibleRanges.clear();
+            for (const SubDraw& subDraw : batch->aSubDraws)
+            {
+                if (!occlusionCuller.IsVisible(subDraw.Bounds))
+                {
+                    continue;
+                }
+
+                m_apVisibleRenderables.push_back(subDraw.pRenderable);
+
+                if (!batch->aVisibleRanges.empty() &&
+                    batch->aVisibleRanges.back().uStartIndex + batch->aVisibleRanges.back().uNumIndices == subDraw.uStartIndex)
+                {
+                    batch->aVisibleRanges.back().uNumIndices += subDraw.uNumIndices;
+                }
+                else
+                {
+                    batch->aVisibleRanges.push_back(DrawRange{ .uStartIndex = subDraw.uStartIndex, .uNumIndices = subDraw.uNumIndices });
+                }
+            }
+        }
+
+        // A renderable with meshes in several batches is listed once
+        std::sort(m_apVisibleRenderables.begin(), m_apVisibleRenderables.end());
+        m_apVisibleRenderables.erase(std::unique(m_apVisibleRenderables.begin(), m_apVisibleRenderables.end()), m_apVisibleRenderables.end());
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::Record
+
+      Summary:  Records the visible ranges of a batch, one draw each.
+                A batch whose buffers could not be created is skipped.
+                Only reads the batcher, so different batches can be
+                recorded by different threads
+
+      Args:     RenderBackend& backend
+                  Backend or command buffer receiving the commands
+                size_t uBatch
+                  Index of the batch
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatcher::Record(_In_ RenderBackend& backend, _In_ size_t uBatch) const
+    {
+        const Batch& batch = *m_aBatches[uBatch];
+        if (batch.bDirty || batch.aVisibleRanges.empty())
+        {
+            return;
+        }
+
+        backend.SetVertexBuffer(0u, batch.vertexBuffer.Get(), sizeof(SimpleVertex), 0u);
+        backend.SetIndexBuffer(batch.indexBuffer.Get(), DXGI_FORMAT_R32_UINT);
+
+        // Identity world matrix and the output color shared by the batch
+        backend.SetPipelineState(*batch.pipelineState, batch.constantBuffer.Get());
+
+        if (batch.diffuse)
+        {
+            backend.SetPixelShaderResource(0u, batch.diffuse->GetTextureResourceView().Get());
+        }
+
+        for (const DrawRange& range : batch.aVisibleRanges)
+        {
+            backend.DrawIndexed(range.uNumIndices, range.uStartIndex, 0);
+        }
+    }
+
+    size_t StaticBatcher::GetNumBatches() const
+    {
+        return m_aBatches.size();
+    }
+
+    const std::vector<Renderable*>& StaticBatcher::GetVisibleRenderables() const
+    {
+        return m_apVisibleRenderables;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::addMesh
+
+      Summary:  Appends the vertices referenced by a mesh, transformed
+                by the world matrix of the renderable, and its indices
+                rebased on them, to the batch of the mesh. Normals are
+                transformed the same way as in the vertex shaders
+
+      Args:     Renderable& renderable
+                  Renderable of the mesh
+                UINT uMesh
+                  Index of the mesh
+
+      Modifies: [m_aBatches].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void StaticBatcher::addMesh(_In_ Renderable& renderable, _In_ UINT uMesh)
+    {
+        const auto& mesh = renderable.GetMesh(uMesh);
+        if (mesh.uNumIndices == 0u)
+        {
+            return;
+        }
+
+        const SimpleVertex* pVertices = renderable.GetVertices();
+        const WORD* pIndices = renderable.GetIndices();
+
+        UINT uMinVertex = UINT_MAX;
+        UINT uMaxVertex = 0u;
+        for (UINT i = mesh.uBaseIndex; i < mesh.uBaseIndex + mesh.uNumIndices; ++i)
+        {
+            uMinVertex = std::min(uMinVertex, mesh.uBaseVertex + pIndices[i]);
+            uMaxVertex = std::max(uMaxVertex, mesh.uBaseVertex + pIndices[i]);
+        }
+
+        Batch& batch = findBatch(renderable, uMesh);
+        SubDraw subDraw = {
+            .pRenderable = &renderable,
+            .Bounds = {},
+            .uStartIndex = static_cast<UINT>(batch.auIndices.size()),
+            .uNumIndices = mesh.uNumIndices,
+            .uStartVertex = static_cast<UINT>(batch.aVertices.size()),
+            .uNumVertices = uMaxVertex - uMinVertex + 1u,
+        };
+
+        const XMMATRIX world = renderable.GetWorldMatrix();
+        XMVECTOR minimum = XMVectorReplicate(D3D11_FLOAT32_MAX);
+        XMVECTOR maximum = XMVectorReplicate(-D3D11_FLOAT32_MAX);
+        for (UINT i = uMinVertex; i <= uMaxVertex; ++i)
+        {
+            const XMVECTOR position = XMVector3TransformCoord(XMLoadFloat3(&pVertices[i].Position), world);
+            minimum = XMVectorMin(minimum, position);
+            maximum = XMVectorMax(maximum, position);
+
+            SimpleVertex vertex = pVertices[i];
+            XMStoreFloat3(&vertex.Position, position);
+            XMStoreFloat3(&vertex.Normal, XMVector3TransformNormal(XMLoadFloat3(&pVertices[i].Normal), world));
+            batch.aVertices.push_back(vertex);
+        }
+        XMStoreFloat3(&subDraw.Bounds.Min, minimum);
+        XMStoreFloat3(&subDraw.Bounds.Max, maximum);
+
+        for (UINT i = mesh.uBaseIndex; i < mesh.uBaseIndex + mesh.uNumIndices; ++i)
+        {
+            batch.auIndices.push_back(subDraw.uStartVertex + mesh.uBaseVertex + pIndices[i] - uMinVertex);
+        }
+
+        batch.aSubDraws.push_back(subDraw);
+        batch.bDirty = TRUE;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::findBatch
+
+      Summary:  Returns the batch drawn with the pipeline state,
+                diffuse texture and output color of a mesh, creating it if
+                there is none
+
+      Args:     Renderable& renderable
+                  Renderable of the mesh
+                UINT uMesh
+                  Index of the mesh
+
+      Modifies: [m_aBatches].
+
+      Returns:  Batch&
+                  Batch of the mesh
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    StaticBatcher::Batch& StaticBatcher::findBatch(_In_ Renderable& renderable, _In_ UINT uMesh)
+    {
+        const std::shared_ptr<Texture> diffuse = renderable.HasTexture()
+            ? renderable.GetMaterial(renderable.GetMesh(uMesh).uMaterialIndex).pDiffuse
+            : nullptr;
+        const XMFLOAT4& outputColor = renderable.GetOutputColor();
+
+        for (const std::unique_ptr<Batch>& batch : m_aBatches)
+        {
+            if (batch->pipelineState == renderable.GetPipelineState() &&
+                batch->diffuse == diffuse &&
+                XMVector4Equal(XMLoadFloat4(&batch->OutputColor), XMLoadFloat4(&outputColor)))
+            {
+                return *batch;
+            }
+        }
+
+        std::unique_ptr<Batch> batch = std::make_unique<Batch>();
+        batch->pipelineState = renderable.GetPipelineState();
+        batch->diffuse = diffuse;
+        batch->OutputColor = outputColor;
+        batch->bDirty = TRUE;
+        m_aBatches.push_back(std::move(batch));
+
+        return *m_aBatches.back();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   StaticBatcher::createBuffers
+
+      Summary:  Creates the immutable vertex, index and constant buffers
+                of a batch from its CPU copy, replacing the previous ones
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the buffers
+                Batch& batch
+                  Batch to create the buffers of
+                std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects
+                  Receives the replaced buffers, may be nullptr
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT StaticBatcher::createBuffers(_In_ ID3D11Device* pDevice, _Inout_ Batch& batch, _Inout_opt_ std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects)
+    {
+        HRESULT hr = S_OK;
+
+        if (pRetiredObjects)
+        {
+            if (batch.vertexBuffer) pRetiredObjects->push_back(batch.vertexBuffer);
+            if (batch.indexBuffer) pRetiredObjects->push_back(batch.indexBuffer);
+        }
+
+        D3D11_BUFFER_DESC vertexBufferDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(SimpleVertex) * batch.aVertices.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_VERTEX_BUFFER,
+            .CPUAccessFlags = 0u,
+        };
+        D3D11_SUBRESOURCE_DATA vertexData = {
+            .pSysMem = batch.aVertices.data(),
+        };
+        hr = pDevice->CreateBuffer(&vertexBufferDesc, &vertexData, batch.vertexBuffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        D3D11_BUFFER_DESC indexBufferDesc = {
+            .ByteWidth = static_cast<UINT>(sizeof(UINT) * batch.auIndices.size()),
+            .Usage = D3D11_USAGE_IMMUTABLE,
+            .BindFlags = D3D11_BIND_INDEX_BUFFER,
+            .CPUAccessFlags = 0u,
+        };
+        D3D11_SUBRESOURCE_DATA indexData = {
+            .pSysMem = batch.auIndices.data(),
+        };
+        hr = pDevice->CreateBuffer(&indexBufferDesc, &indexData, batch.indexBuffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) return hr;
+
+        if (!batch.constantBuffer)
+        {
+            D3D11_BUFFER_DESC constantBufferDesc = {
+                .ByteWidth = sizeof(CBChangesEveryFrame),
+                .Usage = D3D11_USAGE_IMMUTABLE,
+                .BindFlags = D3D11_BIND_CONSTANT_BUFFER,
+                .CPUAccessFlags = 0u,
+            };
+            CBChangesEveryFrame cb = {
+                .World = XMMatrixIdentity(),
+                .OutputColor = batch.OutputColor,
+            };
+            D3D11_SUBRESOURCE_DATA constantData = {
+                .pSysMem = &cb,
+            };
+            hr = pDevice->CreateBuffer(&constantBufferDesc, &constantData, batch.constantBuffer.GetAddressOf());
+            if (FAILED(hr)) return hr;
+        }
+
+        return S_OK;
+    }
+}
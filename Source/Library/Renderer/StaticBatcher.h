@@ -0,0 +1,121 @@
+/*+===================================================================
+  File:      STATICBATCHER.H
+
+  Summary:   StaticBatcher header file contains declarations of the
+             static batching that merges the renderables whose world
+             matrix never changes into shared, pre-transformed vertex
+             and index buffers.
+
+  Classes: StaticBatcher
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Renderer/DataTypes.h"
+#include "Renderer/OcclusionCuller.h"
+#include "Renderer/PipelineState.h"
+#include "Renderer/RenderBackend.h"
+#include "Renderer/Renderable.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    StaticBatcher
+
+      Summary:  Groups the meshes of static renderables by pipeline
+                state, diffuse texture and output color. Each group owns one
+                vertex buffer holding the vertices already transformed
+                by their world matrix, and one 32 bit index buffer, so
+                it is drawn with an identity world matrix and no per
+                object constant buffer update. Every mesh keeps its
+                range of the buffers as a sub-draw, culled on its own;
+                the consecutive visible sub-draws of a group are merged
+                into one draw. Adding or removing a renderable only
+                edits the groups of its meshes on the CPU, and only
+                those groups have their buffers created again
+
+      Methods:  Add
+                  Queues a static renderable to be batched
+                Remove
+                  Removes a renderable from its batches
+                Update
+                  Batches the queued renderables and creates the
+                  buffers of the changed batches
+                Cull
+                  Tests the sub-draws against an occlusion culler
+                Record
+                  Records the visible sub-draws of a batch
+                GetNumBatches
+                  Returns the number of batches
+                GetVisibleRenderables
+                  Returns the renderables with a visible sub-draw
+                StaticBatcher
+                  Constructor.
+                ~StaticBatcher
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class StaticBatcher final
+    {
+    public:
+        StaticBatcher();
+        StaticBatcher(const StaticBatcher& other) = delete;
+        StaticBatcher(StaticBatcher&& other) = delete;
+        StaticBatcher& operator=(const StaticBatcher& other) = delete;
+        StaticBatcher& operator=(StaticBatcher&& other) = delete;
+        ~StaticBatcher() = default;
+
+        void Add(_In_ Renderable* pRenderable);
+        void Remove(_In_ const Renderable* pRenderable);
+        HRESULT Update(_In_ ID3D11Device* pDevice, _Inout_opt_ std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects = nullptr);
+        void Cull(_In_ OcclusionCuller& occlusionCuller);
+        void Record(_In_ RenderBackend& backend, _In_ size_t uBatch) const;
+
+        size_t GetNumBatches() const;
+        const std::vector<Renderable*>& GetVisibleRenderables() const;
+
+    private:
+        struct SubDraw
+        {
+            Renderable* pRenderable;
+            AxisAlignedBox Bounds;
+            UINT uStartIndex;
+            UINT uNumIndices;
+            UINT uStartVertex;
+            UINT uNumVertices;
+        };
+
+        struct DrawRange
+        {
+            UINT uStartIndex;
+            UINT uNumIndices;
+        };
+
+        struct Batch
+        {
+            std::shared_ptr<PipelineState> pipelineState;
+            std::shared_ptr<Texture> diffuse;
+            XMFLOAT4 OutputColor;
+            std::vector<SimpleVertex> aVertices;
+            std::vector<UINT> auIndices;
+            std::vector<SubDraw> aSubDraws;
+            std::vector<DrawRange> aVisibleRanges;
+            ComPtr<ID3D11Buffer> vertexBuffer;
+            ComPtr<ID3D11Buffer> indexBuffer;
+            ComPtr<ID3D11Buffer> constantBuffer;
+            BOOL bDirty;
+        };
+
+    private:
+        void addMesh(_In_ Renderable& renderable, _In_ UINT uMesh);
+        Batch& findBatch(_In_ Renderable& renderable, _In_ UINT uMesh);
+        static HRESULT createBuffers(_In_ ID3D11Device* pDevice, _Inout_ Batch& batch, _Inout_opt_ std::vector<ComPtr<ID3D11DeviceChild>>* pRetiredObjects);
+
+    private:
+        std::vector<Renderable*> m_apPendingRenderables;
+        std::vector<std::unique_ptr<Batch>> m_aBatches;
+        std::vector<Renderable*> m_apVisibleRenderables;
+    };
+}
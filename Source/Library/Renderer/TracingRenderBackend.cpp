@@ -0,0 +1,433 @@
+#include "Renderer/TracingRenderBackend.h"
+
+namespace library
+{
+    static_assert(static_cast<BYTE>(eTraceRecordType::PRESENT) == static_cast<BYTE>(eRenderCommandType::PRESENT),
+        "Trace records must keep the values of the render commands");
+    static_assert(static_cast<BYTE>(eTraceRecordType::FRAME) == static_cast<BYTE>(eRenderCommandType::COUNT),
+        "Trace records must keep the values of the render commands");
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::TracingRenderBackend
+
+      Summary:  Constructor
+
+      Args:     const std::shared_ptr<RenderBackend>& backend
+                  Backend receiving the traced commands
+
+      Modifies: [m_backend, m_file, m_objectIds, m_aRecords,
+                 m_uNumFrames, m_uNumWrittenFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TracingRenderBackend::TracingRenderBackend(_In_ const std::shared_ptr<RenderBackend>& backend)
+        : m_backend(backend)
+        , m_file()
+        , m_objectIds()
+        , m_aRecords()
+        , m_uNumFrames(0u)
+        , m_uNumWrittenFrames(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::~TracingRenderBackend
+
+      Summary:  Destructor, closes an unfinished trace so the frames
+                written so far stay readable
+
+      Modifies: [m_file].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TracingRenderBackend::~TracingRenderBackend()
+    {
+        Close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::Open
+
+      Summary:  Creates the trace file and writes its header. The
+                number of frames of the header is written on Close
+
+      Args:     const std::filesystem::path& filePath
+                  Path of the trace file
+                UINT uNumFrames
+                  Number of frames to trace
+
+      Modifies: [m_file, m_objectIds, m_aRecords, m_uNumFrames,
+                 m_uNumWrittenFrames].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG when no frame is requested,
+                  E_FAIL when the file cannot be written
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TracingRenderBackend::Open(_In_ const std::filesystem::path& filePath, _In_ UINT uNumFrames)
+    {
+        if (uNumFrames == 0u)
+        {
+            return E_INVALIDARG;
+        }
+
+        Close();
+
+        m_file.open(filePath, std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            return E_FAIL;
+        }
+
+        const TraceFileHeader header =
+        {
+            .uMagic = TraceFileHeader::TRACE_MAGIC,
+            .uVersion = TraceFileHeader::TRACE_VERSION,
+            .uNumFrames = 0u,
+            .uReserved = 0u,
+        };
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (m_file.fail())
+        {
+            m_file.close();
+            return E_FAIL;
+        }
+
+        m_objectIds.clear();
+        m_aRecords.clear();
+        m_uNumFrames = uNumFrames;
+        m_uNumWrittenFrames = 0u;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::Close
+
+      Summary:  Writes the number of frames traced into the header and
+                closes the file. Does nothing when no file is open
+
+      Modifies: [m_file].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::Close()
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        const std::uint32_t uNumFrames = m_uNumWrittenFrames;
+        m_file.seekp(offsetof(TraceFileHeader, uNumFrames));
+        m_file.write(reinterpret_cast<const char*>(&uNumFrames), sizeof(uNumFrames));
+        m_file.close();
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::IsFinished
+
+      Summary:  Returns whether the trace file is closed, either
+                because every requested frame is written or because it
+                was never opened
+
+      Returns:  BOOL
+                  Whether no more frames are traced
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TracingRenderBackend::IsFinished() const
+    {
+        return !m_file.is_open();
+    }
+
+    const std::shared_ptr<RenderBackend>& TracingRenderBackend::GetBackend() const
+    {
+        return m_backend;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::BeginFrame
+
+      Summary:  Discards the records of commands issued outside of a
+                frame and begins the frame of the traced backend
+
+      Modifies: [m_aRecords].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::BeginFrame()
+    {
+        m_aRecords.clear();
+        m_backend->BeginFrame();
+    }
+
+    void TracingRenderBackend::ClearRenderTarget(_In_ const FLOAT aClearColor[4])
+    {
+        record(eTraceRecordType::CLEAR_RENDER_TARGET, 0u, nullptr);
+        m_backend->ClearRenderTarget(aClearColor);
+    }
+
+    void TracingRenderBackend::ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil)
+    {
+        record(eTraceRecordType::CLEAR_DEPTH_STENCIL, 0u, nullptr, stencil);
+        m_backend->ClearDepthStencil(depth, stencil);
+    }
+
+    void TracingRenderBackend::UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize)
+    {
+        record(eTraceRecordType::UPDATE_BUFFER, 0u, pBuffer, uSize);
+        m_backend->UpdateBuffer(pBuffer, pData, uSize);
+    }
+
+    void TracingRenderBackend::SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology)
+    {
+        record(eTraceRecordType::SET_PRIMITIVE_TOPOLOGY, 0u, nullptr, static_cast<UINT>(topology));
+        m_backend->SetPrimitiveTopology(topology);
+    }
+
+    void TracingRenderBackend::SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset)
+    {
+        record(eTraceRecordType::SET_VERTEX_BUFFER, uSlot, pBuffer, uStride, uOffset);
+        m_backend->SetVertexBuffer(uSlot, pBuffer, uStride, uOffset);
+    }
+
+    void TracingRenderBackend::SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format)
+    {
+        record(eTraceRecordType::SET_INDEX_BUFFER, 0u, pBuffer, static_cast<UINT>(format));
+        m_backend->SetIndexBuffer(pBuffer, format);
+    }
+
+    void TracingRenderBackend::SetInputLayout(_In_ ID3D11InputLayout* pInputLayout)
+    {
+        record(eTraceRecordType::SET_INPUT_LAYOUT, 0u, pInputLayout);
+        m_backend->SetInputLayout(pInputLayout);
+    }
+
+    void TracingRenderBackend::SetVertexShader(_In_ ID3D11VertexShader* pVertexShader)
+    {
+        record(eTraceRecordType::SET_VERTEX_SHADER, 0u, pVertexShader);
+        m_backend->SetVertexShader(pVertexShader);
+    }
+
+    void TracingRenderBackend::SetPixelShader(_In_ ID3D11PixelShader* pPixelShader)
+    {
+        record(eTraceRecordType::SET_PIXEL_SHADER, 0u, pPixelShader);
+        m_backend->SetPixelShader(pPixelShader);
+    }
+
+    void TracingRenderBackend::SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        record(eTraceRecordType::SET_VS_CONSTANT_BUFFER, uSlot, pBuffer);
+        m_backend->SetVertexShaderConstantBuffer(uSlot, pBuffer);
+    }
+
+    void TracingRenderBackend::SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer)
+    {
+        record(eTraceRecordType::SET_PS_CONSTANT_BUFFER, uSlot, pBuffer);
+        m_backend->SetPixelShaderConstantBuffer(uSlot, pBuffer);
+    }
+
+    void TracingRenderBackend::SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        record(eTraceRecordType::SET_VS_SHADER_RESOURCE, uSlot, pShaderResourceView);
+        m_backend->SetVertexShaderResource(uSlot, pShaderResourceView);
+    }
+
+    void TracingRenderBackend::SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView)
+    {
+        record(eTraceRecordType::SET_PS_SHADER_RESOURCE, uSlot, pShaderResourceView);
+        m_backend->SetPixelShaderResource(uSlot, pShaderResourceView);
+    }
+
+    void TracingRenderBackend::SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState)
+    {
+        record(eTraceRecordType::SET_PS_SAMPLER, uSlot, pSamplerState);
+        m_backend->SetPixelShaderSampler(uSlot, pSamplerState);
+    }
+
+    void TracingRenderBackend::SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants)
+    {
+        record(eTraceRecordType::SET_PIPELINE_STATE, 0u, &pipelineState, getObjectId(pObjectConstants));
+        m_backend->SetPipelineState(pipelineState, pObjectConstants);
+    }
+
+    void TracingRenderBackend::Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex)
+    {
+        record(eTraceRecordType::DRAW, 0u, nullptr, uVertexCount, 0u, uStartVertex);
+        m_backend->Draw(uVertexCount, uStartVertex);
+    }
+
+    void TracingRenderBackend::DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex)
+    {
+        record(eTraceRecordType::DRAW_INDEXED, 0u, nullptr, uIndexCount, 1u, uStartIndex);
+        m_backend->DrawIndexed(uIndexCount, uStartIndex, iBaseVertex);
+    }
+
+    void TracingRenderBackend::DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance)
+    {
+        record(eTraceRecordType::DRAW_INDEXED_INSTANCED, 0u, nullptr, uIndexCount, uInstanceCount, uStartIndex);
+        m_backend->DrawIndexedInstanced(uIndexCount, uInstanceCount, uStartIndex, iBaseVertex, uStartInstance);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::ExecuteCommandBuffers
+
+      Summary:  Traces the recorded commands of the command buffers in
+                the order the traced backend executes them, then lets
+                it execute the command buffers its own way, e.g. on
+                deferred contexts
+
+      Args:     const CommandBuffer* const* apCommandBuffers
+                  Command buffers to execute
+                UINT uNumCommandBuffers
+                  Number of command buffers
+
+      Modifies: [m_aRecords, m_objectIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers)
+    {
+        for (UINT i = 0u; i < uNumCommandBuffers; ++i)
+        {
+            for (const RenderCommand& command : apCommandBuffers[i]->GetCommands())
+            {
+                recordCommand(command);
+            }
+        }
+
+        m_backend->ExecuteCommandBuffers(apCommandBuffers, uNumCommandBuffers);
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::Present
+
+      Summary:  Presents through the traced backend and appends the
+                records of the frame to the trace file. The file is
+                closed after the last requested frame
+
+      Modifies: [m_aRecords, m_file, m_uNumWrittenFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::Present()
+    {
+        record(eTraceRecordType::PRESENT, 0u, nullptr);
+        m_backend->Present();
+
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        writeFrame();
+        if (m_file.fail() || m_uNumWrittenFrames >= m_uNumFrames)
+        {
+            Close();
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::record
+
+      Summary:  Appends a record to the frame while a trace is open
+
+      Args:     eTraceRecordType type
+                  Kind of the record
+                UINT uSlot
+                  Register or input slot of a binding
+                const void* pObject
+                  Bound or updated object or pipeline state
+                UINT uArg0, uArg1, uArg2
+                  Arguments, see TraceRecord
+
+      Modifies: [m_aRecords, m_objectIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::record(
+        _In_ eTraceRecordType type,
+        _In_ UINT uSlot,
+        _In_opt_ const void* pObject,
+        _In_ UINT uArg0,
+        _In_ UINT uArg1,
+        _In_ UINT uArg2
+    )
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        m_aRecords.push_back(
+            TraceRecord
+            {
+                .Type = static_cast<std::uint8_t>(type),
+                .uSlot = static_cast<std::uint8_t>(uSlot),
+                .uReserved = 0u,
+                .uObject = getObjectId(pObject),
+                .auArgs = { uArg0, uArg1, uArg2 },
+            }
+        );
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::recordCommand
+
+      Summary:  Appends the record of a command of a command buffer
+
+      Args:     const RenderCommand& command
+                  Recorded command
+
+      Modifies: [m_aRecords, m_objectIds].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::recordCommand(_In_ const RenderCommand& command)
+    {
+        const eTraceRecordType type = static_cast<eTraceRecordType>(command.Type);
+        switch (command.Type)
+        {
+        case eRenderCommandType::UPDATE_BUFFER:
+            record(type, command.uSlot, command.pObject, command.uPayloadSize);
+            break;
+        case eRenderCommandType::SET_PIPELINE_STATE:
+            record(type, command.uSlot, command.pPipelineState, getObjectId(command.pObject));
+            break;
+        default:
+            record(type, command.uSlot, command.pObject, command.auArgs[0], command.auArgs[1], command.auArgs[2]);
+            break;
+        }
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::writeFrame
+
+      Summary:  Writes a FRAME record followed by the records of the
+                frame, then clears them
+
+      Modifies: [m_file, m_aRecords, m_uNumWrittenFrames].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void TracingRenderBackend::writeFrame()
+    {
+        const TraceRecord frame =
+        {
+            .Type = static_cast<std::uint8_t>(eTraceRecordType::FRAME),
+            .uSlot = 0u,
+            .uReserved = 0u,
+            .uObject = 0u,
+            .auArgs = { m_uNumWrittenFrames, static_cast<std::uint32_t>(m_aRecords.size()), 0u },
+        };
+        m_file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+        m_file.write(reinterpret_cast<const char*>(m_aRecords.data()), static_cast<std::streamsize>(m_aRecords.size() * sizeof(TraceRecord)));
+
+        m_aRecords.clear();
+        ++m_uNumWrittenFrames;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TracingRenderBackend::getObjectId
+
+      Summary:  Returns the id of an object, assigning the next one
+                the first time the object is seen
+
+      Args:     const void* pObject
+                  Object, may be nullptr
+
+      Modifies: [m_objectIds].
+
+      Returns:  std::uint32_t
+                  Id of the object, 0 for nullptr
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    std::uint32_t TracingRenderBackend::getObjectId(_In_opt_ const void* pObject)
+    {
+        if (!pObject)
+        {
+            return 0u;
+        }
+
+        return m_objectIds.try_emplace(pObject, static_cast<std::uint32_t>(m_objectIds.size() + 1u)).first->second;
+    }
+}
@@ -0,0 +1,115 @@
+/*+===================================================================
+  File:      TRACINGRENDERBACKEND.H
+
+  Summary:   TracingRenderBackend header file contains declarations of
+             the render backend that writes a binary trace of the
+             commands of a number of frames while forwarding them to
+             another backend.
+
+  Classes: TracingRenderBackend
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include <fstream>
+#include <unordered_map>
+
+#include "Renderer/CommandBuffer.h"
+#include "Renderer/FrameTraceFormat.h"
+#include "Renderer/RenderBackend.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TracingRenderBackend
+
+      Summary:  Forwards every command to the traced backend and also
+                records it as a TraceRecord, with the objects replaced
+                by ids and the uploads by their size. The commands of
+                executed command buffers are traced in order. At
+                Present the records of the frame are appended to the
+                trace file. Once the requested number of frames is
+                written the file is closed and the commands are only
+                forwarded
+
+      Methods:  Open
+                  Creates the trace file
+                Close
+                  Writes the number of frames and closes the file
+                IsFinished
+                  Returns whether every requested frame is written
+                GetBackend
+                  Returns the traced backend
+                BeginFrame .. Present
+                  Forward to the traced backend and record
+                TracingRenderBackend
+                  Constructor.
+                ~TracingRenderBackend
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TracingRenderBackend final : public RenderBackend
+    {
+    public:
+        TracingRenderBackend() = delete;
+        TracingRenderBackend(_In_ const std::shared_ptr<RenderBackend>& backend);
+        TracingRenderBackend(const TracingRenderBackend& other) = delete;
+        TracingRenderBackend(TracingRenderBackend&& other) = delete;
+        TracingRenderBackend& operator=(const TracingRenderBackend& other) = delete;
+        TracingRenderBackend& operator=(TracingRenderBackend&& other) = delete;
+        ~TracingRenderBackend();
+
+        HRESULT Open(_In_ const std::filesystem::path& filePath, _In_ UINT uNumFrames);
+        void Close();
+        BOOL IsFinished() const;
+        const std::shared_ptr<RenderBackend>& GetBackend() const;
+
+        void BeginFrame() override;
+        void ClearRenderTarget(_In_ const FLOAT aClearColor[4]) override;
+        void ClearDepthStencil(_In_ FLOAT depth, _In_ UINT8 stencil) override;
+        void UpdateBuffer(_In_ ID3D11Buffer* pBuffer, _In_reads_bytes_(uSize) const void* pData, _In_ UINT uSize) override;
+
+        void SetPrimitiveTopology(_In_ D3D11_PRIMITIVE_TOPOLOGY topology) override;
+        void SetVertexBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer, _In_ UINT uStride, _In_ UINT uOffset) override;
+        void SetIndexBuffer(_In_ ID3D11Buffer* pBuffer, _In_ DXGI_FORMAT format) override;
+        void SetInputLayout(_In_ ID3D11InputLayout* pInputLayout) override;
+        void SetVertexShader(_In_ ID3D11VertexShader* pVertexShader) override;
+        void SetPixelShader(_In_ ID3D11PixelShader* pPixelShader) override;
+        void SetVertexShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetPixelShaderConstantBuffer(_In_ UINT uSlot, _In_ ID3D11Buffer* pBuffer) override;
+        void SetVertexShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderResource(_In_ UINT uSlot, _In_ ID3D11ShaderResourceView* pShaderResourceView) override;
+        void SetPixelShaderSampler(_In_ UINT uSlot, _In_ ID3D11SamplerState* pSamplerState) override;
+        void SetPipelineState(_In_ const PipelineState& pipelineState, _In_opt_ ID3D11Buffer* pObjectConstants) override;
+
+        void Draw(_In_ UINT uVertexCount, _In_ UINT uStartVertex) override;
+        void DrawIndexed(_In_ UINT uIndexCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex) override;
+        void DrawIndexedInstanced(_In_ UINT uIndexCount, _In_ UINT uInstanceCount, _In_ UINT uStartIndex, _In_ INT iBaseVertex, _In_ UINT uStartInstance) override;
+        void ExecuteCommandBuffers(_In_reads_(uNumCommandBuffers) const CommandBuffer* const* apCommandBuffers, _In_ UINT uNumCommandBuffers) override;
+
+        void Present() override;
+
+    private:
+        void record(
+            _In_ eTraceRecordType type,
+            _In_ UINT uSlot,
+            _In_opt_ const void* pObject,
+            _In_ UINT uArg0 = 0u,
+            _In_ UINT uArg1 = 0u,
+            _In_ UINT uArg2 = 0u
+        );
+        void recordCommand(_In_ const RenderCommand& command);
+        void writeFrame();
+        std::uint32_t getObjectId(_In_opt_ const void* pObject);
+
+    private:
+        std::shared_ptr<RenderBackend> m_backend;
+        std::ofstream m_file;
+        std::unordered_map<const void*, std::uint32_t> m_objectIds;
+        std::vector<TraceRecord> m_aRecords;
+        UINT m_uNumFrames;
+        UINT m_uNumWrittenFrames;
+    };
+}
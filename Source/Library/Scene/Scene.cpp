@@ -1,5 +1,8 @@
 #include "Scene/Scene.h"
 
+#include <algorithm>
+#include <climits>
+
 namespace library
 {
     FLOAT Scene::GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth)
@@ -25,7 +28,36 @@ namespace library
     Scene::Scene(const std::filesystem::path& filePath)
         : m_filePath(filePath)
         , m_voxels()
+        , m_aChunks()
+        , m_pipelineState()
+        , m_uWidth(0u)
+        , m_uHeight(0u)
+        , m_uDepth(0u)
+        , m_bLoaded(FALSE)
     {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::Load
+
+      Summary:  Parses the scene file into voxels and chunks. Touches
+                no Direct3D object, so the renderer runs it on a worker
+                thread before Initialize. Does nothing once parsed
+
+      Modifies: [m_voxels, m_aChunks, m_uWidth, m_uHeight, m_uDepth,
+                 m_bLoaded].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Scene::Load()
+    {
+        if (m_bLoaded)
+        {
+            return S_OK;
+        }
+        m_bLoaded = TRUE;
+
         std::ifstream inputFile;
         inputFile.open(m_filePath.string());
 
@@ -74,16 +106,30 @@ namespace library
             }
         }
 
-        std::vector<std::vector<InstanceData>> aInstanceData;
+        m_uWidth = aDimension[0];
+        m_uHeight = aDimension[1];
+        m_uDepth = aDimension[2];
+
+        const UINT uNumChunksX = (m_uWidth + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+        const UINT uNumChunksZ = (m_uDepth + CHUNK_SIZE - 1u) / CHUNK_SIZE;
+        const size_t numChunks = static_cast<size_t>(uNumChunksX) * static_cast<size_t>(uNumChunksZ);
+
+        std::vector<InstanceDataVector> aInstanceData;
+        std::vector<std::vector<UINT>> aInstanceChunks;
         aInstanceData.reserve(m_voxels.size());
+        aInstanceChunks.reserve(m_voxels.size());
         for (UINT renderableIdx = 0u; renderableIdx < m_voxels.size(); ++renderableIdx)
         {
-            aInstanceData.push_back(std::vector<InstanceData>());
+            aInstanceData.push_back(InstanceDataVector());
             aInstanceData.back().reserve(
                 static_cast<size_t>(aDimension[0]) * static_cast<size_t>(aDimension[1]) * static_cast<size_t>(aDimension[2])
             );
+            aInstanceChunks.push_back(std::vector<UINT>());
         }
 
+        // Number of stacked blocks of every column, used for the chunk bounds and occluders
+        std::vector<UINT> aColumnHeights(static_cast<size_t>(m_uWidth) * static_cast<size_t>(m_uDepth), 0u);
+
         UINT uDepthIdx = 0u;
         UINT uWidthIdx = 0u;
         CHAR voxelType;
@@ -103,9 +149,12 @@ namespace library
             }
             else if (static_cast<CHAR>(eBlockType::GRASSLAND) <= voxelType && voxelType < static_cast<CHAR>(eBlockType::COUNT))
             {
-                for (UINT heightIdx = 0; heightIdx < static_cast<UINT>(static_cast<float>(aDimension[1]) * height); ++heightIdx)
+                const size_t voxelIdx = static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND);
+                const UINT uNumBlocks = static_cast<UINT>(static_cast<float>(aDimension[1]) * height);
+                const UINT uChunkIdx = (uDepthIdx / CHUNK_SIZE) * uNumChunksX + (uWidthIdx / CHUNK_SIZE);
+                for (UINT heightIdx = 0; heightIdx < uNumBlocks; ++heightIdx)
                 {
-                    aInstanceData[static_cast<size_t>(voxelType) - static_cast<size_t>(eBlockType::GRASSLAND)].push_back(
+                    aInstanceData[voxelIdx].push_back(
                         InstanceData
                         {
                             .Transformation = XMMatrixTranslation(
@@ -115,7 +164,10 @@ namespace library
                                 )
                         }
                     );
+                    aInstanceChunks[voxelIdx].push_back(uChunkIdx);
                 }
+                aColumnHeights[static_cast<size_t>(uDepthIdx) * m_uWidth + uWidthIdx] = uNumBlocks;
+
                 ++uWidthIdx;
                 if (uWidthIdx >= aDimension[0])
                 {
@@ -132,6 +184,68 @@ namespace library
 
         inputFile.close();
 
+        // Chunk bounds and occluders
+        m_aChunks.resize(numChunks);
+        for (UINT uChunkZ = 0u; uChunkZ < uNumChunksZ; ++uChunkZ)
+        {
+            for (UINT uChunkX = 0u; uChunkX < uNumChunksX; ++uChunkX)
+            {
+                const UINT uMinWidthIdx = uChunkX * CHUNK_SIZE;
+                const UINT uMaxWidthIdx = std::min(uMinWidthIdx + CHUNK_SIZE, m_uWidth) - 1u;
+                const UINT uMinDepthIdx = uChunkZ * CHUNK_SIZE;
+                const UINT uMaxDepthIdx = std::min(uMinDepthIdx + CHUNK_SIZE, m_uDepth) - 1u;
+
+                UINT uMinBlocks = UINT_MAX;
+                UINT uMaxBlocks = 0u;
+                for (UINT d = uMinDepthIdx; d <= uMaxDepthIdx; ++d)
+                {
+                    for (UINT w = uMinWidthIdx; w <= uMaxWidthIdx; ++w)
+                    {
+                        const UINT uNumBlocks = aColumnHeights[static_cast<size_t>(d) * m_uWidth + w];
+                        uMinBlocks = std::min(uMinBlocks, uNumBlocks);
+                        uMaxBlocks = std::max(uMaxBlocks, uNumBlocks);
+                    }
+                }
+
+                SceneChunk& chunk = m_aChunks[static_cast<size_t>(uChunkZ) * uNumChunksX + uChunkX];
+                chunk.Bounds = getColumnsBounds(uMinWidthIdx, uMaxWidthIdx, uMinDepthIdx, uMaxDepthIdx, uMaxBlocks);
+                chunk.bHasOccluder = uMinBlocks > 0u;
+                chunk.OccluderBounds = getColumnsBounds(uMinWidthIdx, uMaxWidthIdx, uMinDepthIdx, uMaxDepthIdx, uMinBlocks);
+            }
+        }
+
+        // Sort the instances of every voxel by chunk so each chunk can be drawn as one instance range
+        std::vector<std::vector<InstanceRange>> aChunkRanges(aInstanceData.size());
+        for (size_t voxelIdx = 0u; voxelIdx < aInstanceData.size(); ++voxelIdx)
+        {
+            std::vector<InstanceRange>& aRanges = aChunkRanges[voxelIdx];
+            aRanges.assign(numChunks, InstanceRange{ .uStartInstance = 0u, .uNumInstances = 0u });
+            for (UINT uChunkIdx : aInstanceChunks[voxelIdx])
+            {
+                ++aRanges[uChunkIdx].uNumInstances;
+            }
+
+            UINT uStart = 0u;
+            for (InstanceRange& range : aRanges)
+            {
+                range.uStartInstance = uStart;
+                uStart += range.uNumInstances;
+            }
+
+            std::vector<UINT> aCursors(numChunks);
+            for (size_t chunkIdx = 0u; chunkIdx < numChunks; ++chunkIdx)
+            {
+                aCursors[chunkIdx] = aRanges[chunkIdx].uStartInstance;
+            }
+
+            InstanceDataVector aSorted(aInstanceData[voxelIdx].size());
+            for (size_t instanceIdx = 0u; instanceIdx < aInstanceData[voxelIdx].size(); ++instanceIdx)
+            {
+                aSorted[aCursors[aInstanceChunks[voxelIdx][instanceIdx]]++] = aInstanceData[voxelIdx][instanceIdx];
+            }
+            aInstanceData[voxelIdx] = std::move(aSorted);
+        }
+
         UINT uVoxelIdx = 0u;
         auto it = m_voxels.begin();
         while (it != m_voxels.end())
@@ -143,17 +257,34 @@ namespace library
             else
             {
                 (*it)->SetInstanceData(std::move(aInstanceData[uVoxelIdx]));
+                for (size_t chunkIdx = 0u; chunkIdx < numChunks; ++chunkIdx)
+                {
+                    m_aChunks[chunkIdx].aInstanceRanges.push_back(aChunkRanges[uVoxelIdx][chunkIdx]);
+                }
                 ++it;
             }
             ++uVoxelIdx;
         }
+
+        if (m_pipelineState)
+        {
+            SetPipelineState(m_pipelineState);
+        }
+
+        return S_OK;
     }
 
     HRESULT Scene::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
+        HRESULT hr = Load();
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
         for (auto voxel : m_voxels)
         {
-            HRESULT hr = voxel->Initialize(pDevice, pImmediateContext);
+            hr = voxel->Initialize(pDevice, pImmediateContext);
             if (FAILED(hr))
             {
                 return hr;
@@ -163,11 +294,37 @@ namespace library
         return S_OK;
     }
     
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Scene::SetPipelineState
+
+      Summary:  Sets the pipeline state of the voxels, kept for the
+                voxels of a scene not parsed yet
+
+      Args:     const std::shared_ptr<PipelineState>& pipelineState
+                  Pipeline state drawing the voxels
+
+      Modifies: [m_pipelineState, m_voxels].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    void Scene::SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState)
+    {
+        m_pipelineState = pipelineState;
+
+        for (const std::shared_ptr<Voxel>& voxel : m_voxels)
+        {
+            voxel->SetPipelineState(pipelineState);
+        }
+    }
+
     std::vector<std::shared_ptr<Voxel>>& Scene::GetVoxels()
     {
         return m_voxels;
     }
     
+    const std::vector<SceneChunk>& Scene::GetChunks() const
+    {
+        return m_aChunks;
+    }
+
     const std::filesystem::path& Scene::GetFilePath() const
     {
         return m_filePath;
@@ -212,4 +369,26 @@ namespace library
     {
         return lerp(x, y, s * s * (3.0f - 2.0f * s));
     }
+
+    AxisAlignedBox Scene::getColumnsBounds(UINT uMinWidthIdx, UINT uMaxWidthIdx, UINT uMinDepthIdx, UINT uMaxDepthIdx, UINT uNumBlocks) const
+    {
+        // Same placement as the instance translations, voxels extend 1 unit around their center
+        const FLOAT halfWidth = static_cast<FLOAT>(m_uWidth) / 2.0f;
+        const FLOAT halfDepth = static_cast<FLOAT>(m_uDepth) / 2.0f;
+        const FLOAT baseY = (static_cast<FLOAT>(m_uHeight) * 0.75f) - 2.0f * static_cast<FLOAT>(m_uHeight);
+
+        return AxisAlignedBox
+        {
+            .Min = XMFLOAT3(
+                2.0f * (static_cast<FLOAT>(uMinWidthIdx) - halfWidth) - 1.0f,
+                baseY - 1.0f,
+                2.0f * (static_cast<FLOAT>(uMinDepthIdx) - halfDepth) - 1.0f
+            ),
+            .Max = XMFLOAT3(
+                2.0f * (static_cast<FLOAT>(uMaxWidthIdx) - halfWidth) + 1.0f,
+                baseY + 2.0f * static_cast<FLOAT>(uNumBlocks) - 1.0f,
+                2.0f * (static_cast<FLOAT>(uMaxDepthIdx) - halfDepth) + 1.0f
+            )
+        };
+    }
 }
\ No newline at end of file
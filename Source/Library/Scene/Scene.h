@@ -20,9 +20,39 @@
 
 namespace library
 {
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   InstanceRange
+
+        Summary:  Contiguous range of instances of one voxel
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct InstanceRange
+    {
+        UINT uStartInstance;
+        UINT uNumInstances;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+        Struct:   SceneChunk
+
+        Summary:  Square group of terrain columns. Bounds encloses every
+                  block of the chunk, OccluderBounds is the solid part
+                  below the lowest column and is only valid when
+                  bHasOccluder is set. aInstanceRanges holds one range
+                  per voxel returned by Scene::GetVoxels
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct SceneChunk
+    {
+        AxisAlignedBox Bounds;
+        AxisAlignedBox OccluderBounds;
+        BOOL bHasOccluder;
+        std::vector<InstanceRange> aInstanceRanges;
+    };
+
     class Scene
     {
     public:
+        static constexpr UINT CHUNK_SIZE = 16u;
+
         static FLOAT GetPerlin2d(FLOAT x, FLOAT y, FLOAT frequency, UINT uDepth);
 
         Scene(const std::filesystem::path& filePath);
@@ -32,9 +62,12 @@ namespace library
         Scene& operator=(Scene&& other) = delete;
         virtual ~Scene() = default;
 
+        HRESULT Load();
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
+        void SetPipelineState(_In_ const std::shared_ptr<PipelineState>& pipelineState);
 
         std::vector<std::shared_ptr<Voxel>>& GetVoxels();
+        const std::vector<SceneChunk>& GetChunks() const;
         const std::filesystem::path& GetFilePath() const;
         PCWSTR GetFileName() const;
 
@@ -44,6 +77,8 @@ namespace library
         static FLOAT lerp(FLOAT x, FLOAT y, FLOAT s);
         static FLOAT smoothLerp(FLOAT x, FLOAT y, FLOAT s);
 
+        AxisAlignedBox getColumnsBounds(UINT uMinWidthIdx, UINT uMaxWidthIdx, UINT uMinDepthIdx, UINT uMaxDepthIdx, UINT uNumBlocks) const;
+
     private:
         static constexpr const UINT ms_aHashes[] =
         {
@@ -64,5 +99,11 @@ namespace library
     private:
         std::filesystem::path m_filePath;
         std::vector<std::shared_ptr<Voxel>> m_voxels;
+        std::vector<SceneChunk> m_aChunks;
+        std::shared_ptr<PipelineState> m_pipelineState;
+        UINT m_uWidth;
+        UINT m_uHeight;
+        UINT m_uDepth;
+        BOOL m_bLoaded;
     };
 }
\ No newline at end of file
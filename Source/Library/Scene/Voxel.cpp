@@ -21,12 +21,12 @@ namespace library
 
       Summary:  Constructor
 
-      Args:     std::vector<InstanceData>&& aInstanceData
+      Args:     InstanceDataVector&& aInstanceData
                   Instance data
                 const XMFLOAT4& outputColor
                   Color of the voxel
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
-    Voxel::Voxel(_In_ std::vector<InstanceData>&& aInstanceData, _In_ const XMFLOAT4& outputColor) :
+    Voxel::Voxel(_In_ InstanceDataVector&& aInstanceData, _In_ const XMFLOAT4& outputColor) :
         InstancedRenderable(std::move(aInstanceData), outputColor)
 
     {};
@@ -0,0 +1,80 @@
+#include "Shader/DebugVertexShader.h"
+
+#include "Renderer/DataTypes.h"
+
+namespace library
+{
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DebugVertexShader::DebugVertexShader
+
+	  Summary:  Constructor
+
+	  Args:     PCWSTR pszFileName
+				  Name of the file that contains the shader code
+				PCSTR pszEntryPoint
+				  Name of the shader entry point function where shader
+				  execution begins
+				PCSTR pszShaderModel
+				  Specifies the shader target or set of shader features
+				  to compile against
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	DebugVertexShader::DebugVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel)
+		: VertexShader(pszFileName, pszEntryPoint, pszShaderModel)
+	{
+	}
+
+	/*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+	  Method:   DebugVertexShader::Initialize
+
+	  Summary:  Initializes the vertex shader and the input layout of
+				DebugVertex
+
+	  Args:     ID3D11Device* pDevice
+				  The Direct3D device to create the vertex shader
+
+	  Modifies: [m_vertexShader, m_vertexLayout].
+
+	  Returns:  HRESULT
+				  Status code
+	M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+	HRESULT DebugVertexShader::Initialize(_In_ ID3D11Device* pDevice)
+	{
+		ComPtr<ID3DBlob> vsBlob;
+		HRESULT hr = compile(vsBlob.GetAddressOf());
+		if (FAILED(hr))
+		{
+			WCHAR szMessage[256];
+			swprintf_s(
+				szMessage,
+				L"The FX file %s cannot be compiled. Please run this executable from the directory that contains the FX file.",
+				m_pszFileName
+			);
+			MessageBox(
+				nullptr,
+				szMessage,
+				L"Error",
+				MB_OK
+			);
+			return hr;
+		}
+
+		hr = pDevice->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, m_vertexShader.GetAddressOf());
+		if (FAILED(hr))
+		{
+			return hr;
+		}
+
+		// Define the input layout
+		D3D11_INPUT_ELEMENT_DESC aLayouts[] =
+		{
+			{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+			{ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, offsetof(DebugVertex, uColor), D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		};
+		UINT uNumElements = ARRAYSIZE(aLayouts);
+
+		// Create the input layout
+		hr = pDevice->CreateInputLayout(aLayouts, uNumElements, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), m_vertexLayout.GetAddressOf());
+
+		return hr;
+	}
+}
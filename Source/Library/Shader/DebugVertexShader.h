@@ -0,0 +1,46 @@
+/*+===================================================================
+  File:      DEBUGVERTEXSHADER.H
+
+  Summary:   DebugVertexShader header file contains declarations of
+             DebugVertexShader class, the vertex shader of the lines
+             and triangles of the debug drawing.
+
+  Classes: DebugVertexShader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    DebugVertexShader
+
+      Summary:  Vertex shader reading DebugVertex, a world space
+                position and a packed color
+
+      Methods:  Initialize
+                  Initializes the vertex shader and the input layout
+                DebugVertexShader
+                  Constructor.
+                ~DebugVertexShader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class DebugVertexShader : public VertexShader
+    {
+    public:
+        DebugVertexShader() = delete;
+        DebugVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        DebugVertexShader(const DebugVertexShader& other) = delete;
+        DebugVertexShader(DebugVertexShader&& other) = delete;
+        DebugVertexShader& operator=(const DebugVertexShader& other) = delete;
+        DebugVertexShader& operator=(DebugVertexShader&& other) = delete;
+        virtual ~DebugVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
@@ -0,0 +1,48 @@
+/*+===================================================================
+  File:      INSTANCEDVERTEXSHADER.H
+
+  Summary:   InstancedVertexShader header file contains declarations of
+             InstancedVertexShader class, the vertex shader drawing many
+             copies of a renderable in one instanced draw.
+
+  Classes: InstancedVertexShader
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Shader/VertexShader.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    InstancedVertexShader
+
+      Summary:  Vertex shader reading the world matrix and the output
+                color of every instance from a second vertex buffer of
+                RenderableInstanceData, instead of the constant buffer
+                of the renderable
+
+      Methods:  Initialize
+                  Initializes the vertex shader and the input layout
+                InstancedVertexShader
+                  Constructor.
+                ~InstancedVertexShader
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class InstancedVertexShader : public VertexShader
+    {
+    public:
+        InstancedVertexShader() = delete;
+        InstancedVertexShader(_In_ PCWSTR pszFileName, _In_ PCSTR pszEntryPoint, _In_ PCSTR pszShaderModel);
+        InstancedVertexShader(const InstancedVertexShader& other) = delete;
+        InstancedVertexShader(InstancedVertexShader&& other) = delete;
+        InstancedVertexShader& operator=(const InstancedVertexShader& other) = delete;
+        InstancedVertexShader& operator=(InstancedVertexShader&& other) = delete;
+        virtual ~InstancedVertexShader() = default;
+
+        virtual HRESULT Initialize(_In_ ID3D11Device* pDevice) override;
+    };
+}
@@ -42,7 +42,9 @@ namespace library
 			{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 20, D3D11_INPUT_PER_VERTEX_DATA, 0 },
 
 			{ "BONEINDICES", 0, DXGI_FORMAT_R32G32B32A32_UINT, 1, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
-			{ "BONEWEIGHTS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 }
+			{ "BONEWEIGHTS", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+
+			{ "TEXSLICE", 0, DXGI_FORMAT_R32_UINT, 2, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 }
 		};
 		UINT uNumElements = ARRAYSIZE(aLayouts);
 
@@ -1,6 +1,6 @@
 #include "Texture.h"
 
-#include "Texture/WICTextureLoader.h"
+#include <fstream>
 
 namespace library
 {
@@ -12,36 +12,131 @@ namespace library
       Args:     const std::filesystem::path& textureFilePath
                   Path to the texture to use
 
-      Modifies: [m_filePath, m_textureRV, m_samplerLinear].
+      Modifies: [m_filePath, m_aFileData, m_image, m_textureRV,
+                 m_samplerLinear].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Texture::Texture definition (remove the comment)
     --------------------------------------------------------------------*/
     Texture::Texture(_In_ const std::filesystem::path& filePath) :
         m_filePath(filePath),
+        m_aFileData(),
+        m_image(),
         m_textureRV(nullptr),
         m_samplerLinear(nullptr)
 
     {};
 
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Load
+
+      Summary:  Reads the texture file into memory. Touches no Direct3D
+                object, so the asset loader runs it on its own threads
+                before Initialize. Does nothing once the file is read or
+                decoded
+
+      Modifies: [m_aFileData].
+
+      Returns:  HRESULT
+                  Status code, E_FAIL if the file could not be read
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Load()
+    {
+        if (!m_aFileData.empty() || !m_image.aPixels.empty())
+        {
+            return S_OK;
+        }
+
+        std::ifstream file(m_filePath, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return E_FAIL;
+        }
+
+        const std::streamoff fileSize = file.tellg();
+        if (fileSize <= 0)
+        {
+            return E_FAIL;
+        }
+
+        m_aFileData.resize(static_cast<size_t>(fileSize));
+        file.seekg(0, std::ios::beg);
+        if (!file.read(reinterpret_cast<char*>(m_aFileData.data()), fileSize))
+        {
+            m_aFileData.clear();
+            return E_FAIL;
+        }
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::Decode
+
+      Summary:  Reads the texture file if Load was not called, then
+                decodes it into the pixels of the texture. Only queries
+                the device for the supported formats, so textures are
+                decoded on any thread and several at once. Does nothing
+                once decoded
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device the texture will be created by
+
+      Modifies: [m_aFileData, m_image].
+
+      Returns:  HRESULT
+                  Status code
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT Texture::Decode(_In_ ID3D11Device* pDevice)
+    {
+        if (!m_image.aPixels.empty())
+        {
+            return S_OK;
+        }
+
+        HRESULT hr = Load();
+        if (FAILED(hr))
+            return hr;
+
+        hr = DecodeWICTextureFromMemory(pDevice, m_aFileData.data(), m_aFileData.size(), m_image);
+        if (FAILED(hr))
+            return hr;
+
+        // The pixels are kept until Initialize, the file is no longer needed
+        m_aFileData.clear();
+        m_aFileData.shrink_to_fit();
+
+        return S_OK;
+    }
+
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::Initialize
 
-      Summary:  Initializes the texture
+      Summary:  Initializes the texture from the pixels decoded by
+                Decode, reading and decoding the file first when it was
+                not called
 
       Args:     ID3D11Device* pDevice
                   The Direct3D device to create the buffers
                 ID3D11DeviceContext* pImmediateContext
                   The Direct3D context to set buffers
 
-      Modifies: [m_textureRV, m_samplerLinear].
+      Modifies: [m_aFileData, m_image, m_textureRV, m_samplerLinear].
     M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
     /*--------------------------------------------------------------------
       TODO: Texture::Initialize definition (remove the comment)
     --------------------------------------------------------------------*/
     HRESULT Texture::Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext)
     {
-        HRESULT hr = CreateWICTextureFromFile(pDevice, pImmediateContext, m_filePath.c_str(), nullptr, m_textureRV.GetAddressOf());
+        HRESULT hr = Decode(pDevice);
+        if (FAILED(hr))
+            return hr;
+
+        hr = CreateWICTextureFromImage(pDevice, pImmediateContext, m_image, nullptr, m_textureRV.GetAddressOf());
+
+        // The texture holds the pixels, they are no longer needed
+        m_image.aPixels.clear();
+        m_image.aPixels.shrink_to_fit();
 
         if (FAILED(hr))
             return hr;
@@ -63,6 +158,7 @@ namespace library
         if (FAILED(hr))
             return hr;
 
+        return S_OK;
     }
     /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
       Method:   Texture::GetTextureResourceView
@@ -89,4 +185,46 @@ namespace library
     {
         return m_samplerLinear;
     }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetFilePath
+
+      Summary:  Returns the path of the texture file
+
+      Returns:  const std::filesystem::path&
+                  Path to the texture file
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    const std::filesystem::path& Texture::GetFilePath() const
+    {
+        return m_filePath;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   Texture::GetTextureDesc
+
+      Summary:  Returns the description of the loaded texture
+
+      Returns:  D3D11_TEXTURE2D_DESC
+                  Description of the texture, zeroed if it is not a
+                  loaded 2D texture
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    D3D11_TEXTURE2D_DESC Texture::GetTextureDesc() const
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        if (!m_textureRV)
+        {
+            return desc;
+        }
+
+        ComPtr<ID3D11Resource> resource;
+        m_textureRV->GetResource(resource.GetAddressOf());
+
+        ComPtr<ID3D11Texture2D> texture;
+        if (SUCCEEDED(resource.As(&texture)))
+        {
+            texture->GetDesc(&desc);
+        }
+
+        return desc;
+    }
 }
\ No newline at end of file
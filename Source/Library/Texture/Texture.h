@@ -12,6 +12,9 @@
 
 #include "Common.h"
 
+#include "Memory/MemoryTracker.h"
+#include "Texture/WICTextureLoader.h"
+
 namespace library
 {
     class Texture
@@ -25,14 +28,24 @@ namespace library
         Texture& operator=(Texture&& other) = delete;
         virtual ~Texture() = default;
 
+        // Reads the file without touching Direct3D, optional before Initialize
+        HRESULT Load();
+
+        // Reads the file if needed and decodes it without the context, optional before Initialize
+        HRESULT Decode(_In_ ID3D11Device* pDevice);
+
         // Should be called once to load the texture
         virtual HRESULT Initialize(_In_ ID3D11Device* pDevice, _In_ ID3D11DeviceContext* pImmediateContext);
 
         ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
         ComPtr<ID3D11SamplerState>& GetSamplerState();
+        const std::filesystem::path& GetFilePath() const;
+        D3D11_TEXTURE2D_DESC GetTextureDesc() const;
 
     private:
         std::filesystem::path m_filePath;
+        TaggedVector<BYTE, eMemoryTag::TEXTURE> m_aFileData;
+        WICTextureImage m_image;
         ComPtr<ID3D11ShaderResourceView> m_textureRV;
         ComPtr<ID3D11SamplerState> m_samplerLinear;
     };
@@ -0,0 +1,188 @@
+#include "Texture/TextureArray.h"
+
+namespace library
+{
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::TextureArray
+
+      Summary:  Constructor
+
+      Modifies: [m_texture, m_textureRV, m_samplerLinear, m_uNumSlices].
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    TextureArray::TextureArray()
+        : m_texture()
+        , m_textureRV()
+        , m_samplerLinear()
+        , m_uNumSlices(0u)
+    {
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::Initialize
+
+      Summary:  Creates the array with the description of the first
+                texture, then copies every mip level of every texture
+                into its slice on the GPU
+
+      Args:     ID3D11Device* pDevice
+                  The Direct3D device to create the array
+                ID3D11DeviceContext* pImmediateContext
+                  The Direct3D context to copy the textures
+                const std::vector<std::shared_ptr<Texture>>& textures
+                  Initialized textures, compatible with each other. The
+                  slice of a texture is its index in the vector
+
+      Modifies: [m_texture, m_textureRV, m_samplerLinear, m_uNumSlices].
+
+      Returns:  HRESULT
+                  Status code, E_INVALIDARG if the textures do not fit
+                  in one array
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    HRESULT TextureArray::Initialize(
+        _In_ ID3D11Device* pDevice,
+        _In_ ID3D11DeviceContext* pImmediateContext,
+        _In_ const std::vector<std::shared_ptr<Texture>>& textures
+    )
+    {
+        HRESULT hr = S_OK;
+
+        if (textures.empty() || textures.size() > MAX_NUM_SLICES)
+        {
+            return E_INVALIDARG;
+        }
+
+        D3D11_TEXTURE2D_DESC sliceDesc = textures[0]->GetTextureDesc();
+        for (const std::shared_ptr<Texture>& texture : textures)
+        {
+            if (!AreCompatible(texture->GetTextureDesc(), sliceDesc))
+            {
+                return E_INVALIDARG;
+            }
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {
+            .Width = sliceDesc.Width,
+            .Height = sliceDesc.Height,
+            .MipLevels = sliceDesc.MipLevels,
+            .ArraySize = static_cast<UINT>(textures.size()),
+            .Format = sliceDesc.Format,
+            .SampleDesc = { .Count = 1u, .Quality = 0u },
+            .Usage = D3D11_USAGE_DEFAULT,
+            .BindFlags = D3D11_BIND_SHADER_RESOURCE,
+            .CPUAccessFlags = 0u,
+            .MiscFlags = 0u,
+        };
+        hr = pDevice->CreateTexture2D(&desc, nullptr, m_texture.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        for (UINT uSlice = 0u; uSlice < desc.ArraySize; ++uSlice)
+        {
+            ComPtr<ID3D11Resource> source;
+            textures[uSlice]->GetTextureResourceView()->GetResource(source.GetAddressOf());
+
+            for (UINT uMip = 0u; uMip < desc.MipLevels; ++uMip)
+            {
+                pImmediateContext->CopySubresourceRegion(
+                    m_texture.Get(),
+                    D3D11CalcSubresource(uMip, uSlice, desc.MipLevels),
+                    0u,
+                    0u,
+                    0u,
+                    source.Get(),
+                    uMip,
+                    nullptr
+                );
+            }
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {
+            .Format = desc.Format,
+            .ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY,
+            .Texture2DArray = {
+                .MostDetailedMip = 0u,
+                .MipLevels = desc.MipLevels,
+                .FirstArraySlice = 0u,
+                .ArraySize = desc.ArraySize,
+            },
+        };
+        hr = pDevice->CreateShaderResourceView(m_texture.Get(), &srvDesc, m_textureRV.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        D3D11_SAMPLER_DESC sampDesc =
+        {
+            .Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+            .AddressU = D3D11_TEXTURE_ADDRESS_WRAP,
+            .AddressV = D3D11_TEXTURE_ADDRESS_WRAP,
+            .AddressW = D3D11_TEXTURE_ADDRESS_WRAP,
+            .ComparisonFunc = D3D11_COMPARISON_NEVER,
+            .MinLOD = 0,
+            .MaxLOD = D3D11_FLOAT32_MAX
+        };
+        hr = pDevice->CreateSamplerState(&sampDesc, m_samplerLinear.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+            return hr;
+
+        m_uNumSlices = desc.ArraySize;
+
+        return S_OK;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::GetTextureResourceView
+
+      Summary:  Returns the view of the whole array
+
+      Returns:  ComPtr<ID3D11ShaderResourceView>&
+                  Shader resource view
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11ShaderResourceView>& TextureArray::GetTextureResourceView()
+    {
+        return m_textureRV;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::GetSamplerState
+
+      Summary:  Returns the sampler state
+
+      Returns:  ComPtr<ID3D11SamplerState>&
+                  Sampler state
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    ComPtr<ID3D11SamplerState>& TextureArray::GetSamplerState()
+    {
+        return m_samplerLinear;
+    }
+
+    UINT TextureArray::GetNumSlices() const
+    {
+        return m_uNumSlices;
+    }
+
+    /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+      Method:   TextureArray::AreCompatible
+
+      Summary:  Returns whether two textures can be copied into the same
+                array
+
+      Args:     const D3D11_TEXTURE2D_DESC& a
+                  Description of the first texture
+                const D3D11_TEXTURE2D_DESC& b
+                  Description of the second texture
+
+      Returns:  BOOL
+                  Whether the size, format and mip levels match
+    M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+    BOOL TextureArray::AreCompatible(_In_ const D3D11_TEXTURE2D_DESC& a, _In_ const D3D11_TEXTURE2D_DESC& b)
+    {
+        return a.Width == b.Width &&
+            a.Height == b.Height &&
+            a.MipLevels == b.MipLevels &&
+            a.Format == b.Format &&
+            a.ArraySize == 1u &&
+            b.ArraySize == 1u &&
+            a.SampleDesc.Count == 1u &&
+            b.SampleDesc.Count == 1u;
+    }
+}
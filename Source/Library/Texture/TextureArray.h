@@ -0,0 +1,75 @@
+/*+===================================================================
+  File:      TEXTUREARRAY.H
+
+  Summary:   TextureArray header file contains declaration of class
+             TextureArray used to bind several textures of the same
+             size and format as one Texture2DArray.
+
+  Classes:  TextureArray
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+#pragma once
+
+#include "Common.h"
+
+#include "Texture/Texture.h"
+
+namespace library
+{
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    TextureArray
+
+      Summary:  Texture2DArray holding a copy of loaded textures, one
+                slice each with all its mip levels. The textures must
+                have the same size, format and number of mip levels, so
+                meshes sampling any of them share one binding and pick
+                their slice in the shader
+
+      Methods:  Initialize
+                  Creates the array and copies the textures into it
+                GetTextureResourceView
+                  Returns the view of the array
+                GetSamplerState
+                  Returns the sampler state
+                GetNumSlices
+                  Returns the number of slices
+                AreCompatible
+                  Returns whether two textures fit in the same array
+                TextureArray
+                  Constructor.
+                ~TextureArray
+                  Destructor.
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class TextureArray final
+    {
+    public:
+        static constexpr UINT MAX_NUM_SLICES = D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION;
+
+    public:
+        TextureArray();
+        TextureArray(const TextureArray& other) = delete;
+        TextureArray(TextureArray&& other) = delete;
+        TextureArray& operator=(const TextureArray& other) = delete;
+        TextureArray& operator=(TextureArray&& other) = delete;
+        ~TextureArray() = default;
+
+        HRESULT Initialize(
+            _In_ ID3D11Device* pDevice,
+            _In_ ID3D11DeviceContext* pImmediateContext,
+            _In_ const std::vector<std::shared_ptr<Texture>>& textures
+        );
+
+        ComPtr<ID3D11ShaderResourceView>& GetTextureResourceView();
+        ComPtr<ID3D11SamplerState>& GetSamplerState();
+        UINT GetNumSlices() const;
+
+        static BOOL AreCompatible(_In_ const D3D11_TEXTURE2D_DESC& a, _In_ const D3D11_TEXTURE2D_DESC& b);
+
+    private:
+        ComPtr<ID3D11Texture2D> m_texture;
+        ComPtr<ID3D11ShaderResourceView> m_textureRV;
+        ComPtr<ID3D11SamplerState> m_samplerLinear;
+        UINT m_uNumSlices;
+    };
+}
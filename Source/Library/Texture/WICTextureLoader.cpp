@@ -38,6 +38,7 @@
 
 #include <memory>
 
+#include "Memory/MemoryTracker.h"
 #include "Texture/WICTextureLoader.h"
 
 #if (_WIN32_WINNT >= 0x0602 /*_WIN32_WINNT_WIN8*/) && !defined(DXGI_1_2_FORMATS)
@@ -201,24 +202,20 @@ static WICConvert g_WICConvert[] =
 //--------------------------------------------------------------------------------------
 static IWICImagingFactory* _GetWIC()
 {
-    static IWICImagingFactory* s_Factory = nullptr;
-
-    if (s_Factory)
-        return s_Factory;
-
-    HRESULT hr = CoCreateInstance(
-        CLSID_WICImagingFactory,
-        nullptr,
-        CLSCTX_INPROC_SERVER,
-        __uuidof(IWICImagingFactory),
-        (LPVOID*)&s_Factory
-    );
-
-    if (FAILED(hr))
+    // Textures are decoded on several threads at once, the static is initialized once
+    static IWICImagingFactory* const s_Factory = []() -> IWICImagingFactory*
     {
-        s_Factory = nullptr;
-        return nullptr;
-    }
+        IWICImagingFactory* pFactory = nullptr;
+        HRESULT hr = CoCreateInstance(
+            CLSID_WICImagingFactory,
+            nullptr,
+            CLSCTX_INPROC_SERVER,
+            __uuidof(IWICImagingFactory),
+            (LPVOID*)&pFactory
+        );
+
+        return SUCCEEDED(hr) ? pFactory : nullptr;
+    }();
 
     return s_Factory;
 }
@@ -265,11 +262,9 @@ static size_t _WICBitsPerPixel(REFGUID targetGuid)
 }
 
 //---------------------------------------------------------------------------------
-static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
-    _In_opt_ ID3D11DeviceContext* d3dContext,
+static HRESULT DecodeTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     _In_ IWICBitmapFrameDecode* frame,
-    _Out_opt_ ID3D11Resource** texture,
-    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_ WICTextureImage& image,
     _In_ size_t maxsize)
 {
     UINT width, height;
@@ -381,11 +376,12 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
         bpp = 32;
     }
 
-    // Allocate temporary memory for image
+    // Allocate the memory of the decoded image
     size_t rowPitch = (twidth * bpp + 7) / 8;
     size_t imageSize = rowPitch * theight;
 
-    std::unique_ptr<uint8_t[]> temp(new uint8_t[imageSize]);
+    image.aPixels.resize(imageSize);
+    uint8_t* pixels = image.aPixels.data();
 
     // Load image data
     if (memcmp(&convertGUID, &pixelFormat, sizeof(GUID)) == 0
@@ -393,7 +389,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
         && theight == height)
     {
         // No format conversion or resize needed
-        hr = frame->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
+        hr = frame->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
         if (FAILED(hr))
             return hr;
     }
@@ -421,7 +417,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
         if (memcmp(&convertGUID, &pfScaler, sizeof(GUID)) == 0)
         {
             // No format conversion needed
-            hr = scaler->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
+            hr = scaler->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
             if (FAILED(hr))
                 return hr;
         }
@@ -436,7 +432,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             if (FAILED(hr))
                 return hr;
 
-            hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
+            hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
             if (FAILED(hr))
                 return hr;
         }
@@ -457,11 +453,34 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
         if (FAILED(hr))
             return hr;
 
-        hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), temp.get());
+        hr = FC->CopyPixels(0, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize), pixels);
         if (FAILED(hr))
             return hr;
     }
 
+    image.Width = twidth;
+    image.Height = theight;
+    image.Format = format;
+    image.RowPitch = rowPitch;
+
+    return S_OK;
+}
+
+//---------------------------------------------------------------------------------
+static HRESULT CreateTextureFromImage(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WICTextureImage& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView)
+{
+    const UINT twidth = image.Width;
+    const UINT theight = image.Height;
+    const DXGI_FORMAT format = image.Format;
+    const size_t rowPitch = image.RowPitch;
+    const size_t imageSize = image.aPixels.size();
+    const uint8_t* pixels = image.aPixels.data();
+    HRESULT hr = S_OK;
+
     // See if format is supported for auto-gen mipmaps (varies by feature level)
     bool autogen = false;
     if (d3dContext != 0 && textureView != 0) // Must have context and shader-view to auto generate mipmaps
@@ -489,7 +508,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     desc.MiscFlags = (autogen) ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0;
 
     D3D11_SUBRESOURCE_DATA initData;
-    initData.pSysMem = temp.get();
+    initData.pSysMem = pixels;
     initData.SysMemPitch = static_cast<UINT>(rowPitch);
     initData.SysMemSlicePitch = static_cast<UINT>(imageSize);
 
@@ -515,7 +534,7 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
             if (autogen)
             {
                 assert(d3dContext != 0);
-                d3dContext->UpdateSubresource(tex, 0, nullptr, temp.get(), static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize));
+                d3dContext->UpdateSubresource(tex, 0, nullptr, pixels, static_cast<UINT>(rowPitch), static_cast<UINT>(imageSize));
                 d3dContext->GenerateMips(*textureView);
             }
         }
@@ -539,17 +558,31 @@ static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     return hr;
 }
 
-//--------------------------------------------------------------------------------------
-HRESULT CreateWICTextureFromMemory(_In_ ID3D11Device* d3dDevice,
+//---------------------------------------------------------------------------------
+static HRESULT CreateTextureFromWIC(_In_ ID3D11Device* d3dDevice,
     _In_opt_ ID3D11DeviceContext* d3dContext,
-    _In_bytecount_(wicDataSize) const uint8_t* wicData,
-    _In_ size_t wicDataSize,
+    _In_ IWICBitmapFrameDecode* frame,
     _Out_opt_ ID3D11Resource** texture,
     _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _In_ size_t maxsize)
+{
+    WICTextureImage image = {};
+    HRESULT hr = DecodeTextureFromWIC(d3dDevice, frame, image, maxsize);
+    if (FAILED(hr))
+        return hr;
+
+    return CreateTextureFromImage(d3dDevice, d3dContext, image, texture, textureView);
+}
+
+//--------------------------------------------------------------------------------------
+HRESULT DecodeWICTextureFromMemory(_In_ ID3D11Device* d3dDevice,
+    _In_bytecount_(wicDataSize) const uint8_t* wicData,
+    _In_ size_t wicDataSize,
+    _Out_ WICTextureImage& image,
     _In_ size_t maxsize
 )
 {
-    if (!d3dDevice || !wicData || (!texture && !textureView))
+    if (!d3dDevice || !wicData)
     {
         return E_INVALIDARG;
     }
@@ -589,7 +622,46 @@ HRESULT CreateWICTextureFromMemory(_In_ ID3D11Device* d3dDevice,
     if (FAILED(hr))
         return hr;
 
-    hr = CreateTextureFromWIC(d3dDevice, d3dContext, frame.Get(), texture, textureView, maxsize);
+    return DecodeTextureFromWIC(d3dDevice, frame.Get(), image, maxsize);
+}
+
+//--------------------------------------------------------------------------------------
+HRESULT CreateWICTextureFromImage(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WICTextureImage& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView
+)
+{
+    if (!d3dDevice || image.aPixels.empty() || (!texture && !textureView))
+    {
+        return E_INVALIDARG;
+    }
+
+    return CreateTextureFromImage(d3dDevice, d3dContext, image, texture, textureView);
+}
+
+//--------------------------------------------------------------------------------------
+HRESULT CreateWICTextureFromMemory(_In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_bytecount_(wicDataSize) const uint8_t* wicData,
+    _In_ size_t wicDataSize,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _In_ size_t maxsize
+)
+{
+    if (!d3dDevice || !wicData || (!texture && !textureView))
+    {
+        return E_INVALIDARG;
+    }
+
+    WICTextureImage image = {};
+    HRESULT hr = DecodeWICTextureFromMemory(d3dDevice, wicData, wicDataSize, image, maxsize);
+    if (FAILED(hr))
+        return hr;
+
+    hr = CreateTextureFromImage(d3dDevice, d3dContext, image, texture, textureView);
     if (FAILED(hr))
         return hr;
 
@@ -31,11 +31,41 @@
 
 #include "Common.h"
 
+#include "Memory/MemoryTracker.h"
+
 #pragma warning(push)
 #pragma warning(disable : 4005)
 #include <stdint.h>
 #pragma warning(pop)
 
+// Pixels of a decoded image, in the format and size of the texture created from them
+struct WICTextureImage
+{
+    UINT Width;
+    UINT Height;
+    DXGI_FORMAT Format;
+    size_t RowPitch;
+    library::TaggedVector<uint8_t, library::eMemoryTag::TEXTURE> aPixels;
+};
+
+// Decodes without a context, the device is only queried for the supported formats and sizes, so
+// several images may be decoded at once on other threads than the one owning the context
+HRESULT DecodeWICTextureFromMemory(
+    _In_ ID3D11Device* d3dDevice,
+    _In_bytecount_(wicDataSize) const uint8_t* wicData,
+    _In_ size_t wicDataSize,
+    _Out_ WICTextureImage& image,
+    _In_ size_t maxsize = 0
+    );
+
+HRESULT CreateWICTextureFromImage(
+    _In_ ID3D11Device* d3dDevice,
+    _In_opt_ ID3D11DeviceContext* d3dContext,
+    _In_ const WICTextureImage& image,
+    _Out_opt_ ID3D11Resource** texture,
+    _Out_opt_ ID3D11ShaderResourceView** textureView
+    );
+
 HRESULT CreateWICTextureFromMemory(
     _In_ ID3D11Device* d3dDevice,
     _In_opt_ ID3D11DeviceContext* d3dContext,
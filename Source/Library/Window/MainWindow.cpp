@@ -132,13 +132,17 @@ namespace library
 
             GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, nullptr, &dataSize, sizeof(RAWINPUTHEADER));
 
-            std::unique_ptr<BYTE[]> rawData = std::make_unique<BYTE[]>(dataSize);
-
             if (dataSize <= 0) return DefWindowProc(m_hWnd, uMsg, wParam, lParam);
 
-            if (GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, rawData.get(), &dataSize, sizeof(RAWINPUTHEADER)) == dataSize)
+            // Reused for every message, it only grows
+            if (m_aRawInputData.size() < dataSize)
+            {
+                m_aRawInputData.resize(dataSize);
+            }
+
+            if (GetRawInputData(reinterpret_cast<HRAWINPUT>(lParam), RID_INPUT, m_aRawInputData.data(), &dataSize, sizeof(RAWINPUTHEADER)) == dataSize)
             {
-                RAWINPUT* raw = reinterpret_cast<RAWINPUT*>(rawData.get());
+                RAWINPUT* raw = reinterpret_cast<RAWINPUT*>(m_aRawInputData.data());
                 if (raw->header.dwType == RIM_TYPEMOUSE)
                 {
                     m_mouseRelativeMovement.X += raw->data.mouse.lLastX;
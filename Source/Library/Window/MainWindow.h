@@ -61,6 +61,7 @@ namespace library
     private:
         DirectionsInput m_directions;
         MouseRelativeMovement m_mouseRelativeMovement;
+        std::vector<BYTE> m_aRawInputData;
     };
 }
 
@@ -0,0 +1,253 @@
+/*+===================================================================
+  File:      LIGHTBENCHMARK.CPP
+
+  Summary:   Command line check and benchmark of the clustered light
+             assignment. A camera turns in a field of point lights of
+             various radii, a few of them without attenuation radius.
+             Each frame, the ClusteredLightCuller assigns the lights to
+             its clusters, then points of the view frustum, half of
+             them near the lights, are checked the way the pixel
+             shaders read the lists: the cluster of a point is found
+             with the constants of the culler, and every light reaching
+             the point must be in the list of that cluster, or the
+             benchmark exits with 1. The report shows the time of the
+             assignment and the lights listed per cluster.
+
+             Needs DirectXMath, so only builds on Windows.
+
+             Usage: LightBenchmark [frames] [lights] [points per frame]
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "Renderer/ClusteredLightCuller.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr std::uint32_t DEFAULT_NUM_FRAMES = 64u;
+    constexpr std::uint32_t DEFAULT_NUM_LIGHTS = 512u;
+    constexpr std::uint32_t DEFAULT_NUM_POINTS = 65536u;
+    constexpr std::uint32_t NUM_GLOBAL_LIGHTS = 2u;
+    constexpr UINT WIDTH = 1280u;
+    constexpr UINT HEIGHT = 720u;
+    constexpr FLOAT NEAR_Z = 0.01f;
+    constexpr FLOAT FAR_Z = 100.0f;
+    constexpr FLOAT FIELD_SIZE = 60.0f;
+
+    // A light only has to be listed where it brings more than this, so points on the edge of a cluster never flip
+    constexpr FLOAT MIN_ATTENUATION = 1e-4f;
+
+    std::vector<std::shared_ptr<PointLight>> createLights(std::uint32_t uNumLights)
+    {
+        std::mt19937 generator(7u);
+        std::uniform_real_distribution<FLOAT> position(-FIELD_SIZE * 0.5f, FIELD_SIZE * 0.5f);
+        std::uniform_real_distribution<FLOAT> height(0.0f, 8.0f);
+        std::uniform_real_distribution<FLOAT> radius(0.5f, 8.0f);
+        std::uniform_real_distribution<FLOAT> color(0.2f, 1.0f);
+
+        std::vector<std::shared_ptr<PointLight>> lights;
+        for (std::uint32_t i = 0u; i < uNumLights; ++i)
+        {
+            const XMFLOAT4 lightColor(color(generator), color(generator), color(generator), 1.0f);
+            const FLOAT attenuationRadius = i < NUM_GLOBAL_LIGHTS ? 0.0f : radius(generator);
+            lights.push_back(std::make_shared<PointLight>(XMFLOAT4(position(generator), height(generator), position(generator), 1.0f), lightColor, attenuationRadius));
+        }
+
+        return lights;
+    }
+
+    XMMATRIX getView(std::uint32_t uFrame, std::uint32_t uNumFrames)
+    {
+        const FLOAT yaw = XM_2PI * static_cast<FLOAT>(uFrame) / static_cast<FLOAT>(uNumFrames);
+        const XMVECTOR eye = XMVectorSet(0.0f, 1.7f, 0.0f, 1.0f);
+        const XMVECTOR at = XMVectorAdd(eye, XMVectorSet(std::sin(yaw), -0.1f, std::cos(yaw), 0.0f));
+        return XMMatrixLookAtLH(eye, at, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    }
+
+    UINT getClusterIndex(const CBLights& constants, FLOAT screenX, FLOAT screenY, FLOAT viewDepth)
+    {
+        // Same as GetClusterIndex of the shaders
+        const UINT x = std::min(static_cast<UINT>(screenX * constants.ClusterScale.x), static_cast<UINT>(NUM_CLUSTERS_X - 1));
+        const UINT y = std::min(static_cast<UINT>(screenY * constants.ClusterScale.y), static_cast<UINT>(NUM_CLUSTERS_Y - 1));
+        const UINT z = viewDepth < constants.ClusterScale.w
+            ? 0u
+            : std::min(1u + static_cast<UINT>(std::log(viewDepth / constants.ClusterScale.w) * constants.ClusterScale.z), static_cast<UINT>(NUM_CLUSTERS_Z - 1));
+
+        return (z * NUM_CLUSTERS_Y + y) * NUM_CLUSTERS_X + x;
+    }
+
+    double getMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Assigns the lights of every frame, checks points of the
+            frustum against the lists of their clusters, and prints
+            the lights missing from a list, the time of the
+            assignment and the average length of the lists
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Number of frames, number of lights, then number of points
+              checked per frame
+
+  Returns:  int
+              0 if every light reaching a point is listed, 1 otherwise
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    const std::uint32_t uNumFrames = argc > 1 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[1]), 1)) : DEFAULT_NUM_FRAMES;
+    const std::uint32_t uNumLights = argc > 2 ? static_cast<std::uint32_t>(std::clamp(std::atoi(argv[2]), 1, MAX_NUM_LIGHTS)) : DEFAULT_NUM_LIGHTS;
+    const std::uint32_t uNumPoints = argc > 3 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[3]), 0)) : DEFAULT_NUM_POINTS;
+
+    const std::vector<std::shared_ptr<PointLight>> lights = createLights(uNumLights);
+
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, static_cast<FLOAT>(WIDTH) / static_cast<FLOAT>(HEIGHT), NEAR_Z, FAR_Z);
+    XMFLOAT4X4 projectionValues;
+    XMStoreFloat4x4(&projectionValues, projection);
+
+    ClusteredLightCuller culler;
+    culler.SetProjection(projection, NEAR_Z, FAR_Z, WIDTH, HEIGHT);
+
+    std::mt19937 generator(11u);
+    std::uniform_real_distribution<FLOAT> unit(0.0f, 1.0f);
+
+    std::vector<XMFLOAT4> aViewLights(lights.size());
+    std::vector<BYTE> abListed(lights.size());
+    std::uint64_t uNumMissing = 0u;
+    std::uint64_t uNumCheckedPoints = 0u;
+    std::uint64_t uNumLightIndices = 0u;
+    std::uint32_t uNumTruncatedFrames = 0u;
+    double updateMs = 0.0;
+    double maxUpdateMs = 0.0;
+
+    for (std::uint32_t uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+    {
+        const XMMATRIX view = getView(uFrame, uNumFrames);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        culler.Update(view, lights);
+        const double frameMs = getMilliseconds(start);
+        updateMs += frameMs;
+        maxUpdateMs = std::max(maxUpdateMs, frameMs);
+        uNumLightIndices += culler.GetNumLightIndices();
+
+        // Lists cut at MAX_NUM_CLUSTER_LIGHT_INDICES may miss lights on purpose
+        const BOOL bTruncated = culler.GetNumDroppedLightIndices() > 0u;
+        if (bTruncated)
+        {
+            ++uNumTruncatedFrames;
+            continue;
+        }
+
+        for (size_t i = 0u; i < lights.size(); ++i)
+        {
+            const XMFLOAT4& position = lights[i]->GetPosition();
+            XMStoreFloat4(&aViewLights[i], XMVector3TransformCoord(XMVectorSet(position.x, position.y, position.z, 1.0f), view));
+            aViewLights[i].w = lights[i]->GetAttenuationRadius();
+        }
+
+        const CBLights& constants = culler.GetConstants();
+        const std::vector<XMUINT2>& aClusters = culler.GetClusters();
+        const std::vector<UINT>& auLightIndices = culler.GetLightIndices();
+        for (std::uint32_t uPoint = 0u; uPoint < uNumPoints; ++uPoint)
+        {
+            // Half of the points are in the spheres of the lights, the others anywhere in the frustum
+            XMFLOAT3 viewPosition;
+            if (uPoint % 2u == 0u)
+            {
+                const XMFLOAT4& light = aViewLights[std::uniform_int_distribution<size_t>(NUM_GLOBAL_LIGHTS, lights.size() - 1u)(generator)];
+                const FLOAT reach = std::max(light.w, 1.0f);
+                viewPosition = XMFLOAT3(
+                    light.x + (unit(generator) * 2.0f - 1.0f) * reach,
+                    light.y + (unit(generator) * 2.0f - 1.0f) * reach,
+                    light.z + (unit(generator) * 2.0f - 1.0f) * reach
+                );
+            }
+            else
+            {
+                const FLOAT depth = NEAR_Z * std::pow(FAR_Z / NEAR_Z, unit(generator));
+                viewPosition = XMFLOAT3(
+                    (unit(generator) * 2.0f - 1.0f) * depth / projectionValues._11,
+                    (unit(generator) * 2.0f - 1.0f) * depth / projectionValues._22,
+                    depth
+                );
+            }
+
+            // Pixel of the point, with y from the top of the screen
+            if (viewPosition.z < NEAR_Z || viewPosition.z > FAR_Z)
+            {
+                continue;
+            }
+            const FLOAT ndcX = viewPosition.x * projectionValues._11 / viewPosition.z;
+            const FLOAT ndcY = viewPosition.y * projectionValues._22 / viewPosition.z;
+            if (std::abs(ndcX) >= 1.0f || std::abs(ndcY) >= 1.0f)
+            {
+                continue;
+            }
+            const FLOAT screenX = (ndcX * 0.5f + 0.5f) * static_cast<FLOAT>(WIDTH);
+            const FLOAT screenY = (0.5f - ndcY * 0.5f) * static_cast<FLOAT>(HEIGHT);
+
+            const XMUINT2& cluster = aClusters[getClusterIndex(constants, screenX, screenY, viewPosition.z)];
+            std::fill(abListed.begin(), abListed.end(), static_cast<BYTE>(0u));
+            for (UINT i = 0u; i < cluster.y; ++i)
+            {
+                abListed[auLightIndices[cluster.x + i]] = 1u;
+            }
+
+            ++uNumCheckedPoints;
+            for (size_t i = 0u; i < lights.size(); ++i)
+            {
+                const XMFLOAT4& light = aViewLights[i];
+                FLOAT attenuation = 1.0f;
+                if (light.w > 0.0f)
+                {
+                    const FLOAT dx = light.x - viewPosition.x;
+                    const FLOAT dy = light.y - viewPosition.y;
+                    const FLOAT dz = light.z - viewPosition.z;
+                    const FLOAT ratio = std::sqrt(dx * dx + dy * dy + dz * dz) / light.w;
+                    const FLOAT falloff = std::clamp(1.0f - ratio * ratio, 0.0f, 1.0f);
+                    attenuation = falloff * falloff;
+                }
+
+                if (attenuation > MIN_ATTENUATION && !abListed[i])
+                {
+                    ++uNumMissing;
+                    if (uNumMissing <= 10u)
+                    {
+                        std::printf(
+                            "frame %u: light %zu reaches (%.2f %.2f %.2f) in view space but is not listed in its cluster\n",
+                            uFrame, i, viewPosition.x, viewPosition.y, viewPosition.z
+                        );
+                    }
+                }
+            }
+        }
+    }
+
+    std::printf("%u frames, %u lights, %u clusters, %llu points checked\n", uNumFrames, uNumLights, NUM_CLUSTERS, static_cast<unsigned long long>(uNumCheckedPoints));
+    std::printf("missing lights  %llu\n", static_cast<unsigned long long>(uNumMissing));
+    if (uNumTruncatedFrames > 0u)
+    {
+        std::printf("truncated       %u frames filled the %u light indices and were not checked\n", uNumTruncatedFrames, MAX_NUM_CLUSTER_LIGHT_INDICES);
+    }
+    std::printf("lists           %10.2f lights per cluster\n", static_cast<double>(uNumLightIndices) / (static_cast<double>(uNumFrames) * NUM_CLUSTERS));
+    std::printf("assignment      %10.3fms per frame, %.3fms at most\n", updateMs / uNumFrames, maxUpdateMs);
+
+    return uNumMissing == 0u ? 0 : 1;
+}
@@ -0,0 +1,436 @@
+/*+===================================================================
+  File:      OCCLUSIONBENCHMARK.CPP
+
+  Summary:   Command line check and benchmark of the occlusion culler.
+             A field of walls hides a cloud of small boxes from a
+             camera turning around the origin. Each frame, the boxes
+             are tested by the OcclusionCuller and by a brute force
+             reference, which rasterizes the walls and the boxes
+             pixel by pixel with exact depths at the same resolution.
+             The culler must be conservative: every box the reference
+             sees must be reported visible, or the benchmark exits
+             with 1. It may keep hidden boxes, the report shows the
+             share of the hidden boxes it culled.
+
+             Depends only on the standard library, DirectXMath and
+             the occlusion culler, so it also builds on Linux with the
+             DirectXMath headers and the sal.h stub of DirectX-Headers:
+               g++ -std=c++20 -O2 -I../Library -I<DirectXMath>/Inc
+                   -I<DirectX-Headers>/include/wsl/stubs
+                   OcclusionBenchmark.cpp
+                   ../Library/Renderer/OcclusionCuller.cpp
+                   -o OcclusionBenchmark
+
+             Usage: OcclusionBenchmark [frames] [boxes] [walls]
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include "Renderer/OcclusionCuller.h"
+
+using namespace DirectX;
+using namespace library;
+
+namespace
+{
+    constexpr std::uint32_t DEFAULT_NUM_FRAMES = 64u;
+    constexpr std::uint32_t DEFAULT_NUM_BOXES = 20000u;
+    constexpr std::uint32_t DEFAULT_NUM_WALLS = 96u;
+    constexpr float NEAR_Z = 0.1f;
+    constexpr float FAR_Z = 200.0f;
+
+    // The reference tests a box nearer than an occluder by this much visible, so equal depths never flip
+    constexpr float DEPTH_EPSILON = 1e-5f;
+
+    // The reference occluders are grown by this fraction of a pixel, so they cover every pixel the culler covers
+    constexpr float EDGE_EPSILON = 1e-2f;
+
+    constexpr std::uint32_t BOX_INDICES[] =
+    {
+        0, 1, 2,  2, 1, 3,
+        4, 6, 5,  5, 6, 7,
+        0, 2, 4,  4, 2, 6,
+        1, 5, 3,  3, 5, 7,
+        0, 4, 1,  1, 4, 5,
+        2, 3, 6,  6, 3, 7,
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   ScreenVertex
+
+      Summary:  Vertex projected onto the depth buffer
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct ScreenVertex
+    {
+        float x;
+        float y;
+        float z;
+        bool bInFront;
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    ReferenceDepth
+
+      Summary:  Brute force depth buffer of the same size as the one of
+                the culler. Every triangle is tested at the center of
+                every pixel of its bounds, and written with the depth
+                interpolated at that pixel, without tiles or SIMD. The
+                triangles the culler drops, those with a vertex behind
+                the near plane, are dropped too
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class ReferenceDepth final
+    {
+    public:
+        ReferenceDepth(std::uint32_t uWidth, std::uint32_t uHeight)
+            : m_uWidth(uWidth)
+            , m_uHeight(uHeight)
+            , m_aDepth(static_cast<size_t>(uWidth) * uHeight, 1.0f)
+            , m_viewProjection(XMMatrixIdentity())
+        {
+        }
+
+        void BeginFrame(const XMMATRIX& viewProjection)
+        {
+            std::fill(m_aDepth.begin(), m_aDepth.end(), 1.0f);
+            m_viewProjection = viewProjection;
+        }
+
+        void RenderOccluderBox(const AxisAlignedBox& box)
+        {
+            forEachBoxPixel(box, EDGE_EPSILON, [this](std::uint32_t uX, std::uint32_t uY, float depth)
+            {
+                float& stored = m_aDepth[static_cast<size_t>(uY) * m_uWidth + uX];
+                stored = std::min(stored, depth);
+                return false;
+            });
+        }
+
+        bool IsVisible(const AxisAlignedBox& box) const
+        {
+            // Boxes crossing the near plane are drawn by the renderer
+            ScreenVertex aVertices[8];
+            bool bVisible = !projectBox(box, aVertices);
+            if (!bVisible)
+            {
+                forEachBoxPixel(box, 0.0f, [this, &bVisible](std::uint32_t uX, std::uint32_t uY, float depth)
+                {
+                    bVisible = depth < m_aDepth[static_cast<size_t>(uY) * m_uWidth + uX] - DEPTH_EPSILON;
+                    return static_cast<bool>(bVisible);
+                });
+            }
+            return bVisible;
+        }
+
+    private:
+        bool projectBox(const AxisAlignedBox& box, ScreenVertex aVertices[8]) const
+        {
+            bool bInFront = true;
+            for (std::uint32_t i = 0u; i < 8u; ++i)
+            {
+                const XMVECTOR corner = XMVectorSet(
+                    (i & 1u) ? box.Max.x : box.Min.x,
+                    (i & 2u) ? box.Max.y : box.Min.y,
+                    (i & 4u) ? box.Max.z : box.Min.z,
+                    1.0f
+                );
+                XMFLOAT4 clip;
+                XMStoreFloat4(&clip, XMVector4Transform(corner, m_viewProjection));
+                aVertices[i].bInFront = clip.w > 0.0f && clip.z >= 0.0f;
+                if (!aVertices[i].bInFront)
+                {
+                    bInFront = false;
+                    continue;
+                }
+
+                aVertices[i].x = (clip.x / clip.w * 0.5f + 0.5f) * static_cast<float>(m_uWidth);
+                aVertices[i].y = (0.5f - clip.y / clip.w * 0.5f) * static_cast<float>(m_uHeight);
+                aVertices[i].z = clip.z / clip.w;
+            }
+            return bInFront;
+        }
+
+        /*M+M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M+++M
+          Method:   ReferenceDepth::forEachBoxPixel
+
+          Summary:  Calls a function on every pixel whose center is
+                    covered by a face of a box, with the depth of the
+                    face there, until the function returns true. The
+                    triangles with a corner behind the near plane are
+                    skipped, like the culler does
+
+          Args:     const AxisAlignedBox& box
+                      World space box
+                    float edgeBias
+                      Pixels the faces are grown by
+                    const Function& function
+                      Called with the column, row and depth
+        M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M---M-M*/
+        template <class Function>
+        void forEachBoxPixel(const AxisAlignedBox& box, float edgeBias, const Function& function) const
+        {
+            ScreenVertex aVertices[8];
+            projectBox(box, aVertices);
+
+            for (std::uint32_t i = 0u; i < std::size(BOX_INDICES); i += 3u)
+            {
+                ScreenVertex a = aVertices[BOX_INDICES[i]];
+                ScreenVertex b = aVertices[BOX_INDICES[i + 1u]];
+                ScreenVertex c = aVertices[BOX_INDICES[i + 2u]];
+                if (!a.bInFront || !b.bInFront || !c.bInFront)
+                {
+                    continue;
+                }
+
+                float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+                if (area == 0.0f)
+                {
+                    continue;
+                }
+                if (area < 0.0f)
+                {
+                    std::swap(b, c);
+                    area = -area;
+                }
+
+                const float minX = std::min({ a.x, b.x, c.x });
+                const float minY = std::min({ a.y, b.y, c.y });
+                const float maxX = std::max({ a.x, b.x, c.x });
+                const float maxY = std::max({ a.y, b.y, c.y });
+                if (maxX < 0.0f || maxY < 0.0f || minX >= static_cast<float>(m_uWidth) || minY >= static_cast<float>(m_uHeight))
+                {
+                    continue;
+                }
+
+                const std::int32_t iMinX = static_cast<std::int32_t>(std::max(minX, 0.0f));
+                const std::int32_t iMinY = static_cast<std::int32_t>(std::max(minY, 0.0f));
+                const std::int32_t iMaxX = static_cast<std::int32_t>(std::min(maxX, static_cast<float>(m_uWidth - 1u)));
+                const std::int32_t iMaxY = static_cast<std::int32_t>(std::min(maxY, static_cast<float>(m_uHeight - 1u)));
+
+                const ScreenVertex* apEdges[3][2] = { { &a, &b }, { &b, &c }, { &c, &a } };
+                for (std::int32_t y = iMinY; y <= iMaxY; ++y)
+                {
+                    for (std::int32_t x = iMinX; x <= iMaxX; ++x)
+                    {
+                        const float px = static_cast<float>(x) + 0.5f;
+                        const float py = static_cast<float>(y) + 0.5f;
+
+                        // Edge i is opposite to the vertex weighted by aWeights[(i + 2) % 3]
+                        float aWeights[3];
+                        bool bInside = true;
+                        for (std::uint32_t e = 0u; e < 3u && bInside; ++e)
+                        {
+                            const ScreenVertex& p0 = *apEdges[e][0];
+                            const ScreenVertex& p1 = *apEdges[e][1];
+                            const float edge = (p0.y - p1.y) * (px - p0.x) + (p1.x - p0.x) * (py - p0.y);
+                            const float length = std::sqrt((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y));
+                            bInside = edge + edgeBias * length >= 0.0f;
+                            aWeights[(e + 2u) % 3u] = edge / area;
+                        }
+                        if (!bInside)
+                        {
+                            continue;
+                        }
+
+                        const float depth = aWeights[0] * a.z + aWeights[1] * b.z + aWeights[2] * c.z;
+                        if (function(static_cast<std::uint32_t>(x), static_cast<std::uint32_t>(y), depth))
+                        {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+
+    private:
+        std::uint32_t m_uWidth;
+        std::uint32_t m_uHeight;
+        std::vector<float> m_aDepth;
+        XMMATRIX m_viewProjection;
+    };
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   Scene
+
+      Summary:  Walls standing on the ground around the origin, and
+                small boxes scattered behind and between them
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct Scene
+    {
+        std::vector<AxisAlignedBox> aWalls;
+        std::vector<AxisAlignedBox> aBoxes;
+    };
+
+    Scene createScene(std::uint32_t uNumWalls, std::uint32_t uNumBoxes)
+    {
+        std::mt19937 random(42u);
+        std::uniform_real_distribution<float> angle(0.0f, XM_2PI);
+        std::uniform_real_distribution<float> wallDistance(8.0f, 60.0f);
+        std::uniform_real_distribution<float> boxDistance(4.0f, 120.0f);
+        std::uniform_real_distribution<float> wallWidth(2.0f, 12.0f);
+        std::uniform_real_distribution<float> wallHeight(2.0f, 8.0f);
+        std::uniform_real_distribution<float> boxSize(0.2f, 1.5f);
+        std::uniform_real_distribution<float> boxHeight(0.0f, 6.0f);
+
+        Scene scene;
+        scene.aWalls.reserve(uNumWalls);
+        for (std::uint32_t i = 0u; i < uNumWalls; ++i)
+        {
+            const float wallAngle = angle(random);
+            const float distance = wallDistance(random);
+            const float x = std::sin(wallAngle) * distance;
+            const float z = std::cos(wallAngle) * distance;
+            const float halfWidth = wallWidth(random) * 0.5f;
+
+            // Walls face the origin along whichever axis is nearer to it
+            const bool bAlongX = std::abs(z) > std::abs(x);
+            scene.aWalls.push_back(AxisAlignedBox{
+                .Min = XMFLOAT3(x - (bAlongX ? halfWidth : 0.5f), 0.0f, z - (bAlongX ? 0.5f : halfWidth)),
+                .Max = XMFLOAT3(x + (bAlongX ? halfWidth : 0.5f), wallHeight(random), z + (bAlongX ? 0.5f : halfWidth)),
+            });
+        }
+
+        scene.aBoxes.reserve(uNumBoxes);
+        for (std::uint32_t i = 0u; i < uNumBoxes; ++i)
+        {
+            const float boxAngle = angle(random);
+            const float distance = boxDistance(random);
+            const XMFLOAT3 center(std::sin(boxAngle) * distance, boxHeight(random), std::cos(boxAngle) * distance);
+            const float halfSize = boxSize(random) * 0.5f;
+            scene.aBoxes.push_back(AxisAlignedBox{
+                .Min = XMFLOAT3(center.x - halfSize, center.y, center.z - halfSize),
+                .Max = XMFLOAT3(center.x + halfSize, center.y + halfSize * 2.0f, center.z + halfSize),
+            });
+        }
+
+        return scene;
+    }
+
+    XMMATRIX getViewProjection(std::uint32_t uFrame, std::uint32_t uNumFrames, float aspectRatio)
+    {
+        const float yaw = XM_2PI * static_cast<float>(uFrame) / static_cast<float>(uNumFrames);
+        const XMVECTOR eye = XMVectorSet(0.0f, 1.7f, 0.0f, 1.0f);
+        const XMVECTOR at = XMVectorAdd(eye, XMVectorSet(std::sin(yaw), -0.05f, std::cos(yaw), 0.0f));
+        const XMMATRIX view = XMMatrixLookAtLH(eye, at, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+        return view * XMMatrixPerspectiveFovLH(XM_PIDIV4, aspectRatio, NEAR_Z, FAR_Z);
+    }
+
+    double getMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Culls the boxes of every frame with the culler and the
+            reference, prints the boxes the culler wrongly culled, the
+            share of the hidden boxes it culled, and the time per frame
+            of its occluder rasterization and of its queries
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Number of frames, number of boxes, then number of walls
+
+  Returns:  int
+              0 if the culler is conservative, 1 otherwise
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    const std::uint32_t uNumFrames = argc > 1 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[1]), 1)) : DEFAULT_NUM_FRAMES;
+    const std::uint32_t uNumBoxes = argc > 2 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[2]), 1)) : DEFAULT_NUM_BOXES;
+    const std::uint32_t uNumWalls = argc > 3 ? static_cast<std::uint32_t>(std::max(std::atoi(argv[3]), 1)) : DEFAULT_NUM_WALLS;
+
+    const Scene scene = createScene(uNumWalls, uNumBoxes);
+
+    OcclusionCuller culler;
+    ReferenceDepth reference(culler.GetWidth(), culler.GetHeight());
+    const float aspectRatio = static_cast<float>(culler.GetWidth()) / static_cast<float>(culler.GetHeight());
+
+    std::vector<bool> abVisible(scene.aBoxes.size());
+    std::uint64_t uNumWronglyCulled = 0u;
+    std::uint64_t uNumHidden = 0u;
+    std::uint64_t uNumCulled = 0u;
+    double occluderMs = 0.0;
+    double queryMs = 0.0;
+    double referenceMs = 0.0;
+
+    for (std::uint32_t uFrame = 0u; uFrame < uNumFrames; ++uFrame)
+    {
+        const XMMATRIX viewProjection = getViewProjection(uFrame, uNumFrames, aspectRatio);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        culler.BeginFrame(viewProjection);
+        for (const AxisAlignedBox& wall : scene.aWalls)
+        {
+            culler.RenderOccluderBox(wall);
+        }
+        culler.EndOccluders();
+        occluderMs += getMilliseconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0u; i < scene.aBoxes.size(); ++i)
+        {
+            abVisible[i] = culler.IsVisible(scene.aBoxes[i]);
+        }
+        queryMs += getMilliseconds(start);
+        uNumCulled += culler.GetNumCulled();
+
+        start = std::chrono::steady_clock::now();
+        reference.BeginFrame(viewProjection);
+        for (const AxisAlignedBox& wall : scene.aWalls)
+        {
+            reference.RenderOccluderBox(wall);
+        }
+        for (size_t i = 0u; i < scene.aBoxes.size(); ++i)
+        {
+            if (reference.IsVisible(scene.aBoxes[i]))
+            {
+                if (!abVisible[i])
+                {
+                    ++uNumWronglyCulled;
+                    if (uNumWronglyCulled <= 10u)
+                    {
+                        const AxisAlignedBox& box = scene.aBoxes[i];
+                        std::printf(
+                            "frame %u: visible box %zu (%.2f %.2f %.2f)-(%.2f %.2f %.2f) was culled\n",
+                            uFrame, i, box.Min.x, box.Min.y, box.Min.z, box.Max.x, box.Max.y, box.Max.z
+                        );
+                    }
+                }
+            }
+            else
+            {
+                ++uNumHidden;
+            }
+        }
+        referenceMs += getMilliseconds(start);
+    }
+
+    std::printf("%u frames, %u boxes, %u walls, %ux%u depth buffer\n", uNumFrames, uNumBoxes, uNumWalls, culler.GetWidth(), culler.GetHeight());
+    std::printf("wrongly culled  %llu\n", static_cast<unsigned long long>(uNumWronglyCulled));
+    std::printf(
+        "culled          %llu of %llu hidden (%.1f%%)\n",
+        static_cast<unsigned long long>(uNumCulled),
+        static_cast<unsigned long long>(uNumHidden),
+        uNumHidden > 0u ? 100.0 * static_cast<double>(uNumCulled) / static_cast<double>(uNumHidden) : 100.0
+    );
+    std::printf("occluders       %10.3fms per frame\n", occluderMs / uNumFrames);
+    std::printf("queries         %10.3fms per frame, %.1fns per box\n", queryMs / uNumFrames, queryMs * 1e6 / (static_cast<double>(uNumFrames) * uNumBoxes));
+    std::printf("reference       %10.3fms per frame\n", referenceMs / uNumFrames);
+
+    return uNumWronglyCulled == 0u ? 0 : 1;
+}
@@ -0,0 +1,459 @@
+/*+===================================================================
+  File:      TRACESTATS.CPP
+
+  Summary:   Command line tool replaying a binary frame trace, written
+             with "Game.exe --trace <file>", against a null backend
+             that only tracks the bound state. Prints per frame the
+             calls, draws, redundant binds and uploaded bytes, then
+             histograms of the calls and upload sizes of all frames.
+
+             Depends only on the standard library and
+             Renderer/FrameTraceFormat.h, so it also builds on Linux:
+               g++ -std=c++20 -O2 -I../Library TraceStats.cpp -o TraceStats
+
+             Usage: TraceStats <trace file> [--frames]
+               --frames  also prints the calls of every frame by type
+
+  © 2022 Kyung Hee University
+===================================================================+*/
+
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Renderer/FrameTraceFormat.h"
+
+using namespace library;
+
+namespace
+{
+    constexpr std::size_t NUM_RECORD_TYPES = static_cast<std::size_t>(eTraceRecordType::COUNT);
+    constexpr std::size_t NUM_SLOTS = 256u;
+    constexpr std::size_t NUM_UPLOAD_BUCKETS = 33u;
+    constexpr std::uint32_t UNKNOWN = UINT32_MAX;
+    constexpr int HISTOGRAM_WIDTH = 40;
+
+    /*S+S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S+++S
+      Struct:   FrameStats
+
+      Summary:  Counters of one frame, or of every frame
+
+      Members:  std::uint64_t auNumCalls[]
+                  Number of calls per record type
+                std::uint64_t auNumRedundant[]
+                  Number of binds per record type that did not change
+                  the bound state
+                std::uint64_t auUploadBuckets[]
+                  Number of uploads per power of two of their size
+                std::uint64_t uNumDraws
+                  Number of draws
+                std::uint64_t uNumPrimitiveIndices
+                  Number of vertices or indices drawn, instances
+                  included
+                std::uint64_t uUploadedBytes
+                  Number of bytes uploaded
+    S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S---S-S*/
+    struct FrameStats
+    {
+        std::array<std::uint64_t, NUM_RECORD_TYPES> auNumCalls = {};
+        std::array<std::uint64_t, NUM_RECORD_TYPES> auNumRedundant = {};
+        std::array<std::uint64_t, NUM_UPLOAD_BUCKETS> auUploadBuckets = {};
+        std::uint64_t uNumDraws = 0u;
+        std::uint64_t uNumPrimitiveIndices = 0u;
+        std::uint64_t uUploadedBytes = 0u;
+
+        std::uint64_t GetNumCalls() const
+        {
+            std::uint64_t uNumCalls = 0u;
+            for (std::size_t i = 0u; i < NUM_RECORD_TYPES; ++i)
+            {
+                if (i != static_cast<std::size_t>(eTraceRecordType::FRAME))
+                {
+                    uNumCalls += auNumCalls[i];
+                }
+            }
+            return uNumCalls;
+        }
+
+        std::uint64_t GetNumRedundant() const
+        {
+            std::uint64_t uNumRedundant = 0u;
+            for (const std::uint64_t uCount : auNumRedundant)
+            {
+                uNumRedundant += uCount;
+            }
+            return uNumRedundant;
+        }
+
+        void Add(const FrameStats& other)
+        {
+            for (std::size_t i = 0u; i < NUM_RECORD_TYPES; ++i)
+            {
+                auNumCalls[i] += other.auNumCalls[i];
+                auNumRedundant[i] += other.auNumRedundant[i];
+            }
+            for (std::size_t i = 0u; i < NUM_UPLOAD_BUCKETS; ++i)
+            {
+                auUploadBuckets[i] += other.auUploadBuckets[i];
+            }
+            uNumDraws += other.uNumDraws;
+            uNumPrimitiveIndices += other.uNumPrimitiveIndices;
+            uUploadedBytes += other.uUploadedBytes;
+        }
+    };
+
+    /*C+C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C+++C
+      Class:    NullBackend
+
+      Summary:  Executes trace records without a device. It keeps the
+                ids of the bound objects to find binds that change
+                nothing, and counts calls, draws and uploads. The state
+                is forgotten at the start of every frame. A pipeline
+                state binds the input layout, shaders, sampler and the
+                object constants itself, so it makes them unknown
+
+      Methods:  BeginFrame
+                  Forgets the bound state and the counters
+                Execute
+                  Executes a record
+                GetStats
+                  Returns the counters of the frame
+    C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C---C-C*/
+    class NullBackend final
+    {
+    public:
+        void BeginFrame()
+        {
+            m_stats = FrameStats();
+            m_uTopology = UNKNOWN;
+            m_aVertexBuffers.fill({ UNKNOWN, UNKNOWN, UNKNOWN });
+            m_indexBuffer = { UNKNOWN, UNKNOWN, UNKNOWN };
+            m_uInputLayout = UNKNOWN;
+            m_uVertexShader = UNKNOWN;
+            m_uPixelShader = UNKNOWN;
+            m_auVSConstantBuffers.fill(UNKNOWN);
+            m_auPSConstantBuffers.fill(UNKNOWN);
+            m_auVSShaderResources.fill(UNKNOWN);
+            m_auPSShaderResources.fill(UNKNOWN);
+            m_auPSSamplers.fill(UNKNOWN);
+            m_pipelineState = { UNKNOWN, UNKNOWN, UNKNOWN };
+        }
+
+        void Execute(const TraceRecord& record)
+        {
+            const std::size_t uType = record.Type;
+            ++m_stats.auNumCalls[uType];
+
+            bool bRedundant = false;
+            switch (static_cast<eTraceRecordType>(record.Type))
+            {
+            case eTraceRecordType::UPDATE_BUFFER:
+                m_stats.uUploadedBytes += record.auArgs[0];
+                ++m_stats.auUploadBuckets[getUploadBucket(record.auArgs[0])];
+                break;
+            case eTraceRecordType::SET_PRIMITIVE_TOPOLOGY:
+                bRedundant = bind(m_uTopology, record.auArgs[0]);
+                break;
+            case eTraceRecordType::SET_VERTEX_BUFFER:
+                bRedundant = bind(m_aVertexBuffers[record.uSlot], { record.uObject, record.auArgs[0], record.auArgs[1] });
+                break;
+            case eTraceRecordType::SET_INDEX_BUFFER:
+                bRedundant = bind(m_indexBuffer, { record.uObject, record.auArgs[0], 0u });
+                break;
+            case eTraceRecordType::SET_INPUT_LAYOUT:
+                bRedundant = bind(m_uInputLayout, record.uObject);
+                break;
+            case eTraceRecordType::SET_VERTEX_SHADER:
+                bRedundant = bind(m_uVertexShader, record.uObject);
+                break;
+            case eTraceRecordType::SET_PIXEL_SHADER:
+                bRedundant = bind(m_uPixelShader, record.uObject);
+                break;
+            case eTraceRecordType::SET_VS_CONSTANT_BUFFER:
+                bRedundant = bind(m_auVSConstantBuffers[record.uSlot], record.uObject);
+                break;
+            case eTraceRecordType::SET_PS_CONSTANT_BUFFER:
+                bRedundant = bind(m_auPSConstantBuffers[record.uSlot], record.uObject);
+                break;
+            case eTraceRecordType::SET_VS_SHADER_RESOURCE:
+                bRedundant = bind(m_auVSShaderResources[record.uSlot], record.uObject);
+                break;
+            case eTraceRecordType::SET_PS_SHADER_RESOURCE:
+                bRedundant = bind(m_auPSShaderResources[record.uSlot], record.uObject);
+                break;
+            case eTraceRecordType::SET_PS_SAMPLER:
+                bRedundant = bind(m_auPSSamplers[record.uSlot], record.uObject);
+                break;
+            case eTraceRecordType::SET_PIPELINE_STATE:
+                bRedundant = bind(m_pipelineState, { record.uObject, record.auArgs[0], 0u });
+                m_uInputLayout = UNKNOWN;
+                m_uVertexShader = UNKNOWN;
+                m_uPixelShader = UNKNOWN;
+                m_auPSSamplers[0] = UNKNOWN;
+                m_auVSConstantBuffers.fill(UNKNOWN);
+                m_auPSConstantBuffers.fill(UNKNOWN);
+                break;
+            case eTraceRecordType::DRAW:
+                ++m_stats.uNumDraws;
+                m_stats.uNumPrimitiveIndices += record.auArgs[0];
+                break;
+            case eTraceRecordType::DRAW_INDEXED:
+            case eTraceRecordType::DRAW_INDEXED_INSTANCED:
+                ++m_stats.uNumDraws;
+                m_stats.uNumPrimitiveIndices += static_cast<std::uint64_t>(record.auArgs[0]) * record.auArgs[1];
+                break;
+            default:
+                break;
+            }
+
+            if (bRedundant)
+            {
+                ++m_stats.auNumRedundant[uType];
+            }
+        }
+
+        const FrameStats& GetStats() const
+        {
+            return m_stats;
+        }
+
+    private:
+        typedef std::array<std::uint32_t, 3> Binding;
+
+        static bool bind(std::uint32_t& uBound, std::uint32_t uValue)
+        {
+            const bool bRedundant = uBound == uValue;
+            uBound = uValue;
+            return bRedundant;
+        }
+
+        static bool bind(Binding& bound, const Binding& value)
+        {
+            const bool bRedundant = bound == value;
+            bound = value;
+            return bRedundant;
+        }
+
+        static std::size_t getUploadBucket(std::uint32_t uSize)
+        {
+            std::size_t uBucket = 0u;
+            while (uSize > 1u)
+            {
+                uSize >>= 1u;
+                ++uBucket;
+            }
+            return uBucket;
+        }
+
+    private:
+        FrameStats m_stats;
+        std::uint32_t m_uTopology = UNKNOWN;
+        std::array<Binding, NUM_SLOTS> m_aVertexBuffers = {};
+        Binding m_indexBuffer = {};
+        std::uint32_t m_uInputLayout = UNKNOWN;
+        std::uint32_t m_uVertexShader = UNKNOWN;
+        std::uint32_t m_uPixelShader = UNKNOWN;
+        std::array<std::uint32_t, NUM_SLOTS> m_auVSConstantBuffers = {};
+        std::array<std::uint32_t, NUM_SLOTS> m_auPSConstantBuffers = {};
+        std::array<std::uint32_t, NUM_SLOTS> m_auVSShaderResources = {};
+        std::array<std::uint32_t, NUM_SLOTS> m_auPSShaderResources = {};
+        std::array<std::uint32_t, NUM_SLOTS> m_auPSSamplers = {};
+        Binding m_pipelineState = {};
+    };
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printBar
+
+      Summary:  Prints a histogram bar of a count scaled to the maximum
+
+      Args:     std::uint64_t uCount
+                  Count of the bar
+                std::uint64_t uMaxCount
+                  Count of the longest bar
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void printBar(std::uint64_t uCount, std::uint64_t uMaxCount)
+    {
+        const int iLength = uMaxCount == 0u ? 0 : static_cast<int>((uCount * HISTOGRAM_WIDTH + uMaxCount - 1u) / uMaxCount);
+        std::printf(" %s\n", std::string(static_cast<std::size_t>(iLength), '#').c_str());
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printCallHistogram
+
+      Summary:  Prints the calls and redundant binds per record type
+
+      Args:     const FrameStats& stats
+                  Counters to print
+                std::uint64_t uNumFrames
+                  Number of frames of the counters, to print averages
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void printCallHistogram(const FrameStats& stats, std::uint64_t uNumFrames)
+    {
+        const std::uint64_t uMaxCount = *std::max_element(stats.auNumCalls.begin(), stats.auNumCalls.end() - 1);
+
+        std::printf("  %-22s %12s %12s %10s\n", "call", "count", "per frame", "redundant");
+        for (std::size_t i = 0u; i < NUM_RECORD_TYPES; ++i)
+        {
+            if (i == static_cast<std::size_t>(eTraceRecordType::FRAME) || stats.auNumCalls[i] == 0u)
+            {
+                continue;
+            }
+
+            std::printf("  %-22s %12" PRIu64 " %12.1f %10" PRIu64,
+                TRACE_RECORD_NAMES[i],
+                stats.auNumCalls[i],
+                static_cast<double>(stats.auNumCalls[i]) / static_cast<double>(uNumFrames),
+                stats.auNumRedundant[i]);
+            printBar(stats.auNumCalls[i], uMaxCount);
+        }
+    }
+
+    /*F+F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F+++F
+      Function: printUploadHistogram
+
+      Summary:  Prints the number of uploads per power of two of their
+                size
+
+      Args:     const FrameStats& stats
+                  Counters to print
+    F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F---F-F*/
+    void printUploadHistogram(const FrameStats& stats)
+    {
+        const std::uint64_t uMaxCount = *std::max_element(stats.auUploadBuckets.begin(), stats.auUploadBuckets.end());
+
+        std::printf("  %-22s %12s\n", "upload size (bytes)", "count");
+        for (std::size_t i = 0u; i < NUM_UPLOAD_BUCKETS; ++i)
+        {
+            if (stats.auUploadBuckets[i] == 0u)
+            {
+                continue;
+            }
+
+            const std::string range = ">= " + std::to_string(1ull << i);
+            std::printf("  %-22s %12" PRIu64, range.c_str(), stats.auUploadBuckets[i]);
+            printBar(stats.auUploadBuckets[i], uMaxCount);
+        }
+    }
+}
+
+/*F+F+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+  Function: main
+
+  Summary:  Reads the trace, replays every frame against the null
+            backend and prints the statistics
+
+  Args:     int argc
+              Number of arguments
+            char* argv[]
+              Trace file, then the options
+
+  Returns:  int
+              0 on success, 1 when the trace cannot be read or is
+              malformed
+-----------------------------------------------------------------F-F*/
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <trace file> [--frames]\n", argv[0]);
+        return 1;
+    }
+
+    bool bPrintFrames = false;
+    for (int i = 2; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--frames") == 0)
+        {
+            bPrintFrames = true;
+        }
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    TraceFileHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.uMagic != TraceFileHeader::TRACE_MAGIC || header.uVersion != TraceFileHeader::TRACE_VERSION)
+    {
+        std::fprintf(stderr, "%s is not a version %u frame trace\n", argv[1], TraceFileHeader::TRACE_VERSION);
+        return 1;
+    }
+
+    // Record counts are checked against the bytes left, so a corrupt count cannot allocate more than the file holds
+    file.seekg(0, std::ios::end);
+    const std::uint64_t uFileSize = static_cast<std::uint64_t>(file.tellg());
+    file.seekg(sizeof(header), std::ios::beg);
+
+    NullBackend backend;
+    FrameStats total;
+    std::vector<TraceRecord> aRecords;
+    std::uint32_t uNumFrames = 0u;
+
+    std::printf("%8s %10s %8s %10s %14s %10s %14s\n", "frame", "calls", "draws", "redundant", "uploaded", "uploads", "indices");
+    for (; uNumFrames < header.uNumFrames; ++uNumFrames)
+    {
+        TraceRecord frame = {};
+        if (!file.read(reinterpret_cast<char*>(&frame), sizeof(frame)) ||
+            frame.Type != static_cast<std::uint8_t>(eTraceRecordType::FRAME))
+        {
+            std::fprintf(stderr, "Frame %u is truncated or corrupt\n", uNumFrames);
+            break;
+        }
+
+        const std::uint64_t uNumRecordsLeft = (uFileSize - static_cast<std::uint64_t>(file.tellg())) / sizeof(TraceRecord);
+        if (frame.auArgs[1] > uNumRecordsLeft)
+        {
+            std::fprintf(stderr, "Frame %u claims %u records but only %" PRIu64 " are left, the trace is malformed\n", uNumFrames, frame.auArgs[1], uNumRecordsLeft);
+            return 1;
+        }
+
+        aRecords.resize(frame.auArgs[1]);
+        if (!file.read(reinterpret_cast<char*>(aRecords.data()), static_cast<std::streamsize>(aRecords.size() * sizeof(TraceRecord))))
+        {
+            std::fprintf(stderr, "Frame %u is truncated\n", uNumFrames);
+            break;
+        }
+
+        backend.BeginFrame();
+        for (const TraceRecord& record : aRecords)
+        {
+            if (record.Type >= static_cast<std::uint8_t>(eTraceRecordType::FRAME))
+            {
+                std::fprintf(stderr, "Frame %u has an unknown record type %u\n", uNumFrames, record.Type);
+                return 1;
+            }
+            backend.Execute(record);
+        }
+
+        const FrameStats& stats = backend.GetStats();
+        std::uint64_t uNumUploads = stats.auNumCalls[static_cast<std::size_t>(eTraceRecordType::UPDATE_BUFFER)];
+        std::printf("%8u %10" PRIu64 " %8" PRIu64 " %10" PRIu64 " %14" PRIu64 " %10" PRIu64 " %14" PRIu64 "\n",
+            frame.auArgs[0], stats.GetNumCalls(), stats.uNumDraws, stats.GetNumRedundant(),
+            stats.uUploadedBytes, uNumUploads, stats.uNumPrimitiveIndices);
+        if (bPrintFrames)
+        {
+            printCallHistogram(stats, 1u);
+        }
+
+        total.Add(stats);
+    }
+
+    if (uNumFrames == 0u)
+    {
+        std::printf("No frames\n");
+        return 0;
+    }
+
+    std::printf("\n%u frames, %" PRIu64 " calls, %" PRIu64 " draws, %" PRIu64 " redundant binds, %" PRIu64 " bytes uploaded\n",
+        uNumFrames, total.GetNumCalls(), total.uNumDraws, total.GetNumRedundant(), total.uUploadedBytes);
+    std::printf("\nCalls of all frames\n");
+    printCallHistogram(total, uNumFrames);
+    std::printf("\nUploads of all frames\n");
+    printUploadHistogram(total);
+
+    return 0;
+}